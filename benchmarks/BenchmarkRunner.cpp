@@ -0,0 +1,357 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace pdkbench {
+
+namespace {
+
+using BenchmarkRegistry = std::map<std::string, BenchmarkFunc>;
+
+BenchmarkRegistry &get_registry()
+{
+   static BenchmarkRegistry sg_registry;
+   return sg_registry;
+}
+
+// calibration stops growing the iteration count past this bound
+constexpr std::uint64_t MAX_ITERATIONS = 1000000000;
+
+std::string json_escape(const std::string &str)
+{
+   std::string result;
+   result.reserve(str.size());
+   for (char c : str) {
+      switch (c) {
+      case '"':
+         result += "\\\"";
+         break;
+      case '\\':
+         result += "\\\\";
+         break;
+      case '\n':
+         result += "\\n";
+         break;
+      default:
+         if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            result += buffer;
+         } else {
+            result += c;
+         }
+      }
+   }
+   return result;
+}
+
+std::string csv_escape(const std::string &str)
+{
+   if (str.find_first_of(",\"\n") == std::string::npos) {
+      return str;
+   }
+   std::string result = "\"";
+   for (char c : str) {
+      if (c == '"') {
+         result += '"';
+      }
+      result += c;
+   }
+   result += '"';
+   return result;
+}
+
+std::string current_date_time()
+{
+   std::time_t now = std::time(nullptr);
+   char buffer[32];
+   std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+   return buffer;
+}
+
+bool starts_with(const char *str, const char *prefix, const char **value)
+{
+   std::size_t length = std::strlen(prefix);
+   if (std::strncmp(str, prefix, length) != 0) {
+      return false;
+   }
+   *value = str + length;
+   return true;
+}
+
+void print_usage(const char *program)
+{
+   std::fprintf(stderr,
+                "usage: %s [--filter=substring] [--format=console|json|csv] [--output=path]\n"
+                "          [--min-time=ms] [--repetitions=count] [--list]\n",
+                program);
+}
+
+} // anonymous namespace
+
+BenchmarkState::BenchmarkState(std::uint64_t iterations)
+   : m_iterations(iterations),
+     m_remaining(iterations),
+     m_bytesPerIteration(0),
+     m_elapsed(ClockType::duration::zero()),
+     m_running(false)
+{}
+
+void BenchmarkState::pauseTiming()
+{
+   if (m_running) {
+      m_elapsed += ClockType::now() - m_startTime;
+      m_running = false;
+   }
+}
+
+void BenchmarkState::resumeTiming()
+{
+   if (!m_running) {
+      m_startTime = ClockType::now();
+      m_running = true;
+   }
+}
+
+void BenchmarkState::skip(const std::string &reason)
+{
+   m_skipReason = reason;
+   m_remaining = 0;
+}
+
+void BenchmarkState::finish()
+{
+   pauseTiming();
+}
+
+bool register_benchmark(const char *name, BenchmarkFunc func)
+{
+   get_registry()[name] = func;
+   return true;
+}
+
+BenchmarkRunner::BenchmarkRunner()
+   : m_format(OutputFormat::Console),
+     m_minTime(200),
+     m_repetitions(5),
+     m_listOnly(false)
+{}
+
+bool BenchmarkRunner::parseArguments(int argc, char **argv)
+{
+   for (int i = 1; i < argc; ++i) {
+      const char *value = nullptr;
+      if (starts_with(argv[i], "--filter=", &value)) {
+         m_filter = value;
+      } else if (starts_with(argv[i], "--output=", &value)) {
+         m_outputPath = value;
+      } else if (starts_with(argv[i], "--format=", &value)) {
+         if (std::strcmp(value, "json") == 0) {
+            m_format = OutputFormat::Json;
+         } else if (std::strcmp(value, "csv") == 0) {
+            m_format = OutputFormat::Csv;
+         } else if (std::strcmp(value, "console") == 0) {
+            m_format = OutputFormat::Console;
+         } else {
+            print_usage(argv[0]);
+            return false;
+         }
+      } else if (starts_with(argv[i], "--min-time=", &value)) {
+         m_minTime = std::chrono::milliseconds(std::max(1, std::atoi(value)));
+      } else if (starts_with(argv[i], "--repetitions=", &value)) {
+         m_repetitions = std::max(1, std::atoi(value));
+      } else if (std::strcmp(argv[i], "--list") == 0) {
+         m_listOnly = true;
+      } else {
+         print_usage(argv[0]);
+         return false;
+      }
+   }
+   return true;
+}
+
+int BenchmarkRunner::run()
+{
+   std::vector<BenchmarkResult> results;
+   for (const auto &entry : get_registry()) {
+      if (!m_filter.empty() && entry.first.find(m_filter) == std::string::npos) {
+         continue;
+      }
+      if (m_listOnly) {
+         std::printf("%s\n", entry.first.c_str());
+         continue;
+      }
+      if (m_format != OutputFormat::Console || !m_outputPath.empty()) {
+         std::fprintf(stderr, "running %s\n", entry.first.c_str());
+      }
+      results.push_back(runBenchmark(entry.first, entry.second));
+   }
+   if (m_listOnly) {
+      return 0;
+   }
+   return writeReport(results) ? 0 : 1;
+}
+
+BenchmarkResult BenchmarkRunner::runBenchmark(const std::string &name, BenchmarkFunc func)
+{
+   BenchmarkResult result;
+   result.m_name = name;
+   // grow the iteration count until one run lasts at least the minimum time
+   std::uint64_t iterations = 1;
+   std::chrono::nanoseconds minTime = m_minTime;
+   for (;;) {
+      BenchmarkState state(iterations);
+      func(state);
+      if (!state.m_skipReason.empty()) {
+         result.m_skipReason = state.m_skipReason;
+         return result;
+      }
+      std::chrono::nanoseconds elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(state.m_elapsed);
+      if (elapsed >= minTime || iterations >= MAX_ITERATIONS) {
+         break;
+      }
+      double scale = elapsed.count() > 0
+            ? 1.4 * static_cast<double>(minTime.count()) / static_cast<double>(elapsed.count())
+            : 100.0;
+      scale = std::min(std::max(scale, 2.0), 100.0);
+      iterations = std::min(MAX_ITERATIONS, static_cast<std::uint64_t>(iterations * scale));
+   }
+   std::vector<double> samples;
+   std::uint64_t bytesPerIteration = 0;
+   for (int i = 0; i < m_repetitions; ++i) {
+      BenchmarkState state(iterations);
+      func(state);
+      std::chrono::nanoseconds elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(state.m_elapsed);
+      samples.push_back(static_cast<double>(elapsed.count()) / static_cast<double>(iterations));
+      bytesPerIteration = state.m_bytesPerIteration;
+   }
+   std::sort(samples.begin(), samples.end());
+   double sum = 0;
+   for (double sample : samples) {
+      sum += sample;
+   }
+   double mean = sum / samples.size();
+   double variance = 0;
+   for (double sample : samples) {
+      variance += (sample - mean) * (sample - mean);
+   }
+   std::size_t count = samples.size();
+   result.m_iterations = iterations;
+   result.m_repetitions = m_repetitions;
+   result.m_minNs = samples.front();
+   result.m_medianNs = count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+   result.m_meanNs = mean;
+   result.m_stddevNs = count > 1 ? std::sqrt(variance / (count - 1)) : 0;
+   if (bytesPerIteration != 0 && result.m_medianNs > 0) {
+      result.m_bytesPerSecond = bytesPerIteration * 1e9 / result.m_medianNs;
+   }
+   return result;
+}
+
+bool BenchmarkRunner::writeReport(const std::vector<BenchmarkResult> &results)
+{
+   std::ostringstream out;
+   out.precision(6);
+   out << std::fixed;
+   if (m_format == OutputFormat::Json) {
+      out << "{\n";
+      out << "  \"context\": {\n";
+      out << "    \"date\": \"" << current_date_time() << "\",\n";
+      out << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+      out << "    \"build_type\": \"release\",\n";
+#else
+      out << "    \"build_type\": \"debug\",\n";
+#endif
+      out << "    \"min_time_ms\": " << m_minTime.count() << ",\n";
+      out << "    \"repetitions\": " << m_repetitions << "\n";
+      out << "  },\n";
+      out << "  \"benchmarks\": [";
+      for (std::size_t i = 0; i < results.size(); ++i) {
+         const BenchmarkResult &result = results[i];
+         out << (i == 0 ? "\n" : ",\n");
+         out << "    {\"name\": \"" << json_escape(result.m_name) << "\"";
+         if (!result.m_skipReason.empty()) {
+            out << ", \"skipped\": \"" << json_escape(result.m_skipReason) << "\"}";
+            continue;
+         }
+         out << ", \"iterations\": " << result.m_iterations
+             << ", \"repetitions\": " << result.m_repetitions
+             << ", \"min_ns\": " << result.m_minNs
+             << ", \"median_ns\": " << result.m_medianNs
+             << ", \"mean_ns\": " << result.m_meanNs
+             << ", \"stddev_ns\": " << result.m_stddevNs
+             << ", \"bytes_per_second\": " << result.m_bytesPerSecond << "}";
+      }
+      out << "\n  ]\n}\n";
+   } else if (m_format == OutputFormat::Csv) {
+      out << "name,iterations,repetitions,min_ns,median_ns,mean_ns,stddev_ns,bytes_per_second,skipped\n";
+      for (const BenchmarkResult &result : results) {
+         out << csv_escape(result.m_name) << ','
+             << result.m_iterations << ','
+             << result.m_repetitions << ','
+             << result.m_minNs << ','
+             << result.m_medianNs << ','
+             << result.m_meanNs << ','
+             << result.m_stddevNs << ','
+             << result.m_bytesPerSecond << ','
+             << csv_escape(result.m_skipReason) << '\n';
+      }
+   } else {
+      char line[256];
+      std::snprintf(line, sizeof(line), "%-48s %14s %14s %14s %12s %12s\n",
+                    "benchmark", "iterations", "median ns", "min ns", "stddev", "MB/s");
+      out << line;
+      for (const BenchmarkResult &result : results) {
+         if (!result.m_skipReason.empty()) {
+            std::snprintf(line, sizeof(line), "%-48s skipped: %s\n",
+                          result.m_name.c_str(), result.m_skipReason.c_str());
+         } else {
+            std::snprintf(line, sizeof(line), "%-48s %14llu %14.2f %14.2f %12.2f %12.2f\n",
+                          result.m_name.c_str(),
+                          static_cast<unsigned long long>(result.m_iterations),
+                          result.m_medianNs, result.m_minNs, result.m_stddevNs,
+                          result.m_bytesPerSecond / (1024 * 1024));
+         }
+         out << line;
+      }
+   }
+   if (m_outputPath.empty()) {
+      std::cout << out.str();
+      std::cout.flush();
+      return true;
+   }
+   std::ofstream file(m_outputPath, std::ios::out | std::ios::trunc);
+   if (!file) {
+      std::fprintf(stderr, "can not open %s for writing\n", m_outputPath.c_str());
+      return false;
+   }
+   file << out.str();
+   return static_cast<bool>(file);
+}
+
+} // pdkbench
@@ -0,0 +1,161 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_BENCHMARKS_BENCHMARK_RUNNER_H
+#define PDK_BENCHMARKS_BENCHMARK_RUNNER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pdkbench {
+
+// Handed to every benchmark body, the body runs the measured operation
+// once per keepRunning() call:
+//
+//    PDK_BENCHMARK(String, indexOf)
+//    {
+//       String haystack = ...;
+//       while (state.keepRunning()) {
+//          do_not_optimize(haystack.indexOf(needle));
+//       }
+//    }
+//
+// Setup done before the first keepRunning() call is not measured.
+class BenchmarkState
+{
+public:
+   using ClockType = std::chrono::steady_clock;
+   
+   explicit BenchmarkState(std::uint64_t iterations);
+   
+   bool keepRunning()
+   {
+      if (m_remaining != 0) {
+         if (m_remaining-- == m_iterations) {
+            resumeTiming();
+         }
+         return true;
+      }
+      finish();
+      return false;
+   }
+   
+   std::uint64_t getIterations() const
+   {
+      return m_iterations;
+   }
+   
+   // exclude per iteration setup from the measurement
+   void pauseTiming();
+   void resumeTiming();
+   
+   // bytes touched by one iteration, reported as throughput
+   void setBytesPerIteration(std::uint64_t bytes)
+   {
+      m_bytesPerIteration = bytes;
+   }
+   
+   void skip(const std::string &reason);
+   
+private:
+   friend class BenchmarkRunner;
+   void finish();
+   
+   std::uint64_t m_iterations;
+   std::uint64_t m_remaining;
+   std::uint64_t m_bytesPerIteration;
+   ClockType::time_point m_startTime;
+   ClockType::duration m_elapsed;
+   std::string m_skipReason;
+   bool m_running;
+};
+
+using BenchmarkFunc = void (*)(BenchmarkState &state);
+
+bool register_benchmark(const char *name, BenchmarkFunc func);
+
+// keep a computed value alive without the optimizer noticing
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   asm volatile("" : : "r,m"(value) : "memory");
+#else
+   static volatile const void *sg_sink;
+   sg_sink = &value;
+#endif
+}
+
+inline void clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+   asm volatile("" : : : "memory");
+#endif
+}
+
+struct BenchmarkResult
+{
+   std::string m_name;
+   std::uint64_t m_iterations = 0;
+   int m_repetitions = 0;
+   double m_minNs = 0;
+   double m_medianNs = 0;
+   double m_meanNs = 0;
+   double m_stddevNs = 0;
+   double m_bytesPerSecond = 0;
+   std::string m_skipReason;
+};
+
+class BenchmarkRunner
+{
+public:
+   enum class OutputFormat
+   {
+      Console,
+      Json,
+      Csv
+   };
+   
+   BenchmarkRunner();
+   // returns false and prints the usage when the arguments are invalid
+   bool parseArguments(int argc, char **argv);
+   int run();
+   
+private:
+   BenchmarkResult runBenchmark(const std::string &name, BenchmarkFunc func);
+   bool writeReport(const std::vector<BenchmarkResult> &results);
+   
+   std::string m_filter;
+   std::string m_outputPath;
+   OutputFormat m_format;
+   std::chrono::milliseconds m_minTime;
+   int m_repetitions;
+   bool m_listOnly;
+};
+
+} // pdkbench
+
+#define PDK_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define PDK_BENCHMARK_CONCAT(a, b) PDK_BENCHMARK_CONCAT_IMPL(a, b)
+
+#define PDK_BENCHMARK(group, name) \
+   static void pdk_benchmark_##group##_##name(::pdkbench::BenchmarkState &state); \
+   static const bool PDK_BENCHMARK_CONCAT(sg_benchmarkRegistered, __LINE__) = \
+      ::pdkbench::register_benchmark(#group "/" #name, &pdk_benchmark_##group##_##name); \
+   static void pdk_benchmark_##group##_##name(::pdkbench::BenchmarkState &state)
+
+#endif // PDK_BENCHMARKS_BENCHMARK_RUNNER_H
@@ -0,0 +1,154 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include "pdk/base/ds/ByteArray.h"
+#include "pdk/kernel/HashFuncs.h"
+
+using pdk::ds::ByteArray;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+ByteArray make_text(int size)
+{
+   ByteArray text;
+   text.reserve(size + 16);
+   while (text.size() < size) {
+      text.append("the quick brown fox jumps over the lazy dog ");
+   }
+   text.append("needle");
+   return text;
+}
+
+} // anonymous namespace
+
+PDK_BENCHMARK(ByteArray, indexOfChar)
+{
+   ByteArray text(4096, 'a');
+   text.append('z');
+   state.setBytesPerIteration(text.size());
+   while (state.keepRunning()) {
+      do_not_optimize(text.indexOf('z'));
+   }
+}
+
+PDK_BENCHMARK(ByteArray, indexOf)
+{
+   ByteArray text = make_text(4096);
+   ByteArray needle("needle");
+   state.setBytesPerIteration(text.size());
+   while (state.keepRunning()) {
+      do_not_optimize(text.indexOf(needle));
+   }
+}
+
+PDK_BENCHMARK(ByteArray, countChar)
+{
+   ByteArray text = make_text(4096);
+   state.setBytesPerIteration(text.size());
+   while (state.keepRunning()) {
+      do_not_optimize(text.count('o'));
+   }
+}
+
+PDK_BENCHMARK(ByteArray, compareEqual)
+{
+   ByteArray left = make_text(4096);
+   ByteArray right = make_text(4096);
+   state.setBytesPerIteration(left.size());
+   while (state.keepRunning()) {
+      do_not_optimize(left == right);
+   }
+}
+
+PDK_BENCHMARK(ByteArray, append)
+{
+   state.setBytesPerIteration(16 * 256);
+   while (state.keepRunning()) {
+      ByteArray text;
+      for (int i = 0; i < 256; ++i) {
+         text.append("0123456789abcdef", 16);
+      }
+      do_not_optimize(text);
+   }
+}
+
+PDK_BENCHMARK(ByteArray, toHex)
+{
+   ByteArray data = make_text(1024);
+   state.setBytesPerIteration(data.size());
+   while (state.keepRunning()) {
+      do_not_optimize(data.toHex());
+   }
+}
+
+PDK_BENCHMARK(ByteArray, toBase64)
+{
+   ByteArray data = make_text(4096);
+   state.setBytesPerIteration(data.size());
+   while (state.keepRunning()) {
+      do_not_optimize(data.toBase64());
+   }
+}
+
+PDK_BENCHMARK(ByteArray, fromBase64)
+{
+   ByteArray encoded = make_text(4096).toBase64();
+   state.setBytesPerIteration(encoded.size());
+   while (state.keepRunning()) {
+      do_not_optimize(ByteArray::fromBase64(encoded));
+   }
+}
+
+PDK_BENCHMARK(ByteArray, number)
+{
+   int value = 0;
+   while (state.keepRunning()) {
+      do_not_optimize(ByteArray::number(++value));
+   }
+}
+
+PDK_BENCHMARK(ByteArray, constructShort)
+{
+   while (state.keepRunning()) {
+      do_not_optimize(ByteArray("content-length"));
+   }
+}
+
+PDK_BENCHMARK(ByteArray, hashShort)
+{
+   ByteArray key("content-length");
+   while (state.keepRunning()) {
+      do_not_optimize(pdk::pdk_hash(key));
+   }
+}
+
+PDK_BENCHMARK(ByteArray, hashLong)
+{
+   ByteArray text = make_text(64 * 1024);
+   state.setBytesPerIteration(text.size());
+   while (state.keepRunning()) {
+      do_not_optimize(pdk::pdk_hash(text));
+   }
+}
+
+PDK_BENCHMARK(ByteArray, secureHashShort)
+{
+   ByteArray key("content-length");
+   while (state.keepRunning()) {
+      do_not_optimize(pdk::pdk_secure_hash(key));
+   }
+}
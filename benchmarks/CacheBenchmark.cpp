@@ -0,0 +1,98 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include "pdk/utils/ConcurrentCache.h"
+#include <thread>
+#include <vector>
+
+using pdk::utils::ConcurrentCache;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+using CacheType = ConcurrentCache<int, int>;
+
+constexpr int KEY_COUNT = 4096;
+constexpr int LOOKUPS_PER_THREAD = 10000;
+
+void fill(CacheType &cache)
+{
+   for (int i = 0; i < KEY_COUNT; ++i) {
+      cache.insert(i, new int(i));
+   }
+}
+
+// every iteration runs a fixed number of lookups on four threads
+void run_parallel_lookups(pdkbench::BenchmarkState &state, CacheType::EvictionPolicy policy)
+{
+   CacheType cache(KEY_COUNT, policy);
+   fill(cache);
+   while (state.keepRunning()) {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t) {
+         threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < LOOKUPS_PER_THREAD; ++i) {
+               do_not_optimize(cache.getData((i * 31 + t) % KEY_COUNT));
+            }
+         });
+      }
+      for (std::thread &thread : threads) {
+         thread.join();
+      }
+   }
+}
+
+} // anonymous namespace
+
+PDK_BENCHMARK(ConcurrentCache, lookupLru)
+{
+   CacheType cache(KEY_COUNT);
+   fill(cache);
+   int key = 0;
+   while (state.keepRunning()) {
+      do_not_optimize(cache.getData(++key & (KEY_COUNT - 1)));
+   }
+}
+
+PDK_BENCHMARK(ConcurrentCache, lookupClock)
+{
+   CacheType cache(KEY_COUNT, CacheType::EvictionPolicy::Clock);
+   fill(cache);
+   int key = 0;
+   while (state.keepRunning()) {
+      do_not_optimize(cache.getData(++key & (KEY_COUNT - 1)));
+   }
+}
+
+PDK_BENCHMARK(ConcurrentCache, insertWithEviction)
+{
+   CacheType cache(KEY_COUNT);
+   int key = 0;
+   while (state.keepRunning()) {
+      ++key;
+      cache.insert(key, new int(key));
+   }
+}
+
+PDK_BENCHMARK(ConcurrentCache, parallelLookupLru)
+{
+   run_parallel_lookups(state, CacheType::EvictionPolicy::LeastRecentlyUsed);
+}
+
+PDK_BENCHMARK(ConcurrentCache, parallelLookupClock)
+{
+   run_parallel_lookups(state, CacheType::EvictionPolicy::Clock);
+}
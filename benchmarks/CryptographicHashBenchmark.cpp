@@ -0,0 +1,91 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+#include "BenchmarkRunner.h"
+#include "pdk/utils/CryptographicHash.h"
+#include <vector>
+
+using pdk::ds::ByteArray;
+using pdk::utils::CryptographicHash;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+constexpr int LARGE_SIZE = 1024 * 1024;
+constexpr int SMALL_SIZE = 64;
+constexpr int SMALL_COUNT = 1024;
+
+void hash_large(pdkbench::BenchmarkState &state, CryptographicHash::Algorithm method)
+{
+   ByteArray data(LARGE_SIZE, 'x');
+   state.setBytesPerIteration(LARGE_SIZE);
+   while (state.keepRunning()) {
+      do_not_optimize(CryptographicHash::hash(data, method));
+   }
+}
+
+std::vector<ByteArray> small_messages()
+{
+   std::vector<ByteArray> messages;
+   for (int i = 0; i < SMALL_COUNT; ++i) {
+      messages.push_back(ByteArray(SMALL_SIZE, static_cast<char>('a' + i % 26)));
+   }
+   return messages;
+}
+
+} // anonymous namespace
+
+PDK_BENCHMARK(CryptographicHash, sha1Large)
+{
+   hash_large(state, CryptographicHash::Sha1);
+}
+
+PDK_BENCHMARK(CryptographicHash, sha256Large)
+{
+   hash_large(state, CryptographicHash::Sha256);
+}
+
+PDK_BENCHMARK(CryptographicHash, sha3_256Large)
+{
+   hash_large(state, CryptographicHash::Sha3_256);
+}
+
+PDK_BENCHMARK(CryptographicHash, sha256SmallOneByOne)
+{
+   std::vector<ByteArray> messages = small_messages();
+   state.setBytesPerIteration(SMALL_SIZE * SMALL_COUNT);
+   while (state.keepRunning()) {
+      for (const ByteArray &message : messages) {
+         do_not_optimize(CryptographicHash::hash(message, CryptographicHash::Sha256));
+      }
+   }
+}
+
+PDK_BENCHMARK(CryptographicHash, sha256SmallMany)
+{
+   std::vector<ByteArray> messages = small_messages();
+   state.setBytesPerIteration(SMALL_SIZE * SMALL_COUNT);
+   while (state.keepRunning()) {
+      do_not_optimize(CryptographicHash::hashMany(messages, CryptographicHash::Sha256));
+   }
+}
+
+PDK_BENCHMARK(CryptographicHash, sha3_256SmallMany)
+{
+   std::vector<ByteArray> messages = small_messages();
+   state.setBytesPerIteration(SMALL_SIZE * SMALL_COUNT);
+   while (state.keepRunning()) {
+      do_not_optimize(CryptographicHash::hashMany(messages, CryptographicHash::Sha3_256));
+   }
+}
@@ -0,0 +1,116 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include "pdk/kernel/CoreApplication.h"
+#include "pdk/kernel/CoreEvent.h"
+#include "pdk/kernel/EventLoop.h"
+#include "pdk/kernel/Object.h"
+#include <vector>
+
+using pdk::kernel::CoreApplication;
+using pdk::kernel::Event;
+using pdk::kernel::EventLoop;
+using pdk::kernel::Object;
+using pdk::kernel::TimerEvent;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+constexpr int EVENTS_PER_ITERATION = 1000;
+
+class CountingReceiver : public Object
+{
+public:
+   bool event(Event *event) override
+   {
+      if (event->getType() == Event::Type::User) {
+         ++m_events;
+         return true;
+      }
+      return Object::event(event);
+   }
+   
+   void timerEvent(TimerEvent *) override
+   {
+      ++m_timerEvents;
+   }
+   
+   int m_events = 0;
+   int m_timerEvents = 0;
+};
+
+} // anonymous namespace
+
+// post a batch of events and deliver them, covers the posted event list
+// and the dispatcher wake up
+PDK_BENCHMARK(EventDispatcher, postAndSendEvents)
+{
+   CountingReceiver receiver;
+   while (state.keepRunning()) {
+      for (int i = 0; i < EVENTS_PER_ITERATION; ++i) {
+         CoreApplication::postEvent(&receiver, new Event(Event::Type::User));
+      }
+      CoreApplication::sendPostedEvents(&receiver);
+   }
+   do_not_optimize(receiver.m_events);
+}
+
+// one pass of the event loop with nothing to do
+PDK_BENCHMARK(EventDispatcher, processEventsIdle)
+{
+   while (state.keepRunning()) {
+      CoreApplication::processEvents();
+   }
+}
+
+// one pass of the event loop while a large number of timers are
+// registered but none of them is due
+PDK_BENCHMARK(EventDispatcher, processEventsManyTimers)
+{
+   CountingReceiver receiver;
+   std::vector<int> timers;
+   for (int i = 0; i < 1000; ++i) {
+      timers.push_back(receiver.startTimer(60000 + i, pdk::TimerType::PreciseTimer));
+   }
+   while (state.keepRunning()) {
+      CoreApplication::processEvents();
+   }
+   for (int timerId : timers) {
+      receiver.killTimer(timerId);
+   }
+}
+
+// zero interval timers fire on every pass of the event loop
+PDK_BENCHMARK(EventDispatcher, zeroTimer)
+{
+   CountingReceiver receiver;
+   int timerId = receiver.startTimer(0);
+   while (state.keepRunning()) {
+      CoreApplication::processEvents();
+   }
+   receiver.killTimer(timerId);
+   do_not_optimize(receiver.m_timerEvents);
+}
+
+PDK_BENCHMARK(EventDispatcher, startKillTimer)
+{
+   CountingReceiver receiver;
+   int interval = 0;
+   while (state.keepRunning()) {
+      int timerId = receiver.startTimer(1000 + (++interval & 1023));
+      receiver.killTimer(timerId);
+   }
+}
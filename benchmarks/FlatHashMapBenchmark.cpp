@@ -0,0 +1,112 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include "pdk/base/ds/FlatHashMap.h"
+#include "pdk/base/lang/String.h"
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+using pdk::ds::FlatHashMap;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+constexpr int sg_keyCount = 10000;
+
+std::vector<int> make_keys()
+{
+   std::vector<int> keys;
+   pdk::puint32 state = 20261018;
+   for (int i = 0; i < sg_keyCount; ++i) {
+      state = state * 1664525 + 1013904223;
+      keys.push_back(static_cast<int>(state >> 1));
+   }
+   return keys;
+}
+
+template <typename Map>
+void run_int_lookup(pdkbench::BenchmarkState &state)
+{
+   std::vector<int> keys = make_keys();
+   Map map;
+   for (int key : keys) {
+      map[key] = key;
+   }
+   while (state.keepRunning()) {
+      int found = 0;
+      for (int key : keys) {
+         found += map.find(key) != map.end();
+      }
+      do_not_optimize(found);
+   }
+}
+
+template <typename Map>
+void run_int_churn(pdkbench::BenchmarkState &state)
+{
+   std::vector<int> keys = make_keys();
+   while (state.keepRunning()) {
+      Map map;
+      for (int key : keys) {
+         map[key] = key;
+      }
+      for (int key : keys) {
+         map.erase(key);
+      }
+      do_not_optimize(map.size());
+   }
+}
+
+} // anonymous namespace
+
+PDK_BENCHMARK(FlatHashMap, intLookup)
+{
+   run_int_lookup<FlatHashMap<int, int>>(state);
+}
+
+PDK_BENCHMARK(FlatHashMap, unorderedMapIntLookup)
+{
+   run_int_lookup<std::unordered_map<int, int>>(state);
+}
+
+PDK_BENCHMARK(FlatHashMap, mapIntLookup)
+{
+   run_int_lookup<std::map<int, int>>(state);
+}
+
+PDK_BENCHMARK(FlatHashMap, intChurn)
+{
+   run_int_churn<FlatHashMap<int, int>>(state);
+}
+
+PDK_BENCHMARK(FlatHashMap, unorderedMapIntChurn)
+{
+   run_int_churn<std::unordered_map<int, int>>(state);
+}
+
+PDK_BENCHMARK(FlatHashMap, latin1Lookup)
+{
+   FlatHashMap<String, int> map;
+   for (int i = 0; i < 1000; ++i) {
+      map[String::fromLatin1("key-") + String::number(i)] = i;
+   }
+   while (state.keepRunning()) {
+      do_not_optimize(map.value(Latin1String("key-500")));
+   }
+}
@@ -0,0 +1,167 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include "pdk/base/ds/ByteArray.h"
+#include "pdk/base/ds/StringList.h"
+#include "pdk/base/lang/String.h"
+#include "pdk/base/utils/json/JsonArena.h"
+#include "pdk/base/utils/json/JsonArray.h"
+#include "pdk/base/utils/json/JsonDocument.h"
+#include "pdk/base/utils/json/JsonObject.h"
+#include "pdk/base/utils/json/JsonValue.h"
+
+using pdk::ds::ByteArray;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+using pdk::utils::json::JsonArena;
+using pdk::utils::json::JsonDocument;
+using pdk::utils::json::JsonObject;
+using pdk::utils::json::JsonParseError;
+using pdk::utils::json::JsonValue;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+// an array of small records with strings, numbers, booleans and a nested
+// array, roughly what a configuration or rpc payload looks like
+ByteArray make_document(int records)
+{
+   ByteArray json("{\"records\": [");
+   for (int i = 0; i < records; ++i) {
+      if (i != 0) {
+         json.append(',');
+      }
+      json.append("{\"id\": ");
+      json.append(ByteArray::number(i));
+      json.append(", \"name\": \"record name ");
+      json.append(ByteArray::number(i));
+      json.append("\", \"escaped\": \"tab\\tquote\\\"unicode\\u00e9\", \"price\": ");
+      json.append(ByteArray::number(i * 1.25));
+      json.append(", \"active\": ");
+      json.append(i % 2 ? "true" : "false");
+      json.append(", \"tags\": [\"alpha\", \"beta\", \"gamma\"], \"parent\": null}");
+   }
+   json.append("]}");
+   return json;
+}
+
+} // anonymous namespace
+
+PDK_BENCHMARK(Json, parse)
+{
+   ByteArray json = make_document(500);
+   state.setBytesPerIteration(json.size());
+   while (state.keepRunning()) {
+      JsonParseError error;
+      JsonDocument document = JsonDocument::fromJson(json, &error);
+      do_not_optimize(document);
+   }
+}
+
+PDK_BENCHMARK(Json, parseIndented)
+{
+   ByteArray json = JsonDocument::fromJson(make_document(500)).toJson(JsonDocument::JsonFormat::Indented);
+   state.setBytesPerIteration(json.size());
+   while (state.keepRunning()) {
+      do_not_optimize(JsonDocument::fromJson(json));
+   }
+}
+
+PDK_BENCHMARK(Json, parseLongStrings)
+{
+   ByteArray json("[");
+   for (int i = 0; i < 200; ++i) {
+      json.append(i ? ", \"" : "\"");
+      json.append(ByteArray(1000, static_cast<char>('a' + i % 26)));
+      json.append('"');
+   }
+   json.append(']');
+   state.setBytesPerIteration(json.size());
+   while (state.keepRunning()) {
+      do_not_optimize(JsonDocument::fromJson(json));
+   }
+}
+
+// many small request bodies, each read and dropped before the next one
+PDK_BENCHMARK(Json, parseSmall)
+{
+   ByteArray json = make_document(2);
+   state.setBytesPerIteration(json.size());
+   while (state.keepRunning()) {
+      JsonDocument document = JsonDocument::fromJson(json);
+      do_not_optimize(document);
+   }
+}
+
+PDK_BENCHMARK(Json, parseSmallArena)
+{
+   ByteArray json = make_document(2);
+   JsonArena arena;
+   state.setBytesPerIteration(json.size());
+   while (state.keepRunning()) {
+      {
+         JsonDocument document = JsonDocument::fromJson(json, &arena);
+         do_not_optimize(document);
+      }
+      arena.reset();
+   }
+}
+
+PDK_BENCHMARK(Json, serializeCompact)
+{
+   JsonDocument document = JsonDocument::fromJson(make_document(500));
+   while (state.keepRunning()) {
+      do_not_optimize(document.toJson(JsonDocument::JsonFormat::Compact));
+   }
+}
+
+PDK_BENCHMARK(Json, serializeIndented)
+{
+   JsonDocument document = JsonDocument::fromJson(make_document(500));
+   while (state.keepRunning()) {
+      do_not_optimize(document.toJson(JsonDocument::JsonFormat::Indented));
+   }
+}
+
+PDK_BENCHMARK(Json, objectLookup)
+{
+   JsonDocument document = JsonDocument::fromJson(make_document(1));
+   JsonObject record = document.getObject().getValue(Latin1String("records"))
+         .toArray().at(0).toObject();
+   while (state.keepRunning()) {
+      do_not_optimize(record.getValue(Latin1String("price")).toDouble());
+   }
+}
+
+PDK_BENCHMARK(Json, binaryRoundTrip)
+{
+   JsonDocument document = JsonDocument::fromJson(make_document(500));
+   while (state.keepRunning()) {
+      ByteArray data = document.toBinaryData();
+      do_not_optimize(JsonDocument::fromBinaryData(data));
+   }
+}
+
+PDK_BENCHMARK(Json, buildSmallObjects)
+{
+   while (state.keepRunning()) {
+      JsonObject object;
+      for (int i = 0; i < 32; ++i) {
+         object.insert(String::number(i), JsonValue(Latin1String("value")));
+      }
+      do_not_optimize(object.getKeys());
+   }
+}
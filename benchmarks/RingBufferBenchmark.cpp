@@ -0,0 +1,99 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include "pdk/base/ds/internal/RingBufferPrivate.h"
+#include <vector>
+
+using pdk::ds::ByteArray;
+using pdk::ds::internal::RingBuffer;
+using pdk::ds::internal::RingBufferSegment;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+constexpr int sg_streamSize = 1024 * 1024;
+
+} // anonymous namespace
+
+// what a pipe or socket does: small writes in, larger reads out
+PDK_BENCHMARK(RingBuffer, appendRead)
+{
+   std::vector<char> packet(1500, 'x');
+   std::vector<char> sink(16384);
+   RingBuffer buffer(16384);
+   state.setBytesPerIteration(sg_streamSize);
+   while (state.keepRunning()) {
+      for (int written = 0; written < sg_streamSize; written += static_cast<int>(packet.size())) {
+         buffer.append(packet.data(), packet.size());
+         if (buffer.size() >= 65536) {
+            while (!buffer.isEmpty()) {
+               buffer.read(sink.data(), sink.size());
+            }
+         }
+      }
+      buffer.clear();
+      do_not_optimize(sink.data());
+   }
+}
+
+// large byte arrays are queued by reference, not copied
+PDK_BENCHMARK(RingBuffer, appendLargeByteArray)
+{
+   const ByteArray packet(256 * 1024, 'x');
+   RingBuffer buffer(16384);
+   state.setBytesPerIteration(sg_streamSize);
+   while (state.keepRunning()) {
+      for (int written = 0; written < sg_streamSize; written += packet.size()) {
+         buffer.append(packet);
+      }
+      while (!buffer.isEmpty()) {
+         do_not_optimize(buffer.read().getConstRawData());
+      }
+   }
+}
+
+PDK_BENCHMARK(RingBuffer, reserveChop)
+{
+   RingBuffer buffer(16384);
+   state.setBytesPerIteration(sg_streamSize);
+   while (state.keepRunning()) {
+      for (int written = 0; written < sg_streamSize; written += 4096) {
+         // a read into reserved space that came back short
+         do_not_optimize(buffer.reserve(8192));
+         buffer.chop(4096);
+      }
+      buffer.clear();
+   }
+}
+
+PDK_BENCHMARK(RingBuffer, segments)
+{
+   RingBuffer buffer(16384);
+   RingBufferSegment segments[16];
+   state.setBytesPerIteration(sg_streamSize);
+   while (state.keepRunning()) {
+      for (int written = 0; written < sg_streamSize; written += 65536) {
+         const int count = buffer.getWritableSegments(segments, 16, 65536);
+         for (int i = 0; i < count; ++i) {
+            do_not_optimize(segments[i].iov_base);
+         }
+         buffer.commitWrite(65536);
+         const int readable = buffer.getReadableSegments(segments, 16);
+         do_not_optimize(readable);
+         buffer.free(buffer.size());
+      }
+   }
+}
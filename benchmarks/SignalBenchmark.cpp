@@ -0,0 +1,84 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include "pdk/kernel/signal/Signal.h"
+
+using pdk::kernel::signal::Signal;
+using pdk::kernel::signal::Connection;
+using pdk::kernel::signal::EmissionMode;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+using SignalType = Signal<void (int)>;
+
+int sg_sum = 0;
+
+void accumulate(int value)
+{
+   sg_sum += value;
+}
+
+void run_emit(pdkbench::BenchmarkState &state, EmissionMode mode, int slotCount)
+{
+   SignalType signal;
+   signal.setEmissionMode(mode);
+   for (int i = 0; i < slotCount; ++i) {
+      signal.connect(&accumulate);
+   }
+   int value = 0;
+   while (state.keepRunning()) {
+      signal(++value);
+   }
+   do_not_optimize(sg_sum);
+}
+
+} // anonymous namespace
+
+PDK_BENCHMARK(Signal, emitNoSlot)
+{
+   run_emit(state, EmissionMode::Locked, 0);
+}
+
+PDK_BENCHMARK(Signal, emitOneSlot)
+{
+   run_emit(state, EmissionMode::Locked, 1);
+}
+
+PDK_BENCHMARK(Signal, emitTenSlots)
+{
+   run_emit(state, EmissionMode::Locked, 10);
+}
+
+PDK_BENCHMARK(Signal, snapshotEmitOneSlot)
+{
+   run_emit(state, EmissionMode::Snapshot, 1);
+}
+
+PDK_BENCHMARK(Signal, snapshotEmitTenSlots)
+{
+   run_emit(state, EmissionMode::Snapshot, 10);
+}
+
+PDK_BENCHMARK(Signal, connectDisconnect)
+{
+   SignalType signal;
+   signal.connect(&accumulate);
+   while (state.keepRunning()) {
+      Connection conn = signal.connect(&accumulate);
+      conn.disconnect();
+   }
+}
@@ -0,0 +1,249 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include "pdk/base/lang/String.h"
+#include "pdk/base/ds/ByteArray.h"
+#include "pdk/base/ds/StringList.h"
+#include "pdk/utils/Locale.h"
+
+using pdk::lang::String;
+using pdk::lang::Latin1String;
+using pdk::lang::Character;
+using pdk::ds::ByteArray;
+using pdk::ds::StringList;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+// ascii text of roughly size characters with the needle at the very end
+String make_haystack(int size)
+{
+   String text;
+   text.reserve(size + 16);
+   const char pattern[] = "the quick brown fox jumps over the lazy dog ";
+   for (int i = 0; text.size() < size; ++i) {
+      text.append(Character(static_cast<char16_t>(pattern[i % (sizeof(pattern) - 1)])));
+   }
+   text.append(Latin1String("needle"));
+   return text;
+}
+
+} // anonymous namespace
+
+PDK_BENCHMARK(String, fromUtf8Ascii)
+{
+   ByteArray data(4096, 'a');
+   state.setBytesPerIteration(data.size());
+   while (state.keepRunning()) {
+      do_not_optimize(String::fromUtf8(data));
+   }
+}
+
+PDK_BENCHMARK(String, fromUtf8Multibyte)
+{
+   ByteArray data;
+   while (data.size() < 4096) {
+      data.append("\xe4\xb8\xad\xe6\x96\x87 caf\xc3\xa9 ");
+   }
+   state.setBytesPerIteration(data.size());
+   while (state.keepRunning()) {
+      do_not_optimize(String::fromUtf8(data));
+   }
+}
+
+PDK_BENCHMARK(String, fromUtf8Cjk)
+{
+   ByteArray data;
+   while (data.size() < 4096) {
+      data.append("\xe4\xb8\xad\xe6\x96\x87\xe7\x9a\x84\xe6\x96\x87\xe6\x9c\xac\xe3\x80\x82");
+   }
+   state.setBytesPerIteration(data.size());
+   while (state.keepRunning()) {
+      do_not_optimize(String::fromUtf8(data));
+   }
+}
+
+PDK_BENCHMARK(String, toUtf8Multibyte)
+{
+   ByteArray data;
+   while (data.size() < 4096) {
+      data.append("\xe4\xb8\xad\xe6\x96\x87\xe7\x9a\x84\xe6\x96\x87 \xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 ");
+   }
+   String text = String::fromUtf8(data);
+   state.setBytesPerIteration(text.size() * sizeof(Character));
+   while (state.keepRunning()) {
+      do_not_optimize(text.toUtf8());
+   }
+}
+
+PDK_BENCHMARK(String, toUtf8)
+{
+   String text = make_haystack(4096);
+   state.setBytesPerIteration(text.size() * sizeof(Character));
+   while (state.keepRunning()) {
+      do_not_optimize(text.toUtf8());
+   }
+}
+
+PDK_BENCHMARK(String, indexOf)
+{
+   String text = make_haystack(4096);
+   String needle(Latin1String("needle"));
+   state.setBytesPerIteration(text.size() * sizeof(Character));
+   while (state.keepRunning()) {
+      do_not_optimize(text.indexOf(needle));
+   }
+}
+
+PDK_BENCHMARK(String, indexOfCaseInsensitive)
+{
+   String text = make_haystack(4096);
+   String needle(Latin1String("NEEDLE"));
+   state.setBytesPerIteration(text.size() * sizeof(Character));
+   while (state.keepRunning()) {
+      do_not_optimize(text.indexOf(needle, 0, pdk::CaseSensitivity::Insensitive));
+   }
+}
+
+PDK_BENCHMARK(String, compareEqual)
+{
+   String left = make_haystack(1024);
+   String right = make_haystack(1024);
+   state.setBytesPerIteration(left.size() * sizeof(Character));
+   while (state.keepRunning()) {
+      do_not_optimize(left.compare(right));
+   }
+}
+
+PDK_BENCHMARK(String, compareCaseInsensitive)
+{
+   String left = make_haystack(1024);
+   String right = left.toUpper();
+   state.setBytesPerIteration(left.size() * sizeof(Character));
+   while (state.keepRunning()) {
+      do_not_optimize(left.compare(right, pdk::CaseSensitivity::Insensitive));
+   }
+}
+
+PDK_BENCHMARK(String, countCharacter)
+{
+   String text = make_haystack(4096);
+   state.setBytesPerIteration(text.size() * sizeof(Character));
+   while (state.keepRunning()) {
+      do_not_optimize(text.count(Character('o')));
+   }
+}
+
+PDK_BENCHMARK(String, toLatin1)
+{
+   String text = make_haystack(4096);
+   state.setBytesPerIteration(text.size() * sizeof(Character));
+   while (state.keepRunning()) {
+      do_not_optimize(text.toLatin1());
+   }
+}
+
+PDK_BENCHMARK(String, fromLatin1)
+{
+   ByteArray data(4096, 'a');
+   state.setBytesPerIteration(data.size());
+   while (state.keepRunning()) {
+      do_not_optimize(String::fromLatin1(data));
+   }
+}
+
+PDK_BENCHMARK(String, appendCharacter)
+{
+   while (state.keepRunning()) {
+      String text;
+      for (int i = 0; i < 256; ++i) {
+         text.append(Character(static_cast<char16_t>('a' + i % 26)));
+      }
+      do_not_optimize(text);
+   }
+}
+
+PDK_BENCHMARK(String, copyShort)
+{
+   String text(Latin1String("short string"));
+   while (state.keepRunning()) {
+      String copy(text);
+      copy.append(Character(u'!'));
+      do_not_optimize(copy);
+   }
+}
+
+PDK_BENCHMARK(String, number)
+{
+   int value = 0;
+   while (state.keepRunning()) {
+      do_not_optimize(String::number(++value));
+   }
+}
+
+PDK_BENCHMARK(String, numberDoubleShortest)
+{
+   double value = 0.1;
+   while (state.keepRunning()) {
+      value += 1.0 / 3.0;
+      do_not_optimize(String::number(value, 'g', pdk::utils::Locale::FloatingPointShortest));
+   }
+}
+
+PDK_BENCHMARK(String, toDouble)
+{
+   StringList numbers;
+   double value = 0.1;
+   for (int i = 0; i < 64; ++i) {
+      value *= 1.7;
+      numbers.push_back(String::number(value, 'g', 17));
+   }
+   int i = 0;
+   while (state.keepRunning()) {
+      do_not_optimize(numbers.at(++i & 63).toDouble());
+   }
+}
+
+PDK_BENCHMARK(String, constructShort)
+{
+   while (state.keepRunning()) {
+      do_not_optimize(String(Latin1String("identifier")));
+   }
+}
+
+PDK_BENCHMARK(String, splitShortFields)
+{
+   String line;
+   for (int i = 0; i < 64; ++i) {
+      line.append(String::number(i * 37));
+      line.append(Character(u','));
+   }
+   while (state.keepRunning()) {
+      do_not_optimize(line.split(Character(u',')));
+   }
+}
+
+PDK_BENCHMARK(String, buildStringList)
+{
+   while (state.keepRunning()) {
+      StringList list;
+      for (int i = 0; i < 128; ++i) {
+         list.push_back(String::number(i));
+      }
+      list.removeDuplicates();
+      do_not_optimize(list.join(Character(u' ')));
+   }
+}
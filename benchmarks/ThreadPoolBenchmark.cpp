@@ -0,0 +1,86 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "BenchmarkRunner.h"
+#include "pdk/base/os/thread/Runnable.h"
+#include "pdk/base/os/thread/ThreadPool.h"
+#include <atomic>
+
+using pdk::os::thread::Runnable;
+using pdk::os::thread::ThreadPool;
+using pdkbench::do_not_optimize;
+
+namespace {
+
+constexpr int TASKS_PER_ITERATION = 1000;
+
+class CountingTask : public Runnable
+{
+public:
+   CountingTask()
+   {
+      setAutoDelete(false);
+   }
+   
+   void run() override
+   {
+      m_count.fetch_add(1, std::memory_order_relaxed);
+   }
+   
+   std::atomic<int> m_count{0};
+};
+
+// submit a burst of tiny tasks and wait for the pool to drain them, this
+// mostly measures queueing and wake up overhead
+void run_task_burst(pdkbench::BenchmarkState &state, ThreadPool::SchedulingPolicy policy)
+{
+   ThreadPool pool;
+   if (!pool.setSchedulingPolicy(policy)) {
+      state.skip("scheduling policy not available");
+   }
+   CountingTask task;
+   while (state.keepRunning()) {
+      for (int i = 0; i < TASKS_PER_ITERATION; ++i) {
+         pool.start(&task);
+      }
+      pool.waitForDone();
+   }
+   do_not_optimize(task.m_count.load());
+}
+
+} // anonymous namespace
+
+PDK_BENCHMARK(ThreadPool, taskBurstGlobalQueue)
+{
+   run_task_burst(state, ThreadPool::SchedulingPolicy::GlobalQueue);
+}
+
+PDK_BENCHMARK(ThreadPool, taskBurstWorkStealing)
+{
+   run_task_burst(state, ThreadPool::SchedulingPolicy::WorkStealing);
+}
+
+PDK_BENCHMARK(ThreadPool, tryStartSingleThread)
+{
+   ThreadPool pool;
+   pool.setMaxThreadCount(1);
+   CountingTask task;
+   while (state.keepRunning()) {
+      if (pool.tryStart(&task)) {
+         pool.waitForDone();
+      }
+   }
+   do_not_optimize(task.m_count.load());
+}
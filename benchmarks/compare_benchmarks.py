@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+#
+# Created by softboy on 2026/10/18.
+#
+# Compare two reports written by PdkBenchmarks (--format=json or --format=csv)
+# and flag every benchmark that got slower than the threshold.
+#
+#    compare_benchmarks.py baseline.json current.json --threshold=5
+#
+# The exit status is 1 when at least one regression was found, so the script
+# can gate a CI job directly.
+
+import argparse
+import csv
+import json
+import sys
+
+METRICS = ("median_ns", "min_ns", "mean_ns")
+
+
+def load_report(path):
+    results = {}
+    if path.endswith(".csv"):
+        with open(path, newline="") as handle:
+            for row in csv.DictReader(handle):
+                if row.get("skipped"):
+                    continue
+                results[row["name"]] = {metric: float(row[metric]) for metric in METRICS}
+        return results
+    with open(path) as handle:
+        report = json.load(handle)
+    for entry in report.get("benchmarks", []):
+        if "skipped" in entry:
+            continue
+        results[entry["name"]] = {metric: float(entry[metric]) for metric in METRICS}
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two libpdk benchmark reports.")
+    parser.add_argument("baseline", help="report of the reference run")
+    parser.add_argument("current", help="report of the run under test")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="slowdown in percent reported as a regression (default 5)")
+    parser.add_argument("--metric", choices=METRICS, default="median_ns",
+                        help="per operation time compared between the runs")
+    parser.add_argument("--filter", default="",
+                        help="only compare benchmarks whose name contains this string")
+    args = parser.parse_args()
+
+    baseline = load_report(args.baseline)
+    current = load_report(args.current)
+    names = sorted(name for name in set(baseline) | set(current) if args.filter in name)
+    regressions = []
+    print("%-48s %14s %14s %9s" % ("benchmark", "baseline ns", "current ns", "change"))
+    for name in names:
+        if name not in baseline or name not in current:
+            where = "baseline" if name not in baseline else "current"
+            print("%-48s %40s" % (name, "missing in " + where))
+            continue
+        before = baseline[name][args.metric]
+        after = current[name][args.metric]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        marker = ""
+        if change > args.threshold:
+            marker = "  REGRESSION"
+            regressions.append(name)
+        elif change < -args.threshold:
+            marker = "  improved"
+        print("%-48s %14.2f %14.2f %+8.1f%%%s" % (name, before, after, change, marker))
+    if regressions:
+        print("\n%d benchmark(s) slower than %.1f%%: %s"
+              % (len(regressions), args.threshold, ", ".join(regressions)))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
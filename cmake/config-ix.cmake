@@ -121,6 +121,17 @@ pdk_check_type_exists(int64_t "${headers}" HAVE_INT64_T)
 pdk_check_type_exists(uint64_t "${headers}" HAVE_UINT64_T)
 pdk_check_type_exists(u_int64_t "${headers}" HAVE_U_INT64_T)
 
+# The wide string and UTF-8 kernels are compiled with per function target
+# attributes and selected at runtime, so we only need to know the compiler can emit them.
+if (CMAKE_SYSTEM_PROCESSOR MATCHES "x86_64|AMD64|amd64|i[3-6]86")
+   check_cxx_compiler_flag("-msse2" PDK_COMPILER_SUPPORTS_SSE2)
+   check_cxx_compiler_flag("-msse4.1" PDK_COMPILER_SUPPORTS_SSE4_1)
+   check_cxx_compiler_flag("-mavx" PDK_COMPILER_SUPPORTS_AVX)
+   check_cxx_compiler_flag("-mavx2" PDK_COMPILER_SUPPORTS_AVX2)
+   check_cxx_compiler_flag("-mavx512bw" PDK_COMPILER_SUPPORTS_AVX512BW)
+   check_cxx_compiler_flag("-msha" PDK_COMPILER_SUPPORTS_SHA)
+endif()
+
 check_cxx_compiler_flag("-Wvariadic-macros" PDK_SUPPORTS_VARIADIC_MACROS_FLAG)
 check_cxx_compiler_flag("-Wgnu-zero-variadic-macro-arguments"
    PDK_SUPPORTS_GNU_ZERO_VARIADIC_MACRO_ARGUMENTS_FLAG)
@@ -0,0 +1,64 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_DS_ARRAY_ALLOCATOR_H
+#define PDK_M_BASE_DS_ARRAY_ALLOCATOR_H
+
+#include "pdk/global/Global.h"
+#include <vector>
+
+namespace pdk {
+namespace ds {
+
+// Where the buffers of String, ByteArray and the other ArrayData based
+// containers come from. System hands every buffer to malloc, Slab serves
+// small buffers from per thread size class slabs and passes the rest on
+// to malloc. A buffer freed by another thread than the one that allocated
+// it goes back to the slabs of its owner.
+//
+// The policy is fixed by the first allocation, until then it may be chosen
+// with set_array_allocation_policy() or by setting PDK_ARRAY_ALLOCATOR to
+// "slab" or "system" in the environment. System is the default.
+enum class ArrayAllocationPolicy
+{
+   System,
+   Slab
+};
+
+struct ArrayAllocationStatistics
+{
+   // bytes per block of the size class, 0 for the class of buffers that
+   // were too large for a slab
+   size_t m_blockSize = 0;
+   pdk::puint64 m_allocations = 0;
+   pdk::puint64 m_deallocations = 0;
+   pdk::puint64 m_bytesAllocated = 0;
+   pdk::puint64 m_bytesDeallocated = 0;
+   // slab memory set aside for the class, in use or not
+   pdk::puint64 m_bytesReserved = 0;
+};
+
+// false once the first buffer was allocated with another policy
+PDK_CORE_EXPORT bool set_array_allocation_policy(ArrayAllocationPolicy policy);
+PDK_CORE_EXPORT ArrayAllocationPolicy get_array_allocation_policy();
+// one entry per size class followed by the one for large buffers, sums
+// over all threads. Statistics are only kept by the Slab policy, the list
+// is empty for System
+PDK_CORE_EXPORT std::vector<ArrayAllocationStatistics> get_array_allocation_statistics();
+
+} // ds
+} // pdk
+
+#endif // PDK_M_BASE_DS_ARRAY_ALLOCATOR_H
@@ -26,6 +26,7 @@
 
 #include "pdk/utils/RefCount.h"
 #include "pdk/base/ds/internal/ArrayData.h"
+#include "pdk/base/ds/internal/InlineArrayDataPointer.h"
 #include "pdk/global/EnumDefs.h"
 #include "pdk/kernel/StringUtils.h"
 
@@ -126,7 +127,10 @@ public:
    inline ByteArray(ByteArray &&other) noexcept
       : m_data(other.m_data)
    {
-      other.m_data = Data::getSharedNull();
+      // an inline value is copied, other keeps it
+      if (!other.m_data.isInline()) {
+         other.m_data = Data::getSharedNull();
+      }
    }
    
    inline ByteArray &operator =(ByteArray &&other) noexcept
@@ -439,9 +443,13 @@ public:
    
    bool isNull() const;
    
+   // the data moves to the heap first when it is stored inline
    inline DataPtr &getDataPtr()
    {
-      return m_data;
+      if (m_data.isInline()) {
+         reallocData(static_cast<uint>(m_data->m_size) + 1u, m_data->detachFlags());
+      }
+      return m_data.getPointerRef();
    }
    
 private:
@@ -462,11 +470,15 @@ private:
    friend class ByteRef;
    friend class String;
 private:
-   Data *m_data;
+   // values of up to 22 bytes live in the ByteArray itself
+   internal::InlineArrayDataPointer<char, 22> m_data;
 };
 
 PDK_DECLARE_OPERATORS_FOR_FLAGS(ByteArray::Base64Options)
 
+// the inline value and the pointer share the same 24 bytes
+static_assert(sizeof(ByteArray) <= 24, "ByteArray must stay within 24 bytes");
+
 class PDK_CORE_EXPORT ByteRef
 {
    public:
@@ -555,7 +567,7 @@ inline ByteArray::ByteArray(const ByteArray &data) noexcept
 inline ByteArray::~ByteArray()
 {
    if (!m_data->m_ref.deref()) {
-      Data::deallocate(m_data);
+      Data::deallocate(m_data.get());
    }
 }
 
@@ -622,6 +634,9 @@ inline const char *ByteArray::getConstRawData() const
 
 inline void ByteArray::detach()
 {
+   if (m_data.isInline()) {
+      return;
+   }
    if (m_data->m_ref.isShared() || (m_data->m_offset != sizeof(ByteArrayData))) {
       reallocData(static_cast<uint>(m_data->m_size) + 1u, m_data->detachFlags());
    }
@@ -629,7 +644,7 @@ inline void ByteArray::detach()
 
 inline bool ByteArray::isDetached() const
 {
-   return !m_data->m_ref.isShared();
+   return m_data.isInline() || !m_data->m_ref.isShared();
 }
 
 inline bool ByteArray::isSharedWith(const ByteArray &other) const
@@ -652,6 +667,9 @@ inline void ByteArray::reserve(int asize)
 
 inline void ByteArray::squeeze()
 {
+   if (m_data.isInline()) {
+      return;
+   }
    if (m_data->m_ref.isShared() || static_cast<uint>(m_data->m_size) + 1u < m_data->m_alloc) {
       reallocData(static_cast<uint>(size()) + 1u, 
                   m_data->detachFlags() & ~Data::CapacityReserved);
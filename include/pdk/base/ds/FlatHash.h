@@ -0,0 +1,92 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_DS_FLAT_HASH_H
+#define PDK_M_BASE_DS_FLAT_HASH_H
+
+#include "pdk/global/Global.h"
+#include "pdk/kernel/HashFuncs.h"
+#include "pdk/base/ds/ByteArray.h"
+#include "pdk/base/lang/String.h"
+#include "pdk/base/lang/StringView.h"
+
+namespace pdk {
+namespace ds {
+
+// The hash FlatHashMap and FlatHashSet use when none is given: pdk_hash()
+// of the key, found by argument dependent lookup. The table mixes the bits
+// itself, so hashes that are just the key, like those of integers, do fine.
+template <typename Key>
+struct FlatHash
+{
+   size_t operator()(const Key &key) const noexcept(noexcept(pdk_hash(key)))
+   {
+      return pdk_hash(key);
+   }
+};
+
+// Strings hash their UTF-16 code units with hash_bytes64(). A Latin1String
+// or StringView gets the hash of the String with the same text, so either
+// one finds a String key without making a String first.
+template <>
+struct PDK_CORE_EXPORT FlatHash<lang::String>
+{
+   using is_transparent = void;
+   
+   size_t operator()(const lang::String &key) const noexcept;
+   size_t operator()(lang::StringView key) const noexcept;
+   size_t operator()(lang::Latin1String key) const noexcept;
+};
+
+template <>
+struct PDK_CORE_EXPORT FlatHash<ByteArray>
+{
+   size_t operator()(const ByteArray &key) const noexcept;
+};
+
+template <typename Key>
+struct FlatKeyEqual
+{
+   bool operator()(const Key &lhs, const Key &rhs) const
+   {
+      return lhs == rhs;
+   }
+};
+
+template <>
+struct FlatKeyEqual<lang::String>
+{
+   using is_transparent = void;
+   
+   bool operator()(const lang::String &lhs, const lang::String &rhs) const noexcept
+   {
+      return lhs == rhs;
+   }
+   
+   bool operator()(const lang::String &lhs, lang::StringView rhs) const noexcept
+   {
+      return lang::StringView(lhs) == rhs;
+   }
+   
+   bool operator()(const lang::String &lhs, lang::Latin1String rhs) const noexcept
+   {
+      return lang::StringView(lhs) == rhs;
+   }
+};
+
+} // ds
+} // pdk
+
+#endif // PDK_M_BASE_DS_FLAT_HASH_H
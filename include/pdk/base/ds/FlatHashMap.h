@@ -0,0 +1,370 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_DS_FLAT_HASH_MAP_H
+#define PDK_M_BASE_DS_FLAT_HASH_MAP_H
+
+#include "pdk/base/ds/FlatHash.h"
+#include "pdk/base/ds/internal/ContainerFwd.h"
+#include "pdk/base/ds/internal/FlatHashTablePrivate.h"
+#include <initializer_list>
+#include <tuple>
+
+namespace pdk {
+namespace ds {
+
+// An unordered map that keeps its entries in one array instead of one node
+// each, found by probing 16 control bytes at a time (see
+// internal::FlatHashTable). Inserting may move every entry, so it invalidates
+// iterators, pointers and references; erasing only invalidates the erased
+// one. With the default hash and equality a String keyed map can be looked
+// up by StringView or Latin1String.
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+class FlatHashMap
+{
+private:
+   struct Policy
+   {
+      static constexpr bool isRelocatable = TypeInfo<Key>::isRelocatable && TypeInfo<T>::isRelocatable;
+      
+      static const Key &getKey(const std::pair<const Key, T> &value) noexcept
+      {
+         return value.first;
+      }
+      
+      static void relocate(std::pair<const Key, T> *to, std::pair<const Key, T> *from)
+      {
+         new (to) std::pair<const Key, T>(std::move(*from));
+         from->~pair();
+      }
+   };
+   
+   using Table = internal::FlatHashTable<std::pair<const Key, T>, Key, Policy, Hash, KeyEqual>;
+   
+   template <typename K>
+   using EnableIfTransparent = typename std::enable_if<Table::IS_TRANSPARENT && !std::is_same<K, Key>::value, int>::type;
+   
+public:
+   using KeyType = Key;
+   using MappedType = T;
+   using ValueType = std::pair<const Key, T>;
+   using SizeType = size_t;
+   using Iterator = typename Table::Iterator;
+   using ConstIterator = typename Table::ConstIterator;
+   
+   // STL style
+   using key_type = KeyType;
+   using mapped_type = MappedType;
+   using value_type = ValueType;
+   using size_type = SizeType;
+   using hasher = Hash;
+   using key_equal = KeyEqual;
+   using iterator = Iterator;
+   using const_iterator = ConstIterator;
+   
+   FlatHashMap() = default;
+   
+   FlatHashMap(std::initializer_list<ValueType> list)
+   {
+      reserve(list.size());
+      for (const ValueType &value : list) {
+         insert(value);
+      }
+   }
+   
+   inline Iterator begin() noexcept
+   {
+      return m_table.begin();
+   }
+   
+   inline ConstIterator begin() const noexcept
+   {
+      return m_table.begin();
+   }
+   
+   inline ConstIterator cbegin() const noexcept
+   {
+      return m_table.begin();
+   }
+   
+   inline Iterator end() noexcept
+   {
+      return m_table.end();
+   }
+   
+   inline ConstIterator end() const noexcept
+   {
+      return m_table.end();
+   }
+   
+   inline ConstIterator cend() const noexcept
+   {
+      return m_table.end();
+   }
+   
+   inline SizeType size() const noexcept
+   {
+      return m_table.size();
+   }
+   
+   inline bool isEmpty() const noexcept
+   {
+      return m_table.size() == 0;
+   }
+   
+   inline bool empty() const noexcept
+   {
+      return m_table.size() == 0;
+   }
+   
+   inline SizeType capacity() const noexcept
+   {
+      return m_table.capacity();
+   }
+   
+   // room for count entries without rehashing
+   inline void reserve(SizeType count)
+   {
+      m_table.reserve(count);
+   }
+   
+   // keeps the memory
+   inline void clear() noexcept
+   {
+      m_table.clear();
+   }
+   
+   inline void swap(FlatHashMap &other) noexcept
+   {
+      m_table.swap(other.m_table);
+   }
+   
+   Iterator find(const Key &key)
+   {
+      return at(m_table.find(key));
+   }
+   
+   ConstIterator find(const Key &key) const
+   {
+      return at(m_table.find(key));
+   }
+   
+   template <typename K, EnableIfTransparent<K> = 0>
+   Iterator find(const K &key)
+   {
+      return at(m_table.find(key));
+   }
+   
+   template <typename K, EnableIfTransparent<K> = 0>
+   ConstIterator find(const K &key) const
+   {
+      return at(m_table.find(key));
+   }
+   
+   bool contains(const Key &key) const
+   {
+      return m_table.find(key) != Table::NPOS;
+   }
+   
+   template <typename K, EnableIfTransparent<K> = 0>
+   bool contains(const K &key) const
+   {
+      return m_table.find(key) != Table::NPOS;
+   }
+   
+   SizeType count(const Key &key) const
+   {
+      return contains(key) ? 1 : 0;
+   }
+   
+   inline SizeType count() const noexcept
+   {
+      return m_table.size();
+   }
+   
+   // the value of key, defaultValue if there is none
+   T value(const Key &key, const T &defaultValue = T()) const
+   {
+      const size_t index = m_table.find(key);
+      return index == Table::NPOS ? defaultValue : at(index)->second;
+   }
+   
+   template <typename K, EnableIfTransparent<K> = 0>
+   T value(const K &key, const T &defaultValue = T()) const
+   {
+      const size_t index = m_table.find(key);
+      return index == Table::NPOS ? defaultValue : at(index)->second;
+   }
+   
+   T &operator[](const Key &key)
+   {
+      return tryEmplace(key).first->second;
+   }
+   
+   T &operator[](Key &&key)
+   {
+      return tryEmplace(std::move(key)).first->second;
+   }
+   
+   std::pair<Iterator, bool> insert(const ValueType &value)
+   {
+      return tryEmplace(value.first, value.second);
+   }
+   
+   std::pair<Iterator, bool> insert(ValueType &&value)
+   {
+      return tryEmplace(value.first, std::move(value.second));
+   }
+   
+   // constructs T from args only when key is not there yet
+   template <typename... Args>
+   std::pair<Iterator, bool> tryEmplace(const Key &key, Args &&...args)
+   {
+      return emplaceKey(key, std::forward<Args>(args)...);
+   }
+   
+   template <typename... Args>
+   std::pair<Iterator, bool> tryEmplace(Key &&key, Args &&...args)
+   {
+      return emplaceKey(std::move(key), std::forward<Args>(args)...);
+   }
+   
+   template <typename M>
+   std::pair<Iterator, bool> insertOrAssign(const Key &key, M &&value)
+   {
+      std::pair<Iterator, bool> result = emplaceKey(key, std::forward<M>(value));
+      if (!result.second) {
+         result.first->second = std::forward<M>(value);
+      }
+      return result;
+   }
+   
+   template <typename M>
+   std::pair<Iterator, bool> insertOrAssign(Key &&key, M &&value)
+   {
+      std::pair<Iterator, bool> result = emplaceKey(std::move(key), std::forward<M>(value));
+      if (!result.second) {
+         result.first->second = std::forward<M>(value);
+      }
+      return result;
+   }
+   
+   SizeType erase(const Key &key)
+   {
+      return eraseKey(key);
+   }
+   
+   template <typename K, EnableIfTransparent<K> = 0>
+   SizeType erase(const K &key)
+   {
+      return eraseKey(key);
+   }
+   
+   // returns the iterator following pos
+   Iterator erase(ConstIterator pos) noexcept
+   {
+      const size_t index = m_table.indexOf(pos);
+      m_table.eraseAt(index);
+      return m_table.iteratorAt(index + 1);
+   }
+   
+   Iterator erase(Iterator pos) noexcept
+   {
+      return erase(ConstIterator(pos));
+   }
+   
+   std::pair<T, bool> take(const Key &key)
+   {
+      const size_t index = m_table.find(key);
+      if (index == Table::NPOS) {
+         return std::make_pair(T(), false);
+      }
+      std::pair<T, bool> result(std::move(m_table.slotAt(index)->second), true);
+      m_table.eraseAt(index);
+      return result;
+   }
+   
+   friend bool operator==(const FlatHashMap &lhs, const FlatHashMap &rhs)
+   {
+      if (lhs.size() != rhs.size()) {
+         return false;
+      }
+      for (const ValueType &value : lhs) {
+         ConstIterator iter = rhs.find(value.first);
+         if (iter == rhs.end() || !(iter->second == value.second)) {
+            return false;
+         }
+      }
+      return true;
+   }
+   
+   friend bool operator!=(const FlatHashMap &lhs, const FlatHashMap &rhs)
+   {
+      return !(lhs == rhs);
+   }
+   
+private:
+   Iterator at(size_t index) noexcept
+   {
+      return index == Table::NPOS ? m_table.end() : m_table.iteratorAt(index);
+   }
+   
+   ConstIterator at(size_t index) const noexcept
+   {
+      return index == Table::NPOS ? m_table.end() : m_table.iteratorAt(index);
+   }
+   
+   template <typename K, typename... Args>
+   std::pair<Iterator, bool> emplaceKey(K &&key, Args &&...args)
+   {
+      const std::pair<size_t, bool> slot = m_table.findOrPrepareInsert(key);
+      if (slot.second) {
+         try {
+            new (m_table.slotAt(slot.first)) ValueType(std::piecewise_construct,
+                                                        std::forward_as_tuple(std::forward<K>(key)),
+                                                        std::forward_as_tuple(std::forward<Args>(args)...));
+         } catch (...) {
+            m_table.abandon(slot.first);
+            throw;
+         }
+         m_table.constructed();
+      }
+      return std::make_pair(m_table.iteratorAt(slot.first), slot.second);
+   }
+   
+   template <typename K>
+   SizeType eraseKey(const K &key)
+   {
+      const size_t index = m_table.find(key);
+      if (index == Table::NPOS) {
+         return 0;
+      }
+      m_table.eraseAt(index);
+      return 1;
+   }
+   
+   Table m_table;
+};
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+inline void swap(FlatHashMap<Key, T, Hash, KeyEqual> &lhs, FlatHashMap<Key, T, Hash, KeyEqual> &rhs) noexcept
+{
+   lhs.swap(rhs);
+}
+
+} // ds
+} // pdk
+
+#endif // PDK_M_BASE_DS_FLAT_HASH_MAP_H
@@ -0,0 +1,262 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_DS_FLAT_HASH_SET_H
+#define PDK_M_BASE_DS_FLAT_HASH_SET_H
+
+#include "pdk/base/ds/FlatHash.h"
+#include "pdk/base/ds/internal/ContainerFwd.h"
+#include "pdk/base/ds/internal/FlatHashTablePrivate.h"
+#include <initializer_list>
+
+namespace pdk {
+namespace ds {
+
+// The set counterpart of FlatHashMap, with the same rules for iterators
+// and lookups.
+template <typename Key, typename Hash, typename KeyEqual>
+class FlatHashSet
+{
+private:
+   struct Policy
+   {
+      static constexpr bool isRelocatable = TypeInfo<Key>::isRelocatable;
+      
+      static const Key &getKey(const Key &value) noexcept
+      {
+         return value;
+      }
+      
+      static void relocate(Key *to, Key *from)
+      {
+         new (to) Key(std::move(*from));
+         from->~Key();
+      }
+   };
+   
+   using Table = internal::FlatHashTable<Key, Key, Policy, Hash, KeyEqual>;
+   
+   template <typename K>
+   using EnableIfTransparent = typename std::enable_if<Table::IS_TRANSPARENT && !std::is_same<K, Key>::value, int>::type;
+   
+public:
+   using KeyType = Key;
+   using ValueType = Key;
+   using SizeType = size_t;
+   // the elements are the keys, so they can not be changed in place
+   using Iterator = typename Table::ConstIterator;
+   using ConstIterator = typename Table::ConstIterator;
+   
+   // STL style
+   using key_type = KeyType;
+   using value_type = ValueType;
+   using size_type = SizeType;
+   using hasher = Hash;
+   using key_equal = KeyEqual;
+   using iterator = Iterator;
+   using const_iterator = ConstIterator;
+   
+   FlatHashSet() = default;
+   
+   FlatHashSet(std::initializer_list<Key> list)
+   {
+      reserve(list.size());
+      for (const Key &value : list) {
+         insert(value);
+      }
+   }
+   
+   inline ConstIterator begin() const noexcept
+   {
+      return m_table.begin();
+   }
+   
+   inline ConstIterator cbegin() const noexcept
+   {
+      return m_table.begin();
+   }
+   
+   inline ConstIterator end() const noexcept
+   {
+      return m_table.end();
+   }
+   
+   inline ConstIterator cend() const noexcept
+   {
+      return m_table.end();
+   }
+   
+   inline SizeType size() const noexcept
+   {
+      return m_table.size();
+   }
+   
+   inline SizeType count() const noexcept
+   {
+      return m_table.size();
+   }
+   
+   inline bool isEmpty() const noexcept
+   {
+      return m_table.size() == 0;
+   }
+   
+   inline bool empty() const noexcept
+   {
+      return m_table.size() == 0;
+   }
+   
+   inline SizeType capacity() const noexcept
+   {
+      return m_table.capacity();
+   }
+   
+   // room for count elements without rehashing
+   inline void reserve(SizeType count)
+   {
+      m_table.reserve(count);
+   }
+   
+   // keeps the memory
+   inline void clear() noexcept
+   {
+      m_table.clear();
+   }
+   
+   inline void swap(FlatHashSet &other) noexcept
+   {
+      m_table.swap(other.m_table);
+   }
+   
+   ConstIterator find(const Key &key) const
+   {
+      return at(m_table.find(key));
+   }
+   
+   template <typename K, EnableIfTransparent<K> = 0>
+   ConstIterator find(const K &key) const
+   {
+      return at(m_table.find(key));
+   }
+   
+   bool contains(const Key &key) const
+   {
+      return m_table.find(key) != Table::NPOS;
+   }
+   
+   template <typename K, EnableIfTransparent<K> = 0>
+   bool contains(const K &key) const
+   {
+      return m_table.find(key) != Table::NPOS;
+   }
+   
+   SizeType count(const Key &key) const
+   {
+      return contains(key) ? 1 : 0;
+   }
+   
+   std::pair<ConstIterator, bool> insert(const Key &value)
+   {
+      return insertKey(value);
+   }
+   
+   std::pair<ConstIterator, bool> insert(Key &&value)
+   {
+      return insertKey(std::move(value));
+   }
+   
+   SizeType erase(const Key &key)
+   {
+      return eraseKey(key);
+   }
+   
+   template <typename K, EnableIfTransparent<K> = 0>
+   SizeType erase(const K &key)
+   {
+      return eraseKey(key);
+   }
+   
+   // returns the iterator following pos
+   ConstIterator erase(ConstIterator pos) noexcept
+   {
+      const size_t index = m_table.indexOf(pos);
+      m_table.eraseAt(index);
+      return static_cast<const Table &>(m_table).iteratorAt(index + 1);
+   }
+   
+   friend bool operator==(const FlatHashSet &lhs, const FlatHashSet &rhs)
+   {
+      if (lhs.size() != rhs.size()) {
+         return false;
+      }
+      for (const Key &value : lhs) {
+         if (!rhs.contains(value)) {
+            return false;
+         }
+      }
+      return true;
+   }
+   
+   friend bool operator!=(const FlatHashSet &lhs, const FlatHashSet &rhs)
+   {
+      return !(lhs == rhs);
+   }
+   
+private:
+   ConstIterator at(size_t index) const noexcept
+   {
+      return index == Table::NPOS ? m_table.end() : m_table.iteratorAt(index);
+   }
+   
+   template <typename K>
+   std::pair<ConstIterator, bool> insertKey(K &&value)
+   {
+      const std::pair<size_t, bool> slot = m_table.findOrPrepareInsert(value);
+      if (slot.second) {
+         try {
+            new (m_table.slotAt(slot.first)) Key(std::forward<K>(value));
+         } catch (...) {
+            m_table.abandon(slot.first);
+            throw;
+         }
+         m_table.constructed();
+      }
+      return std::make_pair(at(slot.first), slot.second);
+   }
+   
+   template <typename K>
+   SizeType eraseKey(const K &key)
+   {
+      const size_t index = m_table.find(key);
+      if (index == Table::NPOS) {
+         return 0;
+      }
+      m_table.eraseAt(index);
+      return 1;
+   }
+   
+   Table m_table;
+};
+
+template <typename Key, typename Hash, typename KeyEqual>
+inline void swap(FlatHashSet<Key, Hash, KeyEqual> &lhs, FlatHashSet<Key, Hash, KeyEqual> &rhs) noexcept
+{
+   lhs.swap(rhs);
+}
+
+} // ds
+} // pdk
+
+#endif // PDK_M_BASE_DS_FLAT_HASH_SET_H
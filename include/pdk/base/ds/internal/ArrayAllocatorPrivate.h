@@ -0,0 +1,36 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_DS_INTERNAL_ARRAY_ALLOCATOR_PRIVATE_H
+#define PDK_M_BASE_DS_INTERNAL_ARRAY_ALLOCATOR_PRIVATE_H
+
+#include "pdk/base/ds/ArrayAllocator.h"
+
+namespace pdk {
+namespace ds {
+namespace internal {
+
+// malloc, realloc and free for ArrayData headers under the policy in
+// effect. Blocks only go back through the same functions, the Slab policy
+// keeps a word in front of each block to find its way home
+void *allocate_array_block(size_t size) noexcept;
+void *reallocate_array_block(void *block, size_t size) noexcept;
+void free_array_block(void *block) noexcept;
+
+} // internal
+} // ds
+} // pdk
+
+#endif // PDK_M_BASE_DS_INTERNAL_ARRAY_ALLOCATOR_PRIVATE_H
@@ -20,6 +20,12 @@ namespace pdk {
 namespace ds {
 
 template<class T, int PreAlloc = 256> class VarLengthArray;
+template<typename Key> struct FlatHash;
+template<typename Key> struct FlatKeyEqual;
+template<typename Key, typename T, typename Hash = FlatHash<Key>, typename KeyEqual = FlatKeyEqual<Key>>
+class FlatHashMap;
+template<typename Key, typename Hash = FlatHash<Key>, typename KeyEqual = FlatKeyEqual<Key>>
+class FlatHashSet;
 
 } // ds
 } // pdk
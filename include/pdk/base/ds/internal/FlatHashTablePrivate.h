@@ -0,0 +1,583 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_DS_INTERNAL_FLAT_HASH_TABLE_PRIVATE_H
+#define PDK_M_BASE_DS_INTERNAL_FLAT_HASH_TABLE_PRIVATE_H
+
+#include "pdk/global/Global.h"
+#include "pdk/global/TypeInfo.h"
+#include "pdk/kernel/Algorithms.h"
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+namespace pdk {
+namespace ds {
+namespace internal {
+
+// Open addressing in the style of Swiss tables: beside every slot a
+// control byte tells whether it is empty, deleted or full, and when full
+// holds 7 bits of the hash. A lookup compares the bytes of 16 slots at
+// once and only looks at the slots whose bits match.
+enum FlatControl : pdk::pint8
+{
+   FlatEmpty = -128,
+   FlatDeleted = -2,
+   // ends the control bytes, so iterators stop without a bound check
+   FlatSentinel = -1
+};
+
+// control bytes of 16 consecutive slots, the bit masks have one bit per
+// slot, lowest slot first
+class FlatGroup
+{
+public:
+   static constexpr size_t WIDTH = 16;
+   
+   explicit FlatGroup(const pdk::pint8 *control) noexcept
+   {
+#if defined(__SSE2__)
+      m_control = _mm_loadu_si128(reinterpret_cast<const __m128i *>(control));
+#else
+      std::memcpy(m_control, control, WIDTH);
+#endif
+   }
+   
+   uint match(pdk::pint8 hash) const noexcept
+   {
+#if defined(__SSE2__)
+      return static_cast<uint>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), m_control)));
+#else
+      uint mask = 0;
+      for (size_t i = 0; i < WIDTH; ++i) {
+         mask |= uint(m_control[i] == hash) << i;
+      }
+      return mask;
+#endif
+   }
+   
+   uint matchEmpty() const noexcept
+   {
+      return match(FlatEmpty);
+   }
+   
+   uint matchEmptyOrDeleted() const noexcept
+   {
+#if defined(__SSE2__)
+      return static_cast<uint>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(FlatSentinel), m_control)));
+#else
+      uint mask = 0;
+      for (size_t i = 0; i < WIDTH; ++i) {
+         mask |= uint(m_control[i] < FlatSentinel) << i;
+      }
+      return mask;
+#endif
+   }
+   
+private:
+#if defined(__SSE2__)
+   __m128i m_control;
+#else
+   pdk::pint8 m_control[WIDTH];
+#endif
+};
+
+// spreads a hash over all bits, pdk_hash() of an integer is the integer
+inline size_t flat_hash_mix(pdk::puint64 hash) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+   __extension__ unsigned __int128 product = hash;
+   product *= PDK_UINT64_C(0x9e3779b97f4a7c15);
+   return static_cast<size_t>(static_cast<pdk::puint64>(product) ^ static_cast<pdk::puint64>(product >> 64));
+#else
+   hash *= PDK_UINT64_C(0x9e3779b97f4a7c15);
+   return static_cast<size_t>(hash ^ (hash >> 32));
+#endif
+}
+
+template <typename T, typename = void>
+struct FlatIsTransparent : std::false_type
+{};
+
+template <typename T>
+struct FlatIsTransparent<T, typename std::conditional<true, void, typename T::is_transparent>::type> : std::true_type
+{};
+
+// The table behind FlatHashMap and FlatHashSet. Policy says how to get the
+// key out of a Value and whether a Value can be moved with memcpy. The
+// capacity is zero or one less than a power of two, at least 15, and the
+// table holds at most 7/8 of it.
+template <typename Value, typename Key, typename Policy, typename Hash, typename KeyEqual>
+class FlatHashTable
+{
+public:
+   static constexpr size_t NPOS = ~size_t(0);
+   // lookups take anything the hash and the key equality both accept
+   static constexpr bool IS_TRANSPARENT = FlatIsTransparent<Hash>::value && FlatIsTransparent<KeyEqual>::value;
+   
+   template <bool IsConst>
+   class IteratorBase
+   {
+   public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = Value;
+      using difference_type = pdk::ptrdiff;
+      using pointer = typename std::conditional<IsConst, const Value *, Value *>::type;
+      using reference = typename std::conditional<IsConst, const Value &, Value &>::type;
+      
+      IteratorBase() noexcept
+         : m_control(nullptr),
+           m_slot(nullptr)
+      {}
+      
+      IteratorBase(const pdk::pint8 *control, Value *slot) noexcept
+         : m_control(control),
+           m_slot(slot)
+      {
+         skipFree();
+      }
+      
+      // iterator to const iterator
+      template <bool OtherConst, typename = typename std::enable_if<IsConst && !OtherConst>::type>
+      IteratorBase(const IteratorBase<OtherConst> &other) noexcept
+         : m_control(other.m_control),
+           m_slot(other.m_slot)
+      {}
+      
+      reference operator*() const noexcept
+      {
+         return *m_slot;
+      }
+      
+      pointer operator->() const noexcept
+      {
+         return m_slot;
+      }
+      
+      IteratorBase &operator++() noexcept
+      {
+         ++m_control;
+         ++m_slot;
+         skipFree();
+         return *this;
+      }
+      
+      IteratorBase operator++(int) noexcept
+      {
+         IteratorBase old = *this;
+         ++*this;
+         return old;
+      }
+      
+      friend bool operator==(const IteratorBase &lhs, const IteratorBase &rhs) noexcept
+      {
+         return lhs.m_slot == rhs.m_slot;
+      }
+      
+      friend bool operator!=(const IteratorBase &lhs, const IteratorBase &rhs) noexcept
+      {
+         return lhs.m_slot != rhs.m_slot;
+      }
+      
+   private:
+      friend class FlatHashTable;
+      template <bool> friend class IteratorBase;
+      
+      void skipFree() noexcept
+      {
+         if (!m_control) {
+            return;
+         }
+         while (*m_control < FlatSentinel) {
+            ++m_control;
+            ++m_slot;
+         }
+      }
+      
+      const pdk::pint8 *m_control;
+      Value *m_slot;
+   };
+   
+   using Iterator = IteratorBase<false>;
+   using ConstIterator = IteratorBase<true>;
+   
+   FlatHashTable() noexcept
+      : m_control(nullptr),
+        m_slots(nullptr),
+        m_capacity(0),
+        m_size(0),
+        m_growthLeft(0)
+   {}
+   
+   FlatHashTable(const FlatHashTable &other)
+      : FlatHashTable()
+   {
+      m_hash = other.m_hash;
+      m_equal = other.m_equal;
+      reserve(other.m_size);
+      for (const Value &value : other) {
+         const size_t hash = hashOf(Policy::getKey(value));
+         const size_t index = prepareInsert(hash);
+         try {
+            new (m_slots + index) Value(value);
+         } catch (...) {
+            abandon(index);
+            throw;
+         }
+         ++m_size;
+      }
+   }
+   
+   FlatHashTable(FlatHashTable &&other) noexcept
+      : m_control(other.m_control),
+        m_slots(other.m_slots),
+        m_capacity(other.m_capacity),
+        m_size(other.m_size),
+        m_growthLeft(other.m_growthLeft),
+        m_hash(std::move(other.m_hash)),
+        m_equal(std::move(other.m_equal))
+   {
+      other.m_control = nullptr;
+      other.m_slots = nullptr;
+      other.m_capacity = 0;
+      other.m_size = 0;
+      other.m_growthLeft = 0;
+   }
+   
+   FlatHashTable &operator=(const FlatHashTable &other)
+   {
+      if (this != &other) {
+         FlatHashTable copy(other);
+         swap(copy);
+      }
+      return *this;
+   }
+   
+   FlatHashTable &operator=(FlatHashTable &&other) noexcept
+   {
+      FlatHashTable moved(std::move(other));
+      swap(moved);
+      return *this;
+   }
+   
+   ~FlatHashTable()
+   {
+      destroyAll();
+      std::free(m_control);
+   }
+   
+   void swap(FlatHashTable &other) noexcept
+   {
+      std::swap(m_control, other.m_control);
+      std::swap(m_slots, other.m_slots);
+      std::swap(m_capacity, other.m_capacity);
+      std::swap(m_size, other.m_size);
+      std::swap(m_growthLeft, other.m_growthLeft);
+      std::swap(m_hash, other.m_hash);
+      std::swap(m_equal, other.m_equal);
+   }
+   
+   size_t size() const noexcept
+   {
+      return m_size;
+   }
+   
+   size_t capacity() const noexcept
+   {
+      return m_capacity;
+   }
+   
+   Iterator begin() noexcept
+   {
+      return Iterator(m_control, m_slots);
+   }
+   
+   ConstIterator begin() const noexcept
+   {
+      return ConstIterator(m_control, m_slots);
+   }
+   
+   Iterator end() noexcept
+   {
+      return Iterator(m_control + m_capacity, m_slots + m_capacity);
+   }
+   
+   ConstIterator end() const noexcept
+   {
+      return ConstIterator(m_control + m_capacity, m_slots + m_capacity);
+   }
+   
+   Iterator iteratorAt(size_t index) noexcept
+   {
+      return Iterator(m_control + index, m_slots + index);
+   }
+   
+   ConstIterator iteratorAt(size_t index) const noexcept
+   {
+      return ConstIterator(m_control + index, m_slots + index);
+   }
+   
+   Value *slotAt(size_t index) noexcept
+   {
+      return m_slots + index;
+   }
+   
+   size_t indexOf(ConstIterator iter) const noexcept
+   {
+      return static_cast<size_t>(iter.m_slot - m_slots);
+   }
+   
+   template <typename K>
+   size_t find(const K &key) const
+   {
+      return m_capacity ? findHashed(key, hashOf(key)) : NPOS;
+   }
+   
+   template <typename K>
+   size_t findHashed(const K &key, size_t hash) const
+   {
+      if (!m_capacity) {
+         return NPOS;
+      }
+      const pdk::pint8 h2 = hashBits(hash);
+      size_t pos = (hash >> 7) & m_capacity;
+      size_t step = 0;
+      while (true) {
+         FlatGroup group(m_control + pos);
+         for (uint mask = group.match(h2); mask; mask &= mask - 1) {
+            const size_t index = (pos + count_trailing_zero_bits(mask)) & m_capacity;
+            if (PDK_LIKELY(m_equal(Policy::getKey(m_slots[index]), key))) {
+               return index;
+            }
+         }
+         if (PDK_LIKELY(group.matchEmpty())) {
+            return NPOS;
+         }
+         step += FlatGroup::WIDTH;
+         pos = (pos + step) & m_capacity;
+      }
+   }
+   
+   // the slot of key, or a marked slot for it that the caller must
+   // construct a Value in before anything else touches the table
+   template <typename K>
+   std::pair<size_t, bool> findOrPrepareInsert(const K &key)
+   {
+      const size_t hash = hashOf(key);
+      const size_t index = findHashed(key, hash);
+      if (index != NPOS) {
+         return std::make_pair(index, false);
+      }
+      return std::make_pair(prepareInsert(hash), true);
+   }
+   
+   void constructed() noexcept
+   {
+      ++m_size;
+   }
+   
+   // gives the slot back when constructing its Value threw
+   void abandon(size_t index) noexcept
+   {
+      markFree(index);
+   }
+   
+   void eraseAt(size_t index) noexcept
+   {
+      m_slots[index].~Value();
+      --m_size;
+      markFree(index);
+   }
+   
+   void clear() noexcept
+   {
+      destroyAll();
+      // the growth left depends on the size
+      m_size = 0;
+      if (m_capacity) {
+         resetControl();
+      }
+   }
+   
+   void reserve(size_t count)
+   {
+      if (count > capacityToGrowth(m_capacity)) {
+         rehash(capacityFor(count));
+      }
+   }
+   
+   const Hash &getHash() const noexcept
+   {
+      return m_hash;
+   }
+   
+   const KeyEqual &getKeyEqual() const noexcept
+   {
+      return m_equal;
+   }
+   
+private:
+   static constexpr size_t MIN_CAPACITY = FlatGroup::WIDTH - 1;
+   
+   static size_t capacityToGrowth(size_t capacity) noexcept
+   {
+      return capacity - capacity / 8;
+   }
+   
+   static size_t capacityFor(size_t count) noexcept
+   {
+      size_t capacity = MIN_CAPACITY;
+      while (capacityToGrowth(capacity) < count) {
+         capacity = capacity * 2 + 1;
+      }
+      return capacity;
+   }
+   
+   template <typename K>
+   size_t hashOf(const K &key) const
+   {
+      return flat_hash_mix(static_cast<pdk::puint64>(m_hash(key)));
+   }
+   
+   static pdk::pint8 hashBits(size_t hash) noexcept
+   {
+      return static_cast<pdk::pint8>(hash & 0x7f);
+   }
+   
+   // the first 15 control bytes are repeated after the sentinel, so a
+   // group read near the end sees the start of the table
+   void setControl(size_t index, pdk::pint8 value) noexcept
+   {
+      const size_t cloned = FlatGroup::WIDTH - 1;
+      m_control[index] = value;
+      m_control[((index - cloned) & m_capacity) + cloned] = value;
+   }
+   
+   size_t findFirstFree(size_t hash) const noexcept
+   {
+      size_t pos = (hash >> 7) & m_capacity;
+      size_t step = 0;
+      while (true) {
+         const uint mask = FlatGroup(m_control + pos).matchEmptyOrDeleted();
+         if (mask) {
+            return (pos + count_trailing_zero_bits(mask)) & m_capacity;
+         }
+         step += FlatGroup::WIDTH;
+         pos = (pos + step) & m_capacity;
+      }
+   }
+   
+   size_t prepareInsert(size_t hash)
+   {
+      size_t index = m_capacity ? findFirstFree(hash) : 0;
+      if (PDK_UNLIKELY(!m_growthLeft && (!m_capacity || m_control[index] != FlatDeleted))) {
+         // mostly tombstones, clean them up without growing
+         rehash(m_capacity && m_size <= capacityToGrowth(m_capacity) / 2
+                ? m_capacity : capacityFor(m_size + 1));
+         index = findFirstFree(hash);
+      }
+      m_growthLeft -= m_control[index] == FlatEmpty;
+      setControl(index, hashBits(hash));
+      return index;
+   }
+   
+   // a slot can go back to empty when no probe ever had to pass it, that
+   // is when no 16 slots in a row around it have been in use at once
+   void markFree(size_t index) noexcept
+   {
+      const size_t before = (index - FlatGroup::WIDTH) & m_capacity;
+      const uint emptyAfter = FlatGroup(m_control + index).matchEmpty();
+      const uint emptyBefore = FlatGroup(m_control + before).matchEmpty();
+      const bool wasNeverFull = emptyBefore && emptyAfter
+            && count_trailing_zero_bits(emptyAfter) + count_leading_zero_bits(pdk::puint16(emptyBefore))
+            < FlatGroup::WIDTH;
+      setControl(index, wasNeverFull ? FlatEmpty : FlatDeleted);
+      m_growthLeft += wasNeverFull;
+   }
+   
+   void resetControl() noexcept
+   {
+      std::memset(m_control, FlatEmpty, m_capacity + FlatGroup::WIDTH);
+      m_control[m_capacity] = FlatSentinel;
+      m_growthLeft = capacityToGrowth(m_capacity) - m_size;
+   }
+   
+   void destroyAll() noexcept
+   {
+      if (!std::is_trivially_destructible<Value>::value) {
+         for (size_t i = 0; i < m_capacity; ++i) {
+            if (m_control[i] >= 0) {
+               m_slots[i].~Value();
+            }
+         }
+      }
+   }
+   
+   static size_t slotOffset(size_t capacity) noexcept
+   {
+      const size_t align = alignof(Value);
+      return (capacity + FlatGroup::WIDTH + align - 1) & ~(align - 1);
+   }
+   
+   void rehash(size_t newCapacity)
+   {
+      pdk::pint8 *oldControl = m_control;
+      Value *oldSlots = m_slots;
+      const size_t oldCapacity = m_capacity;
+      // control bytes and slots in one block
+      void *block = std::malloc(slotOffset(newCapacity) + newCapacity * sizeof(Value));
+      PDK_CHECK_ALLOC_PTR(block);
+      m_control = static_cast<pdk::pint8 *>(block);
+      m_slots = reinterpret_cast<Value *>(static_cast<char *>(block) + slotOffset(newCapacity));
+      m_capacity = newCapacity;
+      resetControl();
+      for (size_t i = 0; i < oldCapacity; ++i) {
+         if (oldControl[i] < 0) {
+            continue;
+         }
+         const size_t hash = hashOf(Policy::getKey(oldSlots[i]));
+         const size_t index = findFirstFree(hash);
+         setControl(index, hashBits(hash));
+         if (Policy::isRelocatable) {
+            std::memcpy(static_cast<void *>(m_slots + index), static_cast<const void *>(oldSlots + i), sizeof(Value));
+         } else {
+            Policy::relocate(m_slots + index, oldSlots + i);
+         }
+      }
+      m_growthLeft = capacityToGrowth(m_capacity) - m_size;
+      std::free(oldControl);
+   }
+   
+   pdk::pint8 *m_control;
+   Value *m_slots;
+   size_t m_capacity;
+   size_t m_size;
+   size_t m_growthLeft;
+   Hash m_hash;
+   KeyEqual m_equal;
+};
+
+} // internal
+} // ds
+} // pdk
+
+#endif // PDK_M_BASE_DS_INTERNAL_FLAT_HASH_TABLE_PRIVATE_H
@@ -0,0 +1,202 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_DS_INTERNAL_INLINE_ARRAYDATA_POINTER_H
+#define PDK_M_BASE_DS_INTERNAL_INLINE_ARRAYDATA_POINTER_H
+
+#include "pdk/base/ds/internal/ArrayData.h"
+#include <cstring>
+
+namespace pdk {
+namespace ds {
+namespace internal {
+
+// The data pointer of String and ByteArray, the size of Capacity + 2
+// elements. It either points to a shared header or holds a value of up to
+// Capacity elements and its terminating zero itself, so short values are
+// neither allocated nor reference counted.
+//
+// The last element tells the two apart: it holds Capacity - size for an
+// inline value and HEAP_TAG otherwise. It lies past the terminating zero
+// of a full value, so writing the zero before the size is safe. An inline
+// value has no header of its own, operator
+// ->() builds one on demand that reads as static data: ref() and deref()
+// leave it alone and every path that checks isShared() before writing
+// moves the value to the heap first, exactly as it does for literals.
+// Nothing points into the object, so the owner stays relocatable with
+// memcpy.
+template <typename T, int Capacity>
+class InlineArrayDataPointer
+{
+public:
+   using Data = TypedArrayData<T>;
+   
+   // what operator ->() returns, the shared header or a header made up
+   // for the inline value whose size goes back to the owner when the
+   // expression is done. Other header fields can not be changed this way
+   class View
+   {
+   public:
+      explicit View(const InlineArrayDataPointer *owner) noexcept
+      {
+         if (!owner->isInline()) {
+            m_data = owner->m_ptr;
+            m_owner = nullptr;
+            return;
+         }
+         m_owner = const_cast<InlineArrayDataPointer *>(owner);
+         m_data = reinterpret_cast<Data *>(m_header);
+         m_size = owner->getInlineSize();
+         m_data->m_ref.m_atomic.store(-1);
+         m_data->m_size = m_size;
+         m_data->m_alloc = Capacity + 1;
+         m_data->m_capacityReserved = 0;
+         m_data->m_offset = reinterpret_cast<char *>(m_owner->m_elements) - m_header;
+      }
+      
+      View(const View &) = delete;
+      View &operator =(const View &) = delete;
+      
+      ~View()
+      {
+         if (m_owner && m_data->m_size != m_size) {
+            m_owner->setInlineSize(m_data->m_size);
+         }
+      }
+      
+      Data *operator ->() const noexcept
+      {
+         return m_data;
+      }
+      
+   private:
+      Data *m_data;
+      InlineArrayDataPointer *m_owner;
+      int m_size;
+      alignas(ArrayData) char m_header[sizeof(ArrayData)];
+   };
+   
+   // left unset like a plain pointer, the owner assigns or calls
+   // allocateInline() before anything else
+   InlineArrayDataPointer() noexcept = default;
+   
+   InlineArrayDataPointer(Data *data) noexcept
+   {
+      setPointer(data);
+   }
+   
+   InlineArrayDataPointer &operator =(Data *data) noexcept
+   {
+      setPointer(data);
+      return *this;
+   }
+   
+   View operator ->() const noexcept
+   {
+      return View(this);
+   }
+   
+   bool isInline() const noexcept
+   {
+      return m_elements[TAG_INDEX] != HEAP_TAG;
+   }
+   
+   // the shared header, only while the value is not inline
+   Data *get() const noexcept
+   {
+      PDK_ASSERT(!isInline());
+      return m_ptr;
+   }
+   
+   // the pointer itself, for owners that hand their data over to
+   // someone else. Only valid while the value is not inline
+   Data *&getPointerRef() noexcept
+   {
+      PDK_ASSERT(!isInline());
+      return m_ptr;
+   }
+   
+   // switches to the inline buffer for a value of size elements and
+   // returns its elements, or nullptr when size does not fit. The element
+   // after the last one is zeroed, the others are left to the caller
+   T *allocateInline(int size) noexcept
+   {
+      if (static_cast<uint>(size) > static_cast<uint>(Capacity)) {
+         return nullptr;
+      }
+      setInlineSize(size);
+      m_elements[size] = T();
+      return m_elements;
+   }
+   
+   static constexpr int getCapacity() noexcept
+   {
+      return Capacity;
+   }
+   
+   // an inline value only equals itself
+   friend bool operator ==(const InlineArrayDataPointer &lhs, const InlineArrayDataPointer &rhs) noexcept
+   {
+      return lhs.isInline() ? &lhs == &rhs : !rhs.isInline() && lhs.m_ptr == rhs.m_ptr;
+   }
+   
+   friend bool operator !=(const InlineArrayDataPointer &lhs, const InlineArrayDataPointer &rhs) noexcept
+   {
+      return !(lhs == rhs);
+   }
+   
+   friend bool operator ==(const InlineArrayDataPointer &lhs, const Data *rhs) noexcept
+   {
+      return !lhs.isInline() && lhs.m_ptr == rhs;
+   }
+   
+   friend bool operator !=(const InlineArrayDataPointer &lhs, const Data *rhs) noexcept
+   {
+      return !(lhs == rhs);
+   }
+   
+private:
+   static constexpr int TAG_INDEX = Capacity + 1;
+   static constexpr T HEAP_TAG = static_cast<T>(~0);
+   
+   void setPointer(Data *data) noexcept
+   {
+      m_ptr = data;
+      m_elements[TAG_INDEX] = HEAP_TAG;
+   }
+   
+   int getInlineSize() const noexcept
+   {
+      return Capacity - static_cast<int>(m_elements[TAG_INDEX]);
+   }
+   
+   void setInlineSize(int size) noexcept
+   {
+      PDK_ASSERT(size >= 0 && size <= Capacity);
+      m_elements[TAG_INDEX] = static_cast<T>(Capacity - size);
+   }
+   
+   union
+   {
+      Data *m_ptr;
+      T m_elements[Capacity + 2];
+   };
+};
+
+} // internal
+} // ds
+} // pdk
+
+#endif // PDK_M_BASE_DS_INTERNAL_INLINE_ARRAYDATA_POINTER_H
@@ -18,27 +18,94 @@
 
 #include "pdk/global/Global.h"
 #include "pdk/base/ds/ByteArray.h"
-#include <list>
+#include <algorithm>
+#include <cstddef>
+
+#ifdef PDK_OS_UNIX
+#  include <sys/uio.h>
+#endif
 
 #ifndef PDK_RING_BUFFER_CHUNK_SIZE
 #define PDK_RING_BUFFER_CHUNK_SIZE 4096
 #endif
 
+// bytes of free chunks every thread keeps for the next ring buffer
+#ifndef PDK_RING_BUFFER_POOL_SIZE
+#define PDK_RING_BUFFER_POOL_SIZE (1024 * 1024)
+#endif
+
+// byte arrays from this size on are appended by reference, not copied
+#ifndef PDK_RING_BUFFER_SHARE_SIZE
+#define PDK_RING_BUFFER_SHARE_SIZE 4096
+#endif
+
 namespace pdk {
 namespace ds {
 namespace internal {
 
+// one piece of the buffer, laid out like struct iovec so a list of them
+// can go straight to readv() and writev()
+#ifdef PDK_OS_UNIX
+using RingBufferSegment = ::iovec;
+#else
+struct RingBufferSegment
+{
+   void *iov_base;
+   size_t iov_len;
+};
+#endif
+
+// The header in front of the bytes of a chunk. Chunks whose capacity is a
+// power of two from 1K to 64K come from a per thread pool and go back to
+// it, the others straight from malloc. A shared chunk holds a ByteArray
+// instead of bytes and points into its data, it is never written to and
+// its capacity always ends at m_tail.
+struct RingBufferChunk
+{
+   RingBufferChunk *m_prev;
+   RingBufferChunk *m_next;
+   char *m_data;
+   int m_capacity;
+   // the data is [m_head, m_tail)
+   int m_head;
+   int m_tail;
+   bool m_isShared;
+   
+   inline char *getData()
+   {
+      return m_data;
+   }
+   
+   inline int size() const
+   {
+      return m_tail - m_head;
+   }
+};
+
+// A byte queue in a chain of chunks. Data is written at the back of the
+// last chunk and read from the front of the first one, a chunk goes back
+// to the pool once it has been read. With a chunk size of 0 every reserve()
+// and append() starts a chunk of its own, which read() then returns as one
+// packet.
 class RingBuffer
 {
- public:
+public:
    explicit inline RingBuffer(int growth = PDK_RING_BUFFER_CHUNK_SIZE)
-      : m_head(0),
-        m_tail(0),
-        m_tailBuffer(0),
+      : m_first(nullptr),
+        m_last(nullptr),
+        m_spare(nullptr),
         m_basicBlockSize(growth),
         m_bufferSize(0)
    {}
    
+   PDK_CORE_EXPORT RingBuffer(const RingBuffer &other);
+   PDK_CORE_EXPORT RingBuffer(RingBuffer &&other) noexcept;
+   PDK_CORE_EXPORT ~RingBuffer();
+   PDK_CORE_EXPORT RingBuffer &operator=(const RingBuffer &other);
+   PDK_CORE_EXPORT RingBuffer &operator=(RingBuffer &&other) noexcept;
+   
+   PDK_CORE_EXPORT void swap(RingBuffer &other) noexcept;
+   
    inline void setChunkSize(int size)
    {
       m_basicBlockSize = size;   
@@ -51,12 +118,12 @@ class RingBuffer
    
    inline pdk::pint64 nextDataBlockSize() const
    {
-      return (m_tailBuffer == 0 ? m_tail : m_buffers.front().size()) - m_head;
+      return m_first ? m_first->size() : 0;
    }
    
    inline const char *readPointer() const
    {
-      return m_bufferSize == 0 ? nullptr : (m_buffers.front().getConstRawData() + m_head);
+      return m_bufferSize == 0 ? nullptr : (m_first->getData() + m_first->m_head);
    }
    
    PDK_CORE_EXPORT const char *readPointerAtPosition(pdk::pint64 pos, pdk::pint64 &length) const;
@@ -95,9 +162,9 @@ class RingBuffer
    
    void ungetChar(char c)
    {
-      if (m_head > 0) {
-         --m_head;
-         m_buffers.front()[m_head] = c;
+      if (m_bufferSize != 0 && m_first->m_head > 0 && !m_first->m_isShared) {
+         --m_first->m_head;
+         m_first->getData()[m_first->m_head] = c;
          ++m_bufferSize;
       } else {
          char *ptr = reserveFront(1);
@@ -135,11 +202,32 @@ class RingBuffer
    {
       return indexOf('\n') >= 0;
    }
+   
+   // Scatter gather access for readv() and writev(). The readable segments
+   // are the data from the front, to be released with free() once written
+   // out. The writable segments are free space behind the data, at most
+   // maxCount of them holding up to bytes in total; after filling the
+   // first n bytes of them commitWrite(n) adds those to the buffer. Nothing
+   // else may change the buffer in between. Both return the number of
+   // segments filled in.
+   PDK_CORE_EXPORT int getReadableSegments(RingBufferSegment *segments, int maxCount) const;
+   PDK_CORE_EXPORT int getWritableSegments(RingBufferSegment *segments, int maxCount, pdk::pint64 bytes);
+   PDK_CORE_EXPORT void commitWrite(pdk::pint64 bytes);
+   
 private:
-   std::list<ByteArray> m_buffers;
-   int m_head;
-   int m_tail;
-   int m_tailBuffer;
+   RingBufferChunk *appendChunk(pdk::pint64 capacity);
+   RingBufferChunk *appendSharedChunk(const ByteArray &byteArray);
+   RingBufferChunk *linkLast(RingBufferChunk *chunk);
+   void releaseChunks(RingBufferChunk *chunk);
+   // drops the last chunk left, or keeps it for reuse when it is small and
+   // not shared
+   void releaseEmptyChunk();
+   
+   RingBufferChunk *m_first;
+   RingBufferChunk *m_last;
+   // chunks handed out by getWritableSegments() that hold no data yet,
+   // linked by m_next
+   RingBufferChunk *m_spare;
    int m_basicBlockSize;
    pdk::pint64 m_bufferSize;
 };
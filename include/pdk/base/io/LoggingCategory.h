@@ -25,6 +25,12 @@ namespace io {
 using pdk::os::thread::BasicAtomicInteger;
 using pdk::os::thread::BasicAtomicInt;
 
+// forward declare class with namespace
+namespace internal {
+class LoggingRegistry;
+class LoggingRuleMatcher;
+} // internal
+
 class PDK_CORE_EXPORT LoggingCategory
 {
    PDK_DISABLE_COPY(LoggingCategory);
@@ -34,47 +40,28 @@ public:
    ~LoggingCategory();
    bool isEnabled(pdk::MsgType type) const;
    void setEnabled(pdk::MsgType type, bool enable);
-#ifdef PDK_ATOMIC_INT8_IS_SUPPORTED
+   // the enable state of all message types lives in one packed atomic
+   // mask, checking a disabled category is a single relaxed load
    bool isDebugEnabled() const
    {
-      return m_bools.m_enabledDebug.load();
+      return m_enabled.load() & DebugBit;
    }
    
    bool isInfoEnabled() const
    {
-      return m_bools.m_enabledInfo.load();
+      return m_enabled.load() & InfoBit;
    }
    
    bool isWarningEnabled() const
    {
-      return m_bools.m_enabledWarning.load();
-   }
-   
-   bool isCriticalEnabled() const 
-   {
-      return m_bools.m_enabledCritical.load();
-   }
-#else
-   bool isDebugEnabled() const 
-   {
-      return m_enabled.load() >> DebugShift & 1;
-   }
-   
-   bool isInfoEnabled() const
-   {
-      return enabled.load() >> InfoShift & 1;
-   }
-   
-   bool isWarningEnabled() const
-   {
-      return enabled.load() >> WarningShift & 1;
+      return m_enabled.load() & WarningBit;
    }
    
    bool isCriticalEnabled() const
    {
-      return enabled.load() >> CriticalShift & 1;
+      return m_enabled.load() & CriticalBit;
    }
-#endif
+   
    const char *getCategoryName() const
    {
       return m_name;
@@ -96,36 +83,23 @@ public:
    static CategoryFilter installFilter(CategoryFilter);
    static void setFilterRules(const String &rules);
 private:
+   friend class internal::LoggingRegistry;
+   friend class internal::LoggingRuleMatcher;
+   
+   enum {
+      DebugBit = 0x1,
+      InfoBit = 0x2,
+      WarningBit = 0x4,
+      CriticalBit = 0x8,
+      AllBits = DebugBit | InfoBit | WarningBit | CriticalBit
+   };
+   
    void init(const char *category, pdk::MsgType severityLevel);
+   void setEnabledMask(int mask);
+   
    PDK_DECL_UNUSED_MEMBER void *m_data; // reserved for future use
    const char *m_name;
-#ifdef PDK_BIG_ENDIAN
-   enum {
-      DebugShift = 0,
-      WarningShift = 8,
-      CriticalShift = 16,
-      InfoShift = 24
-   };
-#else
-   enum {
-      DebugShift = 24,
-      WarningShift = 16,
-      CriticalShift = 8,
-      InfoShift = 0
-   };
-#endif
-   struct AtomicBools {
-#ifdef PDK_ATOMIC_INT8_IS_SUPPORTED
-      BasicAtomicInteger<bool> m_enabledDebug;
-      BasicAtomicInteger<bool> m_enabledWarning;
-      BasicAtomicInteger<bool> m_enabledCritical;
-      BasicAtomicInteger<bool> m_enabledInfo;
-#endif
-   };
-   union {
-      AtomicBools m_bools;
-      BasicAtomicInt m_enabled;
-   };
+   BasicAtomicInt m_enabled;
    PDK_DECL_UNUSED_MEMBER bool m_placeholder[4]; // reserved for future use
 };
 
@@ -155,17 +129,19 @@ private:
    for (bool pdkCategoryEnabled = category().isCriticalEnabled(); pdkCategoryEnabled; pdkCategoryEnabled = false) \
    pdk::MessageLogger(PDK_MESSAGELOG_FILE, PDK_MESSAGELOG_LINE, PDK_MESSAGELOG_FUNC, category().getCategoryName()).critical(__VA_ARGS__)
 
+// compiled out levels still type check their arguments but never evaluate
+// them, neither does the category get looked up
 #if defined(PDK_NO_DEBUG_OUTPUT)
 #  undef cdebug_stream
-#  define cdebug_stream(category) PDK_NO_DEBUG_MACRO()
+#  define cdebug_stream(category, ...) PDK_NO_DEBUG_MACRO(__VA_ARGS__)
 #endif
 #if defined(PDK_NO_INFO_OUTPUT)
 #  undef cinfo_stream
-#  define cinfo_stream(category) PDK_NO_DEBUG_MACRO()
+#  define cinfo_stream(category, ...) PDK_NO_DEBUG_MACRO(__VA_ARGS__)
 #endif
 #if defined(PDK_NO_WARNING_OUTPUT)
 #  undef cwarning_stream
-#  define cwarning_stream(category) PDK_NO_DEBUG_MACRO()
+#  define cwarning_stream(category, ...) PDK_NO_DEBUG_MACRO(__VA_ARGS__)
 #endif
 
 } // io
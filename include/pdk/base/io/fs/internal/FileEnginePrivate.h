@@ -20,7 +20,7 @@
 #include "pdk/base/io/fs/internal/AbstractFileEnginePrivate.h"
 #include "pdk/base/io/fs/internal/FileSystemEntryPrivate.h"
 #include "pdk/base/io/fs/internal/FileSystemMetaDataPrivate.h"
-#include <map>
+#include "pdk/base/ds/FlatHashMap.h"
 
 namespace pdk {
 namespace io {
@@ -149,12 +149,12 @@ public:
 #ifdef PDK_OS_WIN
    HANDLE m_fileHandle;
    HANDLE m_mapHandle;
-   std::map<uchar *, DWORD /* offset % AllocationGranularity */> m_maps;
+   pdk::ds::FlatHashMap<uchar *, DWORD /* offset % AllocationGranularity */> m_maps;
    
    mutable int m_cachedFd;
    mutable DWORD m_fileAttrib;
 #else
-   std::map<uchar *, std::pair<int /*offset % PageSize*/, size_t /*length + offset % PageSize*/>> m_maps;
+   pdk::ds::FlatHashMap<uchar *, std::pair<int /*offset % PageSize*/, size_t /*length + offset % PageSize*/>> m_maps;
 #endif
    int m_fd;
    
@@ -202,6 +202,11 @@ public:
       {
          return m_buf && m_buf->canReadLine();
       }
+      
+      inline int getReadableSegments(pdk::ds::internal::RingBufferSegment *segments, int maxCount) const
+      {
+         return (m_buf ? m_buf->getReadableSegments(segments, maxCount) : 0);
+      }
    };
    
    virtual bool putCharHelper(char c);
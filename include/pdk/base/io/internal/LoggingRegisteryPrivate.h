@@ -23,6 +23,8 @@
 
 #include <map>
 #include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace pdk {
@@ -58,6 +60,52 @@ private:
    void parse(const StringRef &pattern);
 };
 
+// all rules compiled for lookup by category name. exact and 'name*' rules
+// share a trie, '*name' rules sit in a trie over the reversed patterns and
+// only the rare '*name*' rules are scanned one by one. matching a category
+// costs a walk over its name instead of a pass() call per rule
+class PDK_UNITTEST_EXPORT LoggingRuleMatcher
+{
+public:
+   LoggingRuleMatcher();
+   void clear();
+   void addRule(const LoggingRule &rule);
+   
+   bool isEmpty() const
+   {
+      return m_ruleCount == 0;
+   }
+   
+   // applies the matching rules in the order they were added to the
+   // LoggingCategory enable mask and returns the result
+   int apply(const char *categoryName, int enabledMask) const;
+   
+private:
+   struct CompiledRule
+   {
+      int m_order;
+      int m_typeMask;
+      bool m_enabled;
+   };
+   
+   struct Node
+   {
+      std::vector<std::pair<char, int>> m_children;
+      // rules anchored at this node, prefix rules in the forward trie and
+      // suffix rules in the reversed one
+      std::vector<CompiledRule> m_anchoredRules;
+      std::vector<CompiledRule> m_exactRules;
+   };
+   
+   static int insert(std::vector<Node> &trie, const std::string &key);
+   static int findChild(const Node &node, char c);
+   
+   std::vector<Node> m_prefixTrie;
+   std::vector<Node> m_suffixTrie;
+   std::vector<std::pair<std::string, CompiledRule>> m_substringRules;
+   int m_ruleCount;
+};
+
 class PDK_UNITTEST_EXPORT LoggingSettingsParser
 {
 public:
@@ -100,6 +148,7 @@ public:
    static LoggingRegistry *getInstance();
    
 private:
+   void compileRules();
    void updateRules();
    
    static void defaultCategoryFilter(LoggingCategory *category);
@@ -117,6 +166,7 @@ private:
    
    // protected by mutex:
    std::vector<LoggingRule> m_ruleSets[NumRuleSets];
+   LoggingRuleMatcher m_matcher;
    std::map<LoggingCategory*, pdk::MsgType> m_categories;
    LoggingCategory::CategoryFilter m_categoryFilter;
 };
@@ -22,6 +22,7 @@
 #include "pdk/base/lang/StringView.h"
 #include "pdk/base/lang/StringAlgorithms.h"
 #include "pdk/base/ds/ByteArray.h"
+#include "pdk/base/ds/internal/InlineArrayDataPointer.h"
 #include "pdk/utils/RefCount.h"
 #include "pdk/kernel/HashFuncs.h"
 
@@ -370,10 +371,10 @@ public:
    explicit String(const Character *unicode, int size = -1);
    String(Character c);
    String(int size, Character c);
-   inline String(Latin1String other);
+   String(Latin1String other);
    template <int N>
    inline String(const char (&str)[N])
-      : m_data(fromAsciiHelper(str, N - 1))
+      : String(fromUtf8(str, N - 1))
    {}
    
    inline String(const String &other) noexcept;
@@ -383,7 +384,7 @@ public:
    
    
    String(int size, pdk::Initialization);
-   constexpr inline String(StringDataPtr dataPtr)
+   inline String(StringDataPtr dataPtr)
       : m_data(dataPtr.m_ptr)
    {}
    
@@ -406,7 +407,10 @@ public:
    inline String(String &&other) noexcept
       : m_data(other.m_data)
    {
-      other.m_data = Data::getSharedNull();
+      // an inline value is copied, other keeps it
+      if (!other.m_data.isInline()) {
+         other.m_data = Data::getSharedNull();
+      }
    }
    
    inline String &operator =(String &&other) noexcept
@@ -711,7 +715,7 @@ public:
    
    inline String &operator +=(Character c)
    {
-      if (m_data->m_ref.isShared() || uint(m_data->m_size) + 2u > m_data->m_alloc) {
+      if (!isDetached() || uint(m_data->m_size) + 2u > m_data->m_alloc) {
          reallocData(uint(m_data->m_size) + 2u, true);
       }
       m_data->getData()[m_data->m_size++] = c.unicode();
@@ -818,8 +822,7 @@ public:
    
    static inline String fromLatin1(const char *str, int size = -1)
    {
-      StringDataPtr dataPtr = { fromLatin1Helper(str, (nullptr != str && size == -1) ? static_cast<int>(std::strlen(str)) : size) };
-      return String(dataPtr);
+      return String(Latin1String(str, (nullptr != str && size == -1) ? static_cast<int>(std::strlen(str)) : size));
    }
    
    static inline String fromUtf8(const char *str, int size = -1)
@@ -1123,16 +1126,24 @@ private:
    
 public:
    static const Null sm_null;
+   // the data moves to the heap first when it is stored inline
    inline DataPtr &getDataPtr()
    {
-      return m_data;
+      if (m_data.isInline()) {
+         reallocData(static_cast<uint>(m_data->m_size) + 1u);
+      }
+      return m_data.getPointerRef();
    }
 private:
-   Data *m_data;
+   // values of up to 10 UTF-16 units live in the String itself
+   pdk::ds::internal::InlineArrayDataPointer<char16_t, 10> m_data;
 };
 
 PDK_DECLARE_OPERATORS_FOR_FLAGS(String::SectionFlags)
 
+// the inline value and the pointer share the same 24 bytes
+static_assert(sizeof(String) <= 24, "String must stay within 24 bytes");
+
 inline String String::section(Character separator, int start, int end, SectionFlags flags) const
 {
    return section(String(separator), start, end, flags);
@@ -1183,10 +1194,6 @@ inline String::String() noexcept
    : m_data(Data::getSharedNull())
 {}
 
-inline String::String(Latin1String other)
-   : m_data(fromLatin1Helper(other.latin1(), other.size()))
-{}
-
 inline String::String(const String &other) noexcept
    : m_data(other.m_data)
 {
@@ -1197,7 +1204,7 @@ inline String::String(const String &other) noexcept
 inline String::~String()
 {
    if (!m_data->m_ref.deref()) {
-      Data::deallocate(m_data);
+      Data::deallocate(m_data.get());
    }
 }
 
@@ -1252,6 +1259,9 @@ inline const Character *String::getConstRawData() const
 
 inline void String::detach()
 {
+   if (m_data.isInline()) {
+      return;
+   }
    if (m_data->m_ref.isShared() || (m_data->m_offset != sizeof(StringData))) {
       reallocData(static_cast<uint>(m_data->m_size) + 1u);
    }
@@ -1259,7 +1269,7 @@ inline void String::detach()
 
 inline bool String::isDetached() const
 {
-   return !m_data->m_ref.isShared();
+   return m_data.isInline() || !m_data->m_ref.isShared();
 }
 
 inline void String::clear()
@@ -1286,6 +1296,9 @@ inline void String::reserve(int size)
 
 inline void String::squeeze()
 {
+   if (m_data.isInline()) {
+      return;
+   }
    if (m_data->m_ref.isShared() || static_cast<uint>(m_data->m_size) + 1u < m_data->m_alloc)
    {
       reallocData(static_cast<uint>(m_data->m_size) + 1u);
@@ -0,0 +1,78 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_LANG_INTERNAL_STRING_SIMD_PRIVATE_H
+#define PDK_M_BASE_LANG_INTERNAL_STRING_SIMD_PRIVATE_H
+
+#include "pdk/global/Global.h"
+#include "pdk/pal/kernel/Simd.h"
+
+#if defined(PDK_PROCESSOR_X86) && PDK_COMPILER_SUPPORTS(AVX2)
+#  define PDK_HAVE_WIDE_STRING_KERNELS
+#endif
+
+namespace pdk {
+namespace lang {
+namespace internal {
+
+// Wide (AVX2 and AVX-512BW) kernels shared by String, ByteArray and the
+// matchers. The callers keep their own SSE2 and scalar paths and only come
+// here when has_wide_string_kernels() says so; every kernel picks the widest
+// instruction set the running CPU offers and handles the tail itself.
+//
+// Inputs shorter than WIDE_KERNEL_MIN_LENGTH are not worth the dispatch.
+constexpr int WIDE_KERNEL_MIN_LENGTH = 32;
+
+inline bool has_wide_string_kernels() noexcept
+{
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   using namespace pdk::pal::kernel;
+   return CPU_HAS_FEATURE(AVX2);
+#else
+   return false;
+#endif
+}
+
+// position of the first ch, or -1
+PDK_CORE_EXPORT int wide_find_char16(const char16_t *str, int length, char16_t ch) noexcept;
+PDK_CORE_EXPORT int wide_find_byte(const char *str, int length, char ch) noexcept;
+
+PDK_CORE_EXPORT int wide_count_char16(const char16_t *str, int length, char16_t ch) noexcept;
+PDK_CORE_EXPORT int wide_count_byte(const char *str, int length, char ch) noexcept;
+
+// position of the first needle (needleLength >= 2) in haystack, or -1
+PDK_CORE_EXPORT int wide_find_utf16(const char16_t *haystack, int haystackLength,
+                                    const char16_t *needle, int needleLength) noexcept;
+PDK_CORE_EXPORT int wide_find_bytes(const char *haystack, int haystackLength,
+                                    const char *needle, int needleLength) noexcept;
+
+// position of the first differing code unit, or length when both are equal
+PDK_CORE_EXPORT int wide_mismatch_utf16(const char16_t *lhs, const char16_t *rhs, int length) noexcept;
+PDK_CORE_EXPORT int wide_mismatch_latin1(const char16_t *lhs, const uchar *rhs, int length) noexcept;
+
+// length of the leading run where both sides are ASCII and equal after
+// ASCII case folding, the caller resumes with the full Unicode folding there
+PDK_CORE_EXPORT int wide_ascii_caseless_prefix(const char16_t *lhs, const char16_t *rhs, int length) noexcept;
+PDK_CORE_EXPORT int wide_ascii_caseless_prefix(const char16_t *lhs, const uchar *rhs, int length) noexcept;
+
+PDK_CORE_EXPORT void wide_latin1_to_utf16(char16_t *dest, const char *str, int length) noexcept;
+// non Latin-1 code units become '?'
+PDK_CORE_EXPORT void wide_utf16_to_latin1(uchar *dest, const char16_t *src, int length) noexcept;
+
+} // internal
+} // lang
+} // pdk
+
+#endif // PDK_M_BASE_LANG_INTERNAL_STRING_SIMD_PRIVATE_H
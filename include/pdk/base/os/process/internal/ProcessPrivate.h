@@ -49,6 +49,7 @@ namespace internal {
 using pdk::utils::SharedData;
 using pdk::kernel::Timer;
 using pdk::lang::String;
+using pdk::ds::internal::RingBuffer;
 
 #ifdef PDK_OS_WIN
 #else
@@ -382,7 +383,9 @@ public:
    bool waitForFinished(int msecs = 30000);
    
    pdk::pint64 bytesAvailableInChannel(const Channel *channel) const;
-   pdk::pint64 readFromChannel(const Channel *channel, char *data, pdk::pint64 maxLength);
+   // reads up to maxLength bytes into the free space behind buffer, -2 when
+   // the read would block
+   pdk::pint64 readFromChannel(const Channel *channel, RingBuffer &buffer, pdk::pint64 maxLength);
    bool writeToStdin();
    
    void cleanup();
@@ -17,6 +17,7 @@
 #define PDK_M_BASE_OS_THREAD_RUNNABLE_H
 
 #include "pdk/global/Global.h"
+#include <atomic>
 
 namespace pdk {
 namespace os {
@@ -51,7 +52,9 @@ public:
       m_ref = autoDelete ? 0 : -1;
    }
 private:
-   int m_ref;
+   // the work stealing scheduler adjusts the reference count without
+   // holding the pool mutex, so it has to be atomic
+   std::atomic<int> m_ref;
    friend class ThreadPool;
    friend class ThreadPoolPrivate;
    friend class ThreadPoolThread;
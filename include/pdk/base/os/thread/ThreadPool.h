@@ -35,6 +35,12 @@ using pdk::kernel::Object;
 class PDK_CORE_EXPORT ThreadPool : public Object
 {
 public:
+   enum class SchedulingPolicy
+   {
+      GlobalQueue,
+      WorkStealing
+   };
+   
    ThreadPool(Object *parent = nullptr);
    ~ThreadPool();
    static ThreadPool *getGlobalInstance();
@@ -51,6 +57,8 @@ public:
    void releaseThread();
    bool waitForDone(int msecs = -1);
    void clear();
+   SchedulingPolicy getSchedulingPolicy() const;
+   bool setSchedulingPolicy(SchedulingPolicy policy);
    
    PDK_REQUIRED_RESULT bool tryTake(Runnable *runnable);
 private:
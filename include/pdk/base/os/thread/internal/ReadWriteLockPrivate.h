@@ -17,9 +17,9 @@
 #define PDK_M_BASE_OS_THREAD_INTERNAL_READWRITE_LOCK_PRIVATE_H
 
 #include "pdk/global/Global.h"
+#include "pdk/base/ds/FlatHashMap.h"
 #include <mutex>
 #include <condition_variable>
-#include <map>
 
 namespace pdk {
 namespace os {
@@ -59,7 +59,7 @@ public:
    const bool m_recursive;
    int m_id;
    pdk::HANDLE m_currentWriter;
-   std::map<pdk::HANDLE, int> m_currentReaders;
+   pdk::ds::FlatHashMap<pdk::HANDLE, int> m_currentReaders;
 };
 
 } // internal
@@ -17,7 +17,9 @@
 #define PDK_M_BASE_OS_THREAD_INTERNAL_THREAD_POOL_PRIVATE_H
 
 #include "pdk/base/os/thread/Thread.h"
+#include "pdk/base/os/thread/ThreadPool.h"
 #include "pdk/kernel/internal/ObjectPrivate.h"
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <set>
@@ -120,6 +122,136 @@ private:
    Runnable *m_entries[MaxPageSize];
 };
 
+/*
+ * Bounded Chase-Lev deque used by the work stealing scheduler.
+ *
+ * The owning worker pushes and pops at the bottom, other workers steal
+ * from the top. Claiming an index does not transfer ownership of the
+ * runnable, the claimant still has to exchange the slot with nullptr.
+ * This lets tryTake() and clear() remove queued runnables from any thread
+ * by nulling their slot, the nulled slot is then skipped as a tombstone.
+ * The owner never overwrites a non-null slot, so a runnable lives in
+ * exactly one slot until somebody takes it.
+ */
+class WorkStealingDeque
+{
+public:
+   enum {
+      Capacity = 256,
+      Mask = Capacity - 1
+   };
+   
+   WorkStealingDeque()
+   {
+      for (std::atomic<Runnable *> &slot : m_slots) {
+         slot.store(nullptr, std::memory_order_relaxed);
+      }
+   }
+   
+   // owner thread only, returns false when the deque can not take more runnables
+   bool push(Runnable *runnable)
+   {
+      PDK_ASSERT(runnable != nullptr);
+      pdk::pint64 bottom = m_bottom.load(std::memory_order_relaxed);
+      pdk::pint64 top = m_top.load(std::memory_order_acquire);
+      if (bottom - top >= Capacity) {
+         return false;
+      }
+      std::atomic<Runnable *> &slot = m_slots[bottom & Mask];
+      if (slot.load(std::memory_order_acquire) != nullptr) {
+         // a thief claimed this slot but did not drain it yet
+         return false;
+      }
+      slot.store(runnable, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+      return true;
+   }
+   
+   // owner thread only
+   Runnable *pop()
+   {
+      for (;;) {
+         pdk::pint64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+         m_bottom.store(bottom, std::memory_order_relaxed);
+         std::atomic_thread_fence(std::memory_order_seq_cst);
+         pdk::pint64 top = m_top.load(std::memory_order_relaxed);
+         if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+         }
+         if (top == bottom) {
+            // last element, race against the thieves
+            bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            if (!won) {
+               return nullptr;
+            }
+         }
+         Runnable *runnable = m_slots[bottom & Mask].exchange(nullptr, std::memory_order_acq_rel);
+         if (runnable) {
+            return runnable;
+         }
+         // tombstone left by tryTake() or clear(), keep looking
+      }
+   }
+   
+   // any thread, returns nullptr if empty or if we lost the race for the top slot
+   Runnable *steal()
+   {
+      pdk::pint64 top = m_top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      pdk::pint64 bottom = m_bottom.load(std::memory_order_acquire);
+      if (top >= bottom) {
+         return nullptr;
+      }
+      if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+         return nullptr;
+      }
+      return m_slots[top & Mask].exchange(nullptr, std::memory_order_acq_rel);
+   }
+   
+   bool isEmpty() const
+   {
+      return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+   }
+   
+   // any thread
+   bool tryTake(Runnable *runnable)
+   {
+      for (std::atomic<Runnable *> &slot : m_slots) {
+         Runnable *expected = runnable;
+         if (slot.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+            return true;
+         }
+      }
+      return false;
+   }
+   
+   // any thread, returns the number of runnables removed
+   template <typename Callback>
+   int takeAll(Callback callback)
+   {
+      int count = 0;
+      for (std::atomic<Runnable *> &slot : m_slots) {
+         Runnable *runnable = slot.exchange(nullptr, std::memory_order_acq_rel);
+         if (runnable) {
+            callback(runnable);
+            ++count;
+         }
+      }
+      return count;
+   }
+   
+private:
+   // keep the indices written by different threads on separate cache lines
+   alignas(64) std::atomic<pdk::pint64> m_top{0};
+   alignas(64) std::atomic<pdk::pint64> m_bottom{0};
+   alignas(64) std::atomic<Runnable *> m_slots[Capacity];
+};
+
 class ThreadPoolThread;
 class PDK_CORE_EXPORT ThreadPoolPrivate : public ObjectPrivate
 {
@@ -143,6 +275,38 @@ public:
    void stealAndRunRunnable(Runnable *runnable);
    void deletePageIfFinished(QueuePage *page);
    
+   // work stealing scheduler
+   enum {
+      LaneCount = 3,
+      MaxStealVictims = 256,
+      GlobalQueueBatchSize = 32,
+      // empty handed rounds a worker yields in before it starts sleeping
+      IdleSpinRounds = 16
+   };
+   
+   static int getPriorityLane(int priority)
+   {
+      return priority > 0 ? 0 : (priority == 0 ? 1 : 2);
+   }
+   
+   bool isWorkStealing() const
+   {
+      return m_schedulingPolicy == ThreadPool::SchedulingPolicy::WorkStealing;
+   }
+   
+   bool tryPushLocal(Runnable *runnable, int priority);
+   Runnable *findWork(ThreadPoolThread *self);
+   Runnable *takeFromGlobalQueue(ThreadPoolThread *self);
+   void registerStealVictim(ThreadPoolThread *thread);
+   void wakeWaitingThread();
+   bool tryTakeLocal(Runnable *runnable);
+   void clearLocal();
+   void requeueLocal(ThreadPoolThread *self);
+   bool hasPendingWork() const
+   {
+      return !m_queue.empty() || m_pendingTasks.load() > 0;
+   }
+   
    mutable std::mutex m_mutex;
    std::list<ThreadPoolThread *> m_allThreads;
    std::deque<ThreadPoolThread *> m_waitingThreads;
@@ -156,6 +320,15 @@ public:
    int m_activeThreads = 0;
    uint m_stackSize = 0;
    bool m_isExiting = false;
+   
+   ThreadPool::SchedulingPolicy m_schedulingPolicy = ThreadPool::SchedulingPolicy::GlobalQueue;
+   // workers whose local deques may be stolen from, appended under m_mutex
+   // and only cleared by reset() once every worker has been joined
+   std::atomic<ThreadPoolThread *> m_stealVictims[MaxStealVictims] = {};
+   std::atomic<int> m_stealVictimCount{0};
+   // runnables sitting in the local deques, not counting the global m_queue
+   std::atomic<int> m_pendingTasks{0};
+   std::atomic<int> m_idleThreads{0};
 };
 
 } // internal
@@ -20,6 +20,7 @@
 #include "pdk/kernel/CoreApplication.h"
 #include "pdk/kernel/internal/ObjectPrivate.h"
 #include "pdk/base/os/thread/Atomic.h"
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -75,12 +76,24 @@ inline bool operator<(const PostEvent &lhs, const PostEvent &rhs)
 //  The list has to be kept sorted by priority
 class PostEventList : public std::vector<PostEvent>
 {
-public:   
+public:
+   // normal priority events are pushed on a lock-free intake stack by
+   // postEvent() and moved into the list in batches by whoever holds
+   // m_mutex next, see ThreadData::drainPostEventIntake()
+   struct IntakeNode
+   {
+      IntakeNode *m_next;
+      Object *m_receiver;
+      Event *m_event;
+   };
+   
    inline PostEventList()
       : std::vector<PostEvent>(),
         m_recursion(0),
         m_startOffset(0),
-        m_insertionOffset(0)
+        m_insertionOffset(0),
+        m_intake(nullptr),
+        m_lockedPostCount(0)
    {}
    
    void addEvent(const PostEvent &event) {
@@ -100,6 +113,46 @@ public:
       }
    }
    
+   void pushIntake(IntakeNode *node)
+   {
+      IntakeNode *head = m_intake.load(std::memory_order_relaxed);
+      do {
+         node->m_next = head;
+      } while (!m_intake.compare_exchange_weak(head, node, std::memory_order_release,
+                                               std::memory_order_relaxed));
+   }
+   
+   // number of postEvent() calls that could not use the intake, normal
+   // priority posts that show up here took the mutex they meant to avoid
+   pdk::puint64 getLockedPostCount() const
+   {
+      return m_lockedPostCount.load(std::memory_order_relaxed);
+   }
+   
+   void countLockedPost()
+   {
+      m_lockedPostCount.fetch_add(1, std::memory_order_relaxed);
+   }
+   
+   bool hasPendingIntake() const
+   {
+      return m_intake.load(std::memory_order_acquire) != nullptr;
+   }
+   
+   // detach the intake, the nodes are returned in posting order
+   IntakeNode *takeIntake()
+   {
+      IntakeNode *node = m_intake.exchange(nullptr, std::memory_order_acquire);
+      IntakeNode *ordered = nullptr;
+      while (node) {
+         IntakeNode *next = node->m_next;
+         node->m_next = ordered;
+         ordered = node;
+         node = next;
+      }
+      return ordered;
+   }
+   
 public:
    // recursion == recursion count for sendPostedEvents()
    int m_recursion;
@@ -108,7 +161,9 @@ public:
    // insertionOffset == set by sendPostedEvents to tell postEvent() where to start insertions
    int m_insertionOffset;
    std::mutex m_mutex;
+   std::atomic<IntakeNode *> m_intake;
 private:
+   std::atomic<pdk::puint64> m_lockedPostCount;
    //hides because they do not keep that list sorted. addEvent must be used
    using std::vector<PostEvent>::push_back;
    using std::vector<PostEvent>::insert;
@@ -199,9 +254,12 @@ public:
    bool canWaitLocked()
    {
       std::scoped_lock locker(m_postEventList.m_mutex);
-      return m_canWait;
+      return m_canWait && !m_postEventList.hasPendingIntake();
    }
    
+   // m_postEventList.m_mutex must be held
+   void drainPostEventIntake();
+   
    // This class provides per-thread (by way of being a QThreadData
    // member) storage for qFlagLocation()
    class FlaggedDebugSignatures
@@ -275,8 +275,9 @@ enum DataEndianness
    LittleEndianness
 };
 
-struct Utf8
+struct PDK_CORE_EXPORT Utf8
 {
+   static bool isValidUtf8(const char *, int) noexcept;
    static Character *convertToUnicode(Character *, const char *, int) noexcept;
    static String convertToUnicode(const char *, int);
    static String convertToUnicode(const char *, int, TextCodec::ConverterState *);
@@ -0,0 +1,96 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_TIME_DATETIME_FORMATTER_H
+#define PDK_M_BASE_TIME_DATETIME_FORMATTER_H
+
+#include "pdk/base/time/Date.h"
+#include "pdk/base/time/Time.h"
+#include "pdk/base/time/DateTime.h"
+#include "pdk/utils/Locale.h"
+#include "pdk/utils/SharedData.h"
+
+namespace pdk {
+namespace time {
+
+// forward declare class with namespace
+namespace internal {
+class DateTimeFormatterPrivate;
+} // internal
+
+using internal::DateTimeFormatterPrivate;
+using pdk::lang::Character;
+using pdk::lang::String;
+using pdk::lang::StringView;
+using pdk::utils::Locale;
+using pdk::utils::SharedDataPointer;
+
+// Compiles a date time format once into a plan that can be applied to any
+// number of values. format() writes into a caller supplied buffer and never
+// allocates, except for time zone abbreviations of Date Times with a
+// LocalTime or TimeZone spec. The plan captures the locale's names and
+// digits when it is built, so later changes to the default locale do not
+// affect it.
+class PDK_CORE_EXPORT DateTimeFormatter
+{
+public:
+   DateTimeFormatter();
+   explicit DateTimeFormatter(pdk::DateFormat format, const Locale &locale = Locale::c());
+   explicit DateTimeFormatter(StringView format, const Locale &locale = Locale::c());
+   DateTimeFormatter(const DateTimeFormatter &other);
+   DateTimeFormatter(DateTimeFormatter &&other) noexcept;
+   ~DateTimeFormatter();
+   
+   DateTimeFormatter &operator=(const DateTimeFormatter &other);
+   DateTimeFormatter &operator=(DateTimeFormatter &&other) noexcept;
+   
+   bool isValid() const;
+   // Upper bound of what format() writes, in Characters or UTF-8 bytes,
+   // counting 32 for a time zone abbreviation
+   int getMaxLength() const;
+   
+   // return the number of units written, or -1 if the value is invalid or
+   // does not fit in size
+   int format(const DateTime &dateTime, Character *buffer, int size) const;
+   int format(const DateTime &dateTime, char *buffer, int size) const;
+   int format(const Date &date, Character *buffer, int size) const;
+   int format(const Date &date, char *buffer, int size) const;
+   int format(const Time &time, Character *buffer, int size) const;
+   int format(const Time &time, char *buffer, int size) const;
+   // Formats the wall clock time offsetFromUtc seconds east of UTC without
+   // building a DateTime, an offset of 0 is formatted as UTC
+   int format(pdk::pint64 msecsSinceEpoch, int offsetFromUtc, Character *buffer, int size) const;
+   int format(pdk::pint64 msecsSinceEpoch, int offsetFromUtc, char *buffer, int size) const;
+   
+   String toString(const DateTime &dateTime) const;
+   String toString(const Date &date) const;
+   String toString(const Time &time) const;
+   
+   DateTime parse(StringView text) const;
+   DateTime parse(const char *text, int size) const;
+   
+   // ISO 8601 "yyyy-MM-dd[THH:mm[:ss[.fff]]][Z|+HH:mm]", without going
+   // through Locale, 24:00 is read as midnight of the next day
+   static DateTime parseIsoDateTime(StringView text);
+   static DateTime parseIsoDateTime(const char *text, int size);
+   
+private:
+   SharedDataPointer<DateTimeFormatterPrivate> m_implPtr;
+};
+
+} // time
+} // pdk
+
+#endif // PDK_M_BASE_TIME_DATETIME_FORMATTER_H
@@ -0,0 +1,152 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_TIME_INTERNAL_DATETIME_FORMATTER_PRIVATE_H
+#define PDK_M_BASE_TIME_INTERNAL_DATETIME_FORMATTER_PRIVATE_H
+
+#include "pdk/base/time/DateTimeFormatter.h"
+#include "pdk/base/ds/ByteArray.h"
+#include "pdk/utils/SharedData.h"
+
+#include <vector>
+
+namespace pdk {
+namespace time {
+namespace internal {
+
+using pdk::ds::ByteArray;
+using pdk::utils::SharedData;
+
+// A piece of plan text kept in both output encodings
+struct DateTimeFormatText
+{
+   String m_text;
+   ByteArray m_utf8;
+};
+
+// Broken down value a plan is applied to
+struct DateTimeFormatFields
+{
+   int m_year;
+   int m_month;
+   int m_day;
+   int m_dayOfWeek;
+   int m_hour;
+   int m_minute;
+   int m_second;
+   int m_msec;
+   int m_offsetFromUtc;
+   pdk::TimeSpec m_spec;
+   // DatePart and/or TimePart, see DateTimeFormatterPrivate::Part
+   int m_parts;
+   // source of the zone abbreviation, null when formatting msecs and an offset
+   const DateTime *m_dateTime;
+};
+
+class DateTimeFormatterPrivate : public SharedData
+{
+public:
+   enum class Field : pdk::puint8
+   {
+      Literal,
+      Year4,
+      Year2,
+      YearNumber,
+      Month,
+      Month2,
+      MonthShortName,
+      MonthLongName,
+      Day,
+      Day2,
+      DayShortName,
+      DayLongName,
+      Hour12,
+      Hour12Padded,
+      Hour,
+      Hour2,
+      Minute,
+      Minute2,
+      Second,
+      Second2,
+      Msec3,
+      MsecTrimmed,
+      AmPmLower,
+      AmPmUpper,
+      ZoneAbbreviation,
+      // Z, or +HH:mm
+      IsoOffset,
+      // +HHmm
+      RfcOffset,
+      // nothing for local time, " GMT[+HHmm]" or " <abbreviation>"
+      TextZone
+   };
+   
+   enum Part
+   {
+      DatePart = 0x1,
+      TimePart = 0x2
+   };
+   
+   struct Step
+   {
+      Field m_field;
+      // parts the value needs for this step to apply
+      pdk::puint8 m_parts;
+      // index into m_texts of the literal, or of the format text a field
+      // falls back to when the value lacks its part, TextZone keeps its
+      // " GMT" there, -1 for none
+      int m_text;
+   };
+   
+   DateTimeFormatterPrivate();
+   
+   void compile(StringView format, const Locale &locale);
+   void compile(pdk::DateFormat format, const Locale &locale);
+   
+   template <typename CharType>
+   int write(const DateTimeFormatFields &fields, CharType *buffer, int size) const;
+   template <typename CharType>
+   DateTime read(const CharType *text, int size) const;
+   
+   std::vector<Step> m_steps;
+   std::vector<DateTimeFormatText> m_texts;
+   // indexes by FormatType: [0] long, [1] short
+   DateTimeFormatText m_monthNames[2][12];
+   DateTimeFormatText m_dayNames[2][7];
+   // [0] lower case, [1] upper case
+   DateTimeFormatText m_amText[2];
+   DateTimeFormatText m_pmText[2];
+   char16_t m_zero;
+   int m_maxLength;
+   // parts missing from the value skip their steps instead of falling back
+   // to the format text, used by the pdk::DateFormat plans
+   bool m_skipMissingParts;
+   // ISO 8601 only covers years 0 to 9999
+   bool m_isoYearRange;
+   bool m_needsOffset;
+   bool m_needsNames;
+   
+private:
+   void addStep(Field field, int parts, StringView text);
+   void addLiteral(StringView text, int parts = 0);
+   void addText(const String &text, int parts = 0);
+   void captureNames(const Locale &locale);
+};
+
+} // internal
+} // time
+} // pdk
+
+#endif // PDK_M_BASE_TIME_INTERNAL_DATETIME_FORMATTER_PRIVATE_H
@@ -34,6 +34,7 @@ PDK_FORWARD_DECLARE_OBJC_CLASS(NSTimeZone);
 
 #include <vector>
 #include <list>
+#include <memory>
 
 namespace pdk {
 namespace time {
@@ -260,6 +261,8 @@ constexpr inline bool operator!=(const TzTransitionRule &lhs, const TzTransition
    return !operator==(lhs, rhs);
 }
 
+struct TzZoneData;
+
 class PDK_UNITTEST_EXPORT TzTimeZonePrivate final : public TimeZonePrivate
 {
    TzTimeZonePrivate(const TzTimeZonePrivate &) = default;
@@ -305,13 +308,11 @@ private:
    void init(const ByteArray &ianaId);
    
    Data dataForTzTransition(TzTransitionTime tran) const;
-   std::vector<TzTransitionTime> m_tranTimes;
-   std::vector<TzTransitionRule> m_tranRules;
-   std::list<ByteArray> m_abbreviations;
+   // parsed tzfile tables, shared with every other instance of the same zone
+   std::shared_ptr<const TzZoneData> m_zone;
 #if PDK_CONFIG(icu)
    mutable pdk::utils::SharedDataPointer<TimeZonePrivate> m_icu;
 #endif
-   ByteArray m_posixRule;
 };
 
 #endif // PDK_OS_UNIX
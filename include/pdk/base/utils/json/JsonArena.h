@@ -0,0 +1,78 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_JSON_JSON_ARENA_H
+#define PDK_M_BASE_JSON_JSON_ARENA_H
+
+#include "pdk/global/Global.h"
+
+namespace pdk {
+namespace utils {
+namespace json {
+
+namespace jsonprivate {
+class Parser;
+struct ParserStacks;
+}
+
+// Monotonic memory for JsonDocument::fromJson(). A document parsed into
+// the arena reads its values from arena memory in place, parsing it costs
+// no allocation once the arena has grown to the size of the documents it
+// sees. Modifying such a document copies it to the heap first.
+//
+// reset() takes constant time and keeps the blocks for the next documents.
+// Every document, object, array and value read from the arena must be gone
+// by then, and the arena must outlive them. An arena is meant to be used
+// by one thread, typically one per worker, reset after each request.
+class PDK_CORE_EXPORT JsonArena
+{
+public:
+   explicit JsonArena(int blockSize = 16 * 1024);
+   ~JsonArena();
+
+   void reset();
+
+   int getBlockSize() const;
+   // bytes handed out since the last reset
+   size_t getBytesUsed() const;
+   // bytes held in blocks, in use or not
+   size_t getBytesReserved() const;
+
+private:
+   PDK_DISABLE_COPY(JsonArena);
+   friend class jsonprivate::Parser;
+   struct Block;
+
+   char *allocate(size_t size);
+   // grows the last allocation in place when the block has room left,
+   // otherwise moves the first size bytes to a new allocation
+   char *reallocate(char *ptr, size_t size, size_t newSize);
+   jsonprivate::ParserStacks *getParserStacks();
+
+   Block *m_first;
+   Block *m_current;
+   size_t m_offset;
+   char *m_last;
+   size_t m_blockSize;
+   size_t m_bytesUsed;
+   size_t m_bytesReserved;
+   jsonprivate::ParserStacks *m_parserStacks;
+};
+
+} // json
+} // utils
+} // pdk
+
+#endif // PDK_M_BASE_JSON_JSON_ARENA_H
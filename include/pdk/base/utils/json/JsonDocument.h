@@ -44,6 +44,8 @@ namespace jsonprivate {
 class Parser;
 }
 
+class JsonArena;
+
 using pdk::io::Debug;
 using pdk::ds::ByteArray;
 using pdk::lang::String;
@@ -108,12 +110,18 @@ public:
       std::swap(m_data, other.m_data);
    }
    
+   // Validate checks the root container when the data is loaded and every
+   // nested container when it is first reached, a corrupted one reads as an
+   // undefined value. The binary format addresses at most 2^27 - 1 bytes,
+   // larger documents are rejected
    enum class DataValidation
    {
       Validate,
       BypassValidation
    };
    
+   // data is read in place and must outlive the document, a read only
+   // File::map() of a binary document works, it is never written to
    static JsonDocument fromRawData(const char *data, int size, 
                                    DataValidation validation = DataValidation::Validate);
    const char *getRawData(int *size) const;
@@ -132,6 +140,10 @@ public:
    };
    
    static JsonDocument fromJson(const ByteArray &json, JsonParseError *error = nullptr);
+   // parses into arena memory instead of the heap, see JsonArena for how
+   // long the document stays valid
+   static JsonDocument fromJson(const ByteArray &json, JsonArena *arena,
+                                JsonParseError *error = nullptr);
    
 #if !defined(PDK_JSON_READONLY)
    ByteArray toJson() const;
@@ -18,7 +18,9 @@
 
 #include "pdk/global/Global.h"
 #include "pdk/base/utils/json/JsonDocument.h"
-#include "pdk/base/ds/VarLengthArray.h"
+#include "pdk/base/utils/json/JsonArena.h"
+#include "pdk/base/utils/json/internal/JsonPrivate.h"
+#include "pdk/base/utils/json/internal/JsonScannerPrivate.h"
 #include <vector>
 
 namespace pdk {
@@ -26,10 +28,26 @@ namespace utils {
 namespace json {
 namespace jsonprivate {
 
+// member offsets of the open objects and values of the open arrays, one
+// stack for all nesting levels. The innermost container owns the top of
+// the stack while it is parsed and pops its part when it is done. The
+// blocks and structural positions of the index are kept here as well
+struct ParserStacks
+{
+   std::vector<uint> m_offsets;
+   std::vector<jsonprivate::LocalValue> m_values;
+   std::vector<StructuralIndex::Block> m_blocks;
+   std::vector<uint> m_structurals;
+};
+
 class Parser
 {
 public:
-   Parser(const char *json, int length);
+   Parser(const char *json, int length, JsonArena *arena = nullptr);
+   
+   // the binary form can be several times larger than the text, from
+   // this length on the document is written as version 2 with wide offsets
+   static constexpr int WIDE_OFFSETS_LENGTH = jsonprivate::LocalValue::MaxSize / 8;
    
    JsonDocument parse(JsonParseError *error);
    
@@ -38,19 +56,36 @@ public:
    public:
       ParsedObject(Parser *parser, int pos) 
          : m_parser(parser),
-           m_objectPosition(pos)
+           m_objectPosition(pos),
+           m_offsets(parser->m_stacks->m_offsets),
+           m_begin(m_offsets.size())
+      {}
+      
+      ~ParsedObject()
       {
-         m_offsets.reserve(64);
+         m_offsets.resize(m_begin);
       }
+      
       void insert(uint offset);
       
+      int getSize() const
+      {
+         return m_offsets.size() - m_begin;
+      }
+      
+      const uint *getData() const
+      {
+         return m_offsets.data() + m_begin;
+      }
+      
       Parser *m_parser;
       int m_objectPosition;
-      std::vector<uint> m_offsets;
+      std::vector<uint> &m_offsets;
+      size_t m_begin;
       
       inline jsonprivate::LocalEntry *entryAt(int i) const
       {
-         return reinterpret_cast<jsonprivate::LocalEntry *>(m_parser->m_data + m_objectPosition + m_offsets[i]);
+         return reinterpret_cast<jsonprivate::LocalEntry *>(m_parser->m_data + m_objectPosition + m_offsets[m_begin + i]);
       }
    };
 private:
@@ -73,12 +108,23 @@ private:
    int m_current;
    int m_nestingLevel;
    JsonParseError::ParseError m_lastError;
+   JsonArena *m_arena;
+   ParserStacks *m_stacks;
+   ParserStacks m_ownStacks;
+   StructuralIndex m_index;
+   // the first structural position nextToken() has not passed yet
+   const uint *m_nextStructural;
+   bool m_useIndex;
+   bool m_wideOffsets;
    
    inline int reserveSpace(int space)
    {
       if (m_current + space >= m_dataLength) {
+         int oldLength = m_dataLength;
          m_dataLength = 2 * m_dataLength + space;
-         char *newData = (char *)realloc(m_data, m_dataLength);
+         char *newData = m_arena
+               ? m_arena->reallocate(m_data, oldLength, m_dataLength)
+               : (char *)realloc(m_data, m_dataLength);
          if (!newData) {
             m_lastError = JsonParseError::ParseError::DocumentTooLarge;
             return -1;
@@ -89,6 +135,17 @@ private:
       m_current += space;
       return pos;
    }
+   
+   inline bool storeValueOffset(jsonprivate::LocalValue *val, int offset)
+   {
+      uint stored = m_wideOffsets ? uint(offset) >> 2 : uint(offset);
+      if (stored >= jsonprivate::LocalValue::MaxSize) {
+         m_lastError = JsonParseError::ParseError::DocumentTooLarge;
+         return false;
+      }
+      val->m_value = stored;
+      return true;
+   }
 };
 
 } // jsonprivate
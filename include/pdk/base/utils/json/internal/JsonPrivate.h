@@ -22,13 +22,16 @@
 #include "pdk/base/utils/json/JsonArray.h"
 #include "pdk/base/os/thread/Atomic.h"
 #include "pdk/base/lang/String.h"
+#include "pdk/base/ds/ByteArray.h"
 #include "pdk/global/Endian.h"
 #include "pdk/global/internal/EndianPrivate.h"
 #include "pdk/global/Numeric.h"
 #include "pdk/global/Logging.h"
 #include "pdk/pal/kernel/Simd.h"
 #include <limits.h>
+#include <atomic>
 #include <limits>
+#include <memory>
 
 namespace pdk {
 namespace utils {
@@ -101,6 +104,7 @@ class LocalArray;
 class LocalObject;
 class LocalValue;
 class LocalEntry;
+class Data;
 
 template<typename T>
 using local_littleendian = LEInteger<T>;
@@ -503,7 +507,10 @@ public:
    union {
       uint m_dummy;
       ple_bitfield<0, 1> m_isObject;
-      ple_bitfield<1, 31> m_length;
+      ple_bitfield<1, 30> m_length;
+      // only in version 2 documents, the value offsets of this container
+      // count 4 byte units, which lets it grow to 512 MB instead of 128 MB
+      ple_bitfield<31, 1> m_wideOffsets;
    };
    offset m_tableOffset;
    // content follows here
@@ -517,6 +524,19 @@ public:
    {
       return !isObject();}
    
+   inline uint getMaxSize() const;
+   
+   // converts between byte offsets and what LocalValue::m_value stores,
+   // everything a value points to is 4 byte aligned
+   inline uint toValueOffset(uint byteOffset) const
+   {
+      return m_wideOffsets ? byteOffset >> 2 : byteOffset;
+   }
+   
+   inline uint fromValueOffset(uint valueOffset) const
+   {
+      return m_wideOffsets ? valueOffset << 2 : valueOffset;
+   }
    
    inline offset *getTable() const
    {
@@ -525,6 +545,9 @@ public:
    
    int reserveSpace(uint dataSize, int posInTable, uint numItems, bool replace);
    void removeItems(int pos, int numItems);
+   // checks the table and the values of this container, nested containers
+   // only have to fit in their slot, they are checked once they are reached
+   bool isShallowValid() const;
 };
 
 class LocalObject : public Base
@@ -536,7 +559,7 @@ public:
    }
    int indexOf(const String &key, bool *exists) const;
    int indexOf(Latin1String key, bool *exists) const;
-   bool isValid(int maxSize) const;
+   bool isValid(int maxSize, bool recursive = true) const;
 };
 
 
@@ -546,14 +569,15 @@ public:
    inline LocalValue at(int i) const;
    inline LocalValue &operator [](int i);
    
-   bool isValid(int maxSize) const;
+   bool isValid(int maxSize, bool recursive = true) const;
 };
 
 class LocalValue
 {
 public:
    enum {
-      MaxSize = (1<<27) - 1
+      MaxSize = (1<<27) - 1,
+      MaxWideSize = MaxSize * 4
    };
    union {
       uint m_dummy;
@@ -566,7 +590,7 @@ public:
    
    inline char *getData(const Base *base) const
    {
-      return ((char *)const_cast<Base *>(base)) + m_value;
+      return ((char *)const_cast<Base *>(base)) + base->fromValueOffset(m_value);
    }
    
    int getUsedStorage(const Base *b) const;
@@ -577,12 +601,18 @@ public:
    LocalString asString(const Base *b) const;
    LocalLatin1String asLatin1String(const Base *b) const;
    Base *base(const Base *b) const;
-   bool isValid(const Base *b) const;
+   bool isValid(const Base *b, bool recursive = true) const;
    static int requiredStorage(JsonValue &v, bool *compressed);
-   static uint valueToStore(const JsonValue &v, uint offset);
-   static void copyData(const JsonValue &v, char *dest, bool compressed);
+   static uint valueToStore(const Base *b, const JsonValue &v, uint offset);
+   // a container copied from a version 2 document turns target into one
+   static void copyData(const JsonValue &v, char *dest, bool compressed, Data *target);
 };
 
+inline uint Base::getMaxSize() const
+{
+   return m_wideOffsets ? LocalValue::MaxWideSize : LocalValue::MaxSize;
+}
+
 inline LocalValue LocalArray::at(int i) const
 {
    return *(LocalValue *) (getTable() + i);
@@ -699,11 +729,18 @@ class Header
 {
 public:
    ple_uint m_tag;
-   ple_uint m_version; // 1
+   // 1, or 2 when containers may use wide offsets, see Base::m_wideOffsets
+   ple_uint m_version;
    Base *getRoot()
    {
       return (Base *)(this + 1);
    }
+   
+   // the largest document of a version, including the header
+   static int getMaxSize(uint version)
+   {
+      return version >= 2u ? LocalValue::MaxWideSize : LocalValue::MaxSize;
+   }
 };
 
 inline bool LocalValue::toBoolean() const
@@ -718,7 +755,7 @@ inline double LocalValue::toDouble(const Base *base) const
    if (m_latinOrIntValue) {
       return m_intValue;
    }
-   pdk::puint64 i = pdk::from_little_endian<pdk::puint64>((const uchar *)base + m_value);
+   pdk::puint64 i = pdk::from_little_endian<pdk::puint64>((const uchar *)base + base->fromValueOffset(m_value));
    double d;
    memcpy(&d, &i, sizeof(double));
    return d;
@@ -770,7 +807,17 @@ public:
       Header *m_header;
    };
    uint m_compactionCounter : 31;
+   // raw data we don't own (fromRawData(), or a ByteArray / mapped file we
+   // point into) is never written to, the first modification detaches
    uint m_ownsData : 1;
+   // keeps the buffer of fromBinaryData() alive while we read from it in place
+   ByteArray m_sharedData;
+   // only the root was validated when the data was loaded, every other
+   // container is checked by isValidContainer() when a value reaches it
+   bool m_checkContainers = false;
+   // one bit per 4 byte offset into the data, set once the container that
+   // starts there passed its check
+   std::unique_ptr<std::atomic<uint>[]> m_validContainers;
    
    inline Data(char *raw, int a)
       : m_alloc(a), 
@@ -796,6 +843,7 @@ public:
       base->m_isObject = (valueType == JsonValue::Type::Object);
       base->m_tableOffset = sizeof(Base);
       base->m_length = 0;
+      base->m_wideOffsets = false;
    }
    
    inline ~Data()
@@ -823,15 +871,17 @@ public:
    Data *clone(Base *base, int reserve = 0)
    {
       int size = sizeof(Header) + base->m_size;
-      if (base == m_header->getRoot() && m_ref.load() == 1 && m_alloc >= size + reserve) {
+      if (base == m_header->getRoot() && m_ref.load() == 1 && m_ownsData &&
+          m_alloc >= size + reserve) {
          return this;
       }
       if (reserve) {
          if (reserve < 128) {
             reserve = 128;
          }
-         size = std::max(size + reserve, std::min(size *2, (int)LocalValue::MaxSize));
-         if (size > LocalValue::MaxSize) {
+         const int maxSize = Header::getMaxSize(m_header->m_version);
+         size = std::max(size + reserve, std::min(size *2, maxSize));
+         if (size > maxSize) {
             warning_stream("Json: Document too large to store in data structure");
             return 0;
          }
@@ -841,14 +891,20 @@ public:
       memcpy(raw + sizeof(Header), base, base->m_size);
       Header *header = (Header *)raw;
       header->m_tag = JsonDocument::BinaryFormatTag;
-      header->m_version = 1;
+      header->m_version = m_header->m_version;
       Data *data = new Data(raw, size);
       data->m_compactionCounter = (base == header->getRoot()) ? m_compactionCounter : 0;
+      // the nested containers were copied unchecked
+      if (m_checkContainers) {
+         data->checkContainersLazily();
+      }
       return data;
    }
    
    void compact();
-   bool valid() const;
+   bool valid(bool recursive = true) const;
+   void checkContainersLazily();
+   bool isValidContainer(const Base *base);
    
 private:
    PDK_DISABLE_COPY(Data);
@@ -0,0 +1,114 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_M_BASE_JSON_INTERNAL_JSON_SCANNER_PRIVATE_H
+#define PDK_M_BASE_JSON_INTERNAL_JSON_SCANNER_PRIVATE_H
+
+#include "pdk/global/Global.h"
+#include "pdk/kernel/Algorithms.h"
+#include <vector>
+
+namespace pdk {
+namespace utils {
+namespace json {
+namespace jsonprivate {
+
+// First stage of the parser for large inputs. Every byte is classified in
+// blocks of 64 before the tree builder runs. Unescaped quotes are folded
+// into a mask of the bytes inside strings, which leaves the structural
+// characters outside of them as a list of positions for nextToken() to
+// walk. Whitespace is skipped and plain string runs are copied with a bit
+// scan instead of a byte loop. The index only answers questions about well
+// formed input, the tree builder still checks every byte it consumes, so
+// errors are reported at the same offsets with or without the index.
+class StructuralIndex
+{
+public:
+   // inputs below this size are parsed without an index
+   static constexpr int MIN_LENGTH = 1024;
+
+   struct Block
+   {
+      // anything but space, tab, line feed and carriage return
+      pdk::puint64 m_tokens;
+      // quotes, backslashes and the bytes of multi byte UTF-8 sequences
+      pdk::puint64 m_stringStops;
+      // opening quotes and string contents, closing quotes are outside
+      pdk::puint64 m_inString;
+   };
+
+   StructuralIndex(std::vector<Block> &blocks, std::vector<uint> &structurals)
+      : m_begin(nullptr),
+        m_end(nullptr),
+        m_blocks(blocks),
+        m_structurals(structurals)
+   {}
+
+   // bits from length on are set in the token and stop masks and clear in
+   // the string mask, a scan never runs past the end
+   void build(const char *json, int length);
+
+   // offsets of the brackets, braces, colons and commas outside of strings
+   // and of the opening quotes, in order and closed by the length
+   const uint *getStructurals() const
+   {
+      return m_structurals.data();
+   }
+
+   // first byte at or after pos that is not whitespace, or the end
+   const char *skipSpace(const char *pos) const
+   {
+      return find(pos, &Block::m_tokens, 0);
+   }
+
+   // first byte at or after pos a string can not be copied over, or the end
+   const char *findStringStop(const char *pos) const
+   {
+      return find(pos, &Block::m_stringStops, 0);
+   }
+
+   // the closing quote of the string pos is in, or the end
+   const char *findStringEnd(const char *pos) const
+   {
+      return find(pos, &Block::m_inString, ~pdk::puint64(0));
+   }
+
+private:
+   const char *find(const char *pos, pdk::puint64 Block::*mask, pdk::puint64 invert) const
+   {
+      if (pos >= m_end) {
+         return pos;
+      }
+      size_t index = pos - m_begin;
+      const Block *block = m_blocks.data() + (index >> 6);
+      pdk::puint64 bits = ((block->*mask) ^ invert) & (~pdk::puint64(0) << (index & 63));
+      while (!bits) {
+         bits = (++block)->*mask ^ invert;
+      }
+      return m_begin + ((block - m_blocks.data()) << 6) + pdk::count_trailing_zero_bits(bits);
+   }
+
+   const char *m_begin;
+   const char *m_end;
+   std::vector<Block> &m_blocks;
+   std::vector<uint> &m_structurals;
+};
+
+} // jsonprivate
+} // json
+} // utils
+} // pdk
+
+#endif // PDK_M_BASE_JSON_INTERNAL_JSON_SCANNER_PRIVATE_H
@@ -35,8 +35,12 @@ using pdk::ds::ByteArray;
 class Writer
 {
 public:
-    static void objectToJson(const LocalObject *object, ByteArray &json, int indent, bool compact = false);
-    static void arrayToJson(const LocalArray *array, ByteArray &json, int indent, bool compact = false);
+    // checkContainers skips nested containers that fail Base::isShallowValid(),
+    // they are written as null
+    static void objectToJson(const LocalObject *object, ByteArray &json, int indent, bool compact = false,
+                             bool checkContainers = false);
+    static void arrayToJson(const LocalArray *array, ByteArray &json, int indent, bool compact = false,
+                            bool checkContainers = false);
 };
 
 } // jsonprivate
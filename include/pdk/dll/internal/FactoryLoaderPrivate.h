@@ -27,11 +27,21 @@
 
 #include <map>
 #include <list>
+#include <vector>
 
 namespace pdk {
+
+// forward declare class with namespace
+namespace os {
+namespace thread {
+class ThreadPool;
+} // thread
+} // os
+
 namespace dll {
 namespace internal {
 
+using pdk::os::thread::ThreadPool;
 using pdk::utils::json::JsonDocument;
 using pdk::utils::json::JsonObject;
 using pdk::ds::ByteArray;
@@ -47,6 +57,21 @@ inline JsonDocument json_from_raw_library_meta_data(const char *raw)
    return JsonDocument::fromBinaryData(json);
 }
 
+// how many static plugins were registered so far, lets FactoryLoader tell
+// whether its key index is stale without copying the list
+PDK_CORE_EXPORT size_t static_plugin_count();
+
+// Where the time went for one file a FactoryLoader looked at
+struct PluginLoadTiming
+{
+   String m_fileName;
+   // finding and checking the plugin metadata
+   pdk::pint64 m_scanNsecs;
+   // dlopen, relocation and the plugin's static initialization
+   pdk::pint64 m_loadNsecs;
+   bool m_loaded;
+};
+
 class FactoryLoaderPrivate;
 class PDK_CORE_EXPORT FactoryLoader : public Object
 {
@@ -61,6 +86,12 @@ public:
    ~FactoryLoader();
    
    void update();
+   // Like update(), but validates the files and loads the plugins that
+   // implement our interface on pool, the global one by default. Plugins
+   // loaded this way run their static initialization concurrently, and the
+   // caller must not be one of the pool's own threads
+   void updateConcurrently(ThreadPool *pool = nullptr, bool load = true);
+   std::vector<PluginLoadTiming> getLoadTimings() const;
    static void refreshAll();
    
 #if defined(PDK_OS_UNIX) && !defined (PDK_OS_MAC)
@@ -73,6 +104,11 @@ public:
    
    std::list<JsonObject> getMetaData() const;
    Object *getInstance(int index) const;
+   
+private:
+#if PDK_CONFIG(library)
+   void scan(ThreadPool *pool, bool load);
+#endif
 };
 
 template <class PluginInterface, class FactoryInterface, typename ...Args>
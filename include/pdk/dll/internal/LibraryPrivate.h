@@ -92,6 +92,9 @@ public:
    
    void updatePluginState();
    bool isPlugin();
+   // takes metadata a PluginIndex kept for this file instead of scanning
+   // it, and for a file that is not a plugin the error found back then
+   bool isPlugin(const JsonObject &indexedMetaData, const String &indexedErrorString);
    
 private:
    explicit LibraryPrivate(const String &canonicalFileName, const String &version, Library::LoadHints loadHints);
@@ -100,6 +103,7 @@ private:
    bool loadSys();
    bool unloadSys();
    FuncPointer resolveSys(const char *);
+   void checkPluginVersion();
    AtomicInt m_loadHintsInt;
    /// counts how many Library or PluginLoader are attached to us, plus 1 if it's loaded
    AtomicInt m_libraryRefCount;
@@ -0,0 +1,113 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_DLL_INTERNAL_PLUGIN_INDEX_PRIVATE_H
+#define PDK_DLL_INTERNAL_PLUGIN_INDEX_PRIVATE_H
+
+#include "pdk/global/Global.h"
+#include "pdk/base/lang/String.h"
+#include "pdk/base/utils/json/JsonObject.h"
+
+#include <unordered_map>
+
+namespace pdk {
+namespace dll {
+namespace internal {
+
+using pdk::lang::String;
+using pdk::utils::json::JsonObject;
+
+// What tells one version of a plugin file from the next, a rebuilt or
+// replaced file changes at least one of these
+struct PluginFileStamp
+{
+   pdk::pint64 m_size = -1;
+   // nanoseconds since the epoch
+   pdk::pint64 m_modified = 0;
+   pdk::puint64 m_inode = 0;
+
+   bool isValid() const
+   {
+      return m_size >= 0;
+   }
+
+   bool operator==(const PluginFileStamp &other) const
+   {
+      return m_size == other.m_size && m_modified == other.m_modified
+            && m_inode == other.m_inode;
+   }
+
+   bool operator!=(const PluginFileStamp &other) const
+   {
+      return !(*this == other);
+   }
+
+   static PluginFileStamp fromFile(const String &fileName);
+};
+
+// On disk index of the metadata FactoryLoader found in one plugin
+// directory. Files whose stamp still matches are neither mapped nor parsed
+// again, files that turned out not to be plugins are remembered too. The
+// index is kept as binary JSON under the generic cache location, or under
+// PDK_PLUGIN_INDEX_PATH, and PDK_NO_PLUGIN_INDEX turns it off
+class PluginIndex
+{
+public:
+   explicit PluginIndex(const String &directory);
+
+   bool isEnabled() const
+   {
+      return !m_indexFileName.isEmpty();
+   }
+
+   // true when fileName is indexed with this stamp, metaData is left empty
+   // for files that are not plugins and errorString says why
+   bool lookup(const String &fileName, const PluginFileStamp &stamp, JsonObject *metaData,
+               String *errorString);
+   void insert(const String &fileName, const PluginFileStamp &stamp, const JsonObject &metaData,
+               const String &errorString = String());
+   // writes the index back when entries were added, or when files that
+   // were indexed have not been looked up since it was loaded
+   bool save();
+
+   const String &getIndexFileName() const
+   {
+      return m_indexFileName;
+   }
+
+   static String getIndexFileName(const String &directory);
+
+private:
+   struct Entry
+   {
+      PluginFileStamp m_stamp;
+      JsonObject m_metaData;
+      String m_errorString;
+      bool m_seen;
+   };
+
+   void load();
+
+   String m_directory;
+   String m_indexFileName;
+   std::unordered_map<String, Entry> m_entries;
+   bool m_dirty;
+};
+
+} // internal
+} // dll
+} // pdk
+
+#endif // PDK_DLL_INTERNAL_PLUGIN_INDEX_PRIVATE_H
@@ -178,6 +178,46 @@ PDK_CORE_EXPORT void errno_warning(const char *msg, ...);
 typedef void (*MessageHandler)(pdk::MsgType, const MessageLogContext&, const String &);
 PDK_CORE_EXPORT MessageHandler install_message_handler(MessageHandler);
 
+// asynchronous output of the default message handler, the calling thread
+// formats the message and appends it to its own lock free ring buffer, a
+// background thread writes the buffered messages out in batches
+struct AsyncLogRecord
+{
+   pdk::MsgType m_type;
+   const char *m_data; // formatted message including the trailing newline
+   int m_size;
+};
+
+typedef void (*AsyncLogSink)(const AsyncLogRecord *records, int count, void *userData);
+
+struct AsyncLoggingOptions
+{
+   enum class OverflowPolicy
+   {
+      DropMessage,
+      BlockProducer
+   };
+   
+   // bytes of ring buffer per logging thread, rounded up to a power of two
+   int m_bufferSize = 256 * 1024;
+   OverflowPolicy m_overflowPolicy = OverflowPolicy::DropMessage;
+   // milliseconds a message may wait before the writer wakes up by itself
+   int m_flushInterval = 20;
+   // custom sink, when not set messages go to m_fileName or stderr
+   AsyncLogSink m_sink = nullptr;
+   void *m_sinkData = nullptr;
+   const char *m_fileName = nullptr;
+   // rotate the file once it grows past this many bytes, 0 never rotates
+   pdk::pint64 m_maxFileSize = 0;
+   int m_maxBackupFiles = 3;
+};
+
+PDK_CORE_EXPORT bool enable_async_logging(const AsyncLoggingOptions &options = AsyncLoggingOptions());
+PDK_CORE_EXPORT void disable_async_logging();
+PDK_CORE_EXPORT bool is_async_logging_enabled();
+PDK_CORE_EXPORT void flush_async_logging();
+PDK_CORE_EXPORT pdk::puint64 get_dropped_log_message_count();
+
 PDK_CORE_EXPORT void set_message_pattern(const String &messagePattern);
 PDK_CORE_EXPORT String format_log_message(pdk::MsgType type, const MessageLogContext &context,
                                           const String &buf);
@@ -0,0 +1,40 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_GLOBAL_INTERNAL_ASYNC_LOGGING_PRIVATE_H
+#define PDK_GLOBAL_INTERNAL_ASYNC_LOGGING_PRIVATE_H
+
+#include "pdk/global/Global.h"
+
+namespace pdk {
+
+// forward declare class with namespace
+namespace lang {
+class String;
+} // lang
+
+namespace internal {
+
+// queues a formatted message when asynchronous logging is enabled, returns
+// false when the caller has to write the message itself
+bool async_log_message(pdk::MsgType type, const lang::String &message);
+
+// the rings of logging threads that are still held, for the unit tests
+PDK_CORE_EXPORT int async_log_ring_count();
+
+} // internal
+} // pdk
+
+#endif // PDK_GLOBAL_INTERNAL_ASYNC_LOGGING_PRIVATE_H
@@ -0,0 +1,82 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_KERNEL_EVENT_DISPATCHER_EPOLL_H
+#define PDK_KERNEL_EVENT_DISPATCHER_EPOLL_H
+
+#include "pdk/kernel/EventDispatcherUnix.h"
+
+#include <vector>
+
+// forward declare with global namespace
+struct epoll_event;
+
+namespace pdk {
+namespace kernel {
+
+namespace internal {
+class EventDispatcherEpollPrivate;
+} // internal
+
+using internal::EventDispatcherEpollPrivate;
+
+// Linux only dispatcher, socket notifiers are registered with the kernel
+// as they come and go instead of rebuilding a pollfd array on every wakeup.
+// Timers and the thread pipe are shared with EventDispatcherUNIX.
+class PDK_CORE_EXPORT EventDispatcherEpoll : public EventDispatcherUNIX
+{
+   PDK_DECLARE_PRIVATE(EventDispatcherEpoll);
+   
+public:
+   explicit EventDispatcherEpoll(Object *parent = nullptr);
+   ~EventDispatcherEpoll();
+   
+   bool processEvents(EventLoop::ProcessEventsFlags flags) override;
+   
+   void registerSocketNotifier(SocketNotifier *notifier) override;
+   void unregisterSocketNotifier(SocketNotifier *notifier) override;
+   
+   // false when the PDK_EVENT_DISPATCHER_POLL environment variable asks for
+   // the poll(2) based dispatcher
+   static bool isPreferred();
+};
+
+namespace internal {
+
+class PDK_CORE_EXPORT EventDispatcherEpollPrivate : public EventDispatcherUNIXPrivate
+{
+   PDK_DECLARE_PUBLIC(EventDispatcherEpoll);
+   
+public:
+   EventDispatcherEpollPrivate();
+   ~EventDispatcherEpollPrivate();
+   
+   void updateRegistration(int fd, bool wasRegistered);
+   int waitTimeout(const timespec *ts);
+   void consumeTimerFd();
+   
+   int m_epollFd;
+   // only created when PDK_EVENT_DISPATCHER_TIMERFD is set, -1 otherwise
+   int m_timerFd;
+   timespec m_armedDeadline;
+   std::vector<epoll_event> m_epollEvents;
+};
+
+} // internal
+
+} // kernel
+} // pdk
+
+#endif // PDK_KERNEL_EVENT_DISPATCHER_EPOLL_H
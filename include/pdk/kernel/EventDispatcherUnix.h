@@ -79,8 +79,8 @@ public:
    bool processEvents(EventLoop::ProcessEventsFlags flags) override;
    bool hasPendingEvents() override;
    
-   void registerSocketNotifier(SocketNotifier *notifier) final;
-   void unregisterSocketNotifier(SocketNotifier *notifier) final;
+   void registerSocketNotifier(SocketNotifier *notifier) override;
+   void unregisterSocketNotifier(SocketNotifier *notifier) override;
    
    void registerTimer(int timerId, int interval, pdk::TimerType timerType, Object *object) final;
    bool unregisterTimer(int timerId) final;
@@ -95,6 +95,13 @@ public:
    
 protected:
    EventDispatcherUNIX(EventDispatcherUNIXPrivate &dd, Object *parent = nullptr);
+   
+   // the steps every processEvents() shares around its own wait: resets the
+   // interrupt flag, sends posted events and points *ts at the wait limit,
+   // nullptr to block without one. False if interrupted in the meantime
+   bool prepareWait(EventLoop::ProcessEventsFlags flags, timespec *waitTs, timespec **ts);
+   // fires the timers that are due unless flags exclude them
+   int activateTimers(EventLoop::ProcessEventsFlags flags);
 };
 
 namespace internal {
@@ -110,6 +117,7 @@ public:
    int getActivateTimers();
    
    void markPendingSocketNotifiers();
+   void markPendingSocketNotifiers(int fd, short revents);
    int getActivateSocketNotifiers();
    void setSocketNotifierPending(SocketNotifier *notifier);
    
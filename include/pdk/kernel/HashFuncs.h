@@ -18,6 +18,8 @@
 
 #include "pdk/global/Global.h"
 #include "pdk/base/lang/Character.h"
+#include <cstddef>
+#include <functional>
 #include <numeric>
 #include <utility>
 
@@ -48,6 +50,55 @@ PDK_CORE_EXPORT void set_global_hash_seed(int newSeed);
 
 PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION uint hash_bits(const void *p, size_t length, uint seed = 0) noexcept;
 
+// Fast 64-bit hash of any bytes, behind every pdk_hash overload for byte
+// and string keys. Short keys go through wyhash, long ones through eight
+// independent multiply accumulators (AVX2 where the CPU has it), results
+// do not depend on the CPU. Good spread, but an attacker who knows the
+// algorithm can still make keys collide, see siphash() for that.
+PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION puint64 hash_bytes64(const void *p, size_t length,
+                                                            puint64 seed = 0) noexcept;
+
+struct SipHashKey
+{
+   puint64 m_k0;
+   puint64 m_k1;
+};
+
+// SipHash-2-4, for keys that come from untrusted input; without the key
+// nobody can predict which keys collide
+PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION puint64 siphash(const void *p, size_t length,
+                                                       const SipHashKey &key) noexcept;
+// random per process, made on first use
+PDK_CORE_EXPORT const SipHashKey &retrieve_global_siphash_key() noexcept;
+
+// hash_bytes64() of everything added so far, for keys that are not in one
+// piece of memory
+class PDK_CORE_EXPORT IncrementalHash
+{
+public:
+   explicit IncrementalHash(puint64 seed = 0) noexcept;
+   
+   void reset() noexcept;
+   
+   void addData(const void *data, size_t length) noexcept;
+   void addData(const ds::ByteArray &data) noexcept;
+   // the UTF-16 code units, like pdk_hash() of a string
+   void addData(lang::StringView data) noexcept;
+   
+   puint64 result() const noexcept;
+   
+private:
+   void consumeBlock(const uchar *block) noexcept;
+   
+   alignas(32) puint64 m_accumulators[8];
+   puint64 m_keys[32];
+   puint64 m_seed;
+   puint64 m_length;
+   size_t m_bufferSize;
+   uchar m_lastStripe[64];
+   uchar m_buffer[1024];
+};
+
 PDK_DECL_CONST_FUNCTION constexpr inline uint pdk_hash(char key, uint seed = 0) noexcept
 {
    return static_cast<uint>(key) ^ seed;
@@ -128,6 +179,12 @@ PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION uint pdk_hash(const ds::BitArray &key, ui
 PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION uint pdk_hash(lang::Latin1String key, uint seed = 0) noexcept;
 PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION uint pdk_internal_hash(lang::StringView key, uint chained = 0) noexcept;
 
+// siphash() with the process key, for containers whose keys are untrusted
+PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION uint pdk_secure_hash(const ds::ByteArray &key, uint seed = 0) noexcept;
+PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION uint pdk_secure_hash(const lang::String &key, uint seed = 0) noexcept;
+PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION uint pdk_secure_hash(lang::StringView key, uint seed = 0) noexcept;
+PDK_CORE_EXPORT PDK_DECL_PURE_FUNCTION uint pdk_secure_hash(lang::Latin1String key, uint seed = 0) noexcept;
+
 template <typename T>
 inline uint pdk_hash(const T *key, uint seed = 0) noexcept
 {
@@ -183,6 +240,19 @@ inline uint hash_range_commutative(InputIterator first, InputIterator last, uint
    return std::accumulate(first, last, seed, internal::HashCombineCommutative());
 }
 
+// hash functor for containers, e.g.
+// ConcurrentCache<ByteArray, Session, SecureHash<ByteArray>>
+template <typename Key>
+struct SecureHash
+{
+   using argument_type = Key;
+   using result_type = std::size_t;
+   result_type operator()(const Key &key) const noexcept
+   {
+      return pdk_secure_hash(key);
+   }
+};
+
 template <typename T1, typename T2>
 inline uint pdk_hash(const std::pair<T1, T2> &key, uint seed = 0)
 noexcept(noexcept(pdk_hash(key.first, seed)) && noexcept(pdk_hash(key.first, seed)))
@@ -195,6 +265,19 @@ noexcept(noexcept(pdk_hash(key.first, seed)) && noexcept(pdk_hash(key.first, see
 
 } // pdk
 
+namespace std
+{
+template<> struct hash<pdk::ds::ByteArray>
+{
+   using argument_type = pdk::ds::ByteArray;
+   using result_type = std::size_t;
+   result_type operator()(argument_type const &bytes) const noexcept
+   {
+      return pdk::pdk_hash(bytes);
+   }
+};
+} // std
+
 #if defined(PDK_CC_MSVC)
 #pragma warning(pop)
 #endif
@@ -28,6 +28,7 @@
 #include <cstring>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #ifdef PDK_OS_NACL
@@ -271,6 +272,27 @@ inline pdk::pint64 safe_write_nosignal(int fd, const void *data, pdk::pint64 len
    return safe_write(fd, data, len);
 }
 
+// gather and scatter versions, count at most IOV_MAX
+inline pdk::pint64 safe_readv(int fd, const struct iovec *vectors, int count)
+{
+   pdk::pint64 ret = 0;
+   PDK_EINTR_LOOP(ret, ::readv(fd, vectors, count));
+   return ret;
+}
+
+inline pdk::pint64 safe_writev(int fd, const struct iovec *vectors, int count)
+{
+   pdk::pint64 ret = 0;
+   PDK_EINTR_LOOP(ret, ::writev(fd, vectors, count));
+   return ret;
+}
+
+inline pdk::pint64 safe_writev_nosignal(int fd, const struct iovec *vectors, int count)
+{
+   ignore_sigpipe();
+   return safe_writev(fd, vectors, count);
+}
+
 inline int safe_close(int fd)
 {
    int ret;
@@ -20,6 +20,7 @@
 #include "pdk/kernel/AbstractEventDispatcher.h"
 #include <sys/time.h>
 #include <list>
+#include <unordered_map>
 
 namespace pdk {
 namespace kernel {
@@ -34,6 +35,15 @@ struct TimerInfo {
    Object *m_obj;     // - object to receive event
    TimerInfo **m_activateRef; // - ref from activateTimers
    
+   // intrusive links, a timer is always on exactly one bucket list
+   // and on the timer chain of its object
+   pdk::puint64 m_expireTick; // - millisecond tick of m_timeout, rounded up
+   TimerInfo **m_bucket;
+   TimerInfo *m_prev;   // - the head of a bucket points to the tail
+   TimerInfo *m_next;
+   TimerInfo *m_objectPrev;
+   TimerInfo *m_objectNext;
+   
 #ifdef PDK_TIMERINFO_DEBUG
    timeval m_expected; // when timer is expected to fire
    float m_cumulativeError;
@@ -41,7 +51,12 @@ struct TimerInfo {
 #endif
 };
 
-class PDK_CORE_EXPORT TimerInfoList : public std::list<TimerInfo *>
+// Timers are kept in a hierarchical timing wheel with a resolution of one
+// millisecond. The root wheel holds the next 256 ms one tick per bucket, each
+// of the four upper wheels has 64 buckets that cover 64 buckets of the wheel
+// below. Starting and stopping a timer is O(1), buckets of an upper wheel are
+// cascaded down when the root wheel wraps around.
+class PDK_CORE_EXPORT TimerInfoList
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(PDK_OS_MAC))
    timespec m_previousTime;
@@ -55,6 +70,7 @@ class PDK_CORE_EXPORT TimerInfoList : public std::list<TimerInfo *>
    
 public:
    TimerInfoList();
+   ~TimerInfoList();
    timespec updateCurrentTime();
    // must call updateCurrentTime() first!
    void repairTimersIfNeeded();
@@ -66,11 +82,57 @@ public:
    bool unregisterTimers(Object *object);
    std::list<AbstractEventDispatcher::TimerInfo> getRegisteredTimers(Object *object) const;
    int getActivateTimers();
+   
+   size_t size() const
+   {
+      return m_timers.size();
+   }
+   
+   bool empty() const
+   {
+      return m_timers.empty();
+   }
+   
+   void clear();
+   
 public:
     timespec m_currentTime;
+    
+private:
+   enum : int {
+      RootWheelBits = 8,
+      RootWheelSize = 1 << RootWheelBits,
+      WheelBits = 6,
+      WheelSize = 1 << WheelBits,
+      WheelLevels = 4,
+      BucketCount = RootWheelSize + WheelLevels * WheelSize
+   };
+   
+   void appendTimer(TimerInfo *timerInfo, TimerInfo **bucket);
+   void unlinkTimer(TimerInfo *timerInfo);
+   void removeTimer(TimerInfo *timerInfo);
+   bool isWheelBucket(TimerInfo **bucket) const
+   {
+      return bucket >= m_buckets && bucket < m_buckets + BucketCount;
+   }
+   
+   int findOccupiedBucket(int first, int last) const;
+   void advanceWheel(pdk::puint64 currentTick);
+   void cascadeWheels();
+   pdk::puint64 getBucketMinTick(int bucket);
+   bool findNextExpireTick(pdk::puint64 &tick);
+   
 private:
-   // state variables used by activateTimers()
-   TimerInfo *m_firstTimerInfo;
+   TimerInfo *m_buckets[BucketCount];
+   pdk::puint64 m_bucketMinTick[BucketCount]; // 0 means unknown
+   pdk::puint64 m_occupiedBuckets[BucketCount / 64];
+   TimerInfo *m_zeroTimers;    // interval 0 timers, due on every pass
+   TimerInfo *m_expiredTimers; // taken off the wheel, waiting for delivery
+   TimerInfo *m_activeTimers;  // being delivered by getActivateTimers()
+   pdk::puint64 m_wheelTick;   // first tick the wheel did not process yet
+   size_t m_wheelTimerCount;
+   std::unordered_map<int, TimerInfo *> m_timers;
+   std::unordered_map<Object *, TimerInfo *> m_objectTimers;
 };
 
 } // internal
@@ -33,6 +33,7 @@
 #include "pdk/kernel/signal/internal/AutoBuffer.h"
 #include "pdk/kernel/signal/internal/NullOutputIterator.h"
 #include "pdk/kernel/signal/Slot.h"
+#include <atomic>
 #include <mutex>
 
 namespace pdk {
@@ -70,12 +71,13 @@ private:
    std::unique_lock<Mutex> m_lock;
 };
 
-class ConnectionBodyBase
+class ConnectionBodyBase : public std::enable_shared_from_this<ConnectionBodyBase>
 {
 public:
    ConnectionBodyBase()
       : m_connected(true),
-        m_slotRefcount(1)
+        m_slotRefcount(1),
+        m_blockerCount(0)
    {}
    
    virtual ~ConnectionBodyBase()
@@ -90,29 +92,33 @@ public:
    template<typename Mutex>
    void nolockDisconnect(GarbageCollectingLock<Mutex> &lock) const
    {
-      if(m_connected) {
-         m_connected = false;
+      if(m_connected.load(std::memory_order_relaxed)) {
+         m_connected.store(false, std::memory_order_release);
          decSlotRefcount(lock);
       }
    }
    
    virtual bool connected() const = 0;
    
+   // every blocker handed out bumps an atomic count so blocked() can be
+   // read by a snapshot emission without taking the signal mutex, the
+   // deleter only holds a weak reference because a SharedConnectionBlock
+   // may outlive the connection body
    std::shared_ptr<void> getBlocker()
    {
-      std::unique_lock<ConnectionBodyBase> lock(*this);
-      std::shared_ptr<void> blocker = m_weakBlocker.lock();
-      if(blocker == std::shared_ptr<void>())
-      {
-         blocker.reset(this, &null_deleter);
-         m_weakBlocker = blocker;
-      }
-      return blocker;
+      std::weak_ptr<ConnectionBodyBase> weakSelf(weak_from_this());
+      m_blockerCount.fetch_add(1, std::memory_order_release);
+      return std::shared_ptr<void>(this, [weakSelf](void *) {
+         std::shared_ptr<ConnectionBodyBase> self(weakSelf.lock());
+         if(self) {
+            self->m_blockerCount.fetch_sub(1, std::memory_order_release);
+         }
+      });
    }
    
    bool blocked() const
    {
-      return !m_weakBlocker.expired();
+      return m_blockerCount.load(std::memory_order_acquire) != 0;
    }
    
    bool nolockNograbBlocked() const
@@ -122,7 +128,7 @@ public:
    
    bool nolockNograbConnected() const
    {
-      return m_connected;
+      return m_connected.load(std::memory_order_acquire);
    }
    
    // expose part of Lockable concept of mutex
@@ -157,11 +163,11 @@ public:
    
 protected:
    virtual std::shared_ptr<void> releaseSlot() const = 0;
-   std::weak_ptr<void> m_weakBlocker;
    
 private:
-   mutable bool m_connected;
+   mutable std::atomic<bool> m_connected;
    mutable unsigned m_slotRefcount;
+   std::atomic<unsigned> m_blockerCount;
 };
 
 template<typename GroupKey, typename SlotType, typename Mutex>
@@ -229,6 +235,29 @@ public:
       }
    }
    
+   // lock free variant used by snapshot emission, the snapshot keeps a
+   // slot reference so m_slot stays valid, returns false when a tracked
+   // object has expired and leaves the disconnect to the caller
+   template<typename OutputIterator>
+   bool grabTrackedObjects(OutputIterator inserter) const
+   {
+      if(!m_slot) {
+         return false;
+      }
+      SlotBase::TrackedContainerType::const_iterator iter;
+      for(iter = slot().getTrackedObjects().begin();
+          iter != slot().getTrackedObjects().end();
+          ++iter)
+      {
+         VoidSharedPtrVariant lockedObject(std::visit(internal::LockWeakPtrVisitor(), *iter));
+         if(std::visit(internal::ExpiredWeakPtrVisitor(), *iter)) {
+            return false;
+         }
+         *inserter++ = lockedObject;
+      }
+      return true;
+   }
+   
    // expose Lockable concept of mutex
    virtual void lock()
    {
@@ -0,0 +1,125 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_KERNEL_SIGNAL_INTERNAL_EPOCH_DOMAIN_H
+#define PDK_KERNEL_SIGNAL_INTERNAL_EPOCH_DOMAIN_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace pdk {
+namespace kernel {
+namespace signal {
+namespace internal {
+
+// Each reader thread is pinned to one counter stripe so concurrent
+// emitters on different threads do not bounce the same cache line.
+inline std::size_t current_epoch_stripe()
+{
+   static std::atomic<std::size_t> sg_nextStripe(0);
+   thread_local std::size_t stripe = sg_nextStripe.fetch_add(1, std::memory_order_relaxed);
+   return stripe;
+}
+
+// Epoch based reclamation for the snapshot emission mode of a signal.
+//
+// Readers announce themselves in the counter of the current epoch parity,
+// writers retire objects stamped with the epoch observed after the
+// replacement was published. The epoch only moves from E to E + 1 when no
+// reader is left in the parity of E + 1, so an object retired at epoch E
+// is unreachable once the epoch reaches E + 2. Writers must be serialized
+// by the caller, readers never block and never take a lock.
+class EpochDomain
+{
+public:
+   enum { StripeCount = 8 };
+   
+   class ReadGuard
+   {
+   public:
+      explicit ReadGuard(EpochDomain &domain)
+         : m_counter(domain.enter())
+      {}
+      
+      ~ReadGuard()
+      {
+         m_counter->fetch_sub(1, std::memory_order_release);
+      }
+      
+   private:
+      ReadGuard(const ReadGuard &) = delete;
+      ReadGuard &operator=(const ReadGuard &) = delete;
+      std::atomic<std::size_t> *m_counter;
+   };
+   
+   EpochDomain()
+      : m_epoch(0)
+   {
+      for(Stripe &stripe : m_stripes) {
+         stripe.m_readers[0].store(0, std::memory_order_relaxed);
+         stripe.m_readers[1].store(0, std::memory_order_relaxed);
+      }
+   }
+   
+   std::size_t getEpoch() const
+   {
+      return m_epoch.load(std::memory_order_seq_cst);
+   }
+   
+   bool tryAdvance()
+   {
+      std::size_t epoch = m_epoch.load(std::memory_order_relaxed);
+      std::size_t parity = (epoch + 1) & 1;
+      for(const Stripe &stripe : m_stripes) {
+         if(stripe.m_readers[parity].load(std::memory_order_seq_cst) != 0) {
+            return false;
+         }
+      }
+      m_epoch.store(epoch + 1, std::memory_order_seq_cst);
+      return true;
+   }
+   
+   bool isReclaimable(std::size_t retireEpoch) const
+   {
+      return m_epoch.load(std::memory_order_relaxed) >= retireEpoch + 2;
+   }
+   
+private:
+   EpochDomain(const EpochDomain &) = delete;
+   EpochDomain &operator=(const EpochDomain &) = delete;
+   
+   std::atomic<std::size_t> *enter()
+   {
+      Stripe &stripe = m_stripes[current_epoch_stripe() % StripeCount];
+      std::atomic<std::size_t> *counter = &stripe.m_readers[m_epoch.load(std::memory_order_seq_cst) & 1];
+      counter->fetch_add(1, std::memory_order_seq_cst);
+      return counter;
+   }
+   
+   struct alignas(64) Stripe
+   {
+      std::atomic<std::size_t> m_readers[2];
+   };
+   
+   Stripe m_stripes[StripeCount];
+   std::atomic<std::size_t> m_epoch;
+};
+
+} // internal
+} // signal
+} // kernel
+} // pdk
+
+#endif // PDK_KERNEL_SIGNAL_INTERNAL_EPOCH_DOMAIN_H
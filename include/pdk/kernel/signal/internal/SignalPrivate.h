@@ -35,12 +35,16 @@
 #include "pdk/kernel/signal/internal/SlotCallIterator.h"
 #include "pdk/kernel/signal/internal/VariadicArgType.h"
 #include "pdk/kernel/signal/internal/ResultTypeWrapper.h"
+#include "pdk/kernel/signal/internal/EpochDomain.h"
 #include "pdk/kernel/signal/OptionalLastValue.h"
 #include "pdk/kernel/signal/Connection.h"
 #include "pdk/stdext/typetraits/FunctionTraits.h"
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace pdk {
 namespace kernel {
@@ -53,6 +57,16 @@ using pdk::kernel::Object;
 
 class Connection;
 
+// How a signal reads its connection list while emitting. Locked copies the
+// shared invocation state under the signal mutex, Snapshot reads an
+// immutable snapshot republished by every connect, so an emission that does
+// not race with a connect or disconnect takes no lock at all.
+enum class EmissionMode
+{
+   Locked,
+   Snapshot
+};
+
 namespace internal {
 
 using pdk::kernel::signal::ConnectPosition;
@@ -182,13 +196,40 @@ public:
    using SlotCallIterator = typename internal::SlotCallIterator<SlotInvoker,
    typename ConnectionListType::iterator, ConnectionBody<GroupKeyType, SlotType, Mutex>>;
    
+private:
+   class EmissionSnapshot;
+   using SnapshotSlotCallIterator = typename internal::SnapshotSlotCallIterator<SlotInvoker,
+   typename std::vector<ConnectionBodyType>::const_iterator>;
+   
+public:
    SignalImpl(const CombinerType &combinerArg,
               const GroupCompareType &groupCompare)
       : m_sharedState(new InvocationState(ConnectionListType(groupCompare), combinerArg)),
         m_garbageCollectorIter(m_sharedState->connectionBodies().end()),
+        m_emissionMode(EmissionMode::Locked),
+        m_snapshot(nullptr),
+        m_retiredSnapshots(nullptr),
         m_mutex(new MutexType())
    {}
    
+   ~SignalImpl()
+   {
+      if(!m_epochDomain) {
+         return;
+      }
+      // no emission can be in flight any more, every owner of the impl is gone
+      GarbageCollectingLock<MutexType> lock(*m_mutex);
+      EmissionSnapshot *snapshot = m_snapshot.exchange(nullptr, std::memory_order_relaxed);
+      if(snapshot) {
+         nolockReleaseSnapshot(lock, snapshot);
+      }
+      while(m_retiredSnapshots) {
+         snapshot = m_retiredSnapshots;
+         m_retiredSnapshots = snapshot->m_nextRetired;
+         nolockReleaseSnapshot(lock, snapshot);
+      }
+   }
+   
    // connect slot
    Connection connect(const SlotType &slot, 
                       ConnectPosition position = ConnectPosition::AtBack)
@@ -235,6 +276,7 @@ public:
           iter != localState->connectionBodies().end(); ++iter) {
          (*iter)->disconnect();
       }
+      refreshSnapshot();
    }
    
    void disconnect(const GroupType &group)
@@ -249,6 +291,7 @@ public:
       {
          (*iter)->disconnect();
       }
+      refreshSnapshot();
    }
    
    void disconnect(const Connection &connection)
@@ -259,6 +302,14 @@ public:
    // emit signal
    ResultType operator ()(Args ...args)
    {
+      if(m_emissionMode.load(std::memory_order_acquire) == EmissionMode::Snapshot) {
+         EpochDomain::ReadGuard guard(*m_epochDomain);
+         const EmissionSnapshot *snapshot = m_snapshot.load(std::memory_order_seq_cst);
+         // a null snapshot means the mode was switched back concurrently
+         if(snapshot) {
+            return snapshotEmit(*snapshot, args...);
+         }
+      }
       std::shared_ptr<InvocationState> localState;
       {
          GarbageCollectingLock<MutexType> lock(*m_mutex);
@@ -284,6 +335,13 @@ public:
    
    ResultType operator ()(Args ...args) const
    {
+      if(m_emissionMode.load(std::memory_order_acquire) == EmissionMode::Snapshot) {
+         EpochDomain::ReadGuard guard(*m_epochDomain);
+         const EmissionSnapshot *snapshot = m_snapshot.load(std::memory_order_seq_cst);
+         if(snapshot) {
+            return snapshotEmit(*snapshot, args...);
+         }
+      }
       std::shared_ptr<InvocationState> localState;
       {
          GarbageCollectingLock<MutexType> lock(*m_mutex);
@@ -342,12 +400,41 @@ public:
    
    void setCombiner(const CombinerType &combinerArg)
    {
-      std::unique_lock<MutexType> lock(*m_mutex);
-      if(m_sharedState.unique()) {
+      GarbageCollectingLock<MutexType> lock(*m_mutex);
+      // snapshot emitters share the combiner without holding the state
+      if(m_sharedState.unique() && !m_epochDomain) {
          m_sharedState->getCombiner() = combinerArg;
       } else {
          m_sharedState.reset(new InvocationState(*m_sharedState, combinerArg));
       }
+      if(m_emissionMode.load(std::memory_order_relaxed) == EmissionMode::Snapshot) {
+         nolockPublishSnapshot(lock);
+      }
+   }
+   
+   EmissionMode getEmissionMode() const
+   {
+      return m_emissionMode.load(std::memory_order_acquire);
+   }
+   
+   void setEmissionMode(EmissionMode mode)
+   {
+      GarbageCollectingLock<MutexType> lock(*m_mutex);
+      if(m_emissionMode.load(std::memory_order_relaxed) == mode) {
+         return;
+      }
+      if(mode == EmissionMode::Snapshot) {
+         // the domain is kept until destruction, an emitter may still be
+         // inside a read guard after the mode is switched back
+         if(!m_epochDomain) {
+            m_epochDomain.reset(new EpochDomain);
+         }
+         nolockPublishSnapshot(lock);
+         m_emissionMode.store(mode, std::memory_order_release);
+      } else {
+         m_emissionMode.store(mode, std::memory_order_release);
+         nolockRetireSnapshot(lock, nullptr);
+      }
    }
    
 private:
@@ -377,6 +464,11 @@ private:
          return *m_connectionBodies;
       }
       
+      const std::shared_ptr<CombinerType> &getSharedCombiner() const
+      {
+         return m_combiner;
+      }
+      
       const ConnectionListType & connectionBodies() const
       {
          return *m_connectionBodies;
@@ -429,6 +521,142 @@ private:
       const ConnectionListType *m_connectionBodies;
    };
    
+   // Immutable copy of the connected bodies read by snapshot emissions. Each
+   // listed body holds one slot reference for the snapshot, so a concurrent
+   // disconnect can not release the slot under a running emission.
+   class EmissionSnapshot
+   {
+   public:
+      std::vector<ConnectionBodyType> m_bodies;
+      std::shared_ptr<CombinerType> m_combiner;
+      std::size_t m_retireEpoch = 0;
+      EmissionSnapshot *m_nextRetired = nullptr;
+   };
+   
+   class SnapshotJanitor
+   {
+   public:
+      using SignalType = SignalImpl;
+      SnapshotJanitor(
+               const SlotCallIteratorCacheType &cache,
+               const SignalType &sig,
+               const EmissionSnapshot *snapshot)
+         : m_cache(cache),
+           m_sig(sig),
+           m_snapshot(snapshot)
+      {}
+      
+      ~SnapshotJanitor()
+      {
+         // republish once the snapshot is mostly made of disconnected slots
+         if(m_cache.m_disconnectedSlotCount > m_cache.m_connectedSlotCount)
+         {
+            m_sig.forceRefreshSnapshot(m_snapshot);
+         }
+      }
+      
+   private:
+      PDK_DISABLE_COPY(SnapshotJanitor);
+      const SlotCallIteratorCacheType &m_cache;
+      const SignalType &m_sig;
+      const EmissionSnapshot *m_snapshot;
+   };
+   
+   ResultType snapshotEmit(const EmissionSnapshot &snapshot, Args ...args) const
+   {
+      SlotInvoker invoker = SlotInvoker(args...);
+      SlotCallIteratorCacheType cache(invoker);
+      SnapshotJanitor janitor(cache, *this, &snapshot);
+      return internal::CombinerInvoker<typename CombinerType::ResultType>()(
+               *snapshot.m_combiner,
+               SnapshotSlotCallIterator(snapshot.m_bodies.begin(), snapshot.m_bodies.end(), cache),
+               SnapshotSlotCallIterator(snapshot.m_bodies.end(), snapshot.m_bodies.end(), cache)
+               );
+   }
+   
+   void nolockPublishSnapshot(GarbageCollectingLock<MutexType> &lock) const
+   {
+      std::unique_ptr<EmissionSnapshot> snapshot(new EmissionSnapshot);
+      snapshot->m_combiner = m_sharedState->getSharedCombiner();
+      typename ConnectionListType::iterator iter;
+      for(iter = m_sharedState->connectionBodies().begin();
+          iter != m_sharedState->connectionBodies().end(); ++iter) {
+         if((*iter)->nolockNograbConnected()) {
+            snapshot->m_bodies.push_back(*iter);
+         }
+      }
+      for(const ConnectionBodyType &body : snapshot->m_bodies) {
+         body->incSlotRefcount(lock);
+      }
+      nolockRetireSnapshot(lock, snapshot.release());
+   }
+   
+   void nolockRetireSnapshot(GarbageCollectingLock<MutexType> &lock,
+                             EmissionSnapshot *replacement) const
+   {
+      EmissionSnapshot *snapshot = m_snapshot.exchange(replacement, std::memory_order_seq_cst);
+      if(snapshot) {
+         snapshot->m_retireEpoch = m_epochDomain->getEpoch();
+         snapshot->m_nextRetired = m_retiredSnapshots;
+         m_retiredSnapshots = snapshot;
+      }
+      if(!m_retiredSnapshots) {
+         return;
+      }
+      // two steps are needed before the newest retired snapshot is unreachable
+      if(m_epochDomain->tryAdvance()) {
+         m_epochDomain->tryAdvance();
+      }
+      EmissionSnapshot **link = &m_retiredSnapshots;
+      while(*link) {
+         snapshot = *link;
+         if(m_epochDomain->isReclaimable(snapshot->m_retireEpoch)) {
+            *link = snapshot->m_nextRetired;
+            nolockReleaseSnapshot(lock, snapshot);
+         } else {
+            link = &snapshot->m_nextRetired;
+         }
+      }
+   }
+   
+   void nolockReleaseSnapshot(GarbageCollectingLock<MutexType> &lock,
+                              EmissionSnapshot *snapshot) const
+   {
+      for(const ConnectionBodyType &body : snapshot->m_bodies) {
+         body->decSlotRefcount(lock);
+         // the body may be the last owner of its slot, destroy it unlocked
+         lock.addTrash(body);
+      }
+      delete snapshot;
+   }
+   
+   // drop disconnected bodies from the published snapshot
+   void forceRefreshSnapshot(const EmissionSnapshot *snapshot) const
+   {
+      GarbageCollectingLock<MutexType> lock(*m_mutex);
+      if(m_snapshot.load(std::memory_order_relaxed) != snapshot) {
+         return;
+      }
+      nolockRefreshSnapshot(lock);
+   }
+   
+   void refreshSnapshot()
+   {
+      GarbageCollectingLock<MutexType> lock(*m_mutex);
+      if(m_emissionMode.load(std::memory_order_relaxed) == EmissionMode::Snapshot) {
+         nolockRefreshSnapshot(lock);
+      }
+   }
+   
+   void nolockRefreshSnapshot(GarbageCollectingLock<MutexType> &lock) const
+   {
+      if(m_sharedState.use_count() > 1) {
+         m_sharedState.reset(new InvocationState(*m_sharedState, m_sharedState->connectionBodies()));
+      }
+      nolockCleanupConnectionsFrom(lock, false, m_sharedState->connectionBodies().begin());
+      nolockPublishSnapshot(lock);
+   }
+   
    // clean up disconnected connections
    void nolockCleanupConnectionsFrom(GarbageCollectingLock<MutexType> &lock,
                                      bool grabTracked,
@@ -525,6 +753,9 @@ private:
          m_sharedState->connectionBodies().pushFront(groupKey, newConnectionBody);
       }
       newConnectionBody->setGroupKey(groupKey);
+      if(m_emissionMode.load(std::memory_order_relaxed) == EmissionMode::Snapshot) {
+         nolockPublishSnapshot(lock);
+      }
       return Connection(newConnectionBody);
    }
    
@@ -541,12 +772,21 @@ private:
          // at_front
          m_sharedState->connectionBodies().pushFront(groupKey, newConnectionBody);
       }
+      if(m_emissionMode.load(std::memory_order_relaxed) == EmissionMode::Snapshot) {
+         nolockPublishSnapshot(lock);
+      }
       return Connection(newConnectionBody);
    }
    
    // _shared_state is mutable so we can do force_cleanup_connections during a const invocation
    mutable std::shared_ptr<InvocationState> m_sharedState;
    mutable typename ConnectionListType::iterator m_garbageCollectorIter;
+   // the emission mode and the epoch domain are only written under m_mutex,
+   // m_snapshot is the published list read by lock free emissions
+   std::atomic<EmissionMode> m_emissionMode;
+   std::unique_ptr<EpochDomain> m_epochDomain;
+   mutable std::atomic<EmissionSnapshot *> m_snapshot;
+   mutable EmissionSnapshot *m_retiredSnapshots;
    // connection list mutex must never be locked when attempting a blocking lock on a slot,
    // or you could deadlock.
    const std::shared_ptr<MutexType> m_mutex;
@@ -705,6 +945,16 @@ public:
       return (*m_pimpl).setCombiner(combinerArg);
    }
    
+   EmissionMode getEmissionMode() const
+   {
+      return (*m_pimpl).getEmissionMode();
+   }
+   
+   void setEmissionMode(EmissionMode mode)
+   {
+      (*m_pimpl).setEmissionMode(mode);
+   }
+   
    void swap(Signal &other)
    {
       using std::swap;
@@ -198,6 +198,96 @@ private:
    mutable Iterator m_callableIter;
 };
 
+// Slot call iterator used by the snapshot emission mode. The snapshot
+// pins every slot it references, so the connection bodies are only
+// inspected through their atomic state and no lock is taken unless a
+// tracked object turns out to be expired.
+template<typename Function, typename Iterator>
+class SnapshotSlotCallIterator
+{
+public:
+   using ResultType = typename Function::ResultType;
+   
+   using CacheType = SlotCallIteratorCache<ResultType, Function>;
+   using ValueType = ResultType;
+   using Reference = typename std::add_lvalue_reference<typename std::add_const<ResultType>::type>::type;
+   using Difference = std::ptrdiff_t;
+   using IteratorCategory = std::forward_iterator_tag;
+   
+   using result_type = ResultType;
+   using value_type = ValueType;
+   using reference = Reference;
+   using difference = Difference;
+   using iterator_category = IteratorCategory;
+   
+public:
+   SnapshotSlotCallIterator(Iterator begin, Iterator end, CacheType &cacheType)
+      : m_iter(begin),
+        m_end(end),
+        m_cache(&cacheType)
+   {
+      findNextCallable();
+   }
+   
+   reference operator *() const
+   {
+      if (!m_cache->m_result) {
+         try {
+            m_cache->m_result.reset();
+            m_cache->m_result = m_cache->m_func(*m_iter);
+         } catch(ExpiredSlot &) {
+            (*m_iter)->disconnect();
+            throw;
+         }
+      }
+      return m_cache->m_result.value();
+   }
+   
+   const SnapshotSlotCallIterator &operator ++() const
+   {
+      ++m_iter;
+      findNextCallable();
+      m_cache->m_result.reset();
+      return *this;
+   }
+   
+   bool operator ==(const SnapshotSlotCallIterator &other) const
+   {
+      return m_iter == other.m_iter;
+   }
+   
+   bool operator !=(const SnapshotSlotCallIterator &other) const
+   {
+      return m_iter != other.m_iter;
+   }
+   
+private:
+   void findNextCallable() const
+   {
+      for(;m_iter != m_end; ++m_iter) {
+         m_cache->m_trackedPtrs.clear();
+         if(!(*m_iter)->nolockNograbConnected()) {
+            ++m_cache->m_disconnectedSlotCount;
+            continue;
+         }
+         if(!(*m_iter)->grabTrackedObjects(std::back_inserter(m_cache->m_trackedPtrs))) {
+            m_cache->m_trackedPtrs.clear();
+            (*m_iter)->disconnect();
+            ++m_cache->m_disconnectedSlotCount;
+            continue;
+         }
+         ++m_cache->m_connectedSlotCount;
+         if(!(*m_iter)->blocked()) {
+            break;
+         }
+      }
+   }
+   
+   mutable Iterator m_iter;
+   Iterator m_end;
+   CacheType *m_cache;
+};
+
 } // internal
 } // signal
 } // kernel
@@ -235,7 +235,7 @@
 #define PDK_FUNCTION_TARGET_STRING_BMI           "bmi"
 #define PDK_FUNCTION_TARGET_STRING_BMI2          "bmi2"
 #define PDK_FUNCTION_TARGET_STRING_RDSEED        "rdseed"
-#define PDK_FUNCTION_TARGET_STRING_SHA           "sha"
+#define PDK_FUNCTION_TARGET_STRING_SHA           "sha,sse4.1"
 
 // other x86 intrinsics
 #if defined(PDK_PROCESSOR_X86) && ((defined(PDK_CC_GNU) && (PDK_CC_GNU >= 404)) \
@@ -430,6 +430,7 @@ extern PDK_CORE_EXPORT pdk::os::thread::BasicAtomicInteger<unsigned int> pdk_cpu
 #endif
 
 PDK_CORE_EXPORT void detect_cpu_features();
+PDK_CORE_EXPORT void dump_cpu_features();
 
 namespace
 {
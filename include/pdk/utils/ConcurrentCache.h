@@ -0,0 +1,516 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_UTILS_CONCURRENT_CACHE_H
+#define PDK_UTILS_CONCURRENT_CACHE_H
+
+#include "pdk/global/Global.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pdk {
+namespace utils {
+
+// Thread safe counterpart of Cache.
+//
+// Keys are spread over independently locked shards by hash. The cost budget
+// is shared by the whole cache, so one object may cost up to maxCost. Each
+// shard also gets an equal share of the budget, when the cache is over budget
+// the shards above their share are evicted first, the inserting shard before
+// the others. Objects are handed out as std::shared_ptr, so an object evicted
+// by one thread stays valid for the threads still using it.
+//
+// With EvictionPolicy::LeastRecentlyUsed a lookup moves the entry to the
+// front of its shard and takes the shard lock exclusively. With
+// EvictionPolicy::Clock a lookup only sets a reference bit under a shared
+// lock, so concurrent readers of the same shard do not serialize, and
+// eviction gives referenced entries a second chance.
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class ConcurrentCache
+{
+public:
+   enum class EvictionPolicy
+   {
+      LeastRecentlyUsed,
+      Clock
+   };
+   
+   struct Statistics
+   {
+      pdk::puint64 m_hits = 0;
+      pdk::puint64 m_misses = 0;
+      pdk::puint64 m_insertions = 0;
+      pdk::puint64 m_evictions = 0;
+   };
+   
+   // shardCount is rounded up to a power of two, 0 picks one from the
+   // number of hardware threads, the shard count is lowered until every
+   // shard can hold at least one object of cost 1
+   explicit ConcurrentCache(int maxCost = 100,
+                            EvictionPolicy policy = EvictionPolicy::LeastRecentlyUsed,
+                            int shardCount = 0);
+   ~ConcurrentCache();
+   
+   EvictionPolicy getEvictionPolicy() const
+   {
+      return m_policy;
+   }
+   
+   int getShardCount() const
+   {
+      return static_cast<int>(m_shards.size());
+   }
+   
+   int getMaxCost() const
+   {
+      return m_maxCost.load(std::memory_order_relaxed);
+   }
+   
+   void setMaxCost(int maxCost);
+   int getTotalCost() const;
+   int getCount() const;
+   
+   bool isEmpty() const
+   {
+      return getCount() == 0;
+   }
+   
+   void clear();
+   
+   // takes ownership of object, an object costlier than maxCost is deleted
+   // right away and false is returned
+   bool insert(const Key &key, T *object, int cost = 1);
+   bool insert(const Key &key, std::shared_ptr<T> object, int cost = 1);
+   std::shared_ptr<T> getData(const Key &key) const;
+   bool contains(const Key &key) const;
+   
+   std::shared_ptr<T> operator[](const Key &key) const
+   {
+      return getData(key);
+   }
+   
+   bool remove(const Key &key);
+   std::shared_ptr<T> take(const Key &key);
+   std::list<Key> keys() const;
+   
+   Statistics getStatistics() const;
+   void resetStatistics();
+   
+private:
+   PDK_DISABLE_COPY(ConcurrentCache);
+   
+   struct Node
+   {
+      Node(std::shared_ptr<T> &&data, int cost)
+         : m_keyPtr(nullptr),
+           m_data(std::move(data)),
+           m_cost(cost),
+           m_prevNode(nullptr),
+           m_nextNode(nullptr),
+           m_referenced(false)
+      {}
+      
+      const Key *m_keyPtr;
+      std::shared_ptr<T> m_data;
+      int m_cost;
+      Node *m_prevNode;
+      Node *m_nextNode;
+      mutable std::atomic<bool> m_referenced;
+   };
+   
+   // shards sit on their own cache lines so the counters of one shard do
+   // not slow down lookups in its neighbours
+   struct alignas(64) Shard
+   {
+      Shard()
+         : m_forward(nullptr),
+           m_last(nullptr),
+           m_maxCost(0),
+           m_totalCost(0)
+      {}
+      
+      mutable std::shared_mutex m_mutex;
+      std::unordered_map<Key, Node, Hash> m_nodes;
+      // most recently used or inserted entry first
+      Node *m_forward;
+      Node *m_last;
+      // share of the cache budget, only enforced while the cache is over
+      // budget
+      int m_maxCost;
+      int m_totalCost;
+      mutable std::atomic<pdk::puint64> m_hits{0};
+      mutable std::atomic<pdk::puint64> m_misses{0};
+      std::atomic<pdk::puint64> m_insertions{0};
+      std::atomic<pdk::puint64> m_evictions{0};
+   };
+   
+   Shard &getShard(const Key &key) const
+   {
+      std::size_t hash = m_hash(key);
+      // fold the high bits in, std::hash is the identity for integers
+      hash ^= hash >> 17;
+      hash *= static_cast<std::size_t>(0x9e3779b97f4a7c15ULL);
+      hash ^= hash >> 29;
+      return *m_shards[hash & (m_shards.size() - 1)];
+   }
+   
+   void distributeMaxCost(int maxCost);
+   static void linkFront(Shard &shard, Node *node);
+   static void unlinkNode(Shard &shard, Node *node);
+   std::shared_ptr<T> eraseNode(Shard &shard, Node *node);
+   void trim(Shard &shard, int maxCost, int reserve, std::vector<std::shared_ptr<T>> &evicted);
+   void trimOverBudget(Shard *inserted = nullptr);
+   
+   std::vector<std::unique_ptr<Shard>> m_shards;
+   Hash m_hash;
+   EvictionPolicy m_policy;
+   std::atomic<int> m_maxCost;
+   std::atomic<int> m_totalCost;
+};
+
+template <typename Key, typename T, typename Hash>
+ConcurrentCache<Key, T, Hash>::ConcurrentCache(int maxCost, EvictionPolicy policy, int shardCount)
+   : m_policy(policy),
+     m_maxCost(maxCost),
+     m_totalCost(0)
+{
+   if (shardCount <= 0) {
+      shardCount = std::min<int>(std::max<unsigned>(std::thread::hardware_concurrency(), 1u), 64);
+   }
+   int count = 1;
+   while (count < shardCount) {
+      count <<= 1;
+   }
+   while (count > 1 && maxCost / count < 1) {
+      count >>= 1;
+   }
+   for (int i = 0; i < count; ++i) {
+      m_shards.emplace_back(new Shard);
+   }
+   distributeMaxCost(maxCost);
+}
+
+template <typename Key, typename T, typename Hash>
+ConcurrentCache<Key, T, Hash>::~ConcurrentCache()
+{
+   clear();
+}
+
+template <typename Key, typename T, typename Hash>
+void ConcurrentCache<Key, T, Hash>::distributeMaxCost(int maxCost)
+{
+   int count = static_cast<int>(m_shards.size());
+   int share = std::max(maxCost, 0) / count;
+   int remainder = std::max(maxCost, 0) % count;
+   for (int i = 0; i < count; ++i) {
+      std::unique_lock<std::shared_mutex> locker(m_shards[i]->m_mutex);
+      m_shards[i]->m_maxCost = share + (i < remainder ? 1 : 0);
+   }
+}
+
+template <typename Key, typename T, typename Hash>
+void ConcurrentCache<Key, T, Hash>::setMaxCost(int maxCost)
+{
+   m_maxCost.store(maxCost, std::memory_order_relaxed);
+   distributeMaxCost(maxCost);
+   trimOverBudget();
+}
+
+template <typename Key, typename T, typename Hash>
+int ConcurrentCache<Key, T, Hash>::getTotalCost() const
+{
+   int total = 0;
+   for (const std::unique_ptr<Shard> &shard : m_shards) {
+      std::shared_lock<std::shared_mutex> locker(shard->m_mutex);
+      total += shard->m_totalCost;
+   }
+   return total;
+}
+
+template <typename Key, typename T, typename Hash>
+int ConcurrentCache<Key, T, Hash>::getCount() const
+{
+   int count = 0;
+   for (const std::unique_ptr<Shard> &shard : m_shards) {
+      std::shared_lock<std::shared_mutex> locker(shard->m_mutex);
+      count += static_cast<int>(shard->m_nodes.size());
+   }
+   return count;
+}
+
+template <typename Key, typename T, typename Hash>
+std::list<Key> ConcurrentCache<Key, T, Hash>::keys() const
+{
+   std::list<Key> keys;
+   for (const std::unique_ptr<Shard> &shard : m_shards) {
+      std::shared_lock<std::shared_mutex> locker(shard->m_mutex);
+      for (const auto &entry : shard->m_nodes) {
+         keys.push_back(entry.first);
+      }
+   }
+   return keys;
+}
+
+template <typename Key, typename T, typename Hash>
+void ConcurrentCache<Key, T, Hash>::clear()
+{
+   for (std::unique_ptr<Shard> &shard : m_shards) {
+      // release the objects after unlocking, their destructors may be
+      // arbitrarily expensive
+      std::unordered_map<Key, Node, Hash> nodes;
+      {
+         std::unique_lock<std::shared_mutex> locker(shard->m_mutex);
+         nodes.swap(shard->m_nodes);
+         shard->m_forward = nullptr;
+         shard->m_last = nullptr;
+         m_totalCost.fetch_sub(shard->m_totalCost, std::memory_order_relaxed);
+         shard->m_totalCost = 0;
+      }
+   }
+}
+
+template <typename Key, typename T, typename Hash>
+inline bool ConcurrentCache<Key, T, Hash>::insert(const Key &key, T *object, int cost)
+{
+   return insert(key, std::shared_ptr<T>(object), cost);
+}
+
+template <typename Key, typename T, typename Hash>
+bool ConcurrentCache<Key, T, Hash>::insert(const Key &key, std::shared_ptr<T> object, int cost)
+{
+   Shard &shard = getShard(key);
+   std::shared_ptr<T> replaced;
+   std::vector<std::shared_ptr<T>> evicted;
+   {
+      std::unique_lock<std::shared_mutex> locker(shard.m_mutex);
+      auto iter = shard.m_nodes.find(key);
+      if (iter != shard.m_nodes.end()) {
+         replaced = eraseNode(shard, &iter->second);
+      }
+      if (cost > getMaxCost()) {
+         return false;
+      }
+      trim(shard, shard.m_maxCost, cost, evicted);
+      iter = shard.m_nodes.emplace(std::piecewise_construct,
+                                   std::forward_as_tuple(key),
+                                   std::forward_as_tuple(std::move(object), cost)).first;
+      Node *node = &iter->second;
+      node->m_keyPtr = &iter->first;
+      linkFront(shard, node);
+      shard.m_totalCost += cost;
+      m_totalCost.fetch_add(cost, std::memory_order_relaxed);
+      shard.m_insertions.fetch_add(1, std::memory_order_relaxed);
+   }
+   // this shard is within its share, make room in the others
+   if (m_totalCost.load(std::memory_order_relaxed) > getMaxCost()) {
+      trimOverBudget(&shard);
+   }
+   return true;
+}
+
+template <typename Key, typename T, typename Hash>
+std::shared_ptr<T> ConcurrentCache<Key, T, Hash>::getData(const Key &key) const
+{
+   Shard &shard = getShard(key);
+   if (m_policy == EvictionPolicy::Clock) {
+      std::shared_lock<std::shared_mutex> locker(shard.m_mutex);
+      auto iter = shard.m_nodes.find(key);
+      if (iter == shard.m_nodes.end()) {
+         shard.m_misses.fetch_add(1, std::memory_order_relaxed);
+         return std::shared_ptr<T>();
+      }
+      const Node &node = iter->second;
+      if (!node.m_referenced.load(std::memory_order_relaxed)) {
+         node.m_referenced.store(true, std::memory_order_relaxed);
+      }
+      shard.m_hits.fetch_add(1, std::memory_order_relaxed);
+      return node.m_data;
+   }
+   std::unique_lock<std::shared_mutex> locker(shard.m_mutex);
+   auto iter = shard.m_nodes.find(key);
+   if (iter == shard.m_nodes.end()) {
+      shard.m_misses.fetch_add(1, std::memory_order_relaxed);
+      return std::shared_ptr<T>();
+   }
+   Node *node = &iter->second;
+   if (shard.m_forward != node) {
+      unlinkNode(shard, node);
+      linkFront(shard, node);
+   }
+   shard.m_hits.fetch_add(1, std::memory_order_relaxed);
+   return node->m_data;
+}
+
+template <typename Key, typename T, typename Hash>
+bool ConcurrentCache<Key, T, Hash>::contains(const Key &key) const
+{
+   Shard &shard = getShard(key);
+   std::shared_lock<std::shared_mutex> locker(shard.m_mutex);
+   return shard.m_nodes.find(key) != shard.m_nodes.end();
+}
+
+template <typename Key, typename T, typename Hash>
+bool ConcurrentCache<Key, T, Hash>::remove(const Key &key)
+{
+   return static_cast<bool>(take(key));
+}
+
+template <typename Key, typename T, typename Hash>
+std::shared_ptr<T> ConcurrentCache<Key, T, Hash>::take(const Key &key)
+{
+   Shard &shard = getShard(key);
+   std::unique_lock<std::shared_mutex> locker(shard.m_mutex);
+   auto iter = shard.m_nodes.find(key);
+   if (iter == shard.m_nodes.end()) {
+      return std::shared_ptr<T>();
+   }
+   return eraseNode(shard, &iter->second);
+}
+
+template <typename Key, typename T, typename Hash>
+typename ConcurrentCache<Key, T, Hash>::Statistics
+ConcurrentCache<Key, T, Hash>::getStatistics() const
+{
+   Statistics statistics;
+   for (const std::unique_ptr<Shard> &shard : m_shards) {
+      statistics.m_hits += shard->m_hits.load(std::memory_order_relaxed);
+      statistics.m_misses += shard->m_misses.load(std::memory_order_relaxed);
+      statistics.m_insertions += shard->m_insertions.load(std::memory_order_relaxed);
+      statistics.m_evictions += shard->m_evictions.load(std::memory_order_relaxed);
+   }
+   return statistics;
+}
+
+template <typename Key, typename T, typename Hash>
+void ConcurrentCache<Key, T, Hash>::resetStatistics()
+{
+   for (std::unique_ptr<Shard> &shard : m_shards) {
+      shard->m_hits.store(0, std::memory_order_relaxed);
+      shard->m_misses.store(0, std::memory_order_relaxed);
+      shard->m_insertions.store(0, std::memory_order_relaxed);
+      shard->m_evictions.store(0, std::memory_order_relaxed);
+   }
+}
+
+template <typename Key, typename T, typename Hash>
+inline void ConcurrentCache<Key, T, Hash>::linkFront(Shard &shard, Node *node)
+{
+   node->m_prevNode = nullptr;
+   node->m_nextNode = shard.m_forward;
+   if (shard.m_forward) {
+      shard.m_forward->m_prevNode = node;
+   }
+   shard.m_forward = node;
+   if (!shard.m_last) {
+      shard.m_last = node;
+   }
+}
+
+template <typename Key, typename T, typename Hash>
+inline void ConcurrentCache<Key, T, Hash>::unlinkNode(Shard &shard, Node *node)
+{
+   if (node->m_prevNode) {
+      node->m_prevNode->m_nextNode = node->m_nextNode;
+   }
+   if (node->m_nextNode) {
+      node->m_nextNode->m_prevNode = node->m_prevNode;
+   }
+   if (shard.m_last == node) {
+      shard.m_last = node->m_prevNode;
+   }
+   if (shard.m_forward == node) {
+      shard.m_forward = node->m_nextNode;
+   }
+}
+
+template <typename Key, typename T, typename Hash>
+std::shared_ptr<T> ConcurrentCache<Key, T, Hash>::eraseNode(Shard &shard, Node *node)
+{
+   unlinkNode(shard, node);
+   shard.m_totalCost -= node->m_cost;
+   m_totalCost.fetch_sub(node->m_cost, std::memory_order_relaxed);
+   std::shared_ptr<T> data = std::move(node->m_data);
+   shard.m_nodes.erase(shard.m_nodes.find(*node->m_keyPtr));
+   return data;
+}
+
+// evicts from shard while both the shard would be over maxCost and the cache
+// over budget with reserve more cost, the evicted objects are moved to
+// evicted, the caller releases them once the shard is unlocked
+template <typename Key, typename T, typename Hash>
+void ConcurrentCache<Key, T, Hash>::trim(Shard &shard, int maxCost, int reserve,
+                                         std::vector<std::shared_ptr<T>> &evicted)
+{
+   Node *node = shard.m_last;
+   // every entry gets at most one second chance, so a clock sweep visits
+   // each node at most twice
+   while (node && shard.m_totalCost + reserve > maxCost &&
+          m_totalCost.load(std::memory_order_relaxed) + reserve > getMaxCost()) {
+      Node *victim = node;
+      node = node->m_prevNode;
+      if (m_policy == EvictionPolicy::Clock &&
+          victim->m_referenced.load(std::memory_order_relaxed)) {
+         victim->m_referenced.store(false, std::memory_order_relaxed);
+         unlinkNode(shard, victim);
+         linkFront(shard, victim);
+         if (!node) {
+            node = shard.m_last;
+         }
+         continue;
+      }
+      evicted.push_back(eraseNode(shard, victim));
+      shard.m_evictions.fetch_add(1, std::memory_order_relaxed);
+   }
+}
+
+// evicts until the cache is within budget, first from the shards above their
+// share, then from any shard, the shard that was just inserted into last
+template <typename Key, typename T, typename Hash>
+void ConcurrentCache<Key, T, Hash>::trimOverBudget(Shard *inserted)
+{
+   auto trimShard = [this](Shard &shard, bool toShare) -> bool {
+      if (m_totalCost.load(std::memory_order_relaxed) <= getMaxCost()) {
+         return false;
+      }
+      // released after unlocking, see clear()
+      std::vector<std::shared_ptr<T>> evicted;
+      std::unique_lock<std::shared_mutex> locker(shard.m_mutex);
+      trim(shard, toShare ? shard.m_maxCost : 0, 0, evicted);
+      return true;
+   };
+   for (bool toShare : {true, false}) {
+      for (std::unique_ptr<Shard> &shard : m_shards) {
+         if (shard.get() != inserted && !trimShard(*shard, toShare)) {
+            return;
+         }
+      }
+   }
+   if (inserted) {
+      trimShard(*inserted, false);
+   }
+}
+
+} // utils
+} // pdk
+
+#endif // PDK_UTILS_CONCURRENT_CACHE_H
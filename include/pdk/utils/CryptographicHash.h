@@ -17,6 +17,7 @@
 #define PDK_UTILS_CRYPTO_GRAPHIC_HASH_H
 
 #include "pdk/base/ds/ByteArray.h"
+#include <vector>
 
 namespace pdk {
 
@@ -90,6 +91,8 @@ public:
    ByteArray result() const;
    
    static ByteArray hash(const ByteArray &data, Algorithm method);
+   // hashes every item on its own, several at once where the CPU allows
+   static std::vector<ByteArray> hashMany(const std::vector<ByteArray> &data, Algorithm method);
 private:
    PDK_DISABLE_COPY(CryptographicHash);
    CryptographicHashPrivate *m_implPtr;
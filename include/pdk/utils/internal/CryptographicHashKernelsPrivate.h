@@ -0,0 +1,68 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_UTILS_INTERNAL_CRYPTOGRAPHIC_HASH_KERNELS_PRIVATE_H
+#define PDK_UTILS_INTERNAL_CRYPTOGRAPHIC_HASH_KERNELS_PRIVATE_H
+
+#include "pdk/global/Global.h"
+#include <cstddef>
+
+namespace pdk {
+namespace utils {
+namespace internal {
+
+// compresses count consecutive 64 byte blocks into the chaining value
+using HashBlockFunction = void (*)(pdk::puint32 *hash, const uchar *blocks, size_t count);
+
+// running state of SHA-1, SHA-224 and SHA-256, which share the block size
+// and the padding
+struct BlockHashState
+{
+   pdk::puint32 m_hash[8];
+   pdk::puint64 m_length;
+   uchar m_buffer[64];
+};
+
+// the best block function the CPU runs, picked once
+PDK_CORE_EXPORT HashBlockFunction sha1_block_function();
+PDK_CORE_EXPORT HashBlockFunction sha256_block_function();
+
+PDK_CORE_EXPORT void sha1_blocks_generic(pdk::puint32 *hash, const uchar *blocks, size_t count);
+PDK_CORE_EXPORT void sha256_blocks_generic(pdk::puint32 *hash, const uchar *blocks, size_t count);
+
+PDK_CORE_EXPORT void sha1_init(BlockHashState *state);
+PDK_CORE_EXPORT void sha224_init(BlockHashState *state);
+PDK_CORE_EXPORT void sha256_init(BlockHashState *state);
+PDK_CORE_EXPORT void block_hash_update(BlockHashState *state, const uchar *data, size_t length,
+                                       HashBlockFunction blocks);
+// pads a copy of the state, the state itself can take more data
+PDK_CORE_EXPORT void block_hash_final(const BlockHashState *state, uchar *digest, int digestSize,
+                                      HashBlockFunction blocks);
+
+// Hash count independent messages, digestSize bytes each written back to
+// back. SHA-224/256 messages go through eight AVX2 lanes at a time, Keccak
+// ones through four. These return false when that would not be faster than
+// hashing one message after the other, which is then up to the caller.
+PDK_CORE_EXPORT bool sha256_many(const uchar *const *data, const size_t *lengths, size_t count,
+                                 int digestSize, uchar *digests);
+// rate in bytes, suffix 0x06 for SHA-3 and 0x01 for the original Keccak
+PDK_CORE_EXPORT bool keccak_many(const uchar *const *data, const size_t *lengths, size_t count,
+                                 int rate, uchar suffix, int digestSize, uchar *digests);
+
+} // internal
+} // utils
+} // pdk
+
+#endif // PDK_UTILS_INTERNAL_CRYPTOGRAPHIC_HASH_KERNELS_PRIVATE_H
@@ -0,0 +1,45 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#ifndef PDK_UTILS_INTERNAL_DOUBLE_CONVERSION_PRIVATE_H
+#define PDK_UTILS_INTERNAL_DOUBLE_CONVERSION_PRIVATE_H
+
+#include "pdk/global/Global.h"
+
+namespace pdk {
+namespace utils {
+namespace internal {
+
+// Binary to decimal and back without going through the C library, so the
+// result does not depend on its locale or on how well it rounds.
+//
+// double_to_shortest() is Schubfach (R. Giulietti, "The Schubfach way to
+// render doubles"): the shortest digits that read back as d, the closest
+// to d among them. d must be finite and greater than zero. At most 17
+// digits are written, without trailing zeros, and their number returned.
+// The value is 0.digits times 10 to the power of decpt.
+PDK_CORE_EXPORT int double_to_shortest(double d, char *digits, int *decpt) noexcept;
+
+// w times 10 to the power of q, correctly rounded, using Clinger's exact
+// fast path or the Eisel-Lemire algorithm. Returns false in the rare cases
+// the algorithm can not decide, the caller must then use an exact method.
+// Overflow gives an infinity, underflow a zero.
+PDK_CORE_EXPORT bool decimal_to_double(pdk::puint64 w, int q, bool negative, double *result) noexcept;
+
+} // internal
+} // utils
+} // pdk
+
+#endif // PDK_UTILS_INTERNAL_DOUBLE_CONVERSION_PRIVATE_H
@@ -14,6 +14,7 @@
 // Created by softboy on 2018/03/07.
 
 #include "pdk/dll/internal/FactoryLoaderPrivate.h"
+#include "pdk/dll/internal/PluginIndexPrivate.h"
 #include "pdk/dll/FactoryInterface.h"
 #include "pdk/dll/Plugin.h"
 #include "pdk/dll/PluginLoader.h"
@@ -26,9 +27,17 @@
 #include "pdk/base/utils/json/JsonObject.h"
 #include "pdk/base/utils/json/JsonArray.h"
 #include "pdk/global/GlobalStatic.h"
+#include "pdk/kernel/ElapsedTimer.h"
+#include "pdk/base/os/thread/Runnable.h"
+#include "pdk/base/os/thread/Semaphore.h"
+#include "pdk/base/os/thread/ThreadPool.h"
 
 #include <list>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace pdk {
 namespace dll {
@@ -45,6 +54,9 @@ using pdk::io::fs::Dir;
 using pdk::io::fs::FileInfo;
 using pdk::utils::json::JsonArray;
 using pdk::dll::Library;
+using pdk::kernel::ElapsedTimer;
+using pdk::os::thread::Runnable;
+using pdk::os::thread::Semaphore;
 
 class FactoryLoaderPrivate : public ObjectPrivate
 {
@@ -53,18 +65,68 @@ public:
    FactoryLoaderPrivate()
    {}
    
+   void updateKeyIndex() const;
+   
    ByteArray m_iid;
 #if PDK_CONFIG(library)
    ~FactoryLoaderPrivate();
    mutable std::mutex m_mutex;
-   std::list<LibraryPrivate *> m_libraryList;
-   std::map<String, LibraryPrivate*> m_keyMap;
+   std::vector<LibraryPrivate *> m_libraryList;
+   std::unordered_map<String, LibraryPrivate *> m_keyMap;
    String m_suffix;
    pdk::CaseSensitivity m_cs;
    StringList m_loadedPaths;
+   std::vector<PluginLoadTiming> m_loadTimings;
+#else
+   mutable std::mutex m_mutex;
 #endif
+   // the keys of every plugin getInstance() can reach, in its index order,
+   // and the first index serving each lower cased key
+   mutable std::vector<std::pair<int, String>> m_keys;
+   mutable std::unordered_map<String, int> m_keyIndex;
+   mutable size_t m_keyIndexStaticPlugins = 0;
+   mutable bool m_keyIndexValid = false;
 };
 
+// Rebuilds the key lookup tables when plugins were added, called with
+// m_mutex held
+void FactoryLoaderPrivate::updateKeyIndex() const
+{
+   if (m_keyIndexValid && m_keyIndexStaticPlugins == static_plugin_count()) {
+      return;
+   }
+   const std::vector<StaticPlugin> staticPlugins = PluginLoader::getStaticPlugins();
+   m_keys.clear();
+   m_keyIndex.clear();
+   int index = 0;
+   auto addKeys = [this, &index](const JsonObject &metaData) {
+      const JsonArray keys = metaData.getValue(Latin1String("MetaData")).toObject()
+            .getValue(Latin1String("Keys")).toArray();
+      const int keyCount = keys.getSize();
+      for (int k = 0; k < keyCount; ++k) {
+         const String key = keys.at(k).toString();
+         m_keys.emplace_back(index, key);
+         m_keyIndex.emplace(key.toLower(), index);
+      }
+      ++index;
+   };
+#if PDK_CONFIG(library)
+   for (const LibraryPrivate *library : m_libraryList) {
+      addKeys(library->m_metaData);
+   }
+#endif
+   const Latin1String iid(m_iid.getConstRawData(), m_iid.size());
+   for (const StaticPlugin &plugin : staticPlugins) {
+      const JsonObject object = plugin.getMetaData();
+      if (object.getValue(Latin1String("IID")) != iid) {
+         continue;
+      }
+      addKeys(object);
+   }
+   m_keyIndexStaticPlugins = staticPlugins.size();
+   m_keyIndexValid = true;
+}
+
 #if PDK_CONFIG(library)
 
 PDK_GLOBAL_STATIC(std::list<FactoryLoader *>, sg_factoryLoaders);
@@ -72,19 +134,107 @@ PDK_GLOBAL_STATIC(std::recursive_mutex, sg_factoryloaderMutex);
 
 FactoryLoaderPrivate::~FactoryLoaderPrivate()
 {
-   for (size_t i = 0; i < m_libraryList.size(); ++i) {
-      auto iter = m_libraryList.begin();
-      std::advance(iter, i);
-      LibraryPrivate *library = *iter;
+   for (LibraryPrivate *library : m_libraryList) {
       library->unload();
       library->release();
    }
 }
 
+namespace {
+
+// One file found in a plugin directory. scan_plugin_candidate() fills in
+// the rest, possibly on a pool thread, and touches nothing but the
+// candidate and its own LibraryPrivate
+struct PluginCandidate
+{
+   String m_fileName;
+   PluginIndex *m_index;
+   PluginFileStamp m_stamp;
+   JsonObject m_indexedMetaData;
+   String m_indexedErrorString;
+   bool m_indexed;
+   LibraryPrivate *m_library;
+   bool m_isPlugin;
+   bool m_matchesIid;
+   bool m_loaded;
+   pdk::pint64 m_scanNsecs;
+   pdk::pint64 m_loadNsecs;
+};
+
+void scan_plugin_candidate(PluginCandidate &candidate, const String &iid, bool load)
+{
+   ElapsedTimer timer;
+   timer.start();
+   LibraryPrivate *library = LibraryPrivate::findOrCreate(candidate.m_fileName);
+   candidate.m_library = library;
+   candidate.m_isPlugin = candidate.m_indexed
+         ? library->isPlugin(candidate.m_indexedMetaData, candidate.m_indexedErrorString)
+         : library->isPlugin();
+   candidate.m_matchesIid = candidate.m_isPlugin
+         && library->m_metaData.getValue(Latin1String("IID")).toString() == iid;
+   candidate.m_scanNsecs = timer.getNsecsElapsed();
+   if (load && candidate.m_matchesIid) {
+      timer.start();
+      candidate.m_loaded = library->loadPlugin();
+      candidate.m_loadNsecs = timer.getNsecsElapsed();
+   }
+}
+
+class PluginScanTask : public Runnable
+{
+public:
+   PluginScanTask(PluginCandidate *candidate, const String &iid, bool load, Semaphore *done)
+      : m_candidate(candidate),
+        m_iid(iid),
+        m_load(load),
+        m_done(done)
+   {}
+   
+   void run() override
+   {
+      scan_plugin_candidate(*m_candidate, m_iid, m_load);
+      m_done->release();
+   }
+   
+private:
+   PluginCandidate *m_candidate;
+   const String &m_iid;
+   bool m_load;
+   Semaphore *m_done;
+};
+
+} // anonymous namespace
+
 void FactoryLoader::update()
+{
+   scan(nullptr, false);
+}
+
+void FactoryLoader::updateConcurrently(ThreadPool *pool, bool load)
+{
+   scan(pool ? pool : ThreadPool::getGlobalInstance(), load);
+}
+
+std::vector<PluginLoadTiming> FactoryLoader::getLoadTimings() const
+{
+   PDK_D(const FactoryLoader);
+   std::lock_guard<std::mutex> locker(implPtr->m_mutex);
+   return implPtr->m_loadTimings;
+}
+
+// Finds the files in new plugin directories, validates them and, when asked,
+// loads the ones implementing our interface, on pool when there is one. The
+// results are then resolved in directory order and published in one step,
+// so the key a plugin ends up serving does not depend on which load
+// finished first
+void FactoryLoader::scan(ThreadPool *pool, bool load)
 {
 #ifdef PDK_SHARED
    PDK_D(FactoryLoader);
+   const String iid = String::fromLatin1(implPtr->m_iid);
+   std::vector<std::unique_ptr<PluginIndex>> indexes;
+   std::vector<PluginCandidate> candidates;
+   std::unordered_set<String> seenFiles;
    StringList paths = CoreApplication::getLibraryPaths();
    for (size_t i = 0; i < paths.size(); ++i) {
       const String &pluginDir = paths.at(i);
@@ -101,13 +251,14 @@ void FactoryLoader::update()
          continue;
       }
       
-      
+      // metadata of files unchanged since the last scan comes from here
+      indexes.push_back(std::make_unique<PluginIndex>(path));
+      PluginIndex *index = indexes.back().get();
       StringList plugins = Dir(path).entryList(
          #ifdef PDK_OS_WIN
                StringList(StringLiteral("*.dll")),
          #endif
                Dir::Filter::Files);
-      LibraryPrivate *library = nullptr;
 #ifdef PDK_OS_MAC
       // Loading both the debug and release version of the cocoa plugins causes the objective-c runtime
       // to print "duplicate class definitions" warnings. Detect if FactoryLoader is about to load both,
@@ -137,62 +288,129 @@ void FactoryLoader::update()
          if (pdk_debug_component()) {
             debug_stream() << "FactoryLoader::FactoryLoader() looking at" << fileName;
          }
-         library = LibraryPrivate::findOrCreate(FileInfo(fileName).getCanonicalFilePath());
-         if (!library->isPlugin()) {
-            if (pdk_debug_component()) {
-               debug_stream() << library->m_errorString << pdk::io::endl
-                              << "         not a plugin";
-            }
-            library->release();
+         // two names for one file would hand one LibraryPrivate to two tasks
+         const String canonicalFileName = FileInfo(fileName).getCanonicalFilePath();
+         if (!seenFiles.insert(canonicalFileName).second) {
             continue;
          }
-         
-         StringList keys;
-         bool metaDataOk = false;
-         
-         String iid = library->m_metaData.getValue(Latin1String("IID")).toString();
-         if (iid == Latin1String(implPtr->m_iid.getConstRawData(), implPtr->m_iid.size())) {
-            JsonObject object = library->m_metaData.getValue(Latin1String("MetaData")).toObject();
-            metaDataOk = true;
-            JsonArray k = object.getValue(Latin1String("Keys")).toArray();
-            for (int i = 0; i < k.getSize(); ++i) {
-               keys += implPtr->m_cs == pdk::CaseSensitivity::Sensitive? k.at(i).toString() : k.at(i).toString().toLower();
-            }
+         PluginCandidate candidate = {};
+         candidate.m_fileName = canonicalFileName;
+         candidate.m_index = index;
+         if (index->isEnabled()) {
+            candidate.m_stamp = PluginFileStamp::fromFile(canonicalFileName);
+         }
+         candidate.m_indexed = index->lookup(canonicalFileName, candidate.m_stamp,
+                                             &candidate.m_indexedMetaData,
+                                             &candidate.m_indexedErrorString);
+         candidates.push_back(std::move(candidate));
+      }
+   }
+   
+   if (pool && candidates.size() > 1) {
+      Semaphore done;
+      for (PluginCandidate &candidate : candidates) {
+         pool->start(new PluginScanTask(&candidate, iid, load, &done));
+      }
+      done.acquire(static_cast<int>(candidates.size()));
+   } else {
+      for (PluginCandidate &candidate : candidates) {
+         scan_plugin_candidate(candidate, iid, load);
+      }
+   }
+   
+   std::unordered_map<String, LibraryPrivate *> keyMap;
+   std::vector<LibraryPrivate *> accepted;
+   std::vector<PluginLoadTiming> timings;
+   {
+      std::lock_guard<std::mutex> locker(implPtr->m_mutex);
+      keyMap = implPtr->m_keyMap;
+   }
+   for (PluginCandidate &candidate : candidates) {
+      LibraryPrivate *library = candidate.m_library;
+      if (!candidate.m_indexed) {
+         if (candidate.m_isPlugin) {
+            candidate.m_index->insert(candidate.m_fileName, candidate.m_stamp, library->m_metaData);
+         } else {
+            candidate.m_index->insert(candidate.m_fileName, candidate.m_stamp, JsonObject(),
+                                      library->m_errorString);
          }
+      }
+      timings.push_back(PluginLoadTiming{candidate.m_fileName, candidate.m_scanNsecs,
+                                         candidate.m_loadNsecs, candidate.m_loaded});
+      if (pdk_debug_component() && candidate.m_matchesIid) {
+         debug_stream() << "FactoryLoader::scan()" << candidate.m_fileName << "validated in"
+                        << candidate.m_scanNsecs / 1000 << "us, loaded in"
+                        << candidate.m_loadNsecs / 1000 << "us";
+      }
+      if (!candidate.m_isPlugin || (load && candidate.m_matchesIid && !candidate.m_loaded)) {
          if (pdk_debug_component()) {
-            debug_stream() << "Got keys from plugin meta data" << keys;
+            debug_stream() << library->m_errorString << pdk::io::endl
+                           << "         not a plugin";
          }
-         if (!metaDataOk) {
-            library->release();
-            continue;
+         library->release();
+         continue;
+      }
+      
+      StringList keys;
+      bool metaDataOk = false;
+      
+      if (candidate.m_matchesIid) {
+         JsonObject object = library->m_metaData.getValue(Latin1String("MetaData")).toObject();
+         metaDataOk = true;
+         JsonArray k = object.getValue(Latin1String("Keys")).toArray();
+         for (int i = 0; i < k.getSize(); ++i) {
+            keys += implPtr->m_cs == pdk::CaseSensitivity::Sensitive? k.at(i).toString() : k.at(i).toString().toLower();
          }
-         int keyUsageCount = 0;
-         for (size_t k = 0; k < keys.size(); ++k) {
-            // first come first serve, unless the first
-            // library was built with a future pdk version,
-            // whereas the new one has a pdk version that fits
-            // better
-            const String &key = keys.at(k);
-            LibraryPrivate *previous = implPtr->m_keyMap.at(key);
-            int prevPdkVersion = 0;
-            if (previous) {
-               prevPdkVersion = (int)previous->m_metaData.getValue(Latin1String("version")).toDouble();
-            }
-            int pdkVersion = (int)library->m_metaData.getValue(Latin1String("version")).toDouble();
-            if (!previous || (prevPdkVersion > PDK_VERSION && pdkVersion <= PDK_VERSION)) {
-               implPtr->m_keyMap[key] = library;
-               ++keyUsageCount;
-            }
+      }
+      if (pdk_debug_component()) {
+         debug_stream() << "Got keys from plugin meta data" << keys;
+      }
+      if (!metaDataOk) {
+         library->release();
+         continue;
+      }
+      int keyUsageCount = 0;
+      for (size_t k = 0; k < keys.size(); ++k) {
+         // first come first serve, unless the first
+         // library was built with a future pdk version,
+         // whereas the new one has a pdk version that fits
+         // better
+         const String &key = keys.at(k);
+         auto previousIter = keyMap.find(key);
+         LibraryPrivate *previous = previousIter != keyMap.end() ? previousIter->second : nullptr;
+         int prevPdkVersion = 0;
+         if (previous) {
+            prevPdkVersion = (int)previous->m_metaData.getValue(Latin1String("version")).toDouble();
          }
-         if (keyUsageCount || keys.empty()) {
-            library->setLoadHints(Library::LoadHint::PreventUnloadHint); // once loaded, don't unload
-            implPtr->m_libraryList.push_back(library);
-         } else {
-            library->release();
+         int pdkVersion = (int)library->m_metaData.getValue(Latin1String("version")).toDouble();
+         if (!previous || (prevPdkVersion > PDK_VERSION && pdkVersion <= PDK_VERSION)) {
+            keyMap[key] = library;
+            ++keyUsageCount;
+         }
+      }
+      if (keyUsageCount || keys.empty()) {
+         library->setLoadHints(Library::LoadHint::PreventUnloadHint); // once loaded, don't unload
+         accepted.push_back(library);
+      } else {
+         // lost every key to an earlier plugin, give back what was loaded for it
+         if (candidate.m_loaded) {
+            library->unload();
          }
+         library->release();
       }
    }
+   for (const std::unique_ptr<PluginIndex> &index : indexes) {
+      index->save();
+   }
+   
+   std::lock_guard<std::mutex> locker(implPtr->m_mutex);
+   implPtr->m_libraryList.insert(implPtr->m_libraryList.end(), accepted.cbegin(), accepted.cend());
+   implPtr->m_keyMap.swap(keyMap);
+   implPtr->m_loadTimings.insert(implPtr->m_loadTimings.end(), timings.cbegin(), timings.cend());
+   implPtr->m_keyIndexValid = false;
 #else
+   PDK_UNUSED(pool);
+   PDK_UNUSED(load);
    PDK_D(FactoryLoader);
    if (pdk_debug_component()) {
       debug_stream() << "FactoryLoader::FactoryLoader() ignoring" << implPtr->m_iid
@@ -211,7 +429,9 @@ FactoryLoader::~FactoryLoader()
 LibraryPrivate *FactoryLoader::library(const String &key) const
 {
    PDK_D(const FactoryLoader);
-   return implPtr->m_keyMap.at(implPtr->m_cs ? key : key.toLower());
+   std::lock_guard<std::mutex> locker(implPtr->m_mutex);
+   auto iter = implPtr->m_keyMap.find(implPtr->m_cs == pdk::CaseSensitivity::Sensitive ? key : key.toLower());
+   return iter != implPtr->m_keyMap.end() ? iter->second : nullptr;
 }
 #endif
 
@@ -254,10 +474,8 @@ std::list<JsonObject> FactoryLoader::getMetaData() const
    std::list<JsonObject> metaData;
 #if PDK_CONFIG(library)
    std::lock_guard<std::mutex> locker(implPtr->m_mutex);
-   for (size_t i = 0; i < implPtr->m_libraryList.size(); ++i) {
-      auto iter = implPtr->m_libraryList.begin();
-      std::advance(iter, i);
-      metaData.push_back((*iter)->m_metaData);
+   for (const LibraryPrivate *library : implPtr->m_libraryList) {
+      metaData.push_back(library->m_metaData);
    }
 #endif
    const auto staticPlugins = PluginLoader::getStaticPlugins();
@@ -280,9 +498,7 @@ Object *FactoryLoader::getInstance(int index) const
 #if PDK_CONFIG(library)
    std::unique_lock<std::mutex> lock(implPtr->m_mutex);
    if (static_cast<size_t>(index) < implPtr->m_libraryList.size()) {
-      auto iter = implPtr->m_libraryList.begin();
-      std::advance(iter, index);
-      LibraryPrivate *library = *iter;
+      LibraryPrivate *library = implPtr->m_libraryList[index];
       if (library->m_instance || library->loadPlugin()) {
          if (!library->m_inst) {
             library->m_inst = library->m_instance();
@@ -316,37 +532,19 @@ Object *FactoryLoader::getInstance(int index) const
 
 std::multimap<int, String> FactoryLoader::getKeyMap() const
 {
-   std::multimap<int, String> result;
-   const std::list<JsonObject> metaDataList = getMetaData();
-   for (size_t i = 0; i < metaDataList.size(); ++i) {
-      auto iter = metaDataList.begin();
-      std::advance(iter, i);
-      const JsonObject metaData = (*iter).getValue(Latin1String("MetaData")).toObject();
-      const JsonArray keys = metaData.getValue(Latin1String("Keys")).toArray();
-      const int keyCount = keys.getSize();
-      for (int k = 0; k < keyCount; ++k) {
-         result.insert(std::pair<int, String>(i, keys.at(k).toString()));
-      }
-   }
-   return result;
+   PDK_D(const FactoryLoader);
+   std::lock_guard<std::mutex> locker(implPtr->m_mutex);
+   implPtr->updateKeyIndex();
+   return std::multimap<int, String>(implPtr->m_keys.cbegin(), implPtr->m_keys.cend());
 }
 
 int FactoryLoader::indexOf(const String &needle) const
 {
-   const std::list<JsonObject> metaDataList = getMetaData();
-   for (size_t i = 0; i < metaDataList.size(); ++i) {
-      auto iter = metaDataList.begin();
-      std::advance(iter, i);
-      const JsonObject metaData = (*iter).getValue(Latin1String("MetaData")).toObject();
-      const JsonArray keys = metaData.getValue(Latin1String("Keys")).toArray();
-      const int keyCount = keys.getSize();
-      for (int k = 0; k < keyCount; ++k) {
-         if (!keys.at(k).toString().compare(needle, pdk::CaseSensitivity::Insensitive)) {
-            return i;
-         }
-      }
-   }
-   return -1;
+   PDK_D(const FactoryLoader);
+   std::lock_guard<std::mutex> locker(implPtr->m_mutex);
+   implPtr->updateKeyIndex();
+   auto iter = implPtr->m_keyIndex.find(needle.toLower());
+   return iter != implPtr->m_keyIndex.end() ? iter->second : -1;
 }
 
 } // internal
@@ -362,7 +362,8 @@ inline LibraryPrivate *LibraryStore::findOrCreate(const String &fileName, const
    // check if this library is already loaded
    LibraryPrivate *lib = 0;
    if (PDK_LIKELY(data)) {
-      lib = data->m_libraryMap.at(fileName);
+      auto iter = data->m_libraryMap.find(fileName);
+      lib = iter != data->m_libraryMap.end() ? iter->second : nullptr;
       if (lib) {
          lib->mergeLoadHints(loadHints);
       }
@@ -546,6 +547,23 @@ bool LibraryPrivate::isPlugin()
    return m_pluginState == IsAPlugin;
 }
 
+bool LibraryPrivate::isPlugin(const JsonObject &indexedMetaData, const String &indexedErrorString)
+{
+   if (m_pluginState == MightBeAPlugin) {
+      m_errorString.clear();
+      if (indexedMetaData.isEmpty()) {
+         m_errorString = indexedErrorString.isEmpty()
+               ? Library::tr("The file '%1' is not a valid pdk plugin.").arg(m_fileName)
+               : indexedErrorString;
+         m_pluginState = IsNotAPlugin;
+      } else {
+         m_metaData = indexedMetaData;
+         checkPluginVersion();
+      }
+   }
+   return m_pluginState == IsAPlugin;
+}
+
 void LibraryPrivate::updatePluginState()
 {
    m_errorString.clear();
@@ -587,6 +605,11 @@ void LibraryPrivate::updatePluginState()
       m_pluginState = IsNotAPlugin;
       return;
    }
+   checkPluginVersion();
+}
+
+void LibraryPrivate::checkPluginVersion()
+{
    m_pluginState = IsNotAPlugin; // be pessimistic
    uint pdkVersion = (uint)m_metaData.getValue(Latin1String("version")).toDouble();
    bool debug = m_metaData.getValue(Latin1String("debug")).toBool();
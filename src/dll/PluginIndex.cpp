@@ -0,0 +1,244 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/dll/internal/PluginIndexPrivate.h"
+#include "pdk/dll/internal/LibraryPrivate.h"
+#include "pdk/base/io/fs/Dir.h"
+#include "pdk/base/io/fs/File.h"
+#include "pdk/base/io/fs/FileInfo.h"
+#include "pdk/base/io/fs/SaveFile.h"
+#include "pdk/base/io/fs/StandardPaths.h"
+#include "pdk/base/io/Debug.h"
+#include "pdk/base/time/DateTime.h"
+#include "pdk/base/utils/json/JsonDocument.h"
+#include "pdk/base/utils/json/JsonValue.h"
+#include "pdk/utils/CryptographicHash.h"
+#include "pdk/utils/Funcs.h"
+
+#if defined(PDK_OS_UNIX)
+#  include <sys/stat.h>
+#endif
+
+namespace pdk {
+namespace dll {
+namespace internal {
+
+using pdk::ds::ByteArray;
+using pdk::io::IoDevice;
+using pdk::io::fs::Dir;
+using pdk::io::fs::File;
+using pdk::io::fs::FileInfo;
+using pdk::io::fs::SaveFile;
+using pdk::io::fs::StandardPaths;
+using pdk::lang::Latin1String;
+using pdk::lang::Latin1Character;
+using pdk::utils::CryptographicHash;
+using pdk::utils::json::JsonDocument;
+using pdk::utils::json::JsonValue;
+
+namespace {
+
+// bump when the layout below changes
+constexpr int PLUGIN_INDEX_FORMAT = 2;
+
+#ifdef PDK_NO_DEBUG
+constexpr bool PLUGIN_INDEX_DEBUG = false;
+#else
+constexpr bool PLUGIN_INDEX_DEBUG = true;
+#endif
+
+// the 64 bit stamp fields do not survive a trip through a JSON double
+String stamp_field(pdk::pint64 value)
+{
+   return String::number(static_cast<pdk::plonglong>(value));
+}
+
+} // anonymous namespace
+
+PluginFileStamp PluginFileStamp::fromFile(const String &fileName)
+{
+   PluginFileStamp stamp;
+#if defined(PDK_OS_UNIX)
+   struct stat statBuffer;
+   if (::stat(File::encodeName(fileName).getConstRawData(), &statBuffer) != 0) {
+      return stamp;
+   }
+   stamp.m_size = statBuffer.st_size;
+   stamp.m_modified = static_cast<pdk::pint64>(statBuffer.st_mtime) * 1000000000;
+#  if defined(PDK_OS_DARWIN)
+   stamp.m_modified += statBuffer.st_mtimespec.tv_nsec;
+#  elif defined(PDK_OS_LINUX)
+   stamp.m_modified += statBuffer.st_mtim.tv_nsec;
+#  endif
+   stamp.m_inode = statBuffer.st_ino;
+#else
+   const FileInfo info(fileName);
+   if (!info.exists()) {
+      return stamp;
+   }
+   stamp.m_size = info.getSize();
+   stamp.m_modified = info.getLastModified().toMSecsSinceEpoch() * 1000000;
+#endif
+   return stamp;
+}
+
+PluginIndex::PluginIndex(const String &directory)
+   : m_directory(directory),
+     m_indexFileName(getIndexFileName(directory)),
+     m_dirty(false)
+{
+   if (isEnabled()) {
+      load();
+   }
+}
+
+String PluginIndex::getIndexFileName(const String &directory)
+{
+   if (pdk::env_var_intval("PDK_NO_PLUGIN_INDEX")) {
+      return String();
+   }
+   String location = pdk::get_env_var("PDK_PLUGIN_INDEX_PATH");
+   if (location.isEmpty()) {
+#ifndef PDK_NO_STANDARDPATHS
+      location = StandardPaths::writableLocation(StandardPaths::StandardLocation::GenericCacheLocation);
+#endif
+      if (location.isEmpty()) {
+         return String();
+      }
+      location += Latin1String("/pdk/plugin-index");
+   }
+   // one index per directory, named after a digest of its path
+   const ByteArray digest = CryptographicHash::hash(directory.toUtf8(), CryptographicHash::Sha1).toHex();
+   return location + Latin1Character('/') + String::fromLatin1(digest) + Latin1String(".index");
+}
+
+void PluginIndex::load()
+{
+   File file(m_indexFileName);
+   if (!file.open(IoDevice::OpenMode::ReadOnly)) {
+      return;
+   }
+   const JsonDocument document = JsonDocument::fromBinaryData(file.readAll());
+   const JsonObject root = document.getObject();
+   // an index written by another build may have judged plugins differently
+   if (root.getValue(Latin1String("format")).toInt() != PLUGIN_INDEX_FORMAT
+       || root.getValue(Latin1String("version")).toInt() != PDK_VERSION
+       || root.getValue(Latin1String("debug")).toBool() != PLUGIN_INDEX_DEBUG
+       || root.getValue(Latin1String("directory")).toString() != m_directory) {
+      if (pdk_debug_component() && !document.isNull()) {
+         debug_stream() << "PluginIndex: discarding stale index" << m_indexFileName;
+      }
+      return;
+   }
+   const JsonObject plugins = root.getValue(Latin1String("plugins")).toObject();
+   m_entries.reserve(plugins.getSize());
+   for (JsonObject::const_iterator iter = plugins.cbegin(); iter != plugins.cend(); ++iter) {
+      const JsonObject object = iter.getValue().toObject();
+      Entry entry;
+      entry.m_stamp.m_size = object.getValue(Latin1String("size")).toString().toLongLong();
+      entry.m_stamp.m_modified = object.getValue(Latin1String("modified")).toString().toLongLong();
+      entry.m_stamp.m_inode = object.getValue(Latin1String("inode")).toString().toULongLong();
+      entry.m_metaData = object.getValue(Latin1String("metaData")).toObject();
+      entry.m_errorString = object.getValue(Latin1String("error")).toString();
+      entry.m_seen = false;
+      m_entries.emplace(iter.getKey(), std::move(entry));
+   }
+}
+
+bool PluginIndex::lookup(const String &fileName, const PluginFileStamp &stamp, JsonObject *metaData,
+                         String *errorString)
+{
+   if (!stamp.isValid()) {
+      return false;
+   }
+   auto iter = m_entries.find(fileName);
+   if (iter == m_entries.end()) {
+      return false;
+   }
+   Entry &entry = iter->second;
+   if (entry.m_stamp != stamp) {
+      return false;
+   }
+   entry.m_seen = true;
+   *metaData = entry.m_metaData;
+   *errorString = entry.m_errorString;
+   return true;
+}
+
+void PluginIndex::insert(const String &fileName, const PluginFileStamp &stamp, const JsonObject &metaData,
+                         const String &errorString)
+{
+   if (!isEnabled() || !stamp.isValid()) {
+      return;
+   }
+   m_entries[fileName] = Entry{stamp, metaData, errorString, true};
+   m_dirty = true;
+}
+
+bool PluginIndex::save()
+{
+   if (!isEnabled()) {
+      return false;
+   }
+   // files that were removed since the index was written drop out
+   for (auto iter = m_entries.begin(); iter != m_entries.end();) {
+      if (!iter->second.m_seen) {
+         iter = m_entries.erase(iter);
+         m_dirty = true;
+      } else {
+         ++iter;
+      }
+   }
+   if (!m_dirty) {
+      return true;
+   }
+   JsonObject plugins;
+   for (auto iter = m_entries.cbegin(); iter != m_entries.cend(); ++iter) {
+      const Entry &entry = iter->second;
+      JsonObject object;
+      object.insert(Latin1String("size"), stamp_field(entry.m_stamp.m_size));
+      object.insert(Latin1String("modified"), stamp_field(entry.m_stamp.m_modified));
+      object.insert(Latin1String("inode"),
+                    String::number(static_cast<pdk::pulonglong>(entry.m_stamp.m_inode)));
+      object.insert(Latin1String("metaData"), entry.m_metaData);
+      if (!entry.m_errorString.isEmpty()) {
+         object.insert(Latin1String("error"), entry.m_errorString);
+      }
+      plugins.insert(iter->first, object);
+   }
+   JsonObject root;
+   root.insert(Latin1String("format"), PLUGIN_INDEX_FORMAT);
+   root.insert(Latin1String("version"), PDK_VERSION);
+   root.insert(Latin1String("debug"), PLUGIN_INDEX_DEBUG);
+   root.insert(Latin1String("directory"), m_directory);
+   root.insert(Latin1String("plugins"), plugins);
+
+   Dir().mkpath(FileInfo(m_indexFileName).getAbsolutePath());
+   SaveFile file(m_indexFileName);
+   if (!file.open(IoDevice::OpenMode::WriteOnly)
+       || file.write(JsonDocument(root).toBinaryData()) < 0
+       || !file.commit()) {
+      if (pdk_debug_component()) {
+         debug_stream() << "PluginIndex: could not write" << m_indexFileName;
+      }
+      return false;
+   }
+   m_dirty = false;
+   return true;
+}
+
+} // internal
+} // dll
+} // pdk
@@ -244,6 +244,12 @@ std::vector<StaticPlugin> PluginLoader::getStaticPlugins()
    return std::vector<StaticPlugin>();
 }
 
+size_t internal::static_plugin_count()
+{
+   const StaticPluginList *plugins = sg_staticPluginList();
+   return plugins ? plugins->size() : 0;
+}
+
 JsonObject StaticPlugin::getMetaData() const
 {
    return internal::json_from_raw_library_meta_data(m_rawMetaData()).getObject();
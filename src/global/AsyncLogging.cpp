@@ -0,0 +1,614 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/global/Global.h"
+#include "pdk/global/Logging.h"
+#include "pdk/global/GlobalStatic.h"
+#include "pdk/global/internal/AsyncLoggingPrivate.h"
+#include "pdk/base/ds/ByteArray.h"
+#include "pdk/base/lang/String.h"
+
+#ifdef PDK_OS_UNIX
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/uio.h>
+# include <unistd.h>
+# include "pdk/kernel/internal/CoreUnixPrivate.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pdk {
+namespace internal {
+
+using pdk::ds::ByteArray;
+using pdk::lang::String;
+
+namespace {
+
+// every record in a ring starts with this header, the payload follows and
+// the whole record is padded to RecordAlignment
+struct RecordHeader
+{
+   puint32 m_size;
+   puint32 m_type;
+};
+
+constexpr size_t RecordAlignment = 8;
+constexpr puint32 PaddingRecord = 0xffffffffu;
+constexpr int MinBufferSize = 4096;
+constexpr int MaxIoVectors = 1024;
+
+inline size_t record_size(size_t payload)
+{
+   return (sizeof(RecordHeader) + payload + RecordAlignment - 1) & ~(RecordAlignment - 1);
+}
+
+// single producer single consumer byte ring, the owning thread appends and
+// only the writer thread consumes. m_head and m_tail grow monotonically,
+// records never wrap around the end of the buffer
+class LogRing
+{
+public:
+   explicit LogRing(size_t capacity)
+      : m_capacity(capacity),
+        m_data(new char[capacity])
+   {}
+
+   size_t getCapacity() const
+   {
+      return m_capacity;
+   }
+
+   // records above this size could fail to fit even into an empty ring
+   size_t getMaxRecordSize() const
+   {
+      return m_capacity / 2;
+   }
+
+   bool isEmpty() const
+   {
+      return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+   }
+
+   // returns false when the ring has no room, sets halfFull when this
+   // record pushed the fill level over half of the capacity
+   bool tryPush(pdk::MsgType type, const char *data, size_t size, bool &halfFull)
+   {
+      const size_t need = record_size(size + 1);
+      size_t head = m_head.load(std::memory_order_relaxed);
+      const size_t tail = m_tail.load(std::memory_order_acquire);
+      size_t offset = head & (m_capacity - 1);
+      const size_t contiguous = m_capacity - offset;
+      const size_t total = contiguous < need ? contiguous + need : need;
+      if (m_capacity - (head - tail) < total) {
+         return false;
+      }
+      if (contiguous < need) {
+         RecordHeader *padding = reinterpret_cast<RecordHeader *>(m_data.get() + offset);
+         padding->m_size = static_cast<puint32>(contiguous);
+         padding->m_type = PaddingRecord;
+         head += contiguous;
+         offset = 0;
+      }
+      RecordHeader *header = reinterpret_cast<RecordHeader *>(m_data.get() + offset);
+      header->m_size = static_cast<puint32>(size + 1);
+      header->m_type = static_cast<puint32>(type);
+      char *payload = reinterpret_cast<char *>(header + 1);
+      std::memcpy(payload, data, size);
+      payload[size] = '\n';
+      const size_t filled = head + need - tail;
+      halfFull = filled >= m_capacity / 2 && filled - total < m_capacity / 2;
+      m_head.store(head + need, std::memory_order_release);
+      return true;
+   }
+
+   // appends the pending records to records and returns the new tail, the
+   // records stay valid until commit() hands the space back to the producer
+   size_t collect(std::vector<AsyncLogRecord> &records) const
+   {
+      size_t tail = m_tail.load(std::memory_order_relaxed);
+      const size_t head = m_head.load(std::memory_order_acquire);
+      while (tail != head) {
+         const RecordHeader *header = reinterpret_cast<const RecordHeader *>(
+                  m_data.get() + (tail & (m_capacity - 1)));
+         if (header->m_type == PaddingRecord) {
+            tail += header->m_size;
+            continue;
+         }
+         AsyncLogRecord record;
+         record.m_type = static_cast<pdk::MsgType>(header->m_type);
+         record.m_data = reinterpret_cast<const char *>(header + 1);
+         record.m_size = static_cast<int>(header->m_size);
+         records.push_back(record);
+         tail += record_size(header->m_size);
+      }
+      return tail;
+   }
+
+   void commit(size_t tail)
+   {
+      m_tail.store(tail, std::memory_order_release);
+   }
+
+   std::atomic<bool> m_orphaned{false};
+
+private:
+   alignas(64) std::atomic<size_t> m_head{0};
+   alignas(64) std::atomic<size_t> m_tail{0};
+   const size_t m_capacity;
+   std::unique_ptr<char[]> m_data;
+};
+
+// the ring of a thread outlives the thread until the writer has drained it
+struct ThreadRing
+{
+   ~ThreadRing();
+
+   std::shared_ptr<LogRing> m_ring;
+};
+
+thread_local ThreadRing sg_threadRing;
+// messages of the writer thread itself, e.g. from a custom sink, are never queued
+thread_local bool sg_isWriterThread = false;
+
+#ifdef PDK_OS_UNIX
+
+bool write_vectors(int fd, struct iovec *vectors, int count)
+{
+   while (count > 0) {
+      ssize_t written;
+      PDK_EINTR_LOOP(written, ::writev(fd, vectors, std::min(count, MaxIoVectors)));
+      if (written < 0) {
+         return false;
+      }
+      while (count > 0 && static_cast<size_t>(written) >= vectors->iov_len) {
+         written -= vectors->iov_len;
+         ++vectors;
+         --count;
+      }
+      if (count > 0) {
+         vectors->iov_base = static_cast<char *>(vectors->iov_base) + written;
+         vectors->iov_len -= written;
+      }
+   }
+   return true;
+}
+
+#endif
+
+class AsyncLogger
+{
+public:
+   ~AsyncLogger()
+   {
+      disable();
+   }
+
+   bool enable(const AsyncLoggingOptions &options);
+   void disable();
+   bool push(pdk::MsgType type, const String &message);
+   void flush();
+   void releaseThreadRing(const std::shared_ptr<LogRing> &ring);
+   int getRingCount();
+
+   bool isEnabled() const
+   {
+      return m_enabled.load(std::memory_order_acquire);
+   }
+
+   puint64 getDroppedCount() const
+   {
+      return m_dropped.load(std::memory_order_relaxed);
+   }
+
+private:
+   LogRing *getThreadRing();
+   void requestWakeup();
+   void run();
+   void drain();
+   void writeRecords(const AsyncLogRecord *records, int count);
+   bool openLogFile();
+   void rotateLogFile();
+   void closeLogFile();
+
+private:
+   std::atomic<bool> m_enabled{false};
+   std::atomic<int> m_activeProducers{0};
+   std::atomic<puint64> m_dropped{0};
+
+   AsyncLoggingOptions m_options;
+   std::string m_fileName;
+   int m_fd = -1;
+   pdk::pint64 m_fileSize = 0;
+
+   // guards enable() and disable()
+   std::mutex m_controlMutex;
+   std::thread m_writer;
+
+   std::mutex m_ringsMutex;
+   std::vector<std::shared_ptr<LogRing>> m_rings;
+
+   std::mutex m_wakeupMutex;
+   std::condition_variable m_wakeup;
+   std::condition_variable m_spaceFreed;
+   std::condition_variable m_flushed;
+   bool m_wakeupRequested = false;
+   bool m_stopRequested = false;
+   puint64 m_flushRequested = 0;
+   puint64 m_flushDone = 0;
+
+   // held while records are written to the sink
+   std::mutex m_sinkMutex;
+   std::vector<std::shared_ptr<LogRing>> m_drainRings;
+   std::vector<size_t> m_drainTails;
+   std::vector<AsyncLogRecord> m_drainRecords;
+#ifdef PDK_OS_UNIX
+   std::vector<struct iovec> m_vectors;
+#endif
+};
+
+PDK_GLOBAL_STATIC(AsyncLogger, sg_asyncLogger);
+
+ThreadRing::~ThreadRing()
+{
+   if (m_ring && sg_asyncLogger.exists()) {
+      sg_asyncLogger()->releaseThreadRing(m_ring);
+   }
+}
+
+bool AsyncLogger::enable(const AsyncLoggingOptions &options)
+{
+   std::lock_guard<std::mutex> controlLocker(m_controlMutex);
+   if (isEnabled()) {
+      return false;
+   }
+   m_options = options;
+   size_t bufferSize = MinBufferSize;
+   while (bufferSize < static_cast<size_t>(options.m_bufferSize)) {
+      bufferSize <<= 1;
+   }
+   m_options.m_bufferSize = static_cast<int>(bufferSize);
+   m_options.m_flushInterval = std::max(options.m_flushInterval, 1);
+   m_fileName = options.m_fileName ? options.m_fileName : "";
+   m_options.m_fileName = nullptr;
+   if (!m_options.m_sink && !m_fileName.empty() && !openLogFile()) {
+      return false;
+   }
+   m_stopRequested = false;
+   m_writer = std::thread(&AsyncLogger::run, this);
+   m_enabled.store(true, std::memory_order_release);
+   return true;
+}
+
+void AsyncLogger::disable()
+{
+   std::lock_guard<std::mutex> controlLocker(m_controlMutex);
+   if (!isEnabled()) {
+      return;
+   }
+   m_enabled.store(false);
+   // producers that saw the flag set finish their push before the writer
+   // takes its last pass
+   while (m_activeProducers.load() != 0) {
+      std::this_thread::yield();
+   }
+   {
+      std::lock_guard<std::mutex> locker(m_wakeupMutex);
+      m_stopRequested = true;
+   }
+   m_wakeup.notify_one();
+   m_writer.join();
+   closeLogFile();
+   // the last pass drained every ring, those of finished threads can go
+   std::lock_guard<std::mutex> locker(m_ringsMutex);
+   m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                                [](const std::shared_ptr<LogRing> &ring) {
+      return ring->m_orphaned.load(std::memory_order_acquire);
+   }), m_rings.end());
+}
+
+// called when a logging thread exits, a ring with nothing left to write is
+// freed right away, the writer drops the others once they are drained
+void AsyncLogger::releaseThreadRing(const std::shared_ptr<LogRing> &ring)
+{
+   std::lock_guard<std::mutex> locker(m_ringsMutex);
+   ring->m_orphaned.store(true, std::memory_order_release);
+   if (ring->isEmpty()) {
+      m_rings.erase(std::remove(m_rings.begin(), m_rings.end(), ring), m_rings.end());
+   }
+}
+
+int AsyncLogger::getRingCount()
+{
+   std::lock_guard<std::mutex> locker(m_ringsMutex);
+   return static_cast<int>(m_rings.size());
+}
+
+LogRing *AsyncLogger::getThreadRing()
+{
+   LogRing *ring = sg_threadRing.m_ring.get();
+   if (PDK_LIKELY(ring)) {
+      return ring;
+   }
+   sg_threadRing.m_ring = std::make_shared<LogRing>(static_cast<size_t>(m_options.m_bufferSize));
+   std::lock_guard<std::mutex> locker(m_ringsMutex);
+   m_rings.push_back(sg_threadRing.m_ring);
+   return sg_threadRing.m_ring.get();
+}
+
+void AsyncLogger::requestWakeup()
+{
+   {
+      std::lock_guard<std::mutex> locker(m_wakeupMutex);
+      m_wakeupRequested = true;
+   }
+   m_wakeup.notify_one();
+}
+
+bool AsyncLogger::push(pdk::MsgType type, const String &message)
+{
+   if (sg_isWriterThread) {
+      return false;
+   }
+   m_activeProducers.fetch_add(1);
+   if (!m_enabled.load()) {
+      m_activeProducers.fetch_sub(1);
+      return false;
+   }
+   const ByteArray local = message.toLocal8Bit();
+   LogRing *ring = getThreadRing();
+   const size_t size = static_cast<size_t>(local.size());
+   if (record_size(size + 1) > ring->getMaxRecordSize()) {
+      // too large to queue, keep the order of this thread and write it here
+      while (!ring->isEmpty()) {
+         flush();
+      }
+      ByteArray line = local;
+      line.append('\n');
+      AsyncLogRecord record = { type, line.getConstRawData(), line.size() };
+      {
+         std::lock_guard<std::mutex> sinkLocker(m_sinkMutex);
+         writeRecords(&record, 1);
+      }
+      m_activeProducers.fetch_sub(1);
+      return true;
+   }
+   bool halfFull = false;
+   while (!ring->tryPush(type, local.getConstRawData(), size, halfFull)) {
+      if (m_options.m_overflowPolicy == AsyncLoggingOptions::OverflowPolicy::DropMessage) {
+         m_dropped.fetch_add(1, std::memory_order_relaxed);
+         m_activeProducers.fetch_sub(1);
+         return true;
+      }
+      std::unique_lock<std::mutex> locker(m_wakeupMutex);
+      m_wakeupRequested = true;
+      m_wakeup.notify_one();
+      m_spaceFreed.wait_for(locker, std::chrono::milliseconds(1));
+   }
+   m_activeProducers.fetch_sub(1);
+   if (halfFull) {
+      requestWakeup();
+   }
+   return true;
+}
+
+void AsyncLogger::flush()
+{
+   if (!isEnabled() || sg_isWriterThread) {
+      return;
+   }
+   std::unique_lock<std::mutex> locker(m_wakeupMutex);
+   const puint64 generation = ++m_flushRequested;
+   m_wakeupRequested = true;
+   m_wakeup.notify_one();
+   m_flushed.wait(locker, [this, generation]() {
+      return m_flushDone >= generation || m_stopRequested;
+   });
+}
+
+void AsyncLogger::run()
+{
+   sg_isWriterThread = true;
+   const std::chrono::milliseconds interval(m_options.m_flushInterval);
+   std::unique_lock<std::mutex> locker(m_wakeupMutex);
+   while (true) {
+      m_wakeup.wait_for(locker, interval, [this]() {
+         return m_wakeupRequested || m_stopRequested;
+      });
+      const bool stop = m_stopRequested;
+      const puint64 generation = m_flushRequested;
+      m_wakeupRequested = false;
+      locker.unlock();
+      drain();
+      m_spaceFreed.notify_all();
+      locker.lock();
+      m_flushDone = generation;
+      m_flushed.notify_all();
+      if (stop) {
+         break;
+      }
+   }
+}
+
+void AsyncLogger::drain()
+{
+   m_drainRings.clear();
+   {
+      std::lock_guard<std::mutex> locker(m_ringsMutex);
+      // rings of finished threads go away once everything in them is written,
+      // the flag is read before the emptiness check so no late record is lost
+      m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                                   [](const std::shared_ptr<LogRing> &ring) {
+         return ring->m_orphaned.load(std::memory_order_acquire) && ring->isEmpty();
+      }), m_rings.end());
+      m_drainRings = m_rings;
+   }
+   std::lock_guard<std::mutex> sinkLocker(m_sinkMutex);
+   m_drainRecords.clear();
+   m_drainTails.clear();
+   for (const std::shared_ptr<LogRing> &ring : m_drainRings) {
+      m_drainTails.push_back(ring->collect(m_drainRecords));
+   }
+   if (!m_drainRecords.empty()) {
+      writeRecords(m_drainRecords.data(), static_cast<int>(m_drainRecords.size()));
+   }
+   for (size_t i = 0; i < m_drainRings.size(); ++i) {
+      m_drainRings[i]->commit(m_drainTails[i]);
+   }
+}
+
+void AsyncLogger::writeRecords(const AsyncLogRecord *records, int count)
+{
+   if (m_options.m_sink) {
+      m_options.m_sink(records, count, m_options.m_sinkData);
+      return;
+   }
+#ifdef PDK_OS_UNIX
+   pdk::pint64 size = 0;
+   m_vectors.resize(count);
+   for (int i = 0; i < count; ++i) {
+      m_vectors[i].iov_base = const_cast<char *>(records[i].m_data);
+      m_vectors[i].iov_len = records[i].m_size;
+      size += records[i].m_size;
+   }
+   if (m_fd == -1) {
+      write_vectors(STDERR_FILENO, m_vectors.data(), count);
+      return;
+   }
+   if (m_options.m_maxFileSize > 0 && m_fileSize > 0 && m_fileSize + size > m_options.m_maxFileSize) {
+      rotateLogFile();
+      if (m_fd == -1) {
+         write_vectors(STDERR_FILENO, m_vectors.data(), count);
+         return;
+      }
+   }
+   write_vectors(m_fd, m_vectors.data(), count);
+   m_fileSize += size;
+#else
+   FILE *stream = stderr;
+   for (int i = 0; i < count; ++i) {
+      fwrite(records[i].m_data, 1, records[i].m_size, stream);
+   }
+   fflush(stream);
+#endif
+}
+
+bool AsyncLogger::openLogFile()
+{
+#ifdef PDK_OS_UNIX
+   m_fd = pdk::kernel::safe_open(m_fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+   if (m_fd == -1) {
+      return false;
+   }
+   struct stat info;
+   m_fileSize = ::fstat(m_fd, &info) == 0 ? info.st_size : 0;
+   return true;
+#else
+   return false;
+#endif
+}
+
+// name.log becomes name.log.1, name.log.1 becomes name.log.2 and so on, the
+// oldest backup is overwritten
+void AsyncLogger::rotateLogFile()
+{
+   closeLogFile();
+   if (m_options.m_maxBackupFiles > 0) {
+      for (int i = m_options.m_maxBackupFiles - 1; i > 0; --i) {
+         const std::string from = m_fileName + '.' + std::to_string(i);
+         const std::string to = m_fileName + '.' + std::to_string(i + 1);
+         std::rename(from.c_str(), to.c_str());
+      }
+      std::rename(m_fileName.c_str(), (m_fileName + ".1").c_str());
+   } else {
+      std::remove(m_fileName.c_str());
+   }
+   openLogFile();
+}
+
+void AsyncLogger::closeLogFile()
+{
+#ifdef PDK_OS_UNIX
+   if (m_fd != -1) {
+      pdk::kernel::safe_close(m_fd);
+      m_fd = -1;
+   }
+#endif
+   m_fileSize = 0;
+}
+
+} // anonymous namespace
+
+int async_log_ring_count()
+{
+   AsyncLogger *logger = sg_asyncLogger();
+   return logger ? logger->getRingCount() : 0;
+}
+
+bool async_log_message(pdk::MsgType type, const String &message)
+{
+   AsyncLogger *logger = sg_asyncLogger();
+   if (!logger || !logger->isEnabled()) {
+      return false;
+   }
+   return logger->push(type, message);
+}
+
+} // internal
+
+bool enable_async_logging(const AsyncLoggingOptions &options)
+{
+   internal::AsyncLogger *logger = internal::sg_asyncLogger();
+   return logger && logger->enable(options);
+}
+
+void disable_async_logging()
+{
+   if (internal::AsyncLogger *logger = internal::sg_asyncLogger()) {
+      logger->disable();
+   }
+}
+
+bool is_async_logging_enabled()
+{
+   internal::AsyncLogger *logger = internal::sg_asyncLogger();
+   return logger && logger->isEnabled();
+}
+
+void flush_async_logging()
+{
+   if (internal::AsyncLogger *logger = internal::sg_asyncLogger()) {
+      logger->flush();
+   }
+}
+
+pdk::puint64 get_dropped_log_message_count()
+{
+   internal::AsyncLogger *logger = internal::sg_asyncLogger();
+   return logger ? logger->getDroppedCount() : 0;
+}
+
+} // pdk
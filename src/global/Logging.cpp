@@ -29,6 +29,7 @@
 #include "pdk/base/os/thread/Atomic.h"
 #include "pdk/pal/kernel/Simd.h"
 #include "pdk/global/GlobalStatic.h"
+#include "pdk/global/internal/AsyncLoggingPrivate.h"
 #ifdef PDK_OS_WIN
 #include "pdk/global/Windows.h"
 #endif
@@ -1241,6 +1242,9 @@ void pdk_default_message_handler(pdk::MsgType type, const MessageLogContext &con
       return;
 #endif
    }
+   if (internal::async_log_message(type, logMessage)) {
+      return;
+   }
    fprintf(stderr, "%s\n", logMessage.toLocal8Bit().getConstRawData());
    fflush(stderr);
 }
@@ -1316,6 +1320,8 @@ void pdk_message_fatal(pdk::MsgType, const MessageLogContext &context, const Str
    PDK_UNUSED(context);
    PDK_UNUSED(message);
 #endif
+   // queued messages, the fatal one included, must reach the sink first
+   flush_async_logging();
    std::abort();
 }
 
@@ -55,6 +55,8 @@
 #if defined(PDK_OS_UNIX)
 # if defined(PDK_OS_DARWIN)
 #  include "pdk/kernel/EventDispatcherCf.h"
+# elif defined(PDK_OS_LINUX)
+#  include "pdk/kernel/EventDispatcherEpoll.h"
 # endif
 # include "pdk/kernel/EventDispatcherUnix.h"
 #endif
@@ -92,6 +94,8 @@ extern String retrieve_app_filename();
 
 #if defined(PDK_OS_DARWIN)
 using pdk::kernel::EventDispatcherCoreFoundation;
+#elif defined(PDK_OS_LINUX)
+using pdk::kernel::EventDispatcherEpoll;
 #endif
 
 extern "C" void PDK_CORE_EXPORT startup_hook()
@@ -338,6 +342,8 @@ pdk::HANDLE pdk_application_thread_id = 0;
 uint global_posted_events_count()
 {
    ThreadData *currentThreadData = ThreadData::current();
+   std::lock_guard<std::mutex> locker(currentThreadData->m_postEventList.m_mutex);
+   currentThreadData->drainPostEventIntake();
    return currentThreadData->m_postEventList.size() - currentThreadData->m_postEventList.m_startOffset;
 }
 
@@ -438,6 +444,7 @@ void CoreApplicationPrivate::cleanupThreadData()
       ThreadStorageData::finish(reinterpret_cast<void **>(data));
    }
    std::lock_guard<std::mutex> locker(m_threadData->m_postEventList.m_mutex);
+   m_threadData->drainPostEventIntake();
    for (size_t i = 0; i < m_threadData->m_postEventList.size(); ++i) {
       const PostEvent &pe = m_threadData->m_postEventList.at(i);
       if (pe.m_event) {
@@ -464,6 +471,14 @@ void CoreApplicationPrivate::createEventDispatcher()
    } else {
       sm_eventDispatcher = new EventDispatcherUNIX(apiPtr);
    }
+#  elif defined(PDK_OS_LINUX)
+   if (EventDispatcherEpoll::isPreferred()) {
+      sm_eventDispatcher = new EventDispatcherEpoll(apiPtr);
+   } else {
+      sm_eventDispatcher = new EventDispatcherUNIX(apiPtr);
+   }
+#  else
+   sm_eventDispatcher = new EventDispatcherUNIX(apiPtr);
 #  endif
 #else
 #  error "pdk::kernel::EventDispatcher not yet ported to this platform"
@@ -793,6 +808,24 @@ void replace_percent_n(String *result, int n)
    }
 }
 
+// events that compressEvent() may drop or that need the sorted list go
+// through the locked path of postEvent()
+inline bool can_use_post_event_intake(Event *event, pdk::EventPriority priority)
+{
+   if (priority != pdk::EventPriority::NormalEventPriority) {
+      return false;
+   }
+   switch (event->getType()) {
+   case Event::Type::DeferredDelete:
+   case Event::Type::Quit:
+#ifdef PDK_OS_WIN
+   case Event::Type::Timer:
+#endif
+      return false;
+   default:
+      return true;
+   }
+}
 
 } // anonymous namespace
 
@@ -1043,6 +1076,21 @@ void CoreApplication::postEvent(Object *receiver, Event *event, pdk::EventPriori
       delete event;
       return;
    }
+   if (can_use_post_event_intake(event, priority)) {
+      // nothing to compress or to order, hand the event over without
+      // taking the mutex. if the receiver is moved to another thread in
+      // the meantime the event is passed on when the intake is drained
+      pdk::utils::ScopedPointer<Event> eventDeleter(event);
+      PostEventList::IntakeNode *node = new PostEventList::IntakeNode{nullptr, receiver, event};
+      eventDeleter.take();
+      event->m_posted = true;
+      data->m_postEventList.pushIntake(node);
+      AbstractEventDispatcher* dispatcher = data->m_eventDispatcher.loadAcquire();
+      if (dispatcher) {
+         dispatcher->wakeUp();
+      }
+      return;
+   }
    // lock the post event mutex
    data->m_postEventList.m_mutex.lock();
    // if object has moved to another thread, follow it
@@ -1057,6 +1105,9 @@ void CoreApplication::postEvent(Object *receiver, Event *event, pdk::EventPriori
       data->m_postEventList.m_mutex.lock();
    }
    MutexUnlocker locker(&data->m_postEventList.m_mutex);
+   data->m_postEventList.countLockedPost();
+   // keep the order with the events that went through the intake
+   data->drainPostEventIntake();
    // if this is one of the compressible events, do compression
    if (receiver->getImplPtr()->m_postedEvents
        && sm_self && sm_self->compressEvent(event, receiver, &data->m_postEventList)) {
@@ -1170,6 +1221,7 @@ void CoreApplicationPrivate::sendPostedEvents(Object *receiver, Event::Type even
    }
    ++data->m_postEventList.m_recursion;
    std::unique_lock<std::mutex> locker(data->m_postEventList.m_mutex);
+   data->drainPostEventIntake();
    // by default, we assume that the event dispatcher can go to sleep after
    // processing all events. if any new events are posted while we send
    // events, canWait will be set to false.
@@ -1307,6 +1359,7 @@ void CoreApplicationPrivate::removePostedEvent(Event * event)
    }
    ThreadData *data = ThreadData::current();
    std::lock_guard<std::mutex> locker(data->m_postEventList.m_mutex);
+   data->drainPostEventIntake();
    if (data->m_postEventList.size() == 0) {
 #if defined(PDK_DEBUG)
       debug_stream("CoreApplication::removePostedEvent: Internal error: %p %d is posted",
@@ -1373,6 +1426,7 @@ void CoreApplication::removePostedEvents(Object *receiver, Event::Type eventType
 {
    ThreadData *data = receiver ? receiver->getImplPtr()->m_threadData : ThreadData::current();
    std::unique_lock<std::mutex> locker(data->m_postEventList.m_mutex);
+   data->drainPostEventIntake();
    // the Object destructor calls this function directly.  this can
    // happen while the event loop is in the middle of posting events,
    // and when we get here, we may not have any more posted events
@@ -13,7 +13,9 @@
 //
 // Created by softboy on 2017/12/30.
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <climits>
 
@@ -21,6 +23,7 @@
 #include "pdk/base/os/thread/Atomic.h"
 #include "pdk/pal/kernel/Simd.h"
 #include "pdk/global/Endian.h"
+#include "pdk/global/Random.h"
 #include "pdk/base/lang/String.h"
 #include "pdk/base/lang/StringView.h"
 #include "pdk/base/lang/Character.h"
@@ -59,151 +62,565 @@ PDK_CORE_EXPORT pdk::os::thread::BasicAtomicInt HashFuncSeed = PDK_BASIC_ATOMIC_
 
 namespace
 {
-#if PDK_COMPILER_SUPPORTS_HERE(SSE4_2)
-inline bool hash_fast_crc32()
+
+using namespace pdk::pal::kernel;
+
+void initialize_hash_func_seed()
 {
-   return CPU_HAS_FEATURE(SSE4_2);
+   if (HashFuncSeed.load() == -1) {
+      std::srand(std::time(nullptr));
+      int seed = (std::rand() & INT_MAX);
+      HashFuncSeed.testAndSetRelaxed(-1, seed);
+   }
 }
 
-template <typename Char>
-PDK_FUNCTION_TARGET(SSE4_2) uint crc32(const Char *ptr, size_t len, uint h)
+// wyhash final version 4 (Wang Yi, public domain) up to sg_longHashThreshold
+// bytes, above that eight 64-bit accumulators take a 64 byte stripe per
+// step the way XXH3 does, with a multiply of two 32-bit halves each, which
+// AVX2 does four at a time
+constexpr size_t sg_stripeSize = 64;
+constexpr size_t sg_stripesPerBlock = 16;
+constexpr size_t sg_blockSize = sg_stripeSize * sg_stripesPerBlock;
+constexpr size_t sg_longHashThreshold = sg_blockSize;
+
+// where in the 32 keys the last stripe, the scrambling and the merge start
+constexpr int sg_lastStripeKeys = 16;
+constexpr int sg_mergeKeys = 11;
+constexpr int sg_scrambleKeys = 24;
+
+const puint64 sg_wyPrimes[4] = {
+   PDK_UINT64_C(0x2d358dccaa6c78a5), PDK_UINT64_C(0x8bb84b93962eacc9),
+   PDK_UINT64_C(0x4b33a62ed433d4a3), PDK_UINT64_C(0x4d5a2da51de1aa47)
+};
+
+// splitmix64 output, nothing up the sleeve
+const puint64 sg_hashSecret[32] = {
+   PDK_UINT64_C(0x2cb0f69f4abea221), PDK_UINT64_C(0x9417034723148989), PDK_UINT64_C(0xdd555950609dfe03),
+   PDK_UINT64_C(0xdbafb150deb12800), PDK_UINT64_C(0x7e789b2e6c442cb6), PDK_UINT64_C(0xf41e5636c7e4f8c4),
+   PDK_UINT64_C(0x0959d150f8fba7e4), PDK_UINT64_C(0xa97316f13cdb9eea), PDK_UINT64_C(0x74cd8258f9520068),
+   PDK_UINT64_C(0x55c74a62e116868b), PDK_UINT64_C(0xd2f4c799a2023cbd), PDK_UINT64_C(0xdf98cb79a37b51b9),
+   PDK_UINT64_C(0x396f5885524f3905), PDK_UINT64_C(0xaf1d56386ca3b276), PDK_UINT64_C(0xa9ffbe6b5104e85a),
+   PDK_UINT64_C(0x6bd0c51b9fd533b3), PDK_UINT64_C(0x980ce91c50ab4b56), PDK_UINT64_C(0x28ac395780fe62c5),
+   PDK_UINT64_C(0x768912e3a6bcedc7), PDK_UINT64_C(0x50b3e8c9332c7c88), PDK_UINT64_C(0xce3bbfe520bd47da),
+   PDK_UINT64_C(0xcba6c8e8e0bb7c4f), PDK_UINT64_C(0xbf194db8434a346d), PDK_UINT64_C(0x7d8f2a7b60416d7f),
+   PDK_UINT64_C(0x0849d1f6e0e10a5e), PDK_UINT64_C(0x7654b590d064e22f), PDK_UINT64_C(0x16d1da9507df3af2),
+   PDK_UINT64_C(0xf63aef1089ea30e4), PDK_UINT64_C(0x9ade6673cc6c522b), PDK_UINT64_C(0x4c75bc274e37087c),
+   PDK_UINT64_C(0xd35e12b49f51f27b), PDK_UINT64_C(0x22ddf2ffcee481ea)
+};
+
+const puint64 sg_initialAccumulators[8] = {
+   PDK_UINT64_C(0x00000000c2b2ae3d), PDK_UINT64_C(0x9e3779b185ebca87),
+   PDK_UINT64_C(0xc2b2ae3d27d4eb4f), PDK_UINT64_C(0x165667b19e3779f9),
+   PDK_UINT64_C(0x85ebca77c2b2ae63), PDK_UINT64_C(0x0000000085ebca77),
+   PDK_UINT64_C(0x27d4eb2f165667c5), PDK_UINT64_C(0x000000009e3779b1)
+};
+
+constexpr puint64 sg_accumulatorPrime = PDK_UINT64_C(0x9e3779b1);
+
+inline void multiply128(puint64 *a, puint64 *b) noexcept
 {
-   // The CRC32 instructions from Nehalem calculate a 32-bit CRC32 checksum
-   const uchar *p = reinterpret_cast<const uchar *>(ptr);
-   const uchar *const e = p + (len * sizeof(Char));
-#  ifdef PDK_PROCESSOR_X86_64
-   // The 64-bit instruction still calculates only 32-bit, but without this
-   // variable GCC 4.9 still tries to clear the high bits on every loop
-   pulonglong h2 = h;
-   
-   p += 8;
-   for ( ; p <= e; p += 8)
-      h2 = _mm_crc32_u64(h2, pdk::from_unaligned<plonglong>(p - 8));
-   h = h2;
-   p -= 8;
-   
-   len = e - p;
-   if (len & 4) {
-      h = _mm_crc32_u32(h, from_unaligned<uint>(p));
-      p += 4;
-   }
-#  else
-   p += 4;
-   for ( ; p <= e; p += 4)
-      h = _mm_crc32_u32(h, from_unaligned<uint>(p - 4));
-   p -= 4;
-   len = e - p;
-#  endif
-   if (len & 2) {
-      h = _mm_crc32_u16(h, from_unaligned<ushort>(p));
-      p += 2;
-   }
-   if (sizeof(Char) == 1 && len & 1)
-      h = _mm_crc32_u8(h, *p);
-   return h;
+#if defined(__SIZEOF_INT128__)
+   __extension__ unsigned __int128 product = *a;
+   product *= *b;
+   *a = static_cast<puint64>(product);
+   *b = static_cast<puint64>(product >> 64);
+#elif defined(PDK_CC_MSVC) && defined(PDK_PROCESSOR_X86_64)
+   *a = _umul128(*a, *b, b);
+#else
+   const puint64 lowLow = (*a & 0xffffffff) * (*b & 0xffffffff);
+   const puint64 highLow = (*a >> 32) * (*b & 0xffffffff);
+   const puint64 lowHigh = (*a & 0xffffffff) * (*b >> 32);
+   const puint64 highHigh = (*a >> 32) * (*b >> 32);
+   const puint64 middle = (lowLow >> 32) + (highLow & 0xffffffff) + lowHigh;
+   *a = (middle << 32) | (lowLow & 0xffffffff);
+   *b = highHigh + (highLow >> 32) + (middle >> 32);
+#endif
 }
-#elif defined(__ARM_FEATURE_CRC32)
 
-inline bool has_fast_crc32()
+inline puint64 mix(puint64 a, puint64 b) noexcept
 {
-   return CPU_HAS_FEATURE(CRC32);
+   multiply128(&a, &b);
+   return a ^ b;
 }
 
-template <typename Char>
-PDK_FUNCTION_TARGET(CRC32) uint crc32(const Char *ptr, size_t len, uint h)
+inline puint64 read64(const uchar *p) noexcept
 {
-   // The crc32[whbd] instructions on Aarch64/Aarch32 calculate a 32-bit CRC32 checksum
-   const uchar *p = reinterpret_cast<const uchar *>(ptr);
-   const uchar *const e = p + (len * sizeof(Char));
-   
-#  ifndef __ARM_FEATURE_UNALIGNED
-   if (PDK_UNLIKELY(reinterpret_cast<quintptr>(p) & 7)) {
-      if ((sizeof(Char) == 1) && (reinterpret_cast<pdk::uintptr>(p) & 1) && (e - p > 0)) {
-         h = __crc32b(h, *p);
-         ++p;
+   return from_little_endian<puint64>(p);
+}
+
+inline puint64 read32(const uchar *p) noexcept
+{
+   return from_little_endian<puint32>(p);
+}
+
+inline uint fold(puint64 hash) noexcept
+{
+   return static_cast<uint>(hash ^ (hash >> 32));
+}
+
+puint64 short_hash(const uchar *p, size_t length, puint64 seed) noexcept
+{
+   seed ^= mix(seed ^ sg_wyPrimes[0], sg_wyPrimes[1]);
+   puint64 a;
+   puint64 b;
+   if (PDK_LIKELY(length <= 16)) {
+      if (PDK_LIKELY(length >= 4)) {
+         a = (read32(p) << 32) | read32(p + ((length >> 3) << 2));
+         b = (read32(p + length - 4) << 32) | read32(p + length - 4 - ((length >> 3) << 2));
+      } else if (PDK_LIKELY(length > 0)) {
+         a = (puint64(p[0]) << 16) | (puint64(p[length >> 1]) << 8) | p[length - 1];
+         b = 0;
+      } else {
+         a = b = 0;
       }
-      if ((reinterpret_cast<pdk::uintptr>(p) & 2) && (e >= p + 2)) {
-         h = __crc32h(h, *reinterpret_cast<const uint16_t *>(p));
-         p += 2;
+   } else {
+      size_t i = length;
+      if (PDK_UNLIKELY(i > 48)) {
+         puint64 seed1 = seed;
+         puint64 seed2 = seed;
+         do {
+            seed = mix(read64(p) ^ sg_wyPrimes[1], read64(p + 8) ^ seed);
+            seed1 = mix(read64(p + 16) ^ sg_wyPrimes[2], read64(p + 24) ^ seed1);
+            seed2 = mix(read64(p + 32) ^ sg_wyPrimes[3], read64(p + 40) ^ seed2);
+            p += 48;
+            i -= 48;
+         } while (PDK_LIKELY(i > 48));
+         seed ^= seed1 ^ seed2;
       }
-      if ((reinterpret_cast<pdk::uintptr>(p) & 4) && (e >= p + 4)) {
-         h = __crc32w(h, *reinterpret_cast<const uint32_t *>(p));
-         p += 4;
+      while (PDK_UNLIKELY(i > 16)) {
+         seed = mix(read64(p) ^ sg_wyPrimes[1], read64(p + 8) ^ seed);
+         i -= 16;
+         p += 16;
       }
+      a = read64(p + i - 16);
+      b = read64(p + i - 8);
    }
-#  endif
-   
-   for ( ; p + 8 <= e; p += 8)
-      h = __crc32d(h, *reinterpret_cast<const uint64_t *>(p));
-   
-   len = e - p;
-   if (len == 0)
-      return h;
-   if (len & 4) {
-      h = __crc32w(h, *reinterpret_cast<const uint32_t *>(p));
-      p += 4;
+   a ^= sg_wyPrimes[1];
+   b ^= seed;
+   multiply128(&a, &b);
+   return mix(a ^ sg_wyPrimes[0] ^ length, b ^ sg_wyPrimes[1]);
+}
+
+void init_long_hash_keys(puint64 *keys, puint64 seed) noexcept
+{
+   for (int i = 0; i < 32; i += 2) {
+      keys[i] = sg_hashSecret[i] + seed;
+      keys[i + 1] = sg_hashSecret[i + 1] - seed;
+   }
+}
+
+#if defined(__SSE2__) && defined(PDK_COMPILER_SUPPORTS_SSE2)
+void accumulate_sse2(puint64 *accumulators, const uchar *p, size_t stripes, const puint64 *keys) noexcept
+{
+   __m128i values[4];
+   for (int i = 0; i < 4; ++i) {
+      values[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(accumulators + i * 2));
    }
-   if (len & 2) {
-      h = __crc32h(h, *reinterpret_cast<const uint16_t *>(p));
-      p += 2;
+   for (size_t s = 0; s < stripes; ++s) {
+      const uchar *stripe = p + s * sg_stripeSize;
+      for (int i = 0; i < 4; ++i) {
+         const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(stripe + i * 16));
+         const __m128i keyed = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + s + i * 2)));
+         const __m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+         values[i] = _mm_add_epi64(values[i], _mm_add_epi64(product, _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2))));
+      }
+   }
+   for (int i = 0; i < 4; ++i) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(accumulators + i * 2), values[i]);
    }
-   if (sizeof(Char) == 1 && len & 1)
-      h = __crc32b(h, *p);
-   return h;
 }
 #else
-inline bool has_fast_crc32()
+void accumulate_scalar(puint64 *accumulators, const uchar *p, size_t stripes, const puint64 *keys) noexcept
+{
+   // locals, the compiler can not tell the accumulators from the keys
+   puint64 values[8];
+   std::memcpy(values, accumulators, sizeof(values));
+   for (size_t s = 0; s < stripes; ++s) {
+      const uchar *stripe = p + s * sg_stripeSize;
+      const puint64 *key = keys + s;
+      for (int i = 0; i < 8; i += 2) {
+         // each word of a pair is added to the other's accumulator
+         const puint64 data0 = read64(stripe + i * 8);
+         const puint64 data1 = read64(stripe + i * 8 + 8);
+         const puint64 keyed0 = data0 ^ key[i];
+         const puint64 keyed1 = data1 ^ key[i + 1];
+         values[i] += data1 + (keyed0 & 0xffffffff) * (keyed0 >> 32);
+         values[i + 1] += data0 + (keyed1 & 0xffffffff) * (keyed1 >> 32);
+      }
+   }
+   std::memcpy(accumulators, values, sizeof(values));
+}
+#endif
+
+void scramble_scalar(puint64 *accumulators, const puint64 *keys) noexcept
 {
-   return false;
+   for (int i = 0; i < 8; ++i) {
+      puint64 value = accumulators[i];
+      value ^= value >> 47;
+      value ^= keys[i];
+      accumulators[i] = value * sg_accumulatorPrime;
+   }
 }
 
-uint crc32(...)
+#if defined(PDK_PROCESSOR_X86) && PDK_COMPILER_SUPPORTS(AVX2)
+#  define PDK_HAVE_AVX2_HASH_FUNCS
+
+PDK_FUNCTION_TARGET(AVX2)
+void accumulate_avx2(puint64 *accumulators, const uchar *p, size_t stripes, const puint64 *keys) noexcept
 {
-   PDK_UNREACHABLE();
-   return 0;   
+   __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i *>(accumulators));
+   __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i *>(accumulators + 4));
+   for (size_t s = 0; s < stripes; ++s) {
+      const uchar *stripe = p + s * sg_stripeSize;
+      const __m256i data0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(stripe));
+      const __m256i data1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(stripe + 32));
+      const __m256i keyed0 = _mm256_xor_si256(data0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + s)));
+      const __m256i keyed1 = _mm256_xor_si256(data1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + s + 4)));
+      // low half of every word times its high half, and the data with the
+      // words of each pair swapped
+      const __m256i product0 = _mm256_mul_epu32(keyed0, _mm256_srli_epi64(keyed0, 32));
+      const __m256i product1 = _mm256_mul_epu32(keyed1, _mm256_srli_epi64(keyed1, 32));
+      low = _mm256_add_epi64(low, _mm256_add_epi64(product0, _mm256_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2))));
+      high = _mm256_add_epi64(high, _mm256_add_epi64(product1, _mm256_shuffle_epi32(data1, _MM_SHUFFLE(1, 0, 3, 2))));
+   }
+   _mm256_store_si256(reinterpret_cast<__m256i *>(accumulators), low);
+   _mm256_store_si256(reinterpret_cast<__m256i *>(accumulators + 4), high);
 }
 
+PDK_FUNCTION_TARGET(AVX2)
+void scramble_avx2(puint64 *accumulators, const puint64 *keys) noexcept
+{
+   const __m256i prime = _mm256_set1_epi32(static_cast<int>(sg_accumulatorPrime));
+   for (int i = 0; i < 8; i += 4) {
+      __m256i value = _mm256_load_si256(reinterpret_cast<const __m256i *>(accumulators + i));
+      value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+      value = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i)));
+      // 64 by 32 bit multiply out of two 32 by 32 bit ones
+      const __m256i productLow = _mm256_mul_epu32(value, prime);
+      const __m256i productHigh = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+      value = _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32));
+      _mm256_store_si256(reinterpret_cast<__m256i *>(accumulators + i), value);
+   }
+}
 #endif
-void initialize_hash_func_seed()
+
+// accumulators must be 32 byte aligned
+inline void accumulate(puint64 *accumulators, const uchar *p, size_t stripes, const puint64 *keys) noexcept
 {
-   if (HashFuncSeed.load() == -1) {
-      std::srand(std::time(nullptr));
-      int seed = (std::rand() & INT_MAX);
-      HashFuncSeed.testAndSetRelaxed(-1, seed);
+#ifdef PDK_HAVE_AVX2_HASH_FUNCS
+   if (CPU_HAS_FEATURE(AVX2)) {
+      accumulate_avx2(accumulators, p, stripes, keys);
+      return;
+   }
+#endif
+#if defined(__SSE2__) && defined(PDK_COMPILER_SUPPORTS_SSE2)
+   accumulate_sse2(accumulators, p, stripes, keys);
+#else
+   accumulate_scalar(accumulators, p, stripes, keys);
+#endif
+}
+
+inline void scramble(puint64 *accumulators, const puint64 *keys) noexcept
+{
+#ifdef PDK_HAVE_AVX2_HASH_FUNCS
+   if (CPU_HAS_FEATURE(AVX2)) {
+      scramble_avx2(accumulators, keys);
+      return;
    }
+#endif
+   scramble_scalar(accumulators, keys);
 }
 
-inline uint do_hash(const uchar *p, int length, uint seed) noexcept
+inline void accumulate_block(puint64 *accumulators, const uchar *block, const puint64 *keys) noexcept
 {
-   uint h = seed;
-   if (seed && has_fast_crc32()) {
-      return crc32(p, static_cast<uint>(length), h);
+   accumulate(accumulators, block, sg_stripesPerBlock, keys);
+   scramble(accumulators, keys + sg_scrambleKeys);
+}
+
+// the data after the last whole block, 1 to sg_blockSize bytes, and the
+// 64 bytes that end the input
+puint64 finish_long_hash(puint64 *accumulators, const uchar *rest, size_t restSize,
+                         const uchar *lastStripe, puint64 length, const puint64 *keys) noexcept
+{
+   accumulate(accumulators, rest, (restSize - 1) / sg_stripeSize, keys);
+   accumulate(accumulators, lastStripe, 1, keys + sg_lastStripeKeys);
+   puint64 hash = length * sg_wyPrimes[1];
+   for (int i = 0; i < 4; ++i) {
+      hash += mix(accumulators[2 * i] ^ keys[sg_mergeKeys + 2 * i],
+                  accumulators[2 * i + 1] ^ keys[sg_mergeKeys + 2 * i + 1]);
    }
-   for (int i = 0; i < length; ++i) {
-      h = 31 * h + p[i];
+   hash ^= hash >> 37;
+   hash *= PDK_UINT64_C(0x165667919e3779f9);
+   return hash ^ (hash >> 32);
+}
+
+puint64 long_hash(const uchar *p, size_t length, puint64 seed) noexcept
+{
+   puint64 keys[32];
+   init_long_hash_keys(keys, seed);
+   alignas(32) puint64 accumulators[8];
+   std::memcpy(accumulators, sg_initialAccumulators, sizeof(accumulators));
+   // a block is only taken whole when more data follows it, the way
+   // IncrementalHash sees it
+   const size_t blocks = (length - 1) / sg_blockSize;
+   for (size_t i = 0; i < blocks; ++i) {
+      accumulate_block(accumulators, p + i * sg_blockSize, keys);
    }
-   return h;
+   return finish_long_hash(accumulators, p + blocks * sg_blockSize, length - blocks * sg_blockSize,
+                           p + length - sg_stripeSize, length, keys);
+}
+
+inline puint64 rotate_left(puint64 value, int shift) noexcept
+{
+   return (value << shift) | (value >> (64 - shift));
 }
 
-inline uint do_hash(const Character *p, int length, uint seed) noexcept
+inline void sip_round(puint64 &v0, puint64 &v1, puint64 &v2, puint64 &v3) noexcept
 {
-   uint h = seed;
+   v0 += v1;
+   v1 = rotate_left(v1, 13);
+   v1 ^= v0;
+   v0 = rotate_left(v0, 32);
+   v2 += v3;
+   v3 = rotate_left(v3, 16);
+   v3 ^= v2;
+   v0 += v3;
+   v3 = rotate_left(v3, 21);
+   v3 ^= v0;
+   v2 += v1;
+   v1 = rotate_left(v1, 17);
+   v1 ^= v2;
+   v2 = rotate_left(v2, 32);
+}
+
+inline uint do_hash(const uchar *p, size_t length, uint seed) noexcept
+{
+   return fold(hash_bytes64(p, length, seed));
+}
+
+inline uint do_hash(const Character *p, size_t length, uint seed) noexcept
+{
+   return fold(hash_bytes64(p, length * sizeof(Character), seed));
+}
+
+inline uint do_secure_hash(const void *p, size_t length, uint seed) noexcept
+{
+   SipHashKey key = retrieve_global_siphash_key();
+   key.m_k0 ^= seed;
+   return fold(siphash(p, length, key));
+}
+
+// SipHash-2-4 fed 8 byte words at a time, so input that is not in one
+// piece of memory hashes the same as siphash() of all of it
+class SipHashState
+{
+public:
+   explicit SipHashState(const SipHashKey &key) noexcept
+      : m_v0(key.m_k0 ^ PDK_UINT64_C(0x736f6d6570736575)),
+        m_v1(key.m_k1 ^ PDK_UINT64_C(0x646f72616e646f6d)),
+        m_v2(key.m_k0 ^ PDK_UINT64_C(0x6c7967656e657261)),
+        m_v3(key.m_k1 ^ PDK_UINT64_C(0x7465646279746573))
+   {}
    
-   if (seed && has_fast_crc32()) {
-      return crc32(p, static_cast<uint>(length), h);
+   void compress(const uchar *p, size_t words) noexcept
+   {
+      for (const uchar *end = p + words * 8; p != end; p += 8) {
+         const puint64 message = read64(p);
+         m_v3 ^= message;
+         sip_round(m_v0, m_v1, m_v2, m_v3);
+         sip_round(m_v0, m_v1, m_v2, m_v3);
+         m_v0 ^= message;
+      }
    }
    
-   for (size_t i = 0; i < static_cast<size_t>(length); ++i) {
-      h = 31 * h + p[i].unicode();
+   // rest holds the last length % 8 bytes
+   puint64 finish(const uchar *rest, size_t length) noexcept
+   {
+      puint64 last = puint64(length) << 56;
+      for (size_t i = 0; i < (length & 7); ++i) {
+         last |= puint64(rest[i]) << (8 * i);
+      }
+      m_v3 ^= last;
+      sip_round(m_v0, m_v1, m_v2, m_v3);
+      sip_round(m_v0, m_v1, m_v2, m_v3);
+      m_v0 ^= last;
+      m_v2 ^= 0xff;
+      for (int i = 0; i < 4; ++i) {
+         sip_round(m_v0, m_v1, m_v2, m_v3);
+      }
+      return m_v0 ^ m_v1 ^ m_v2 ^ m_v3;
    }
-   return h;
+   
+private:
+   puint64 m_v0;
+   puint64 m_v1;
+   puint64 m_v2;
+   puint64 m_v3;
+};
+
+// Latin-1 keys hash as the UTF-16 a String of them holds, widened on the
+// stack a chunk at a time
+constexpr int sg_latin1Chunk = 256;
+
+inline int widen_latin1(const uchar *data, int count, char16_t *buffer) noexcept
+{
+   for (int i = 0; i < count; ++i) {
+      buffer[i] = data[i];
+   }
+   return count;
+}
+
+uint do_latin1_hash(Latin1String key, uint seed) noexcept
+{
+   const uchar *data = reinterpret_cast<const uchar *>(key.getRawData());
+   const int size = key.size();
+   char16_t buffer[sg_latin1Chunk];
+   if (size <= sg_latin1Chunk) {
+      widen_latin1(data, size, buffer);
+      return fold(hash_bytes64(buffer, size_t(size) * sizeof(char16_t), seed));
+   }
+   IncrementalHash hash(seed);
+   for (int done = 0; done < size; done += sg_latin1Chunk) {
+      const int count = widen_latin1(data + done, std::min(sg_latin1Chunk, size - done), buffer);
+      hash.addData(buffer, size_t(count) * sizeof(char16_t));
+   }
+   return fold(hash.result());
+}
+
+uint do_latin1_secure_hash(Latin1String key, uint seed) noexcept
+{
+   SipHashKey sipKey = retrieve_global_siphash_key();
+   sipKey.m_k0 ^= seed;
+   SipHashState state(sipKey);
+   const uchar *data = reinterpret_cast<const uchar *>(key.getRawData());
+   const int size = key.size();
+   char16_t buffer[sg_latin1Chunk];
+   // a whole chunk is a whole number of words, only the last one has a tail
+   int done = 0;
+   for (; size - done > sg_latin1Chunk; done += sg_latin1Chunk) {
+      widen_latin1(data + done, sg_latin1Chunk, buffer);
+      state.compress(reinterpret_cast<const uchar *>(buffer), sg_latin1Chunk * sizeof(char16_t) / 8);
+   }
+   const size_t restBytes = size_t(widen_latin1(data + done, size - done, buffer)) * sizeof(char16_t);
+   const uchar *rest = reinterpret_cast<const uchar *>(buffer);
+   state.compress(rest, restBytes / 8);
+   return fold(state.finish(rest + (restBytes & ~size_t(7)), size_t(size) * sizeof(char16_t)));
 }
 
 }
 
+puint64 hash_bytes64(const void *p, size_t length, puint64 seed) noexcept
+{
+   const uchar *bytes = static_cast<const uchar *>(p);
+   if (length <= sg_longHashThreshold) {
+      return short_hash(bytes, length, seed);
+   }
+   return long_hash(bytes, length, seed);
+}
+
+puint64 siphash(const void *p, size_t length, const SipHashKey &key) noexcept
+{
+   const uchar *bytes = static_cast<const uchar *>(p);
+   SipHashState state(key);
+   state.compress(bytes, length / 8);
+   return state.finish(bytes + (length & ~size_t(7)), length);
+}
+
+const SipHashKey &retrieve_global_siphash_key() noexcept
+{
+   static const SipHashKey key = {
+      RandomGenerator64::system()->generate(),
+      RandomGenerator64::system()->generate()
+   };
+   return key;
+}
+
+IncrementalHash::IncrementalHash(puint64 seed) noexcept
+   : m_seed(seed)
+{
+   init_long_hash_keys(m_keys, seed);
+   reset();
+}
+
+void IncrementalHash::reset() noexcept
+{
+   std::memcpy(m_accumulators, sg_initialAccumulators, sizeof(m_accumulators));
+   m_length = 0;
+   m_bufferSize = 0;
+}
+
+void IncrementalHash::consumeBlock(const uchar *block) noexcept
+{
+   accumulate_block(m_accumulators, block, m_keys);
+   std::memcpy(m_lastStripe, block + sg_blockSize - sg_stripeSize, sg_stripeSize);
+}
+
+void IncrementalHash::addData(const void *data, size_t length) noexcept
+{
+   if (!length) {
+      return;
+   }
+   const uchar *p = static_cast<const uchar *>(data);
+   m_length += length;
+   // a full buffer waits until it is known not to be the end
+   if (m_bufferSize) {
+      if (m_bufferSize == sg_blockSize) {
+         consumeBlock(m_buffer);
+         m_bufferSize = 0;
+      } else {
+         const size_t count = std::min(length, sg_blockSize - m_bufferSize);
+         std::memcpy(m_buffer + m_bufferSize, p, count);
+         m_bufferSize += count;
+         p += count;
+         length -= count;
+         if (!length) {
+            return;
+         }
+         consumeBlock(m_buffer);
+         m_bufferSize = 0;
+      }
+   }
+   while (length > sg_blockSize) {
+      consumeBlock(p);
+      p += sg_blockSize;
+      length -= sg_blockSize;
+   }
+   std::memcpy(m_buffer, p, length);
+   m_bufferSize = length;
+}
+
+void IncrementalHash::addData(const ByteArray &data) noexcept
+{
+   addData(data.getConstRawData(), static_cast<size_t>(data.size()));
+}
+
+void IncrementalHash::addData(StringView data) noexcept
+{
+   addData(data.data(), static_cast<size_t>(data.size()) * sizeof(Character));
+}
+
+puint64 IncrementalHash::result() const noexcept
+{
+   if (m_length <= sg_longHashThreshold) {
+      return short_hash(m_buffer, static_cast<size_t>(m_length), m_seed);
+   }
+   alignas(32) puint64 accumulators[8];
+   std::memcpy(accumulators, m_accumulators, sizeof(accumulators));
+   uchar lastStripe[sg_stripeSize];
+   const uchar *last = m_buffer + m_bufferSize - sg_stripeSize;
+   if (m_bufferSize < sg_stripeSize) {
+      // the end of the previous block and what came after it
+      const size_t previous = sg_stripeSize - m_bufferSize;
+      std::memcpy(lastStripe, m_lastStripe + sg_stripeSize - previous, previous);
+      std::memcpy(lastStripe + previous, m_buffer, m_bufferSize);
+      last = lastStripe;
+   }
+   return finish_long_hash(accumulators, m_buffer, m_bufferSize, last, m_length, m_keys);
+}
+
 uint hash_bits(const void *p, size_t length, uint seed) noexcept
 {
-   return do_hash(static_cast<const uchar *>(p), static_cast<int>(length), seed);
+   return do_hash(static_cast<const uchar *>(p), length, seed);
 }
 
 int retrieve_global_hash_seed()
@@ -234,7 +651,7 @@ constexpr uint pdk_hash(double key, uint seed) noexcept
 
 #ifndef PDK_OS_DARWIN
 
-uint pdk_hash(long double key, uint seed) noexcept
+constexpr uint pdk_hash(long double key, uint seed) noexcept
 {
    return key != 0.0L ? do_hash(reinterpret_cast<const uchar *>(&key), sizeof(key), seed) : seed;
 }
@@ -280,7 +697,27 @@ uint pdk_hash(const BitArray &bitArray, uint seed) noexcept
 
 uint pdk_hash(Latin1String key, uint seed) noexcept
 {
-   return do_hash(reinterpret_cast<const uchar *>(key.getRawData()), size_t(key.size()), seed);
+   return do_latin1_hash(key, seed);
+}
+
+uint pdk_secure_hash(const ByteArray &key, uint seed) noexcept
+{
+   return do_secure_hash(key.getConstRawData(), size_t(key.size()), seed);
+}
+
+uint pdk_secure_hash(const String &key, uint seed) noexcept
+{
+   return do_secure_hash(key.unicode(), size_t(key.size()) * sizeof(Character), seed);
+}
+
+uint pdk_secure_hash(StringView key, uint seed) noexcept
+{
+   return do_secure_hash(key.data(), size_t(key.size()) * sizeof(Character), seed);
+}
+
+uint pdk_secure_hash(Latin1String key, uint seed) noexcept
+{
+   return do_latin1_secure_hash(key, seed);
 }
 
 /*!
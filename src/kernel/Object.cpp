@@ -80,7 +80,7 @@ ObjectPrivate::~ObjectPrivate()
          //warning_stream("Object::~Object: Timers cannot be stopped from another thread");
       }
    }
-   if (m_postedEvents) {
+   if (m_postedEvents || m_threadData->m_postEventList.hasPendingIntake()) {
       CoreApplication::removePostedEvents(m_apiPtr, Event::Type::None);
    }
    m_threadData->deref();
@@ -410,6 +410,7 @@ void ObjectPrivate::setThreadDataHelper(ThreadData *currentData, ThreadData *tar
 {
    PDK_Q(Object);
    // move posted events
+   currentData->drainPostEventIntake();
    int eventsMoved = 0;
    for (size_t i = 0; i < currentData->m_postEventList.size(); ++i) {
       const PostEvent &pe = currentData->m_postEventList.at(i);
@@ -182,7 +182,7 @@ EventDispatcherCoreFoundation::EventDispatcherCoreFoundation(Object *parent)
 EventDispatcherCoreFoundation::~EventDispatcherCoreFoundation()
 {
    invalidateTimer();
-   pdk::stdext::delete_all(m_timerInfoList);
+   m_timerInfoList.clear();
    m_cfSocketNotifier.removeSocketNotifiers();
 }
 
@@ -0,0 +1,282 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/global/PlatformDefs.h"
+#include "pdk/kernel/CoreApplication.h"
+#include "pdk/kernel/SocketNotifier.h"
+#include "pdk/kernel/EventDispatcherEpoll.h"
+#include "pdk/kernel/internal/CoreUnixPrivate.h"
+#include "pdk/global/Logging.h"
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <errno.h>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace pdk {
+namespace kernel {
+
+using internal::EventDispatcherEpollPrivate;
+
+namespace {
+
+constexpr int EPOLL_INITIAL_EVENT_COUNT = 64;
+
+pdk::puint32 poll_to_epoll_events(short events)
+{
+   pdk::puint32 result = 0;
+   if (events & POLLIN) {
+      result |= EPOLLIN;
+   }
+   if (events & POLLOUT) {
+      result |= EPOLLOUT;
+   }
+   if (events & POLLPRI) {
+      result |= EPOLLPRI;
+   }
+   return result;
+}
+
+short epoll_to_poll_events(pdk::puint32 events)
+{
+   short result = 0;
+   if (events & EPOLLIN) {
+      result |= POLLIN;
+   }
+   if (events & EPOLLOUT) {
+      result |= POLLOUT;
+   }
+   if (events & EPOLLPRI) {
+      result |= POLLPRI;
+   }
+   if (events & EPOLLERR) {
+      result |= POLLERR;
+   }
+   if (events & EPOLLHUP) {
+      result |= POLLHUP;
+   }
+   return result;
+}
+
+bool epoll_register(int epollFd, int op, int fd, pdk::puint32 events)
+{
+   epoll_event event;
+   event.events = events;
+   event.data.fd = fd;
+   return ::epoll_ctl(epollFd, op, fd, &event) == 0;
+}
+
+} // anonymous namespace
+
+namespace internal {
+
+EventDispatcherEpollPrivate::EventDispatcherEpollPrivate()
+   : m_epollFd(-1),
+     m_timerFd(-1),
+     m_armedDeadline({0, 0}),
+     m_epollEvents(EPOLL_INITIAL_EVENT_COUNT)
+{
+   m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+   if (m_epollFd == -1) {
+      // processEvents() falls back to poll(2)
+      perror("EventDispatcherEpollPrivate: Unable to create epoll instance");
+      return;
+   }
+   if (!epoll_register(m_epollFd, EPOLL_CTL_ADD, m_threadPipe.m_fds[0], EPOLLIN)) {
+      perror("EventDispatcherEpollPrivate: Unable to watch the thread pipe");
+      safe_close(m_epollFd);
+      m_epollFd = -1;
+      return;
+   }
+   bool ok = false;
+   int useTimerFd = pdk::env_var_intval("PDK_EVENT_DISPATCHER_TIMERFD", &ok);
+   if (ok && useTimerFd > 0) {
+      m_timerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+      if (m_timerFd != -1 && !epoll_register(m_epollFd, EPOLL_CTL_ADD, m_timerFd, EPOLLIN)) {
+         safe_close(m_timerFd);
+         m_timerFd = -1;
+      }
+   }
+}
+
+EventDispatcherEpollPrivate::~EventDispatcherEpollPrivate()
+{
+   if (m_timerFd != -1) {
+      safe_close(m_timerFd);
+   }
+   if (m_epollFd != -1) {
+      safe_close(m_epollFd);
+   }
+}
+
+void EventDispatcherEpollPrivate::updateRegistration(int fd, bool wasRegistered)
+{
+   auto iter = m_socketNotifiers.find(fd);
+   if (iter == m_socketNotifiers.end()) {
+      if (wasRegistered && !epoll_register(m_epollFd, EPOLL_CTL_DEL, fd, 0)) {
+         // the fd may already be closed, which removes it from the set
+         if (errno != EBADF && errno != ENOENT) {
+            perror("EventDispatcherEpoll: Unable to remove socket from epoll set");
+         }
+      }
+      return;
+   }
+   const pdk::puint32 events = poll_to_epoll_events(iter->second.events());
+   int op = wasRegistered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+   if (epoll_register(m_epollFd, op, fd, events)) {
+      return;
+   }
+   // the kernel view can differ from ours when a descriptor was closed and
+   // its number reused before the notifier was disabled, retry the other way
+   if (errno == ENOENT && op == EPOLL_CTL_MOD) {
+      op = EPOLL_CTL_ADD;
+   } else if (errno == EEXIST && op == EPOLL_CTL_ADD) {
+      op = EPOLL_CTL_MOD;
+   } else {
+      warning_stream("EventDispatcherEpoll: Unable to watch socket %d: %s", fd, std::strerror(errno));
+      return;
+   }
+   if (!epoll_register(m_epollFd, op, fd, events)) {
+      warning_stream("EventDispatcherEpoll: Unable to watch socket %d: %s", fd, std::strerror(errno));
+   }
+}
+
+int EventDispatcherEpollPrivate::waitTimeout(const timespec *ts)
+{
+   if (!ts) {
+      return -1;
+   }
+   if (ts->tv_sec == 0 && ts->tv_nsec == 0) {
+      return 0;
+   }
+   if (m_timerFd == -1) {
+      // timerWait() already rounded the wait to milliseconds
+      pdk::pint64 msecs = pdk::pint64(ts->tv_sec) * 1000 + (ts->tv_nsec + 999999) / 1000000;
+      return msecs > std::numeric_limits<int>::max() ? std::numeric_limits<int>::max() : int(msecs);
+   }
+   // only touch the timer when the nearest deadline moved, m_currentTime
+   // was just refreshed by timerWait() from the monotonic clock
+   timespec deadline = m_timerList.m_currentTime + *ts;
+   if (deadline != m_armedDeadline) {
+      itimerspec spec;
+      spec.it_interval.tv_sec = 0;
+      spec.it_interval.tv_nsec = 0;
+      spec.it_value = deadline;
+      if (::timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) == -1) {
+         perror("EventDispatcherEpoll: Unable to arm timerfd");
+         m_armedDeadline = {0, 0};
+         return 0;
+      }
+      m_armedDeadline = deadline;
+   }
+   return -1;
+}
+
+void EventDispatcherEpollPrivate::consumeTimerFd()
+{
+   pdk::puint64 expirations;
+   while (::read(m_timerFd, &expirations, sizeof(expirations)) > 0) {}
+   m_armedDeadline = {0, 0};
+}
+
+} // internal
+
+EventDispatcherEpoll::EventDispatcherEpoll(Object *parent)
+   : EventDispatcherUNIX(*new EventDispatcherEpollPrivate, parent)
+{}
+
+EventDispatcherEpoll::~EventDispatcherEpoll()
+{}
+
+bool EventDispatcherEpoll::isPreferred()
+{
+   bool ok = false;
+   int value = pdk::env_var_intval("PDK_EVENT_DISPATCHER_POLL", &ok);
+   return !(ok && value > 0);
+}
+
+void EventDispatcherEpoll::registerSocketNotifier(SocketNotifier *notifier)
+{
+   PDK_ASSERT(notifier);
+   PDK_D(EventDispatcherEpoll);
+   const int sockfd = notifier->getSocket();
+   const bool wasRegistered = implPtr->m_socketNotifiers.find(sockfd) != implPtr->m_socketNotifiers.end();
+   EventDispatcherUNIX::registerSocketNotifier(notifier);
+   if (implPtr->m_epollFd != -1) {
+      implPtr->updateRegistration(sockfd, wasRegistered);
+   }
+}
+
+void EventDispatcherEpoll::unregisterSocketNotifier(SocketNotifier *notifier)
+{
+   PDK_ASSERT(notifier);
+   PDK_D(EventDispatcherEpoll);
+   const int sockfd = notifier->getSocket();
+   const bool wasRegistered = implPtr->m_socketNotifiers.find(sockfd) != implPtr->m_socketNotifiers.end();
+   EventDispatcherUNIX::unregisterSocketNotifier(notifier);
+   if (implPtr->m_epollFd != -1 && wasRegistered) {
+      implPtr->updateRegistration(sockfd, wasRegistered);
+   }
+}
+
+bool EventDispatcherEpoll::processEvents(EventLoop::ProcessEventsFlags flags)
+{
+   PDK_D(EventDispatcherEpoll);
+   const bool includeNotifiers = (flags & EventLoop::ExcludeSocketNotifiers) == 0;
+   if (implPtr->m_epollFd == -1 || !includeNotifiers) {
+      // the epoll set always reports the notifiers, the poll(2) path only
+      // watches the thread pipe when they are excluded
+      return EventDispatcherUNIX::processEvents(flags);
+   }
+   timespec waitTs;
+   timespec *ts;
+   if (!prepareWait(flags, &waitTs, &ts)) {
+      return false;
+   }
+   const int timeout = implPtr->waitTimeout(ts);
+   std::vector<epoll_event> &events = implPtr->m_epollEvents;
+   int ready = ::epoll_wait(implPtr->m_epollFd, events.data(), static_cast<int>(events.size()), timeout);
+   int nevents = 0;
+   if (ready == -1 && errno != EINTR) {
+      perror("EventDispatcherEpoll: epoll_wait");
+   }
+   const int threadPipeFd = implPtr->m_threadPipe.m_fds[0];
+   for (int i = 0; i < ready; ++i) {
+      const int fd = events[i].data.fd;
+      const short revents = epoll_to_poll_events(events[i].events);
+      if (fd == threadPipeFd) {
+         pollfd pfd = implPtr->m_threadPipe.prepare();
+         pfd.revents = revents;
+         nevents += implPtr->m_threadPipe.check(pfd);
+      } else if (fd == implPtr->m_timerFd) {
+         implPtr->consumeTimerFd();
+      } else if (implPtr->m_socketNotifiers.find(fd) != implPtr->m_socketNotifiers.end()) {
+         implPtr->markPendingSocketNotifiers(fd, revents);
+      }
+   }
+   if (ready == static_cast<int>(events.size())) {
+      // the buffer was too small, give the next round more room
+      events.resize(events.size() * 2);
+   }
+   nevents += implPtr->getActivateSocketNotifiers();
+   nevents += activateTimers(flags);
+   // return true if we handled events, false otherwise
+   return (nevents > 0);
+}
+
+} // kernel
+} // pdk
@@ -210,7 +210,7 @@ EventDispatcherUNIXPrivate::EventDispatcherUNIXPrivate()
 
 EventDispatcherUNIXPrivate::~EventDispatcherUNIXPrivate()
 {
-   pdk::stdext::delete_all(m_timerList);
+   m_timerList.clear();
 }
 
 void EventDispatcherUNIXPrivate::setSocketNotifierPending(SocketNotifier *notifier)
@@ -235,35 +235,40 @@ void EventDispatcherUNIXPrivate::markPendingSocketNotifiers()
       if (pfd.fd < 0 || pfd.revents == 0) {
          continue;
       }
-      auto iter = m_socketNotifiers.find(pfd.fd);
-      PDK_ASSERT(iter != m_socketNotifiers.end());
-      const SocketNotifierSetUNIX &snSet = iter->second;
-      static const struct
-      {
-         SocketNotifier::Type m_type;
-         short m_flags;
-      } notifierFlags[] = {
+      markPendingSocketNotifiers(pfd.fd, pfd.revents);
+   }
+   m_pollfds.clear();
+}
+
+void EventDispatcherUNIXPrivate::markPendingSocketNotifiers(int fd, short revents)
+{
+   auto iter = m_socketNotifiers.find(fd);
+   PDK_ASSERT(iter != m_socketNotifiers.end());
+   const SocketNotifierSetUNIX &snSet = iter->second;
+   static const struct
+   {
+      SocketNotifier::Type m_type;
+      short m_flags;
+   } notifierFlags[] = {
       {SocketNotifier::Type::Read,      POLLIN | POLLHUP | POLLERR},
       {SocketNotifier::Type::Write,     POLLOUT | POLLHUP | POLLERR},
       {SocketNotifier::Type::Exception, POLLPRI | POLLHUP | POLLERR}
    };
-      for (const auto &nflag : notifierFlags) {
-         SocketNotifier *notifier = snSet.m_notifiers[static_cast<int>(nflag.m_type)];
-         if (!notifier) {
-            continue;
-         }
-         if (pfd.revents & POLLNVAL) {
-            // @TODO
-            // warning_stream("SocketNotifier: Invalid socket %d with type %s, disabling...",
-            //              iter->first, socketType(notifier->getType()));
-            notifier->setEnabled(false);
-         }
-         if (pfd.revents & nflag.m_flags) {
-            setSocketNotifierPending(notifier);
-         }
+   for (const auto &nflag : notifierFlags) {
+      SocketNotifier *notifier = snSet.m_notifiers[static_cast<int>(nflag.m_type)];
+      if (!notifier) {
+         continue;
+      }
+      if (revents & POLLNVAL) {
+         // @TODO
+         // warning_stream("SocketNotifier: Invalid socket %d with type %s, disabling...",
+         //              iter->first, socketType(notifier->getType()));
+         notifier->setEnabled(false);
+      }
+      if (revents & nflag.m_flags) {
+         setSocketNotifierPending(notifier);
       }
    }
-   m_pollfds.clear();
 }
 
 int EventDispatcherUNIXPrivate::getActivateSocketNotifiers()
@@ -415,7 +420,7 @@ void EventDispatcherUNIX::unregisterSocketNotifier(SocketNotifier *notifier)
    }
 }
 
-bool EventDispatcherUNIX::processEvents(EventLoop::ProcessEventsFlags flags)
+bool EventDispatcherUNIX::prepareWait(EventLoop::ProcessEventsFlags flags, timespec *waitTs, timespec **ts)
 {
    PDK_D(EventDispatcherUNIX);
    implPtr->m_interrupt.store(0);
@@ -423,7 +428,6 @@ bool EventDispatcherUNIX::processEvents(EventLoop::ProcessEventsFlags flags)
    emitAwakeSignal();
    CoreApplicationPrivate::sendPostedEvents(0, Event::Type::None, implPtr->m_threadData);
    const bool includeTimers = (flags & EventLoop::X11ExcludeTimers) == 0;
-   const bool includeNotifiers = (flags & EventLoop::ExcludeSocketNotifiers) == 0;
    const bool waitForEvents = flags & EventLoop::WaitForMoreEvents;
    const bool canWait = (implPtr->m_threadData->canWaitLocked()
                          && !implPtr->m_interrupt.load()
@@ -434,11 +438,32 @@ bool EventDispatcherUNIX::processEvents(EventLoop::ProcessEventsFlags flags)
    if (implPtr->m_interrupt.load()) {
       return false;
    }
-   timespec *ts = nullptr;
-   timespec waitTs = { 0, 0 };
-   if (!canWait || (includeTimers && implPtr->m_timerList.timerWait(waitTs))) {
-      ts = &waitTs;
+   *ts = nullptr;
+   *waitTs = { 0, 0 };
+   if (!canWait || (includeTimers && implPtr->m_timerList.timerWait(*waitTs))) {
+      *ts = waitTs;
    }
+   return true;
+}
+
+int EventDispatcherUNIX::activateTimers(EventLoop::ProcessEventsFlags flags)
+{
+   PDK_D(EventDispatcherUNIX);
+   if (flags & EventLoop::X11ExcludeTimers) {
+      return 0;
+   }
+   return implPtr->getActivateTimers();
+}
+
+bool EventDispatcherUNIX::processEvents(EventLoop::ProcessEventsFlags flags)
+{
+   PDK_D(EventDispatcherUNIX);
+   timespec waitTs;
+   timespec *ts;
+   if (!prepareWait(flags, &waitTs, &ts)) {
+      return false;
+   }
+   const bool includeNotifiers = (flags & EventLoop::ExcludeSocketNotifiers) == 0;
    implPtr->m_pollfds.clear();
    implPtr->m_pollfds.reserve(1 + (includeNotifiers ? implPtr->m_socketNotifiers.size() : 0));
    if (includeNotifiers) {
@@ -464,9 +489,7 @@ bool EventDispatcherUNIX::processEvents(EventLoop::ProcessEventsFlags flags)
       }
       break;
    }
-   if (includeTimers) {
-      nevents += implPtr->getActivateTimers();
-   }
+   nevents += activateTimers(flags);
    // return true if we handled events, false otherwise
    return (nevents > 0);
 }
@@ -19,6 +19,7 @@
 #include "pdk/kernel/internal/ObjectPrivate.h"
 #include "pdk/kernel/internal/AbstractEventDispatcherPrivate.h"
 #include "pdk/kernel/ElapsedTimer.h"
+#include "pdk/kernel/Algorithms.h"
 #include "pdk/base/io/Debug.h"
 #include "pdk/base/lang/Character.h"
 #include "pdk/base/os/thread/Thread.h"
@@ -28,6 +29,9 @@
 #  include "pdk/base/os/thread/Thread.h"
 #endif
 #include <sys/times.h>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 
 namespace pdk {
 namespace kernel {
@@ -41,8 +45,28 @@ using pdk::os::thread::Thread;
 
 PDK_CORE_EXPORT bool g_pdkDisableLowpriorityTimers = false;
 
-// Internal functions for manipulating timer data structures.  The
-// timerBitVec array is used for keeping track of timer identifiers.
+namespace {
+
+inline pdk::puint64 to_expire_tick(const timespec &time)
+{
+   // always round up, a timer must never fire before its timeout
+   return pdk::puint64(time.tv_sec) * 1000 + (pdk::puint64(time.tv_nsec) + 999999) / 1000000;
+}
+
+inline pdk::puint64 to_current_tick(const timespec &time)
+{
+   return pdk::puint64(time.tv_sec) * 1000 + pdk::puint64(time.tv_nsec) / 1000000;
+}
+
+inline timespec from_tick(pdk::puint64 tick)
+{
+   timespec time;
+   time.tv_sec = time_t(tick / 1000);
+   time.tv_nsec = long(tick % 1000) * 1000 * 1000;
+   return time;
+}
+
+} // anonymous namespace
 
 TimerInfoList::TimerInfoList()
 {
@@ -56,13 +80,39 @@ TimerInfoList::TimerInfoList()
       m_msPerTick = 1000/m_ticksPerSecond;
    } else {
       // detected monotonic timers
-      previousTime.tv_sec = m_previousTime.tv_nsec = 0;
+      m_previousTime.tv_sec = m_previousTime.tv_nsec = 0;
       m_previousTicks = 0;
       m_ticksPerSecond = 0;
       m_msPerTick = 0;
    }
 #endif
-   m_firstTimerInfo = nullptr;
+   clear();
+   m_wheelTick = to_current_tick(updateCurrentTime());
+}
+
+TimerInfoList::~TimerInfoList()
+{
+   clear();
+}
+
+void TimerInfoList::clear()
+{
+   for (auto &item : m_timers) {
+      TimerInfo *t = item.second;
+      if (t->m_activateRef) {
+         *(t->m_activateRef) = nullptr;
+      }
+      delete t;
+   }
+   m_timers.clear();
+   m_objectTimers.clear();
+   std::fill(std::begin(m_buckets), std::end(m_buckets), nullptr);
+   std::fill(std::begin(m_bucketMinTick), std::end(m_bucketMinTick), 0);
+   std::fill(std::begin(m_occupiedBuckets), std::end(m_occupiedBuckets), 0);
+   m_zeroTimers = nullptr;
+   m_expiredTimers = nullptr;
+   m_activeTimers = nullptr;
+   m_wheelTimerCount = 0;
 }
 
 timespec TimerInfoList::updateCurrentTime()
@@ -108,16 +158,21 @@ bool TimerInfoList::timeChanged(timespec *delta)
    // been set. Of course, we have to allow for the tick granularity as well.
    timespec tickGranularity;
    tickGranularity.tv_sec = 0;
-   tickGranularity.tv_nsec = msPerTick * 1000 * 1000;
+   tickGranularity.tv_nsec = m_msPerTick * 1000 * 1000;
    return elapsedTimeTicks < ((abs_timespec(*delta) - tickGranularity) * 10);
 }
 
 void TimerInfoList::timerRepair(const timespec &diff)
 {
-   // repair all timers
-   for (size_t i = 0; i < size(); ++i) {
-      TimerInfo *t = at(i);
+   // repair all timers, the wheel is rebuilt on the new time base
+   m_wheelTick = to_current_tick(m_currentTime);
+   for (auto &item : m_timers) {
+      TimerInfo *t = item.second;
       t->m_timeout = t->m_timeout + diff;
+      if (isWheelBucket(t->m_bucket)) {
+         unlinkTimer(t);
+         timerInsert(t);
+      }
    }
 }
 
@@ -141,22 +196,247 @@ void TimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+void TimerInfoList::appendTimer(TimerInfo *timerInfo, TimerInfo **bucket)
+{
+   TimerInfo *head = *bucket;
+   timerInfo->m_bucket = bucket;
+   timerInfo->m_next = nullptr;
+   if (head) {
+      timerInfo->m_prev = head->m_prev;
+      head->m_prev->m_next = timerInfo;
+      head->m_prev = timerInfo;
+   } else {
+      timerInfo->m_prev = timerInfo;
+      *bucket = timerInfo;
+   }
+   if (isWheelBucket(bucket)) {
+      int index = int(bucket - m_buckets);
+      m_occupiedBuckets[index / 64] |= pdk::puint64(1) << (index % 64);
+      if (!head) {
+         m_bucketMinTick[index] = timerInfo->m_expireTick;
+      } else if (timerInfo->m_expireTick < m_bucketMinTick[index]) {
+         m_bucketMinTick[index] = timerInfo->m_expireTick;
+      }
+      ++m_wheelTimerCount;
+   }
+}
+
+void TimerInfoList::unlinkTimer(TimerInfo *timerInfo)
+{
+   TimerInfo **bucket = timerInfo->m_bucket;
+   TimerInfo *head = *bucket;
+   if (timerInfo == head) {
+      *bucket = timerInfo->m_next;
+      if (timerInfo->m_next) {
+         timerInfo->m_next->m_prev = timerInfo->m_prev;
+      }
+   } else {
+      timerInfo->m_prev->m_next = timerInfo->m_next;
+      if (timerInfo->m_next) {
+         timerInfo->m_next->m_prev = timerInfo->m_prev;
+      } else {
+         head->m_prev = timerInfo->m_prev;
+      }
+   }
+   timerInfo->m_bucket = nullptr;
+   timerInfo->m_prev = nullptr;
+   timerInfo->m_next = nullptr;
+   if (isWheelBucket(bucket)) {
+      int index = int(bucket - m_buckets);
+      --m_wheelTimerCount;
+      if (!*bucket) {
+         m_occupiedBuckets[index / 64] &= ~(pdk::puint64(1) << (index % 64));
+         m_bucketMinTick[index] = 0;
+      } else if (timerInfo->m_expireTick == m_bucketMinTick[index]) {
+         // recalculated on demand by getBucketMinTick()
+         m_bucketMinTick[index] = 0;
+      }
+   }
+}
+
+void TimerInfoList::removeTimer(TimerInfo *timerInfo)
+{
+   unlinkTimer(timerInfo);
+   if (timerInfo->m_objectPrev) {
+      timerInfo->m_objectPrev->m_objectNext = timerInfo->m_objectNext;
+   } else if (timerInfo->m_objectNext) {
+      m_objectTimers[timerInfo->m_obj] = timerInfo->m_objectNext;
+   } else {
+      m_objectTimers.erase(timerInfo->m_obj);
+   }
+   if (timerInfo->m_objectNext) {
+      timerInfo->m_objectNext->m_objectPrev = timerInfo->m_objectPrev;
+   }
+   m_timers.erase(timerInfo->m_id);
+   if (timerInfo->m_activateRef) {
+      *(timerInfo->m_activateRef) = nullptr;
+   }
+   delete timerInfo;
+}
+
+int TimerInfoList::findOccupiedBucket(int first, int last) const
+{
+   while (first < last) {
+      pdk::puint64 word = m_occupiedBuckets[first / 64] >> (first % 64);
+      if (word) {
+         int index = first + int(pdk::count_trailing_zero_bits(word));
+         return index < last ? index : -1;
+      }
+      first = (first / 64 + 1) * 64;
+   }
+   return -1;
+}
+
 /*
-  insert timer info into list
+  move every timer that expires up to currentTick onto the expired list
 */
-void TimerInfoList::timerInsert(TimerInfo *timeInfo)
+void TimerInfoList::advanceWheel(pdk::puint64 currentTick)
 {
-   TimerInfoList::iterator iter = begin();
-   TimerInfoList::iterator endMark = end();
-   while (iter != endMark) {
-      const TimerInfo * const t = *iter;
-      if (!(timeInfo->m_timeout < t->m_timeout)) {
+   while (m_wheelTick <= currentTick) {
+      if (m_wheelTimerCount == 0) {
+         // nothing to cascade, just catch up
+         m_wheelTick = currentTick + 1;
+         return;
+      }
+      int index = int(m_wheelTick & (RootWheelSize - 1));
+      pdk::puint64 limit = std::min<pdk::puint64>(currentTick + 1, m_wheelTick + (RootWheelSize - index));
+      int occupied = findOccupiedBucket(index, index + int(limit - m_wheelTick));
+      if (occupied < 0) {
+         m_wheelTick = limit;
+      } else {
+         TimerInfo **bucket = &m_buckets[occupied];
+         while (TimerInfo *t = *bucket) {
+            unlinkTimer(t);
+            appendTimer(t, &m_expiredTimers);
+         }
+         m_wheelTick += occupied - index + 1;
+      }
+      if ((m_wheelTick & (RootWheelSize - 1)) == 0) {
+         cascadeWheels();
+      }
+   }
+}
+
+/*
+  the root wheel wrapped around, move the timers of the upper wheel buckets
+  that start now down to the wheel below
+*/
+void TimerInfoList::cascadeWheels()
+{
+   for (int level = 1; level <= WheelLevels; ++level) {
+      int shift = RootWheelBits + (level - 1) * WheelBits;
+      int slot = int((m_wheelTick >> shift) & (WheelSize - 1));
+      TimerInfo **bucket = &m_buckets[RootWheelSize + (level - 1) * WheelSize + slot];
+      TimerInfo *pending = nullptr;
+      while (TimerInfo *t = *bucket) {
+         unlinkTimer(t);
+         appendTimer(t, &pending);
+      }
+      while (TimerInfo *t = pending) {
+         unlinkTimer(t);
+         timerInsert(t);
+      }
+      if (slot != 0) {
          break;
-      }   
-      ++iter;
+      }
+   }
+}
+
+pdk::puint64 TimerInfoList::getBucketMinTick(int index)
+{
+   if (m_bucketMinTick[index] == 0) {
+      pdk::puint64 minTick = std::numeric_limits<pdk::puint64>::max();
+      for (TimerInfo *t = m_buckets[index]; t; t = t->m_next) {
+         minTick = std::min(minTick, t->m_expireTick);
+      }
+      m_bucketMinTick[index] = minTick;
+   }
+   return m_bucketMinTick[index];
+}
+
+/*
+  find the tick the first timer on the wheel expires at, the wheel must have
+  been advanced to the current time
+*/
+bool TimerInfoList::findNextExpireTick(pdk::puint64 &tick)
+{
+   if (m_wheelTimerCount == 0) {
+      return false;
+   }
+   bool found = false;
+   // every bucket of the root wheel holds exactly one of the next ticks
+   int index = int(m_wheelTick & (RootWheelSize - 1));
+   int occupied = findOccupiedBucket(index, RootWheelSize);
+   if (occupied >= 0) {
+      tick = m_wheelTick + (occupied - index);
+      found = true;
+   } else if ((occupied = findOccupiedBucket(0, index)) >= 0) {
+      tick = m_wheelTick + (RootWheelSize - index + occupied);
+      found = true;
+   }
+   // an upper wheel bucket covers a whole range of ticks and the ranges of
+   // different wheels overlap, so look at the first occupied bucket of each
+   for (int level = 1; level <= WheelLevels; ++level) {
+      int shift = RootWheelBits + (level - 1) * WheelBits;
+      int first = RootWheelSize + (level - 1) * WheelSize;
+      int slot = int((m_wheelTick >> shift) & (WheelSize - 1));
+      int offset;
+      // the bucket of the current slot was cascaded already, whatever is in
+      // there now is one full turn ahead
+      if ((occupied = findOccupiedBucket(first + slot + 1, first + WheelSize)) >= 0) {
+         offset = occupied - first - slot;
+      } else if ((occupied = findOccupiedBucket(first, first + slot + 1)) >= 0) {
+         offset = WheelSize - slot + occupied - first;
+      } else {
+         continue;
+      }
+      pdk::puint64 rangeStart = ((m_wheelTick >> shift) + offset) << shift;
+      if (found && tick <= rangeStart) {
+         continue;
+      }
+      pdk::puint64 bucketTick = std::max(rangeStart, getBucketMinTick(occupied));
+      if (!found || bucketTick < tick) {
+         tick = bucketTick;
+         found = true;
+      }
+   }
+   return found;
+}
+
+/*
+  insert timer info into the wheel
+*/
+void TimerInfoList::timerInsert(TimerInfo *timerInfo)
+{
+   if (timerInfo->m_interval == 0) {
+      appendTimer(timerInfo, &m_zeroTimers);
+      return;
+   }
+   pdk::puint64 expireTick = to_expire_tick(timerInfo->m_timeout);
+   timerInfo->m_expireTick = expireTick;
+   if (expireTick < m_wheelTick) {
+      // already due, deliver it on the next tick
+      expireTick = m_wheelTick;
    }
-   std::advance(iter, 1);
-   insert(iter, timeInfo);
+   pdk::puint64 delta = expireTick - m_wheelTick;
+   int index;
+   if (delta < RootWheelSize) {
+      index = int(expireTick & (RootWheelSize - 1));
+   } else {
+      int level = 1;
+      int shift = RootWheelBits + WheelBits;
+      while (level < WheelLevels && delta >= (pdk::puint64(1) << shift)) {
+         ++level;
+         shift += WheelBits;
+      }
+      if (delta >= (pdk::puint64(1) << shift)) {
+         // beyond the last wheel, park it in its furthest bucket
+         expireTick = m_wheelTick + (pdk::puint64(1) << shift) - 1;
+      }
+      index = RootWheelSize + (level - 1) * WheelSize
+            + int((expireTick >> (shift - WheelBits)) & (WheelSize - 1));
+   }
+   appendTimer(timerInfo, &m_buckets[index]);
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -344,20 +624,23 @@ bool TimerInfoList::timerWait(timespec &tm)
 {
    timespec currentTime = updateCurrentTime();
    repairTimersIfNeeded();
-   // Find first waiting timer not already active
-   TimerInfo *t = nullptr;
-   for (TimerInfoList::const_iterator iter = cbegin(); iter != cend(); ++iter) {
-      if (!(*iter)->m_activateRef) {
-         t = *iter;
-         break;
-      }
+   advanceWheel(to_current_tick(currentTime));
+   // timers that are being activated are parked off the wheel, so everything
+   // found here is eligible
+   if (m_zeroTimers || m_expiredTimers) {
+      // no time to wait
+      tm.tv_sec  = 0;
+      tm.tv_nsec = 0;
+      return true;
    }
-   if (!t) {
+   pdk::puint64 expireTick;
+   if (!findNextExpireTick(expireTick)) {
       return false;
    }
-   if (currentTime < t->m_timeout) {
+   timespec timeout = from_tick(expireTick);
+   if (currentTime < timeout) {
       // time to wait
-      tm = round_to_millisecond(t->m_timeout - currentTime);
+      tm = timeout - currentTime;
    } else {
       // no time to wait
       tm.tv_sec  = 0;
@@ -371,20 +654,16 @@ int TimerInfoList::timerRemainingTime(int timerId)
    timespec currentTime = updateCurrentTime();
    repairTimersIfNeeded();
    timespec tm = {0, 0};
-   TimerInfoList::iterator iter = begin();
-   TimerInfoList::iterator endMark = end();
-   while (iter != endMark) {
-      TimerInfo *t = *iter;
-      if (t->m_id == timerId) {
-         if (currentTime < t->m_timeout) {
-            // time to wait
-            tm = round_to_millisecond(t->m_timeout - currentTime);
-            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-         } else {
-            return 0;
-         }
+   auto iter = m_timers.find(timerId);
+   if (iter != m_timers.end()) {
+      TimerInfo *t = iter->second;
+      if (currentTime < t->m_timeout) {
+         // time to wait
+         tm = round_to_millisecond(t->m_timeout - currentTime);
+         return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+      } else {
+         return 0;
       }
-      ++iter;
    }
    
 #ifndef PDK_NO_DEBUG
@@ -395,6 +674,7 @@ int TimerInfoList::timerRemainingTime(int timerId)
 
 void TimerInfoList::registerTimer(int timerId, int interval, pdk::TimerType timerType, Object *object)
 {
+   PDK_ASSERT(m_timers.find(timerId) == m_timers.end());
    TimerInfo *t = new TimerInfo;
    t->m_id = timerId;
    t->m_interval = interval;
@@ -442,6 +722,14 @@ void TimerInfoList::registerTimer(int timerId, int interval, pdk::TimerType time
       }
    }
    timerInsert(t);
+   m_timers[timerId] = t;
+   TimerInfo *&objectTimers = m_objectTimers[object];
+   t->m_objectPrev = nullptr;
+   t->m_objectNext = objectTimers;
+   if (objectTimers) {
+      objectTimers->m_objectPrev = t;
+   }
+   objectTimers = t;
 #ifdef PDK_TIMERINFO_DEBUG
    t->m_expected = expected;
    t->m_cumulativeError = 0;
@@ -474,50 +762,27 @@ Debug operator<<(Debug s, pdk::TimerType t)
 
 bool TimerInfoList::unregisterTimer(int timerId)
 {
-   // set timer inactive
-   TimerInfoList::iterator iter = begin();
-   TimerInfoList::iterator endMark = end();
-   while (iter != endMark) {
-      TimerInfo *t = *iter;
-      if (t->m_id == timerId) {
-         // found it
-         erase(iter);
-         if (t == m_firstTimerInfo) {
-            m_firstTimerInfo = nullptr;
-         }
-         if (t->m_activateRef) {
-            *(t->m_activateRef) = 0;
-         }            
-         delete t;
-         return true;
-      }
-      ++iter;
+   auto iter = m_timers.find(timerId);
+   if (iter == m_timers.end()) {
+      // id not found
+      return false;
    }
-   // id not found
-   return false;
+   removeTimer(iter->second);
+   return true;
 }
 
 bool TimerInfoList::unregisterTimers(Object *object)
 {
-   if (empty()) {
+   if (m_timers.empty()) {
       return false;
    }
-   TimerInfoList::iterator iter = begin();
-   while (iter != end()) {
-      TimerInfo *t = *iter;
-      if (t->m_obj == object) {
-         // object found
-         iter = erase(iter);
-         if (t == m_firstTimerInfo) {
-            m_firstTimerInfo = nullptr;
-         }  
-         if (t->m_activateRef) {
-            *(t->m_activateRef) = 0;
-         }
-         delete t;
-         // move back one so that we don't skip the new current item
-      } else {
-         ++iter;
+   auto iter = m_objectTimers.find(object);
+   if (iter != m_objectTimers.end()) {
+      TimerInfo *t = iter->second;
+      while (t) {
+         TimerInfo *next = t->m_objectNext;
+         removeTimer(t);
+         t = next;
       }
    }
    return true;
@@ -527,63 +792,44 @@ std::list<AbstractEventDispatcher::TimerInfo>
 TimerInfoList::getRegisteredTimers(Object *object) const
 {
    std::list<AbstractEventDispatcher::TimerInfo> list;
-   TimerInfoList::const_iterator iter = begin();
-   TimerInfoList::const_iterator endMark = end();
-   while (iter != endMark) {
-      const TimerInfo * const t = *iter;
-      if (t->m_obj == object) {
-         list.push_back(AbstractEventDispatcher::TimerInfo(t->m_id,
-                                                           (t->m_timerType == pdk::TimerType::VeryCoarseTimer
-                                                            ? t->m_interval * 1000
-                                                            : t->m_interval),
-                                                           t->m_timerType));
-      }
-      ++iter;
+   auto iter = m_objectTimers.find(object);
+   if (iter == m_objectTimers.end()) {
+      return list;
+   }
+   // the chain is kept newest first, report in registration order
+   for (const TimerInfo *t = iter->second; t; t = t->m_objectNext) {
+      list.push_front(AbstractEventDispatcher::TimerInfo(t->m_id,
+                                                         (t->m_timerType == pdk::TimerType::VeryCoarseTimer
+                                                          ? t->m_interval * 1000
+                                                          : t->m_interval),
+                                                         t->m_timerType));
    }
    return list;
 }
 
 int TimerInfoList::getActivateTimers()
 {
-   if (g_pdkDisableLowpriorityTimers || empty()) {
+   if (g_pdkDisableLowpriorityTimers || m_timers.empty()) {
       return 0; // nothing to do
    }
    int n_act = 0;
-   int maxCount = 0;
-   m_firstTimerInfo = nullptr;
    timespec currentTime = updateCurrentTime();
 #ifdef PDK_TIMERINFO_DEBUG
    // debug_stream() << "Thread" << Thread::getCurrentThreadId() << "woken up at" << currentTime;
 #endif
-   repairTimersIfNeeded();   
-   // Find out how many timer have expired
-   for (TimerInfoList::const_iterator iter = cbegin(); iter != cend(); ++iter) {
-      if (currentTime < (*iter)->m_timeout) {
-         break;
-      }
-      maxCount++;
+   repairTimersIfNeeded();
+   advanceWheel(to_current_tick(currentTime));
+   // zero timers fire once per pass, a timer that was activated during this
+   // pass is parked on m_activeTimers until its event has been delivered, so
+   // it can not be sent twice
+   while (TimerInfo *t = m_zeroTimers) {
+      unlinkTimer(t);
+      appendTimer(t, &m_expiredTimers);
    }
    //fire the timers.
-   while (maxCount--) {
-      if (empty()) {
-         break;
-      }
-      TimerInfo *currentTimerInfo = front();
-      if (currentTime < currentTimerInfo->m_timeout) {
-         break; // no timer has expired
-      }
-      if (!m_firstTimerInfo) {
-         m_firstTimerInfo = currentTimerInfo;
-      } else if (m_firstTimerInfo == currentTimerInfo) {
-         // avoid sending the same timer multiple times
-         break;
-      } else if (currentTimerInfo->m_interval <  m_firstTimerInfo->m_interval
-                 || currentTimerInfo->m_interval == m_firstTimerInfo->m_interval) {
-         m_firstTimerInfo = currentTimerInfo;
-      }
-      
-      // remove from list
-      pop_front();
+   while (m_expiredTimers) {
+      TimerInfo *currentTimerInfo = m_expiredTimers;
+      unlinkTimer(currentTimerInfo);
       
 #ifdef PDK_TIMERINFO_DEBUG
       float diff;
@@ -608,22 +854,21 @@ int TimerInfoList::getActivateTimers()
 #endif
       // determine next timeout time
       calculate_next_timeout(currentTimerInfo, currentTime);
-      // reinsert timer
-      timerInsert(currentTimerInfo);
       if (currentTimerInfo->m_interval > 0) {
          n_act++;
       }
-      if (!currentTimerInfo->m_activateRef) {
-         // send event, but don't allow it to recurse
-         currentTimerInfo->m_activateRef = &currentTimerInfo;
-         TimerEvent e(currentTimerInfo->m_id);
-         CoreApplication::sendEvent(currentTimerInfo->m_obj, &e);
-         if (currentTimerInfo) {
-            currentTimerInfo->m_activateRef = 0;
-         }
+      appendTimer(currentTimerInfo, &m_activeTimers);
+      // send event, but don't allow it to recurse
+      currentTimerInfo->m_activateRef = &currentTimerInfo;
+      TimerEvent e(currentTimerInfo->m_id);
+      CoreApplication::sendEvent(currentTimerInfo->m_obj, &e);
+      if (currentTimerInfo) {
+         currentTimerInfo->m_activateRef = 0;
+         // reinsert timer
+         unlinkTimer(currentTimerInfo);
+         timerInsert(currentTimerInfo);
       }
    }
-   m_firstTimerInfo = 0;
    // debug_stream() << "Thread" << Thread::getCurrentThreadId() << "activated" << n_act << "timers";
    return n_act;
 }
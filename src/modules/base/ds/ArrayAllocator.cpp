@@ -0,0 +1,451 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/base/ds/internal/ArrayAllocatorPrivate.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+
+namespace pdk {
+namespace ds {
+
+namespace {
+
+// The Slab policy puts a tag word in front of every block. Blocks carved
+// from a slab chunk are tagged with the address of their chunk, which
+// knows the size class and the heap that owns it, blocks passed on to
+// malloc are tagged with their size shifted left by one and the low bit
+// set. Chunks are 16 byte aligned so the two never mix up.
+//
+// Every thread allocates from a heap of its own, a free list per size
+// class and a bump area in the newest chunk of each class, without any
+// locking. A block freed by another thread is pushed onto the remote list
+// of its owning heap, which the owner takes over in one exchange when a
+// local free list runs dry. Heaps and their chunks are never given back,
+// the heap of a finished thread is handed to the next thread that needs
+// one, so slab memory stays bounded by the peak use of each class.
+
+constexpr int SIZE_CLASS_COUNT = 11;
+constexpr size_t sg_blockSizes[SIZE_CLASS_COUNT] = {
+   32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256
+};
+constexpr size_t MAX_BLOCK_SIZE = 256;
+// size class for each 16 byte step up to MAX_BLOCK_SIZE
+constexpr pdk::puint8 sg_sizeClassIndex[MAX_BLOCK_SIZE / 16 + 1] = {
+   0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 7, 8, 8, 9, 9, 10, 10
+};
+// the statistics keep one more class for blocks that went to malloc
+constexpr int LARGE_CLASS = SIZE_CLASS_COUNT;
+constexpr size_t SLAB_CHUNK_SIZE = 16 * 1024;
+constexpr size_t BLOCK_TAG_SIZE = sizeof(pdk::uintptr);
+constexpr int POLICY_UNDECIDED = -1;
+
+struct SlabHeap;
+
+struct alignas(16) SlabChunk
+{
+   SlabHeap *m_heap;
+   int m_sizeClass;
+};
+
+struct FreeBlock
+{
+   pdk::uintptr m_tag;
+   FreeBlock *m_next;
+};
+
+struct SizeClassCounters
+{
+   std::atomic<pdk::puint64> m_allocations{0};
+   std::atomic<pdk::puint64> m_deallocations{0};
+   std::atomic<pdk::puint64> m_bytesAllocated{0};
+   std::atomic<pdk::puint64> m_bytesDeallocated{0};
+   std::atomic<pdk::puint64> m_bytesReserved{0};
+};
+
+struct SlabHeap
+{
+   FreeBlock *m_freeLists[SIZE_CLASS_COUNT] = {};
+   char *m_cursors[SIZE_CLASS_COUNT] = {};
+   char *m_ends[SIZE_CLASS_COUNT] = {};
+   // only the owning thread writes these, readers may see them a little late
+   SizeClassCounters m_counters[SIZE_CLASS_COUNT + 1];
+   SlabHeap *m_nextHeap = nullptr;
+   SlabHeap *m_nextOrphan = nullptr;
+   alignas(64) std::atomic<FreeBlock *> m_remoteFrees{nullptr};
+};
+
+std::atomic<int> sg_policy{POLICY_UNDECIDED};
+// every heap ever created, only pushed to
+std::atomic<SlabHeap *> sg_heaps{nullptr};
+std::mutex sg_orphanMutex;
+SlabHeap *sg_orphans = nullptr;
+// for threads that already gave their heap back
+SizeClassCounters sg_detachedCounters[SIZE_CLASS_COUNT + 1];
+
+thread_local SlabHeap *sg_threadHeap = nullptr;
+thread_local bool sg_threadHeapReleased = false;
+
+struct ThreadHeapReleaser
+{
+   ~ThreadHeapReleaser()
+   {
+      if (!m_heap) {
+         return;
+      }
+      // blocks allocated from here on, by later thread local destructors,
+      // come straight from malloc
+      sg_threadHeap = nullptr;
+      sg_threadHeapReleased = true;
+      std::lock_guard<std::mutex> locker(sg_orphanMutex);
+      m_heap->m_nextOrphan = sg_orphans;
+      sg_orphans = m_heap;
+   }
+
+   SlabHeap *m_heap = nullptr;
+};
+
+thread_local ThreadHeapReleaser sg_heapReleaser;
+
+int resolve_policy()
+{
+   // the environment is read without pdk::get_env_var, which would
+   // allocate a ByteArray and come right back here
+   const char *value = std::getenv("PDK_ARRAY_ALLOCATOR");
+   int policy = static_cast<int>(ArrayAllocationPolicy::System);
+   if (value && std::strcmp(value, "slab") == 0) {
+      policy = static_cast<int>(ArrayAllocationPolicy::Slab);
+   }
+   int expected = POLICY_UNDECIDED;
+   if (!sg_policy.compare_exchange_strong(expected, policy, std::memory_order_acq_rel)) {
+      policy = expected;
+   }
+   return policy;
+}
+
+inline ArrayAllocationPolicy current_policy()
+{
+   int policy = sg_policy.load(std::memory_order_acquire);
+   if (PDK_UNLIKELY(policy == POLICY_UNDECIDED)) {
+      policy = resolve_policy();
+   }
+   return static_cast<ArrayAllocationPolicy>(policy);
+}
+
+inline void add_owned(std::atomic<pdk::puint64> &counter, pdk::puint64 value)
+{
+   counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void count_allocation(SlabHeap *heap, int sizeClass, size_t bytes)
+{
+   if (heap) {
+      SizeClassCounters &counters = heap->m_counters[sizeClass];
+      add_owned(counters.m_allocations, 1);
+      add_owned(counters.m_bytesAllocated, bytes);
+   } else {
+      SizeClassCounters &counters = sg_detachedCounters[sizeClass];
+      counters.m_allocations.fetch_add(1, std::memory_order_relaxed);
+      counters.m_bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+   }
+}
+
+void count_deallocation(SlabHeap *heap, int sizeClass, size_t bytes)
+{
+   if (heap) {
+      SizeClassCounters &counters = heap->m_counters[sizeClass];
+      add_owned(counters.m_deallocations, 1);
+      add_owned(counters.m_bytesDeallocated, bytes);
+   } else {
+      SizeClassCounters &counters = sg_detachedCounters[sizeClass];
+      counters.m_deallocations.fetch_add(1, std::memory_order_relaxed);
+      counters.m_bytesDeallocated.fetch_add(bytes, std::memory_order_relaxed);
+   }
+}
+
+SlabHeap *acquire_thread_heap()
+{
+   if (sg_threadHeapReleased) {
+      return nullptr;
+   }
+   SlabHeap *heap;
+   {
+      std::lock_guard<std::mutex> locker(sg_orphanMutex);
+      heap = sg_orphans;
+      if (heap) {
+         sg_orphans = heap->m_nextOrphan;
+         heap->m_nextOrphan = nullptr;
+      }
+   }
+   if (!heap) {
+      heap = new (std::nothrow) SlabHeap;
+      if (!heap) {
+         return nullptr;
+      }
+      SlabHeap *head = sg_heaps.load(std::memory_order_relaxed);
+      do {
+         heap->m_nextHeap = head;
+      } while (!sg_heaps.compare_exchange_weak(head, heap, std::memory_order_release,
+                                               std::memory_order_relaxed));
+   }
+   sg_heapReleaser.m_heap = heap;
+   sg_threadHeap = heap;
+   return heap;
+}
+
+inline SlabHeap *get_thread_heap()
+{
+   SlabHeap *heap = sg_threadHeap;
+   return PDK_LIKELY(heap) ? heap : acquire_thread_heap();
+}
+
+void take_remote_frees(SlabHeap *heap)
+{
+   FreeBlock *block = heap->m_remoteFrees.exchange(nullptr, std::memory_order_acquire);
+   while (block) {
+      FreeBlock *next = block->m_next;
+      const int sizeClass = reinterpret_cast<SlabChunk *>(block->m_tag)->m_sizeClass;
+      block->m_next = heap->m_freeLists[sizeClass];
+      heap->m_freeLists[sizeClass] = block;
+      block = next;
+   }
+}
+
+FreeBlock *carve_block(SlabHeap *heap, int sizeClass)
+{
+   const size_t blockSize = sg_blockSizes[sizeClass];
+   char *cursor = heap->m_cursors[sizeClass];
+   if (static_cast<size_t>(heap->m_ends[sizeClass] - cursor) < blockSize) {
+      SlabChunk *chunk = static_cast<SlabChunk *>(std::malloc(SLAB_CHUNK_SIZE));
+      if (!chunk) {
+         return nullptr;
+      }
+      chunk->m_heap = heap;
+      chunk->m_sizeClass = sizeClass;
+      add_owned(heap->m_counters[sizeClass].m_bytesReserved, SLAB_CHUNK_SIZE);
+      cursor = reinterpret_cast<char *>(chunk + 1);
+      heap->m_ends[sizeClass] = reinterpret_cast<char *>(chunk) + SLAB_CHUNK_SIZE;
+   }
+   FreeBlock *block = reinterpret_cast<FreeBlock *>(cursor);
+   block->m_tag = reinterpret_cast<pdk::uintptr>(heap->m_ends[sizeClass] - SLAB_CHUNK_SIZE);
+   heap->m_cursors[sizeClass] = cursor + blockSize;
+   return block;
+}
+
+inline void *block_data(FreeBlock *block)
+{
+   return reinterpret_cast<char *>(block) + BLOCK_TAG_SIZE;
+}
+
+inline FreeBlock *data_block(void *data)
+{
+   return reinterpret_cast<FreeBlock *>(static_cast<char *>(data) - BLOCK_TAG_SIZE);
+}
+
+void *large_allocate(SlabHeap *heap, size_t size)
+{
+   if (size > (std::numeric_limits<pdk::uintptr>::max() >> 1)) {
+      return nullptr;
+   }
+   FreeBlock *block = static_cast<FreeBlock *>(std::malloc(size));
+   if (!block) {
+      return nullptr;
+   }
+   block->m_tag = (static_cast<pdk::uintptr>(size) << 1) | 1;
+   count_allocation(heap, LARGE_CLASS, size);
+   return block_data(block);
+}
+
+// size includes the tag word
+void *slab_allocate(size_t size)
+{
+   SlabHeap *heap = get_thread_heap();
+   if (size > MAX_BLOCK_SIZE || !heap) {
+      return large_allocate(heap, size);
+   }
+   const int sizeClass = sg_sizeClassIndex[(size + 15) >> 4];
+   FreeBlock *block = heap->m_freeLists[sizeClass];
+   if (!block && heap->m_remoteFrees.load(std::memory_order_relaxed)) {
+      take_remote_frees(heap);
+      block = heap->m_freeLists[sizeClass];
+   }
+   if (block) {
+      heap->m_freeLists[sizeClass] = block->m_next;
+   } else {
+      block = carve_block(heap, sizeClass);
+      if (!block) {
+         return nullptr;
+      }
+   }
+   count_allocation(heap, sizeClass, sg_blockSizes[sizeClass]);
+   return block_data(block);
+}
+
+void slab_free(void *data)
+{
+   FreeBlock *block = data_block(data);
+   SlabHeap *heap = sg_threadHeap;
+   const pdk::uintptr tag = block->m_tag;
+   if (tag & 1) {
+      count_deallocation(heap, LARGE_CLASS, tag >> 1);
+      std::free(block);
+      return;
+   }
+   SlabChunk *chunk = reinterpret_cast<SlabChunk *>(tag);
+   const int sizeClass = chunk->m_sizeClass;
+   count_deallocation(heap, sizeClass, sg_blockSizes[sizeClass]);
+   SlabHeap *owner = chunk->m_heap;
+   if (owner == heap) {
+      block->m_next = heap->m_freeLists[sizeClass];
+      heap->m_freeLists[sizeClass] = block;
+      return;
+   }
+   FreeBlock *head = owner->m_remoteFrees.load(std::memory_order_relaxed);
+   do {
+      block->m_next = head;
+   } while (!owner->m_remoteFrees.compare_exchange_weak(head, block, std::memory_order_release,
+                                                        std::memory_order_relaxed));
+}
+
+void *slab_reallocate(void *data, size_t size)
+{
+   FreeBlock *block = data_block(data);
+   const pdk::uintptr tag = block->m_tag;
+   size_t oldSize;
+   if (tag & 1) {
+      oldSize = tag >> 1;
+      if (size > MAX_BLOCK_SIZE) {
+         // stays with malloc, which may well grow it in place
+         if (size > (std::numeric_limits<pdk::uintptr>::max() >> 1)) {
+            return nullptr;
+         }
+         block = static_cast<FreeBlock *>(std::realloc(block, size));
+         if (!block) {
+            return nullptr;
+         }
+         block->m_tag = (static_cast<pdk::uintptr>(size) << 1) | 1;
+         SlabHeap *heap = sg_threadHeap;
+         count_deallocation(heap, LARGE_CLASS, oldSize);
+         count_allocation(heap, LARGE_CLASS, size);
+         return block_data(block);
+      }
+   } else {
+      const int sizeClass = reinterpret_cast<SlabChunk *>(tag)->m_sizeClass;
+      if (size <= MAX_BLOCK_SIZE && sg_sizeClassIndex[(size + 15) >> 4] == sizeClass) {
+         return data;
+      }
+      oldSize = sg_blockSizes[sizeClass];
+   }
+   void *result = slab_allocate(size);
+   if (!result) {
+      return nullptr;
+   }
+   std::memcpy(result, data, std::min(oldSize, size) - BLOCK_TAG_SIZE);
+   slab_free(data);
+   return result;
+}
+
+} // anonymous namespace
+
+bool set_array_allocation_policy(ArrayAllocationPolicy policy)
+{
+   int expected = POLICY_UNDECIDED;
+   if (sg_policy.compare_exchange_strong(expected, static_cast<int>(policy),
+                                         std::memory_order_acq_rel)) {
+      return true;
+   }
+   return expected == static_cast<int>(policy);
+}
+
+ArrayAllocationPolicy get_array_allocation_policy()
+{
+   return current_policy();
+}
+
+std::vector<ArrayAllocationStatistics> get_array_allocation_statistics()
+{
+   std::vector<ArrayAllocationStatistics> statistics;
+   if (current_policy() != ArrayAllocationPolicy::Slab) {
+      return statistics;
+   }
+   statistics.resize(SIZE_CLASS_COUNT + 1);
+   for (int i = 0; i < SIZE_CLASS_COUNT; ++i) {
+      statistics[i].m_blockSize = sg_blockSizes[i];
+   }
+   auto add_counters = [&statistics](const SizeClassCounters *counters) {
+      for (int i = 0; i <= SIZE_CLASS_COUNT; ++i) {
+         ArrayAllocationStatistics &entry = statistics[i];
+         entry.m_allocations += counters[i].m_allocations.load(std::memory_order_relaxed);
+         entry.m_deallocations += counters[i].m_deallocations.load(std::memory_order_relaxed);
+         entry.m_bytesAllocated += counters[i].m_bytesAllocated.load(std::memory_order_relaxed);
+         entry.m_bytesDeallocated += counters[i].m_bytesDeallocated.load(std::memory_order_relaxed);
+         entry.m_bytesReserved += counters[i].m_bytesReserved.load(std::memory_order_relaxed);
+      }
+   };
+   add_counters(sg_detachedCounters);
+   for (SlabHeap *heap = sg_heaps.load(std::memory_order_acquire); heap; heap = heap->m_nextHeap) {
+      add_counters(heap->m_counters);
+   }
+   return statistics;
+}
+
+namespace internal {
+
+void *allocate_array_block(size_t size) noexcept
+{
+   if (current_policy() == ArrayAllocationPolicy::System) {
+      return std::malloc(size);
+   }
+   if (size > std::numeric_limits<size_t>::max() - BLOCK_TAG_SIZE) {
+      return nullptr;
+   }
+   return slab_allocate(size + BLOCK_TAG_SIZE);
+}
+
+void *reallocate_array_block(void *block, size_t size) noexcept
+{
+   // the policy was settled by the allocation of block
+   if (static_cast<ArrayAllocationPolicy>(sg_policy.load(std::memory_order_relaxed))
+       == ArrayAllocationPolicy::System) {
+      return std::realloc(block, size);
+   }
+   if (size > std::numeric_limits<size_t>::max() - BLOCK_TAG_SIZE) {
+      return nullptr;
+   }
+   return slab_reallocate(block, size + BLOCK_TAG_SIZE);
+}
+
+void free_array_block(void *block) noexcept
+{
+   if (!block) {
+      return;
+   }
+   if (static_cast<ArrayAllocationPolicy>(sg_policy.load(std::memory_order_relaxed))
+       == ArrayAllocationPolicy::System) {
+      std::free(block);
+      return;
+   }
+   slab_free(block);
+}
+
+} // internal
+
+} // ds
+} // pdk
@@ -14,6 +14,7 @@
 // Created by softboy on 2017/12/04.
 
 #include "pdk/base/ds/internal/ArrayData.h"
+#include "pdk/base/ds/internal/ArrayAllocatorPrivate.h"
 #include "pdk/utils/MemoryHelper.h"
 #include <climits>
 
@@ -53,7 +54,7 @@ inline size_t calculate_block_size(size_t &capacity, size_t objectSize, size_t h
 
 ArrayData *reallocate_data(ArrayData *header, size_t allocSize, uint options)
 {
-    header = static_cast<ArrayData *>(::realloc(header, allocSize));
+    header = static_cast<ArrayData *>(reallocate_array_block(header, allocSize));
     if (header) {
        header->m_capacityReserved = bool(options & ArrayData::CapacityReserved);
     }
@@ -77,8 +78,8 @@ ArrayData *ArrayData::allocate(size_t objectSize, size_t alignment,
    }
    size_t headerSize = sizeof(ArrayData);
    // Allocate extra (alignment - PDK_ALIGNOF(ArrayData)) padding bytes so we
-   // can properly align the data array. This assumes malloc is able to
-   // provide appropriate alignment for the header -- as it should!
+   // can properly align the data array. This assumes the block allocator
+   // provides appropriate alignment for the header -- as it should!
    // Padding is skipped when allocating a header for RawData.
    if (!(options & RawData)) {
       headerSize += (alignment - alignof(ArrayData));
@@ -87,7 +88,7 @@ ArrayData *ArrayData::allocate(size_t objectSize, size_t alignment,
       return 0;
    }
    size_t allocSize = calculate_block_size(capacity, objectSize, headerSize, options);
-   ArrayData *header = static_cast<ArrayData *>(std::malloc(allocSize));
+   ArrayData *header = static_cast<ArrayData *>(allocate_array_block(allocSize));
    if (header) {
       pdk::uintptr data = (reinterpret_cast<pdk::uintptr>(header) + sizeof(ArrayData) + alignment - 1)
             & ~(alignment - 1);
@@ -131,7 +132,7 @@ void ArrayData::deallocate(ArrayData *data, size_t objectSize, size_t alignment)
 #endif
    PDK_ASSERT_X(data == 0 || !data->m_ref.isStatic(), "ArrayData::deallocate",
                 "Static data can not be deleted");
-   std::free(data);
+   free_array_block(data);
 }
 
 
@@ -17,6 +17,7 @@
 #include "pdk/utils/MemoryHelper.h"
 #include "pdk/base/lang/Character.h"
 #include "pdk/base/ds/ByteArrayMatcher.h"
+#include "pdk/base/lang/internal/StringSimdPrivate.h"
 #include "pdk/kernel/internal/StringAlgorithms.h"
 #include "pdk/utils/internal/LocalePrivate.h"
 #include "pdk/utils/internal/LocaleToolsPrivate.h"
@@ -25,7 +26,7 @@
 #include <limits.h>
 
 #define PDK_BA_IS_RAW_DATA(data)\
-   ((data)->m_offset != sizeof(pdk::ds::ByteArrayData))
+   (!(data).isInline() && (data)->m_offset != sizeof(pdk::ds::ByteArrayData))
 
 namespace pdk {
 namespace ds {
@@ -77,9 +78,12 @@ ByteArray::ByteArray(const char *data, int size)
       }
       if (!size) {
          m_data = Data::allocate(0);
+      } else if (char *inlineData = m_data.allocateInline(size)) {
+         std::memcpy(inlineData, data, size);
       } else {
-         m_data = Data::allocate(static_cast<uint>(size) + 1u);
-         PDK_CHECK_ALLOC_PTR(m_data);
+         Data *ptr = Data::allocate(static_cast<uint>(size) + 1u);
+         PDK_CHECK_ALLOC_PTR(ptr);
+         m_data = ptr;
          m_data->m_size = size;
          std::memcpy(m_data->getData(), data, size);
          m_data->getData()[size] = '\0';
@@ -91,9 +95,12 @@ ByteArray::ByteArray(int size, char data)
 {
    if (size <= 0) {
       m_data = Data::allocate(0);
+   } else if (char *inlineData = m_data.allocateInline(size)) {
+      std::memset(inlineData, data, size);
    } else {
-      m_data = Data::allocate(static_cast<uint>(size) + 1u);
-      PDK_CHECK_ALLOC_PTR(m_data);
+      Data *ptr = Data::allocate(static_cast<uint>(size) + 1u);
+      PDK_CHECK_ALLOC_PTR(ptr);
+      m_data = ptr;
       m_data->m_size = size;
       std::memset(m_data->getData(), data, size);
       m_data->getData()[size] = '\0';
@@ -102,10 +109,13 @@ ByteArray::ByteArray(int size, char data)
 
 ByteArray::ByteArray(int size, Initialization)
 {
-   m_data = Data::allocate(static_cast<uint>(size) + 1u);
-   PDK_CHECK_ALLOC_PTR(m_data);
-   m_data->m_size = size;
-   m_data->getData()[size] = '\0';
+   if (size <= 0 || !m_data.allocateInline(size)) {
+      Data *ptr = Data::allocate(static_cast<uint>(size) + 1u);
+      PDK_CHECK_ALLOC_PTR(ptr);
+      m_data = ptr;
+      m_data->m_size = size;
+      m_data->getData()[size] = '\0';
+   }
 }
 
 ByteArray &ByteArray::setNum(pdk::plonglong n, int base)
@@ -137,12 +147,31 @@ ByteArray &ByteArray::setNum(pdk::pulonglong n, int base)
    return *this;
 }
 
-// @TODO wait for locale
 ByteArray &ByteArray::setNum(double n, char f, int prec)
 {
-   std::string ret = std::to_string(n);
-   clear();
-   append(ret.data(), ret.size());
+   LocaleData::DoubleForm form = LocaleData::DoubleForm::DFDecimal;
+   LocaleData::Flags flags = 0;
+   if (is_upper(f)) {
+      flags = LocaleData::Flag::CapitalEorX;
+   }
+   f = to_lower(f);
+   switch (f) {
+   case 'f':
+      form = LocaleData::DoubleForm::DFDecimal;
+      break;
+   case 'e':
+      form = LocaleData::DoubleForm::DFExponent;
+      break;
+   case 'g':
+      form = LocaleData::DoubleForm::DFSignificantDigits;
+      break;
+   default:
+#if defined(PDK_CHECK_RANGE)
+      warning_stream("ByteArray::setNum: Invalid format char '%c'", f);
+#endif
+      break;
+   }
+   *this = LocaleData::c()->doubleToString(n, prec, form, -1, flags).toLatin1();
    return *this;
 }
 
@@ -153,7 +182,7 @@ ByteArray &ByteArray::setRawData(const char *data, int size)
    } else {
       if (data) {
          m_data->m_size = size;
-         m_data->m_offset = data - reinterpret_cast<char *>(m_data);
+         m_data->m_offset = data - reinterpret_cast<char *>(m_data.get());
       } else {
          m_data->m_offset = sizeof(ByteArrayData);
          m_data->m_size = 0;
@@ -353,11 +382,11 @@ void ByteArray::reallocData(uint alloc, Data::AllocationOptions options)
       std::memcpy(ptr->getData(), m_data->getData(), ptr->m_size);
       ptr->getData()[ptr->m_size] = '\0';
       if (!m_data->m_ref.deref()) {
-         Data::deallocate(m_data);
+         Data::deallocate(m_data.get());
       }
       m_data = ptr;
    } else {
-      Data *ptr = Data::reallocateUnaligned(m_data, alloc, options);
+      Data *ptr = Data::reallocateUnaligned(m_data.get(), alloc, options);
       PDK_CHECK_ALLOC_PTR(ptr);
       m_data = ptr;
    }
@@ -516,7 +545,7 @@ ByteArray &ByteArray::operator=(const ByteArray &other) noexcept
 {
    other.m_data->m_ref.ref();
    if (!m_data->m_ref.deref()) {
-      Data::deallocate(m_data);
+      Data::deallocate(m_data.get());
    }
    m_data = other.m_data;
    return *this;
@@ -524,25 +553,27 @@ ByteArray &ByteArray::operator=(const ByteArray &other) noexcept
 
 ByteArray &ByteArray::operator =(const char *str)
 {
-   Data *ptr;
-   if (!str) {
-      ptr = Data::getSharedNull();
-   } else if (!*str) {
-      ptr = Data::allocate(0);
-   } else {
+   if (str && *str) {
       const int length = static_cast<int>(std::strlen(str));
       const uint fullLength = length + 1;
-      if (m_data->m_ref.isShared() || fullLength > m_data->m_alloc
-          || (length < m_data->m_size && fullLength < static_cast<uint>((m_data->m_alloc >> 1)))) {
+      if (!isDetached() && length <= m_data.getCapacity()) {
+         if (!m_data->m_ref.deref()) {
+            Data::deallocate(m_data.get());
+         }
+         m_data.allocateInline(length);
+      } else if (!isDetached() || fullLength > m_data->m_alloc
+          || (!m_data.isInline() && length < m_data->m_size
+              && fullLength < static_cast<uint>((m_data->m_alloc >> 1)))) {
          reallocData(fullLength, m_data->detachFlags());
       }
-      ptr = m_data;
-      std::memcpy(ptr->getData(), str, fullLength);
-      ptr->m_size = length;
+      std::memcpy(m_data->getData(), str, fullLength);
+      m_data->m_size = length;
+      return *this;
    }
+   Data *ptr = str ? Data::allocate(0) : Data::getSharedNull();
    ptr->m_ref.ref();
    if (!m_data->m_ref.deref()) {
-      Data::deallocate(m_data);
+      Data::deallocate(m_data.get());
    }
    m_data = ptr;
    return *this;
@@ -557,10 +588,13 @@ void ByteArray::resize(int size)
       m_data->m_size = size;
       return;
    }
+   if (m_data.isInline() && m_data.allocateInline(size)) {
+      return;
+   }
    if (0 == size && !m_data->m_capacityReserved) {
       Data *ptr = Data::allocate(0);
       if (!m_data->m_ref.deref()) {
-         Data::deallocate(m_data);
+         Data::deallocate(m_data.get());
       }
       m_data = ptr;
    } else if (m_data->m_size == 0 &&m_data->m_ref.isStatic()) {
@@ -570,11 +604,13 @@ void ByteArray::resize(int size)
       //    a.resize(sz);
       //    ...
       //
-      Data *ptr = Data::allocate(static_cast<uint>(size) + 1u);
-      PDK_CHECK_ALLOC_PTR(ptr);
-      ptr->m_size = size;
-      ptr->getData()[size] = '\0';
-      m_data = ptr;
+      if (!m_data.allocateInline(size)) {
+         Data *ptr = Data::allocate(static_cast<uint>(size) + 1u);
+         PDK_CHECK_ALLOC_PTR(ptr);
+         ptr->m_size = size;
+         ptr->getData()[size] = '\0';
+         m_data = ptr;
+      }
    } else {
       if (m_data->m_ref.isShared() || static_cast<uint>(size) + 1u > m_data->m_alloc
           || (!m_data->m_capacityReserved && size < m_data->m_size
@@ -601,7 +637,7 @@ ByteArray &ByteArray::fill(char c, int size)
 void ByteArray::clear()
 {
    if (!m_data->m_ref.deref()) {
-      Data::deallocate(m_data);
+      Data::deallocate(m_data.get());
    }
    m_data = Data::getSharedNull();
 }
@@ -650,6 +686,13 @@ int ByteArray::indexOf(char needle, int from) const
       from = std::max(from + m_data->m_size, 0);
    }
    const char *dataPtr = m_data->getData();
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (m_data->m_size - from >= lang::internal::WIDE_KERNEL_MIN_LENGTH
+       && lang::internal::has_wide_string_kernels()) {
+      const int idx = lang::internal::wide_find_byte(dataPtr + from, m_data->m_size - from, needle);
+      return idx < 0 ? -1 : from + idx;
+   }
+#endif
    if (from < m_data->m_size) {
       const char *iter = dataPtr + from - 1;
       const char *end = dataPtr + m_data->m_size;
@@ -725,6 +768,12 @@ int ByteArray::count(const char *array) const
 
 int ByteArray::count(char c) const
 {
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (m_data->m_size >= lang::internal::WIDE_KERNEL_MIN_LENGTH
+       && lang::internal::has_wide_string_kernels()) {
+      return lang::internal::wide_count_byte(m_data->getData(), m_data->m_size, c);
+   }
+#endif
    int num = 0;
    const char *i = m_data->getData() + m_data->m_size;
    const char *b = m_data->getData();
@@ -900,7 +949,7 @@ ByteArray &ByteArray::prepend(const char *str)
 ByteArray &ByteArray::prepend(const char *str, int length)
 {
    if (str) {
-      if (m_data->m_ref.isShared() || 
+      if (!isDetached() || 
           static_cast<uint>(m_data->m_size + length) + 1u > m_data->m_alloc) {
          reallocData(static_cast<uint>(m_data->m_size + length) + 1u, m_data->detachFlags() | Data::Grow);
       }
@@ -914,7 +963,7 @@ ByteArray &ByteArray::prepend(const char *str, int length)
 
 ByteArray &ByteArray::prepend(char c)
 {
-   if (m_data->m_ref.isShared() || 
+   if (!isDetached() || 
        static_cast<uint>(m_data->m_size) + 2u > m_data->m_alloc) {
       reallocData(static_cast<uint>(m_data->m_size) + 2u, m_data->detachFlags() | Data::Grow);
    }
@@ -930,7 +979,7 @@ ByteArray &ByteArray::append(const ByteArray &array)
    if (m_data->m_size == 0 && m_data->m_ref.isStatic() && !PDK_BA_IS_RAW_DATA(array.m_data)) {
       *this = array;
    } else if (array.m_data->m_size != 0) {
-      if (m_data->m_ref.isShared() || 
+      if (!isDetached() || 
           static_cast<uint>(m_data->m_size + array.m_data->m_size) + 1u > m_data->m_alloc) {
          reallocData(static_cast<uint>(m_data->m_size + array.m_data->m_size) + 1u, m_data->detachFlags() | Data::Grow);
       }
@@ -945,7 +994,7 @@ ByteArray &ByteArray::append(const char *str)
 {
    if (str) {
       const int length = static_cast<int>(std::strlen(str));
-      if (m_data->m_ref.isShared() || 
+      if (!isDetached() || 
           static_cast<uint>(m_data->m_size + length) + 1u > m_data->m_alloc) {
          reallocData(static_cast<uint>(m_data->m_size + length) + 1u, m_data->detachFlags() | Data::Grow);
       }
@@ -961,7 +1010,7 @@ ByteArray &ByteArray::append(const char *str, int length)
       length = pdk::strlen(str);
    }
    if (str && length) {
-      if (m_data->m_ref.isShared() || 
+      if (!isDetached() || 
           static_cast<uint>(m_data->m_size + length) + 1u > m_data->m_alloc) {
          reallocData(static_cast<uint>(m_data->m_size + length) + 1u, m_data->detachFlags() | Data::Grow);
       }
@@ -974,7 +1023,7 @@ ByteArray &ByteArray::append(const char *str, int length)
 
 ByteArray &ByteArray::append(char c)
 {
-   if (m_data->m_ref.isShared() || static_cast<uint>(m_data->m_size) + 2u > m_data->m_alloc) {
+   if (!isDetached() || static_cast<uint>(m_data->m_size) + 2u > m_data->m_alloc) {
       reallocData(static_cast<uint>(m_data->m_size) + 2u, m_data->detachFlags() | Data::Grow);
    }
    m_data->getData()[m_data->m_size++] = c;
@@ -14,6 +14,7 @@
 // Created by softboy on 2017/12/19.
 
 #include "pdk/base/ds/ByteArrayMatcher.h"
+#include "pdk/base/lang/internal/StringSimdPrivate.h"
 #include <limits.h>
 
 namespace pdk {
@@ -92,8 +93,8 @@ ByteArrayMatcher::ByteArrayMatcher(const ByteArray &pattern)
    : m_impl(nullptr),
      m_pattern(pattern)
 {
-   m_data.m_ptr = reinterpret_cast<const uchar *>(pattern.getConstRawData());
-   m_data.m_len = pattern.size();
+   m_data.m_ptr = reinterpret_cast<const uchar *>(m_pattern.getConstRawData());
+   m_data.m_len = m_pattern.size();
    bm_init_skiptable(m_data.m_ptr, m_data.m_len, m_data.m_skiptable);
 }
 
@@ -112,24 +113,24 @@ ByteArrayMatcher &ByteArrayMatcher::operator=(const ByteArrayMatcher &other)
 {
    m_pattern = other.m_pattern;
    memcpy(&m_data, &other.m_data, sizeof(m_data));
+   // a short pattern is stored inside other, point to our own copy
+   if (!m_pattern.isNull()) {
+      m_data.m_ptr = reinterpret_cast<const uchar *>(m_pattern.getConstRawData());
+   }
    return *this;
 }
 
 void ByteArrayMatcher::setPattern(const ByteArray &pattern)
 {
    m_pattern = pattern;
-   m_data.m_ptr = reinterpret_cast<const uchar *>(pattern.getConstRawData());
-   m_data.m_len = pattern.size();
+   m_data.m_ptr = reinterpret_cast<const uchar *>(m_pattern.getConstRawData());
+   m_data.m_len = m_pattern.size();
    bm_init_skiptable(m_data.m_ptr, m_data.m_len, m_data.m_skiptable);
 }
 
 int ByteArrayMatcher::indexIn(const ByteArray &ba, int from) const
 {
-   if (from < 0) {
-      from = 0;
-   }
-   return bm_find(reinterpret_cast<const uchar *>(ba.getConstRawData()), ba.size(), from,
-                  m_data.m_ptr, m_data.m_len, m_data.m_skiptable);
+   return indexIn(ba.getConstRawData(), ba.size(), from);
 }
 
 int ByteArrayMatcher::indexIn(const char *str, int len, int from) const
@@ -137,6 +138,15 @@ int ByteArrayMatcher::indexIn(const char *str, int len, int from) const
    if (from < 0) {
       from = 0;
    }
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (m_data.m_len >= 2 && len - from >= std::max(m_data.m_len, lang::internal::WIDE_KERNEL_MIN_LENGTH)
+       && lang::internal::has_wide_string_kernels()) {
+      const int idx = lang::internal::wide_find_bytes(str + from, len - from,
+                                                      reinterpret_cast<const char *>(m_data.m_ptr),
+                                                      m_data.m_len);
+      return idx < 0 ? -1 : from + idx;
+   }
+#endif
    return bm_find(reinterpret_cast<const uchar *>(str), len, from,
                   m_data.m_ptr, m_data.m_len, m_data.m_skiptable);
 }
@@ -149,6 +159,12 @@ int pdk_find_char(const char *str, int len, char ch, int from)
    if (from < 0) {
       from = std::max(from + len, 0);
    }
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (len - from >= lang::internal::WIDE_KERNEL_MIN_LENGTH && lang::internal::has_wide_string_kernels()) {
+      const int idx = lang::internal::wide_find_byte(str + from, len - from, ch);
+      return idx < 0 ? -1 : from + idx;
+   }
+#endif
    if (from < len) {
       const uchar *n = s + from - 1;
       const uchar *e = s + len;
@@ -204,6 +220,13 @@ int pdk_find_byte_array(
       for the skip table should pay off, otherwise we use a simple
       hash function.
     */
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (l - from >= lang::internal::WIDE_KERNEL_MIN_LENGTH && lang::internal::has_wide_string_kernels()) {
+      const int idx = lang::internal::wide_find_bytes(haystack0 + from, l - from, needle, sl);
+      return idx < 0 ? -1 : from + idx;
+   }
+#endif
+   
    if (l > 500 && sl > 5)
       return pdk_find_byte_array_boyer_moore(haystack0, haystackLen, from,
                                              needle, needleLen);
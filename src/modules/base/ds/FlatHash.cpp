@@ -0,0 +1,72 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/base/ds/FlatHash.h"
+#include <algorithm>
+
+namespace pdk {
+namespace ds {
+
+using lang::Character;
+using lang::Latin1String;
+using lang::String;
+using lang::StringView;
+
+namespace {
+
+// code units widened on the stack at a time
+constexpr int sg_latin1Chunk = 256;
+
+} // anonymous namespace
+
+size_t FlatHash<String>::operator()(const String &key) const noexcept
+{
+   return static_cast<size_t>(hash_bytes64(key.unicode(), static_cast<size_t>(key.size()) * sizeof(Character)));
+}
+
+size_t FlatHash<String>::operator()(StringView key) const noexcept
+{
+   return static_cast<size_t>(hash_bytes64(key.data(), static_cast<size_t>(key.size()) * sizeof(Character)));
+}
+
+size_t FlatHash<String>::operator()(Latin1String key) const noexcept
+{
+   const uchar *data = reinterpret_cast<const uchar *>(key.getRawData());
+   const int size = key.size();
+   char16_t buffer[sg_latin1Chunk];
+   if (size <= sg_latin1Chunk) {
+      for (int i = 0; i < size; ++i) {
+         buffer[i] = data[i];
+      }
+      return static_cast<size_t>(hash_bytes64(buffer, static_cast<size_t>(size) * sizeof(char16_t)));
+   }
+   IncrementalHash hash;
+   for (int done = 0; done < size; done += sg_latin1Chunk) {
+      const int count = std::min(sg_latin1Chunk, size - done);
+      for (int i = 0; i < count; ++i) {
+         buffer[i] = data[done + i];
+      }
+      hash.addData(buffer, static_cast<size_t>(count) * sizeof(char16_t));
+   }
+   return static_cast<size_t>(hash.result());
+}
+
+size_t FlatHash<ByteArray>::operator()(const ByteArray &key) const noexcept
+{
+   return static_cast<size_t>(hash_bytes64(key.getConstRawData(), static_cast<size_t>(key.size())));
+}
+
+} // ds
+} // pdk
@@ -15,39 +15,251 @@
 
 #include "pdk/base/ds/internal/RingBufferPrivate.h"
 #include "pdk/base/ds/internal/ByteArrayPrivate.h"
+#include "pdk/kernel/Algorithms.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
 
 namespace pdk {
 namespace ds {
 namespace internal {
 
 namespace {
-ByteArray &retrive_at(std::list<ByteArray> &array, size_t pos)
+
+// Every thread keeps the chunks it released in a free list per size class,
+// up to PDK_RING_BUFFER_POOL_SIZE bytes, so a busy socket or pipe takes
+// its next chunk without going to malloc and without any locking. A chunk
+// freed by another thread simply joins the pool of that thread.
+constexpr int MIN_POOLED_SHIFT = 10;
+constexpr int MAX_POOLED_SHIFT = 16;
+constexpr int CHUNK_CLASS_COUNT = MAX_POOLED_SHIFT - MIN_POOLED_SHIFT + 1;
+
+struct ChunkPool
+{
+   ~ChunkPool();
+   
+   RingBufferChunk *m_freeLists[CHUNK_CLASS_COUNT] = {};
+   size_t m_pooledBytes = 0;
+};
+
+thread_local ChunkPool sg_chunkPool;
+// chunks released after the pool of the thread is gone go to free()
+thread_local bool sg_chunkPoolReleased = false;
+
+ChunkPool::~ChunkPool()
+{
+   sg_chunkPoolReleased = true;
+   for (RingBufferChunk *&list : m_freeLists) {
+      while (list) {
+         RingBufferChunk *next = list->m_next;
+         std::free(list);
+         list = next;
+      }
+   }
+}
+
+// -1 for chunks that do not go to the pool
+inline int chunk_class(pdk::pint64 capacity)
+{
+   if (capacity < (1 << MIN_POOLED_SHIFT) || capacity > (1 << MAX_POOLED_SHIFT)
+       || (capacity & (capacity - 1))) {
+      return -1;
+   }
+   return static_cast<int>(count_trailing_zero_bits(static_cast<pdk::puint32>(capacity))) - MIN_POOLED_SHIFT;
+}
+
+RingBufferChunk *allocate_chunk(pdk::pint64 capacity)
 {
-   PDK_ASSERT(pos >= 0 && pos < array.size());
-   auto iter = array.begin();
-   while (pos != 0) {
-      ++iter;  
-      --pos;
+   PDK_ASSERT(capacity > 0 && capacity < MAX_BYTE_ARRAY_SIZE);
+   RingBufferChunk *chunk = nullptr;
+   const int chunkClass = chunk_class(capacity);
+   if (chunkClass >= 0 && !sg_chunkPoolReleased) {
+      ChunkPool &pool = sg_chunkPool;
+      chunk = pool.m_freeLists[chunkClass];
+      if (chunk) {
+         pool.m_freeLists[chunkClass] = chunk->m_next;
+         pool.m_pooledBytes -= static_cast<size_t>(capacity);
+      }
+   }
+   if (!chunk) {
+      chunk = static_cast<RingBufferChunk *>(std::malloc(sizeof(RingBufferChunk) + static_cast<size_t>(capacity)));
+      PDK_CHECK_ALLOC_PTR(chunk);
    }
-   return *iter;
+   chunk->m_prev = nullptr;
+   chunk->m_next = nullptr;
+   chunk->m_data = reinterpret_cast<char *>(chunk + 1);
+   chunk->m_capacity = static_cast<int>(capacity);
+   chunk->m_head = 0;
+   chunk->m_tail = 0;
+   chunk->m_isShared = false;
+   return chunk;
+}
+
+// the byte array lives behind the header, where the bytes of a chunk go
+inline ByteArray *shared_byte_array(RingBufferChunk *chunk)
+{
+   return reinterpret_cast<ByteArray *>(chunk + 1);
 }
 
-const ByteArray &retrive_at(const std::list<ByteArray> &array, size_t pos)
+RingBufferChunk *allocate_shared_chunk(const ByteArray &byteArray)
 {
-   return const_cast<const ByteArray &>(retrive_at(const_cast<std::list<ByteArray> &>(array), pos));
+   RingBufferChunk *chunk = static_cast<RingBufferChunk *>(std::malloc(sizeof(RingBufferChunk) + sizeof(ByteArray)));
+   PDK_CHECK_ALLOC_PTR(chunk);
+   const ByteArray *copy = new (shared_byte_array(chunk)) ByteArray(byteArray);
+   chunk->m_prev = nullptr;
+   chunk->m_next = nullptr;
+   chunk->m_data = const_cast<char *>(copy->getConstRawData());
+   chunk->m_capacity = copy->size();
+   chunk->m_head = 0;
+   chunk->m_tail = copy->size();
+   chunk->m_isShared = true;
+   return chunk;
 }
 
+void release_chunk(RingBufferChunk *chunk)
+{
+   if (chunk->m_isShared) {
+      shared_byte_array(chunk)->~ByteArray();
+      std::free(chunk);
+      return;
+   }
+   const int chunkClass = chunk_class(chunk->m_capacity);
+   if (chunkClass >= 0 && !sg_chunkPoolReleased) {
+      ChunkPool &pool = sg_chunkPool;
+      if (pool.m_pooledBytes + static_cast<size_t>(chunk->m_capacity) <= PDK_RING_BUFFER_POOL_SIZE) {
+         chunk->m_next = pool.m_freeLists[chunkClass];
+         pool.m_freeLists[chunkClass] = chunk;
+         pool.m_pooledBytes += static_cast<size_t>(chunk->m_capacity);
+         return;
+      }
+   }
+   std::free(chunk);
+}
+
+} // anonymous namespace
+
+RingBuffer::RingBuffer(const RingBuffer &other)
+   : RingBuffer(other.m_basicBlockSize)
+{
+   // chunk by chunk, so read() still returns the same packets
+   for (RingBufferChunk *chunk = other.m_first; chunk; chunk = chunk->m_next) {
+      if (chunk->size() == 0) {
+         continue;
+      }
+      if (chunk->m_isShared) {
+         RingBufferChunk *copy = appendSharedChunk(*shared_byte_array(chunk));
+         copy->m_head = chunk->m_head;
+         copy->m_tail = chunk->m_tail;
+         copy->m_capacity = chunk->m_capacity;
+         m_bufferSize += chunk->size();
+         continue;
+      }
+      RingBufferChunk *copy = appendChunk(chunk->m_capacity);
+      std::memcpy(copy->getData() + chunk->m_head, chunk->getData() + chunk->m_head, chunk->size());
+      copy->m_head = chunk->m_head;
+      copy->m_tail = chunk->m_tail;
+      m_bufferSize += chunk->size();
+   }
+}
+
+RingBuffer::RingBuffer(RingBuffer &&other) noexcept
+   : m_first(other.m_first),
+     m_last(other.m_last),
+     m_spare(other.m_spare),
+     m_basicBlockSize(other.m_basicBlockSize),
+     m_bufferSize(other.m_bufferSize)
+{
+   other.m_first = nullptr;
+   other.m_last = nullptr;
+   other.m_spare = nullptr;
+   other.m_bufferSize = 0;
+}
+
+RingBuffer::~RingBuffer()
+{
+   releaseChunks(m_first);
+   releaseChunks(m_spare);
+}
+
+RingBuffer &RingBuffer::operator=(const RingBuffer &other)
+{
+   if (this != &other) {
+      RingBuffer copy(other);
+      swap(copy);
+   }
+   return *this;
+}
+
+RingBuffer &RingBuffer::operator=(RingBuffer &&other) noexcept
+{
+   RingBuffer moved(std::move(other));
+   swap(moved);
+   return *this;
+}
+
+void RingBuffer::swap(RingBuffer &other) noexcept
+{
+   std::swap(m_first, other.m_first);
+   std::swap(m_last, other.m_last);
+   std::swap(m_spare, other.m_spare);
+   std::swap(m_basicBlockSize, other.m_basicBlockSize);
+   std::swap(m_bufferSize, other.m_bufferSize);
+}
+
+RingBufferChunk *RingBuffer::appendChunk(pdk::pint64 capacity)
+{
+   return linkLast(allocate_chunk(capacity));
+}
+
+RingBufferChunk *RingBuffer::appendSharedChunk(const ByteArray &byteArray)
+{
+   return linkLast(allocate_shared_chunk(byteArray));
+}
+
+RingBufferChunk *RingBuffer::linkLast(RingBufferChunk *chunk)
+{
+   chunk->m_prev = m_last;
+   if (m_last) {
+      m_last->m_next = chunk;
+   } else {
+      m_first = chunk;
+   }
+   m_last = chunk;
+   return chunk;
+}
+
+void RingBuffer::releaseChunks(RingBufferChunk *chunk)
+{
+   while (chunk) {
+      RingBufferChunk *next = chunk->m_next;
+      release_chunk(chunk);
+      chunk = next;
+   }
+}
+
+void RingBuffer::releaseEmptyChunk()
+{
+   PDK_ASSERT(m_first == m_last && m_bufferSize == 0);
+   // keep a single chunk around if it does not exceed the basic block
+   // size, to avoid going to the pool between uses of the buffer
+   if (!m_first->m_isShared && m_first->m_capacity <= m_basicBlockSize) {
+      m_first->m_head = 0;
+      m_first->m_tail = 0;
+   } else {
+      release_chunk(m_first);
+      m_first = nullptr;
+      m_last = nullptr;
+   }
 }
 
 const char *RingBuffer::readPointerAtPosition(pint64 pos, pint64 &length) const
 {
    if (pos >= 0) {
-      pos += m_head;
-      for (size_t i = 0; i < m_buffers.size(); ++i) {
-         length = (i == static_cast<size_t>(m_tailBuffer) ? m_tail : retrive_at(m_buffers, i).size());
+      for (RingBufferChunk *chunk = m_first; chunk; chunk = chunk->m_next) {
+         length = chunk->size();
          if (length > pos) {
             length -= pos;
-            return retrive_at(m_buffers, i).getConstRawData() + pos;
+            return chunk->getData() + chunk->m_head + pos;
          }
          pos -= length;
       }
@@ -60,141 +272,121 @@ void RingBuffer::free(pint64 bytes)
 {
    PDK_ASSERT(bytes <= m_bufferSize);
    while (bytes > 0) {
-      const pdk::pint64 blockSize = m_buffers.front().size() - m_head;
-      if (m_tailBuffer == 0 || blockSize > bytes) {
-         // keep a single block around if it does not exceed
-         // the basic block size, to avoid repeated allocations
-         // between uses of the buffer
-         if (m_bufferSize <= bytes) {
-            if (m_buffers.front().size() <= m_basicBlockSize) {
-               m_bufferSize = 0;
-               m_head = 0;
-               m_tail = 0;
-            } else {
-               clear();// try to minify/squeeze us
-            }
-         } else {
-            PDK_ASSERT(bytes < MAX_BYTE_ARRAY_SIZE);
-            m_head += static_cast<int>(bytes);
-            m_bufferSize -= bytes;
-         }
+      RingBufferChunk *chunk = m_first;
+      const pdk::pint64 blockSize = chunk->size();
+      if (blockSize > bytes) {
+         chunk->m_head += static_cast<int>(bytes);
+         m_bufferSize -= bytes;
          return;
       }
       m_bufferSize -= blockSize;
       bytes -= blockSize;
-      m_buffers.pop_front();
-      --m_tailBuffer;
-      m_head = 0;
+      if (chunk == m_last) {
+         releaseEmptyChunk();
+         return;
+      }
+      m_first = chunk->m_next;
+      m_first->m_prev = nullptr;
+      release_chunk(chunk);
    }
 }
 
 char *RingBuffer::reserve(pint64 bytes)
 {
-   if (bytes <= 0 | bytes >= MAX_BYTE_ARRAY_SIZE) {
+   if (bytes <= 0 || bytes >= MAX_BYTE_ARRAY_SIZE) {
       return 0;
    }
-   if (m_bufferSize == 0) {
-      if (m_buffers.empty()) {
-         m_buffers.push_back(ByteArray(std::max(m_basicBlockSize, static_cast<int>(bytes)), pdk::Uninitialized));
-      } else {
-         m_buffers.front().resize(std::max(m_basicBlockSize, static_cast<int>(bytes)));
-      }
-   } else {
-      const pdk::pint64 newSize = bytes + m_tail;
-      // if need a new buffer
-      if (0 == m_basicBlockSize || (newSize > m_buffers.back().capacity() &&
-                                    (m_tail >= m_basicBlockSize || newSize >= MAX_BYTE_ARRAY_SIZE))) {
-         // shrink this buffer to its current size
-         m_buffers.back().resize(m_tail);
-         // create a new ByteArray
-         m_buffers.push_back(ByteArray(std::max(m_basicBlockSize, static_cast<int>(bytes)), pdk::Uninitialized));
-         ++m_tailBuffer;
-         m_tail = 0;
-      } else if(newSize > m_buffers.back().size()){
-         m_buffers.back().resize(std::max(m_basicBlockSize, static_cast<int>(newSize)));
+   RingBufferChunk *chunk = m_last;
+   // in packet mode every reserve() is a packet of its own
+   if (!chunk || chunk->m_capacity - chunk->m_tail < bytes
+       || (m_basicBlockSize == 0 && chunk->size() != 0)) {
+      if (chunk && m_bufferSize == 0) {
+         releaseChunks(m_first);
+         m_first = nullptr;
+         m_last = nullptr;
       }
+      chunk = appendChunk(std::max(static_cast<pdk::pint64>(m_basicBlockSize), bytes));
    }
-   char *writePtr = m_buffers.back().getRawData() + m_tail;
+   char *writePtr = chunk->getData() + chunk->m_tail;
+   chunk->m_tail += static_cast<int>(bytes);
    m_bufferSize += bytes;
-   PDK_ASSERT(bytes < MAX_BYTE_ARRAY_SIZE);
-   m_tail += static_cast<int>(bytes);
    return writePtr;
 }
 
 char *RingBuffer::reserveFront(pint64 bytes)
 {
-   if (bytes <= 0 | bytes >= MAX_BYTE_ARRAY_SIZE) {
+   if (bytes <= 0 || bytes >= MAX_BYTE_ARRAY_SIZE) {
       return 0;
    }
-   if (m_head < bytes || m_basicBlockSize == 0) {
-      if (m_head > 0) {
-         m_buffers.front().remove(0, m_head);
-         if (m_tailBuffer) {
-            m_tail -= m_head;
-         }
+   RingBufferChunk *chunk = m_first;
+   if (chunk && m_bufferSize == 0) {
+      // an empty chunk is filled from its end
+      if (chunk->m_capacity >= bytes) {
+         chunk->m_head = chunk->m_capacity;
+         chunk->m_tail = chunk->m_capacity;
+      } else {
+         releaseChunks(m_first);
+         m_first = nullptr;
+         m_last = nullptr;
+         chunk = nullptr;
       }
-      m_head = std::max(m_basicBlockSize, static_cast<int>(bytes));
-      if (m_basicBlockSize == 0) {
-         if (m_buffers.empty()) {
-            m_buffers.push_front(ByteArray(m_head, pdk::Uninitialized));
-         } else {
-            m_buffers.front().resize(m_head);
-         }
-         m_tail = m_head;
+   }
+   if (!chunk || chunk->m_isShared || chunk->m_head < bytes) {
+      chunk = allocate_chunk(std::max(static_cast<pdk::pint64>(m_basicBlockSize), bytes));
+      chunk->m_head = chunk->m_capacity;
+      chunk->m_tail = chunk->m_capacity;
+      chunk->m_next = m_first;
+      if (m_first) {
+         m_first->m_prev = chunk;
       } else {
-         m_buffers.push_front(ByteArray(m_head, pdk::Uninitialized));
-         ++m_tailBuffer;
+         m_last = chunk;
       }
+      m_first = chunk;
    }
-   m_head -= static_cast<int>(bytes);
+   chunk->m_head -= static_cast<int>(bytes);
    m_bufferSize += bytes;
-   return m_buffers.front().getRawData() + m_head;
+   return chunk->getData() + chunk->m_head;
 }
 
 void RingBuffer::chop(pint64 bytes)
 {
    PDK_ASSERT(bytes <= m_bufferSize);
    while (bytes > 0) {
-      if (m_tailBuffer == 0 || m_tail > bytes) {
-         // keep a single block around if it does not exceed
-         // the basic block size, to avoid repeated allocations
-         // between uses of the buffer
-         if (m_bufferSize <= bytes) {
-            if (m_buffers.front().size() <= m_basicBlockSize) {
-               m_bufferSize = 0;
-               m_head = 0;
-               m_tail = 0;
-            } else {
-               clear(); // try to minify/squeeze us
-            }
-         } else {
-            PDK_ASSERT(bytes < MAX_BYTE_ARRAY_SIZE);
-            m_tail -= static_cast<int>(bytes);
-            m_bufferSize -= bytes;
+      RingBufferChunk *chunk = m_last;
+      const pdk::pint64 blockSize = chunk->size();
+      if (blockSize > bytes) {
+         chunk->m_tail -= static_cast<int>(bytes);
+         if (chunk->m_isShared) {
+            // the bytes behind m_tail are not ours to write
+            chunk->m_capacity = chunk->m_tail;
          }
+         m_bufferSize -= bytes;
          return;
       }
-      m_bufferSize -= m_tail;
-      bytes -= m_tail;
-      m_buffers.pop_back();
-      --m_tailBuffer;
-      m_tail = m_buffers.back().size();
+      m_bufferSize -= blockSize;
+      bytes -= blockSize;
+      if (chunk == m_first) {
+         releaseEmptyChunk();
+         return;
+      }
+      m_last = chunk->m_prev;
+      m_last->m_next = nullptr;
+      release_chunk(chunk);
    }
 }
 
 void RingBuffer::clear()
 {
-   if (m_buffers.empty()) {
+   if (!m_first) {
       return;
    }
-   auto iter = m_buffers.begin();
-   ++iter;
-   m_buffers.erase(iter, m_buffers.end());
-   m_buffers.front().clear();
-   m_head = 0;
-   m_tail = 0;
-   m_tailBuffer = 0;
+   releaseChunks(m_first->m_next);
+   releaseChunks(m_spare);
+   m_spare = nullptr;
+   m_first->m_next = nullptr;
+   m_last = m_first;
    m_bufferSize = 0;
+   releaseEmptyChunk();
 }
 
 pdk::pint64 RingBuffer::indexOf(char c, pint64 maxLength, pint64 pos) const
@@ -202,11 +394,11 @@ pdk::pint64 RingBuffer::indexOf(char c, pint64 maxLength, pint64 pos) const
    if (maxLength <= 0 || pos < 0) {
       return -1;
    }
-   pdk::pint64 index = -(pos + m_head);
-   for (size_t i = 0; i < m_buffers.size(); ++i) {
-      const pdk::pint64 nextBlockIndex = std::min(index + (i == static_cast<size_t>(m_tailBuffer) ? m_tail : retrive_at(m_buffers, i).size()), maxLength);
+   pdk::pint64 index = -pos;
+   for (RingBufferChunk *chunk = m_first; chunk; chunk = chunk->m_next) {
+      const pdk::pint64 nextBlockIndex = std::min(index + chunk->size(), maxLength);
       if (nextBlockIndex > 0) {
-         const char *ptr = retrive_at(m_buffers, i).getConstRawData();
+         const char *ptr = chunk->getData() + chunk->m_head;
          if (index < 0) {
             ptr -= index;
             index = 0;
@@ -247,18 +439,14 @@ ByteArray RingBuffer::read()
    if (m_bufferSize == 0) {
       return ByteArray();
    }
-   ByteArray qba(m_buffers.front());
-   m_buffers.pop_front();
-   qba.reserve(0); // avoid that resizing needlessly reallocates
-   if (m_tailBuffer == 0) {
-      qba.resize(m_tail);
-      m_tail = 0;
+   const int blockSize = m_first->size();
+   ByteArray qba;
+   if (m_first->m_isShared && blockSize == shared_byte_array(m_first)->size()) {
+      qba = *shared_byte_array(m_first);
    } else {
-      --m_tailBuffer;
+      qba = ByteArray(m_first->getData() + m_first->m_head, blockSize);
    }
-   qba.remove(0, m_head); // does nothing if head is 0
-   m_head = 0;
-   m_bufferSize -= qba.size();
+   free(blockSize);
    return qba;
 }
 
@@ -267,12 +455,11 @@ pdk::pint64 RingBuffer::peek(char *data, pdk::pint64 maxLength, pdk::pint64 pos)
    pdk::pint64 readSoFar = 0;
    
    if (pos >= 0) {
-      pos += m_head;
-      for (size_t i = 0; readSoFar < maxLength && i < m_buffers.size(); ++i) {
-         pdk::pint64 blockLength = (i == static_cast<size_t>(m_tailBuffer) ? m_tail : retrive_at(m_buffers, i).size());
+      for (RingBufferChunk *chunk = m_first; readSoFar < maxLength && chunk; chunk = chunk->m_next) {
+         pdk::pint64 blockLength = chunk->size();
          if (pos < blockLength) {
             blockLength = std::min(blockLength - pos, maxLength - readSoFar);
-            std::memcpy(data + readSoFar, retrive_at(m_buffers, i).getConstRawData() + pos, blockLength);
+            std::memcpy(data + readSoFar, chunk->getData() + chunk->m_head + pos, blockLength);
             readSoFar += blockLength;
             pos = 0;
          } else {
@@ -285,30 +472,67 @@ pdk::pint64 RingBuffer::peek(char *data, pdk::pint64 maxLength, pdk::pint64 pos)
 
 void RingBuffer::append(const char *data, pdk::pint64 size)
 {
-   char *writePointer = reserve(size);
-   if (size == 1) {
-      *writePointer = *data;
-   } else if (size) {
-      std::memcpy(writePointer, data, size);
+   if (size <= 0) {
+      return;
+   }
+   RingBufferChunk *chunk = m_last;
+   if (size == 1 || m_basicBlockSize == 0
+       || (chunk ? chunk->m_capacity - chunk->m_tail : m_basicBlockSize) >= size) {
+      char *writePointer = reserve(size);
+      if (size == 1) {
+         *writePointer = *data;
+      } else {
+         std::memcpy(writePointer, data, size);
+      }
+      return;
+   }
+   // fill up the last chunk and go on in new ones, rather than asking for
+   // one chunk large enough that the pool does not have
+   while (size > 0) {
+      const pdk::pint64 room = chunk ? chunk->m_capacity - chunk->m_tail : 0;
+      if (room == 0) {
+         chunk = appendChunk(m_basicBlockSize);
+         continue;
+      }
+      const pdk::pint64 bytes = std::min(room, size);
+      std::memcpy(chunk->getData() + chunk->m_tail, data, bytes);
+      chunk->m_tail += static_cast<int>(bytes);
+      m_bufferSize += bytes;
+      data += bytes;
+      size -= bytes;
    }
-   
 }
 
 void RingBuffer::append(const ByteArray &qba)
 {
-   if (m_tail == 0) {
-      if (m_buffers.empty()) {
-         m_buffers.push_back(qba);
-      } else {
-         m_buffers.back() = qba;
+   const int size = qba.size();
+   if (size == 0) {
+      return;
+   }
+   // a byte array starts a new chunk, read() returns it as it was, a large
+   // one is kept by reference
+   if (size >= PDK_RING_BUFFER_SHARE_SIZE) {
+      if (m_last && m_bufferSize == 0) {
+         releaseChunks(m_first);
+         m_first = nullptr;
+         m_last = nullptr;
       }
-   } else {
-      m_buffers.back().resize(m_tail);
-      m_buffers.push_back(qba);
-      ++m_tailBuffer;
+      appendSharedChunk(qba);
+      m_bufferSize += size;
+      return;
+   }
+   if (m_last && m_last->size() != 0) {
+      appendChunk(std::max(m_basicBlockSize, size));
+   } else if (!m_last || m_last->m_capacity < size) {
+      releaseChunks(m_first);
+      m_first = nullptr;
+      m_last = nullptr;
+      appendChunk(std::max(m_basicBlockSize, size));
    }
-   m_tail = qba.size();
-   m_bufferSize += m_tail;
+   std::memcpy(m_last->getData(), qba.getConstRawData(), size);
+   m_last->m_head = 0;
+   m_last->m_tail = size;
+   m_bufferSize += size;
 }
 
 pdk::pint64 RingBuffer::readLine(char *data, pdk::pint64 maxLength)
@@ -323,6 +547,81 @@ pdk::pint64 RingBuffer::readLine(char *data, pdk::pint64 maxLength)
    return i;
 }
 
+int RingBuffer::getReadableSegments(RingBufferSegment *segments, int maxCount) const
+{
+   int count = 0;
+   for (RingBufferChunk *chunk = m_first; chunk && count < maxCount; chunk = chunk->m_next) {
+      if (chunk->size() != 0) {
+         segments[count].iov_base = chunk->getData() + chunk->m_head;
+         segments[count].iov_len = static_cast<size_t>(chunk->size());
+         ++count;
+      }
+   }
+   return count;
+}
+
+int RingBuffer::getWritableSegments(RingBufferSegment *segments, int maxCount, pdk::pint64 bytes)
+{
+   if (bytes <= 0 || maxCount <= 0) {
+      return 0;
+   }
+   int count = 0;
+   pdk::pint64 room = 0;
+   RingBufferChunk *chunk = m_last;
+   if (chunk && m_basicBlockSize != 0 && chunk->m_capacity > chunk->m_tail) {
+      segments[count].iov_base = chunk->getData() + chunk->m_tail;
+      segments[count].iov_len = static_cast<size_t>(chunk->m_capacity - chunk->m_tail);
+      room += chunk->m_capacity - chunk->m_tail;
+      ++count;
+   }
+   RingBufferChunk **link = &m_spare;
+   while (room < bytes && count < maxCount) {
+      if (!*link) {
+         *link = allocate_chunk(m_basicBlockSize != 0
+                                ? static_cast<pdk::pint64>(m_basicBlockSize)
+                                : std::min(bytes - room, static_cast<pdk::pint64>(MAX_BYTE_ARRAY_SIZE - 1)));
+      }
+      chunk = *link;
+      segments[count].iov_base = chunk->getData();
+      segments[count].iov_len = static_cast<size_t>(chunk->m_capacity);
+      room += chunk->m_capacity;
+      ++count;
+      link = &chunk->m_next;
+   }
+   return count;
+}
+
+void RingBuffer::commitWrite(pdk::pint64 bytes)
+{
+   if (bytes <= 0) {
+      return;
+   }
+   RingBufferChunk *chunk = m_last;
+   if (chunk && m_basicBlockSize != 0 && chunk->m_capacity > chunk->m_tail) {
+      const pdk::pint64 filled = std::min(bytes, static_cast<pdk::pint64>(chunk->m_capacity - chunk->m_tail));
+      chunk->m_tail += static_cast<int>(filled);
+      m_bufferSize += filled;
+      bytes -= filled;
+   }
+   while (bytes > 0) {
+      chunk = m_spare;
+      PDK_ASSERT(chunk);
+      m_spare = chunk->m_next;
+      const pdk::pint64 filled = std::min(bytes, static_cast<pdk::pint64>(chunk->m_capacity));
+      chunk->m_next = nullptr;
+      chunk->m_tail = static_cast<int>(filled);
+      chunk->m_prev = m_last;
+      if (m_last) {
+         m_last->m_next = chunk;
+      } else {
+         m_first = chunk;
+      }
+      m_last = chunk;
+      m_bufferSize += filled;
+      bytes -= filled;
+   }
+}
+
 } // internal
 } // ds
 } // pdk
@@ -27,22 +27,6 @@ const char pdkDefaultCategoryName[] = "default";
 
 PDK_GLOBAL_STATIC_WITH_ARGS(LoggingCategory, pdkDefaultCategory, (pdkDefaultCategoryName));
 
-#ifndef PDK_ATOMIC_INT8_IS_SUPPORTED
-namespace {
-
-void set_bool_lane(BasicAtomicInt *atomic, bool enable, int shift)
-{
-   const int bit = 1 << shift;
-   if (enable) {
-      atomic->fetchAndOrRelaxed(bit);
-   } else {
-      atomic->fetchAndAndRelaxed(~bit);
-   }
-}
-
-} // anonymous namespace
-#endif
-
 LoggingCategory::LoggingCategory(const char *category)
    : m_data(nullptr),
      m_name(nullptr)
@@ -59,7 +43,7 @@ LoggingCategory::LoggingCategory(const char *category, pdk::MsgType enableForLev
 
 void LoggingCategory::init(const char *category, pdk::MsgType severityLevel)
 {
-   m_enabled.store(0x01010101);   // m_enabledDebug = m_enabledWarning = m_enabledCritical = true;
+   m_enabled.store(AllBits);
    if (category) {
       m_name = category;
    } else {
@@ -96,36 +80,36 @@ bool LoggingCategory::isEnabled(pdk::MsgType msgtype) const
 
 void LoggingCategory::setEnabled(pdk::MsgType type, bool enable)
 {
+   int bit = 0;
    switch (type) {
-#ifdef PDK_ATOMIC_INT8_IS_SUPPORTED
    case pdk::MsgType::DebugMsg:
-      m_bools.m_enabledDebug.store(enable);
+      bit = DebugBit;
       break;
    case pdk::MsgType::InfoMsg:
-      m_bools.m_enabledInfo.store(enable);
+      bit = InfoBit;
       break;
    case pdk::MsgType::WarningMsg:
-      m_bools.m_enabledWarning.store(enable);
+      bit = WarningBit;
       break;
    case pdk::MsgType::CriticalMsg:
-      m_bools.m_enabledCritical.store(enable);
-      break;
-#else
-   case pdk::MsgType::DebugMsg:
-      set_bool_lane(&m_enabled, enable, DebugShift);
-      break;
-   case pdk::MsgType::InfoMsg:
-      set_bool_lane(&m_enabled, enable, InfoShift); 
+      bit = CriticalBit;
       break;
-   case pdk::MsgType::WarningMsg: 
-      set_bool_lane(&m_enabled, enable, WarningShift); 
-      break;
-   case pdk::MsgType::CriticalMsg: 
-      set_bool_lane(&m_enabled, enable, CriticalShift);
-      break;
-#endif
    case pdk::MsgType::FatalMsg:
-      break;
+      return;
+   }
+   if (enable) {
+      m_enabled.fetchAndOrRelaxed(bit);
+   } else {
+      m_enabled.fetchAndAndRelaxed(~bit);
+   }
+}
+
+void LoggingCategory::setEnabledMask(int mask)
+{
+   // skip the store when nothing changes, rule updates then leave the cache
+   // lines of unaffected categories alone
+   if (m_enabled.load() != mask) {
+      m_enabled.store(mask);
    }
 }
 
@@ -21,6 +21,9 @@
 #include "pdk/global/Logging.h"
 #include "pdk/global/GlobalStatic.h"
 #include "pdk/global/LibraryInfo.h"
+#include "pdk/base/ds/VarLengthArray.h"
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <mutex>
 
@@ -39,6 +42,8 @@ using pdk::lang::StringRef;
 using pdk::lang::String;
 using pdk::lang::Latin1String;
 using pdk::lang::Latin1Character;
+using pdk::lang::Character;
+using pdk::ds::VarLengthArray;
 using pdk::ds::ByteArray;
 using pdk::io::TextStream;
 using pdk::io::fs::Dir;
@@ -83,8 +88,8 @@ int LoggingRule::pass(const String &cat, pdk::MsgType msgType) const
             return (m_enabled ? 1 : -1);
          }
       } else if (m_flags == RightFilter) {
-         // matches right
-         if (idx == (cat.count() - m_category.count())) {
+         // matches right, the first occurrence need not be the last one
+         if (cat.endsWith(m_category)) {
             return (m_enabled ? 1 : -1);
          }
       }
@@ -135,6 +140,140 @@ void LoggingRule::parse(const StringRef &pattern)
    m_category = p.toString();
 }
 
+LoggingRuleMatcher::LoggingRuleMatcher()
+{
+   clear();
+}
+
+void LoggingRuleMatcher::clear()
+{
+   m_prefixTrie.assign(1, Node());
+   m_suffixTrie.assign(1, Node());
+   m_substringRules.clear();
+   m_ruleCount = 0;
+}
+
+int LoggingRuleMatcher::findChild(const Node &node, char c)
+{
+   for (const auto &child : node.m_children) {
+      if (child.first == c) {
+         return child.second;
+      }
+   }
+   return -1;
+}
+
+int LoggingRuleMatcher::insert(std::vector<Node> &trie, const std::string &key)
+{
+   int current = 0;
+   for (char c : key) {
+      int next = findChild(trie[current], c);
+      if (next < 0) {
+         next = static_cast<int>(trie.size());
+         trie[current].m_children.emplace_back(c, next);
+         trie.emplace_back();
+      }
+      current = next;
+   }
+   return current;
+}
+
+void LoggingRuleMatcher::addRule(const LoggingRule &rule)
+{
+   CompiledRule compiled;
+   compiled.m_order = m_ruleCount++;
+   compiled.m_enabled = rule.m_enabled;
+   switch (rule.m_messageType) {
+   case pdk::as_integer<pdk::MsgType>(pdk::MsgType::DebugMsg):
+      compiled.m_typeMask = LoggingCategory::DebugBit;
+      break;
+   case pdk::as_integer<pdk::MsgType>(pdk::MsgType::InfoMsg):
+      compiled.m_typeMask = LoggingCategory::InfoBit;
+      break;
+   case pdk::as_integer<pdk::MsgType>(pdk::MsgType::WarningMsg):
+      compiled.m_typeMask = LoggingCategory::WarningBit;
+      break;
+   case pdk::as_integer<pdk::MsgType>(pdk::MsgType::CriticalMsg):
+      compiled.m_typeMask = LoggingCategory::CriticalBit;
+      break;
+   default:
+      compiled.m_typeMask = LoggingCategory::AllBits;
+      break;
+   }
+   // category names are latin1, a pattern outside of it never matches
+   std::string pattern;
+   pattern.reserve(rule.m_category.size());
+   for (Character c : rule.m_category) {
+      if (c.unicode() > 0xff) {
+         return;
+      }
+      pattern.push_back(static_cast<char>(c.unicode()));
+   }
+   if (rule.m_flags == LoggingRule::FullText) {
+      m_prefixTrie[insert(m_prefixTrie, pattern)].m_exactRules.push_back(compiled);
+   } else if (rule.m_flags == LoggingRule::LeftFilter) {
+      m_prefixTrie[insert(m_prefixTrie, pattern)].m_anchoredRules.push_back(compiled);
+   } else if (rule.m_flags == LoggingRule::RightFilter) {
+      std::reverse(pattern.begin(), pattern.end());
+      m_suffixTrie[insert(m_suffixTrie, pattern)].m_anchoredRules.push_back(compiled);
+   } else if (rule.m_flags == LoggingRule::MidFilter) {
+      m_substringRules.emplace_back(std::move(pattern), compiled);
+   }
+}
+
+int LoggingRuleMatcher::apply(const char *categoryName, int enabledMask) const
+{
+   if (isEmpty()) {
+      return enabledMask;
+   }
+   const size_t length = std::strlen(categoryName);
+   VarLengthArray<CompiledRule, 16> matches;
+   const auto collect = [&matches](const std::vector<CompiledRule> &rules) {
+      for (const CompiledRule &rule : rules) {
+         matches.append(rule);
+      }
+   };
+   int node = 0;
+   collect(m_prefixTrie[node].m_anchoredRules);
+   size_t i = 0;
+   for (; i < length; ++i) {
+      node = findChild(m_prefixTrie[node], categoryName[i]);
+      if (node < 0) {
+         break;
+      }
+      collect(m_prefixTrie[node].m_anchoredRules);
+   }
+   if (i == length) {
+      collect(m_prefixTrie[node].m_exactRules);
+   }
+   node = 0;
+   collect(m_suffixTrie[node].m_anchoredRules);
+   for (size_t j = length; j > 0; --j) {
+      node = findChild(m_suffixTrie[node], categoryName[j - 1]);
+      if (node < 0) {
+         break;
+      }
+      collect(m_suffixTrie[node].m_anchoredRules);
+   }
+   for (const auto &rule : m_substringRules) {
+      if (std::strstr(categoryName, rule.first.c_str())) {
+         matches.append(rule.second);
+      }
+   }
+   // later rules override earlier ones
+   std::sort(matches.begin(), matches.end(), [](const CompiledRule &left, const CompiledRule &right) {
+      return left.m_order < right.m_order;
+   });
+   for (const CompiledRule &rule : matches) {
+      if (rule.m_enabled) {
+         enabledMask |= rule.m_typeMask;
+      } else {
+         enabledMask &= ~rule.m_typeMask;
+      }
+   }
+   return enabledMask;
+}
+
 void LoggingSettingsParser::setContent(const String &content)
 {
    m_rules.clear();
@@ -256,6 +395,7 @@ void LoggingRegistry::initializeRules()
    m_ruleSets[PdkConfigRules] = std::move(qr);
    m_ruleSets[ConfigRules] = std::move(cr);
    if (!m_ruleSets[EnvironmentRules].empty() || !m_ruleSets[PdkConfigRules].empty() || !m_ruleSets[ConfigRules].empty()) {
+      compileRules();
       updateRules();
    }
 }
@@ -285,9 +425,22 @@ void LoggingRegistry::setApiRules(const String &content)
    }
    const std::lock_guard<std::mutex> locker(m_registryMutex);
    m_ruleSets[ApiRules] = parser.getRules();
+   compileRules();
    updateRules();
 }
 
+void LoggingRegistry::compileRules()
+{
+   m_matcher.clear();
+   for (const auto &ruleSet : m_ruleSets) {
+      for (const auto &rule : ruleSet) {
+         m_matcher.addRule(rule);
+      }
+   }
+}
+
+// custom filters still run under m_registryMutex, a category may be
+// unregistered from its destructor at any time
 void LoggingRegistry::updateRules()
 {
    for (auto iter = m_categories.begin(), end = m_categories.end(); iter != end; ++iter)
@@ -334,32 +487,11 @@ void LoggingRegistry::defaultCategoryFilter(LoggingCategory *category)
       }  
    }
 
-   String categoryName = Latin1String(category->getCategoryName());
-
-   for (const auto &ruleSet : reg->m_ruleSets) {
-      for (const auto &rule : ruleSet) {
-         int filterpass = rule.pass(categoryName, pdk::MsgType::DebugMsg);
-         if (filterpass != 0) {
-            debug = (filterpass > 0);
-         }
-         filterpass = rule.pass(categoryName, pdk::MsgType::InfoMsg);
-         if (filterpass != 0) {
-            info = (filterpass > 0);
-         }
-         filterpass = rule.pass(categoryName, pdk::MsgType::WarningMsg);
-         if (filterpass != 0) {
-            warning = (filterpass > 0);
-         }
-         filterpass = rule.pass(categoryName, pdk::MsgType::CriticalMsg);
-         if (filterpass != 0) {
-            critical = (filterpass > 0);
-         }
-      }
-   }
-   category->setEnabled(pdk::MsgType::DebugMsg, debug);
-   category->setEnabled(pdk::MsgType::InfoMsg, info);
-   category->setEnabled(pdk::MsgType::WarningMsg, warning);
-   category->setEnabled(pdk::MsgType::CriticalMsg, critical);
+   int enabledMask = (debug ? LoggingCategory::DebugBit : 0)
+         | (info ? LoggingCategory::InfoBit : 0)
+         | (warning ? LoggingCategory::WarningBit : 0)
+         | (critical ? LoggingCategory::CriticalBit : 0);
+   category->setEnabledMask(reg->m_matcher.apply(category->getCategoryName(), enabledMask));
 }
 
 } // internal
@@ -668,18 +668,19 @@ bool FileEnginePrivate::unmap(uchar *ptr)
 {
 #if !defined(PDK_OS_INTEGRITY)
    PDK_Q(FileEngine);
-   if (m_maps.find(ptr) == m_maps.end()) {
+   auto iter = m_maps.find(ptr);
+   if (iter == m_maps.end()) {
       apiPtr->setError(File::FileError::PermissionsError, pdk::error_string(EACCES));
       return false;
    }
    
-   uchar *start = ptr - m_maps[ptr].first;
-   size_t len = m_maps[ptr].second;
+   uchar *start = ptr - iter->second.first;
+   size_t len = iter->second.second;
    if (-1 == munmap(start, len)) {
       apiPtr->setError(File::FileError::UnspecifiedError, pdk::error_string(errno));
       return false;
    }
-   m_maps.erase(ptr);
+   m_maps.erase(iter);
    return true;
 #else
    return false;
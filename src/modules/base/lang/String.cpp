@@ -18,6 +18,7 @@
 #include "pdk/base/lang/internal/StringAlgorithmsPrivate.h"
 #include "pdk/base/lang/internal/StringHelper.h"
 #include "pdk/base/lang/internal/UnicodeTablesPrivate.h"
+#include "pdk/base/lang/internal/StringSimdPrivate.h"
 #include "pdk/base/lang/StringIterator.h"
 #include "pdk/base/lang/StringBuilder.h"
 #include "pdk/base/ds/VarLengthArray.h"
@@ -62,7 +63,7 @@
 #define ULLONG_MAX pdk::puint64_C(18446744073709551615)
 #endif
 
-#define IS_RAW_DATA(d) ((d)->m_offset != sizeof(StringData))
+#define IS_RAW_DATA(d) (!(d).isInline() && (d)->m_offset != sizeof(StringData))
 
 #define REHASH(a) \
    if (slminus1 < sizeof(uint) * CHAR_BIT)  \
@@ -173,6 +174,16 @@ int unicode_stricmp(const Character *lhsBegin, const Character *lhsEnd,
    if (rhsEnd - rhsBegin < lhsEnd - lhsBegin) {
       end = lhsBegin + (rhsEnd - rhsBegin);
    }
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (end - lhsBegin >= internal::WIDE_KERNEL_MIN_LENGTH && internal::has_wide_string_kernels()) {
+      // skip the leading ASCII run, the Unicode folding picks up where it stops
+      const int skipped = internal::wide_ascii_caseless_prefix(reinterpret_cast<const char16_t *>(lhsBegin),
+                                                               reinterpret_cast<const char16_t *>(rhsBegin),
+                                                               end - lhsBegin);
+      lhsBegin += skipped;
+      rhsBegin += skipped;
+   }
+#endif
    char32_t lhsLast = 0;
    char32_t rhsLast = 0;
    while (lhsBegin < end) {
@@ -205,6 +216,15 @@ int unicode_stricmp(const Character *lhsBegin, const Character *lhsEnd, const ch
    if (rhsEnd - rhsBegin < lhsEnd - lhsBegin) {
       end = lhsBegin + (rhsEnd - rhsBegin);
    }
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (end - lhsBegin >= internal::WIDE_KERNEL_MIN_LENGTH && internal::has_wide_string_kernels()) {
+      const int skipped = internal::wide_ascii_caseless_prefix(reinterpret_cast<const char16_t *>(lhsBegin),
+                                                               reinterpret_cast<const uchar *>(rhsBegin),
+                                                               end - lhsBegin);
+      lhsBegin += skipped;
+      rhsBegin += skipped;
+   }
+#endif
    while (lhsBegin < end) {
       int diff = internal::fold_case(lhsBegin->unicode()) - internal::fold_case(static_cast<char16_t>(*rhsBegin));
       if (diff) {
@@ -236,6 +256,13 @@ int unicode_strncmp(const Character *lhs, const Character *rhs, int length)
    }
    return 0;
 #else
+#  ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (length >= internal::WIDE_KERNEL_MIN_LENGTH && internal::has_wide_string_kernels()) {
+      const int idx = internal::wide_mismatch_utf16(reinterpret_cast<const char16_t *>(lhs),
+                                                    reinterpret_cast<const char16_t *>(rhs), length);
+      return idx == length ? 0 : lhs[idx].unicode() - rhs[idx].unicode();
+   }
+#  endif
 #  ifdef __SSE2__
    const char *ptr = reinterpret_cast<const char *>(lhs);
    pdk::ptrdiff distance = reinterpret_cast<const char *>(rhs) - ptr;
@@ -314,6 +341,12 @@ int unicode_strncmp(const Character *lhs, const uchar *rhs, int length)
    const char16_t *ulhs = reinterpret_cast<const char16_t *>(lhs);
    const char16_t *end = ulhs + length;
    
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (length >= internal::WIDE_KERNEL_MIN_LENGTH && internal::has_wide_string_kernels()) {
+      const int idx = internal::wide_mismatch_latin1(ulhs, rhs, length);
+      return idx == length ? 0 : ulhs[idx] - rhs[idx];
+   }
+#endif
 #ifdef __SSE2__
    __m128i nullMask = _mm_setzero_si128();
    pdk::ptrdiff offset = 0;
@@ -330,7 +363,7 @@ int unicode_strncmp(const Character *lhs, const uchar *rhs, int length)
       uint mask = ~_mm256_movemask_epi8(result);
 #  else
       // expand via unpacking
-      __m128i firstHalf = _mm_unpackhi_epi8(chunk, nullMask);
+      __m128i firstHalf = _mm_unpacklo_epi8(chunk, nullMask);
       __m128i secondHalf = _mm_unpackhi_epi8(chunk, nullMask);
       // load UTF-16 data and compare
       __m128i lhsData1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ulhs + offset));
@@ -459,6 +492,12 @@ int find_char(const Character *str, int len, Character ch, int from,
       const char16_t *n = s + from;
       const char16_t *e = s + len;
       if (cs == pdk::CaseSensitivity::Sensitive) {
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+         if (e - n >= internal::WIDE_KERNEL_MIN_LENGTH && internal::has_wide_string_kernels()) {
+            const int idx = internal::wide_find_char16(n, e - n, c);
+            return idx < 0 ? -1 : n - s + idx;
+         }
+#endif
 #ifdef __SSE2__
          __m128i mch = _mm_set1_epi32(c | (c << 16));
          
@@ -615,6 +654,11 @@ void utf16_from_latin1(char16_t *dest, const char *str, size_t size) noexcept
     * Unpacking with SSE has been shown to improve performance on recent CPUs
     * The same method gives no improvement with NEON.
     */
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (size >= static_cast<size_t>(WIDE_KERNEL_MIN_LENGTH) && has_wide_string_kernels()) {
+      return wide_latin1_to_utf16(dest, str, static_cast<int>(size));
+   }
+#endif
 #if defined(__SSE2__)
    const char *end = str + size;
    pdk::ptrdiff offset = 0;
@@ -649,6 +693,11 @@ void utf16_from_latin1(char16_t *dest, const char *str, size_t size) noexcept
 
 void utf16_to_latin1(uchar *dest, const char16_t *src, int length)
 {
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (length >= WIDE_KERNEL_MIN_LENGTH && has_wide_string_kernels()) {
+      return wide_utf16_to_latin1(dest, src, length);
+   }
+#endif
 #if defined(__SSE2__)
    uchar *e = dest + length;
    pdk::ptrdiff offset = 0;
@@ -932,9 +981,12 @@ String::String(const Character *unicode, int size)
       }
       if (!size) {
          m_data = Data::allocate(0);
+      } else if (char16_t *data = m_data.allocateInline(size)) {
+         std::memcpy(data, unicode, size * sizeof(Character));
       } else {
-         m_data = Data::allocate(size + 1);
-         PDK_CHECK_ALLOC_PTR(m_data);
+         Data *ptr = Data::allocate(size + 1);
+         PDK_CHECK_ALLOC_PTR(ptr);
+         m_data = ptr;
          m_data->m_size = size;
          std::memcpy(m_data->getData(), unicode, size * sizeof(Character));
          m_data->getData()[size] = '\0';
@@ -944,10 +996,13 @@ String::String(const Character *unicode, int size)
 
 String::String(int size, Character c)
 {
-   m_data = Data::allocate(size + 1);
-   PDK_CHECK_ALLOC_PTR(m_data);
-   m_data->m_size = size;
-   m_data->getData()[size] = '\0';
+   if (size <= 0 || !m_data.allocateInline(size)) {
+      Data *ptr = Data::allocate(size + 1);
+      PDK_CHECK_ALLOC_PTR(ptr);
+      m_data = ptr;
+      m_data->m_size = size;
+      m_data->getData()[size] = '\0';
+   }
    char16_t *iter = m_data->getData() + size;
    char16_t *begin = m_data->getData();
    const char16_t value = c.unicode();
@@ -958,19 +1013,30 @@ String::String(int size, Character c)
 
 String::String(int size, pdk::Initialization)
 {
-   m_data = Data::allocate(size + 1);
-   PDK_CHECK_ALLOC_PTR(m_data);
-   m_data->m_size = size;
-   m_data->getData()[size] = '\0';
+   if (size <= 0 || !m_data.allocateInline(size)) {
+      Data *ptr = Data::allocate(size + 1);
+      PDK_CHECK_ALLOC_PTR(ptr);
+      m_data = ptr;
+      m_data->m_size = size;
+      m_data->getData()[size] = '\0';
+   }
 }
 
 String::String(Character c)
 {
-   m_data = Data::allocate(2);
-   PDK_CHECK_ALLOC_PTR(m_data);
-   m_data->m_size = 1;
-   m_data->getData()[0] = c.unicode();
-   m_data->getData()[1] = '\0';
+   m_data.allocateInline(1)[0] = c.unicode();
+}
+
+String::String(Latin1String other)
+{
+   const int size = other.size();
+   if (other.latin1() && size > 0) {
+      if (char16_t *data = m_data.allocateInline(size)) {
+         internal::utf16_from_latin1(data, other.latin1(), static_cast<uint>(size));
+         return;
+      }
+   }
+   m_data = fromLatin1Helper(other.latin1(), size);
 }
 
 void String::resize(int size)
@@ -982,6 +1048,12 @@ void String::resize(int size)
       m_data->m_size = size;
       return;
    }
+   // short values stay in or move into the inline buffer, nothing to copy
+   // when coming from the shared null or empty data
+   if ((m_data.isInline() || (m_data->m_ref.isStatic() && !m_data->m_size))
+       && m_data.allocateInline(size)) {
+      return;
+   }
    if (m_data->m_ref.isShared() || static_cast<uint>(size) + 1u > m_data->m_alloc) {
       reallocData(static_cast<uint>(size) + 1u, true);
    }
@@ -1014,11 +1086,11 @@ void String::reallocData(uint alloc, bool grow)
       std::memcpy(newDataPtr->getData(), m_data->getData(), newDataPtr->m_size * sizeof(Character));
       newDataPtr->getData()[newDataPtr->m_size] = '\0';
       if (!m_data->m_ref.deref()) {
-         Data::deallocate(m_data);
+         Data::deallocate(m_data.get());
       }
       m_data = newDataPtr;
    } else {
-      Data *dptr = Data::reallocateUnaligned(m_data, alloc, allocOptions);
+      Data *dptr = Data::reallocateUnaligned(m_data.get(), alloc, allocOptions);
       PDK_CHECK_ALLOC_PTR(dptr);
       m_data = dptr;
    }
@@ -1029,7 +1101,7 @@ String &String::operator =(const String &other) noexcept
    if (this != &other) {
       other.m_data->m_ref.ref();
       if (!m_data->m_ref.deref()) {
-         Data::deallocate(m_data);
+         Data::deallocate(m_data.get());
       }
       m_data = other.m_data;
    }
@@ -1129,7 +1201,7 @@ String &String::append(const String &str)
       if (m_data == Data::getSharedNull()) {
          operator =(str);
       } else {
-         if (m_data->m_ref.isShared() || static_cast<uint>(m_data->m_size + str.m_data->m_size) + 1u > m_data->m_alloc) {
+         if (!isDetached() || static_cast<uint>(m_data->m_size + str.m_data->m_size) + 1u > m_data->m_alloc) {
             reallocData(static_cast<uint>(m_data->m_size + str.m_data->m_size) + 1u, true);
          }
          std::memcpy(m_data->getData() + m_data->m_size, str.m_data->getData(), str.m_data->m_size * sizeof(Character));
@@ -1143,7 +1215,7 @@ String &String::append(const String &str)
 String &String::append(const Character *str, int length)
 {
    if (str && length > 0) {
-      if (m_data->m_ref.isShared() || static_cast<uint>(m_data->m_size + length) + 1u > m_data->m_alloc) {
+      if (!isDetached() || static_cast<uint>(m_data->m_size + length) + 1u > m_data->m_alloc) {
          reallocData(static_cast<uint>(m_data->m_size + length) + 1u, true);
       }
       std::memcpy(m_data->getData() + m_data->m_size, str, length * sizeof(Character));
@@ -1158,7 +1230,7 @@ String &String::append(Latin1String str)
    const char *rawStr = str.latin1();
    if (rawStr) {
       int len = str.size();
-      if (m_data->m_ref.isShared() || static_cast<uint>(m_data->m_size + len) + 1u > m_data->m_alloc) {
+      if (!isDetached() || static_cast<uint>(m_data->m_size + len) + 1u > m_data->m_alloc) {
          reallocData(static_cast<uint>(m_data->m_size + len) + 1u, true);
       }
       char16_t *target = m_data->getData() + m_data->m_size;
@@ -1171,7 +1243,7 @@ String &String::append(Latin1String str)
 
 String &String::append(Character ch)
 {
-   if (m_data->m_ref.isShared() || static_cast<uint>(m_data->m_size) + 2u > m_data->m_alloc) {
+   if (!isDetached() || static_cast<uint>(m_data->m_size) + 2u > m_data->m_alloc) {
       reallocData(static_cast<uint>(m_data->m_size) + 2u, true);
    }
    m_data->getData()[m_data->m_size++] = ch.unicode();
@@ -1702,6 +1774,14 @@ int internal::find_string(
    if (sl == 1) {
       return find_char(haystack0, haystackLen, needle0[0], from, cs);
    }
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   if (cs == pdk::CaseSensitivity::Sensitive && l - from >= internal::WIDE_KERNEL_MIN_LENGTH
+       && internal::has_wide_string_kernels()) {
+      const int idx = internal::wide_find_utf16(reinterpret_cast<const char16_t *>(haystack0) + from, l - from,
+                                                reinterpret_cast<const char16_t *>(needle0), sl);
+      return idx < 0 ? -1 : from + idx;
+   }
+#endif
    /*
         We use the Boyer-Moore algorithm in cases where the overhead
         for the skip table should pay off, otherwise we use a simple
@@ -1943,6 +2023,11 @@ inline int string_count(const Character *unicode, int size, Character ch,
    const ushort *b = reinterpret_cast<const ushort*>(unicode);
    const ushort *i = b + size;
    if (cs == pdk::CaseSensitivity::Sensitive) {
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+      if (size >= internal::WIDE_KERNEL_MIN_LENGTH && internal::has_wide_string_kernels()) {
+         return internal::wide_count_char16(reinterpret_cast<const char16_t *>(unicode), size, c);
+      }
+#endif
       while (i != b)
          if (*--i == c) {
             ++num;
@@ -2342,7 +2427,7 @@ using pdk::ds::ByteArrayDataPtr;
 
 ByteArray String::toLatin1HelperInplace(String &str)
 {
-   if (!str.isDetached()) {
+   if (!str.isDetached() || str.m_data.isInline()) {
       return pdk_convert_to_latin1(str);
    }
    // We can return our own buffer to the caller.
@@ -2352,7 +2437,7 @@ ByteArray String::toLatin1HelperInplace(String &str)
    
    // Swap the d pointers.
    // Kids, avert your eyes. Don't try this at home.
-   ArrayData *byteArrayData = str.m_data;
+   ArrayData *byteArrayData = str.m_data.get();
    
    // multiply the allocated capacity by sizeof(ushort)
    byteArrayData->m_alloc *= sizeof(ushort);
@@ -2408,8 +2493,9 @@ String::Data *String::fromLatin1Helper(const char *str, int size)
 String::Data *String::fromAsciiHelper(const char *str, int size)
 {
    String s = fromUtf8(str, size);
-   s.m_data->m_ref.ref();
-   return s.m_data;
+   Data *data = s.getDataPtr();
+   data->m_ref.ref();
+   return data;
 }
 
 String String::fromLocal8BitHelper(const char *str, int size)
@@ -4085,7 +4171,7 @@ String &String::setRawData(const Character *str, int size)
    } else {
       if (str) {
          m_data->m_size = size;
-         m_data->m_offset = reinterpret_cast<const char *>(str) - reinterpret_cast<char *>(m_data);
+         m_data->m_offset = reinterpret_cast<const char *>(str) - reinterpret_cast<char *>(m_data.get());
       } else {
          m_data->m_offset = sizeof(StringData);
          m_data->m_size = 0;
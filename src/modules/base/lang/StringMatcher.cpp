@@ -15,6 +15,7 @@
 
 #include "pdk/base/lang/StringMatcher.h"
 #include "pdk/base/lang/internal/StringHelper.h"
+#include "pdk/base/lang/internal/StringSimdPrivate.h"
 namespace pdk {
 namespace lang {
 
@@ -113,8 +114,8 @@ StringMatcher::StringMatcher(const String &pattern, pdk::CaseSensitivity cs)
      m_pattern(pattern),
      m_cs(cs)
 {
-   m_p.m_uc = pattern.unicode();
-   m_p.m_len = pattern.size();
+   m_p.m_uc = m_pattern.unicode();
+   m_p.m_len = m_pattern.size();
    bm_init_skiptable(reinterpret_cast<const char16_t *>(m_p.m_uc), m_p.m_len, m_p.m_skiptable, cs);
 }
 
@@ -144,6 +145,10 @@ StringMatcher &StringMatcher::operator=(const StringMatcher &other)
       m_pattern = other.m_pattern;
       m_cs = other.m_cs;
       std::memcpy(m_data, other.m_data, sizeof(m_data));
+      // a short pattern is stored inside other, point to our own copy
+      if (!m_pattern.isNull()) {
+         m_p.m_uc = m_pattern.unicode();
+      }
    }
    return *this;
 }
@@ -151,9 +156,9 @@ StringMatcher &StringMatcher::operator=(const StringMatcher &other)
 void StringMatcher::setPattern(const String &pattern)
 {
    m_pattern = pattern;
-   m_p.m_uc = pattern.unicode();
-   m_p.m_len = pattern.size();
-   bm_init_skiptable(reinterpret_cast<const char16_t *>(pattern.unicode()), pattern.size(), m_p.m_skiptable, m_cs);
+   m_p.m_uc = m_pattern.unicode();
+   m_p.m_len = m_pattern.size();
+   bm_init_skiptable(reinterpret_cast<const char16_t *>(m_p.m_uc), m_p.m_len, m_p.m_skiptable, m_cs);
 }
 
 String StringMatcher::getPattern() const
@@ -175,12 +180,7 @@ void StringMatcher::setCaseSensitivity(pdk::CaseSensitivity cs)
 
 int StringMatcher::indexIn(const String &str, int from) const
 {
-   if (from < 0) {
-      from = 0;
-   }
-   return bm_find(reinterpret_cast<const char16_t *>(str.unicode()), str.size(), from,
-                  reinterpret_cast<const char16_t *>(m_p.m_uc), m_p.m_len,
-                  m_p.m_skiptable, m_cs);
+   return indexIn(str.unicode(), str.size(), from);
 }
 
 int StringMatcher::indexIn(const Character *str, int length, int from) const
@@ -188,6 +188,17 @@ int StringMatcher::indexIn(const Character *str, int length, int from) const
    if (from < 0) {
       from = 0;
    }
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+   // the wide kernels only verify the positions where both the first and
+   // the last pattern unit match, no skip table needed
+   if (m_cs == pdk::CaseSensitivity::Sensitive && m_p.m_len >= 2
+       && length - from >= std::max(m_p.m_len, internal::WIDE_KERNEL_MIN_LENGTH)
+       && internal::has_wide_string_kernels()) {
+      const int idx = internal::wide_find_utf16(reinterpret_cast<const char16_t *>(str) + from, length - from,
+                                                reinterpret_cast<const char16_t *>(m_p.m_uc), m_p.m_len);
+      return idx < 0 ? -1 : from + idx;
+   }
+#endif
    return bm_find(reinterpret_cast<const char16_t *>(str), length, from,
                   reinterpret_cast<const char16_t *>(m_p.m_uc), m_p.m_len,
                   m_p.m_skiptable, m_cs);
@@ -0,0 +1,591 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/base/lang/internal/StringSimdPrivate.h"
+#include "pdk/kernel/Algorithms.h"
+#include <cstring>
+
+#ifdef PDK_HAVE_WIDE_STRING_KERNELS
+
+#if PDK_COMPILER_SUPPORTS(AVX512BW)
+#  define PDK_HAVE_AVX512BW_STRING_KERNELS
+#endif
+
+namespace pdk {
+namespace lang {
+namespace internal {
+
+using namespace pdk::pal::kernel;
+
+namespace {
+
+inline bool use_avx512bw()
+{
+#ifdef PDK_HAVE_AVX512BW_STRING_KERNELS
+   return CPU_HAS_FEATURE(AVX512BW);
+#else
+   return false;
+#endif
+}
+
+inline char16_t ascii_fold(char16_t ch)
+{
+   return (ch >= 'A' && ch <= 'Z') ? ch | 0x20 : ch;
+}
+
+// a 16-bit lane compare sets two bits per code unit in the movemask, keep one
+constexpr uint EVEN_BYTE_BITS = 0x55555555u;
+
+/////////////////////////////////////////////////////////////////////////
+// AVX2, 32 bytes per step
+/////////////////////////////////////////////////////////////////////////
+
+PDK_FUNCTION_TARGET(AVX2)
+int find_char16_avx2(const char16_t *str, int length, char16_t ch)
+{
+   const __m256i needle = _mm256_set1_epi16(static_cast<short>(ch));
+   int i = 0;
+   for (; i + 16 <= length; i += 16) {
+      const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i));
+      const uint mask = _mm256_movemask_epi8(_mm256_cmpeq_epi16(data, needle));
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask) / 2;
+      }
+   }
+   for (; i < length; ++i) {
+      if (str[i] == ch) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+int find_byte_avx2(const char *str, int length, char ch)
+{
+   const __m256i needle = _mm256_set1_epi8(ch);
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i));
+      const uint mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(data, needle));
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask);
+      }
+   }
+   for (; i < length; ++i) {
+      if (str[i] == ch) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+int count_char16_avx2(const char16_t *str, int length, char16_t ch)
+{
+   const __m256i needle = _mm256_set1_epi16(static_cast<short>(ch));
+   int count = 0;
+   int i = 0;
+   for (; i + 16 <= length; i += 16) {
+      const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i));
+      const uint mask = _mm256_movemask_epi8(_mm256_cmpeq_epi16(data, needle));
+      count += pdk::population_count(mask & EVEN_BYTE_BITS);
+   }
+   for (; i < length; ++i) {
+      count += str[i] == ch;
+   }
+   return count;
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+int count_byte_avx2(const char *str, int length, char ch)
+{
+   const __m256i needle = _mm256_set1_epi8(ch);
+   int count = 0;
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i));
+      const uint mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(data, needle));
+      count += pdk::population_count(mask);
+   }
+   for (; i < length; ++i) {
+      count += str[i] == ch;
+   }
+   return count;
+}
+
+// The first/last filter: compare the first and the last needle unit against
+// two shifted views of the haystack and only verify the candidates where both
+// match. For real text that leaves very few candidates per block.
+PDK_FUNCTION_TARGET(AVX2)
+int find_utf16_avx2(const char16_t *haystack, int haystackLength,
+                    const char16_t *needle, int needleLength)
+{
+   const __m256i first = _mm256_set1_epi16(static_cast<short>(needle[0]));
+   const __m256i last = _mm256_set1_epi16(static_cast<short>(needle[needleLength - 1]));
+   const size_t middleBytes = (needleLength - 2) * sizeof(char16_t);
+   const int lastStart = haystackLength - needleLength;
+   int i = 0;
+   for (; i + 16 <= lastStart + 1; i += 16) {
+      const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+      const __m256i blockLast = _mm256_loadu_si256(
+               reinterpret_cast<const __m256i *>(haystack + i + needleLength - 1));
+      const __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi16(blockFirst, first),
+                                            _mm256_cmpeq_epi16(blockLast, last));
+      uint mask = _mm256_movemask_epi8(hits) & EVEN_BYTE_BITS;
+      while (mask) {
+         const int pos = i + pdk::count_trailing_zero_bits(mask) / 2;
+         if (std::memcmp(haystack + pos + 1, needle + 1, middleBytes) == 0) {
+            return pos;
+         }
+         mask &= mask - 1;
+      }
+   }
+   for (; i <= lastStart; ++i) {
+      if (haystack[i] == needle[0]
+          && std::memcmp(haystack + i, needle, needleLength * sizeof(char16_t)) == 0) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+int find_bytes_avx2(const char *haystack, int haystackLength,
+                    const char *needle, int needleLength)
+{
+   const __m256i first = _mm256_set1_epi8(needle[0]);
+   const __m256i last = _mm256_set1_epi8(needle[needleLength - 1]);
+   const int lastStart = haystackLength - needleLength;
+   int i = 0;
+   for (; i + 32 <= lastStart + 1; i += 32) {
+      const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+      const __m256i blockLast = _mm256_loadu_si256(
+               reinterpret_cast<const __m256i *>(haystack + i + needleLength - 1));
+      const __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first),
+                                            _mm256_cmpeq_epi8(blockLast, last));
+      uint mask = _mm256_movemask_epi8(hits);
+      while (mask) {
+         const int pos = i + pdk::count_trailing_zero_bits(mask);
+         if (std::memcmp(haystack + pos + 1, needle + 1, needleLength - 2) == 0) {
+            return pos;
+         }
+         mask &= mask - 1;
+      }
+   }
+   for (; i <= lastStart; ++i) {
+      if (haystack[i] == needle[0] && std::memcmp(haystack + i, needle, needleLength) == 0) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+int mismatch_utf16_avx2(const char16_t *lhs, const char16_t *rhs, int length)
+{
+   int i = 0;
+   for (; i + 16 <= length; i += 16) {
+      const __m256i lhsData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i));
+      const __m256i rhsData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+      const uint mask = ~_mm256_movemask_epi8(_mm256_cmpeq_epi16(lhsData, rhsData));
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask) / 2;
+      }
+   }
+   for (; i < length; ++i) {
+      if (lhs[i] != rhs[i]) {
+         return i;
+      }
+   }
+   return length;
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+int mismatch_latin1_avx2(const char16_t *lhs, const uchar *rhs, int length)
+{
+   int i = 0;
+   for (; i + 16 <= length; i += 16) {
+      const __m256i lhsData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i));
+      // expand Latin 1 data via zero extension
+      const __m256i rhsData = _mm256_cvtepu8_epi16(
+               _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + i)));
+      const uint mask = ~_mm256_movemask_epi8(_mm256_cmpeq_epi16(lhsData, rhsData));
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask) / 2;
+      }
+   }
+   for (; i < length; ++i) {
+      if (lhs[i] != rhs[i]) {
+         return i;
+      }
+   }
+   return length;
+}
+
+// lanes of lhs and rhs that are both ASCII and equal once 'A'-'Z' are
+// lowered, as a byte mask
+PDK_FUNCTION_TARGET(AVX2)
+inline uint ascii_caseless_equal_avx2(__m256i lhs, __m256i rhs)
+{
+   const __m256i nonAscii = _mm256_set1_epi16(static_cast<short>(0xff80));
+   const __m256i beforeUpper = _mm256_set1_epi16('A' - 1);
+   const __m256i afterUpper = _mm256_set1_epi16('Z' + 1);
+   const __m256i caseBit = _mm256_set1_epi16(0x20);
+   const __m256i ascii = _mm256_cmpeq_epi16(
+            _mm256_and_si256(_mm256_or_si256(lhs, rhs), nonAscii), _mm256_setzero_si256());
+   // the signed compares are fine, lanes at or above 0x8000 are not ASCII
+   const __m256i lhsUpper = _mm256_and_si256(_mm256_cmpgt_epi16(lhs, beforeUpper),
+                                             _mm256_cmpgt_epi16(afterUpper, lhs));
+   const __m256i rhsUpper = _mm256_and_si256(_mm256_cmpgt_epi16(rhs, beforeUpper),
+                                             _mm256_cmpgt_epi16(afterUpper, rhs));
+   lhs = _mm256_or_si256(lhs, _mm256_and_si256(lhsUpper, caseBit));
+   rhs = _mm256_or_si256(rhs, _mm256_and_si256(rhsUpper, caseBit));
+   return _mm256_movemask_epi8(_mm256_and_si256(ascii, _mm256_cmpeq_epi16(lhs, rhs)));
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+int ascii_caseless_prefix_avx2(const char16_t *lhs, const char16_t *rhs, int length)
+{
+   int i = 0;
+   for (; i + 16 <= length; i += 16) {
+      const __m256i lhsData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i));
+      const __m256i rhsData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+      const uint mask = ~ascii_caseless_equal_avx2(lhsData, rhsData);
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask) / 2;
+      }
+   }
+   for (; i < length; ++i) {
+      if (lhs[i] >= 0x80 || rhs[i] >= 0x80 || ascii_fold(lhs[i]) != ascii_fold(rhs[i])) {
+         return i;
+      }
+   }
+   return length;
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+int ascii_caseless_prefix_avx2(const char16_t *lhs, const uchar *rhs, int length)
+{
+   int i = 0;
+   for (; i + 16 <= length; i += 16) {
+      const __m256i lhsData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i));
+      const __m256i rhsData = _mm256_cvtepu8_epi16(
+               _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + i)));
+      const uint mask = ~ascii_caseless_equal_avx2(lhsData, rhsData);
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask) / 2;
+      }
+   }
+   for (; i < length; ++i) {
+      if (lhs[i] >= 0x80 || rhs[i] >= 0x80 || ascii_fold(lhs[i]) != ascii_fold(rhs[i])) {
+         return i;
+      }
+   }
+   return length;
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+void latin1_to_utf16_avx2(char16_t *dest, const char *str, int length)
+{
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      const __m128i chunk1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str + i));
+      const __m128i chunk2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str + i + 16));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), _mm256_cvtepu8_epi16(chunk1));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i + 16), _mm256_cvtepu8_epi16(chunk2));
+   }
+   for (; i < length; ++i) {
+      dest[i] = static_cast<uchar>(str[i]);
+   }
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+void utf16_to_latin1_avx2(uchar *dest, const char16_t *src, int length)
+{
+   const __m256i latin1Max = _mm256_set1_epi16(0xff);
+   const __m256i questionMark = _mm256_set1_epi16('?');
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      __m256i chunk1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      __m256i chunk2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 16));
+      // the lanes that survive clamping to 0xff are the Latin 1 ones
+      chunk1 = _mm256_blendv_epi8(questionMark, chunk1,
+                                  _mm256_cmpeq_epi16(_mm256_min_epu16(chunk1, latin1Max), chunk1));
+      chunk2 = _mm256_blendv_epi8(questionMark, chunk2,
+                                  _mm256_cmpeq_epi16(_mm256_min_epu16(chunk2, latin1Max), chunk2));
+      // packus works per 128-bit lane, put the quadwords back in order
+      const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(chunk1, chunk2),
+                                                      _MM_SHUFFLE(3, 1, 2, 0));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), packed);
+   }
+   for (; i < length; ++i) {
+      dest[i] = src[i] > 0xff ? '?' : static_cast<uchar>(src[i]);
+   }
+}
+
+#ifdef PDK_HAVE_AVX512BW_STRING_KERNELS
+
+/////////////////////////////////////////////////////////////////////////
+// AVX-512BW, 64 bytes per step, the tails go through the AVX2 kernels
+/////////////////////////////////////////////////////////////////////////
+
+PDK_FUNCTION_TARGET(AVX512BW)
+int find_char16_avx512(const char16_t *str, int length, char16_t ch)
+{
+   const __m512i needle = _mm512_set1_epi16(static_cast<short>(ch));
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      const __m512i data = _mm512_loadu_si512(str + i);
+      const puint32 mask = _mm512_cmpeq_epi16_mask(data, needle);
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask);
+      }
+   }
+   const int pos = find_char16_avx2(str + i, length - i, ch);
+   return pos < 0 ? -1 : i + pos;
+}
+
+PDK_FUNCTION_TARGET(AVX512BW)
+int find_byte_avx512(const char *str, int length, char ch)
+{
+   const __m512i needle = _mm512_set1_epi8(ch);
+   int i = 0;
+   for (; i + 64 <= length; i += 64) {
+      const __m512i data = _mm512_loadu_si512(str + i);
+      const puint64 mask = _mm512_cmpeq_epi8_mask(data, needle);
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask);
+      }
+   }
+   const int pos = find_byte_avx2(str + i, length - i, ch);
+   return pos < 0 ? -1 : i + pos;
+}
+
+PDK_FUNCTION_TARGET(AVX512BW)
+int count_char16_avx512(const char16_t *str, int length, char16_t ch)
+{
+   const __m512i needle = _mm512_set1_epi16(static_cast<short>(ch));
+   int count = 0;
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      const __m512i data = _mm512_loadu_si512(str + i);
+      count += pdk::population_count(static_cast<puint32>(_mm512_cmpeq_epi16_mask(data, needle)));
+   }
+   return count + count_char16_avx2(str + i, length - i, ch);
+}
+
+PDK_FUNCTION_TARGET(AVX512BW)
+int count_byte_avx512(const char *str, int length, char ch)
+{
+   const __m512i needle = _mm512_set1_epi8(ch);
+   int count = 0;
+   int i = 0;
+   for (; i + 64 <= length; i += 64) {
+      const __m512i data = _mm512_loadu_si512(str + i);
+      count += pdk::population_count(static_cast<puint64>(_mm512_cmpeq_epi8_mask(data, needle)));
+   }
+   return count + count_byte_avx2(str + i, length - i, ch);
+}
+
+PDK_FUNCTION_TARGET(AVX512BW)
+int find_utf16_avx512(const char16_t *haystack, int haystackLength,
+                      const char16_t *needle, int needleLength)
+{
+   const __m512i first = _mm512_set1_epi16(static_cast<short>(needle[0]));
+   const __m512i last = _mm512_set1_epi16(static_cast<short>(needle[needleLength - 1]));
+   const size_t middleBytes = (needleLength - 2) * sizeof(char16_t);
+   const int lastStart = haystackLength - needleLength;
+   int i = 0;
+   for (; i + 32 <= lastStart + 1; i += 32) {
+      const __m512i blockFirst = _mm512_loadu_si512(haystack + i);
+      const __m512i blockLast = _mm512_loadu_si512(haystack + i + needleLength - 1);
+      puint32 mask = _mm512_mask_cmpeq_epi16_mask(_mm512_cmpeq_epi16_mask(blockFirst, first),
+                                                  blockLast, last);
+      while (mask) {
+         const int pos = i + pdk::count_trailing_zero_bits(mask);
+         if (std::memcmp(haystack + pos + 1, needle + 1, middleBytes) == 0) {
+            return pos;
+         }
+         mask &= mask - 1;
+      }
+   }
+   const int pos = find_utf16_avx2(haystack + i, haystackLength - i, needle, needleLength);
+   return pos < 0 ? -1 : i + pos;
+}
+
+PDK_FUNCTION_TARGET(AVX512BW)
+int find_bytes_avx512(const char *haystack, int haystackLength,
+                      const char *needle, int needleLength)
+{
+   const __m512i first = _mm512_set1_epi8(needle[0]);
+   const __m512i last = _mm512_set1_epi8(needle[needleLength - 1]);
+   const int lastStart = haystackLength - needleLength;
+   int i = 0;
+   for (; i + 64 <= lastStart + 1; i += 64) {
+      const __m512i blockFirst = _mm512_loadu_si512(haystack + i);
+      const __m512i blockLast = _mm512_loadu_si512(haystack + i + needleLength - 1);
+      puint64 mask = _mm512_mask_cmpeq_epi8_mask(_mm512_cmpeq_epi8_mask(blockFirst, first),
+                                                 blockLast, last);
+      while (mask) {
+         const int pos = i + pdk::count_trailing_zero_bits(mask);
+         if (std::memcmp(haystack + pos + 1, needle + 1, needleLength - 2) == 0) {
+            return pos;
+         }
+         mask &= mask - 1;
+      }
+   }
+   const int pos = find_bytes_avx2(haystack + i, haystackLength - i, needle, needleLength);
+   return pos < 0 ? -1 : i + pos;
+}
+
+PDK_FUNCTION_TARGET(AVX512BW)
+int mismatch_utf16_avx512(const char16_t *lhs, const char16_t *rhs, int length)
+{
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      const puint32 mask = _mm512_cmpneq_epi16_mask(_mm512_loadu_si512(lhs + i),
+                                                    _mm512_loadu_si512(rhs + i));
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask);
+      }
+   }
+   return i + mismatch_utf16_avx2(lhs + i, rhs + i, length - i);
+}
+
+PDK_FUNCTION_TARGET(AVX512BW)
+int mismatch_latin1_avx512(const char16_t *lhs, const uchar *rhs, int length)
+{
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      const __m512i rhsData = _mm512_cvtepu8_epi16(
+               _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i)));
+      const puint32 mask = _mm512_cmpneq_epi16_mask(_mm512_loadu_si512(lhs + i), rhsData);
+      if (mask) {
+         return i + pdk::count_trailing_zero_bits(mask);
+      }
+   }
+   return i + mismatch_latin1_avx2(lhs + i, rhs + i, length - i);
+}
+
+PDK_FUNCTION_TARGET(AVX512BW)
+void latin1_to_utf16_avx512(char16_t *dest, const char *str, int length)
+{
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i));
+      _mm512_storeu_si512(dest + i, _mm512_cvtepu8_epi16(chunk));
+   }
+   latin1_to_utf16_avx2(dest + i, str + i, length - i);
+}
+
+PDK_FUNCTION_TARGET(AVX512BW)
+void utf16_to_latin1_avx512(uchar *dest, const char16_t *src, int length)
+{
+   const __m512i latin1Max = _mm512_set1_epi16(0xff);
+   const __m512i questionMark = _mm512_set1_epi16('?');
+   int i = 0;
+   for (; i + 32 <= length; i += 32) {
+      const __m512i chunk = _mm512_loadu_si512(src + i);
+      const __mmask32 latin1 = _mm512_cmple_epu16_mask(chunk, latin1Max);
+      const __m512i merged = _mm512_mask_blend_epi16(latin1, questionMark, chunk);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), _mm512_cvtepi16_epi8(merged));
+   }
+   utf16_to_latin1_avx2(dest + i, src + i, length - i);
+}
+
+#endif // PDK_HAVE_AVX512BW_STRING_KERNELS
+
+} // anonymous namespace
+
+#ifdef PDK_HAVE_AVX512BW_STRING_KERNELS
+#  define PDK_DISPATCH_STRING_KERNEL(name, ...) \
+   (use_avx512bw() ? name##_avx512(__VA_ARGS__) : name##_avx2(__VA_ARGS__))
+#else
+#  define PDK_DISPATCH_STRING_KERNEL(name, ...) name##_avx2(__VA_ARGS__)
+#endif
+
+int wide_find_char16(const char16_t *str, int length, char16_t ch) noexcept
+{
+   return PDK_DISPATCH_STRING_KERNEL(find_char16, str, length, ch);
+}
+
+int wide_find_byte(const char *str, int length, char ch) noexcept
+{
+   return PDK_DISPATCH_STRING_KERNEL(find_byte, str, length, ch);
+}
+
+int wide_count_char16(const char16_t *str, int length, char16_t ch) noexcept
+{
+   return PDK_DISPATCH_STRING_KERNEL(count_char16, str, length, ch);
+}
+
+int wide_count_byte(const char *str, int length, char ch) noexcept
+{
+   return PDK_DISPATCH_STRING_KERNEL(count_byte, str, length, ch);
+}
+
+int wide_find_utf16(const char16_t *haystack, int haystackLength,
+                    const char16_t *needle, int needleLength) noexcept
+{
+   PDK_ASSERT(needleLength >= 2);
+   return PDK_DISPATCH_STRING_KERNEL(find_utf16, haystack, haystackLength, needle, needleLength);
+}
+
+int wide_find_bytes(const char *haystack, int haystackLength,
+                    const char *needle, int needleLength) noexcept
+{
+   PDK_ASSERT(needleLength >= 2);
+   return PDK_DISPATCH_STRING_KERNEL(find_bytes, haystack, haystackLength, needle, needleLength);
+}
+
+int wide_mismatch_utf16(const char16_t *lhs, const char16_t *rhs, int length) noexcept
+{
+   return PDK_DISPATCH_STRING_KERNEL(mismatch_utf16, lhs, rhs, length);
+}
+
+int wide_mismatch_latin1(const char16_t *lhs, const uchar *rhs, int length) noexcept
+{
+   return PDK_DISPATCH_STRING_KERNEL(mismatch_latin1, lhs, rhs, length);
+}
+
+int wide_ascii_caseless_prefix(const char16_t *lhs, const char16_t *rhs, int length) noexcept
+{
+   // the case folding kernel only comes in an AVX2 flavour
+   return ascii_caseless_prefix_avx2(lhs, rhs, length);
+}
+
+int wide_ascii_caseless_prefix(const char16_t *lhs, const uchar *rhs, int length) noexcept
+{
+   return ascii_caseless_prefix_avx2(lhs, rhs, length);
+}
+
+void wide_latin1_to_utf16(char16_t *dest, const char *str, int length) noexcept
+{
+   PDK_DISPATCH_STRING_KERNEL(latin1_to_utf16, dest, str, length);
+}
+
+void wide_utf16_to_latin1(uchar *dest, const char16_t *src, int length) noexcept
+{
+   PDK_DISPATCH_STRING_KERNEL(utf16_to_latin1, dest, src, length);
+}
+
+#undef PDK_DISPATCH_STRING_KERNEL
+
+} // internal
+} // lang
+} // pdk
+
+#endif // PDK_HAVE_WIDE_STRING_KERNELS
@@ -432,11 +432,7 @@ bool ProcessPrivate::tryReadFromChannel(Channel *channel)
                                          : Process::ProcessChannel::StandardError);
    PDK_ASSERT(m_readBuffers.size() > size_t(channelIdx));
    RingBuffer &readBuffer = m_readBuffers[int(channelIdx)];
-   char *ptr = readBuffer.reserve(available);
-   pdk::pint64 readBytes = readFromChannel(channel, ptr, available);
-   if (readBytes <= 0) {
-      readBuffer.chop(available);
-   }
+   pdk::pint64 readBytes = readFromChannel(channel, readBuffer, available);
    if (readBytes == -2) {
       // EWOULDBLOCK
       return false;
@@ -471,8 +467,6 @@ bool ProcessPrivate::tryReadFromChannel(Channel *channel)
       return false;
    }
    
-   readBuffer.chop(available - readBytes);
-   
    bool didRead = false;
    if (m_currentReadChannel == pdk::as_integer<Process::ProcessChannel>(channelIdx)) {
       didRead = true;
@@ -62,6 +62,13 @@ using pdk::io::fs::StandardPaths;
 using pdk::lang::Latin1Character;
 using pdk::lang::Latin1String;
 using pdk::kernel::ElapsedTimer;
+using pdk::ds::internal::RingBuffer;
+using pdk::ds::internal::RingBufferSegment;
+
+namespace {
+// segments per readv() and writev(), well below any IOV_MAX
+constexpr int sg_maxIoSegments = 16;
+} // anonymous namespace
 
 #if defined(PDK_PROCESS_DEBUG)
 /*
@@ -609,32 +616,35 @@ pdk::pint64 ProcessPrivate::bytesAvailableInChannel(const Channel *channel) cons
    return available;
 }
 
-pdk::pint64 ProcessPrivate::readFromChannel(const Channel *channel, char *data, pdk::pint64 maxlen)
+pdk::pint64 ProcessPrivate::readFromChannel(const Channel *channel, RingBuffer &buffer, pdk::pint64 maxLength)
 {
    PDK_ASSERT(channel->m_pipe[0] != INVALID_PDK_PIPE);
-   pdk::pint64 bytesRead = pdk::kernel::safe_read(channel->m_pipe[0], data, maxlen);
+   // straight into the chunks of the buffer, however many it takes
+   RingBufferSegment segments[sg_maxIoSegments];
+   const int count = buffer.getWritableSegments(segments, sg_maxIoSegments, maxLength);
+   pdk::pint64 bytesRead = pdk::kernel::safe_readv(channel->m_pipe[0], segments, count);
 #if defined PDK_PROCESS_DEBUG
    int save_errno = errno;
-   debug_stream("ProcessPrivate::readFromChannel(%d, %p \"%s\", %lld) == %lld",
-                int(channel - &stdinChannel),
-                data, pretty_debug(data, bytesRead, 16).getConstRawData(), maxlen, bytesRead);
+   debug_stream("ProcessPrivate::readFromChannel(%d, %lld) == %lld",
+                int(channel - &m_stdinChannel), maxLength, bytesRead);
    errno = save_errno;
 #endif
    if (bytesRead == -1 && errno == EWOULDBLOCK) {
       return -2;
    }
+   if (bytesRead > 0) {
+      buffer.commitWrite(bytesRead);
+   }
    return bytesRead;
 }
 
 bool ProcessPrivate::writeToStdin()
 {
-   const char *data = m_writeBuffer.readPointer();
-   const pdk::pint64 bytesToWrite = m_writeBuffer.nextDataBlockSize();
-   
-   pdk::pint64 written = pdk::kernel::safe_write_nosignal(m_stdinChannel.m_pipe[1], data, bytesToWrite);
+   RingBufferSegment segments[sg_maxIoSegments];
+   const int count = m_writeBuffer.getReadableSegments(segments, sg_maxIoSegments);
+   pdk::pint64 written = pdk::kernel::safe_writev_nosignal(m_stdinChannel.m_pipe[1], segments, count);
 #if defined PDK_PROCESS_DEBUG
-   debug_stream("ProcessPrivate::writeToStdin(), write(%p \"%s\", %lld) == %lld",
-                data, pretty_debug(data, bytesToWrite, 16).getConstRawData(), bytesToWrite, written);
+   debug_stream("ProcessPrivate::writeToStdin(), writev(%d segments) == %lld", count, written);
    if (written == -1)
       debug_stream("ProcessPrivate::writeToStdin(), failed to write (%s)", pdk_printable(qt_error_string(errno)));
 #endif
@@ -169,7 +169,7 @@ bool ReadWriteLockPrivate::recursiveLockForRead(int timeout)
    PDK_ASSERT(m_recursive);
    std::unique_lock<std::mutex> locker(m_mutex);
    pdk::HANDLE self = Thread::getCurrentThreadId();
-   std::map<pdk::HANDLE, int>::iterator iter = m_currentReaders.find(self);
+   auto iter = m_currentReaders.find(self);
    if (iter != m_currentReaders.end()) {
       iter->second = iter->second + 1;
       return true;
@@ -208,7 +208,7 @@ void ReadWriteLockPrivate::recursiveUnlock()
       }
       m_writerCount = 0;
    } else {
-      std::map<pdk::HANDLE, int>::iterator iter = m_currentReaders.find(self);
+      auto iter = m_currentReaders.find(self);
       if (iter == m_currentReaders.end()) {
          // @TODO warning("ReadWriteLock::unlock: unlocking from a thread that did not lock");
          std::cerr << "ReadWriteLock::unlock: unlocking from a thread that did not lock" << std::endl;
@@ -61,6 +61,7 @@ ThreadData::~ThreadData()
    Thread *tempPtr = m_thread;
    m_thread = nullptr;
    delete tempPtr;
+   drainPostEventIntake();
    for (size_t i = 0; i < m_postEventList.size(); ++i) {
       const PostEvent &postEvent = m_postEventList.at(i);
       if (postEvent.m_event) {
@@ -71,6 +72,34 @@ ThreadData::~ThreadData()
    }
 }
 
+void ThreadData::drainPostEventIntake()
+{
+   PostEventList::IntakeNode *node = m_postEventList.takeIntake();
+   while (node) {
+      PostEventList::IntakeNode *next = node->m_next;
+      ThreadData *data = node->m_receiver->getImplPtr()->m_threadData;
+      if (data == this) {
+         m_postEventList.addEvent(PostEvent(node->m_receiver, node->m_event,
+                                            pdk::as_integer<pdk::EventPriority>(pdk::EventPriority::NormalEventPriority)));
+         ++node->m_receiver->getImplPtr()->m_postedEvents;
+         delete node;
+      } else if (data) {
+         // the receiver was moved to another thread while the event was
+         // on its way, pass it on
+         data->m_postEventList.pushIntake(node);
+         AbstractEventDispatcher *dispatcher = data->m_eventDispatcher.loadAcquire();
+         if (dispatcher) {
+            dispatcher->wakeUp();
+         }
+      } else {
+         node->m_event->m_posted = false;
+         delete node->m_event;
+         delete node;
+      }
+      node = next;
+   }
+}
+
 void ThreadData::ref()
 {
    (void) m_ref.ref();
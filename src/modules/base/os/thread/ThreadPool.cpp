@@ -23,6 +23,8 @@
 #include "pdk/stdext/utility/Algorithms.h"
 #include <algorithm>
 #include <chrono>
+#include <thread>
+#include <vector>
 
 namespace pdk {
 namespace os {
@@ -30,6 +32,7 @@ namespace thread {
 
 using internal::ThreadPoolPrivate;
 using internal::QueuePage;
+using internal::WorkStealingDeque;
 using pdk::lang::Latin1String;
 using pdk::kernel::ElapsedTimer;
 
@@ -45,22 +48,84 @@ class ThreadPoolThread : public Thread
 public:
    ThreadPoolThread(ThreadPoolPrivate *manager);
    void run() override;
+   void runWorkStealing();
+   void runTask(Runnable *runnable);
+   void backOff(std::unique_lock<std::mutex> &locker, int &idleRounds);
    void registerThreadInactive();
+   pdk::puint32 nextRandom();
    
    std::condition_variable m_runnableReady;
    ThreadPoolPrivate *m_manager;
    Runnable *m_runnable;
+   // per priority lane deques, only used by the work stealing scheduler
+   WorkStealingDeque m_lanes[ThreadPoolPrivate::LaneCount];
+   bool m_isStealVictim;
+   pdk::puint32 m_randomState;
 };
 
+namespace {
+// the pool worker running on the current thread, if any
+thread_local ThreadPoolThread *sg_currentPoolThread = nullptr;
+} // anonymous namespace
+
 ThreadPoolThread::ThreadPoolThread(ThreadPoolPrivate *manager)
    : m_manager(manager),
-     m_runnable(nullptr)
+     m_runnable(nullptr),
+     m_isStealVictim(false),
+     m_randomState(static_cast<pdk::puint32>(reinterpret_cast<pdk::uintptr>(this) >> 4) | 1)
 {
    setStackSize(manager->m_stackSize);
 }
 
+pdk::puint32 ThreadPoolThread::nextRandom()
+{
+   // xorshift32, only used to pick a steal victim
+   pdk::puint32 x = m_randomState;
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   m_randomState = x;
+   return x;
+}
+
+void ThreadPoolThread::runTask(Runnable *runnable)
+{
+   const bool autoDelete = runnable->autoDelete();
+   try {
+      runnable->run();
+   } catch (...) {
+      warning_stream("ThreadPool: a Runnable threw an exception out of run().\n"
+                     "Exceptions must be caught inside Runnable::run(), the pool\n"
+                     "cannot recover the worker thread they escape from.");
+      std::lock_guard<std::mutex> locker(m_manager->m_mutex);
+      registerThreadInactive();
+      throw;
+   }
+   if (autoDelete && !--runnable->m_ref) {
+      delete runnable;
+   }
+}
+
+// tasks are pending but none could be taken, they are between a lane and
+// m_pendingTasks or a steal lost its race, yield for a few rounds and then
+// sleep briefly instead of spinning on the pool mutex
+void ThreadPoolThread::backOff(std::unique_lock<std::mutex> &locker, int &idleRounds)
+{
+   if (++idleRounds <= ThreadPoolPrivate::IdleSpinRounds) {
+      locker.unlock();
+      std::this_thread::yield();
+      locker.lock();
+   } else {
+      m_runnableReady.wait_for(locker, std::chrono::milliseconds(1));
+   }
+}
+
 void ThreadPoolThread::run()
 {
+   if (m_manager->isWorkStealing()) {
+      runWorkStealing();
+      return;
+   }
    std::unique_lock<std::mutex> locker(m_manager->m_mutex);
    for(;;) {
       Runnable *runnable = m_runnable;
@@ -135,6 +200,83 @@ void ThreadPoolThread::run()
    }
 }
 
+void ThreadPoolThread::runWorkStealing()
+{
+   sg_currentPoolThread = this;
+   std::unique_lock<std::mutex> locker(m_manager->m_mutex);
+   int idleRounds = 0;
+   for(;;) {
+      Runnable *runnable = m_runnable;
+      m_runnable = nullptr;
+      for (;;) {
+         // fast path, drain the local lanes and steal without the pool mutex
+         locker.unlock();
+         do {
+            if (runnable) {
+               runTask(runnable);
+               idleRounds = 0;
+            }
+            runnable = m_manager->findWork(this);
+         } while (runnable);
+         locker.lock();
+         // if too many threads are active, expire this thread
+         if (m_manager->tooManyThreadsActive()) {
+            break;
+         }
+         runnable = m_manager->takeFromGlobalQueue(this);
+         if (!runnable) {
+            if (m_manager->m_pendingTasks.load() == 0) {
+               break;
+            }
+            backOff(locker, idleRounds);
+         }
+      }
+      
+      if (m_manager->m_isExiting) {
+         registerThreadInactive();
+         break;
+      }
+      
+      bool expired = m_manager->tooManyThreadsActive();
+      if (!expired) {
+         m_manager->m_waitingThreads.push_back(this);
+         ++m_manager->m_idleThreads;
+         // a worker may have pushed into its local lanes right before it saw
+         // m_idleThreads go up, recheck once we are visible as idle
+         if (m_manager->m_pendingTasks.load() > 0) {
+            --m_manager->m_idleThreads;
+            auto iter = std::find(m_manager->m_waitingThreads.begin(), 
+                                  m_manager->m_waitingThreads.end(), this);
+            if (iter != m_manager->m_waitingThreads.end()) {
+               m_manager->m_waitingThreads.erase(iter);
+            }
+            backOff(locker, idleRounds);
+            continue;
+         }
+         registerThreadInactive();
+         m_runnableReady.wait_for(locker, 
+                                  std::chrono::milliseconds(m_manager->m_expiryTimeout + pdk::RandomGenerator::global()->bounded(64)));
+         --m_manager->m_idleThreads;
+         ++m_manager->m_activeThreads;
+         auto iter = std::find(m_manager->m_waitingThreads.begin(), 
+                               m_manager->m_waitingThreads.end(), this);
+         if (iter != m_manager->m_waitingThreads.end()) {
+            m_manager->m_waitingThreads.erase(iter);
+            // nobody woke us up, but there may still be work left behind
+            expired = !m_manager->hasPendingWork();
+         }
+      }
+      if (expired) {
+         // nobody steals from an expired thread once the others fall asleep
+         m_manager->requeueLocal(this);
+         m_manager->m_expiredThreads.push_back(this);
+         registerThreadInactive();
+         break;
+      }
+   }
+   sg_currentPoolThread = nullptr;
+}
+
 void ThreadPoolThread::registerThreadInactive()
 {
    if (--m_manager->m_activeThreads == 0) {
@@ -238,14 +380,17 @@ bool ThreadPoolPrivate::tooManyThreadsActive() const
 
 void ThreadPoolPrivate::startThread(Runnable *runnable)
 {
-   PDK_ASSERT(runnable != nullptr);
+   PDK_ASSERT(runnable != nullptr || isWorkStealing());
    pdk::utils::ScopedPointer <ThreadPoolThread> thread(new ThreadPoolThread(this));
    thread->setObjectName(Latin1String("Thread (pooled)"));
    PDK_ASSERT(m_allThreads.end() == std::find(m_allThreads.begin(), m_allThreads.end(), thread.getData())); 
    // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
    m_allThreads.push_back(thread.getData());
+   if (isWorkStealing()) {
+      registerStealVictim(thread.getData());
+   }
    ++m_activeThreads;
-   if (runnable->autoDelete()) {
+   if (runnable && runnable->autoDelete()) {
       ++runnable->m_ref;
    }
    thread->m_runnable = runnable;
@@ -261,16 +406,25 @@ void ThreadPoolPrivate::reset()
       std::list<ThreadPoolThread *> allThreadsCopy;
       allThreadsCopy.swap(m_allThreads);
       locker.unlock();
+      // join everybody before deleting anything, a worker that is still
+      // winding down may be looking into the deques of the others
       for (ThreadPoolThread *thread : std::as_const(allThreadsCopy)) {
          thread->m_runnableReady.notify_all();
          thread->wait();
-         delete thread;
       }
       locker.lock();
+      if (m_allThreads.empty()) {
+         m_stealVictimCount.store(0);
+         for (std::atomic<ThreadPoolThread *> &victim : m_stealVictims) {
+            victim.store(nullptr, std::memory_order_relaxed);
+         }
+      }
+      pdk::stdext::delete_all(allThreadsCopy);
       // repeat until all newly arrived threads have also completed
    }
    m_waitingThreads.clear();
    m_expiredThreads.clear();
+   m_idleThreads.store(0);
    m_isExiting = false;
 }
 
@@ -278,19 +432,19 @@ bool ThreadPoolPrivate::waitForDone(int msecs)
 {
    std::unique_lock<std::mutex> locker(m_mutex);
    if (msecs < 0) {
-      while (!(m_queue.empty() && m_activeThreads == 0)) {
+      while (hasPendingWork() || m_activeThreads != 0) {
          m_noActiveThreads.wait(locker);
       } 
    } else {
       ElapsedTimer timer;
       timer.start();
       int t;
-      while (!(m_queue.empty() && m_activeThreads == 0) &&
+      while ((hasPendingWork() || m_activeThreads != 0) &&
              ((t = msecs - timer.getElapsed()) > 0)) {
          m_noActiveThreads.wait_for(locker, std::chrono::milliseconds(t));
       }
    }
-   return m_queue.empty() && m_activeThreads == 0;
+   return !hasPendingWork() && m_activeThreads == 0;
 }
 
 void ThreadPoolPrivate::clear()
@@ -306,6 +460,181 @@ void ThreadPoolPrivate::clear()
    }
    pdk::stdext::delete_all(m_queue);
    m_queue.clear();
+   clearLocal();
+}
+
+bool ThreadPoolPrivate::tryPushLocal(Runnable *runnable, int priority)
+{
+   ThreadPoolThread *self = sg_currentPoolThread;
+   if (!self || self->m_manager != this || !self->m_isStealVictim) {
+      return false;
+   }
+   if (runnable->autoDelete()) {
+      ++runnable->m_ref;
+   }
+   if (!self->m_lanes[getPriorityLane(priority)].push(runnable)) {
+      if (runnable->autoDelete()) {
+         --runnable->m_ref;
+      }
+      return false;
+   }
+   // pairs with the m_idleThreads increment in ThreadPoolThread::runWorkStealing()
+   ++m_pendingTasks;
+   if (m_idleThreads.load() > 0) {
+      std::lock_guard<std::mutex> locker(m_mutex);
+      wakeWaitingThread();
+   }
+   return true;
+}
+
+Runnable *ThreadPoolPrivate::findWork(ThreadPoolThread *self)
+{
+   const int victimCount = m_stealVictimCount.load(std::memory_order_acquire);
+   for (int lane = 0; lane < LaneCount; ++lane) {
+      if (self->m_isStealVictim) {
+         if (Runnable *runnable = self->m_lanes[lane].pop()) {
+            --m_pendingTasks;
+            return runnable;
+         }
+      }
+      if (victimCount == 0) {
+         continue;
+      }
+      // start from a random victim so that thieves spread out
+      const int start = static_cast<int>(self->nextRandom() % static_cast<pdk::puint32>(victimCount));
+      for (int i = 0; i < victimCount; ++i) {
+         ThreadPoolThread *victim = m_stealVictims[(start + i) % victimCount].load(std::memory_order_acquire);
+         if (victim == nullptr || victim == self) {
+            continue;
+         }
+         if (Runnable *runnable = victim->m_lanes[lane].steal()) {
+            --m_pendingTasks;
+            return runnable;
+         }
+      }
+   }
+   return nullptr;
+}
+
+Runnable *ThreadPoolPrivate::takeFromGlobalQueue(ThreadPoolThread *self)
+{
+   // called with m_mutex held, grab a batch so that we come back less often
+   if (m_queue.empty()) {
+      return nullptr;
+   }
+   QueuePage *page = m_queue.front();
+   Runnable *first = page->pop();
+   int moved = 0;
+   while (self->m_isStealVictim && moved < GlobalQueueBatchSize) {
+      if (page->isFinished()) {
+         m_queue.pop_front();
+         delete page;
+         if (m_queue.empty()) {
+            break;
+         }
+         page = m_queue.front();
+      }
+      Runnable *runnable = page->first();
+      if (!self->m_lanes[getPriorityLane(page->getPriority())].push(runnable)) {
+         break;
+      }
+      // the reference taken by enqueueTask() travels with the runnable
+      page->pop();
+      ++m_pendingTasks;
+      ++moved;
+   }
+   if (!m_queue.empty() && m_queue.front()->isFinished()) {
+      delete m_queue.front();
+      m_queue.pop_front();
+   }
+   if (moved > 0) {
+      wakeWaitingThread();
+   }
+   return first;
+}
+
+void ThreadPoolPrivate::registerStealVictim(ThreadPoolThread *thread)
+{
+   // called with m_mutex held
+   const int index = m_stealVictimCount.load(std::memory_order_relaxed);
+   if (index >= MaxStealVictims) {
+      // this worker only runs what it is handed or what it steals
+      return;
+   }
+   thread->m_isStealVictim = true;
+   m_stealVictims[index].store(thread, std::memory_order_release);
+   m_stealVictimCount.store(index + 1, std::memory_order_release);
+}
+
+void ThreadPoolPrivate::wakeWaitingThread()
+{
+   // called with m_mutex held
+   if (!m_waitingThreads.empty()) {
+      ThreadPoolThread *thread = m_waitingThreads.front();
+      m_waitingThreads.pop_front();
+      thread->m_runnableReady.notify_one();
+   }
+}
+
+bool ThreadPoolPrivate::tryTakeLocal(Runnable *runnable)
+{
+   // called with m_mutex held, which keeps the victim list stable
+   const int victimCount = m_stealVictimCount.load(std::memory_order_acquire);
+   for (int i = 0; i < victimCount; ++i) {
+      ThreadPoolThread *victim = m_stealVictims[i].load(std::memory_order_acquire);
+      for (WorkStealingDeque &lane : victim->m_lanes) {
+         if (lane.tryTake(runnable)) {
+            --m_pendingTasks;
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+void ThreadPoolPrivate::clearLocal()
+{
+   // called with m_mutex held
+   const int victimCount = m_stealVictimCount.load(std::memory_order_acquire);
+   for (int i = 0; i < victimCount; ++i) {
+      ThreadPoolThread *victim = m_stealVictims[i].load(std::memory_order_acquire);
+      for (WorkStealingDeque &lane : victim->m_lanes) {
+         m_pendingTasks -= lane.takeAll([](Runnable *runnable) {
+            if (runnable->autoDelete() && !--runnable->m_ref) {
+               delete runnable;
+            }
+         });
+      }
+   }
+}
+
+void ThreadPoolPrivate::requeueLocal(ThreadPoolThread *self)
+{
+   // called with m_mutex held by the owner of the lanes
+   if (!self->m_isStealVictim) {
+      return;
+   }
+   const int lanePriorities[LaneCount] = {1, 0, -1};
+   std::vector<Runnable *> runnables;
+   for (int lane = 0; lane < LaneCount; ++lane) {
+      runnables.clear();
+      while (Runnable *runnable = self->m_lanes[lane].pop()) {
+         --m_pendingTasks;
+         runnables.push_back(runnable);
+      }
+      // pop() hands out the newest first, keep the submission order
+      for (auto iter = runnables.rbegin(); iter != runnables.rend(); ++iter) {
+         Runnable *runnable = *iter;
+         // enqueueTask() takes a reference of its own
+         if (runnable->autoDelete()) {
+            --runnable->m_ref;
+         }
+         enqueueTask(runnable, lanePriorities[lane]);
+      }
+   }
+   if (!m_queue.empty()) {
+      wakeWaitingThread();
+   }
 }
 
 void ThreadPoolPrivate::stealAndRunRunnable(Runnable *runnable)
@@ -346,6 +675,12 @@ bool ThreadPool::tryTake(Runnable *runnable)
             return true;
          }
       }
+      if (implPtr->isWorkStealing() && implPtr->tryTakeLocal(runnable)) {
+         if (runnable->autoDelete()) {
+            --runnable->m_ref; // undo ++ref in start()
+         }
+         return true;
+      }
    }
    return false;
 }
@@ -370,6 +705,9 @@ void ThreadPool::start(Runnable *runnable, int priority)
       return;
    }
    PDK_D(ThreadPool);
+   if (implPtr->isWorkStealing() && implPtr->tryPushLocal(runnable, priority)) {
+      return;
+   }
    std::unique_lock<std::mutex> locker(implPtr->m_mutex);
    if (!implPtr->tryStart(runnable)) {
       implPtr->enqueueTask(runnable, priority);
@@ -478,6 +816,30 @@ void ThreadPool::clear()
    implPtr->clear();
 }
 
+ThreadPool::SchedulingPolicy ThreadPool::getSchedulingPolicy() const
+{
+   PDK_D(const ThreadPool);
+   std::lock_guard<std::mutex> locker(implPtr->m_mutex);
+   return implPtr->m_schedulingPolicy;
+}
+
+bool ThreadPool::setSchedulingPolicy(SchedulingPolicy policy)
+{
+   PDK_D(ThreadPool);
+   std::lock_guard<std::mutex> locker(implPtr->m_mutex);
+   if (implPtr->m_schedulingPolicy == policy) {
+      return true;
+   }
+   // the policy is baked into the running workers, it can only change
+   // before the first thread starts or after waitForDone() reset the pool
+   if (!implPtr->m_allThreads.empty()) {
+      warning_stream("ThreadPool::setSchedulingPolicy: can not change the policy of a running pool");
+      return false;
+   }
+   implPtr->m_schedulingPolicy = policy;
+   return true;
+}
+
 } // thread
 } // os
 } // pdk
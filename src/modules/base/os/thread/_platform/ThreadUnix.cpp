@@ -21,6 +21,8 @@
 #include "pdk/base/os/thread/ThreadStorage.h"
 #if defined(PDK_OS_DARWIN)
 #  include "pdk/kernel/EventDispatcherCf.h"
+#elif defined(PDK_OS_LINUX)
+#  include "pdk/kernel/EventDispatcherEpoll.h"
 #endif
 
 #include <thread>
@@ -84,6 +86,8 @@ using pdk::kernel::internal::CoreApplicationPrivate;
 using pdk::kernel::EventDispatcherUNIX;
 #ifdef PDK_OS_DARWIN
 using pdk::kernel::EventDispatcherCoreFoundation;
+#elif defined(PDK_OS_LINUX)
+using pdk::kernel::EventDispatcherEpoll;
 #endif
 
 PDK_STATIC_ASSERT(sizeof(pthread_t) <= sizeof(pdk::HANDLE));
@@ -320,6 +324,12 @@ void ThreadPrivate::createEventDispatcher(ThreadData *data)
    } else {
       data->m_eventDispatcher.storeRelease(new EventDispatcherUNIX);
    }
+#elif defined(PDK_OS_LINUX)
+   if (EventDispatcherEpoll::isPreferred()) {
+      data->m_eventDispatcher.storeRelease(new EventDispatcherEpoll);
+   } else {
+      data->m_eventDispatcher.storeRelease(new EventDispatcherUNIX);
+   }
 #else
    data->m_eventDispatcher.storeRelease(new EventDispatcherUNIX);
 #endif
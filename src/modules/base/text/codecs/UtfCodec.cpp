@@ -81,7 +81,7 @@ static inline bool simd_encode_ascii(uchar *&dst, const char16_t *&nextAscii, co
          // characters still coming
          nextAscii = src + bit_scan_reverse(n) + 1;
          
-         n = pdk::count_trailing_zero_bits(n);
+         n = pdk::count_trailing_zero_bits(uint(n));
          dst += n;
          src += n;
          return false;
@@ -149,6 +149,415 @@ static inline bool simd_decode_ascii(char16_t *, const uchar *, const uchar *, c
 }
 #endif
 
+// Bulk UTF-8 validation and transcoding for the non-ASCII runs. The
+// validator is the nibble lookup scheme of Keiser and Lemire: every byte is
+// classified together with its predecessor through three 16 entry tables,
+// and the required continuation bytes of three and four byte sequences are
+// checked separately. Only blocks that validate completely are decoded
+// here, anything else goes through Utf8Functions so that errors, BOM and
+// state handling stay exactly those of the state machine.
+#if defined(PDK_PROCESSOR_X86) && PDK_COMPILER_SUPPORTS(SSE4_1)
+#  define PDK_HAVE_UTF8_BLOCK_KERNELS
+#endif
+
+#ifdef PDK_HAVE_UTF8_BLOCK_KERNELS
+namespace {
+
+using namespace pdk::pal::kernel;
+
+// bytes validated per step, sequences that straddle the end are left for the next block
+constexpr int UTF8_BLOCK_SIZE = 64;
+
+// error classes of a (previous byte, byte) pair
+enum : uchar
+{
+   Utf8TooShort = 1 << 0,      // 11______ 0_______ or 11______ 11______
+   Utf8TooLong = 1 << 1,       // 0_______ 10______
+   Utf8Overlong3 = 1 << 2,     // 11100000 100_____
+   Utf8TooLarge = 1 << 3,      // 11110100 1001____ and above
+   Utf8Surrogate = 1 << 4,     // 11101101 101_____
+   Utf8Overlong2 = 1 << 5,     // 1100000_ 10______
+   Utf8TooLarge1000 = 1 << 6,  // 11110101 1000____ and above
+   Utf8Overlong4 = 1 << 6,     // 11110000 1000____
+   Utf8TwoConts = 1 << 7,      // 10______ 10______
+   Utf8Carry = Utf8TooShort | Utf8TooLong | Utf8TwoConts
+};
+
+// indexed by the high nibble of the previous byte
+alignas(16) const uchar sg_utf8PrevHighTable[16] = {
+   Utf8TooLong, Utf8TooLong, Utf8TooLong, Utf8TooLong,
+   Utf8TooLong, Utf8TooLong, Utf8TooLong, Utf8TooLong,
+   Utf8TwoConts, Utf8TwoConts, Utf8TwoConts, Utf8TwoConts,
+   Utf8TooShort | Utf8Overlong2,
+   Utf8TooShort,
+   Utf8TooShort | Utf8Overlong3 | Utf8Surrogate,
+   Utf8TooShort | Utf8TooLarge | Utf8TooLarge1000 | Utf8Overlong4
+};
+
+// indexed by the low nibble of the previous byte
+alignas(16) const uchar sg_utf8PrevLowTable[16] = {
+   Utf8Carry | Utf8Overlong3 | Utf8Overlong2 | Utf8Overlong4,
+   Utf8Carry | Utf8Overlong2,
+   Utf8Carry,
+   Utf8Carry,
+   Utf8Carry | Utf8TooLarge,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000 | Utf8Surrogate,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+   Utf8Carry | Utf8TooLarge | Utf8TooLarge1000
+};
+
+// indexed by the high nibble of the byte itself
+alignas(16) const uchar sg_utf8CurHighTable[16] = {
+   Utf8TooShort, Utf8TooShort, Utf8TooShort, Utf8TooShort,
+   Utf8TooShort, Utf8TooShort, Utf8TooShort, Utf8TooShort,
+   Utf8TooLong | Utf8Overlong2 | Utf8TwoConts | Utf8Overlong3 | Utf8TooLarge1000 | Utf8Overlong4,
+   Utf8TooLong | Utf8Overlong2 | Utf8TwoConts | Utf8Overlong3 | Utf8TooLarge,
+   Utf8TooLong | Utf8Overlong2 | Utf8TwoConts | Utf8Surrogate | Utf8TooLarge,
+   Utf8TooLong | Utf8Overlong2 | Utf8TwoConts | Utf8Surrogate | Utf8TooLarge,
+   Utf8TooShort, Utf8TooShort, Utf8TooShort, Utf8TooShort
+};
+
+// lead and continuation byte patterns of the runs decoded in one step, the
+// unused tail of the three byte pattern never matches
+alignas(16) const uchar sg_utf8TwoByteMask[16] = {
+   0xe0, 0xc0, 0xe0, 0xc0, 0xe0, 0xc0, 0xe0, 0xc0, 0xe0, 0xc0, 0xe0, 0xc0, 0xe0, 0xc0, 0xe0, 0xc0
+};
+alignas(16) const uchar sg_utf8TwoByteValue[16] = {
+   0xc0, 0x80, 0xc0, 0x80, 0xc0, 0x80, 0xc0, 0x80, 0xc0, 0x80, 0xc0, 0x80, 0xc0, 0x80, 0xc0, 0x80
+};
+alignas(16) const uchar sg_utf8ThreeByteMask[16] = {
+   0xf0, 0xc0, 0xc0, 0xf0, 0xc0, 0xc0, 0xf0, 0xc0, 0xc0, 0xf0, 0xc0, 0xc0, 0, 0, 0, 0
+};
+alignas(16) const uchar sg_utf8ThreeByteValue[16] = {
+   0xe0, 0x80, 0x80, 0xe0, 0x80, 0x80, 0xe0, 0x80, 0x80, 0xe0, 0x80, 0x80, 0xff, 0xff, 0xff, 0xff
+};
+alignas(16) const uchar sg_utf8FourByteMask[16] = {
+   0xf8, 0xc0, 0xc0, 0xc0, 0xf8, 0xc0, 0xc0, 0xc0, 0xf8, 0xc0, 0xc0, 0xc0, 0xf8, 0xc0, 0xc0, 0xc0
+};
+alignas(16) const uchar sg_utf8FourByteValue[16] = {
+   0xf0, 0x80, 0x80, 0x80, 0xf0, 0x80, 0x80, 0x80, 0xf0, 0x80, 0x80, 0x80, 0xf0, 0x80, 0x80, 0x80
+};
+
+struct Utf8TrustedTraits : public Utf8BaseTraits
+{
+   static const bool sm_isTrusted = true;
+};
+
+inline __m128i load_table(const uchar *table)
+{
+   return _mm_load_si128(reinterpret_cast<const __m128i *>(table));
+}
+
+PDK_FUNCTION_TARGET(SSE4_1)
+inline __m128i utf8_errors_sse4(__m128i input, __m128i previous)
+{
+   const __m128i nibble = _mm_set1_epi8(0x0f);
+   const __m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+   const __m128i prev2 = _mm_alignr_epi8(input, previous, 14);
+   const __m128i prev3 = _mm_alignr_epi8(input, previous, 13);
+   __m128i special = _mm_shuffle_epi8(load_table(sg_utf8PrevHighTable),
+                                      _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+   special = _mm_and_si128(special, _mm_shuffle_epi8(load_table(sg_utf8PrevLowTable),
+                                                     _mm_and_si128(prev1, nibble)));
+   special = _mm_and_si128(special, _mm_shuffle_epi8(load_table(sg_utf8CurHighTable),
+                                                     _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+   // only 111_____ and 1111____ survive the saturated subtraction with the high bit set,
+   // those are the bytes that must be followed by a second and third continuation
+   const __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xe0 - 0x80)));
+   const __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xf0 - 0x80)));
+   const __m128i mustContinue = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(char(0x80)));
+   return _mm_xor_si128(mustContinue, special);
+}
+
+PDK_FUNCTION_TARGET(SSE4_1)
+bool utf8_block_is_valid_sse4(const uchar *src)
+{
+   __m128i previous = _mm_setzero_si128();
+   __m128i error = _mm_setzero_si128();
+   for (int i = 0; i < UTF8_BLOCK_SIZE; i += 16) {
+      const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+      error = _mm_or_si128(error, utf8_errors_sse4(input, previous));
+      previous = input;
+   }
+   return _mm_testz_si128(error, error);
+}
+
+#if PDK_COMPILER_SUPPORTS(AVX2)
+PDK_FUNCTION_TARGET(AVX2)
+inline __m256i utf8_errors_avx2(__m256i input, __m256i previous)
+{
+   const __m256i nibble = _mm256_set1_epi8(0x0f);
+   // the last bytes of previous followed by the bytes of input, lane by lane
+   const __m256i shifted = _mm256_permute2x128_si256(previous, input, 0x21);
+   const __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+   const __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+   const __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+   __m256i special = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(load_table(sg_utf8PrevHighTable)),
+                                         _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+   special = _mm256_and_si256(special, _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(load_table(sg_utf8PrevLowTable)),
+                                                           _mm256_and_si256(prev1, nibble)));
+   special = _mm256_and_si256(special, _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(load_table(sg_utf8CurHighTable)),
+                                                           _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+   const __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xe0 - 0x80)));
+   const __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xf0 - 0x80)));
+   const __m256i mustContinue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+   return _mm256_xor_si256(mustContinue, special);
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+bool utf8_block_is_valid_avx2(const uchar *src)
+{
+   __m256i previous = _mm256_setzero_si256();
+   __m256i error = _mm256_setzero_si256();
+   for (int i = 0; i < UTF8_BLOCK_SIZE; i += 32) {
+      const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      error = _mm256_or_si256(error, utf8_errors_avx2(input, previous));
+      previous = input;
+   }
+   return _mm256_testz_si256(error, error);
+}
+#endif
+
+inline bool utf8_block_is_valid(const uchar *src)
+{
+#if PDK_COMPILER_SUPPORTS(AVX2)
+   if (CPU_HAS_FEATURE(AVX2)) {
+      return utf8_block_is_valid_avx2(src);
+   }
+#endif
+   return utf8_block_is_valid_sse4(src);
+}
+
+// moves end back to the lead byte of a sequence that does not finish before it
+inline const uchar *utf8_sequence_boundary(const uchar *end)
+{
+   for (int i = 1; i <= 3; ++i) {
+      const uchar b = end[-i];
+      if (!Utf8Functions::isContinuationByte(b)) {
+         const int length = b < 0xc0 ? 1 : b < 0xe0 ? 2 : b < 0xf0 ? 3 : 4;
+         return length > i ? end - i : end;
+      }
+   }
+   return end;
+}
+
+// number of leading sequences, width bytes each, that match the pattern and
+// end before available; lanes is how many of them fit the pattern
+inline int leading_sequences(__m128i data, const uchar *mask, const uchar *value, int width,
+                             int lanes, pdk::ptrdiff available)
+{
+   const uint matches = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, load_table(mask)),
+                                                         load_table(value)));
+   const uint full = (1u << (width * lanes)) - 1;
+   // a full run is the common case, and as a predictable branch it does not
+   // hold the next load back until the count is known
+   if (PDK_LIKELY((matches & full) == full && available >= width * lanes)) {
+      return lanes;
+   }
+   return std::min<pdk::ptrdiff>(pdk::count_trailing_zero_bits(~matches | 0x10000) / width,
+                                 available / width);
+}
+
+// decodes the validated bytes in [src, stop); end bounds the 16 byte loads
+PDK_FUNCTION_TARGET(SSE4_1)
+void utf8_decode_valid_sse4(char16_t *&dstRef, const uchar *&srcRef, const uchar *stop, const uchar *end)
+{
+   char16_t *dst = dstRef;
+   const uchar *src = srcRef;
+   while (src < stop) {
+      if (end - src < 16) {
+         const uchar b = *src++;
+         Utf8Functions::fromUtf8<Utf8TrustedTraits>(b, dst, src, stop);
+         continue;
+      }
+      // every byte decodes to at most one code unit, so the output has room for 16 of them
+      const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+      const uint nonAscii = _mm_movemask_epi8(data);
+      const pdk::ptrdiff available = stop - src;
+      if (!(nonAscii & 1)) {
+         _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_cvtepu8_epi16(data));
+         _mm_storeu_si128(reinterpret_cast<__m128i *>(dst) + 1, _mm_cvtepu8_epi16(_mm_srli_si128(data, 8)));
+         if (PDK_LIKELY(!nonAscii && available >= 16)) {
+            dst += 16;
+            src += 16;
+         } else {
+            const int count = std::min<pdk::ptrdiff>(pdk::count_trailing_zero_bits(nonAscii | 0x10000),
+                                                     available);
+            dst += count;
+            src += count;
+         }
+         continue;
+      }
+      const uchar lead = *src;
+      if (lead < 0xe0) {
+         // U+0080 to U+07FF, byte pairs become 110xxxxx 10yyyyyy -> 00000xxx xxyyyyyy
+         const int count = leading_sequences(data, sg_utf8TwoByteMask, sg_utf8TwoByteValue, 2, 8, available);
+         const __m128i high = _mm_slli_epi16(_mm_and_si128(data, _mm_set1_epi16(0x1f)), 6);
+         const __m128i low = _mm_and_si128(_mm_srli_epi16(data, 8), _mm_set1_epi16(0x3f));
+         _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(high, low));
+         dst += count;
+         src += 2 * count;
+      } else if (lead < 0xf0) {
+         // U+0800 to U+FFFF, every triple goes big endian into a 32-bit lane first
+         const int count = leading_sequences(data, sg_utf8ThreeByteMask, sg_utf8ThreeByteValue, 3, 4, available);
+         const __m128i lanes = _mm_shuffle_epi8(data, _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1,
+                                                                    8, 7, 6, -1, 11, 10, 9, -1));
+         __m128i ucs = _mm_and_si128(lanes, _mm_set1_epi32(0x3f));
+         ucs = _mm_or_si128(ucs, _mm_and_si128(_mm_srli_epi32(lanes, 2), _mm_set1_epi32(0x0fc0)));
+         ucs = _mm_or_si128(ucs, _mm_and_si128(_mm_srli_epi32(lanes, 4), _mm_set1_epi32(0xf000)));
+         _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packus_epi32(ucs, ucs));
+         dst += count;
+         src += 3 * count;
+      } else {
+         // U+10000 to U+10FFFF, written as surrogate pairs
+         const int count = leading_sequences(data, sg_utf8FourByteMask, sg_utf8FourByteValue, 4, 4, available);
+         const __m128i lanes = _mm_shuffle_epi8(data, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4,
+                                                                    11, 10, 9, 8, 15, 14, 13, 12));
+         __m128i ucs = _mm_and_si128(lanes, _mm_set1_epi32(0x3f));
+         ucs = _mm_or_si128(ucs, _mm_and_si128(_mm_srli_epi32(lanes, 2), _mm_set1_epi32(0x0fc0)));
+         ucs = _mm_or_si128(ucs, _mm_and_si128(_mm_srli_epi32(lanes, 4), _mm_set1_epi32(0x3f000)));
+         ucs = _mm_or_si128(ucs, _mm_and_si128(_mm_srli_epi32(lanes, 6), _mm_set1_epi32(0x1c0000)));
+         ucs = _mm_sub_epi32(ucs, _mm_set1_epi32(0x10000));
+         const __m128i high = _mm_or_si128(_mm_srli_epi32(ucs, 10), _mm_set1_epi32(0xd800));
+         const __m128i low = _mm_or_si128(_mm_and_si128(ucs, _mm_set1_epi32(0x3ff)), _mm_set1_epi32(0xdc00));
+         _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(high, _mm_slli_epi32(low, 16)));
+         dst += 2 * count;
+         src += 4 * count;
+      }
+   }
+   dstRef = dst;
+   srcRef = src;
+}
+
+// U+0080 to U+07FF in the leading lanes, as a movemask with two bits per lane
+PDK_FUNCTION_TARGET(SSE4_1)
+inline uint utf16_two_byte_lanes(__m128i data)
+{
+   const __m128i belowTwoByte = _mm_cmpeq_epi16(_mm_min_epu16(data, _mm_set1_epi16(0x7f)), data);
+   const __m128i belowThreeByte = _mm_cmpeq_epi16(_mm_min_epu16(data, _mm_set1_epi16(0x7ff)), data);
+   return _mm_movemask_epi8(_mm_andnot_si128(belowTwoByte, belowThreeByte));
+}
+
+// U+0800 to U+FFFF without the surrogates
+PDK_FUNCTION_TARGET(SSE4_1)
+inline uint utf16_three_byte_lanes(__m128i data)
+{
+   const __m128i belowThreeByte = _mm_cmpeq_epi16(_mm_min_epu16(data, _mm_set1_epi16(0x7ff)), data);
+   const __m128i surrogate = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(short(0xf800))),
+                                             _mm_set1_epi16(short(0xd800)));
+   return ~_mm_movemask_epi8(_mm_or_si128(belowThreeByte, surrogate)) & 0xffff;
+}
+
+// four code units of U+0800 to U+FFFF into exactly twelve bytes
+PDK_FUNCTION_TARGET(SSE4_1)
+inline void utf16_store_three_byte(uchar *dst, __m128i ucs)
+{
+   __m128i lanes = _mm_or_si128(_mm_srli_epi32(ucs, 12), _mm_set1_epi32(0xe0));
+   lanes = _mm_or_si128(lanes, _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(ucs, 6), _mm_set1_epi32(0x3f)), 8));
+   lanes = _mm_or_si128(lanes, _mm_slli_epi32(_mm_and_si128(ucs, _mm_set1_epi32(0x3f)), 16));
+   lanes = _mm_or_si128(lanes, _mm_set1_epi32(0x808000));
+   lanes = _mm_shuffle_epi8(lanes, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+   _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), lanes);
+   const int tail = _mm_extract_epi32(lanes, 2);
+   std::memcpy(dst + 8, &tail, sizeof(tail));
+}
+
+// encodes the leading run of two and three byte characters at src; the
+// output has room for three bytes per remaining input code unit
+PDK_FUNCTION_TARGET(SSE4_1)
+void utf16_encode_multibyte_sse4(uchar *&dst, const char16_t *&src, const char16_t *end)
+{
+   while (end - src >= 8) {
+      const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+      const uint twoByte = utf16_two_byte_lanes(data);
+      if (twoByte & 1) {
+         const int count = twoByte == 0xffff ? 8 : pdk::count_trailing_zero_bits(~twoByte) / 2;
+         // 00000xxx xxyyyyyy -> 110xxxxx 10yyyyyy
+         const __m128i lead = _mm_or_si128(_mm_srli_epi16(data, 6), _mm_set1_epi16(0xc0));
+         const __m128i trail = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(data, _mm_set1_epi16(0x3f)), 8),
+                                            _mm_set1_epi16(short(0x8000)));
+         _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(lead, trail));
+         dst += 2 * count;
+         src += count;
+         continue;
+      }
+      const uint threeByte = utf16_three_byte_lanes(data);
+      if (!(threeByte & 1)) {
+         return;
+      }
+      const int count = threeByte == 0xffff ? 8 : pdk::count_trailing_zero_bits(~threeByte) / 2;
+      utf16_store_three_byte(dst, _mm_cvtepu16_epi32(data));
+      if (count > 4) {
+         utf16_store_three_byte(dst + 12, _mm_cvtepu16_epi32(_mm_srli_si128(data, 8)));
+      }
+      dst += 3 * count;
+      src += count;
+   }
+}
+
+} // anonymous namespace
+
+// Decodes whole blocks of valid UTF-8 at src. Returns the end of the first
+// block that failed to validate, the caller runs the state machine up to
+// there; returns src when less than a block is left.
+static inline const uchar *simd_decode_utf8(char16_t *&dst, const uchar *&src, const uchar *end)
+{
+   if (!CPU_HAS_FEATURE(SSE4_1)) {
+      return src;
+   }
+   while (end - src >= UTF8_BLOCK_SIZE) {
+      const uchar *blockEnd = utf8_sequence_boundary(src + UTF8_BLOCK_SIZE);
+      if (!utf8_block_is_valid(src)) {
+         return blockEnd;
+      }
+      utf8_decode_valid_sse4(dst, src, blockEnd, end);
+   }
+   return src;
+}
+
+static inline void simd_encode_utf8(uchar *&dst, const char16_t *&src, const char16_t *end)
+{
+   if (CPU_HAS_FEATURE(SSE4_1)) {
+      utf16_encode_multibyte_sse4(dst, src, end);
+   }
+}
+
+static inline bool simd_is_valid_utf8(const uchar *&src, const uchar *end)
+{
+   if (!CPU_HAS_FEATURE(SSE4_1)) {
+      return true;
+   }
+   for ( ; end - src >= UTF8_BLOCK_SIZE; src = utf8_sequence_boundary(src + UTF8_BLOCK_SIZE)) {
+      if (!utf8_block_is_valid(src)) {
+         return false;
+      }
+   }
+   return true;
+}
+#else
+static inline const uchar *simd_decode_utf8(char16_t *, const uchar *&src, const uchar *)
+{
+   return src;
+}
+
+static inline void simd_encode_utf8(uchar *&, const char16_t *&, const char16_t *)
+{
+}
+
+static inline bool simd_is_valid_utf8(const uchar *&, const uchar *)
+{
+   return true;
+}
+#endif
+
 ByteArray Utf8::convertFromUnicode(const Character *uc, int len)
 {
    // create a ByteArray with the worst case scenario size
@@ -161,15 +570,16 @@ ByteArray Utf8::convertFromUnicode(const Character *uc, int len)
       const char16_t *nextAscii = end;
       if (simd_encode_ascii(dst, nextAscii, src, end))
          break;
+      simd_encode_utf8(dst, src, end);
       
-      do {
+      while (src < nextAscii) {
          char16_t uc = *src++;
          int res = Utf8Functions::toUtf8<Utf8BaseTraits>(uc, dst, src, end);
          if (res < 0) {
             // encoding error - append '?'
             *dst++ = '?';
          }
-      } while (src < nextAscii);
+      }
    }
    
    result.truncate(dst - reinterpret_cast<uchar *>(const_cast<char *>(result.getConstRawData())));
@@ -213,8 +623,13 @@ ByteArray Utf8::convertFromUnicode(const Character *uc, int len, TextCodec::Conv
          surrogate_high = -1;
          res = Utf8Functions::toUtf8<Utf8BaseTraits>(uc, cursor, src, end);
       } else {
-         if (src >= nextAscii && simd_encode_ascii(cursor, nextAscii, src, end))
-            break;
+         if (src >= nextAscii) {
+            if (simd_encode_ascii(cursor, nextAscii, src, end))
+               break;
+            simd_encode_utf8(cursor, src, end);
+            if (src == end)
+               break;
+         }
          
          uc = *src++;
          res = Utf8Functions::toUtf8<Utf8BaseTraits>(uc, cursor, src, end);
@@ -302,20 +717,48 @@ Character *Utf8::convertToUnicode(Character *buffer, const char *chars, int len)
          if (simd_decode_ascii(dst, nextAscii, src, end)) {
             break;
          }
-         do {
+         // whole blocks of valid UTF-8 are decoded in bulk, the state machine
+         // takes over at the first block that does not validate
+         const uchar *blockEnd = simd_decode_utf8(dst, src, end);
+         const uchar *stop = std::max(nextAscii, blockEnd);
+         while (src < stop) {
             uchar b = *src++;
             int res = Utf8Functions::fromUtf8<Utf8BaseTraits>(b, dst, src, end);
             if (res < 0) {
                // decoding error
                *dst++ = Character::ReplacementCharacter;
             }
-         } while (src < nextAscii);
+         }
       }
    }
    
    return reinterpret_cast<Character *>(dst);
 }
 
+/*!
+    Returns true if the \a len octets beginning at \a chars are well formed
+    UTF-8: no overlong forms, no surrogates, nothing above U+10FFFF and no
+    truncated sequence at the end.
+*/
+
+bool Utf8::isValidUtf8(const char *chars, int len) noexcept
+{
+   const uchar *src = reinterpret_cast<const uchar *>(chars);
+   const uchar *end = src + len;
+   if (!simd_is_valid_utf8(src, end)) {
+      return false;
+   }
+   char16_t buffer[2];
+   while (src < end) {
+      char16_t *dst = buffer;
+      uchar b = *src++;
+      if (Utf8Functions::fromUtf8<Utf8BaseTraits>(b, dst, src, end) < 0) {
+         return false;
+      }
+   }
+   return true;
+}
+
 String Utf8::convertToUnicode(const char *chars, int len, TextCodec::ConverterState *state)
 {
    bool headerdone = false;
@@ -387,10 +830,19 @@ String Utf8::convertToUnicode(const char *chars, int len, TextCodec::ConverterSt
    // main body, stateless decoding
    res = 0;
    const uchar *nextAscii = src;
+   const uchar *nextBlock = src;
    const uchar *start = src;
    while (res >= 0 && src < end) {
-      if (src >= nextAscii && simd_decode_ascii(dst, nextAscii, src, end))
-         break;
+      if (src >= nextAscii) {
+         if (simd_decode_ascii(dst, nextAscii, src, end))
+            break;
+         // the BOM is only looked for in the first character, the blocks come after it
+         if (headerdone && src >= nextBlock) {
+            nextBlock = simd_decode_utf8(dst, src, end);
+            if (src == end)
+               break;
+         }
+      }
       
       ch = *src++;
       res = Utf8Functions::fromUtf8<Utf8BaseTraits>(ch, dst, src, end);
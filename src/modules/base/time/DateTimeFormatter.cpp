@@ -0,0 +1,1401 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/base/time/DateTimeFormatter.h"
+#include "pdk/base/time/internal/DateTimeFormatterPrivate.h"
+#include "pdk/utils/internal/LocalePrivate.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+
+namespace pdk {
+namespace time {
+
+using internal::DateTimeFormatFields;
+using internal::DateTimeFormatText;
+using pdk::ds::ByteArray;
+using pdk::lang::Latin1String;
+
+namespace {
+
+constexpr int SECS_PER_HOUR = 3600;
+constexpr pdk::pint64 MSECS_PER_DAY = 86400000;
+constexpr int MSECS_PER_SEC = 1000;
+// what a time zone abbreviation is assumed to take up when sizing buffers
+constexpr int ZONE_ABBREVIATION_LENGTH = 32;
+// toString() formats into the stack when the plan is this short
+constexpr int STACK_BUFFER_SIZE = 128;
+
+using Field = DateTimeFormatterPrivate::Field;
+
+DateTimeFormatText make_text(const String &text)
+{
+   return DateTimeFormatText{text, text.toUtf8()};
+}
+
+bool is_ascii_digit(char16_t c)
+{
+   return c >= '0' && c <= '9';
+}
+
+char16_t unit_of(Character c)
+{
+   return c.unicode();
+}
+
+char16_t unit_of(char c)
+{
+   return static_cast<uchar>(c);
+}
+
+bool format_contains_ap(StringView format)
+{
+   int i = 0;
+   while (static_cast<StringView::size_type>(i) < format.size()) {
+      if (format.at(i).unicode() == '\'') {
+         pdk::utils::internal::read_escaped_format_string(format, &i);
+         continue;
+      }
+      if (format.at(i).toLower().unicode() == 'a') {
+         return true;
+      }
+      ++i;
+   }
+   return false;
+}
+
+// Bounded writer shared by the Character and the UTF-8 output, it keeps
+// counting past the end of the buffer so the caller can tell how much room
+// the value needed
+template <typename CharType>
+class PlanWriter
+{
+public:
+   PlanWriter(CharType *buffer, int size, char16_t zero)
+      : m_buffer(buffer),
+        m_size(size),
+        m_length(0),
+        m_zero(zero)
+   {}
+
+   void putAscii(char c)
+   {
+      if (m_length < m_size) {
+         m_buffer[m_length] = CharType(c);
+      }
+      ++m_length;
+   }
+
+   void putText(const DateTimeFormatText &text)
+   {
+      if constexpr (std::is_same<CharType, char>::value) {
+         putUnits(text.m_utf8.getConstRawData(), text.m_utf8.size());
+      } else {
+         putUnits(text.m_text.getRawData(), text.m_text.size());
+      }
+   }
+
+   void putString(const String &text)
+   {
+      if constexpr (std::is_same<CharType, char>::value) {
+         const ByteArray utf8 = text.toUtf8();
+         putUnits(utf8.getConstRawData(), utf8.size());
+      } else {
+         putUnits(text.getRawData(), text.size());
+      }
+   }
+
+   void putDigit(int digit)
+   {
+      const char16_t c = static_cast<char16_t>(m_zero + digit);
+      if constexpr (std::is_same<CharType, char>::value) {
+         if (c < 0x80) {
+            putAscii(static_cast<char>(c));
+         } else if (c < 0x800) {
+            putAscii(static_cast<char>(0xc0 | (c >> 6)));
+            putAscii(static_cast<char>(0x80 | (c & 0x3f)));
+         } else {
+            putAscii(static_cast<char>(0xe0 | (c >> 12)));
+            putAscii(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+            putAscii(static_cast<char>(0x80 | (c & 0x3f)));
+         }
+      } else {
+         if (m_length < m_size) {
+            m_buffer[m_length] = Character(c);
+         }
+         ++m_length;
+      }
+   }
+
+   // width counts the sign of a negative value, like Locale does
+   void putNumber(int value, int width)
+   {
+      char digits[12];
+      int count = 0;
+      unsigned magnitude = value < 0 ? 0u - static_cast<unsigned>(value) : static_cast<unsigned>(value);
+      do {
+         digits[count++] = static_cast<char>(magnitude % 10);
+         magnitude /= 10;
+      } while (magnitude != 0);
+      if (value < 0) {
+         putAscii('-');
+         --width;
+      }
+      for (int i = count; i < width; ++i) {
+         putDigit(0);
+      }
+      while (count > 0) {
+         putDigit(digits[--count]);
+      }
+   }
+
+   // +HH:mm, or +HHmm without the colon; offsets are always ASCII
+   void putOffset(int offset, bool colon)
+   {
+      putAscii(offset >= 0 ? '+' : '-');
+      const int magnitude = std::abs(offset);
+      const int hours = magnitude / SECS_PER_HOUR;
+      const int minutes = (magnitude / 60) % 60;
+      putAscii(static_cast<char>('0' + hours / 10));
+      putAscii(static_cast<char>('0' + hours % 10));
+      if (colon) {
+         putAscii(':');
+      }
+      putAscii(static_cast<char>('0' + minutes / 10));
+      putAscii(static_cast<char>('0' + minutes % 10));
+   }
+
+   int finish() const
+   {
+      return m_length <= m_size ? m_length : -1;
+   }
+
+private:
+   template <typename SourceType>
+   void putUnits(const SourceType *units, int count)
+   {
+      const int room = std::max(0, std::min(count, m_size - m_length));
+      std::copy(units, units + room, m_buffer + m_length);
+      m_length += count;
+   }
+
+   CharType *m_buffer;
+   int m_size;
+   int m_length;
+   char16_t m_zero;
+};
+
+String zone_abbreviation(const DateTimeFormatFields &fields)
+{
+   if (fields.m_dateTime) {
+      return fields.m_dateTime->timeZoneAbbreviation();
+   }
+   switch (fields.m_spec) {
+   case pdk::TimeSpec::UTC:
+      return Latin1String("UTC");
+   case pdk::TimeSpec::OffsetFromUTC: {
+      char buffer[6];
+      PlanWriter<char> writer(buffer, sizeof(buffer), '0');
+      writer.putOffset(fields.m_offsetFromUtc, true);
+      return Latin1String("UTC") + String::fromLatin1(buffer, writer.finish());
+   }
+   default:
+      // a Time on its own is formatted with the current zone, as Locale does
+      return DateTime::getCurrentDateTime().timeZoneAbbreviation();
+   }
+}
+
+void fields_from_date(const Date &date, DateTimeFormatFields &fields)
+{
+   date.getDate(&fields.m_year, &fields.m_month, &fields.m_day);
+   fields.m_dayOfWeek = date.getDayOfWeek();
+}
+
+void fields_from_time(const Time &time, DateTimeFormatFields &fields)
+{
+   int msecs = time.msecsSinceStartOfDay();
+   fields.m_msec = msecs % MSECS_PER_SEC;
+   msecs /= MSECS_PER_SEC;
+   fields.m_second = msecs % 60;
+   msecs /= 60;
+   fields.m_minute = msecs % 60;
+   fields.m_hour = msecs / 60;
+}
+
+DateTimeFormatFields empty_fields()
+{
+   DateTimeFormatFields fields = {};
+   fields.m_spec = pdk::TimeSpec::LocalTime;
+   return fields;
+}
+
+// Splits the wall clock time offsetFromUtc seconds east of UTC, using
+// Howard Hinnant's days to civil date algorithm
+bool fields_from_msecs(pdk::pint64 msecs, int offsetFromUtc, DateTimeFormatFields &fields)
+{
+   // keeps the arithmetic below far from overflowing, that is still
+   // about 146 million years either way
+   constexpr pdk::pint64 msecsLimit = PDK_INT64_C(1) << 62;
+   if (msecs <= -msecsLimit || msecs >= msecsLimit || std::abs(offsetFromUtc) >= 86400) {
+      return false;
+   }
+   const pdk::pint64 local = msecs + offsetFromUtc * pdk::pint64(MSECS_PER_SEC);
+   pdk::pint64 days = local / MSECS_PER_DAY;
+   pdk::pint64 msecOfDay = local % MSECS_PER_DAY;
+   if (msecOfDay < 0) {
+      msecOfDay += MSECS_PER_DAY;
+      --days;
+   }
+   // 1970-01-01 was a Thursday
+   fields.m_dayOfWeek = static_cast<int>(((days % 7) + 7 + 3) % 7) + 1;
+   days += 719468;
+   const pdk::pint64 era = (days >= 0 ? days : days - 146096) / 146097;
+   const pdk::pint64 dayOfEra = days - era * 146097;
+   const pdk::pint64 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+   const pdk::pint64 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+   const pdk::pint64 monthIndex = (5 * dayOfYear + 2) / 153;
+   fields.m_day = static_cast<int>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+   fields.m_month = static_cast<int>(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+   fields.m_year = static_cast<int>(yearOfEra + era * 400 + (fields.m_month <= 2));
+   // there is no year 0, 1 BCE is year -1
+   if (fields.m_year <= 0) {
+      --fields.m_year;
+   }
+   fields_from_time(Time::fromMSecsSinceStartOfDay(static_cast<int>(msecOfDay)), fields);
+   fields.m_offsetFromUtc = offsetFromUtc;
+   fields.m_spec = offsetFromUtc == 0 ? pdk::TimeSpec::UTC : pdk::TimeSpec::OffsetFromUTC;
+   fields.m_parts = DateTimeFormatterPrivate::DatePart | DateTimeFormatterPrivate::TimePart;
+   fields.m_dateTime = nullptr;
+   return true;
+}
+
+int digit_width(char16_t zero)
+{
+   return zero < 0x80 ? 1 : (zero < 0x800 ? 2 : 3);
+}
+
+int text_width(const DateTimeFormatText &text)
+{
+   return std::max(text.m_text.size(), text.m_utf8.size());
+}
+
+template <size_t N>
+int names_width(const DateTimeFormatText (&names)[N])
+{
+   int width = 0;
+   for (const DateTimeFormatText &name : names) {
+      width = std::max(width, text_width(name));
+   }
+   return width;
+}
+
+int step_width(const DateTimeFormatterPrivate &plan, const DateTimeFormatterPrivate::Step &step)
+{
+   const int digit = digit_width(plan.m_zero);
+   switch (step.m_field) {
+   case Field::Literal:
+      return 0;
+   case Field::Year4:
+   case Field::YearNumber:
+      return 1 + 10 * digit;
+   case Field::Year2:
+      return 1 + 2 * digit;
+   case Field::Month:
+   case Field::Month2:
+   case Field::Day:
+   case Field::Day2:
+   case Field::Hour12:
+   case Field::Hour12Padded:
+   case Field::Hour:
+   case Field::Hour2:
+   case Field::Minute:
+   case Field::Minute2:
+   case Field::Second:
+   case Field::Second2:
+      return 2 * digit;
+   case Field::Msec3:
+   case Field::MsecTrimmed:
+      return 3 * digit;
+   case Field::MonthShortName:
+      return names_width(plan.m_monthNames[1]);
+   case Field::MonthLongName:
+      return names_width(plan.m_monthNames[0]);
+   case Field::DayShortName:
+      return names_width(plan.m_dayNames[1]);
+   case Field::DayLongName:
+      return names_width(plan.m_dayNames[0]);
+   case Field::AmPmLower:
+      return std::max(text_width(plan.m_amText[0]), text_width(plan.m_pmText[0]));
+   case Field::AmPmUpper:
+      return std::max(text_width(plan.m_amText[1]), text_width(plan.m_pmText[1]));
+   case Field::ZoneAbbreviation:
+      return ZONE_ABBREVIATION_LENGTH;
+   case Field::IsoOffset:
+      return 6;
+   case Field::RfcOffset:
+      return 5;
+   case Field::TextZone:
+      return 1 + ZONE_ABBREVIATION_LENGTH;
+   }
+   return 0;
+}
+
+int plan_max_length(const DateTimeFormatterPrivate &plan)
+{
+   int length = 0;
+   for (const DateTimeFormatterPrivate::Step &step : plan.m_steps) {
+      const int fallback = step.m_text >= 0 ? text_width(plan.m_texts[step.m_text]) : 0;
+      length += std::max(step_width(plan, step), fallback);
+   }
+   return length;
+}
+
+// parse side helpers
+
+template <typename CharType>
+class PlanReader
+{
+public:
+   PlanReader(const CharType *text, int size, char16_t zero)
+      : m_cursor(text),
+        m_end(text + size),
+        m_zero(zero)
+   {}
+
+   bool atEnd() const
+   {
+      return m_cursor == m_end;
+   }
+
+   char16_t peek() const
+   {
+      return atEnd() ? 0 : unit_of(*m_cursor);
+   }
+
+   bool skip(char16_t c)
+   {
+      if (!atEnd() && unit_of(*m_cursor) == c) {
+         ++m_cursor;
+         return true;
+      }
+      return false;
+   }
+
+   // reads between minDigits and maxDigits digits, ASCII or the plan's own
+   bool readNumber(int minDigits, int maxDigits, int *value, int *digits = nullptr)
+   {
+      const CharType *start = m_cursor;
+      int count = 0;
+      int result = 0;
+      while (count < maxDigits && !atEnd()) {
+         const int digit = digitOf(unit_of(*m_cursor));
+         if (digit < 0) {
+            break;
+         }
+         result = result * 10 + digit;
+         ++count;
+         ++m_cursor;
+      }
+      if (count < minDigits) {
+         m_cursor = start;
+         return false;
+      }
+      *value = result;
+      if (digits) {
+         *digits = count;
+      }
+      return true;
+   }
+
+   bool readSignedNumber(int minDigits, int maxDigits, int *value)
+   {
+      const bool negative = skip('-');
+      if (!readNumber(minDigits, maxDigits, value)) {
+         return false;
+      }
+      if (negative) {
+         *value = -*value;
+      }
+      return true;
+   }
+
+   // matches text case insensitively, ASCII only for UTF-8 input
+   bool matchText(const DateTimeFormatText &text)
+   {
+      int length;
+      if constexpr (std::is_same<CharType, char>::value) {
+         length = text.m_utf8.size();
+         if (length == 0 || m_end - m_cursor < length) {
+            return false;
+         }
+         const char *expected = text.m_utf8.getConstRawData();
+         for (int i = 0; i < length; ++i) {
+            char lhs = m_cursor[i];
+            char rhs = expected[i];
+            if (lhs >= 'A' && lhs <= 'Z') {
+               lhs += 'a' - 'A';
+            }
+            if (rhs >= 'A' && rhs <= 'Z') {
+               rhs += 'a' - 'A';
+            }
+            if (lhs != rhs) {
+               return false;
+            }
+         }
+      } else {
+         length = text.m_text.size();
+         if (length == 0 || m_end - m_cursor < length) {
+            return false;
+         }
+         const Character *expected = text.m_text.getRawData();
+         for (int i = 0; i < length; ++i) {
+            if (m_cursor[i].toLower() != expected[i].toLower()) {
+               return false;
+            }
+         }
+      }
+      m_cursor += length;
+      return true;
+   }
+
+   // index of the longest matching name, -1 for none
+   template <size_t N>
+   int matchName(const DateTimeFormatText (&names)[N])
+   {
+      int best = -1;
+      int bestLength = 0;
+      const CharType *start = m_cursor;
+      for (size_t i = 0; i < N; ++i) {
+         m_cursor = start;
+         if (matchText(names[i]) && m_cursor - start > bestLength) {
+            best = static_cast<int>(i);
+            bestLength = static_cast<int>(m_cursor - start);
+         }
+      }
+      m_cursor = start + bestLength;
+      return best;
+   }
+
+   // [+-]HH[[:]mm], colon says whether the separator is allowed
+   bool readOffset(bool colon, int *offset)
+   {
+      const char16_t sign = peek();
+      if (sign != '+' && sign != '-') {
+         return false;
+      }
+      const CharType *start = m_cursor++;
+      int hours;
+      int minutes = 0;
+      bool ok = readNumber(2, 2, &hours);
+      if (ok && ((colon && skip(':')) || is_ascii_digit(peek()))) {
+         ok = readNumber(2, 2, &minutes);
+      }
+      if (!ok || hours > 23 || minutes > 59) {
+         m_cursor = start;
+         return false;
+      }
+      *offset = (hours * 60 + minutes) * 60 * (sign == '-' ? -1 : 1);
+      return true;
+   }
+
+   bool matchAscii(const char *text)
+   {
+      const CharType *start = m_cursor;
+      for (; *text; ++text) {
+         if (!skip(static_cast<char16_t>(*text))) {
+            m_cursor = start;
+            return false;
+         }
+      }
+      return true;
+   }
+
+   // any run of digits, without converting them
+   void skipDigits()
+   {
+      while (!atEnd() && digitOf(unit_of(*m_cursor)) >= 0) {
+         ++m_cursor;
+      }
+   }
+   
+   void skipLetters()
+   {
+      while (!atEnd()) {
+         const char16_t c = unit_of(*m_cursor);
+         if (!((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))) {
+            break;
+         }
+         ++m_cursor;
+      }
+   }
+
+private:
+   int digitOf(char16_t c) const
+   {
+      if (is_ascii_digit(c)) {
+         return c - '0';
+      }
+      return (c >= m_zero && c < m_zero + 10) ? c - m_zero : -1;
+   }
+   
+   const CharType *m_cursor;
+   const CharType *m_end;
+   char16_t m_zero;
+};
+
+template <typename CharType>
+DateTime parse_iso_datetime(const CharType *text, int size)
+{
+   if (!text || size <= 0) {
+      return DateTime();
+   }
+   PlanReader<CharType> reader(text, size, '0');
+   int year;
+   int month;
+   int day;
+   if (!reader.readNumber(4, 4, &year) || !reader.skip('-')
+       || !reader.readNumber(2, 2, &month) || !reader.skip('-')
+       || !reader.readNumber(2, 2, &day)) {
+      return DateTime();
+   }
+   Date date(year, month, day);
+   if (!date.isValid() || year == 0) {
+      return DateTime();
+   }
+   if (reader.atEnd()) {
+      return DateTime(date);
+   }
+   if (!reader.skip('T') && !reader.skip(' ')) {
+      return DateTime();
+   }
+   int hour;
+   int minute;
+   int second = 0;
+   int msec = 0;
+   if (!reader.readNumber(2, 2, &hour) || !reader.skip(':') || !reader.readNumber(2, 2, &minute)) {
+      return DateTime();
+   }
+   if (reader.skip(':')) {
+      if (!reader.readNumber(2, 2, &second)) {
+         return DateTime();
+      }
+      if (reader.skip('.') || reader.skip(',')) {
+         // round to milliseconds from the first four digits, ignore the rest
+         int fraction;
+         int digits;
+         if (!reader.readNumber(1, 4, &fraction, &digits)) {
+            return DateTime();
+         }
+         reader.skipDigits();
+         static const int scale[] = {1, 10, 100, 1000, 10000};
+         msec = std::min((fraction * 10000 / scale[digits] + 5) / 10, 999);
+      }
+   }
+   pdk::TimeSpec spec = pdk::TimeSpec::LocalTime;
+   int offset = 0;
+   if (reader.skip('Z')) {
+      spec = pdk::TimeSpec::UTC;
+   } else if (reader.readOffset(true, &offset)) {
+      spec = pdk::TimeSpec::OffsetFromUTC;
+   }
+   if (!reader.atEnd()) {
+      return DateTime();
+   }
+   if (hour == 24 && minute == 0 && second == 0 && msec == 0) {
+      date = date.addDays(1);
+      hour = 0;
+   }
+   const Time time(hour, minute, second, msec);
+   if (!time.isValid()) {
+      return DateTime();
+   }
+   return DateTime(date, time, spec, offset);
+}
+
+} // anonymous namespace
+
+namespace internal {
+
+DateTimeFormatterPrivate::DateTimeFormatterPrivate()
+   : m_zero('0'),
+     m_maxLength(0),
+     m_skipMissingParts(false),
+     m_isoYearRange(false),
+     m_needsOffset(false),
+     m_needsNames(false)
+{}
+
+void DateTimeFormatterPrivate::addText(const String &text, int parts)
+{
+   if (text.isEmpty()) {
+      return;
+   }
+   // adjacent literals with the same requirement become one step
+   if (!m_steps.empty() && m_steps.back().m_field == Field::Literal
+       && m_steps.back().m_parts == parts) {
+      DateTimeFormatText &previous = m_texts[m_steps.back().m_text];
+      previous = make_text(previous.m_text + text);
+      return;
+   }
+   m_texts.push_back(make_text(text));
+   m_steps.push_back(Step{Field::Literal, static_cast<pdk::puint8>(parts),
+                          static_cast<int>(m_texts.size()) - 1});
+}
+
+void DateTimeFormatterPrivate::addLiteral(StringView text, int parts)
+{
+   addText(text.toString(), parts);
+}
+
+void DateTimeFormatterPrivate::addStep(Field field, int parts, StringView text)
+{
+   int index = -1;
+   if (!text.isEmpty()) {
+      m_texts.push_back(make_text(text.toString()));
+      index = static_cast<int>(m_texts.size()) - 1;
+   }
+   switch (field) {
+   case Field::MonthShortName:
+   case Field::MonthLongName:
+   case Field::DayShortName:
+   case Field::DayLongName:
+   case Field::AmPmLower:
+   case Field::AmPmUpper:
+      m_needsNames = true;
+      break;
+   default:
+      break;
+   }
+   if (field == Field::IsoOffset || field == Field::RfcOffset || field == Field::TextZone) {
+      m_needsOffset = true;
+   }
+   if (field == Field::TextZone && index < 0) {
+      // written for UTC and fixed offsets, kept here so format() does not
+      // build it on every call
+      m_texts.push_back(make_text(Latin1String(" GMT")));
+      index = static_cast<int>(m_texts.size()) - 1;
+   }
+   m_steps.push_back(Step{field, static_cast<pdk::puint8>(parts), index});
+}
+
+void DateTimeFormatterPrivate::captureNames(const Locale &locale)
+{
+   for (int i = 0; i < 12; ++i) {
+      m_monthNames[0][i] = make_text(locale.getMonthName(i + 1, Locale::FormatType::LongFormat));
+      m_monthNames[1][i] = make_text(locale.getMonthName(i + 1, Locale::FormatType::ShortFormat));
+   }
+   for (int i = 0; i < 7; ++i) {
+      m_dayNames[0][i] = make_text(locale.getDayName(i + 1, Locale::FormatType::LongFormat));
+      m_dayNames[1][i] = make_text(locale.getDayName(i + 1, Locale::FormatType::ShortFormat));
+   }
+   const String am = locale.getAmText();
+   const String pm = locale.getPmText();
+   m_amText[0] = make_text(am.toLower());
+   m_amText[1] = make_text(am.toUpper());
+   m_pmText[0] = make_text(pm.toLower());
+   m_pmText[1] = make_text(pm.toUpper());
+}
+
+// Mirrors LocalePrivate::dateTimeToString, every token becomes one step
+// that keeps its source text for values that lack its part
+void DateTimeFormatterPrivate::compile(StringView format, const Locale &locale)
+{
+   m_zero = locale.getZeroDigit().unicode();
+   const bool twelveHour = format_contains_ap(format);
+   int i = 0;
+   while (static_cast<StringView::size_type>(i) < format.size()) {
+      if (format.at(i).unicode() == '\'') {
+         addText(pdk::utils::internal::read_escaped_format_string(format, &i));
+         continue;
+      }
+      const Character c = format.at(i);
+      int repeat = pdk::utils::internal::repeat_count(format.substring(i));
+      bool used = true;
+      Field field = Field::Literal;
+      int parts = DatePart;
+      switch (c.unicode()) {
+      case 'y':
+         if (repeat >= 4) {
+            repeat = 4;
+            field = Field::Year4;
+         } else if (repeat >= 2) {
+            repeat = 2;
+            field = Field::Year2;
+         } else {
+            used = false;
+         }
+         break;
+      case 'M': {
+         static const Field monthFields[] = {
+            Field::Month, Field::Month2, Field::MonthShortName, Field::MonthLongName
+         };
+         repeat = std::min(repeat, 4);
+         field = monthFields[repeat - 1];
+         break;
+      }
+      case 'd': {
+         static const Field dayFields[] = {
+            Field::Day, Field::Day2, Field::DayShortName, Field::DayLongName
+         };
+         repeat = std::min(repeat, 4);
+         field = dayFields[repeat - 1];
+         break;
+      }
+      case 'h':
+         repeat = std::min(repeat, 2);
+         parts = TimePart;
+         if (twelveHour) {
+            field = repeat == 1 ? Field::Hour12 : Field::Hour12Padded;
+         } else {
+            field = repeat == 1 ? Field::Hour : Field::Hour2;
+         }
+         break;
+      case 'H':
+         repeat = std::min(repeat, 2);
+         parts = TimePart;
+         field = repeat == 1 ? Field::Hour : Field::Hour2;
+         break;
+      case 'm':
+         repeat = std::min(repeat, 2);
+         parts = TimePart;
+         field = repeat == 1 ? Field::Minute : Field::Minute2;
+         break;
+      case 's':
+         repeat = std::min(repeat, 2);
+         parts = TimePart;
+         field = repeat == 1 ? Field::Second : Field::Second2;
+         break;
+      case 'a':
+      case 'A': {
+         const char16_t second = c.unicode() == 'a' ? 'p' : 'P';
+         repeat = (static_cast<StringView::size_type>(i + 1) < format.size()
+                   && format.at(i + 1).unicode() == second) ? 2 : 1;
+         parts = TimePart;
+         field = c.unicode() == 'a' ? Field::AmPmLower : Field::AmPmUpper;
+         break;
+      }
+      case 'z':
+         repeat = repeat >= 3 ? 3 : 1;
+         parts = TimePart;
+         field = repeat == 3 ? Field::Msec3 : Field::MsecTrimmed;
+         break;
+      case 't':
+         repeat = 1;
+         parts = TimePart;
+         field = Field::ZoneAbbreviation;
+         break;
+      default:
+         used = false;
+         break;
+      }
+      if (used) {
+         addStep(field, parts, format.substring(i, repeat));
+      } else {
+         addLiteral(format.substring(i, repeat));
+      }
+      i += repeat;
+   }
+   if (m_needsNames) {
+      captureNames(locale);
+   }
+}
+
+void DateTimeFormatterPrivate::compile(pdk::DateFormat format, const Locale &locale)
+{
+   const int both = DatePart | TimePart;
+   switch (format) {
+   case pdk::DateFormat::SystemLocaleShortDate:
+   case pdk::DateFormat::SystemLocaleLongDate:
+   case pdk::DateFormat::DefaultLocaleShortDate:
+   case pdk::DateFormat::DefaultLocaleLongDate: {
+      const Locale source = (format == pdk::DateFormat::SystemLocaleShortDate
+                             || format == pdk::DateFormat::SystemLocaleLongDate)
+            ? Locale::getSystem() : Locale();
+      const Locale::FormatType type = (format == pdk::DateFormat::SystemLocaleShortDate
+                                       || format == pdk::DateFormat::DefaultLocaleShortDate)
+            ? Locale::FormatType::ShortFormat : Locale::FormatType::LongFormat;
+      compile(StringView(source.getDateTimeFormat(type)), source);
+      m_skipMissingParts = true;
+      return;
+   }
+   case pdk::DateFormat::RFC2822Date:
+      // dd MMM yyyy hh:mm:ss +HHmm, always with the C locale's names
+      m_skipMissingParts = true;
+      addStep(Field::Day2, DatePart, StringView());
+      addText(Latin1String(" "), DatePart);
+      addStep(Field::MonthShortName, DatePart, StringView());
+      addText(Latin1String(" "), DatePart);
+      addStep(Field::Year4, DatePart, StringView());
+      addText(Latin1String(" "), both);
+      addStep(Field::Hour2, TimePart, StringView());
+      addText(Latin1String(":"), TimePart);
+      addStep(Field::Minute2, TimePart, StringView());
+      addText(Latin1String(":"), TimePart);
+      addStep(Field::Second2, TimePart, StringView());
+      addText(Latin1String(" "), both);
+      addStep(Field::RfcOffset, both, StringView());
+      captureNames(Locale::c());
+      return;
+   case pdk::DateFormat::TextDate:
+      // ddd MMM d hh:mm:ss yyyy [zone], the time goes between day and year
+      m_skipMissingParts = true;
+      addStep(Field::DayShortName, DatePart, StringView());
+      addText(Latin1String(" "), DatePart);
+      addStep(Field::MonthShortName, DatePart, StringView());
+      addText(Latin1String(" "), DatePart);
+      addStep(Field::Day, DatePart, StringView());
+      addText(Latin1String(" "), both);
+      addStep(Field::Hour2, TimePart, StringView());
+      addText(Latin1String(":"), TimePart);
+      addStep(Field::Minute2, TimePart, StringView());
+      addText(Latin1String(":"), TimePart);
+      addStep(Field::Second2, TimePart, StringView());
+      addText(Latin1String(" "), DatePart);
+      addStep(Field::YearNumber, DatePart, StringView());
+      addStep(Field::TextZone, both, StringView());
+      captureNames(locale);
+      return;
+   case pdk::DateFormat::ISODate:
+   case pdk::DateFormat::ISODateWithMs:
+      m_skipMissingParts = true;
+      m_isoYearRange = true;
+      addStep(Field::Year4, DatePart, StringView());
+      addText(Latin1String("-"), DatePart);
+      addStep(Field::Month2, DatePart, StringView());
+      addText(Latin1String("-"), DatePart);
+      addStep(Field::Day2, DatePart, StringView());
+      addText(Latin1String("T"), both);
+      addStep(Field::Hour2, TimePart, StringView());
+      addText(Latin1String(":"), TimePart);
+      addStep(Field::Minute2, TimePart, StringView());
+      addText(Latin1String(":"), TimePart);
+      addStep(Field::Second2, TimePart, StringView());
+      if (format == pdk::DateFormat::ISODateWithMs) {
+         addText(Latin1String("."), TimePart);
+         addStep(Field::Msec3, TimePart, StringView());
+      }
+      addStep(Field::IsoOffset, both, StringView());
+      return;
+   }
+}
+
+template <typename CharType>
+int DateTimeFormatterPrivate::write(const DateTimeFormatFields &fields, CharType *buffer, int size) const
+{
+   if (m_isoYearRange && (fields.m_parts & DatePart) && (fields.m_year < 0 || fields.m_year > 9999)) {
+      return -1;
+   }
+   PlanWriter<CharType> out(buffer, size, m_zero);
+   for (const Step &step : m_steps) {
+      if ((step.m_parts & fields.m_parts) != step.m_parts) {
+         if (!m_skipMissingParts && step.m_text >= 0) {
+            out.putText(m_texts[step.m_text]);
+         }
+         continue;
+      }
+      switch (step.m_field) {
+      case Field::Literal:
+         out.putText(m_texts[step.m_text]);
+         break;
+      case Field::Year4:
+         out.putNumber(fields.m_year, fields.m_year < 0 ? 5 : 4);
+         break;
+      case Field::Year2:
+         out.putNumber(fields.m_year % 100, 2);
+         break;
+      case Field::YearNumber:
+         out.putNumber(fields.m_year, 1);
+         break;
+      case Field::Month:
+         out.putNumber(fields.m_month, 1);
+         break;
+      case Field::Month2:
+         out.putNumber(fields.m_month, 2);
+         break;
+      case Field::MonthShortName:
+         out.putText(m_monthNames[1][fields.m_month - 1]);
+         break;
+      case Field::MonthLongName:
+         out.putText(m_monthNames[0][fields.m_month - 1]);
+         break;
+      case Field::Day:
+         out.putNumber(fields.m_day, 1);
+         break;
+      case Field::Day2:
+         out.putNumber(fields.m_day, 2);
+         break;
+      case Field::DayShortName:
+         out.putText(m_dayNames[1][fields.m_dayOfWeek - 1]);
+         break;
+      case Field::DayLongName:
+         out.putText(m_dayNames[0][fields.m_dayOfWeek - 1]);
+         break;
+      case Field::Hour12:
+      case Field::Hour12Padded: {
+         int hour = fields.m_hour;
+         if (hour > 12) {
+            hour -= 12;
+         } else if (hour == 0) {
+            hour = 12;
+         }
+         out.putNumber(hour, step.m_field == Field::Hour12 ? 1 : 2);
+         break;
+      }
+      case Field::Hour:
+         out.putNumber(fields.m_hour, 1);
+         break;
+      case Field::Hour2:
+         out.putNumber(fields.m_hour, 2);
+         break;
+      case Field::Minute:
+         out.putNumber(fields.m_minute, 1);
+         break;
+      case Field::Minute2:
+         out.putNumber(fields.m_minute, 2);
+         break;
+      case Field::Second:
+         out.putNumber(fields.m_second, 1);
+         break;
+      case Field::Second2:
+         out.putNumber(fields.m_second, 2);
+         break;
+      case Field::Msec3:
+         out.putNumber(fields.m_msec, 3);
+         break;
+      case Field::MsecTrimmed:
+         // the milliseconds read as a fraction of the second, up to two
+         // trailing zeros go, so 200 is "2" and 2 stays "002"
+         if (fields.m_msec % 100 == 0) {
+            out.putNumber(fields.m_msec / 100, 1);
+         } else if (fields.m_msec % 10 == 0) {
+            out.putNumber(fields.m_msec / 10, 2);
+         } else {
+            out.putNumber(fields.m_msec, 3);
+         }
+         break;
+      case Field::AmPmLower:
+         out.putText(fields.m_hour < 12 ? m_amText[0] : m_pmText[0]);
+         break;
+      case Field::AmPmUpper:
+         out.putText(fields.m_hour < 12 ? m_amText[1] : m_pmText[1]);
+         break;
+      case Field::ZoneAbbreviation:
+         out.putString(zone_abbreviation(fields));
+         break;
+      case Field::IsoOffset:
+         if (fields.m_spec == pdk::TimeSpec::UTC) {
+            out.putAscii('Z');
+         } else if (fields.m_spec != pdk::TimeSpec::LocalTime) {
+            out.putOffset(fields.m_offsetFromUtc, true);
+         }
+         break;
+      case Field::RfcOffset:
+         out.putOffset(fields.m_offsetFromUtc, false);
+         break;
+      case Field::TextZone:
+         if (fields.m_spec == pdk::TimeSpec::TimeZone) {
+            out.putAscii(' ');
+            out.putString(zone_abbreviation(fields));
+         } else if (fields.m_spec != pdk::TimeSpec::LocalTime) {
+            out.putText(m_texts[step.m_text]);
+            if (fields.m_spec == pdk::TimeSpec::OffsetFromUTC) {
+               out.putOffset(fields.m_offsetFromUtc, false);
+            }
+         }
+         break;
+      }
+   }
+   return out.finish();
+}
+
+template <typename CharType>
+DateTime DateTimeFormatterPrivate::read(const CharType *text, int size) const
+{
+   PlanReader<CharType> in(text, size, m_zero);
+   int year = 1900;
+   int month = 1;
+   int day = 1;
+   int hour = 0;
+   int minute = 0;
+   int second = 0;
+   int msec = 0;
+   int pm = -1;
+   bool twelveHour = false;
+   pdk::TimeSpec spec = pdk::TimeSpec::LocalTime;
+   int offset = 0;
+   for (const Step &step : m_steps) {
+      bool ok = true;
+      switch (step.m_field) {
+      case Field::Literal:
+         ok = in.matchText(m_texts[step.m_text]);
+         break;
+      case Field::Year4:
+         ok = in.readSignedNumber(4, 4, &year);
+         break;
+      case Field::Year2:
+         ok = in.readNumber(2, 2, &year);
+         year += 1900;
+         break;
+      case Field::YearNumber:
+         ok = in.readSignedNumber(1, 9, &year);
+         break;
+      case Field::Month:
+         ok = in.readNumber(1, 2, &month);
+         break;
+      case Field::Month2:
+         ok = in.readNumber(2, 2, &month);
+         break;
+      case Field::MonthShortName:
+      case Field::MonthLongName: {
+         const int index = in.matchName(m_monthNames[step.m_field == Field::MonthShortName ? 1 : 0]);
+         ok = index >= 0;
+         month = index + 1;
+         break;
+      }
+      case Field::Day:
+         ok = in.readNumber(1, 2, &day);
+         break;
+      case Field::Day2:
+         ok = in.readNumber(2, 2, &day);
+         break;
+      case Field::DayShortName:
+      case Field::DayLongName:
+         // the day of the week follows from the date, it is only checked
+         // to be a name
+         ok = in.matchName(m_dayNames[step.m_field == Field::DayShortName ? 1 : 0]) >= 0;
+         break;
+      case Field::Hour12:
+      case Field::Hour12Padded:
+         twelveHour = true;
+         ok = in.readNumber(step.m_field == Field::Hour12 ? 1 : 2, 2, &hour);
+         break;
+      case Field::Hour:
+         ok = in.readNumber(1, 2, &hour);
+         break;
+      case Field::Hour2:
+         ok = in.readNumber(2, 2, &hour);
+         break;
+      case Field::Minute:
+         ok = in.readNumber(1, 2, &minute);
+         break;
+      case Field::Minute2:
+         ok = in.readNumber(2, 2, &minute);
+         break;
+      case Field::Second:
+         ok = in.readNumber(1, 2, &second);
+         break;
+      case Field::Second2:
+         ok = in.readNumber(2, 2, &second);
+         break;
+      case Field::Msec3:
+         ok = in.readNumber(3, 3, &msec);
+         break;
+      case Field::MsecTrimmed: {
+         int digits = 0;
+         ok = in.readNumber(1, 3, &msec, &digits);
+         for (; ok && digits < 3; ++digits) {
+            msec *= 10;
+         }
+         break;
+      }
+      case Field::AmPmLower:
+      case Field::AmPmUpper:
+         if (in.matchText(m_amText[0])) {
+            pm = 0;
+         } else if (in.matchText(m_pmText[0])) {
+            pm = 1;
+         } else {
+            ok = false;
+         }
+         break;
+      case Field::ZoneAbbreviation:
+         if (in.matchAscii("UTC") || in.matchAscii("GMT")) {
+            spec = in.readOffset(true, &offset) ? pdk::TimeSpec::OffsetFromUTC : pdk::TimeSpec::UTC;
+         } else {
+            in.skipLetters();
+         }
+         break;
+      case Field::IsoOffset:
+         if (in.skip('Z')) {
+            spec = pdk::TimeSpec::UTC;
+         } else if (in.readOffset(true, &offset)) {
+            spec = pdk::TimeSpec::OffsetFromUTC;
+         }
+         break;
+      case Field::RfcOffset:
+         ok = in.readOffset(false, &offset);
+         spec = pdk::TimeSpec::OffsetFromUTC;
+         break;
+      case Field::TextZone:
+         if (in.matchAscii(" GMT")) {
+            spec = in.readOffset(false, &offset) ? pdk::TimeSpec::OffsetFromUTC : pdk::TimeSpec::UTC;
+         } else if (in.skip(' ')) {
+            // an abbreviation names no offset we could rely on
+            in.skipLetters();
+         }
+         break;
+      }
+      if (!ok) {
+         return DateTime();
+      }
+   }
+   if (!in.atEnd()) {
+      return DateTime();
+   }
+   if (twelveHour) {
+      if (hour < 1 || hour > 12) {
+         return DateTime();
+      }
+      if (pm == 1 && hour < 12) {
+         hour += 12;
+      } else if (pm == 0 && hour == 12) {
+         hour = 0;
+      }
+   }
+   const Date date(year, month, day);
+   const Time time(hour, minute, second, msec);
+   if (!date.isValid() || !time.isValid()) {
+      return DateTime();
+   }
+   return DateTime(date, time, spec, offset);
+}
+
+} // internal
+
+DateTimeFormatter::DateTimeFormatter()
+{}
+
+DateTimeFormatter::DateTimeFormatter(pdk::DateFormat format, const Locale &locale)
+   : m_implPtr(new DateTimeFormatterPrivate)
+{
+   m_implPtr->compile(format, locale);
+   m_implPtr->m_maxLength = plan_max_length(*m_implPtr);
+}
+
+DateTimeFormatter::DateTimeFormatter(StringView format, const Locale &locale)
+   : m_implPtr(new DateTimeFormatterPrivate)
+{
+   m_implPtr->compile(format, locale);
+   m_implPtr->m_maxLength = plan_max_length(*m_implPtr);
+}
+
+DateTimeFormatter::DateTimeFormatter(const DateTimeFormatter &other)
+   : m_implPtr(other.m_implPtr)
+{}
+
+DateTimeFormatter::DateTimeFormatter(DateTimeFormatter &&other) noexcept
+   : m_implPtr(std::move(other.m_implPtr))
+{}
+
+DateTimeFormatter::~DateTimeFormatter()
+{}
+
+DateTimeFormatter &DateTimeFormatter::operator=(const DateTimeFormatter &other)
+{
+   m_implPtr = other.m_implPtr;
+   return *this;
+}
+
+DateTimeFormatter &DateTimeFormatter::operator=(DateTimeFormatter &&other) noexcept
+{
+   m_implPtr = std::move(other.m_implPtr);
+   return *this;
+}
+
+bool DateTimeFormatter::isValid() const
+{
+   return m_implPtr.constData() != nullptr;
+}
+
+int DateTimeFormatter::getMaxLength() const
+{
+   return isValid() ? m_implPtr->m_maxLength : 0;
+}
+
+namespace {
+
+// the wall clock time of the msecs overloads of format()
+struct MsecsValue
+{
+   pdk::pint64 m_msecsSinceEpoch;
+   int m_offsetFromUtc;
+};
+
+bool value_fields(const DateTimeFormatterPrivate &plan, const DateTime &dateTime,
+                  DateTimeFormatFields &fields)
+{
+   if (!dateTime.isValid()) {
+      return false;
+   }
+   fields_from_date(dateTime.getDate(), fields);
+   fields_from_time(dateTime.getTime(), fields);
+   fields.m_spec = dateTime.getTimeSpec();
+   fields.m_offsetFromUtc = plan.m_needsOffset ? dateTime.getOffsetFromUtc() : 0;
+   fields.m_parts = DateTimeFormatterPrivate::DatePart | DateTimeFormatterPrivate::TimePart;
+   fields.m_dateTime = &dateTime;
+   return true;
+}
+
+bool value_fields(const DateTimeFormatterPrivate &, const Date &date, DateTimeFormatFields &fields)
+{
+   if (!date.isValid()) {
+      return false;
+   }
+   fields_from_date(date, fields);
+   fields.m_parts = DateTimeFormatterPrivate::DatePart;
+   return true;
+}
+
+bool value_fields(const DateTimeFormatterPrivate &, const Time &time, DateTimeFormatFields &fields)
+{
+   if (!time.isValid()) {
+      return false;
+   }
+   fields_from_time(time, fields);
+   fields.m_parts = DateTimeFormatterPrivate::TimePart;
+   return true;
+}
+
+bool value_fields(const DateTimeFormatterPrivate &, const MsecsValue &value, DateTimeFormatFields &fields)
+{
+   return fields_from_msecs(value.m_msecsSinceEpoch, value.m_offsetFromUtc, fields);
+}
+
+template <typename ValueType, typename CharType>
+int format_value(const DateTimeFormatterPrivate *plan, const ValueType &value,
+                 CharType *buffer, int size)
+{
+   DateTimeFormatFields fields = empty_fields();
+   if (!plan || !value_fields(*plan, value, fields)) {
+      return -1;
+   }
+   return plan->write(fields, buffer, size);
+}
+
+} // anonymous namespace
+
+int DateTimeFormatter::format(const DateTime &dateTime, Character *buffer, int size) const
+{
+   return format_value(m_implPtr.constData(), dateTime, buffer, size);
+}
+
+int DateTimeFormatter::format(const DateTime &dateTime, char *buffer, int size) const
+{
+   return format_value(m_implPtr.constData(), dateTime, buffer, size);
+}
+
+int DateTimeFormatter::format(const Date &date, Character *buffer, int size) const
+{
+   return format_value(m_implPtr.constData(), date, buffer, size);
+}
+
+int DateTimeFormatter::format(const Date &date, char *buffer, int size) const
+{
+   return format_value(m_implPtr.constData(), date, buffer, size);
+}
+
+int DateTimeFormatter::format(const Time &time, Character *buffer, int size) const
+{
+   return format_value(m_implPtr.constData(), time, buffer, size);
+}
+
+int DateTimeFormatter::format(const Time &time, char *buffer, int size) const
+{
+   return format_value(m_implPtr.constData(), time, buffer, size);
+}
+
+int DateTimeFormatter::format(pdk::pint64 msecsSinceEpoch, int offsetFromUtc,
+                              Character *buffer, int size) const
+{
+   return format_value(m_implPtr.constData(), MsecsValue{msecsSinceEpoch, offsetFromUtc}, buffer, size);
+}
+
+int DateTimeFormatter::format(pdk::pint64 msecsSinceEpoch, int offsetFromUtc,
+                              char *buffer, int size) const
+{
+   return format_value(m_implPtr.constData(), MsecsValue{msecsSinceEpoch, offsetFromUtc}, buffer, size);
+}
+
+namespace {
+
+// Formats into the stack when the plan fits, and retries once with a
+// larger heap buffer for zone abbreviations longer than the estimate
+template <typename ValueType>
+String format_to_string(const DateTimeFormatter &formatter, const ValueType &value)
+{
+   const int maxLength = formatter.getMaxLength();
+   if (maxLength <= STACK_BUFFER_SIZE) {
+      Character buffer[STACK_BUFFER_SIZE];
+      const int length = formatter.format(value, buffer, STACK_BUFFER_SIZE);
+      if (length >= 0) {
+         return String(buffer, length);
+      }
+   }
+   int size = std::max(maxLength, STACK_BUFFER_SIZE) * 4;
+   String result(size, pdk::Initialization::Uninitialized);
+   const int length = formatter.format(value, result.getRawData(), size);
+   if (length < 0) {
+      return String();
+   }
+   result.truncate(length);
+   return result;
+}
+
+} // anonymous namespace
+
+String DateTimeFormatter::toString(const DateTime &dateTime) const
+{
+   return format_to_string(*this, dateTime);
+}
+
+String DateTimeFormatter::toString(const Date &date) const
+{
+   return format_to_string(*this, date);
+}
+
+String DateTimeFormatter::toString(const Time &time) const
+{
+   return format_to_string(*this, time);
+}
+
+DateTime DateTimeFormatter::parse(StringView text) const
+{
+   if (!isValid()) {
+      return DateTime();
+   }
+   return m_implPtr->read(text.data(), static_cast<int>(text.size()));
+}
+
+DateTime DateTimeFormatter::parse(const char *text, int size) const
+{
+   if (!isValid() || !text || size < 0) {
+      return DateTime();
+   }
+   return m_implPtr->read(text, size);
+}
+
+DateTime DateTimeFormatter::parseIsoDateTime(StringView text)
+{
+   return parse_iso_datetime(text.data(), static_cast<int>(text.size()));
+}
+
+DateTime DateTimeFormatter::parseIsoDateTime(const char *text, int size)
+{
+   return parse_iso_datetime(text, size);
+}
+
+} // time
+} // pdk
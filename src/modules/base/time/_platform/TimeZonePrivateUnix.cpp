@@ -0,0 +1,1050 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/base/time/TimeZone.h"
+#include "pdk/base/time/internal/TimeZonePrivate.h"
+#include "pdk/base/time/Date.h"
+#include "pdk/base/time/DateTime.h"
+#include "pdk/base/io/fs/File.h"
+#include "pdk/base/lang/String.h"
+#include "pdk/global/GlobalStatic.h"
+#include "pdk/utils/Funcs.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace pdk {
+namespace time {
+namespace internal {
+
+using pdk::ds::ByteArray;
+using pdk::io::IoDevice;
+using pdk::io::fs::File;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+using pdk::lang::StringView;
+using pdk::utils::Locale;
+using pdk::utils::internal::LocalePrivate;
+
+/*
+    Private
+    
+    tzfile (TZif) implementation
+    
+    Each zone file is mapped and parsed once per process, the resulting tables
+    are immutable and shared by every TzTimeZonePrivate using that zone.
+*/
+
+// One half of a POSIX TZ rule: the local date and wall clock time DST starts or ends on
+struct TzPosixDate
+{
+   enum class Kind
+   {
+      JulianNoLeap,     // Jn, 1 to 365, February 29 is never counted
+      JulianZeroBased,  // n, 0 to 365, February 29 is counted in leap years
+      MonthWeekDay      // Mm.w.d, day d (Sunday = 0) of week w (5 = last) of month m
+   };
+   Kind m_kind = Kind::MonthWeekDay;
+   int m_day = 0;
+   int m_month = 0;
+   int m_week = 0;
+   // seconds after local midnight, RFC 8536 allows -167 to 167 hours
+   int m_time = 7200;
+};
+
+struct TzPosixRule
+{
+   String m_stdName;
+   String m_dstName;
+   int m_stdOffset = 0;
+   int m_dstOffset = 0;
+   TzPosixDate m_start;
+   TzPosixDate m_end;
+   // only set when both transition dates are known, a bare DST name is ignored
+   bool m_hasDst = false;
+};
+
+struct TzZoneData
+{
+   std::vector<TzTransitionTime> m_tranTimes;
+   std::vector<TzTransitionRule> m_tranRules;
+   std::vector<String> m_abbreviations;
+   ByteArray m_posixRule;
+   TzPosixRule m_posix;
+   // rule in force before the first transition
+   pdk::puint8 m_initialRule = 0;
+   pdk::puint8 m_posixStdRule = 0;
+   pdk::puint8 m_posixDstRule = 0;
+   bool m_hasDaylightTime = false;
+   // the POSIX rule only applies after the last transition read from the file
+   pdk::pint64 m_posixFrom = TimeZonePrivate::getMinMSecs();
+   // m_tranTimes is exact inside [m_cacheBegin, m_cacheEnd], the POSIX rule is
+   // evaluated on the fly outside of it
+   pdk::pint64 m_cacheBegin = TimeZonePrivate::getMinMSecs();
+   pdk::pint64 m_cacheEnd = TimeZonePrivate::getMaxMSecs();
+   
+   bool usesPosixRule(pdk::pint64 msecs) const
+   {
+      return m_posix.m_hasDst && (msecs < m_cacheBegin || msecs > m_cacheEnd);
+   }
+};
+
+namespace {
+
+constexpr const int sg_tzHeaderSize = 44;
+constexpr const int sg_msecsPerDay = 86400000;
+constexpr const pdk::pint64 sg_julianDayForEpoch = 2440588;
+// transitions of the POSIX rule are precomputed up to this year, later ones are
+// worked out on demand
+constexpr const int sg_posixCacheEndYear = 2100;
+constexpr const int sg_posixMinYear = 1;
+constexpr const int sg_posixMaxYear = 9999;
+
+const char * const sg_zoneInfoDirs[] = {
+   "/usr/share/zoneinfo/",
+   "/usr/lib/zoneinfo/"
+};
+
+struct TzHeader
+{
+   char m_version;
+   pdk::puint32 m_isUtcCount;
+   pdk::puint32 m_isStdCount;
+   pdk::puint32 m_leapCount;
+   pdk::puint32 m_timeCount;
+   pdk::puint32 m_typeCount;
+   pdk::puint32 m_charCount;
+   
+   // size of the data block following the header
+   pdk::pint64 dataSize(int timeSize) const
+   {
+      return pdk::pint64(m_timeCount) * (timeSize + 1) + pdk::pint64(m_typeCount) * 6
+            + m_charCount + pdk::pint64(m_leapCount) * (timeSize + 4)
+            + m_isStdCount + m_isUtcCount;
+   }
+};
+
+struct TzType
+{
+   int m_utcOffset;
+   bool m_isDst;
+   pdk::puint8 m_abbreviationIndex;
+};
+
+inline pdk::puint32 read_be32(const uchar *data)
+{
+   return (pdk::puint32(data[0]) << 24) | (pdk::puint32(data[1]) << 16)
+         | (pdk::puint32(data[2]) << 8) | pdk::puint32(data[3]);
+}
+
+inline pdk::pint64 read_be64(const uchar *data)
+{
+   return pdk::pint64((pdk::puint64(read_be32(data)) << 32) | read_be32(data + 4));
+}
+
+bool parse_tz_header(const uchar *&cursor, const uchar *end, TzHeader &header)
+{
+   if (end - cursor < sg_tzHeaderSize || std::memcmp(cursor, "TZif", 4) != 0) {
+      return false;
+   }
+   header.m_version = char(cursor[4]);
+   const uchar *counts = cursor + 20;
+   header.m_isUtcCount = read_be32(counts);
+   header.m_isStdCount = read_be32(counts + 4);
+   header.m_leapCount = read_be32(counts + 8);
+   header.m_timeCount = read_be32(counts + 12);
+   header.m_typeCount = read_be32(counts + 16);
+   header.m_charCount = read_be32(counts + 20);
+   cursor += sg_tzHeaderSize;
+   // rule indexes are stored in a puint8, which is also the TZif limit on types
+   return header.m_typeCount != 0 && header.m_typeCount <= 256 && header.m_charCount != 0
+         && (header.m_isUtcCount == 0 || header.m_isUtcCount == header.m_typeCount)
+         && (header.m_isStdCount == 0 || header.m_isStdCount == header.m_typeCount)
+         && end - cursor >= header.dataSize(4);
+}
+
+int find_or_add_rule(TzZoneData &zone, const TzTransitionRule &rule)
+{
+   auto iter = std::find(zone.m_tranRules.begin(), zone.m_tranRules.end(), rule);
+   if (iter != zone.m_tranRules.end()) {
+      return int(iter - zone.m_tranRules.begin());
+   }
+   if (zone.m_tranRules.size() >= 256) {
+      return -1;
+   }
+   zone.m_tranRules.push_back(rule);
+   return int(zone.m_tranRules.size()) - 1;
+}
+
+int find_or_add_abbreviation(TzZoneData &zone, const String &abbreviation)
+{
+   auto iter = std::find(zone.m_abbreviations.begin(), zone.m_abbreviations.end(), abbreviation);
+   if (iter != zone.m_abbreviations.end()) {
+      return int(iter - zone.m_abbreviations.begin());
+   }
+   if (zone.m_abbreviations.size() >= 256) {
+      return -1;
+   }
+   zone.m_abbreviations.push_back(abbreviation);
+   return int(zone.m_abbreviations.size()) - 1;
+}
+
+bool parse_posix_number(const char *&cursor, const char *end, int maxDigits, int &value)
+{
+   const char *begin = cursor;
+   value = 0;
+   while (cursor < end && cursor - begin < maxDigits && *cursor >= '0' && *cursor <= '9') {
+      value = value * 10 + (*cursor - '0');
+      ++cursor;
+   }
+   return cursor != begin;
+}
+
+// std and dst are either alphabetic or quoted in angle brackets, at least three characters
+bool parse_posix_name(const char *&cursor, const char *end, String &name)
+{
+   const char *begin = cursor;
+   if (cursor < end && *cursor == '<') {
+      const char *close = static_cast<const char *>(std::memchr(cursor, '>', end - cursor));
+      if (!close) {
+         return false;
+      }
+      begin = cursor + 1;
+      cursor = close + 1;
+      name = String::fromLatin1(begin, int(close - begin));
+   } else {
+      while (cursor < end && ((*cursor >= 'a' && *cursor <= 'z') || (*cursor >= 'A' && *cursor <= 'Z'))) {
+         ++cursor;
+      }
+      name = String::fromLatin1(begin, int(cursor - begin));
+   }
+   return name.size() >= 3;
+}
+
+// [+-]hh[:mm[:ss]]
+bool parse_posix_time(const char *&cursor, const char *end, int maxHours, int &seconds)
+{
+   int sign = 1;
+   if (cursor < end && (*cursor == '+' || *cursor == '-')) {
+      sign = *cursor == '-' ? -1 : 1;
+      ++cursor;
+   }
+   int fields[3] = {0, 0, 0};
+   for (int i = 0; i < 3; ++i) {
+      if (i > 0) {
+         if (cursor == end || *cursor != ':') {
+            break;
+         }
+         ++cursor;
+      }
+      if (!parse_posix_number(cursor, end, i == 0 ? 3 : 2, fields[i])) {
+         return false;
+      }
+   }
+   if (fields[0] > maxHours || fields[1] > 59 || fields[2] > 59) {
+      return false;
+   }
+   seconds = sign * (fields[0] * 3600 + fields[1] * 60 + fields[2]);
+   return true;
+}
+
+bool parse_posix_date(const char *&cursor, const char *end, TzPosixDate &date)
+{
+   if (cursor == end) {
+      return false;
+   }
+   if (*cursor == 'M') {
+      ++cursor;
+      date.m_kind = TzPosixDate::Kind::MonthWeekDay;
+      if (!parse_posix_number(cursor, end, 2, date.m_month) || date.m_month < 1 || date.m_month > 12
+          || cursor == end || *cursor++ != '.'
+          || !parse_posix_number(cursor, end, 1, date.m_week) || date.m_week < 1 || date.m_week > 5
+          || cursor == end || *cursor++ != '.'
+          || !parse_posix_number(cursor, end, 1, date.m_day) || date.m_day > 6) {
+         return false;
+      }
+   } else if (*cursor == 'J') {
+      ++cursor;
+      date.m_kind = TzPosixDate::Kind::JulianNoLeap;
+      if (!parse_posix_number(cursor, end, 3, date.m_day) || date.m_day < 1 || date.m_day > 365) {
+         return false;
+      }
+   } else {
+      date.m_kind = TzPosixDate::Kind::JulianZeroBased;
+      if (!parse_posix_number(cursor, end, 3, date.m_day) || date.m_day > 365) {
+         return false;
+      }
+   }
+   date.m_time = 7200;
+   if (cursor < end && *cursor == '/') {
+      ++cursor;
+      return parse_posix_time(cursor, end, 167, date.m_time);
+   }
+   return true;
+}
+
+// std offset [dst [offset] [,start[/time],end[/time]]]
+bool parse_posix_rule(const ByteArray &text, TzPosixRule &rule)
+{
+   const char *cursor = text.getConstRawData();
+   const char *end = cursor + text.size();
+   int offset;
+   if (!parse_posix_name(cursor, end, rule.m_stdName) || !parse_posix_time(cursor, end, 24, offset)) {
+      return false;
+   }
+   // POSIX counts hours west of Greenwich, we count seconds east of it
+   rule.m_stdOffset = -offset;
+   if (cursor == end) {
+      return true;
+   }
+   if (!parse_posix_name(cursor, end, rule.m_dstName)) {
+      return false;
+   }
+   rule.m_dstOffset = rule.m_stdOffset + 3600;
+   if (cursor < end && *cursor != ',') {
+      if (!parse_posix_time(cursor, end, 24, offset)) {
+         return false;
+      }
+      rule.m_dstOffset = -offset;
+   }
+   if (cursor == end) {
+      // the transition dates are implementation defined, treat as standard time only
+      return true;
+   }
+   if (*cursor++ != ',' || !parse_posix_date(cursor, end, rule.m_start)
+       || cursor == end || *cursor++ != ',' || !parse_posix_date(cursor, end, rule.m_end)
+       || cursor != end) {
+      return false;
+   }
+   rule.m_hasDst = true;
+   return true;
+}
+
+pdk::pint64 posix_date_msecs(const TzPosixDate &date, int year)
+{
+   pdk::pint64 julianDay;
+   switch (date.m_kind) {
+   case TzPosixDate::Kind::JulianNoLeap:
+      julianDay = Date(year, 1, 1).toJulianDay() + date.m_day - 1;
+      if (date.m_day >= 60 && Date::isLeapYear(year)) {
+         ++julianDay;
+      }
+      break;
+   case TzPosixDate::Kind::JulianZeroBased:
+      julianDay = Date(year, 1, 1).toJulianDay() + date.m_day;
+      break;
+   case TzPosixDate::Kind::MonthWeekDay:
+   default: {
+      const Date first(year, date.m_month, 1);
+      // getDayOfWeek() counts Monday as 1 and Sunday as 7, POSIX counts Sunday as 0
+      int day = 1 + (date.m_day - first.getDayOfWeek() % 7 + 7) % 7 + (date.m_week - 1) * 7;
+      if (day > first.getDaysInMonth()) {
+         day -= 7;
+      }
+      julianDay = first.toJulianDay() + day - 1;
+      break;
+   }
+   }
+   return (julianDay - sg_julianDayForEpoch) * sg_msecsPerDay + date.m_time * pdk::pint64(1000);
+}
+
+int year_for_msecs(pdk::pint64 msecs)
+{
+   pdk::pint64 days = msecs / sg_msecsPerDay;
+   if (msecs % sg_msecsPerDay < 0) {
+      --days;
+   }
+   return Date::fromJulianDay(days + sg_julianDayForEpoch).getYear();
+}
+
+// Appends the POSIX rule's transitions for the given years, in order, skipping
+// those not after zone.m_posixFrom
+void append_posix_transitions(const TzZoneData &zone, int firstYear, int lastYear,
+                              std::vector<TzTransitionTime> &transitions)
+{
+   const TzPosixRule &posix = zone.m_posix;
+   firstYear = std::min(std::max(firstYear, sg_posixMinYear), sg_posixMaxYear);
+   lastYear = std::min(std::max(lastYear, sg_posixMinYear), sg_posixMaxYear);
+   for (int year = firstYear; year <= lastYear; ++year) {
+      TzTransitionTime start;
+      TzTransitionTime end;
+      // DST starts at a standard wall clock time and ends at a daylight one
+      start.m_atMSecsSinceEpoch = posix_date_msecs(posix.m_start, year) - posix.m_stdOffset * pdk::pint64(1000);
+      start.m_ruleIndex = zone.m_posixDstRule;
+      end.m_atMSecsSinceEpoch = posix_date_msecs(posix.m_end, year) - posix.m_dstOffset * pdk::pint64(1000);
+      end.m_ruleIndex = zone.m_posixStdRule;
+      if (end.m_atMSecsSinceEpoch < start.m_atMSecsSinceEpoch) {
+         std::swap(start, end);
+      }
+      for (const TzTransitionTime &tran : {start, end}) {
+         if (tran.m_atMSecsSinceEpoch > zone.m_posixFrom) {
+            transitions.push_back(tran);
+         }
+      }
+   }
+}
+
+std::vector<TzTransitionTime> posix_transitions_around(const TzZoneData &zone, pdk::pint64 msecs,
+                                                       int yearsBefore, int yearsAfter)
+{
+   std::vector<TzTransitionTime> transitions;
+   const int year = year_for_msecs(msecs);
+   append_posix_transitions(zone, year - yearsBefore, year + yearsAfter, transitions);
+   return transitions;
+}
+
+struct TransitionBefore
+{
+   bool operator()(pdk::pint64 msecs, const TzTransitionTime &tran) const
+   {
+      return msecs < tran.m_atMSecsSinceEpoch;
+   }
+   
+   bool operator()(const TzTransitionTime &tran, pdk::pint64 msecs) const
+   {
+      return tran.m_atMSecsSinceEpoch < msecs;
+   }
+};
+
+// Adds the POSIX footer's rules and the transition cache, then fills in the
+// derived flags
+bool finish_zone(TzZoneData &zone)
+{
+   if (!zone.m_posixRule.isEmpty() && parse_posix_rule(zone.m_posixRule, zone.m_posix)
+       && zone.m_posix.m_hasDst) {
+      const TzPosixRule &posix = zone.m_posix;
+      const int stdAbbreviation = find_or_add_abbreviation(zone, posix.m_stdName);
+      const int dstAbbreviation = find_or_add_abbreviation(zone, posix.m_dstName);
+      if (stdAbbreviation < 0 || dstAbbreviation < 0) {
+         return false;
+      }
+      const int stdRule = find_or_add_rule(zone, {posix.m_stdOffset, 0, pdk::puint8(stdAbbreviation)});
+      const int dstRule = find_or_add_rule(zone, {posix.m_stdOffset, posix.m_dstOffset - posix.m_stdOffset,
+                                                  pdk::puint8(dstAbbreviation)});
+      if (stdRule < 0 || dstRule < 0) {
+         return false;
+      }
+      zone.m_posixStdRule = pdk::puint8(stdRule);
+      zone.m_posixDstRule = pdk::puint8(dstRule);
+      int firstYear = 1970;
+      if (!zone.m_tranTimes.empty()) {
+         zone.m_posixFrom = zone.m_tranTimes.back().m_atMSecsSinceEpoch;
+         firstYear = year_for_msecs(zone.m_posixFrom);
+      } else {
+         zone.m_initialRule = zone.m_posixStdRule;
+      }
+      append_posix_transitions(zone, firstYear, std::max(firstYear + 1, sg_posixCacheEndYear),
+                               zone.m_tranTimes);
+      if (zone.m_posixFrom == TimeZonePrivate::getMinMSecs()) {
+         zone.m_cacheBegin = zone.m_tranTimes.front().m_atMSecsSinceEpoch;
+      }
+      zone.m_cacheEnd = zone.m_tranTimes.back().m_atMSecsSinceEpoch;
+   } else {
+      zone.m_posix.m_hasDst = false;
+   }
+   zone.m_hasDaylightTime = std::any_of(zone.m_tranRules.begin(), zone.m_tranRules.end(),
+                                        [](const TzTransitionRule &rule) {
+      return rule.m_dstOffset != 0;
+   });
+   return true;
+}
+
+std::shared_ptr<TzZoneData> parse_tz_data(const uchar *data, pdk::pint64 size)
+{
+   const uchar *cursor = data;
+   const uchar *end = data + size;
+   TzHeader header;
+   if (!parse_tz_header(cursor, end, header)) {
+      return nullptr;
+   }
+   int timeSize = 4;
+   if (header.m_version >= '2') {
+      // skip the version 1 block, the 64 bit one after it covers the full range
+      cursor += header.dataSize(4);
+      if (!parse_tz_header(cursor, end, header) || end - cursor < header.dataSize(8)) {
+         return nullptr;
+      }
+      timeSize = 8;
+   }
+   const uchar *times = cursor;
+   const uchar *typeIndexes = times + pdk::pint64(header.m_timeCount) * timeSize;
+   const uchar *types = typeIndexes + header.m_timeCount;
+   const char *chars = reinterpret_cast<const char *>(types + header.m_typeCount * 6);
+   cursor += header.dataSize(timeSize);
+   
+   auto zone = std::make_shared<TzZoneData>();
+   // designations are NUL terminated, an index may point into the middle of one
+   std::vector<TzType> typeList(header.m_typeCount);
+   for (pdk::puint32 i = 0; i < header.m_typeCount; ++i) {
+      const uchar *type = types + i * 6;
+      const pdk::puint32 charIndex = type[5];
+      if (charIndex >= header.m_charCount) {
+         return nullptr;
+      }
+      const char *name = chars + charIndex;
+      const int length = int(pdk::strnlen(name, header.m_charCount - charIndex));
+      typeList[i].m_utcOffset = pdk::pint32(read_be32(type));
+      typeList[i].m_isDst = type[4] != 0;
+      typeList[i].m_abbreviationIndex = pdk::puint8(find_or_add_abbreviation(*zone, String::fromLatin1(name, length)));
+   }
+   if (timeSize == 8 && cursor < end && *cursor == '\n') {
+      const uchar *footer = cursor + 1;
+      const uchar *footerEnd = static_cast<const uchar *>(std::memchr(footer, '\n', end - footer));
+      if (footerEnd) {
+         zone->m_posixRule = ByteArray(reinterpret_cast<const char *>(footer), int(footerEnd - footer));
+      }
+   }
+   
+   // TZif only records the total offset and a DST flag, the standard offset in
+   // effect during DST is taken from the closest preceding standard time type
+   int stdOffset = typeList[0].m_utcOffset;
+   for (pdk::puint32 i = 0; i < header.m_timeCount; ++i) {
+      const pdk::puint8 typeIndex = typeIndexes[i];
+      if (typeIndex < header.m_typeCount && !typeList[typeIndex].m_isDst) {
+         stdOffset = typeList[typeIndex].m_utcOffset;
+         break;
+      }
+   }
+   const TzType &initialType = typeList[0];
+   const int initialStdOffset = initialType.m_isDst ? stdOffset : initialType.m_utcOffset;
+   zone->m_initialRule = pdk::puint8(find_or_add_rule(*zone, {initialStdOffset, initialType.m_utcOffset - initialStdOffset,
+                                                              initialType.m_abbreviationIndex}));
+   zone->m_tranTimes.reserve(header.m_timeCount);
+   for (pdk::puint32 i = 0; i < header.m_timeCount; ++i) {
+      const pdk::puint8 typeIndex = typeIndexes[i];
+      if (typeIndex >= header.m_typeCount) {
+         return nullptr;
+      }
+      const TzType &type = typeList[typeIndex];
+      int tranStdOffset = stdOffset;
+      if (!type.m_isDst) {
+         stdOffset = tranStdOffset = type.m_utcOffset;
+      } else if (type.m_utcOffset == stdOffset) {
+         // DST starting as the standard offset changes, as in Argentina in 1999,
+         // assume the usual hour rather than reporting DST without an offset
+         tranStdOffset = type.m_utcOffset - 3600;
+      }
+      const int ruleIndex = find_or_add_rule(*zone, {tranStdOffset, type.m_utcOffset - tranStdOffset,
+                                                     type.m_abbreviationIndex});
+      if (ruleIndex < 0) {
+         return nullptr;
+      }
+      const pdk::pint64 seconds = timeSize == 8 ? read_be64(times + i * 8)
+                                                : pdk::pint64(pdk::pint32(read_be32(times + i * 4)));
+      TzTransitionTime tran;
+      // version 2 files use -2^59 as a "big bang" time, keep it representable
+      tran.m_atMSecsSinceEpoch = std::min(std::max(seconds, TimeZonePrivate::getMinMSecs() / 1000),
+                                          TimeZonePrivate::getMaxMSecs() / 1000) * 1000;
+      tran.m_ruleIndex = pdk::puint8(ruleIndex);
+      // the times must be ascending, drop anything that would break the binary search
+      if (zone->m_tranTimes.empty()
+          || zone->m_tranTimes.back().m_atMSecsSinceEpoch < tran.m_atMSecsSinceEpoch) {
+         zone->m_tranTimes.push_back(tran);
+      }
+   }
+   if (!finish_zone(*zone)) {
+      return nullptr;
+   }
+   return zone;
+}
+
+std::shared_ptr<TzZoneData> load_tz_file(const String &fileName)
+{
+   File file(fileName);
+   if (!file.open(IoDevice::OpenMode::ReadOnly)) {
+      return nullptr;
+   }
+   const pdk::pint64 size = file.getSize();
+   uchar *memory = size > 0 ? file.map(0, size) : nullptr;
+   if (memory) {
+      std::shared_ptr<TzZoneData> zone = parse_tz_data(memory, size);
+      file.unmap(memory);
+      return zone;
+   }
+   // not every file system can be mapped
+   const ByteArray content = file.readAll();
+   return parse_tz_data(reinterpret_cast<const uchar *>(content.getConstRawData()), content.size());
+}
+
+// A POSIX TZ string can stand in for a zone name, as in TZ="EST5EDT,M3.2.0,M11.1.0"
+std::shared_ptr<TzZoneData> load_posix_zone(const ByteArray &rule)
+{
+   auto zone = std::make_shared<TzZoneData>();
+   zone->m_posixRule = rule;
+   if (!parse_posix_rule(rule, zone->m_posix)) {
+      return nullptr;
+   }
+   const int abbreviation = find_or_add_abbreviation(*zone, zone->m_posix.m_stdName);
+   zone->m_initialRule = pdk::puint8(find_or_add_rule(*zone, {zone->m_posix.m_stdOffset, 0, pdk::puint8(abbreviation)}));
+   if (!finish_zone(*zone)) {
+      return nullptr;
+   }
+   return zone;
+}
+
+std::shared_ptr<TzZoneData> load_tz_zone(const ByteArray &ianaId)
+{
+   if (ianaId.startsWith('/')) {
+      return load_tz_file(String::fromLocal8Bit(ianaId));
+   }
+   if (TimeZonePrivate::isValidId(ianaId) && !ianaId.contains("..")) {
+      const ByteArray tzDir = pdk::get_env("TZDIR");
+      if (!tzDir.isEmpty()) {
+         std::shared_ptr<TzZoneData> zone = load_tz_file(String::fromLocal8Bit(tzDir + '/' + ianaId));
+         if (zone) {
+            return zone;
+         }
+      }
+      for (const char *dir : sg_zoneInfoDirs) {
+         std::shared_ptr<TzZoneData> zone = load_tz_file(String::fromLocal8Bit(dir + ianaId));
+         if (zone) {
+            return zone;
+         }
+      }
+   }
+   return load_posix_zone(ianaId);
+}
+
+// Process wide cache of parsed zones, keyed by IANA id (or file path for the
+// system zone), zones that fail to load are not remembered
+class TzZoneCache
+{
+public:
+   std::shared_ptr<const TzZoneData> findOrLoad(const ByteArray &ianaId)
+   {
+      const std::string key = ianaId.toStdString();
+      {
+         std::lock_guard<std::mutex> locker(m_mutex);
+         auto iter = m_zones.find(key);
+         if (iter != m_zones.end()) {
+            return iter->second;
+         }
+      }
+      // parse outside of the lock, a racing thread loading the same zone is harmless
+      std::shared_ptr<const TzZoneData> zone = load_tz_zone(ianaId);
+      if (!zone) {
+         return nullptr;
+      }
+      std::lock_guard<std::mutex> locker(m_mutex);
+      return m_zones.emplace(key, std::move(zone)).first->second;
+   }
+   
+private:
+   std::mutex m_mutex;
+   std::map<std::string, std::shared_ptr<const TzZoneData>> m_zones;
+};
+
+PDK_GLOBAL_STATIC(TzZoneCache, sg_tzZoneCache);
+
+struct TzZoneInfo
+{
+   Locale::Country m_country;
+   String m_comment;
+};
+
+using TzZoneTable = std::map<std::string, TzZoneInfo>;
+
+TzZoneTable load_tz_zone_table()
+{
+   TzZoneTable table;
+   std::list<String> fileNames;
+   const ByteArray tzDir = pdk::get_env("TZDIR");
+   if (!tzDir.isEmpty()) {
+      fileNames.push_back(String::fromLocal8Bit(tzDir) + Latin1String("/zone.tab"));
+   }
+   for (const char *dir : sg_zoneInfoDirs) {
+      fileNames.push_back(String::fromLatin1(dir) + Latin1String("zone.tab"));
+   }
+   File file;
+   for (const String &fileName : fileNames) {
+      file.setFileName(fileName);
+      if (file.open(IoDevice::OpenMode::ReadOnly)) {
+         break;
+      }
+   }
+   if (!file.isOpen()) {
+      return table;
+   }
+   const ByteArray content = file.readAll();
+   for (const ByteArray &line : content.split('\n')) {
+      // comment lines are prefixed with a #, data rows are tab separated
+      // columns: country code, coordinates, id and an optional comment
+      if (line.isEmpty() || line.at(0) == '#') {
+         continue;
+      }
+      const std::list<ByteArray> parts = line.split('\t');
+      if (parts.size() < 3) {
+         continue;
+      }
+      auto part = parts.begin();
+      const String countryCode = String::fromLatin1(*part);
+      std::advance(part, 2);
+      const std::string ianaId = part->toStdString();
+      TzZoneInfo info;
+      info.m_country = LocalePrivate::codeToCountry(StringView(countryCode));
+      if (++part != parts.end()) {
+         info.m_comment = String::fromUtf8(*part);
+      }
+      table.emplace(ianaId, info);
+   }
+   return table;
+}
+
+PDK_GLOBAL_STATIC_WITH_ARGS(const TzZoneTable, sg_tzZones, (load_tz_zone_table()));
+
+// the TZ env var, a leading ':' only marks an implementation defined value
+ByteArray tz_env_value()
+{
+   ByteArray value = pdk::get_env("TZ");
+   if (!value.isEmpty() && value.at(0) == ':') {
+      value = value.mid(1);
+   }
+   return value;
+}
+
+// the name of the zone /etc/localtime holds
+ByteArray local_time_zone_id()
+{
+   // On most distros /etc/localtime is a symlink to a real file so extract name from the path
+   const String path = File::getSymLinkTarget(StringLiteral("/etc/localtime"));
+   const int index = path.indexOf(Latin1String("/zoneinfo/"));
+   if (index != -1) {
+      return path.substring(index + 10).toUtf8();
+   }
+   // On Debian /etc/localtime may be a regular file while the name is in /etc/timezone
+   File file(StringLiteral("/etc/timezone"));
+   if (file.open(IoDevice::OpenMode::ReadOnly)) {
+      const ByteArray content = file.readAll();
+      const int lineEnd = content.indexOf('\n');
+      return content.left(lineEnd == -1 ? content.size() : lineEnd).trimmed();
+   }
+   return ByteArray();
+}
+
+} // anonymous namespace
+
+// Create the system default time zone
+TzTimeZonePrivate::TzTimeZonePrivate()
+{
+   ByteArray ianaId = getSystemTimeZoneId();
+   const ByteArray tzPath = tz_env_value();
+   if (tzPath.startsWith('/') && tzPath != "/etc/localtime") {
+      // the file TZ names is what the C library uses, wherever it lives
+      m_zone = sg_tzZoneCache->findOrLoad(tzPath);
+      if (m_zone) {
+         m_id = ianaId;
+         return;
+      }
+      ianaId = local_time_zone_id();
+      if (ianaId.isEmpty()) {
+         ianaId = getUtcByteArray();
+      }
+   }
+   init(ianaId);
+   if (!m_zone) {
+      // /etc/localtime may be a copy of a zone file whose name is not known
+      m_zone = sg_tzZoneCache->findOrLoad(ByteArrayLiteral("/etc/localtime"));
+      if (m_zone) {
+         m_id = ianaId;
+      }
+   }
+}
+
+// Create a named time zone
+TzTimeZonePrivate::TzTimeZonePrivate(const ByteArray &ianaId)
+{
+   init(ianaId);
+}
+
+TzTimeZonePrivate::~TzTimeZonePrivate()
+{}
+
+TzTimeZonePrivate *TzTimeZonePrivate::clone() const
+{
+   return new TzTimeZonePrivate(*this);
+}
+
+void TzTimeZonePrivate::init(const ByteArray &ianaId)
+{
+   if (ianaId.isEmpty() || ianaId.startsWith('/')) {
+      return;
+   }
+   m_zone = sg_tzZoneCache->findOrLoad(ianaId);
+   if (m_zone) {
+      m_id = ianaId;
+   }
+}
+
+Locale::Country TzTimeZonePrivate::getCountry() const
+{
+   auto iter = sg_tzZones->find(m_id.toStdString());
+   return iter != sg_tzZones->end() ? iter->second.m_country : Locale::Country::AnyCountry;
+}
+
+String TzTimeZonePrivate::getComment() const
+{
+   auto iter = sg_tzZones->find(m_id.toStdString());
+   return iter != sg_tzZones->end() ? iter->second.m_comment : String();
+}
+
+String TzTimeZonePrivate::displayName(pdk::pint64 atMSecsSinceEpoch,
+                                      TimeZone::NameType nameType,
+                                      const Locale &locale) const
+{
+#if PDK_CONFIG(icu)
+   if (!m_icu) {
+      m_icu = new IcuTimeZonePrivate(m_id);
+   }
+   // ICU's own zone data may be older or newer than the tzfile, so the time
+   // type comes from the tzfile and ICU only supplies the name
+   if (m_icu->isValid()) {
+      const TimeZone::TimeType timeType = isDaylightTime(atMSecsSinceEpoch)
+            ? TimeZone::TimeType::DaylightTime : TimeZone::TimeType::StandardTime;
+      return m_icu->displayName(timeType, nameType, locale);
+   }
+#else
+   PDK_UNUSED(nameType);
+   PDK_UNUSED(locale);
+#endif
+   return abbreviation(atMSecsSinceEpoch);
+}
+
+String TzTimeZonePrivate::displayName(TimeZone::TimeType timeType,
+                                      TimeZone::NameType nameType,
+                                      const Locale &locale) const
+{
+#if PDK_CONFIG(icu)
+   if (!m_icu) {
+      m_icu = new IcuTimeZonePrivate(m_id);
+   }
+   if (m_icu->isValid()) {
+      return m_icu->displayName(timeType, nameType, locale);
+   }
+#else
+   PDK_UNUSED(nameType);
+   PDK_UNUSED(locale);
+#endif
+   // If no ICU available then have to use abbreviations instead
+   // Abbreviations don't have GenericTime
+   if (timeType == TimeZone::TimeType::GenericTime) {
+      timeType = TimeZone::TimeType::StandardTime;
+   }
+   const bool wantDaylight = timeType == TimeZone::TimeType::DaylightTime;
+   auto matches = [wantDaylight](const Data &tran) {
+      return tran.m_atMSecsSinceEpoch != getInvalidMSecs()
+            && (tran.m_daylightTimeOffset != 0) == wantDaylight;
+   };
+   // Try the current, next and previous periods before searching the whole table
+   const pdk::pint64 currentMSecs = DateTime::getCurrentMSecsSinceEpoch();
+   Data tran = data(currentMSecs);
+   if (matches(tran)) {
+      return tran.m_abbreviation;
+   }
+   tran = nextTransition(currentMSecs);
+   if (matches(tran)) {
+      return tran.m_abbreviation;
+   }
+   tran = previousTransition(currentMSecs);
+   if (tran.m_atMSecsSinceEpoch != getInvalidMSecs()) {
+      tran = previousTransition(tran.m_atMSecsSinceEpoch);
+   }
+   if (matches(tran)) {
+      return tran.m_abbreviation;
+   }
+   if (m_zone) {
+      const std::vector<TzTransitionTime> &tranTimes = m_zone->m_tranTimes;
+      auto iter = std::upper_bound(tranTimes.begin(), tranTimes.end(), currentMSecs, TransitionBefore());
+      while (iter != tranTimes.begin()) {
+         --iter;
+         tran = dataForTzTransition(*iter);
+         if (matches(tran)) {
+            return tran.m_abbreviation;
+         }
+      }
+   }
+   // Otherwise if no match use current data
+   return data(currentMSecs).m_abbreviation;
+}
+
+String TzTimeZonePrivate::abbreviation(pdk::pint64 atMSecsSinceEpoch) const
+{
+   return data(atMSecsSinceEpoch).m_abbreviation;
+}
+
+int TzTimeZonePrivate::offsetFromUtc(pdk::pint64 atMSecsSinceEpoch) const
+{
+   const Data tran = data(atMSecsSinceEpoch);
+   return tran.m_offsetFromUtc; // == tran.m_standardTimeOffset + tran.m_daylightTimeOffset
+}
+
+int TzTimeZonePrivate::standardTimeOffset(pdk::pint64 atMSecsSinceEpoch) const
+{
+   return data(atMSecsSinceEpoch).m_standardTimeOffset;
+}
+
+int TzTimeZonePrivate::daylightTimeOffset(pdk::pint64 atMSecsSinceEpoch) const
+{
+   return data(atMSecsSinceEpoch).m_daylightTimeOffset;
+}
+
+bool TzTimeZonePrivate::hasDaylightTime() const
+{
+   return m_zone && m_zone->m_hasDaylightTime;
+}
+
+bool TzTimeZonePrivate::isDaylightTime(pdk::pint64 atMSecsSinceEpoch) const
+{
+   return data(atMSecsSinceEpoch).m_daylightTimeOffset != 0;
+}
+
+TimeZonePrivate::Data TzTimeZonePrivate::dataForTzTransition(TzTransitionTime tran) const
+{
+   const TzTransitionRule &rule = m_zone->m_tranRules[tran.m_ruleIndex];
+   Data data;
+   data.m_atMSecsSinceEpoch = tran.m_atMSecsSinceEpoch;
+   data.m_standardTimeOffset = rule.m_stdOffset;
+   data.m_daylightTimeOffset = rule.m_dstOffset;
+   data.m_offsetFromUtc = rule.m_stdOffset + rule.m_dstOffset;
+   data.m_abbreviation = m_zone->m_abbreviations[rule.m_abbreviationIndex];
+   return data;
+}
+
+TimeZonePrivate::Data TzTimeZonePrivate::data(pdk::pint64 forMSecsSinceEpoch) const
+{
+   if (!m_zone) {
+      return getInvalidData();
+   }
+   const TzZoneData &zone = *m_zone;
+   TzTransitionTime tran;
+   tran.m_atMSecsSinceEpoch = forMSecsSinceEpoch;
+   tran.m_ruleIndex = zone.m_initialRule;
+   if (zone.usesPosixRule(forMSecsSinceEpoch)) {
+      const std::vector<TzTransitionTime> transitions = posix_transitions_around(zone, forMSecsSinceEpoch, 1, 1);
+      auto iter = std::upper_bound(transitions.begin(), transitions.end(), forMSecsSinceEpoch, TransitionBefore());
+      if (iter != transitions.begin()) {
+         tran.m_ruleIndex = (iter - 1)->m_ruleIndex;
+      } else if (!transitions.empty()) {
+         // the rules alternate, so before the first one the other was in force
+         tran.m_ruleIndex = iter->m_ruleIndex == zone.m_posixDstRule ? zone.m_posixStdRule : zone.m_posixDstRule;
+      }
+   } else {
+      const std::vector<TzTransitionTime> &tranTimes = zone.m_tranTimes;
+      auto iter = std::upper_bound(tranTimes.begin(), tranTimes.end(), forMSecsSinceEpoch, TransitionBefore());
+      if (iter != tranTimes.begin()) {
+         tran.m_ruleIndex = (iter - 1)->m_ruleIndex;
+      }
+   }
+   Data data = dataForTzTransition(tran);
+   data.m_atMSecsSinceEpoch = forMSecsSinceEpoch;
+   return data;
+}
+
+bool TzTimeZonePrivate::hasTransitions() const
+{
+   return m_zone && !m_zone->m_tranTimes.empty();
+}
+
+TimeZonePrivate::Data TzTimeZonePrivate::nextTransition(pdk::pint64 afterMSecsSinceEpoch) const
+{
+   if (!m_zone) {
+      return getInvalidData();
+   }
+   const TzZoneData &zone = *m_zone;
+   if (zone.usesPosixRule(afterMSecsSinceEpoch)
+       || (zone.m_posix.m_hasDst && afterMSecsSinceEpoch == zone.m_cacheEnd)) {
+      const std::vector<TzTransitionTime> transitions = posix_transitions_around(zone, afterMSecsSinceEpoch, 0, 1);
+      auto iter = std::upper_bound(transitions.begin(), transitions.end(), afterMSecsSinceEpoch, TransitionBefore());
+      if (iter != transitions.end()) {
+         return dataForTzTransition(*iter);
+      }
+   }
+   const std::vector<TzTransitionTime> &tranTimes = zone.m_tranTimes;
+   auto iter = std::upper_bound(tranTimes.begin(), tranTimes.end(), afterMSecsSinceEpoch, TransitionBefore());
+   return iter != tranTimes.end() ? dataForTzTransition(*iter) : getInvalidData();
+}
+
+TimeZonePrivate::Data TzTimeZonePrivate::previousTransition(pdk::pint64 beforeMSecsSinceEpoch) const
+{
+   if (!m_zone) {
+      return getInvalidData();
+   }
+   const TzZoneData &zone = *m_zone;
+   if (zone.usesPosixRule(beforeMSecsSinceEpoch)
+       || (zone.m_posix.m_hasDst && beforeMSecsSinceEpoch == zone.m_cacheBegin)) {
+      const std::vector<TzTransitionTime> transitions = posix_transitions_around(zone, beforeMSecsSinceEpoch, 1, 0);
+      auto iter = std::lower_bound(transitions.begin(), transitions.end(), beforeMSecsSinceEpoch, TransitionBefore());
+      if (iter != transitions.begin()) {
+         return dataForTzTransition(*(iter - 1));
+      }
+      if (beforeMSecsSinceEpoch <= zone.m_cacheBegin) {
+         return getInvalidData();
+      }
+   }
+   const std::vector<TzTransitionTime> &tranTimes = zone.m_tranTimes;
+   auto iter = std::lower_bound(tranTimes.begin(), tranTimes.end(), beforeMSecsSinceEpoch, TransitionBefore());
+   return iter != tranTimes.begin() ? dataForTzTransition(*(iter - 1)) : getInvalidData();
+}
+
+ByteArray TzTimeZonePrivate::getSystemTimeZoneId() const
+{
+   // Check TZ env var first
+   ByteArray ianaId = tz_env_value();
+   if (ianaId == "/etc/localtime") {
+      // names the default zone, which is found below
+      ianaId.clear();
+   } else if (ianaId.startsWith('/')) {
+      // a zone file is named by its place in a zoneinfo directory, other
+      // paths are their own name
+      const int index = ianaId.indexOf("/zoneinfo/");
+      if (index != -1) {
+         ianaId = ianaId.mid(index + 10);
+      }
+   }
+   if (ianaId.isEmpty()) {
+      ianaId = local_time_zone_id();
+   }
+   // Give up for now and return UTC
+   if (ianaId.isEmpty()) {
+      ianaId = getUtcByteArray();
+   }
+   return ianaId;
+}
+
+std::list<ByteArray> TzTimeZonePrivate::getAvailableTimeZoneIds() const
+{
+   // the table is ordered by id already
+   std::list<ByteArray> result;
+   for (const auto &zone : *sg_tzZones) {
+      result.push_back(ByteArray::fromStdString(zone.first));
+   }
+   return result;
+}
+
+std::list<ByteArray> TzTimeZonePrivate::getAvailableTimeZoneIds(Locale::Country country) const
+{
+   std::list<ByteArray> result;
+   for (const auto &zone : *sg_tzZones) {
+      if (country == Locale::Country::AnyCountry || zone.second.m_country == country) {
+         result.push_back(ByteArray::fromStdString(zone.first));
+      }
+   }
+   return result;
+}
+
+} // internal
+} // time
+} // pdk
@@ -49,11 +49,12 @@ void Data::compact()
    int alloc = sizeof(Header) + size;
    Header *h = (Header *) malloc(alloc);
    h->m_tag = JsonDocument::BinaryFormatTag;
-   h->m_version = 1;
+   h->m_version = m_header->m_version;
    Base *b = h->getRoot();
    b->m_size = size;
    b->m_isObject = m_header->getRoot()->m_isObject;
    b->m_length = base->m_length;
+   b->m_wideOffsets = base->m_wideOffsets;
    b->m_tableOffset = reserve + sizeof(LocalArray);
    int offset = sizeof(Base);
    if (b->m_isObject) {
@@ -69,7 +70,7 @@ void Data::compact()
          int dataSize = e->m_value.getUsedStorage(o);
          if (dataSize) {
             memcpy((char *)no + offset, e->m_value.getData(o), dataSize);
-            ne->m_value.m_value = offset;
+            ne->m_value.m_value = b->toValueOffset(offset);
             offset += dataSize;
          }
       }
@@ -83,40 +84,74 @@ void Data::compact()
          int dataSize = v.getUsedStorage(a);
          if (dataSize) {
             memcpy((char *)na + offset, v.getData(a), dataSize);
-            nv.m_value = offset;
+            nv.m_value = b->toValueOffset(offset);
             offset += dataSize;
          }
       }
    }
    PDK_ASSERT(offset == (int)b->m_tableOffset);
    
-   free(m_header);
+   if (m_ownsData) {
+      free(m_header);
+   }
    m_header = h;
    m_alloc = alloc;
    m_compactionCounter = 0;
+   m_ownsData = true;
+   m_sharedData.clear();
+   // the offsets moved, a bit set for the old layout means nothing now
+   if (m_checkContainers) {
+      checkContainersLazily();
+   }
 }
 
-bool Data::valid() const
+bool Data::valid(bool recursive) const
 {
-   if (m_header->m_tag != JsonDocument::BinaryFormatTag || m_header->m_version != 1u) {
+   if (m_header->m_tag != JsonDocument::BinaryFormatTag ||
+       (m_header->m_version != 1u && m_header->m_version != 2u)) {
       return false;
    }
    bool res = false;
    Base *root = m_header->getRoot();
    int maxSize = m_alloc - sizeof(Header);
    if (root->m_isObject) {
-      res = static_cast<LocalObject *>(root)->isValid(maxSize);
+      res = static_cast<LocalObject *>(root)->isValid(maxSize, recursive);
    } else {
-      res = static_cast<LocalArray *>(root)->isValid(maxSize);
+      res = static_cast<LocalArray *>(root)->isValid(maxSize, recursive);
    }
    return res;
 }
 
+void Data::checkContainersLazily()
+{
+   m_checkContainers = true;
+   m_validContainers.reset(new std::atomic<uint>[(m_alloc / 4 + 31) / 32]());
+}
+
+bool Data::isValidContainer(const Base *base)
+{
+   const std::ptrdiff_t pos = (const char *)base - (const char *)m_header;
+   if (!m_validContainers || pos < 0 || pos >= m_alloc || (pos & 3)) {
+      return base->isShallowValid();
+   }
+   const uint slot = uint(pos) / 4;
+   const uint bit = 1u << (slot % 32);
+   std::atomic<uint> &word = m_validContainers[slot / 32];
+   if (word.load(std::memory_order_relaxed) & bit) {
+      return true;
+   }
+   if (!base->isShallowValid()) {
+      return false;
+   }
+   word.fetch_or(bit, std::memory_order_relaxed);
+   return true;
+}
+
 int Base::reserveSpace(uint dataSize, int posInTable, uint numItems, bool replace)
 {
    PDK_ASSERT(posInTable >= 0 && posInTable <= (int)m_length);
-   if (m_size + dataSize >= LocalValue::MaxSize) {
-      warning_stream("Json: Document too large to store in data structure %d %d %d", (uint)m_size, dataSize, LocalValue::MaxSize);
+   if (m_size + dataSize >= getMaxSize()) {
+      warning_stream("Json: Document too large to store in data structure %d %d %d", (uint)m_size, dataSize, getMaxSize());
       return 0;
    }
    offset off = m_tableOffset;
@@ -192,12 +227,22 @@ int LocalObject::indexOf(Latin1String key, bool *exists) const
    return min;
 }
 
-bool LocalObject::isValid(int maxSize) const
+bool Base::isShallowValid() const
+{
+   if (m_isObject) {
+      return static_cast<const LocalObject *>(this)->isValid(m_size, false);
+   }
+   return static_cast<const LocalArray *>(this)->isValid(m_size, false);
+}
+
+bool LocalObject::isValid(int maxSize, bool recursive) const
 {
    if (m_size > (uint)maxSize || m_tableOffset + m_length * sizeof(offset) > m_size) {
       return false;
    }
-   String lastKey;
+   // keys are compared in place, validating a large mapped document must not
+   // allocate a String per entry
+   const LocalEntry *lastEntry = nullptr;
    for (uint i = 0; i < m_length; ++i) {
       offset entryOffset = getTable()[i];
       if (entryOffset + sizeof(LocalEntry) >= m_tableOffset) {
@@ -206,25 +251,24 @@ bool LocalObject::isValid(int maxSize) const
       LocalEntry *e = entryAt(i);
       if (!e->isValid(m_tableOffset - getTable()[i]))
          return false;
-      String key = e->getKey();
-      if (key < lastKey) {
+      if (lastEntry && !(*e >= *lastEntry)) {
          return false;
       } 
-      if (!e->m_value.isValid(this)) {
+      if (!e->m_value.isValid(this, recursive)) {
          return false;
       }
-      lastKey = key;
+      lastEntry = e;
    }
    return true;
 }
 
-bool LocalArray::isValid(int maxSize) const
+bool LocalArray::isValid(int maxSize, bool recursive) const
 {
    if (m_size > (uint)maxSize || m_tableOffset + m_length * sizeof(offset) > m_size) {
       return false;
    }
    for (uint i = 0; i < m_length; ++i) {
-      if (!at(i).isValid(this)) {
+      if (!at(i).isValid(this, recursive)) {
          return false;
       }
    }
@@ -306,7 +350,7 @@ int LocalValue::getUsedStorage(const Base *b) const
    return aligned_size(s);
 }
 
-bool LocalValue::isValid(const Base *b) const
+bool LocalValue::isValid(const Base *b, bool recursive) const
 {
    int offset = 0;
    switch (JsonValue::Type(static_cast<uint>(m_type))) {
@@ -318,7 +362,7 @@ bool LocalValue::isValid(const Base *b) const
    case JsonValue::Type::String:
    case JsonValue::Type::Array:
    case JsonValue::Type::Object:
-      offset = m_value;
+      offset = b->fromValueOffset(m_value);
       break;
    case JsonValue::Type::Null:
    case JsonValue::Type::Bool:
@@ -339,11 +383,20 @@ bool LocalValue::isValid(const Base *b) const
       return false;
    }
    
+   if ((m_type == pdk::as_integer<JsonValue::Type>(JsonValue::Type::Array) ||
+        m_type == pdk::as_integer<JsonValue::Type>(JsonValue::Type::Object)) &&
+       s < (int)sizeof(Base)) {
+      return false;
+   }
    if (m_type == pdk::as_integer<JsonValue::Type>(JsonValue::Type::Array)) {
-      return static_cast<LocalArray *>(base(b))->isValid(s);
+      const LocalArray *array = static_cast<LocalArray *>(base(b));
+      return recursive ? array->isValid(s)
+                       : array->m_tableOffset + array->m_length * sizeof(offset) <= array->m_size;
    }
    if (m_type == pdk::as_integer<JsonValue::Type>(JsonValue::Type::Object)) {
-      return static_cast<LocalObject *>(base(b))->isValid(s);
+      const LocalObject *object = static_cast<LocalObject *>(base(b));
+      return recursive ? object->isValid(s)
+                       : object->m_tableOffset + object->m_length * sizeof(offset) <= object->m_size;
    }
    return true;
 }
@@ -379,7 +432,7 @@ int LocalValue::requiredStorage(JsonValue &v, bool *compressed)
    return 0;
 }
 
-uint LocalValue::valueToStore(const JsonValue &v, uint offset)
+uint LocalValue::valueToStore(const Base *b, const JsonValue &v, uint offset)
 {
    switch (v.m_type) {
    case JsonValue::Type::Undefined:
@@ -397,12 +450,12 @@ uint LocalValue::valueToStore(const JsonValue &v, uint offset)
    case JsonValue::Type::String:
    case JsonValue::Type::Array:
    case JsonValue::Type::Object:
-      return offset;
+      return b->toValueOffset(offset);
    }
    return 0;
 }
 
-void LocalValue::copyData(const JsonValue &v, char *dest, bool compressed)
+void LocalValue::copyData(const JsonValue &v, char *dest, bool compressed, Data *target)
 {
    switch (v.m_type) {
    case JsonValue::Type::Double:
@@ -422,6 +475,11 @@ void LocalValue::copyData(const JsonValue &v, char *dest, bool compressed)
          b = (v.m_type == JsonValue::Type::Array ? &sg_emptyArray : &sg_emptyObject);
       }
       memcpy(dest, b, b->m_size);
+      // a wide container keeps its layout, so the document it lands in
+      // has to announce version 2 as well
+      if (v.m_data && v.m_data->m_header->m_version > target->m_header->m_version) {
+         target->m_header->m_version = v.m_data->m_header->m_version;
+      }
       break;
    }
    default:
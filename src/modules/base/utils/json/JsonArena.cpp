@@ -0,0 +1,155 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/base/utils/json/JsonArena.h"
+#include "pdk/base/utils/json/internal/JsonParserPrivate.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace pdk {
+namespace utils {
+namespace json {
+
+namespace {
+
+// enough for the header and the doubles of a binary document
+const size_t sg_alignment = 8;
+
+inline size_t align_size(size_t size)
+{
+   return (size + sg_alignment - 1) & ~(sg_alignment - 1);
+}
+
+} // anonymous namespace
+
+// blocks stay linked in the order they were first used, reset() starts
+// over at the head and walks the same chain again
+struct JsonArena::Block
+{
+   Block *m_next;
+   size_t m_size;
+
+   char *getData()
+   {
+      return reinterpret_cast<char *>(this) + align_size(sizeof(Block));
+   }
+};
+
+JsonArena::JsonArena(int blockSize)
+   : m_first(nullptr),
+     m_current(nullptr),
+     m_offset(0),
+     m_last(nullptr),
+     m_blockSize(align_size(std::max(blockSize, 256))),
+     m_bytesUsed(0),
+     m_bytesReserved(0),
+     m_parserStacks(nullptr)
+{}
+
+JsonArena::~JsonArena()
+{
+   Block *block = m_first;
+   while (block) {
+      Block *next = block->m_next;
+      std::free(block);
+      block = next;
+   }
+   delete m_parserStacks;
+}
+
+void JsonArena::reset()
+{
+   m_current = m_first;
+   m_offset = 0;
+   m_last = nullptr;
+   m_bytesUsed = 0;
+}
+
+int JsonArena::getBlockSize() const
+{
+   return static_cast<int>(m_blockSize);
+}
+
+size_t JsonArena::getBytesUsed() const
+{
+   return m_bytesUsed;
+}
+
+size_t JsonArena::getBytesReserved() const
+{
+   return m_bytesReserved;
+}
+
+char *JsonArena::allocate(size_t size)
+{
+   size = align_size(size);
+   if (!m_current || m_current->m_size - m_offset < size) {
+      // the rest of the current block is given up, a document needs one
+      // contiguous buffer
+      Block *next = m_current ? m_current->m_next : m_first;
+      if (!next || next->m_size < size) {
+         size_t blockSize = std::max(m_blockSize, size);
+         Block *block = static_cast<Block *>(std::malloc(align_size(sizeof(Block)) + blockSize));
+         if (!block) {
+            return nullptr;
+         }
+         block->m_size = blockSize;
+         block->m_next = next;
+         if (m_current) {
+            m_current->m_next = block;
+         } else {
+            m_first = block;
+         }
+         m_bytesReserved += blockSize;
+         next = block;
+      }
+      m_current = next;
+      m_offset = 0;
+   }
+   m_last = m_current->getData() + m_offset;
+   m_offset += size;
+   m_bytesUsed += size;
+   return m_last;
+}
+
+char *JsonArena::reallocate(char *ptr, size_t size, size_t newSize)
+{
+   if (ptr && ptr == m_last) {
+      size_t start = m_last - m_current->getData();
+      if (m_current->m_size - start >= align_size(newSize)) {
+         m_bytesUsed += align_size(newSize) - (m_offset - start);
+         m_offset = start + align_size(newSize);
+         return ptr;
+      }
+   }
+   char *newPtr = allocate(newSize);
+   if (newPtr && ptr) {
+      std::memcpy(newPtr, ptr, std::min(size, newSize));
+   }
+   return newPtr;
+}
+
+jsonprivate::ParserStacks *JsonArena::getParserStacks()
+{
+   if (!m_parserStacks) {
+      m_parserStacks = new jsonprivate::ParserStacks;
+   }
+   return m_parserStacks;
+}
+
+} // json
+} // utils
+} // pdk
@@ -115,9 +115,9 @@ JsonArray JsonArray::fromAnyList(const AnyList &list)
       value->m_type = pdk::as_integer<JsonValue::Type>((val.m_type == JsonValue::Type::Undefined ? JsonValue::Type::Null : val.m_type));
       value->m_latinOrIntValue = latinOrIntValue;
       value->m_latinKey = false;
-      value->m_value = jsonprivate::LocalValue::valueToStore(val, currentOffset);
+      value->m_value = jsonprivate::LocalValue::valueToStore(array.m_array, val, currentOffset);
       if (valueSize) {
-         jsonprivate::LocalValue::copyData(val, (char *)array.m_array + currentOffset, latinOrIntValue);
+         jsonprivate::LocalValue::copyData(val, (char *)array.m_array + currentOffset, latinOrIntValue, array.m_data);
       }
       currentOffset += valueSize;
       array.m_array->m_size = currentOffset;
@@ -234,9 +234,9 @@ void JsonArray::insert(int i, const JsonValue &value)
    v.m_type = pdk::as_integer<JsonValue::Type>((val.m_type == JsonValue::Type::Undefined ? JsonValue::Type::Null : val.m_type));
    v.m_latinOrIntValue = compressed;
    v.m_latinKey = false;
-   v.m_value = jsonprivate::LocalValue::valueToStore(val, valueOffset);
+   v.m_value = jsonprivate::LocalValue::valueToStore(m_array, val, valueOffset);
    if (valueSize) {
-      jsonprivate::LocalValue::copyData(val, (char *)m_array + valueOffset, compressed);
+      jsonprivate::LocalValue::copyData(val, (char *)m_array + valueOffset, compressed, m_data);
    } 
 }
 
@@ -260,9 +260,9 @@ void JsonArray::replace(int i, const JsonValue &value)
    v.m_type = pdk::as_integer<JsonValue::Type>((val.m_type == JsonValue::Type::Undefined ? JsonValue::Type::Null : val.m_type));
    v.m_latinOrIntValue = compressed;
    v.m_latinKey = false;
-   v.m_value = jsonprivate::LocalValue::valueToStore(val, valueOffset);
+   v.m_value = jsonprivate::LocalValue::valueToStore(m_array, val, valueOffset);
    if (valueSize) {
-      jsonprivate::LocalValue::copyData(val, (char *)m_array + valueOffset, compressed);
+      jsonprivate::LocalValue::copyData(val, (char *)m_array + valueOffset, compressed, m_data);
    }
    ++m_data->m_compactionCounter;
    if (m_data->m_compactionCounter > 32u && m_data->m_compactionCounter >= unsigned(m_array->m_length) / 2u) {
@@ -330,7 +330,7 @@ bool JsonArray::detach(uint reserve)
       m_data->m_ref.ref();
       return true;
    }
-   if (reserve == 0 && m_data->m_ref.load() == 1)
+   if (reserve == 0 && m_data->m_ref.load() == 1 && m_data->m_ownsData)
       return true;
    
    jsonprivate::Data *x = m_data->clone(m_array, reserve);
@@ -365,7 +365,7 @@ Debug operator<<(Debug dbg, const JsonArray &array)
       return dbg;
    }
    ByteArray json;
-   jsonprivate::Writer::arrayToJson(array.m_array, json, 0, true);
+   jsonprivate::Writer::arrayToJson(array.m_array, json, 0, true, array.m_data->m_checkContainers);
    dbg.nospace() << "JsonArray("
                  << json.getConstRawData() // print as utf-8 string without extra quotation marks
                  << ")";
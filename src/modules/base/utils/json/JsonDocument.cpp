@@ -89,11 +89,20 @@ JsonDocument JsonDocument::fromRawData(const char *data, int size, DataValidatio
       warning_stream("JsonDocument::fromRawData: data has to have 4 byte alignment");
       return JsonDocument();
    }
+   // only a version 2 document may grow past the version 1 limit
+   if (size > jsonprivate::LocalValue::MaxSize &&
+       size > jsonprivate::Header::getMaxSize(reinterpret_cast<const jsonprivate::Header *>(data)->m_version)) {
+      warning_stream("JsonDocument::fromRawData: document too large for the binary format");
+      return JsonDocument();
+   }
    jsonprivate::Data *d = new jsonprivate::Data(const_cast<char *>(data), size);
    d->m_ownsData = false;
-   if (validation != DataValidation::BypassValidation && !d->valid()) {
-      delete d;
-      return JsonDocument();
+   if (validation != DataValidation::BypassValidation) {
+      if (!d->valid(false)) {
+         delete d;
+         return JsonDocument();
+      }
+      d->checkContainersLazily();
    }
    return JsonDocument(d);
 }
@@ -119,20 +128,36 @@ JsonDocument JsonDocument::fromBinaryData(const ByteArray &data, DataValidation
    memcpy(&root, data.getConstRawData() + sizeof(jsonprivate::Header), sizeof(jsonprivate::Base));
    
    // do basic checks here, so we don't try to allocate more memory than we can.
-   if (h.m_tag != JsonDocument::BinaryFormatTag || h.m_version != 1u ||
+   if (h.m_tag != JsonDocument::BinaryFormatTag || (h.m_version != 1u && h.m_version != 2u) ||
        sizeof(jsonprivate::Header) + root.m_size > (uint)data.size()) {
       return JsonDocument();
    }
    const uint size = sizeof(jsonprivate::Header) + root.m_size;
-   char *raw = (char *)malloc(size);
-   if (!raw) {
+   if (size > (uint)jsonprivate::Header::getMaxSize(h.m_version)) {
+      warning_stream("JsonDocument::fromBinaryData: document too large for the binary format");
       return JsonDocument();
    }
-   memcpy(raw, data.getConstRawData(), size);
-   jsonprivate::Data *d = new jsonprivate::Data(raw, size);
-   if (validation != DataValidation::BypassValidation && !d->valid()) {
-      delete d;
-      return JsonDocument();
+   jsonprivate::Data *d;
+   if (pdk::uintptr(data.getConstRawData()) & 3) {
+      char *raw = (char *)malloc(size);
+      if (!raw) {
+         return JsonDocument();
+      }
+      memcpy(raw, data.getConstRawData(), size);
+      d = new jsonprivate::Data(raw, size);
+   } else {
+      // values are read in place, the document shares the buffer of data
+      // and only copies it once it gets modified
+      d = new jsonprivate::Data(const_cast<char *>(data.getConstRawData()), size);
+      d->m_ownsData = false;
+      d->m_sharedData = data;
+   }
+   if (validation != DataValidation::BypassValidation) {
+      if (!d->valid(false)) {
+         delete d;
+         return JsonDocument();
+      }
+      d->checkContainersLazily();
    }
    return JsonDocument(d);
 }
@@ -178,9 +203,11 @@ ByteArray JsonDocument::toJson(JsonFormat format) const
       return json;
    }
    if (m_data->m_header->getRoot()->isArray()) {
-      jsonprivate::Writer::arrayToJson(static_cast<jsonprivate::LocalArray *>(m_data->m_header->getRoot()), json, 0, (format == JsonFormat::Compact));
+      jsonprivate::Writer::arrayToJson(static_cast<jsonprivate::LocalArray *>(m_data->m_header->getRoot()), json, 0, (format == JsonFormat::Compact),
+                                       m_data->m_checkContainers);
    } else {
-      jsonprivate::Writer::objectToJson(static_cast<jsonprivate::LocalObject *>(m_data->m_header->getRoot()), json, 0, (format == JsonFormat::Compact));
+      jsonprivate::Writer::objectToJson(static_cast<jsonprivate::LocalObject *>(m_data->m_header->getRoot()), json, 0, (format == JsonFormat::Compact),
+                                        m_data->m_checkContainers);
    }   
    return json;
 }
@@ -192,6 +219,12 @@ JsonDocument JsonDocument::fromJson(const ByteArray &json, JsonParseError *error
    return parser.parse(error);
 }
 
+JsonDocument JsonDocument::fromJson(const ByteArray &json, JsonArena *arena, JsonParseError *error)
+{
+   jsonprivate::Parser parser(json.getConstRawData(), json.length(), arena);
+   return parser.parse(error);
+}
+
 bool JsonDocument::isEmpty() const
 {
    if (!m_data) {
@@ -205,7 +238,11 @@ ByteArray JsonDocument::toBinaryData() const
    if (!m_data || !m_data->m_rawData) {
       return ByteArray();
    }
-   return ByteArray(m_data->m_rawData, m_data->m_header->getRoot()->m_size + sizeof(jsonprivate::Header));
+   const int size = m_data->m_header->getRoot()->m_size + sizeof(jsonprivate::Header);
+   if (!m_data->m_ownsData && m_data->m_sharedData.size() == size) {
+      return m_data->m_sharedData;
+   }
+   return ByteArray(m_data->m_rawData, size);
 }
 
 bool JsonDocument::isArray() const
@@ -352,9 +389,11 @@ Debug operator<<(Debug dbg, const JsonDocument &other)
    }
    ByteArray json;
    if (other.m_data->m_header->getRoot()->isArray()) {
-      jsonprivate::Writer::arrayToJson(static_cast<jsonprivate::LocalArray *>(other.m_data->m_header->getRoot()), json, 0, true);
+      jsonprivate::Writer::arrayToJson(static_cast<jsonprivate::LocalArray *>(other.m_data->m_header->getRoot()), json, 0, true,
+                                       other.m_data->m_checkContainers);
    } else {
-      jsonprivate::Writer::objectToJson(static_cast<jsonprivate::LocalObject *>(other.m_data->m_header->getRoot()), json, 0, true);
+      jsonprivate::Writer::objectToJson(static_cast<jsonprivate::LocalObject *>(other.m_data->m_header->getRoot()), json, 0, true,
+                                        other.m_data->m_checkContainers);
    }
    dbg.nospace() << "JsonDocument("
                  << json.getConstRawData() // print as utf-8 string without extra quotation marks
@@ -110,10 +110,10 @@ JsonObject JsonObject::fromAnyMap(const AnyMap &map)
       entry->m_value.m_type = pdk::as_integer<JsonValue::Type>(val.m_type);
       entry->m_value.m_latinKey = latinKey;
       entry->m_value.m_latinOrIntValue = latinOrIntValue;
-      entry->m_value.m_value = jsonprivate::LocalValue::valueToStore(val, (char *)entry - (char *)object.m_object + valueOffset);
+      entry->m_value.m_value = jsonprivate::LocalValue::valueToStore(object.m_object, val, (char *)entry - (char *)object.m_object + valueOffset);
       jsonprivate::copy_string((char *)(entry + 1), key, latinKey);
       if (valueSize) {
-         jsonprivate::LocalValue::copyData(val, (char *)entry + valueOffset, latinOrIntValue);
+         jsonprivate::LocalValue::copyData(val, (char *)entry + valueOffset, latinOrIntValue, object.m_data);
       }
       offsets.push_back(currentOffset);
       currentOffset += requiredSize;
@@ -254,10 +254,10 @@ JsonObject::iterator JsonObject::insert(const String &key, const JsonValue &valu
    entry->m_value.m_type = pdk::as_integer<JsonValue::Type>(val.m_type);
    entry->m_value.m_latinKey = latinKey;
    entry->m_value.m_latinOrIntValue = latinOrIntValue;
-   entry->m_value.m_value = jsonprivate::LocalValue::valueToStore(val, (char *)entry - (char *)m_object + valueOffset);
+   entry->m_value.m_value = jsonprivate::LocalValue::valueToStore(m_object, val, (char *)entry - (char *)m_object + valueOffset);
    jsonprivate::copy_string((char *)(entry + 1), key, latinKey);
    if (valueSize) {
-      jsonprivate::LocalValue::copyData(val, (char *)entry + valueOffset, latinOrIntValue);
+      jsonprivate::LocalValue::copyData(val, (char *)entry + valueOffset, latinOrIntValue, m_data);
    }
    if (m_data->m_compactionCounter > 32u && m_data->m_compactionCounter >= unsigned(m_object->m_length) / 2u) {
       compact();
@@ -422,7 +422,7 @@ bool JsonObject::detach(uint reserve)
       m_data->m_ref.ref();
       return true;
    }
-   if (reserve == 0 && m_data->m_ref.load() == 1) {
+   if (reserve == 0 && m_data->m_ref.load() == 1 && m_data->m_ownsData) {
       return true;
    }
    jsonprivate::Data *x = m_data->clone(m_object, reserve);
@@ -480,7 +480,7 @@ Debug operator<<(Debug dbg, const JsonObject &object)
       return dbg;
    }
    ByteArray json;
-   jsonprivate::Writer::objectToJson(object.m_object, json, 0, true);
+   jsonprivate::Writer::objectToJson(object.m_object, json, 0, true, object.m_data->m_checkContainers);
    dbg.nospace() << "JsonObject("
                  << json.getConstRawData() // print as utf-8 string without extra quotation marks
                  << ")";
@@ -117,14 +117,20 @@ String JsonParseError::getErrorString() const
 
 namespace jsonprivate {
 
-Parser::Parser(const char *json, int length)
+Parser::Parser(const char *json, int length, JsonArena *arena)
    : m_head(json),
      m_json(json),
      m_data(nullptr),
      m_dataLength(0),
      m_current(0),
      m_nestingLevel(0),
-     m_lastError(JsonParseError::ParseError::NoError)
+     m_lastError(JsonParseError::ParseError::NoError),
+     m_arena(arena),
+     m_stacks(arena ? arena->getParserStacks() : &m_ownStacks),
+     m_index(m_stacks->m_blocks, m_stacks->m_structurals),
+     m_nextStructural(nullptr),
+     m_useIndex(false),
+     m_wideOffsets(false)
 {
    m_end = json + length;
 }
@@ -181,6 +187,10 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
+   if (m_useIndex) {
+      m_json = m_index.skipSpace(m_json);
+      return m_json < m_end;
+   }
    while (m_json < m_end) {
       if (*m_json > Space) {
          break;
@@ -200,6 +210,18 @@ char Parser::nextToken()
    if (!eatSpace()) {
       return 0;
    }
+   if (m_useIndex) {
+      // a structural position is one of the tokens below, when the list
+      // and the parser disagree about malformed input the switch decides
+      const uint pos = m_json - m_head;
+      while (*m_nextStructural < pos) {
+         ++m_nextStructural;
+      }
+      if (*m_nextStructural == pos) {
+         ++m_nextStructural;
+         return *m_json++;
+      }
+   }
    char token = *m_json++;
    switch (token) {
    case BeginArray:
@@ -228,12 +250,21 @@ JsonDocument Parser::parse(JsonParseError *error)
 #endif
    // allocate some space
    m_dataLength = std::max(m_end - m_json, (ptrdiff_t) 256);
-   m_data = (char *)malloc(m_dataLength);
+   m_data = m_arena ? m_arena->allocate(m_dataLength) : (char *)malloc(m_dataLength);
    // fill in Header data
    jsonprivate::Header *h = (jsonprivate::Header *)m_data;
+   m_wideOffsets = m_end - m_head >= WIDE_OFFSETS_LENGTH;
    h->m_tag = JsonDocument::BinaryFormatTag;
-   h->m_version = 1u;   
+   h->m_version = m_wideOffsets ? 2u : 1u;
    m_current = sizeof(jsonprivate::Header);
+   // left over by an earlier parse of the arena that failed half way
+   m_stacks->m_offsets.clear();
+   m_stacks->m_values.clear();
+   m_useIndex = m_end - m_head >= StructuralIndex::MIN_LENGTH;
+   if (m_useIndex) {
+      m_index.build(m_head, m_end - m_head);
+      m_nextStructural = m_index.getStructurals();
+   }
    eatBOM();
    char token = nextToken();
    DEBUG << pdk::io::hex << (uint)token;
@@ -262,6 +293,8 @@ JsonDocument Parser::parse(JsonParseError *error)
          error->m_error = JsonParseError::ParseError::NoError;
       }
       jsonprivate::Data *d = new jsonprivate::Data(m_data, m_current);
+      // the arena is not ours to free, the first change detaches
+      d->m_ownsData = !m_arena;
       return JsonDocument(d);
    }
    
@@ -273,7 +306,9 @@ error:
       error->m_offset = m_json - m_head;
       error->m_error  = m_lastError;
    }
-   free(m_data);
+   if (!m_arena) {
+      free(m_data);
+   }
    return JsonDocument();
 }
 
@@ -281,7 +316,7 @@ void Parser::ParsedObject::insert(uint offset) {
    const jsonprivate::LocalEntry *newEntry = 
          reinterpret_cast<const jsonprivate::LocalEntry *>(m_parser->m_data + m_objectPosition + offset);
    size_t min = 0;
-   int n = m_offsets.size();
+   int n = getSize();
    while (n > 0) {
       int half = n >> 1;
       int middle = min + half;
@@ -292,11 +327,10 @@ void Parser::ParsedObject::insert(uint offset) {
          n -= half + 1;
       }
    }
-   if (min < m_offsets.size() && *entryAt(min) == *newEntry) {
-      m_offsets[min] = offset;
+   if (min < static_cast<size_t>(getSize()) && *entryAt(min) == *newEntry) {
+      m_offsets[m_begin + min] = offset;
    } else {
-      m_offsets.push_back(offset);
-      // m_offsets[min] = offset;
+      m_offsets.insert(m_offsets.begin() + m_begin + min, offset);
    }
 }
 
@@ -340,21 +374,21 @@ bool Parser::parseObject()
       return false;
    }
    
-   DEBUG << "numEntries" << parsedObject.m_offsets.size();
+   DEBUG << "numEntries" << parsedObject.getSize();
    int table = objectOffset;
    // finalize the object
-   if (parsedObject.m_offsets.size()) {
-      int tableSize = parsedObject.m_offsets.size() * sizeof(uint);
+   if (parsedObject.getSize()) {
+      int tableSize = parsedObject.getSize() * sizeof(uint);
       table = reserveSpace(tableSize);
       if (table < 0) {
          return false;
       }
 #if PDK_BYTE_ORDER == PDK_LITTLE_ENDIAN
-      memcpy(m_data + table, parsedObject.m_offsets.data(), tableSize);
+      memcpy(m_data + table, parsedObject.getData(), tableSize);
 #else
       offset *o = (offset *)(m_data + table);
-      for (int i = 0; i < parsedObject.m_offsets.size(); ++i) {
-         o[i] = parsedObject.m_offsets[i];
+      for (int i = 0; i < parsedObject.getSize(); ++i) {
+         o[i] = parsedObject.getData()[i];
       } 
 #endif
    }
@@ -363,7 +397,8 @@ bool Parser::parseObject()
    o->m_tableOffset = table - objectOffset;
    o->m_size = m_current - objectOffset;
    o->m_isObject = true;
-   o->m_length = parsedObject.m_offsets.size();
+   o->m_length = parsedObject.getSize();
+   o->m_wideOffsets = m_wideOffsets;
    DEBUG << "current=" << m_current;
    END;
    --m_nestingLevel;
@@ -405,59 +440,6 @@ bool Parser::parseMember(int baseOffset)
    return true;
 }
 
-namespace {
-struct ValueArray {
-   static const int sm_prealloc = 128;
-   ValueArray()
-      : m_data(m_stackValues),
-        m_alloc(sm_prealloc),
-        m_size(0)
-   {}
-   
-   ~ValueArray()
-   {
-      if (m_data != m_stackValues) {
-         free(m_data);
-      }
-   }
-   
-   inline bool grow()
-   {
-      m_alloc *= 2;
-      if (m_data == m_stackValues) {
-         jsonprivate::LocalValue *newValues = static_cast<jsonprivate::LocalValue *>(malloc(m_alloc * sizeof(jsonprivate::LocalValue)));
-         if (!newValues) {
-            return false;
-         }
-         memcpy(newValues, m_data, m_size * sizeof(jsonprivate::LocalValue));
-         m_data = newValues;
-      } else {
-         void *newValues = realloc(m_data, m_alloc * sizeof(jsonprivate::LocalValue));
-         if (!newValues) {
-            return false;
-         }
-         m_data = static_cast<jsonprivate::LocalValue *>(newValues);
-      }
-      return true;
-   }
-   
-   bool append(const jsonprivate::LocalValue &v)
-   {
-      if (m_alloc == m_size && !grow()) {
-         return false;
-      }
-      m_data[m_size] = v;
-      ++m_size;
-      return true;
-   }
-   
-   jsonprivate::LocalValue m_stackValues[sm_prealloc];
-   jsonprivate::LocalValue *m_data;
-   int m_alloc;
-   int m_size;
-};
-} // anonymous namespace
-
 /*
     array = begin-array [ value *( value-separator value ) ] end-array
 */
@@ -472,7 +454,8 @@ bool Parser::parseArray()
    if (arrayOffset < 0) {
       return false;
    }
-   ValueArray values;
+   std::vector<jsonprivate::LocalValue> &values = m_stacks->m_values;
+   const size_t valuesBegin = values.size();
    if (!eatSpace()) {
       m_lastError = JsonParseError::ParseError::UnterminatedArray;
       return false;
@@ -488,10 +471,7 @@ bool Parser::parseArray()
          jsonprivate::LocalValue val;
          if (!parseValue(&val, arrayOffset))
             return false;
-         if (!values.append(val)) {
-            m_lastError = JsonParseError::ParseError::DocumentTooLarge;
-            return false;
-         }
+         values.push_back(val);
          char token = nextToken();
          if (token == EndArray)
             break;
@@ -506,22 +486,25 @@ bool Parser::parseArray()
       }
    }
    
-   DEBUG << "size =" << values.m_size;
+   const int valueCount = values.size() - valuesBegin;
+   DEBUG << "size =" << valueCount;
    int table = arrayOffset;
    // finalize the object
-   if (values.m_size) {
-      int tableSize = values.m_size * sizeof(jsonprivate::LocalValue);
+   if (valueCount) {
+      int tableSize = valueCount * sizeof(jsonprivate::LocalValue);
       table = reserveSpace(tableSize);
       if (table < 0) {
          return false;
       }
-      memcpy(m_data + table, values.m_data, tableSize);
+      memcpy(m_data + table, values.data() + valuesBegin, tableSize);
+      values.resize(valuesBegin);
    }
    jsonprivate::LocalArray *a = (jsonprivate::LocalArray *)(m_data + arrayOffset);
    a->m_tableOffset = table - arrayOffset;
    a->m_size = m_current - arrayOffset;
    a->m_isObject = false;
-   a->m_length = values.m_size;
+   a->m_length = valueCount;
+   a->m_wideOffsets = m_wideOffsets;
    DEBUG << "current=" << m_current;
    END;
    --m_nestingLevel;
@@ -587,11 +570,9 @@ bool Parser::parseValue(jsonprivate::LocalValue *val, int baseOffset)
       return false;
    case Quote: {
       val->m_type = pdk::as_integer<JsonValue::Type>(JsonValue::Type::String);
-      if (m_current - baseOffset >= LocalValue::MaxSize) {
-         m_lastError = JsonParseError::ParseError::DocumentTooLarge;
+      if (!storeValueOffset(val, m_current - baseOffset)) {
          return false;
       }
-      val->m_value = m_current - baseOffset;
       bool latin1;
       if (!parseString(&latin1)) {
          return false;
@@ -603,11 +584,9 @@ bool Parser::parseValue(jsonprivate::LocalValue *val, int baseOffset)
    }
    case BeginArray:
       val->m_type = pdk::as_integer<JsonValue::Type>(JsonValue::Type::Array);
-      if (m_current - baseOffset >= LocalValue::MaxSize) {
-         m_lastError = JsonParseError::ParseError::DocumentTooLarge;
+      if (!storeValueOffset(val, m_current - baseOffset)) {
          return false;
       }
-      val->m_value = m_current - baseOffset;
       if (!parseArray()) {
          return false;
       }
@@ -616,11 +595,9 @@ bool Parser::parseValue(jsonprivate::LocalValue *val, int baseOffset)
       return true;
    case BeginObject:
       val->m_type = pdk::as_integer<JsonValue::Type>(JsonValue::Type::Object);
-      if (m_current - baseOffset >= LocalValue::MaxSize) {
-         m_lastError = JsonParseError::ParseError::DocumentTooLarge;
+      if (!storeValueOffset(val, m_current - baseOffset)) {
          return false;
       }
-      val->m_value = m_current - baseOffset;
       if (!parseObject()) {
          return false;
       }
@@ -730,11 +707,9 @@ bool Parser::parseNumber(jsonprivate::LocalValue *val, int baseOffset)
       return false;
    }
    pdk::to_little_endian(m_ui, m_data + pos);
-   if (m_current - baseOffset >= LocalValue::MaxSize) {
-      m_lastError = JsonParseError::ParseError::DocumentTooLarge;
+   if (!storeValueOffset(val, pos - baseOffset)) {
       return false;
    }
-   val->m_value = pos - baseOffset;
    val->m_latinOrIntValue = false;
    END;
    return true;
@@ -852,7 +827,34 @@ bool Parser::parseString(bool *latin1)
       return false;
    }
    BEGIN << "parse string stringPos=" << stringPos << m_json;
+   int expectedLength = 0;
+   if (m_useIndex) {
+      // the in-string mask knows where a well formed string ends, grow the
+      // output once for all of it instead of run by run
+      expectedLength = m_index.findStringEnd(m_json) - m_json;
+      if (reserveSpace(expectedLength) < 0) {
+         return false;
+      }
+      m_current -= expectedLength;
+   }
    while (m_json < m_end) {
+      if (m_useIndex) {
+         // plain ASCII up to the next quote, escape or UTF-8 sequence goes
+         // in one piece, as long as the string can stay latin1
+         int run = std::min(m_index.findStringStop(m_json) - m_json,
+                            static_cast<ptrdiff_t>(0x7fff) - (m_json - start));
+         if (run > 0) {
+            int pos = reserveSpace(run);
+            if (pos < 0) {
+               return false;
+            }
+            memcpy(m_data + pos, m_json, run);
+            m_json += run;
+            if (m_json >= m_end) {
+               break;
+            }
+         }
+      }
       uint ch = 0;
       if (*m_json == '"') {
          break;
@@ -903,7 +905,29 @@ bool Parser::parseString(bool *latin1)
    DEBUG << "not latin";
    m_json = start;
    m_current = outStart + sizeof(int);
+   if (m_useIndex) {
+      if (reserveSpace(2 * expectedLength) < 0) {
+         return false;
+      }
+      m_current -= 2 * expectedLength;
+   }
    while (m_json < m_end) {
+      if (m_useIndex) {
+         int run = m_index.findStringStop(m_json) - m_json;
+         if (run > 0) {
+            int pos = reserveSpace(2 * run);
+            if (pos < 0) {
+               return false;
+            }
+            for (int i = 0; i < run; ++i) {
+               *(jsonprivate::ple_ushort *)(m_data + pos + 2 * i) = (ushort)m_json[i];
+            }
+            m_json += run;
+            if (m_json >= m_end) {
+               break;
+            }
+         }
+      }
       uint ch = 0;
       if (*m_json == '"') {
          break;
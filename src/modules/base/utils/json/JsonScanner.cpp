@@ -0,0 +1,253 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/base/utils/json/internal/JsonScannerPrivate.h"
+#include "pdk/pal/kernel/Simd.h"
+#include <algorithm>
+
+#if defined(PDK_PROCESSOR_X86) && PDK_COMPILER_SUPPORTS(AVX2)
+#  define PDK_HAVE_AVX2_JSON_SCANNER
+#endif
+
+namespace pdk {
+namespace utils {
+namespace json {
+namespace jsonprivate {
+
+using namespace pdk::pal::kernel;
+
+namespace {
+
+// a block as the classifiers see it, before quotes and escapes are paired
+struct RawBlock
+{
+   pdk::puint64 m_tokens;
+   pdk::puint64 m_stringStops;
+   pdk::puint64 m_quotes;
+   pdk::puint64 m_backslashes;
+   // brackets, braces, colons and commas
+   pdk::puint64 m_operators;
+};
+
+using ClassifyBlock = void (*)(const char *json, RawBlock *raw);
+
+void classify_scalar(const char *json, int length, RawBlock *raw)
+{
+   pdk::puint64 tokens = 0;
+   pdk::puint64 stops = 0;
+   pdk::puint64 quotes = 0;
+   pdk::puint64 backslashes = 0;
+   pdk::puint64 operators = 0;
+   for (int i = 0; i < length; ++i) {
+      const uchar ch = static_cast<uchar>(json[i]);
+      const pdk::puint64 bit = pdk::puint64(1) << i;
+      if (ch != ' ' && ch != '\t' && ch != '\n' && ch != '\r') {
+         tokens |= bit;
+      }
+      if (ch == '"' || ch == '\\' || ch >= 0x80) {
+         stops |= bit;
+      }
+      if (ch == '"') {
+         quotes |= bit;
+      } else if (ch == '\\') {
+         backslashes |= bit;
+      } else if (ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ':' || ch == ',') {
+         operators |= bit;
+      }
+   }
+   raw->m_tokens = tokens;
+   raw->m_stringStops = stops;
+   raw->m_quotes = quotes;
+   raw->m_backslashes = backslashes;
+   raw->m_operators = operators;
+}
+
+void classify_block_scalar(const char *json, RawBlock *raw)
+{
+   classify_scalar(json, 64, raw);
+}
+
+#if defined(__SSE2__) && defined(PDK_COMPILER_SUPPORTS_SSE2)
+// 16 bytes per step
+void classify_sse2(const char *json, RawBlock *raw)
+{
+   const __m128i space = _mm_set1_epi8(' ');
+   const __m128i tab = _mm_set1_epi8('\t');
+   const __m128i lineFeed = _mm_set1_epi8('\n');
+   const __m128i carriageReturn = _mm_set1_epi8('\r');
+   const __m128i quote = _mm_set1_epi8('"');
+   const __m128i backslash = _mm_set1_epi8('\\');
+   const __m128i lowerCase = _mm_set1_epi8(0x20);
+   const __m128i openBrace = _mm_set1_epi8('{');
+   const __m128i closeBrace = _mm_set1_epi8('}');
+   const __m128i colon = _mm_set1_epi8(':');
+   const __m128i comma = _mm_set1_epi8(',');
+   pdk::puint64 whitespace = 0;
+   pdk::puint64 stops = 0;
+   pdk::puint64 quotes = 0;
+   pdk::puint64 backslashes = 0;
+   pdk::puint64 operators = 0;
+   for (int j = 0; j < 4; ++j) {
+      const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json + j * 16));
+      const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, space), _mm_cmpeq_epi8(data, tab)),
+                                      _mm_or_si128(_mm_cmpeq_epi8(data, lineFeed), _mm_cmpeq_epi8(data, carriageReturn)));
+      const __m128i quoteBytes = _mm_cmpeq_epi8(data, quote);
+      const __m128i backslashBytes = _mm_cmpeq_epi8(data, backslash);
+      // brackets only differ from braces in the 0x20 bit
+      const __m128i folded = _mm_or_si128(data, lowerCase);
+      const __m128i ops = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)),
+                                       _mm_or_si128(_mm_cmpeq_epi8(data, colon), _mm_cmpeq_epi8(data, comma)));
+      whitespace |= pdk::puint64(static_cast<uint>(_mm_movemask_epi8(ws))) << (j * 16);
+      // the sign bit is set for every byte of a multi byte sequence
+      stops |= pdk::puint64(static_cast<uint>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(quoteBytes, backslashBytes), data)))) << (j * 16);
+      quotes |= pdk::puint64(static_cast<uint>(_mm_movemask_epi8(quoteBytes))) << (j * 16);
+      backslashes |= pdk::puint64(static_cast<uint>(_mm_movemask_epi8(backslashBytes))) << (j * 16);
+      operators |= pdk::puint64(static_cast<uint>(_mm_movemask_epi8(ops))) << (j * 16);
+   }
+   raw->m_tokens = ~whitespace;
+   raw->m_stringStops = stops;
+   raw->m_quotes = quotes;
+   raw->m_backslashes = backslashes;
+   raw->m_operators = operators;
+}
+#endif
+
+#ifdef PDK_HAVE_AVX2_JSON_SCANNER
+PDK_FUNCTION_TARGET(AVX2)
+void classify_avx2(const char *json, RawBlock *raw)
+{
+   const __m256i space = _mm256_set1_epi8(' ');
+   const __m256i tab = _mm256_set1_epi8('\t');
+   const __m256i lineFeed = _mm256_set1_epi8('\n');
+   const __m256i carriageReturn = _mm256_set1_epi8('\r');
+   const __m256i quote = _mm256_set1_epi8('"');
+   const __m256i backslash = _mm256_set1_epi8('\\');
+   const __m256i lowerCase = _mm256_set1_epi8(0x20);
+   const __m256i openBrace = _mm256_set1_epi8('{');
+   const __m256i closeBrace = _mm256_set1_epi8('}');
+   const __m256i colon = _mm256_set1_epi8(':');
+   const __m256i comma = _mm256_set1_epi8(',');
+   pdk::puint64 whitespace = 0;
+   pdk::puint64 stops = 0;
+   pdk::puint64 quotes = 0;
+   pdk::puint64 backslashes = 0;
+   pdk::puint64 operators = 0;
+   for (int j = 0; j < 2; ++j) {
+      const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json + j * 32));
+      const __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, space), _mm256_cmpeq_epi8(data, tab)),
+                                         _mm256_or_si256(_mm256_cmpeq_epi8(data, lineFeed), _mm256_cmpeq_epi8(data, carriageReturn)));
+      const __m256i quoteBytes = _mm256_cmpeq_epi8(data, quote);
+      const __m256i backslashBytes = _mm256_cmpeq_epi8(data, backslash);
+      const __m256i folded = _mm256_or_si256(data, lowerCase);
+      const __m256i ops = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, openBrace), _mm256_cmpeq_epi8(folded, closeBrace)),
+                                          _mm256_or_si256(_mm256_cmpeq_epi8(data, colon), _mm256_cmpeq_epi8(data, comma)));
+      whitespace |= pdk::puint64(static_cast<uint>(_mm256_movemask_epi8(ws))) << (j * 32);
+      stops |= pdk::puint64(static_cast<uint>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(quoteBytes, backslashBytes), data)))) << (j * 32);
+      quotes |= pdk::puint64(static_cast<uint>(_mm256_movemask_epi8(quoteBytes))) << (j * 32);
+      backslashes |= pdk::puint64(static_cast<uint>(_mm256_movemask_epi8(backslashBytes))) << (j * 32);
+      operators |= pdk::puint64(static_cast<uint>(_mm256_movemask_epi8(ops))) << (j * 32);
+   }
+   raw->m_tokens = ~whitespace;
+   raw->m_stringStops = stops;
+   raw->m_quotes = quotes;
+   raw->m_backslashes = backslashes;
+   raw->m_operators = operators;
+}
+#endif
+
+// the bytes escaped by a backslash, that is the byte after every run of
+// odd length. oddCarry is 1 when the previous block ended inside such a run
+pdk::puint64 find_escaped(pdk::puint64 backslashes, pdk::puint64 &oddCarry)
+{
+   const pdk::puint64 evenBits = 0x5555555555555555ULL;
+   const pdk::puint64 oddBits = ~evenBits;
+   const pdk::puint64 startEdges = backslashes & ~(backslashes << 1);
+   // a run carried over starts one byte early, which flips its parity
+   const pdk::puint64 evenStartMask = evenBits ^ oddCarry;
+   const pdk::puint64 evenStarts = startEdges & evenStartMask;
+   const pdk::puint64 oddStarts = startEdges & ~evenStartMask;
+   // adding the start of a run carries through it to the byte after
+   const pdk::puint64 evenCarries = backslashes + evenStarts;
+   pdk::puint64 oddCarries = backslashes + oddStarts;
+   const bool endsOdd = oddCarries < backslashes;
+   oddCarries |= oddCarry;
+   oddCarry = endsOdd ? 1 : 0;
+   const pdk::puint64 evenCarryEnds = evenCarries & ~backslashes;
+   const pdk::puint64 oddCarryEnds = oddCarries & ~backslashes;
+   return (evenCarryEnds & oddBits) | (oddCarryEnds & evenBits);
+}
+
+// every bit becomes the parity of the bits up to and including it
+inline pdk::puint64 prefix_xor(pdk::puint64 bits)
+{
+   bits ^= bits << 1;
+   bits ^= bits << 2;
+   bits ^= bits << 4;
+   bits ^= bits << 8;
+   bits ^= bits << 16;
+   bits ^= bits << 32;
+   return bits;
+}
+
+} // anonymous namespace
+
+void StructuralIndex::build(const char *json, int length)
+{
+   m_begin = json;
+   m_end = json + length;
+   // one more block than whole ones, so the end always has its bit
+   const int blockCount = length / 64 + 1;
+   m_blocks.resize(blockCount);
+   m_structurals.clear();
+   ClassifyBlock classify = classify_block_scalar;
+#if defined(__SSE2__) && defined(PDK_COMPILER_SUPPORTS_SSE2)
+   classify = classify_sse2;
+#endif
+#ifdef PDK_HAVE_AVX2_JSON_SCANNER
+   if (CPU_HAS_FEATURE(AVX2)) {
+      classify = classify_avx2;
+   }
+#endif
+   pdk::puint64 oddCarry = 0;
+   pdk::puint64 inStringCarry = 0;
+   for (int i = 0; i < blockCount; ++i) {
+      const int blockLength = std::min(64, length - i * 64);
+      RawBlock raw;
+      if (blockLength == 64) {
+         classify(json + i * 64, &raw);
+      } else {
+         classify_scalar(json + i * 64, blockLength, &raw);
+      }
+      const pdk::puint64 quotes = raw.m_quotes & ~find_escaped(raw.m_backslashes, oddCarry);
+      const pdk::puint64 inString = prefix_xor(quotes) ^ inStringCarry;
+      inStringCarry = pdk::puint64(0) - (inString >> 63);
+      const pdk::puint64 tail = blockLength < 64 ? ~pdk::puint64(0) << blockLength : 0;
+      Block &block = m_blocks[i];
+      block.m_tokens = raw.m_tokens | tail;
+      block.m_stringStops = raw.m_stringStops | tail;
+      block.m_inString = inString & ~tail;
+      pdk::puint64 structurals = (raw.m_operators & ~inString) | (quotes & inString);
+      while (structurals) {
+         m_structurals.push_back(i * 64 + pdk::count_trailing_zero_bits(structurals));
+         structurals &= structurals - 1;
+      }
+   }
+   m_structurals.push_back(length);
+}
+
+} // jsonprivate
+} // json
+} // utils
+} // pdk
@@ -60,6 +60,12 @@ JsonValue::JsonValue(jsonprivate::Data *data, jsonprivate::Base *base, const jso
    }
    case Type::Array:
    case Type::Object:
+      if (data->m_checkContainers && !data->isValidContainer(value.base(base))) {
+         // corrupted container of a lazily validated document
+         m_type = Type::Undefined;
+         m_dbl = 0;
+         break;
+      }
       m_data = data;
       this->m_base = value.base(base);
       break;
@@ -106,7 +112,9 @@ JsonValue::JsonValue(const String &value)
 
 void JsonValue::stringDataFromStringHelper(const String &string)
 {
-   m_stringData = *(StringData **)(const_cast<String *>(&string));
+   // short strings are stored inline, give the value a header of its own
+   String copy(string);
+   m_stringData = copy.getDataPtr();
    m_stringData->m_ref.ref();
 }
 
@@ -30,8 +30,8 @@ using pdk::utils::Locale;
 
 namespace {
 
-void object_content_to_json(const LocalObject *o, ByteArray &json, int indent, bool compact);
-void array_content_to_json(const LocalArray *a, ByteArray &json, int indent, bool compact);
+void object_content_to_json(const LocalObject *o, ByteArray &json, int indent, bool compact, bool checkContainers);
+void array_content_to_json(const LocalArray *a, ByteArray &json, int indent, bool compact, bool checkContainers);
 
 static inline uchar hexdig(uint u)
 {
@@ -100,7 +100,8 @@ ByteArray escaped_string(const String &s)
    return ba;
 }
 
-void value_to_json(const jsonprivate::Base *base, const jsonprivate::LocalValue &value, ByteArray &json, int indent, bool compact)
+void value_to_json(const jsonprivate::Base *base, const jsonprivate::LocalValue &value, ByteArray &json, int indent, bool compact,
+                   bool checkContainers)
 {
    JsonValue::Type type = (JsonValue::Type)(uint)value.m_type;
    switch (type) {
@@ -123,14 +124,22 @@ void value_to_json(const jsonprivate::Base *base, const jsonprivate::LocalValue
       json += '"';
       break;
    case JsonValue::Type::Array:
+      if (checkContainers && !value.base(base)->isShallowValid()) {
+         json += "null";
+         break;
+      }
       json += compact ? "[" : "[\n";
-      array_content_to_json(static_cast<jsonprivate::LocalArray *>(value.base(base)), json, indent + (compact ? 0 : 1), compact);
+      array_content_to_json(static_cast<jsonprivate::LocalArray *>(value.base(base)), json, indent + (compact ? 0 : 1), compact, checkContainers);
       json += ByteArray(4 * indent, ' ');
       json += ']';
       break;
    case JsonValue::Type::Object:
+      if (checkContainers && !value.base(base)->isShallowValid()) {
+         json += "null";
+         break;
+      }
       json += compact ? "{" : "{\n";
-      object_content_to_json(static_cast<jsonprivate::LocalObject *>(value.base(base)), json, indent + (compact ? 0 : 1), compact);
+      object_content_to_json(static_cast<jsonprivate::LocalObject *>(value.base(base)), json, indent + (compact ? 0 : 1), compact, checkContainers);
       json += ByteArray(4 * indent, ' ');
       json += '}';
       break;
@@ -140,7 +149,8 @@ void value_to_json(const jsonprivate::Base *base, const jsonprivate::LocalValue
    }
 }
 
-void array_content_to_json(const jsonprivate::LocalArray *array, ByteArray &json, int indent, bool compact)
+void array_content_to_json(const jsonprivate::LocalArray *array, ByteArray &json, int indent, bool compact,
+                           bool checkContainers)
 {
    if (!array || !array->m_length) {
       return;
@@ -149,7 +159,7 @@ void array_content_to_json(const jsonprivate::LocalArray *array, ByteArray &json
    uint i = 0;
    while (1) {
       json += indentString;
-      value_to_json(array, array->at(i), json, indent, compact);
+      value_to_json(array, array->at(i), json, indent, compact, checkContainers);
       if (++i == array->m_length) {
          if (!compact) {
             json += '\n';
@@ -160,7 +170,8 @@ void array_content_to_json(const jsonprivate::LocalArray *array, ByteArray &json
    }
 }
 
-void object_content_to_json(const jsonprivate::LocalObject *object, ByteArray &json, int indent, bool compact)
+void object_content_to_json(const jsonprivate::LocalObject *object, ByteArray &json, int indent, bool compact,
+                            bool checkContainers)
 {
    if (!object || !object->m_length) {
       return;
@@ -173,7 +184,7 @@ void object_content_to_json(const jsonprivate::LocalObject *object, ByteArray &j
       json += '"';
       json += escaped_string(e->getKey());
       json += compact ? "\":" : "\": ";
-      value_to_json(object, e->m_value, json, indent, compact);
+      value_to_json(object, e->m_value, json, indent, compact, checkContainers);
       if (++i == object->m_length) {
          if (!compact) {
             json += '\n';
@@ -186,20 +197,22 @@ void object_content_to_json(const jsonprivate::LocalObject *object, ByteArray &j
 
 } // anonymous namespace
 
-void Writer::objectToJson(const jsonprivate::LocalObject *object, ByteArray &json, int indent, bool compact)
+void Writer::objectToJson(const jsonprivate::LocalObject *object, ByteArray &json, int indent, bool compact,
+                          bool checkContainers)
 {
     json.reserve(json.size() + (object ? (int)object->m_size : 16));
     json += compact ? "{" : "{\n";
-    object_content_to_json(object, json, indent + (compact ? 0 : 1), compact);
+    object_content_to_json(object, json, indent + (compact ? 0 : 1), compact, checkContainers);
     json += ByteArray(4*indent, ' ');
     json += compact ? "}" : "}\n";
 }
 
-void Writer::arrayToJson(const jsonprivate::LocalArray *array, ByteArray &json, int indent, bool compact)
+void Writer::arrayToJson(const jsonprivate::LocalArray *array, ByteArray &json, int indent, bool compact,
+                         bool checkContainers)
 {
     json.reserve(json.size() + (array ? (int)array->m_size : 16));
     json += compact ? "[" : "[\n";
-    array_content_to_json(array, json, indent + (compact ? 0 : 1), compact);
+    array_content_to_json(array, json, indent + (compact ? 0 : 1), compact, checkContainers);
     json += ByteArray(4*indent, ' ');
     json += compact ? "]" : "]\n";
 }
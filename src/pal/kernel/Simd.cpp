@@ -14,13 +14,255 @@
 // Created by softboy on 2018/02/24.
 
 #include "pdk/pal/kernel/Simd.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(PDK_PROCESSOR_X86) && !defined(PDK_CC_MSVC)
+#  include <cpuid.h>
+#elif defined(PDK_PROCESSOR_ARM) && defined(PDK_OS_LINUX)
+#  include <sys/auxv.h>
+#endif
 
 namespace pdk {
 namespace pal {
 namespace kernel {
 
+#ifdef PDK_ATOMIC_INT64_IS_SUPPORTED
+pdk::os::thread::BasicAtomicInteger<puint64> pdk_cpu_features[1] = {
+   PDK_BASIC_ATOMIC_INITIALIZER(0)
+};
+#else
+pdk::os::thread::BasicAtomicInteger<unsigned int> pdk_cpu_features[2] = {
+   PDK_BASIC_ATOMIC_INITIALIZER(0),
+   PDK_BASIC_ATOMIC_INITIALIZER(0)
+};
+#endif
+
+namespace {
+
+struct CpuFeatureName
+{
+   const char *m_name;
+   long m_bit;
+};
+
+constexpr puint64 feature_bit(long feature)
+{
+   return PDK_UINT64_C(1) << feature;
+}
+
+#if defined(PDK_PROCESSOR_X86)
+
+const CpuFeatureName sg_featureNames[] = {
+   {"sse2", CPUFeaturesSSE2},
+   {"sse3", CPUFeaturesSSE3},
+   {"ssse3", CPUFeaturesSSSE3},
+   {"sse4.1", CPUFeaturesSSE4_1},
+   {"sse4.2", CPUFeaturesSSE4_2},
+   {"movbe", CPUFeaturesMOVBE},
+   {"popcnt", CPUFeaturesPOPCNT},
+   {"aes", CPUFeaturesAES},
+   {"avx", CPUFeaturesAVX},
+   {"f16c", CPUFeaturesF16C},
+   {"rdrand", CPUFeaturesRDRAND},
+   {"bmi", CPUFeaturesBMI},
+   {"hle", CPUFeaturesHLE},
+   {"avx2", CPUFeaturesAVX2},
+   {"bmi2", CPUFeaturesBMI2},
+   {"rtm", CPUFeaturesRTM},
+   {"avx512f", CPUFeaturesAVX512F},
+   {"avx512dq", CPUFeaturesAVX512DQ},
+   {"rdseed", CPUFeaturesRDSEED},
+   {"avx512ifma", CPUFeaturesAVX512IFMA},
+   {"avx512pf", CPUFeaturesAVX512PF},
+   {"avx512er", CPUFeaturesAVX512ER},
+   {"avx512cd", CPUFeaturesAVX512CD},
+   {"sha", CPUFeaturesSHA},
+   {"avx512bw", CPUFeaturesAVX512BW},
+   {"avx512vl", CPUFeaturesAVX512VL},
+   {"avx512vbmi", CPUFeaturesAVX512VBMI}
+};
+
+void cpuid(unsigned leaf, unsigned subLeaf, unsigned regs[4])
+{
+#  if defined(PDK_CC_MSVC)
+   int info[4];
+   __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subLeaf));
+   std::memcpy(regs, info, sizeof(info));
+#  else
+   __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#  endif
+}
+
+puint64 read_xcr0()
+{
+#  if defined(PDK_CC_MSVC)
+   return _xgetbv(0);
+#  else
+   // xgetbv, spelled out for assemblers that do not know the mnemonic
+   unsigned eax;
+   unsigned edx;
+   asm (".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+   return eax | (static_cast<puint64>(edx) << 32);
+#  endif
+}
+
+puint64 detect_processor_features()
+{
+   // the CPUID leaf 1 ECX bits we keep, they line up with the CPUFeatures enum
+   constexpr unsigned leaf1EcxMask = (1u << CPUFeaturesSSE3) | (1u << CPUFeaturesSSSE3)
+         | (1u << CPUFeaturesSSE4_1) | (1u << CPUFeaturesSSE4_2) | (1u << CPUFeaturesMOVBE)
+         | (1u << CPUFeaturesPOPCNT) | (1u << CPUFeaturesAES) | (1u << CPUFeaturesAVX)
+         | (1u << CPUFeaturesF16C) | (1u << CPUFeaturesRDRAND);
+   // the CPUID leaf 7 EBX bits we keep, stored in the upper half
+   constexpr unsigned leaf7EbxMask = (1u << (CPUFeaturesBMI - 32)) | (1u << (CPUFeaturesHLE - 32))
+         | (1u << (CPUFeaturesAVX2 - 32)) | (1u << (CPUFeaturesBMI2 - 32))
+         | (1u << (CPUFeaturesRTM - 32)) | (1u << (CPUFeaturesAVX512F - 32))
+         | (1u << (CPUFeaturesAVX512DQ - 32)) | (1u << (CPUFeaturesRDSEED - 32))
+         | (1u << (CPUFeaturesAVX512IFMA - 32)) | (1u << (CPUFeaturesAVX512PF - 32))
+         | (1u << (CPUFeaturesAVX512ER - 32)) | (1u << (CPUFeaturesAVX512CD - 32))
+         | (1u << (CPUFeaturesSHA - 32)) | (1u << (CPUFeaturesAVX512BW - 32))
+         | (1u << (CPUFeaturesAVX512VL - 32));
+   constexpr puint64 avxFeatures = feature_bit(CPUFeaturesAVX) | feature_bit(CPUFeaturesF16C)
+         | feature_bit(CPUFeaturesAVX2);
+   constexpr puint64 avx512Features = feature_bit(CPUFeaturesAVX512F) | feature_bit(CPUFeaturesAVX512DQ)
+         | feature_bit(CPUFeaturesAVX512IFMA) | feature_bit(CPUFeaturesAVX512PF)
+         | feature_bit(CPUFeaturesAVX512ER) | feature_bit(CPUFeaturesAVX512CD)
+         | feature_bit(CPUFeaturesAVX512BW) | feature_bit(CPUFeaturesAVX512VL)
+         | feature_bit(CPUFeaturesAVX512VBMI);
+   // XCR0 state components the OS must save for the wide registers to be usable
+   constexpr puint64 xsaveAvxState = (1u << 1) | (1u << 2);
+   constexpr puint64 xsaveAvx512State = xsaveAvxState | (1u << 5) | (1u << 6) | (1u << 7);
+
+   unsigned regs[4];
+   cpuid(0, 0, regs);
+   const unsigned maxLevel = regs[0];
+   if (maxLevel < 1) {
+      return 0;
+   }
+   cpuid(1, 0, regs);
+   puint64 features = regs[2] & leaf1EcxMask;
+   if (regs[3] & (1u << 26)) {
+      features |= feature_bit(CPUFeaturesSSE2);
+   }
+   const bool osxsave = regs[2] & (1u << 27);
+   if (maxLevel >= 7) {
+      cpuid(7, 0, regs);
+      features |= static_cast<puint64>(regs[1] & leaf7EbxMask) << 32;
+      if (regs[2] & (1u << 1)) {
+         features |= feature_bit(CPUFeaturesAVX512VBMI);
+      }
+   }
+   const puint64 xcr0 = osxsave ? read_xcr0() : 0;
+   if ((xcr0 & xsaveAvxState) != xsaveAvxState) {
+      features &= ~(avxFeatures | avx512Features);
+   } else if ((xcr0 & xsaveAvx512State) != xsaveAvx512State) {
+      features &= ~avx512Features;
+   }
+   return features;
+}
+
+#elif defined(PDK_PROCESSOR_ARM)
+
+const CpuFeatureName sg_featureNames[] = {
+   {"neon", CPUFeaturesNEON},
+   {"crc32", CPUFeaturesCRC32}
+};
+
+puint64 detect_processor_features()
+{
+   puint64 features = 0;
+#  if defined(PDK_PROCESSOR_ARM_64)
+   // NEON is part of every AArch64 implementation
+   features |= feature_bit(CPUFeaturesNEON);
+#  endif
+#  if defined(PDK_OS_LINUX)
+   const unsigned long hwcap = getauxval(AT_HWCAP);
+#     if defined(PDK_PROCESSOR_ARM_64)
+   // HWCAP_CRC32 of asm/hwcap.h on arm64
+   if (hwcap & (1ul << 7)) {
+      features |= feature_bit(CPUFeaturesCRC32);
+   }
+#     else
+   // HWCAP_NEON and HWCAP2_CRC32 of asm/hwcap.h on arm
+   if (hwcap & (1ul << 12)) {
+      features |= feature_bit(CPUFeaturesNEON);
+   }
+   if (getauxval(AT_HWCAP2) & (1ul << 4)) {
+      features |= feature_bit(CPUFeaturesCRC32);
+   }
+#     endif
+#  endif
+   return features;
+}
+
+#else
+
+const CpuFeatureName sg_featureNames[] = {
+   {nullptr, 0}
+};
+
+// MIPS DSP and the other architectures only get what the compiler was told
+// to target, see COMPILER_CPU_FEATURE
+puint64 detect_processor_features()
+{
+   return 0;
+}
+
+#endif
+
+// PDK_NO_CPU_FEATURE holds a comma or space separated list of feature names
+// that are masked off, which is how the fallback paths get exercised on
+// machines that do have the wider instruction sets
+puint64 disabled_features()
+{
+   const char *env = std::getenv("PDK_NO_CPU_FEATURE");
+   if (!env) {
+      return 0;
+   }
+   puint64 mask = 0;
+   while (*env) {
+      const size_t length = std::strcspn(env, ", ");
+      for (const CpuFeatureName &feature : sg_featureNames) {
+         if (feature.m_name && std::strlen(feature.m_name) == length
+             && std::strncmp(feature.m_name, env, length) == 0) {
+            mask |= PDK_UINT64_C(1) << feature.m_bit;
+         }
+      }
+      env += length;
+      if (*env) {
+         ++env;
+      }
+   }
+   return mask;
+}
+
+} // anonymous namespace
+
+void detect_cpu_features()
+{
+   puint64 features = (detect_processor_features() & ~disabled_features()) | COMPILER_CPU_FEATURE;
+   features |= static_cast<puint64>(CPUFeaturesSimdInitialized);
+#ifdef PDK_ATOMIC_INT64_IS_SUPPORTED
+   pdk_cpu_features[0].store(features);
+#else
+   pdk_cpu_features[1].store(static_cast<unsigned int>(features >> 32));
+   pdk_cpu_features[0].store(static_cast<unsigned int>(features));
+#endif
+}
+
 void dump_cpu_features()
 {
+   const puint64 features = cpu_features();
+   std::printf("Processor features: ");
+   for (const CpuFeatureName &feature : sg_featureNames) {
+      if (feature.m_name && (features & (PDK_UINT64_C(1) << feature.m_bit))) {
+         std::printf("%s%s", feature.m_name,
+                     (COMPILER_CPU_FEATURE & (PDK_UINT64_C(1) << feature.m_bit)) ? "[required] " : " ");
+      }
+   }
+   std::printf("\n");
 }
 
 } // kernel
@@ -14,8 +14,10 @@
 // Created by softboy on 2018/03/05.
 
 #include "pdk/utils/CryptographicHash.h"
+#include "pdk/utils/internal/CryptographicHashKernelsPrivate.h"
 #include "pdk/base/io/IoDevice.h"
-#include "sha1/sha1.cpp"
+#include "pdk/base/io/fs/FileDevice.h"
+#include <algorithm>
 
 //#if !defined(PDK_CRYPTOGRAPHICHASH_ONLY_SHA1)
 //#  error "Are you sure you need the other hashing algorithms besides SHA-1?"
@@ -97,24 +99,17 @@ static SHA3Final * const sha3Final = Final;
 #include "rfc6234/sha.h"
 
 /*
-    These 2 functions replace macros of the same name in sha224-256.c and
-    sha384-512.c. Originally, these macros relied on a global static 'addTemp'
-    variable. We do not want this for 2 reasons:
-    
-    1. since we are including the sources directly, the declaration of the 2 conflict
-    
-    2. static variables are not thread-safe, we do not want multiple threads
-    computing a hash to corrupt one another
+    This function replaces the macro of the same name in sha384-512.c.
+    Originally, the macro relied on a global static 'addTemp' variable, which
+    is not thread-safe, we do not want multiple threads computing a hash to
+    corrupt one another. SHA-224 and SHA-256 no longer use the rfc6234 code,
+    see CryptographicHashKernels.cpp.
 */
 extern "C" {
-int SHA224_256AddLength(SHA256Context *context, unsigned int length);
 int SHA384_512AddLength(SHA512Context *context, unsigned int length);
 }
 
-// Sources from rfc6234, with 4 modifications:
-// sha224-256.c - commented out 'static uint32_t addTemp;' on line 68
-// sha224-256.c - appended 'M' to the SHA224_256AddLength macro on line 70
-#include "rfc6234/sha224-256.c"
+// Sources from rfc6234, with 2 modifications:
 // sha384-512.c - commented out 'static uint64_t addTemp;' on line 302
 // sha384-512.c - appended 'M' to the SHA224_256AddLength macro on line 304
 #include "rfc6234/sha384-512.c"
@@ -124,11 +119,6 @@ int SHA384_512AddLength(SHA512Context *context, unsigned int length);
 #undef uint68_t
 #undef int_least16_t
 
-inline int SHA224_256AddLength(SHA256Context *context, unsigned int length)
-{
-   pdk::puint32 addTemp;
-   return SHA224_256AddLengthM(context, length);
-}
 inline int SHA384_512AddLength(SHA512Context *context, unsigned int length)
 {
    pdk::puint64 addTemp;
@@ -138,10 +128,26 @@ inline int SHA384_512AddLength(SHA512Context *context, unsigned int length)
 namespace pdk {
 namespace utils {
 
-using pdk::internal::Sha1State;
 using pdk::internal::MD5Context;
 using pdk::internal::md4_context;
 using pdk::io::IoDevice;
+using pdk::io::fs::FileDevice;
+using internal::sha1_init;
+using internal::sha224_init;
+using internal::sha256_init;
+using internal::sha1_block_function;
+using internal::sha256_block_function;
+using internal::block_hash_update;
+using internal::block_hash_final;
+using internal::sha256_many;
+using internal::keccak_many;
+
+namespace {
+// files smaller than this are not worth a mapping
+constexpr pdk::pint64 sg_minMappedHashSize = 64 * 1024;
+// and larger ones are mapped this much at a time
+constexpr pdk::pint64 sg_mappedHashWindow = 32 * 1024 * 1024;
+} // anonymous namespace
 
 namespace internal {
 
@@ -150,12 +156,11 @@ class CryptographicHashPrivate
 public:
    CryptographicHash::Algorithm m_method;
    union {
-      Sha1State m_sha1Context;
+      // SHA-1, SHA-224 and SHA-256
+      BlockHashState m_blockContext;
 #ifndef PDK_CRYPTOGRAPHICHASH_ONLY_SHA1
       MD5Context m_md5Context;
       md4_context m_md4Context;
-      SHA224Context m_sha224Context;
-      SHA256Context m_sha256Context;
       SHA384Context m_sha384Context;
       SHA512Context m_sha512Context;
       SHA3Context m_sha3Context;
@@ -169,6 +174,7 @@ public:
    };
    void sha3Finish(int bitCount, Sha3Variant sha3Variant);
 #endif
+   HashBlockFunction m_blockFunction;
    ByteArray m_result;
 };
 
@@ -227,7 +233,8 @@ void CryptographicHash::reset()
 {
    switch (m_implPtr->m_method) {
    case Sha1:
-      sha1InitState(&m_implPtr->m_sha1Context);
+      sha1_init(&m_implPtr->m_blockContext);
+      m_implPtr->m_blockFunction = sha1_block_function();
       break;
 #ifdef PDK_CRYPTOGRAPHICHASH_ONLY_SHA1
    default:
@@ -242,10 +249,12 @@ void CryptographicHash::reset()
       MD5Init(&m_implPtr->m_md5Context);
       break;
    case Sha224:
-      SHA224Reset(&m_implPtr->m_sha224Context);
+      sha224_init(&m_implPtr->m_blockContext);
+      m_implPtr->m_blockFunction = sha256_block_function();
       break;
    case Sha256:
-      SHA256Reset(&m_implPtr->m_sha256Context);
+      sha256_init(&m_implPtr->m_blockContext);
+      m_implPtr->m_blockFunction = sha256_block_function();
       break;
    case Sha384:
       SHA384Reset(&m_implPtr->m_sha384Context);
@@ -278,7 +287,8 @@ void CryptographicHash::addData(const char *data, int length)
 {
    switch (m_implPtr->m_method) {
    case Sha1:
-      sha1Update(&m_implPtr->m_sha1Context, (const unsigned char *)data, length);
+      block_hash_update(&m_implPtr->m_blockContext, reinterpret_cast<const uchar *>(data), length,
+                        m_implPtr->m_blockFunction);
       break;
 #ifdef PDK_CRYPTOGRAPHICHASH_ONLY_SHA1
    default:
@@ -293,10 +303,9 @@ void CryptographicHash::addData(const char *data, int length)
       MD5Update(&m_implPtr->m_md5Context, (const unsigned char *)data, length);
       break;
    case Sha224:
-      SHA224Input(&m_implPtr->m_sha224Context, reinterpret_cast<const unsigned char *>(data), length);
-      break;
    case Sha256:
-      SHA256Input(&m_implPtr->m_sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+      block_hash_update(&m_implPtr->m_blockContext, reinterpret_cast<const uchar *>(data), length,
+                        m_implPtr->m_blockFunction);
       break;
    case Sha384:
       SHA384Input(&m_implPtr->m_sha384Context, reinterpret_cast<const unsigned char *>(data), length);
@@ -339,7 +348,30 @@ bool CryptographicHash::addData(IoDevice *device)
       return false;
    }
    
-   char buffer[1024];
+   // a file is hashed straight from its mapping, a window at a time, rather
+   // than copied through a buffer first
+   FileDevice *file = dynamic_cast<FileDevice *>(device);
+   if (file && !file->isSequential() && !file->isTextModeEnabled()
+       && file->getSize() - file->getPosition() >= sg_minMappedHashSize) {
+      const pdk::pint64 size = file->getSize();
+      pdk::pint64 pos = file->getPosition();
+      while (pos < size) {
+         const pdk::pint64 window = std::min(size - pos, sg_mappedHashWindow);
+         uchar *address = file->map(pos, window);
+         if (!address) {
+            break;
+         }
+         addData(reinterpret_cast<const char *>(address), static_cast<int>(window));
+         file->unmap(address);
+         pos += window;
+      }
+      // whatever could not be mapped is read below
+      if (!file->seek(pos)) {
+         return false;
+      }
+   }
+   
+   char buffer[16 * 1024];
    int length;
    
    while ((length = device->read(buffer,sizeof(buffer))) > 0) {
@@ -357,10 +389,9 @@ ByteArray CryptographicHash::result() const
    
    switch (m_implPtr->m_method) {
    case Sha1: {
-      Sha1State copy = m_implPtr->m_sha1Context;
       m_implPtr->m_result.resize(20);
-      sha1FinalizeState(&copy);
-      sha1ToHash(&copy, (unsigned char *)m_implPtr->m_result.getRawData());
+      block_hash_final(&m_implPtr->m_blockContext, reinterpret_cast<uchar *>(m_implPtr->m_result.getRawData()),
+                       20, m_implPtr->m_blockFunction);
       break;
    }
 #ifdef PDK_CRYPTOGRAPHICHASH_ONLY_SHA1
@@ -382,15 +413,15 @@ ByteArray CryptographicHash::result() const
       break;
    }
    case Sha224: {
-      SHA224Context copy = m_implPtr->m_sha224Context;
       m_implPtr->m_result.resize(SHA224HashSize);
-      SHA224Result(&copy, reinterpret_cast<unsigned char *>(m_implPtr->m_result.getRawData()));
+      block_hash_final(&m_implPtr->m_blockContext, reinterpret_cast<uchar *>(m_implPtr->m_result.getRawData()),
+                       SHA224HashSize, m_implPtr->m_blockFunction);
       break;
    }
    case Sha256:{
-      SHA256Context copy = m_implPtr->m_sha256Context;
       m_implPtr->m_result.resize(SHA256HashSize);
-      SHA256Result(&copy, reinterpret_cast<unsigned char *>(m_implPtr->m_result.getRawData()));
+      block_hash_final(&m_implPtr->m_blockContext, reinterpret_cast<uchar *>(m_implPtr->m_result.getRawData()),
+                       SHA256HashSize, m_implPtr->m_blockFunction);
       break;
    }
    case Sha384:{
@@ -449,6 +480,74 @@ ByteArray CryptographicHash::hash(const ByteArray &data, Algorithm method)
    return hash.result();
 }
 
+std::vector<ByteArray> CryptographicHash::hashMany(const std::vector<ByteArray> &data, Algorithm method)
+{
+   std::vector<ByteArray> results;
+   results.reserve(data.size());
+#ifndef PDK_CRYPTOGRAPHICHASH_ONLY_SHA1
+   int digestSize = 0;
+   uchar keccakSuffix = 0;
+   switch (method) {
+   case Sha224:
+      digestSize = SHA224HashSize;
+      break;
+   case Sha256:
+      digestSize = SHA256HashSize;
+      break;
+   case Keccak_224:
+   case RealSha3_224:
+      digestSize = 28;
+      break;
+   case Keccak_256:
+   case RealSha3_256:
+      digestSize = 32;
+      break;
+   case Keccak_384:
+   case RealSha3_384:
+      digestSize = 48;
+      break;
+   case Keccak_512:
+   case RealSha3_512:
+      digestSize = 64;
+      break;
+   default:
+      break;
+   }
+   if (method >= Keccak_224) {
+      keccakSuffix = method >= RealSha3_224 ? 0x06 : 0x01;
+   }
+   if (digestSize && data.size() > 1) {
+      std::vector<const uchar *> pointers;
+      std::vector<size_t> lengths;
+      pointers.reserve(data.size());
+      lengths.reserve(data.size());
+      for (const ByteArray &item : data) {
+         pointers.push_back(reinterpret_cast<const uchar *>(item.getConstRawData()));
+         lengths.push_back(static_cast<size_t>(item.size()));
+      }
+      std::vector<uchar> digests(data.size() * digestSize);
+      const bool done = keccakSuffix
+            ? keccak_many(pointers.data(), lengths.data(), data.size(), 200 - 2 * digestSize,
+                          keccakSuffix, digestSize, digests.data())
+            : sha256_many(pointers.data(), lengths.data(), data.size(), digestSize, digests.data());
+      if (done) {
+         for (size_t i = 0; i < data.size(); ++i) {
+            results.push_back(ByteArray(reinterpret_cast<const char *>(digests.data() + i * digestSize),
+                                        digestSize));
+         }
+         return results;
+      }
+   }
+#endif
+   CryptographicHash hash(method);
+   for (const ByteArray &item : data) {
+      hash.reset();
+      hash.addData(item);
+      results.push_back(hash.result());
+   }
+   return results;
+}
+
 } // utils
 } // pdk
 
@@ -0,0 +1,776 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "pdk/utils/internal/CryptographicHashKernelsPrivate.h"
+#include "pdk/global/Endian.h"
+#include "pdk/pal/kernel/Simd.h"
+#include <algorithm>
+#include <cstring>
+#include "sha1/sha1.cpp"
+
+#if defined(PDK_PROCESSOR_X86) && PDK_COMPILER_SUPPORTS(SHA)
+#  define PDK_HAVE_SHA_NI_HASH
+#endif
+
+#if defined(PDK_PROCESSOR_X86) && PDK_COMPILER_SUPPORTS(AVX2)
+#  define PDK_HAVE_AVX2_HASH
+#endif
+
+// there is no runtime detection for ARM yet, the crypto extension is used
+// when the compiler targets it
+#if defined(PDK_PROCESSOR_ARM_64) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#  define PDK_HAVE_ARM_CRYPTO_HASH
+#endif
+
+namespace pdk {
+namespace utils {
+namespace internal {
+
+using namespace pdk::pal::kernel;
+
+namespace {
+
+alignas(16) const pdk::puint32 sg_sha256K[64] = {
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const pdk::puint32 sg_sha1K[4] = {0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6};
+
+const pdk::puint64 sg_keccakRoundConstants[24] = {
+   PDK_UINT64_C(0x0000000000000001), PDK_UINT64_C(0x0000000000008082), PDK_UINT64_C(0x800000000000808a),
+   PDK_UINT64_C(0x8000000080008000), PDK_UINT64_C(0x000000000000808b), PDK_UINT64_C(0x0000000080000001),
+   PDK_UINT64_C(0x8000000080008081), PDK_UINT64_C(0x8000000000008009), PDK_UINT64_C(0x000000000000008a),
+   PDK_UINT64_C(0x0000000000000088), PDK_UINT64_C(0x0000000080008009), PDK_UINT64_C(0x000000008000000a),
+   PDK_UINT64_C(0x000000008000808b), PDK_UINT64_C(0x800000000000008b), PDK_UINT64_C(0x8000000000008089),
+   PDK_UINT64_C(0x8000000000008003), PDK_UINT64_C(0x8000000000008002), PDK_UINT64_C(0x8000000000000080),
+   PDK_UINT64_C(0x000000000000800a), PDK_UINT64_C(0x800000008000000a), PDK_UINT64_C(0x8000000080008081),
+   PDK_UINT64_C(0x8000000000008080), PDK_UINT64_C(0x0000000080000001), PDK_UINT64_C(0x8000000080008008)
+};
+
+inline pdk::puint32 rotate_right(pdk::puint32 value, int shift)
+{
+   return (value >> shift) | (value << (32 - shift));
+}
+
+#ifdef PDK_HAVE_SHA_NI_HASH
+PDK_FUNCTION_TARGET(SHA)
+void sha1_blocks_shani(pdk::puint32 *hash, const uchar *blocks, size_t count)
+{
+   const __m128i byteSwap = _mm_set_epi64x(PDK_INT64_C(0x0001020304050607), PDK_INT64_C(0x08090a0b0c0d0e0f));
+   __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)), 0x1b);
+   __m128i e0 = _mm_set_epi32(static_cast<int>(hash[4]), 0, 0, 0);
+   for (; count; --count, blocks += 64) {
+      const __m128i abcdSave = abcd;
+      const __m128i eSave = e0;
+      __m128i msg[4];
+      __m128i e1;
+      for (int i = 0; i < 4; ++i) {
+         msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(blocks + i * 16)), byteSwap);
+      }
+      // four rounds per step, the schedule runs three steps ahead; the
+      // constant conditions fold away once the loop is unrolled
+#define PDK_SHA1_STEP(step, eIn, eOut) \
+      if (step == 0) { \
+         eIn = _mm_add_epi32(eIn, msg[0]); \
+      } else { \
+         eIn = _mm_sha1nexte_epu32(eIn, msg[(step) & 3]); \
+      } \
+      eOut = abcd; \
+      if (step >= 3 && step <= 18) { \
+         msg[((step) + 1) & 3] = _mm_sha1msg2_epu32(msg[((step) + 1) & 3], msg[(step) & 3]); \
+      } \
+      abcd = _mm_sha1rnds4_epu32(abcd, eIn, (step) / 5); \
+      if (step >= 1 && step <= 16) { \
+         msg[((step) - 1) & 3] = _mm_sha1msg1_epu32(msg[((step) - 1) & 3], msg[(step) & 3]); \
+      } \
+      if (step >= 2 && step <= 17) { \
+         msg[((step) + 2) & 3] = _mm_xor_si128(msg[((step) + 2) & 3], msg[(step) & 3]); \
+      }
+      PDK_SHA1_STEP(0, e0, e1) PDK_SHA1_STEP(1, e1, e0) PDK_SHA1_STEP(2, e0, e1) PDK_SHA1_STEP(3, e1, e0)
+      PDK_SHA1_STEP(4, e0, e1) PDK_SHA1_STEP(5, e1, e0) PDK_SHA1_STEP(6, e0, e1) PDK_SHA1_STEP(7, e1, e0)
+      PDK_SHA1_STEP(8, e0, e1) PDK_SHA1_STEP(9, e1, e0) PDK_SHA1_STEP(10, e0, e1) PDK_SHA1_STEP(11, e1, e0)
+      PDK_SHA1_STEP(12, e0, e1) PDK_SHA1_STEP(13, e1, e0) PDK_SHA1_STEP(14, e0, e1) PDK_SHA1_STEP(15, e1, e0)
+      PDK_SHA1_STEP(16, e0, e1) PDK_SHA1_STEP(17, e1, e0) PDK_SHA1_STEP(18, e0, e1) PDK_SHA1_STEP(19, e1, e0)
+#undef PDK_SHA1_STEP
+      e0 = _mm_sha1nexte_epu32(e0, eSave);
+      abcd = _mm_add_epi32(abcd, abcdSave);
+   }
+   _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), _mm_shuffle_epi32(abcd, 0x1b));
+   hash[4] = static_cast<pdk::puint32>(_mm_extract_epi32(e0, 3));
+}
+
+PDK_FUNCTION_TARGET(SHA)
+void sha256_blocks_shani(pdk::puint32 *hash, const uchar *blocks, size_t count)
+{
+   const __m128i byteSwap = _mm_set_epi64x(PDK_INT64_C(0x0c0d0e0f08090a0b), PDK_INT64_C(0x0405060700010203));
+   // the instructions want the state as ABEF and CDGH
+   __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)), 0xb1);
+   __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 4)), 0x1b);
+   __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+   state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+   for (; count; --count, blocks += 64) {
+      const __m128i abefSave = state0;
+      const __m128i cdghSave = state1;
+      __m128i msg[4];
+      for (int i = 0; i < 4; ++i) {
+         msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(blocks + i * 16)), byteSwap);
+      }
+#define PDK_SHA256_STEP(step) \
+      tmp = _mm_add_epi32(msg[(step) & 3], _mm_load_si128(reinterpret_cast<const __m128i *>(sg_sha256K + (step) * 4))); \
+      state1 = _mm_sha256rnds2_epu32(state1, state0, tmp); \
+      if (step >= 3 && step <= 14) { \
+         msg[((step) + 1) & 3] = _mm_add_epi32(msg[((step) + 1) & 3], \
+                                               _mm_alignr_epi8(msg[(step) & 3], msg[((step) - 1) & 3], 4)); \
+         msg[((step) + 1) & 3] = _mm_sha256msg2_epu32(msg[((step) + 1) & 3], msg[(step) & 3]); \
+      } \
+      state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(tmp, 0x0e)); \
+      if (step >= 1 && step <= 12) { \
+         msg[((step) - 1) & 3] = _mm_sha256msg1_epu32(msg[((step) - 1) & 3], msg[(step) & 3]); \
+      }
+      PDK_SHA256_STEP(0) PDK_SHA256_STEP(1) PDK_SHA256_STEP(2) PDK_SHA256_STEP(3)
+      PDK_SHA256_STEP(4) PDK_SHA256_STEP(5) PDK_SHA256_STEP(6) PDK_SHA256_STEP(7)
+      PDK_SHA256_STEP(8) PDK_SHA256_STEP(9) PDK_SHA256_STEP(10) PDK_SHA256_STEP(11)
+      PDK_SHA256_STEP(12) PDK_SHA256_STEP(13) PDK_SHA256_STEP(14) PDK_SHA256_STEP(15)
+#undef PDK_SHA256_STEP
+      state0 = _mm_add_epi32(state0, abefSave);
+      state1 = _mm_add_epi32(state1, cdghSave);
+   }
+   tmp = _mm_shuffle_epi32(state0, 0x1b);
+   state1 = _mm_shuffle_epi32(state1, 0xb1);
+   _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), _mm_blend_epi16(tmp, state1, 0xf0));
+   _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 4), _mm_alignr_epi8(state1, tmp, 8));
+}
+#endif
+
+#ifdef PDK_HAVE_ARM_CRYPTO_HASH
+void sha1_blocks_arm(pdk::puint32 *hash, const uchar *blocks, size_t count)
+{
+   uint32x4_t abcd = vld1q_u32(hash);
+   pdk::puint32 e = hash[4];
+   for (; count; --count, blocks += 64) {
+      const uint32x4_t abcdSave = abcd;
+      const pdk::puint32 eSave = e;
+      uint32x4_t msg[4];
+      for (int i = 0; i < 4; ++i) {
+         msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + i * 16)));
+      }
+      for (int step = 0; step < 20; ++step) {
+         const uint32x4_t wk = vaddq_u32(msg[step & 3], vdupq_n_u32(sg_sha1K[step / 5]));
+         if (step < 16) {
+            msg[step & 3] = vsha1su1q_u32(vsha1su0q_u32(msg[step & 3], msg[(step + 1) & 3], msg[(step + 2) & 3]),
+                                          msg[(step + 3) & 3]);
+         }
+         const pdk::puint32 nextE = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+         if (step < 5) {
+            abcd = vsha1cq_u32(abcd, e, wk);
+         } else if (step < 10 || step >= 15) {
+            abcd = vsha1pq_u32(abcd, e, wk);
+         } else {
+            abcd = vsha1mq_u32(abcd, e, wk);
+         }
+         e = nextE;
+      }
+      abcd = vaddq_u32(abcd, abcdSave);
+      e += eSave;
+   }
+   vst1q_u32(hash, abcd);
+   hash[4] = e;
+}
+
+void sha256_blocks_arm(pdk::puint32 *hash, const uchar *blocks, size_t count)
+{
+   uint32x4_t state0 = vld1q_u32(hash);
+   uint32x4_t state1 = vld1q_u32(hash + 4);
+   for (; count; --count, blocks += 64) {
+      const uint32x4_t abcdSave = state0;
+      const uint32x4_t efghSave = state1;
+      uint32x4_t msg[4];
+      for (int i = 0; i < 4; ++i) {
+         msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + i * 16)));
+      }
+      for (int step = 0; step < 16; ++step) {
+         const uint32x4_t wk = vaddq_u32(msg[step & 3], vld1q_u32(sg_sha256K + step * 4));
+         if (step < 12) {
+            msg[step & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[step & 3], msg[(step + 1) & 3]),
+                                            msg[(step + 2) & 3], msg[(step + 3) & 3]);
+         }
+         const uint32x4_t previous = state0;
+         state0 = vsha256hq_u32(state0, state1, wk);
+         state1 = vsha256h2q_u32(state1, previous, wk);
+      }
+      state0 = vaddq_u32(state0, abcdSave);
+      state1 = vaddq_u32(state1, efghSave);
+   }
+   vst1q_u32(hash, state0);
+   vst1q_u32(hash + 4, state1);
+}
+#endif
+
+#ifdef PDK_HAVE_AVX2_HASH
+PDK_FUNCTION_TARGET(AVX2)
+inline __m256i rotate_right_avx2(__m256i value, int shift)
+{
+   return _mm256_or_si256(_mm256_srli_epi32(value, shift), _mm256_slli_epi32(value, 32 - shift));
+}
+
+// words of eight rows become eight words of one row each
+PDK_FUNCTION_TARGET(AVX2)
+void transpose_8x8_avx2(__m256i *rows)
+{
+   const __m256i t0 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+   const __m256i t1 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+   const __m256i t2 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+   const __m256i t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+   const __m256i t4 = _mm256_unpacklo_epi32(rows[4], rows[5]);
+   const __m256i t5 = _mm256_unpackhi_epi32(rows[4], rows[5]);
+   const __m256i t6 = _mm256_unpacklo_epi32(rows[6], rows[7]);
+   const __m256i t7 = _mm256_unpackhi_epi32(rows[6], rows[7]);
+   const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+   const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+   const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+   const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+   const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+   const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+   const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+   const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+   rows[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+   rows[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+   rows[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+   rows[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+   rows[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+   rows[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+   rows[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+   rows[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// one 64 byte block of each of eight messages, lane i of every state word
+// belongs to message i
+PDK_FUNCTION_TARGET(AVX2)
+void sha256_block_x8_avx2(__m256i *state, const uchar *const *blocks)
+{
+   const __m256i byteSwap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+   __m256i w[16];
+   for (int half = 0; half < 2; ++half) {
+      for (int lane = 0; lane < 8; ++lane) {
+         w[half * 8 + lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(blocks[lane] + half * 32));
+      }
+      transpose_8x8_avx2(w + half * 8);
+   }
+   for (int i = 0; i < 16; ++i) {
+      w[i] = _mm256_shuffle_epi8(w[i], byteSwap);
+   }
+   __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+   __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+   for (int round = 0; round < 64; ++round) {
+      __m256i word;
+      if (round < 16) {
+         word = w[round];
+      } else {
+         const __m256i w15 = w[(round - 15) & 15];
+         const __m256i w2 = w[(round - 2) & 15];
+         const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotate_right_avx2(w15, 7), rotate_right_avx2(w15, 18)),
+                                             _mm256_srli_epi32(w15, 3));
+         const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotate_right_avx2(w2, 17), rotate_right_avx2(w2, 19)),
+                                             _mm256_srli_epi32(w2, 10));
+         word = _mm256_add_epi32(_mm256_add_epi32(w[round & 15], s0), _mm256_add_epi32(w[(round - 7) & 15], s1));
+         w[round & 15] = word;
+      }
+      const __m256i sum1 = _mm256_xor_si256(_mm256_xor_si256(rotate_right_avx2(e, 6), rotate_right_avx2(e, 11)),
+                                            rotate_right_avx2(e, 25));
+      const __m256i choose = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+      const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, sum1), choose),
+                                          _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(sg_sha256K[round])), word));
+      const __m256i sum0 = _mm256_xor_si256(_mm256_xor_si256(rotate_right_avx2(a, 2), rotate_right_avx2(a, 13)),
+                                            rotate_right_avx2(a, 22));
+      const __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+      h = g;
+      g = f;
+      f = e;
+      e = _mm256_add_epi32(d, t1);
+      d = c;
+      c = b;
+      b = a;
+      a = _mm256_add_epi32(t1, _mm256_add_epi32(sum0, majority));
+   }
+   state[0] = _mm256_add_epi32(state[0], a);
+   state[1] = _mm256_add_epi32(state[1], b);
+   state[2] = _mm256_add_epi32(state[2], c);
+   state[3] = _mm256_add_epi32(state[3], d);
+   state[4] = _mm256_add_epi32(state[4], e);
+   state[5] = _mm256_add_epi32(state[5], f);
+   state[6] = _mm256_add_epi32(state[6], g);
+   state[7] = _mm256_add_epi32(state[7], h);
+}
+
+// the shifts must be immediates, a variable count costs a register move
+// per rotation and keeps the compiler from unrolling the rounds
+#define PDK_ROTATE_LEFT64_AVX2(value, shift) \
+   _mm256_or_si256(_mm256_slli_epi64(value, shift), _mm256_srli_epi64(value, 64 - (shift)))
+
+// Keccak-f[1600] on four states, lane i of every word belongs to state i
+PDK_FUNCTION_TARGET(AVX2)
+void keccak_f1600_x4_avx2(__m256i *state)
+{
+   __m256i a00 = state[0], a01 = state[1], a02 = state[2], a03 = state[3], a04 = state[4];
+   __m256i a05 = state[5], a06 = state[6], a07 = state[7], a08 = state[8], a09 = state[9];
+   __m256i a10 = state[10], a11 = state[11], a12 = state[12], a13 = state[13], a14 = state[14];
+   __m256i a15 = state[15], a16 = state[16], a17 = state[17], a18 = state[18], a19 = state[19];
+   __m256i a20 = state[20], a21 = state[21], a22 = state[22], a23 = state[23], a24 = state[24];
+   for (int round = 0; round < 24; ++round) {
+      // theta
+      const __m256i c0 = _mm256_xor_si256(_mm256_xor_si256(a00, a05), _mm256_xor_si256(_mm256_xor_si256(a10, a15), a20));
+      const __m256i c1 = _mm256_xor_si256(_mm256_xor_si256(a01, a06), _mm256_xor_si256(_mm256_xor_si256(a11, a16), a21));
+      const __m256i c2 = _mm256_xor_si256(_mm256_xor_si256(a02, a07), _mm256_xor_si256(_mm256_xor_si256(a12, a17), a22));
+      const __m256i c3 = _mm256_xor_si256(_mm256_xor_si256(a03, a08), _mm256_xor_si256(_mm256_xor_si256(a13, a18), a23));
+      const __m256i c4 = _mm256_xor_si256(_mm256_xor_si256(a04, a09), _mm256_xor_si256(_mm256_xor_si256(a14, a19), a24));
+      const __m256i d0 = _mm256_xor_si256(c4, PDK_ROTATE_LEFT64_AVX2(c1, 1));
+      const __m256i d1 = _mm256_xor_si256(c0, PDK_ROTATE_LEFT64_AVX2(c2, 1));
+      const __m256i d2 = _mm256_xor_si256(c1, PDK_ROTATE_LEFT64_AVX2(c3, 1));
+      const __m256i d3 = _mm256_xor_si256(c2, PDK_ROTATE_LEFT64_AVX2(c4, 1));
+      const __m256i d4 = _mm256_xor_si256(c3, PDK_ROTATE_LEFT64_AVX2(c0, 1));
+      // rho and pi, b[y][2x+3y] = rotate(a[x][y] ^ d[x])
+      const __m256i b00 = _mm256_xor_si256(a00, d0);
+      const __m256i b01 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a06, d1), 44);
+      const __m256i b02 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a12, d2), 43);
+      const __m256i b03 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a18, d3), 21);
+      const __m256i b04 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a24, d4), 14);
+      const __m256i b05 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a03, d3), 28);
+      const __m256i b06 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a09, d4), 20);
+      const __m256i b07 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a10, d0), 3);
+      const __m256i b08 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a16, d1), 45);
+      const __m256i b09 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a22, d2), 61);
+      const __m256i b10 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a01, d1), 1);
+      const __m256i b11 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a07, d2), 6);
+      const __m256i b12 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a13, d3), 25);
+      const __m256i b13 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a19, d4), 8);
+      const __m256i b14 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a20, d0), 18);
+      const __m256i b15 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a04, d4), 27);
+      const __m256i b16 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a05, d0), 36);
+      const __m256i b17 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a11, d1), 10);
+      const __m256i b18 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a17, d2), 15);
+      const __m256i b19 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a23, d3), 56);
+      const __m256i b20 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a02, d2), 62);
+      const __m256i b21 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a08, d3), 55);
+      const __m256i b22 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a14, d4), 39);
+      const __m256i b23 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a15, d0), 41);
+      const __m256i b24 = PDK_ROTATE_LEFT64_AVX2(_mm256_xor_si256(a21, d1), 2);
+      // chi and iota
+      a00 = _mm256_xor_si256(_mm256_xor_si256(b00, _mm256_andnot_si256(b01, b02)),
+                             _mm256_set1_epi64x(static_cast<pdk::pint64>(sg_keccakRoundConstants[round])));
+      a01 = _mm256_xor_si256(b01, _mm256_andnot_si256(b02, b03));
+      a02 = _mm256_xor_si256(b02, _mm256_andnot_si256(b03, b04));
+      a03 = _mm256_xor_si256(b03, _mm256_andnot_si256(b04, b00));
+      a04 = _mm256_xor_si256(b04, _mm256_andnot_si256(b00, b01));
+      a05 = _mm256_xor_si256(b05, _mm256_andnot_si256(b06, b07));
+      a06 = _mm256_xor_si256(b06, _mm256_andnot_si256(b07, b08));
+      a07 = _mm256_xor_si256(b07, _mm256_andnot_si256(b08, b09));
+      a08 = _mm256_xor_si256(b08, _mm256_andnot_si256(b09, b05));
+      a09 = _mm256_xor_si256(b09, _mm256_andnot_si256(b05, b06));
+      a10 = _mm256_xor_si256(b10, _mm256_andnot_si256(b11, b12));
+      a11 = _mm256_xor_si256(b11, _mm256_andnot_si256(b12, b13));
+      a12 = _mm256_xor_si256(b12, _mm256_andnot_si256(b13, b14));
+      a13 = _mm256_xor_si256(b13, _mm256_andnot_si256(b14, b10));
+      a14 = _mm256_xor_si256(b14, _mm256_andnot_si256(b10, b11));
+      a15 = _mm256_xor_si256(b15, _mm256_andnot_si256(b16, b17));
+      a16 = _mm256_xor_si256(b16, _mm256_andnot_si256(b17, b18));
+      a17 = _mm256_xor_si256(b17, _mm256_andnot_si256(b18, b19));
+      a18 = _mm256_xor_si256(b18, _mm256_andnot_si256(b19, b15));
+      a19 = _mm256_xor_si256(b19, _mm256_andnot_si256(b15, b16));
+      a20 = _mm256_xor_si256(b20, _mm256_andnot_si256(b21, b22));
+      a21 = _mm256_xor_si256(b21, _mm256_andnot_si256(b22, b23));
+      a22 = _mm256_xor_si256(b22, _mm256_andnot_si256(b23, b24));
+      a23 = _mm256_xor_si256(b23, _mm256_andnot_si256(b24, b20));
+      a24 = _mm256_xor_si256(b24, _mm256_andnot_si256(b20, b21));
+   }
+   state[0] = a00; state[1] = a01; state[2] = a02; state[3] = a03; state[4] = a04;
+   state[5] = a05; state[6] = a06; state[7] = a07; state[8] = a08; state[9] = a09;
+   state[10] = a10; state[11] = a11; state[12] = a12; state[13] = a13; state[14] = a14;
+   state[15] = a15; state[16] = a16; state[17] = a17; state[18] = a18; state[19] = a19;
+   state[20] = a20; state[21] = a21; state[22] = a22; state[23] = a23; state[24] = a24;
+}
+
+#undef PDK_ROTATE_LEFT64_AVX2
+#endif
+
+// where the blocks of one message in a batch come from: the whole blocks
+// straight from the message, the padded end from a small buffer
+struct LaneBlocks
+{
+   const uchar *m_data;
+   size_t m_wholeBlocks;
+   size_t m_blockCount;
+   uchar m_tail[2 * 168];
+
+   const uchar *getBlock(size_t index, size_t blockSize) const
+   {
+      return index < m_wholeBlocks ? m_data + index * blockSize : m_tail + (index - m_wholeBlocks) * blockSize;
+   }
+};
+
+#ifdef PDK_HAVE_AVX2_HASH
+void prepare_sha256_lane(LaneBlocks *lane, const uchar *data, size_t length)
+{
+   const size_t rest = length % 64;
+   lane->m_data = data;
+   lane->m_wholeBlocks = length / 64;
+   lane->m_blockCount = lane->m_wholeBlocks + (rest < 56 ? 1 : 2);
+   const size_t tailSize = (lane->m_blockCount - lane->m_wholeBlocks) * 64;
+   std::memset(lane->m_tail, 0, tailSize);
+   if (rest) {
+      std::memcpy(lane->m_tail, data + length - rest, rest);
+   }
+   lane->m_tail[rest] = 0x80;
+   pdk::to_big_endian<pdk::puint64>(pdk::puint64(length) << 3, lane->m_tail + tailSize - 8);
+}
+
+void prepare_keccak_lane(LaneBlocks *lane, const uchar *data, size_t length, size_t rate, uchar suffix)
+{
+   const size_t rest = length % rate;
+   lane->m_data = data;
+   lane->m_wholeBlocks = length / rate;
+   lane->m_blockCount = lane->m_wholeBlocks + 1;
+   std::memset(lane->m_tail, 0, rate);
+   if (rest) {
+      std::memcpy(lane->m_tail, data + length - rest, rest);
+   }
+   lane->m_tail[rest] ^= suffix;
+   lane->m_tail[rate - 1] ^= 0x80;
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+void sha256_eight_avx2(const uchar *const *data, const size_t *lengths, size_t count,
+                       int digestSize, uchar *digests)
+{
+   static const pdk::puint32 sha224Init[8] = {
+      0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+   };
+   static const pdk::puint32 sha256Init[8] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+   };
+   static const uchar unused[64] = {};
+   const pdk::puint32 *init = digestSize == 28 ? sha224Init : sha256Init;
+   LaneBlocks lanes[8];
+   size_t maxBlocks = 0;
+   for (size_t i = 0; i < count; ++i) {
+      prepare_sha256_lane(lanes + i, data[i], lengths[i]);
+      maxBlocks = std::max(maxBlocks, lanes[i].m_blockCount);
+   }
+   __m256i state[8];
+   for (int i = 0; i < 8; ++i) {
+      state[i] = _mm256_set1_epi32(static_cast<int>(init[i]));
+   }
+   alignas(32) pdk::puint32 words[8][8];
+   const uchar *blocks[8];
+   for (size_t index = 0; index < maxBlocks; ++index) {
+      for (size_t i = 0; i < 8; ++i) {
+         blocks[i] = i < count && index < lanes[i].m_blockCount ? lanes[i].getBlock(index, 64) : unused;
+      }
+      sha256_block_x8_avx2(state, blocks);
+      // a message that ends here leaves its digest before the lane runs on
+      // over garbage
+      bool stored = false;
+      for (size_t i = 0; i < count; ++i) {
+         if (lanes[i].m_blockCount != index + 1) {
+            continue;
+         }
+         if (!stored) {
+            for (int j = 0; j < 8; ++j) {
+               _mm256_store_si256(reinterpret_cast<__m256i *>(words[j]), state[j]);
+            }
+            stored = true;
+         }
+         for (int j = 0; j < digestSize / 4; ++j) {
+            pdk::to_big_endian<pdk::puint32>(words[j][i], digests + i * digestSize + j * 4);
+         }
+      }
+   }
+}
+
+PDK_FUNCTION_TARGET(AVX2)
+void keccak_four_avx2(const uchar *const *data, const size_t *lengths, size_t count,
+                      int rate, uchar suffix, int digestSize, uchar *digests)
+{
+   static const uchar unused[168] = {};
+   LaneBlocks lanes[4];
+   size_t maxBlocks = 0;
+   for (size_t i = 0; i < count; ++i) {
+      prepare_keccak_lane(lanes + i, data[i], lengths[i], rate, suffix);
+      maxBlocks = std::max(maxBlocks, lanes[i].m_blockCount);
+   }
+   __m256i state[25];
+   for (int i = 0; i < 25; ++i) {
+      state[i] = _mm256_setzero_si256();
+   }
+   alignas(32) pdk::puint64 words[25][4];
+   const uchar *blocks[4];
+   for (size_t index = 0; index < maxBlocks; ++index) {
+      for (size_t i = 0; i < 4; ++i) {
+         blocks[i] = i < count && index < lanes[i].m_blockCount ? lanes[i].getBlock(index, rate) : unused;
+      }
+      for (int i = 0; i < rate / 8; ++i) {
+         const __m256i word = _mm256_set_epi64x(pdk::from_little_endian<pdk::pint64>(blocks[3] + i * 8),
+                                                pdk::from_little_endian<pdk::pint64>(blocks[2] + i * 8),
+                                                pdk::from_little_endian<pdk::pint64>(blocks[1] + i * 8),
+                                                pdk::from_little_endian<pdk::pint64>(blocks[0] + i * 8));
+         state[i] = _mm256_xor_si256(state[i], word);
+      }
+      keccak_f1600_x4_avx2(state);
+      bool stored = false;
+      for (size_t i = 0; i < count; ++i) {
+         if (lanes[i].m_blockCount != index + 1) {
+            continue;
+         }
+         if (!stored) {
+            for (int j = 0; j < 25; ++j) {
+               _mm256_store_si256(reinterpret_cast<__m256i *>(words[j]), state[j]);
+            }
+            stored = true;
+         }
+         // every digest we hand out fits in one block of output
+         uchar *digest = digests + i * digestSize;
+         for (int j = 0; j < digestSize; j += 8) {
+            uchar bytes[8];
+            pdk::to_little_endian<pdk::puint64>(words[j / 8][i], bytes);
+            std::memcpy(digest + j, bytes, std::min(8, digestSize - j));
+         }
+      }
+   }
+}
+#endif
+
+} // anonymous namespace
+
+void sha1_blocks_generic(pdk::puint32 *hash, const uchar *blocks, size_t count)
+{
+   // the portable rounds we always had
+   pdk::internal::Sha1State state;
+   state.h0 = hash[0];
+   state.h1 = hash[1];
+   state.h2 = hash[2];
+   state.h3 = hash[3];
+   state.h4 = hash[4];
+   for (; count; --count, blocks += 64) {
+      pdk::internal::sha1ProcessChunk(&state, blocks);
+   }
+   hash[0] = state.h0;
+   hash[1] = state.h1;
+   hash[2] = state.h2;
+   hash[3] = state.h3;
+   hash[4] = state.h4;
+}
+
+void sha256_blocks_generic(pdk::puint32 *hash, const uchar *blocks, size_t count)
+{
+   for (; count; --count, blocks += 64) {
+      pdk::puint32 w[16];
+      for (int i = 0; i < 16; ++i) {
+         w[i] = pdk::from_big_endian<pdk::puint32>(blocks + i * 4);
+      }
+      pdk::puint32 a = hash[0], b = hash[1], c = hash[2], d = hash[3];
+      pdk::puint32 e = hash[4], f = hash[5], g = hash[6], h = hash[7];
+      // eight rounds per iteration with the variables renamed instead of
+      // moved, the schedule is kept in a ring of sixteen words
+#define PDK_SHA256_ROUND(a, b, c, d, e, f, g, h, i) \
+      { \
+         pdk::puint32 word; \
+         if (round + (i) < 16) { \
+            word = w[(i) & 15]; \
+         } else { \
+            const pdk::puint32 w15 = w[((i) + 1) & 15]; \
+            const pdk::puint32 w2 = w[((i) + 14) & 15]; \
+            word = w[(i) & 15] += (rotate_right(w15, 7) ^ rotate_right(w15, 18) ^ (w15 >> 3)) \
+                  + w[((i) + 9) & 15] + (rotate_right(w2, 17) ^ rotate_right(w2, 19) ^ (w2 >> 10)); \
+         } \
+         const pdk::puint32 t1 = h + (rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25)) \
+               + (g ^ (e & (f ^ g))) + sg_sha256K[round + (i)] + word; \
+         d += t1; \
+         h = t1 + (rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22)) + ((a & b) | (c & (a | b))); \
+      }
+      for (int round = 0; round < 64; round += 16) {
+         PDK_SHA256_ROUND(a, b, c, d, e, f, g, h, 0)
+         PDK_SHA256_ROUND(h, a, b, c, d, e, f, g, 1)
+         PDK_SHA256_ROUND(g, h, a, b, c, d, e, f, 2)
+         PDK_SHA256_ROUND(f, g, h, a, b, c, d, e, 3)
+         PDK_SHA256_ROUND(e, f, g, h, a, b, c, d, 4)
+         PDK_SHA256_ROUND(d, e, f, g, h, a, b, c, 5)
+         PDK_SHA256_ROUND(c, d, e, f, g, h, a, b, 6)
+         PDK_SHA256_ROUND(b, c, d, e, f, g, h, a, 7)
+         PDK_SHA256_ROUND(a, b, c, d, e, f, g, h, 8)
+         PDK_SHA256_ROUND(h, a, b, c, d, e, f, g, 9)
+         PDK_SHA256_ROUND(g, h, a, b, c, d, e, f, 10)
+         PDK_SHA256_ROUND(f, g, h, a, b, c, d, e, 11)
+         PDK_SHA256_ROUND(e, f, g, h, a, b, c, d, 12)
+         PDK_SHA256_ROUND(d, e, f, g, h, a, b, c, 13)
+         PDK_SHA256_ROUND(c, d, e, f, g, h, a, b, 14)
+         PDK_SHA256_ROUND(b, c, d, e, f, g, h, a, 15)
+      }
+#undef PDK_SHA256_ROUND
+      hash[0] += a;
+      hash[1] += b;
+      hash[2] += c;
+      hash[3] += d;
+      hash[4] += e;
+      hash[5] += f;
+      hash[6] += g;
+      hash[7] += h;
+   }
+}
+
+HashBlockFunction sha1_block_function()
+{
+#ifdef PDK_HAVE_SHA_NI_HASH
+   if (CPU_HAS_FEATURE(SHA) && CPU_HAS_FEATURE(SSE4_1)) {
+      return sha1_blocks_shani;
+   }
+#endif
+#ifdef PDK_HAVE_ARM_CRYPTO_HASH
+   return sha1_blocks_arm;
+#else
+   return sha1_blocks_generic;
+#endif
+}
+
+HashBlockFunction sha256_block_function()
+{
+#ifdef PDK_HAVE_SHA_NI_HASH
+   if (CPU_HAS_FEATURE(SHA) && CPU_HAS_FEATURE(SSE4_1)) {
+      return sha256_blocks_shani;
+   }
+#endif
+#ifdef PDK_HAVE_ARM_CRYPTO_HASH
+   return sha256_blocks_arm;
+#else
+   return sha256_blocks_generic;
+#endif
+}
+
+void sha1_init(BlockHashState *state)
+{
+   static const pdk::puint32 init[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+   std::memcpy(state->m_hash, init, sizeof(init));
+   state->m_length = 0;
+}
+
+void sha224_init(BlockHashState *state)
+{
+   static const pdk::puint32 init[8] = {
+      0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+   };
+   std::memcpy(state->m_hash, init, sizeof(init));
+   state->m_length = 0;
+}
+
+void sha256_init(BlockHashState *state)
+{
+   static const pdk::puint32 init[8] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+   };
+   std::memcpy(state->m_hash, init, sizeof(init));
+   state->m_length = 0;
+}
+
+void block_hash_update(BlockHashState *state, const uchar *data, size_t length, HashBlockFunction blocks)
+{
+   size_t buffered = static_cast<size_t>(state->m_length & 63);
+   state->m_length += length;
+   if (buffered) {
+      const size_t fill = std::min(length, 64 - buffered);
+      std::memcpy(state->m_buffer + buffered, data, fill);
+      data += fill;
+      length -= fill;
+      if (buffered + fill < 64) {
+         return;
+      }
+      blocks(state->m_hash, state->m_buffer, 1);
+   }
+   // whole blocks are compressed from where they are
+   if (length >= 64) {
+      blocks(state->m_hash, data, length / 64);
+      data += length & ~size_t(63);
+      length &= 63;
+   }
+   if (length) {
+      std::memcpy(state->m_buffer, data, length);
+   }
+}
+
+void block_hash_final(const BlockHashState *state, uchar *digest, int digestSize, HashBlockFunction blocks)
+{
+   pdk::puint32 hash[8];
+   std::memcpy(hash, state->m_hash, sizeof(hash));
+   uchar tail[128] = {};
+   const size_t buffered = static_cast<size_t>(state->m_length & 63);
+   std::memcpy(tail, state->m_buffer, buffered);
+   tail[buffered] = 0x80;
+   const size_t tailSize = buffered < 56 ? 64 : 128;
+   pdk::to_big_endian<pdk::puint64>(state->m_length << 3, tail + tailSize - 8);
+   blocks(hash, tail, tailSize / 64);
+   for (int i = 0; i < digestSize / 4; ++i) {
+      pdk::to_big_endian<pdk::puint32>(hash[i], digest + i * 4);
+   }
+}
+
+bool sha256_many(const uchar *const *data, const size_t *lengths, size_t count, int digestSize, uchar *digests)
+{
+#ifdef PDK_HAVE_AVX2_HASH
+   // a single SHA-NI stream still outruns eight AVX2 lanes
+   if (CPU_HAS_FEATURE(AVX2) && sha256_block_function() == sha256_blocks_generic) {
+      for (size_t i = 0; i < count; i += 8) {
+         sha256_eight_avx2(data + i, lengths + i, std::min<size_t>(8, count - i), digestSize, digests + i * digestSize);
+      }
+      return true;
+   }
+#endif
+   PDK_UNUSED(data);
+   PDK_UNUSED(lengths);
+   PDK_UNUSED(count);
+   PDK_UNUSED(digestSize);
+   PDK_UNUSED(digests);
+   return false;
+}
+
+bool keccak_many(const uchar *const *data, const size_t *lengths, size_t count,
+                 int rate, uchar suffix, int digestSize, uchar *digests)
+{
+#ifdef PDK_HAVE_AVX2_HASH
+   if (CPU_HAS_FEATURE(AVX2)) {
+      for (size_t i = 0; i < count; i += 4) {
+         keccak_four_avx2(data + i, lengths + i, std::min<size_t>(4, count - i), rate, suffix, digestSize,
+                          digests + i * digestSize);
+      }
+      return true;
+   }
+#endif
+   PDK_UNUSED(data);
+   PDK_UNUSED(lengths);
+   PDK_UNUSED(count);
+   PDK_UNUSED(rate);
+   PDK_UNUSED(suffix);
+   PDK_UNUSED(digestSize);
+   PDK_UNUSED(digests);
+   return false;
+}
+
+} // internal
+} // utils
+} // pdk
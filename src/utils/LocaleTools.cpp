@@ -15,6 +15,7 @@
 
 #include "pdk/utils/internal/LocaleToolsPrivate.h"
 #include "pdk/utils/internal/LocalePrivate.h"
+#include "pdk/utils/internal/DoubleConversionPrivate.h"
 #include "pdk/utils/internal/DoubleScanPrintPrivate.h"
 #include "pdk/global/internal/NumericPrivate.h"
 #include "pdk/base/lang/String.h"
@@ -97,8 +98,6 @@ void double_to_ascii(double d, LocaleData::DoubleForm form, int precision, char
    // to honor higher precisions. We define that at more than 999 digits that is not the case.
    if (precision > 999) {
       precision = 999;
-   } else if (precision == Locale::FloatingPointShortest) {
-      precision = LocaleData::DoubleMaxSignificant; // "shortest" mode not supported by snprintf
    }
    if (is_zero(d)) {
       // Negative zero is expected as simple "0", not "-0". We cannot do d < 0, though.
@@ -113,6 +112,14 @@ void double_to_ascii(double d, LocaleData::DoubleForm form, int precision, char
    } else {
       sign = false;
    }
+   if (precision == Locale::FloatingPointShortest) {
+      // snprintf has no shortest mode, and the digits do not depend on the
+      // form, only where the caller puts the decimal point
+      char digits[LocaleData::DoubleMaxSignificant];
+      length = std::min(double_to_shortest(d, digits, &decpt), bufSize);
+      std::memcpy(buf, digits, length);
+      return;
+   }
    const int formatLength = 7; // '%', '.', 3 digits precision, 'f', '\0'
    char format[formatLength];
    format[formatLength - 1] = '\0';
@@ -231,6 +238,86 @@ void double_to_ascii(double d, LocaleData::DoubleForm form, int precision, char
    }
 }
 
+namespace {
+
+inline bool is_ascii_digit(char ch)
+{
+   return ch >= '0' && ch <= '9';
+}
+
+// [+-]digits[.digits][(e|E)[+-]digits] with up to 19 significant digits,
+// which is what numbers written by us and by JSON encoders look like.
+// Anything else, leading spaces, hex floats, longer significands, is left
+// to the C library
+bool scan_decimal(const char *num, int numLen, double &d, int &processed)
+{
+   const char *ptr = num;
+   const char *end = num + numLen;
+   bool negative = false;
+   if (ptr < end && (*ptr == '-' || *ptr == '+')) {
+      negative = *ptr == '-';
+      ++ptr;
+   }
+   pdk::puint64 significand = 0;
+   int significantDigits = 0;
+   int exponent = 0;
+   bool hasDigits = false;
+   for (; ptr < end && is_ascii_digit(*ptr); ++ptr) {
+      if (significand || *ptr != '0') {
+         if (++significantDigits > 19) {
+            return false;
+         }
+         significand = significand * 10 + (*ptr - '0');
+      }
+      hasDigits = true;
+   }
+   if (ptr < end && (*ptr == 'x' || *ptr == 'X')) {
+      return false;
+   }
+   if (ptr < end && *ptr == '.') {
+      for (++ptr; ptr < end && is_ascii_digit(*ptr); ++ptr) {
+         if (significand || *ptr != '0') {
+            if (++significantDigits > 19) {
+               return false;
+            }
+            significand = significand * 10 + (*ptr - '0');
+         }
+         --exponent;
+         hasDigits = true;
+      }
+   }
+   if (!hasDigits) {
+      return false;
+   }
+   if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+      // an exponent without digits is not part of the number
+      const char *exponentPtr = ptr + 1;
+      bool negativeExponent = false;
+      if (exponentPtr < end && (*exponentPtr == '-' || *exponentPtr == '+')) {
+         negativeExponent = *exponentPtr == '-';
+         ++exponentPtr;
+      }
+      if (exponentPtr < end && is_ascii_digit(*exponentPtr)) {
+         int value = 0;
+         for (; exponentPtr < end && is_ascii_digit(*exponentPtr); ++exponentPtr) {
+            // far beyond any double already
+            if (value < 100000) {
+               value = value * 10 + (*exponentPtr - '0');
+            }
+         }
+         exponent += negativeExponent ? -value : value;
+         ptr = exponentPtr;
+      }
+   }
+   if (!decimal_to_double(significand, exponent, negative, &d)) {
+      return false;
+   }
+   processed = ptr - num;
+   return true;
+}
+
+} // anonymous namespace
+
 double ascii_to_double(const char *num, int numLen, bool &ok, int &processed,
                        TrailingJunkMode trailingJunkMode)
 {
@@ -268,7 +355,8 @@ double ascii_to_double(const char *num, int numLen, bool &ok, int &processed,
    }
    
    double d = 0.0;
-   if (pdk_double_sscanf(num, PDK_CLOCALE, "%lf%n", &d, &processed) < 1) {
+   if (!scan_decimal(num, numLen, d, processed)
+       && pdk_double_sscanf(num, PDK_CLOCALE, "%lf%n", &d, &processed) < 1) {
       processed = 0;
    }
    if ((trailingJunkMode == TrailingJunkMode::TrailingJunkProhibited && processed != numLen) || std::isnan(d)) {
@@ -21,10 +21,12 @@
 #include <algorithm>
 
 #include "pdk/base/ds/ByteArray.h"
+#include "pdk/base/ds/ByteArrayMatcher.h"
 
 using pdk::ds::ByteArrayData;
 using pdk::ds::ByteArrayDataPtr;
 using pdk::ds::ByteArray;
+using pdk::ds::ByteArrayMatcher;
 
 namespace
 {
@@ -1347,3 +1349,86 @@ TEST(ByteArrayTest, testToOrFromHex)
       ++begin;
    }
 }
+
+TEST(ByteArrayTest, testLongArraySearch)
+{
+   // lengths and positions around the 32 and 64 byte block sizes of the wide
+   // kernels, so the vector loops and their tails are all crossed
+   for (int length = 1; length < 200; ++length) {
+      ByteArray base;
+      for (int i = 0; i < length; ++i) {
+         base.append(static_cast<char>('a' + i % 23));
+      }
+      ASSERT_EQ(base.count('a'), (length + 22) / 23);
+      for (int pos = 0; pos < length; pos += (length > 70 ? 5 : 1)) {
+         ByteArray array = base;
+         array[pos] = '\xff';
+         ASSERT_EQ(array.indexOf('\xff'), pos);
+         ASSERT_EQ(array.indexOf('\xff', pos + 1), -1);
+         ASSERT_EQ(array.count('\xff'), 1);
+         ASSERT_TRUE(array.contains('\xff'));
+         if (pos + 4 <= length) {
+            ByteArray hay = base;
+            hay.replace(pos, 4, "WXYZ");
+            ASSERT_EQ(hay.indexOf("WXYZ"), pos);
+            ASSERT_EQ(hay.indexOf(ByteArray("WXYZ"), pos + 1), -1);
+            ASSERT_EQ(hay.count("WXYZ"), 1);
+            ByteArrayMatcher matcher(ByteArray("WXYZ"));
+            ASSERT_EQ(matcher.indexIn(hay), pos);
+         }
+      }
+   }
+}
+
+TEST(ByteArrayTest, testInlineStorage)
+{
+   auto is_inline = [](const ByteArray &array) {
+      const char *begin = reinterpret_cast<const char *>(&array);
+      return array.getConstRawData() >= begin && array.getConstRawData() < begin + sizeof(ByteArray);
+   };
+   ByteArray empty;
+   ASSERT_FALSE(is_inline(empty));
+   ByteArray shortArray("0123456789abcdefghijkl");
+   ASSERT_TRUE(is_inline(shortArray));
+   ASSERT_TRUE(shortArray.isDetached());
+   ASSERT_EQ(shortArray.size(), 22);
+   ASSERT_EQ(shortArray.capacity(), 22);
+   ASSERT_EQ(shortArray.getConstRawData()[22], '\0');
+   ASSERT_FALSE(is_inline(ByteArray("0123456789abcdefghijklm")));
+   ASSERT_TRUE(is_inline(ByteArray(5, 'x')));
+   ASSERT_FALSE(is_inline(ByteArray::fromRawData("abc", 3)));
+   ASSERT_TRUE(ByteArrayLiteral("abc").getDataPtr()->m_ref.isStatic());
+   
+   // copies do not share, writing to one leaves the other alone
+   ByteArray copy = shortArray;
+   ASSERT_TRUE(is_inline(copy));
+   ASSERT_FALSE(copy.isSharedWith(shortArray));
+   copy[0] = 'X';
+   ASSERT_EQ(shortArray, ByteArray("0123456789abcdefghijkl"));
+   ASSERT_EQ(copy, ByteArray("X123456789abcdefghijkl"));
+   
+   // growing past the buffer moves the value to the heap
+   ByteArray grown("abc");
+   grown.append("def");
+   ASSERT_TRUE(is_inline(grown));
+   grown.append(ByteArray(20, 'g'));
+   ASSERT_FALSE(is_inline(grown));
+   ASSERT_EQ(grown, ByteArray("abcdef") + ByteArray(20, 'g'));
+   grown.resize(3);
+   ASSERT_EQ(grown, ByteArray("abc"));
+   ByteArray resized;
+   resized.resize(4);
+   ASSERT_TRUE(is_inline(resized));
+   
+   // the data pointer always points to a header of its own
+   ByteArray exposed("exposed");
+   ByteArray::DataPtr dataPtr = exposed.getDataPtr();
+   ASSERT_FALSE(is_inline(exposed));
+   ASSERT_EQ(dataPtr->m_size, 7);
+   ASSERT_EQ(exposed, ByteArray("exposed"));
+   
+   // moving keeps an inline value where it is
+   ByteArray moved(std::move(copy));
+   ASSERT_EQ(moved, ByteArray("X123456789abcdefghijkl"));
+   ASSERT_TRUE(is_inline(moved));
+}
@@ -0,0 +1,230 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/base/ds/FlatHashMap.h"
+#include "pdk/base/ds/FlatHashSet.h"
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using pdk::ds::ByteArray;
+using pdk::ds::FlatHashMap;
+using pdk::ds::FlatHashSet;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+using pdk::lang::StringView;
+
+namespace {
+
+// every key in one bucket, so probing and erasing in long runs is exercised
+struct CollidingHash
+{
+   size_t operator()(int) const noexcept
+   {
+      return 42;
+   }
+};
+
+} // anonymous namespace
+
+TEST(FlatHashMapTest, testBasics)
+{
+   FlatHashMap<int, int> map;
+   ASSERT_TRUE(map.isEmpty());
+   ASSERT_EQ(map.capacity(), 0u);
+   ASSERT_TRUE(map.find(1) == map.end());
+   ASSERT_TRUE(map.begin() == map.end());
+   ASSERT_EQ(map.erase(1), 0u);
+   ASSERT_TRUE(map.insert(std::make_pair(1, 10)).second);
+   ASSERT_FALSE(map.insert(std::make_pair(1, 11)).second);
+   ASSERT_EQ(map.value(1), 10);
+   ASSERT_EQ(map.value(2, -1), -1);
+   map[2] = 20;
+   ASSERT_EQ(map.size(), 2u);
+   ASSERT_FALSE(map.insertOrAssign(2, 21).second);
+   ASSERT_EQ(map[2], 21);
+   ASSERT_TRUE(map.contains(1));
+   ASSERT_EQ(map.count(2), 1u);
+   std::pair<int, bool> taken = map.take(1);
+   ASSERT_TRUE(taken.second);
+   ASSERT_EQ(taken.first, 10);
+   ASSERT_FALSE(map.contains(1));
+   map.clear();
+   ASSERT_TRUE(map.isEmpty());
+   ASSERT_TRUE(map.begin() == map.end());
+   ASSERT_NE(map.capacity(), 0u);
+}
+
+TEST(FlatHashMapTest, testClearKeepsCapacity)
+{
+   FlatHashMap<int, int> map;
+   for (int i = 0; i < 1000; ++i) {
+      map[i] = i;
+   }
+   const size_t capacity = map.capacity();
+   for (int round = 0; round < 4; ++round) {
+      map.clear();
+      ASSERT_EQ(map.capacity(), capacity);
+      for (int i = 0; i < 1000; ++i) {
+         map[i + round] = i;
+      }
+      ASSERT_EQ(map.size(), 1000u);
+      ASSERT_EQ(map.capacity(), capacity);
+   }
+}
+
+TEST(FlatHashMapTest, testMatchesUnorderedMap)
+{
+   FlatHashMap<int, int> map;
+   std::unordered_map<int, int> expected;
+   std::mt19937 rng(20261018);
+   for (int i = 0; i < 200000; ++i) {
+      const int key = static_cast<int>(rng() % 5000);
+      switch (rng() % 4) {
+      case 0:
+      case 1:
+         ASSERT_EQ(map.insertOrAssign(key, i).second, expected.find(key) == expected.end());
+         expected[key] = i;
+         break;
+      case 2:
+         ASSERT_EQ(map.erase(key), expected.erase(key));
+         break;
+      default: {
+         auto iter = expected.find(key);
+         auto found = map.find(key);
+         ASSERT_EQ(found == map.end(), iter == expected.end());
+         if (iter != expected.end()) {
+            ASSERT_EQ(found->second, iter->second);
+         }
+      }
+      }
+      ASSERT_EQ(map.size(), expected.size());
+   }
+   size_t count = 0;
+   for (const auto &value : map) {
+      ASSERT_EQ(expected.at(value.first), value.second);
+      ++count;
+   }
+   ASSERT_EQ(count, expected.size());
+}
+
+TEST(FlatHashMapTest, testTombstones)
+{
+   // keeps the size small while inserting and erasing many keys, the table
+   // must clean up its deleted slots instead of growing
+   FlatHashMap<int, int, CollidingHash> map;
+   for (int i = 0; i < 10000; ++i) {
+      map[i] = i;
+      if (i >= 8) {
+         ASSERT_EQ(map.erase(i - 8), 1u);
+      }
+      ASSERT_TRUE(map.contains(i));
+   }
+   ASSERT_EQ(map.size(), 8u);
+   ASSERT_LE(map.capacity(), 31u);
+   for (int i = 10000 - 8; i < 10000; ++i) {
+      ASSERT_EQ(map.value(i), i);
+   }
+}
+
+TEST(FlatHashMapTest, testEraseWhileIterating)
+{
+   FlatHashMap<int, std::string> map;
+   for (int i = 0; i < 1000; ++i) {
+      map[i] = std::to_string(i);
+   }
+   for (auto iter = map.begin(); iter != map.end();) {
+      if (iter->first % 3) {
+         iter = map.erase(iter);
+      } else {
+         ++iter;
+      }
+   }
+   ASSERT_EQ(map.size(), 334u);
+   for (const auto &value : map) {
+      ASSERT_EQ(value.first % 3, 0);
+      ASSERT_EQ(value.second, std::to_string(value.first));
+   }
+}
+
+TEST(FlatHashMapTest, testStringKeys)
+{
+   FlatHashMap<String, int> map;
+   for (int i = 0; i < 500; ++i) {
+      map[String::number(i)] = i;
+   }
+   const String longKey(1000, pdk::lang::Character('x'));
+   map[longKey] = -1;
+   ASSERT_EQ(map.value(Latin1String("123")), 123);
+   ASSERT_EQ(map.value(StringView(String::fromLatin1("321"))), 321);
+   ASSERT_TRUE(map.find(Latin1String("500")) == map.end());
+   ASSERT_EQ(map.value(Latin1String(std::string(1000, 'x').c_str())), -1);
+   ASSERT_EQ(map.erase(Latin1String("7")), 1u);
+   ASSERT_FALSE(map.contains(String::fromLatin1("7")));
+   ASSERT_EQ(map.size(), 500u);
+}
+
+TEST(FlatHashMapTest, testByteArrayKeys)
+{
+   FlatHashMap<ByteArray, ByteArray> map;
+   for (int i = 0; i < 1000; ++i) {
+      map.tryEmplace(ByteArray::number(i), ByteArray::number(i * 2));
+   }
+   ASSERT_EQ(map.size(), 1000u);
+   ASSERT_EQ(map.value(ByteArray("999")), ByteArray("1998"));
+}
+
+TEST(FlatHashMapTest, testCopyAndMove)
+{
+   FlatHashMap<int, std::unique_ptr<int>> owner;
+   owner.tryEmplace(1, new int(1));
+   FlatHashMap<int, std::unique_ptr<int>> moved(std::move(owner));
+   ASSERT_TRUE(owner.isEmpty());
+   ASSERT_EQ(*moved.find(1)->second, 1);
+   
+   FlatHashMap<String, int> map{{String::fromLatin1("a"), 1}, {String::fromLatin1("b"), 2}};
+   FlatHashMap<String, int> copy(map);
+   ASSERT_TRUE(copy == map);
+   copy[String::fromLatin1("c")] = 3;
+   ASSERT_TRUE(copy != map);
+   map = copy;
+   ASSERT_EQ(map.value(Latin1String("c")), 3);
+   FlatHashMap<String, int> other;
+   other.swap(map);
+   ASSERT_TRUE(map.isEmpty());
+   ASSERT_EQ(other.size(), 3u);
+}
+
+TEST(FlatHashMapTest, testSet)
+{
+   FlatHashSet<String> set{String::fromLatin1("one"), String::fromLatin1("two")};
+   ASSERT_FALSE(set.insert(String::fromLatin1("one")).second);
+   ASSERT_TRUE(set.insert(String::fromLatin1("three")).second);
+   ASSERT_TRUE(set.contains(Latin1String("two")));
+   ASSERT_EQ(set.erase(Latin1String("two")), 1u);
+   ASSERT_EQ(set.size(), 2u);
+   FlatHashSet<int> numbers;
+   for (int i = 0; i < 100; ++i) {
+      numbers.insert(i % 10);
+   }
+   ASSERT_EQ(numbers.size(), 10u);
+   int sum = 0;
+   for (int value : numbers) {
+      sum += value;
+   }
+   ASSERT_EQ(sum, 45);
+}
@@ -14,12 +14,15 @@
 // Created by zzu_softboy on 2018/01/29.
 
 #include "gtest/gtest.h"
+#include <deque>
+#include <random>
 #include <vector>
 
 #include "pdk/base/ds/internal/RingBufferPrivate.h"
 #include "pdk/base/ds/ByteArray.h"
 
 using pdk::ds::internal::RingBuffer;
+using pdk::ds::internal::RingBufferSegment;
 using pdk::ds::ByteArray;
 
 TEST(RingBufferTest, testConstructing)
@@ -310,3 +313,192 @@ TEST(RingBufferTest, testReadLine)
    ASSERT_EQ(ByteArray(stringBuf, int(strlen(stringBuf))), ba3 + ba4 + ba2);
    ASSERT_EQ(ringBuffer.size(), PDK_INT64_C(0));
 }
+
+TEST(RingBufferTest, testReadableSegments)
+{
+   RingBuffer ringBuffer(16);
+   ByteArray data;
+   for (int i = 0; i < 100; ++i) {
+      data.append(char('a' + i % 26));
+   }
+   ringBuffer.append(data.getConstRawData(), data.size());
+   ringBuffer.free(10);
+   RingBufferSegment segments[16];
+   const int count = ringBuffer.getReadableSegments(segments, 16);
+   ASSERT_GT(count, 1);
+   ByteArray gathered;
+   for (int i = 0; i < count; ++i) {
+      gathered.append(static_cast<const char *>(segments[i].iov_base), int(segments[i].iov_len));
+   }
+   ASSERT_EQ(gathered, data.mid(10));
+   ASSERT_EQ(ringBuffer.getReadableSegments(segments, 2), 2);
+   ringBuffer.free(ringBuffer.size());
+   ASSERT_EQ(ringBuffer.getReadableSegments(segments, 16), 0);
+}
+
+TEST(RingBufferTest, testWritableSegments)
+{
+   RingBuffer ringBuffer(16);
+   ringBuffer.append("0123456789", 10);
+   RingBufferSegment segments[8];
+   const int count = ringBuffer.getWritableSegments(segments, 8, 40);
+   pdk::pint64 room = 0;
+   for (int i = 0; i < count; ++i) {
+      room += segments[i].iov_len;
+   }
+   ASSERT_GE(room, 40);
+   // the space left in the last chunk comes first
+   ASSERT_EQ(segments[0].iov_len, 6u);
+   ASSERT_EQ(ringBuffer.size(), PDK_INT64_C(10));
+   // fill 30 bytes as readv() would
+   pdk::pint64 left = 30;
+   char next = 'a';
+   for (int i = 0; i < count && left > 0; ++i) {
+      const pdk::pint64 bytes = std::min<pdk::pint64>(left, segments[i].iov_len);
+      for (pdk::pint64 j = 0; j < bytes; ++j) {
+         static_cast<char *>(segments[i].iov_base)[j] = next++;
+      }
+      left -= bytes;
+   }
+   ringBuffer.commitWrite(30);
+   ASSERT_EQ(ringBuffer.size(), PDK_INT64_C(40));
+   char result[40];
+   ASSERT_EQ(ringBuffer.read(result, 40), PDK_INT64_C(40));
+   ASSERT_EQ(std::memcmp(result, "0123456789abcdefghijklmnopqrstuvwxyz{|}~", 40), 0);
+   
+   // unused chunks stay around for the next call
+   ASSERT_GE(ringBuffer.getWritableSegments(segments, 1, 100), 1);
+   ringBuffer.commitWrite(0);
+   ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(RingBufferTest, testWritableSegmentsInPacketMode)
+{
+   RingBuffer ringBuffer(0);
+   ringBuffer.append(ByteArray("abc"));
+   RingBufferSegment segments[4];
+   ASSERT_EQ(ringBuffer.getWritableSegments(segments, 4, 5), 1);
+   ASSERT_EQ(segments[0].iov_len, 5u);
+   std::memcpy(segments[0].iov_base, "defgh", 5);
+   ringBuffer.commitWrite(5);
+   ASSERT_EQ(ringBuffer.read(), ByteArray("abc"));
+   ASSERT_EQ(ringBuffer.read(), ByteArray("defgh"));
+}
+
+TEST(RingBufferTest, testCopyAndMove)
+{
+   RingBuffer ringBuffer(0);
+   ringBuffer.append(ByteArray("first"));
+   ringBuffer.append(ByteArray("second"));
+   RingBuffer copy(ringBuffer);
+   RingBuffer moved(std::move(ringBuffer));
+   ASSERT_TRUE(ringBuffer.isEmpty());
+   ASSERT_EQ(copy.read(), ByteArray("first"));
+   ASSERT_EQ(moved.read(), ByteArray("first"));
+   ASSERT_EQ(copy.read(), ByteArray("second"));
+   ringBuffer = moved;
+   ASSERT_EQ(ringBuffer.read(), ByteArray("second"));
+}
+
+TEST(RingBufferTest, testLargeByteArrayShared)
+{
+   const int size = PDK_RING_BUFFER_SHARE_SIZE * 2;
+   const ByteArray large(size, 'a');
+   RingBuffer ringBuffer;
+   ringBuffer.append(large);
+   RingBuffer copy(ringBuffer);
+   // handed back without copying
+   ByteArray out = ringBuffer.read();
+   ASSERT_EQ(out.getConstRawData(), large.getConstRawData());
+   ASSERT_TRUE(ringBuffer.isEmpty());
+   // writing around the shared bytes must not touch the byte array
+   ASSERT_EQ(copy.getChar(), 'a');
+   copy.ungetChar('x');
+   copy.chop(10);
+   copy.putChar('y');
+   std::memset(copy.reserve(100), 'z', 100);
+   copy.append("w", 1);
+   ASSERT_EQ(large, ByteArray(size, 'a'));
+   ByteArray expected = ByteArray(1, 'x') + ByteArray(size - 11, 'a')
+         + ByteArray(1, 'y') + ByteArray(100, 'z') + ByteArray(1, 'w');
+   ByteArray result(static_cast<int>(copy.size()), '\0');
+   ASSERT_EQ(copy.read(result.getRawData(), result.size()), expected.size());
+   ASSERT_EQ(result, expected);
+}
+
+TEST(RingBufferTest, testMatchesDeque)
+{
+   std::mt19937 rng(20261018);
+   for (int chunkSize : {0, 16, 4096}) {
+      RingBuffer ringBuffer(chunkSize);
+      std::deque<char> expected;
+      char counter = 0;
+      for (int i = 0; i < 20000; ++i) {
+         const int bytes = 1 + int(rng() % 300);
+         switch (rng() % 8) {
+         case 0: {
+            char *ptr = ringBuffer.reserve(bytes);
+            for (int j = 0; j < bytes; ++j) {
+               ptr[j] = counter;
+               expected.push_back(counter++);
+            }
+            break;
+         }
+         case 1: {
+            std::vector<char> data;
+            for (int j = 0; j < bytes; ++j) {
+               data.push_back(counter);
+               expected.push_back(counter++);
+            }
+            ringBuffer.append(data.data(), bytes);
+            break;
+         }
+         case 2: {
+            char *ptr = ringBuffer.reserveFront(bytes);
+            for (int j = bytes - 1; j >= 0; --j) {
+               ptr[j] = counter;
+               expected.push_front(counter++);
+            }
+            break;
+         }
+         case 3: {
+            RingBufferSegment segments[4];
+            const int count = ringBuffer.getWritableSegments(segments, 4, bytes);
+            pdk::pint64 written = 0;
+            for (int j = 0; j < count && written < bytes; ++j) {
+               for (size_t k = 0; k < segments[j].iov_len && written < bytes; ++k, ++written) {
+                  static_cast<char *>(segments[j].iov_base)[k] = counter;
+                  expected.push_back(counter++);
+               }
+            }
+            ringBuffer.commitWrite(written);
+            break;
+         }
+         case 4: {
+            const pdk::pint64 count = std::min<pdk::pint64>(bytes, ringBuffer.size());
+            ringBuffer.chop(count);
+            expected.erase(expected.end() - count, expected.end());
+            break;
+         }
+         default: {
+            std::vector<char> data(bytes);
+            const pdk::pint64 count = ringBuffer.read(data.data(), bytes);
+            ASSERT_EQ(count, std::min<pdk::pint64>(bytes, expected.size()));
+            for (pdk::pint64 j = 0; j < count; ++j) {
+               ASSERT_EQ(data[j], expected.front());
+               expected.pop_front();
+            }
+         }
+         }
+         ASSERT_EQ(ringBuffer.size(), static_cast<pdk::pint64>(expected.size()));
+      }
+      RingBufferSegment segments[64];
+      const int count = ringBuffer.getReadableSegments(segments, 64);
+      size_t offset = 0;
+      for (int i = 0; i < count; ++i) {
+         for (size_t j = 0; j < segments[i].iov_len; ++j) {
+            ASSERT_EQ(static_cast<char *>(segments[i].iov_base)[j], expected[offset++]);
+         }
+      }
+   }
+}
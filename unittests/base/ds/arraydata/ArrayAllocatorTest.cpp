@@ -0,0 +1,138 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "pdk/base/ds/ArrayAllocator.h"
+#include "pdk/base/ds/ByteArray.h"
+
+using pdk::ds::ArrayAllocationPolicy;
+using pdk::ds::ArrayAllocationStatistics;
+using pdk::ds::ByteArray;
+
+namespace
+{
+
+struct StatisticsTotal
+{
+   pdk::puint64 m_allocations = 0;
+   pdk::puint64 m_deallocations = 0;
+   pdk::puint64 m_largeAllocations = 0;
+   pdk::puint64 m_largeBytes = 0;
+};
+
+StatisticsTotal get_statistics_total()
+{
+   StatisticsTotal total;
+   for (const ArrayAllocationStatistics &entry : pdk::ds::get_array_allocation_statistics()) {
+      total.m_allocations += entry.m_allocations;
+      total.m_deallocations += entry.m_deallocations;
+      if (entry.m_blockSize == 0) {
+         total.m_largeAllocations += entry.m_allocations;
+         total.m_largeBytes += entry.m_bytesAllocated;
+      }
+   }
+   return total;
+}
+
+}
+
+TEST(ArrayAllocatorTest, testPolicy)
+{
+   // ctest runs this executable with PDK_ARRAY_ALLOCATOR=slab
+   ASSERT_EQ(pdk::ds::get_array_allocation_policy(), ArrayAllocationPolicy::Slab);
+   ASSERT_TRUE(pdk::ds::set_array_allocation_policy(ArrayAllocationPolicy::Slab));
+   ASSERT_FALSE(pdk::ds::set_array_allocation_policy(ArrayAllocationPolicy::System));
+   ASSERT_EQ(pdk::ds::get_array_allocation_policy(), ArrayAllocationPolicy::Slab);
+}
+
+TEST(ArrayAllocatorTest, testStatistics)
+{
+   ASSERT_EQ(pdk::ds::get_array_allocation_policy(), ArrayAllocationPolicy::Slab);
+   const std::vector<ArrayAllocationStatistics> statistics = pdk::ds::get_array_allocation_statistics();
+   ASSERT_GE(statistics.size(), 2u);
+   ASSERT_EQ(statistics.back().m_blockSize, 0u);
+   for (size_t i = 1; i < statistics.size() - 1; ++i) {
+      ASSERT_GT(statistics[i].m_blockSize, statistics[i - 1].m_blockSize);
+   }
+   const size_t largestBlock = statistics[statistics.size() - 2].m_blockSize;
+
+   StatisticsTotal before = get_statistics_total();
+   {
+      // long enough not to be stored inline
+      ByteArray small(40, 'x');
+      StatisticsTotal during = get_statistics_total();
+      ASSERT_EQ(during.m_allocations, before.m_allocations + 1);
+      ASSERT_EQ(during.m_largeAllocations, before.m_largeAllocations);
+   }
+   StatisticsTotal after = get_statistics_total();
+   ASSERT_EQ(after.m_deallocations, before.m_deallocations + 1);
+
+   before = after;
+   {
+      ByteArray large(static_cast<int>(largestBlock) * 4, 'x');
+      StatisticsTotal during = get_statistics_total();
+      ASSERT_EQ(during.m_largeAllocations, before.m_largeAllocations + 1);
+      ASSERT_GE(during.m_largeBytes, before.m_largeBytes + largestBlock * 4);
+   }
+   after = get_statistics_total();
+   ASSERT_EQ(after.m_deallocations, before.m_deallocations + 1);
+}
+
+TEST(ArrayAllocatorTest, testCrossThreadFree)
+{
+   ASSERT_EQ(pdk::ds::get_array_allocation_policy(), ArrayAllocationPolicy::Slab);
+   std::vector<ByteArray> arrays;
+   std::thread producer([&arrays]() {
+      for (int i = 0; i < 1000; ++i) {
+         arrays.push_back(ByteArray(i % 300 + 1, static_cast<char>('a' + i % 26)));
+      }
+   });
+   producer.join();
+   for (int i = 0; i < 1000; ++i) {
+      ASSERT_EQ(arrays[i], ByteArray(i % 300 + 1, static_cast<char>('a' + i % 26)));
+   }
+   // blocks of the finished thread go back to it, and grow past their slab
+   for (size_t i = 0; i < arrays.size(); i += 2) {
+      arrays[i].append(ByteArray(64, '-'));
+   }
+   arrays.clear();
+
+   // one size class, long enough not to be stored inline
+   std::vector<ByteArray> received;
+   std::set<const char *> sent;
+   for (int i = 0; i < 1000; ++i) {
+      received.push_back(ByteArray(100, 'z'));
+      sent.insert(received.back().getConstRawData());
+   }
+   std::thread consumer([&received]() {
+      received.clear();
+   });
+   consumer.join();
+   // the slabs of this thread take the remotely freed blocks back before
+   // they carve new ones
+   size_t reused = 0;
+   for (int i = 0; i < 4000; ++i) {
+      received.push_back(ByteArray(100, 'y'));
+      reused += sent.count(received.back().getConstRawData());
+   }
+   for (const ByteArray &array : received) {
+      ASSERT_EQ(array, ByteArray(100, 'y'));
+   }
+   ASSERT_EQ(reused, sent.size());
+}
@@ -0,0 +1,169 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/base/io/LoggingCategory.h"
+#include "pdk/base/io/internal/LoggingRegisteryPrivate.h"
+#include "pdk/base/lang/String.h"
+#include <string>
+
+using pdk::io::LoggingCategory;
+using pdk::io::internal::LoggingRule;
+using pdk::io::internal::LoggingRuleMatcher;
+using pdk::io::internal::LoggingSettingsParser;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+
+namespace {
+
+int sg_evaluations = 0;
+
+int count_evaluation()
+{
+   return ++sg_evaluations;
+}
+
+int sg_customFilterCalls = 0;
+
+void custom_category_filter(LoggingCategory *category)
+{
+   ++sg_customFilterCalls;
+   category->setEnabled(pdk::MsgType::DebugMsg, true);
+   category->setEnabled(pdk::MsgType::WarningMsg, false);
+}
+
+} // anonymous namespace
+
+TEST(LoggingCategoryTest, testDefaultLevels)
+{
+   LoggingCategory all("test.levels.all");
+   ASSERT_TRUE(all.isDebugEnabled());
+   ASSERT_TRUE(all.isInfoEnabled());
+   ASSERT_TRUE(all.isWarningEnabled());
+   ASSERT_TRUE(all.isCriticalEnabled());
+   ASSERT_TRUE(all.isEnabled(pdk::MsgType::FatalMsg));
+   
+   LoggingCategory warnings("test.levels.warning", pdk::MsgType::WarningMsg);
+   ASSERT_FALSE(warnings.isDebugEnabled());
+   ASSERT_FALSE(warnings.isInfoEnabled());
+   ASSERT_TRUE(warnings.isWarningEnabled());
+   ASSERT_TRUE(warnings.isCriticalEnabled());
+   
+   // debug output of the library itself is off by default
+   LoggingCategory internal("pdk.test.levels");
+   ASSERT_FALSE(internal.isDebugEnabled());
+   ASSERT_TRUE(internal.isWarningEnabled());
+   
+   all.setEnabled(pdk::MsgType::InfoMsg, false);
+   ASSERT_FALSE(all.isEnabled(pdk::MsgType::InfoMsg));
+   ASSERT_TRUE(all.isEnabled(pdk::MsgType::DebugMsg));
+}
+
+TEST(LoggingCategoryTest, testFilterRulesUpdateCategories)
+{
+   LoggingCategory network("app.network");
+   LoggingCategory networkHttp("app.network.http");
+   LoggingCategory storage("app.storage.http");
+   ASSERT_TRUE(networkHttp.isDebugEnabled());
+   
+   LoggingCategory::setFilterRules(String(Latin1String(
+                                             "app.network*=false\n"
+                                             "*.http.warning=true\n"
+                                             "app.storage.http.debug=false\n"
+                                             "*stor*.critical=false")));
+   ASSERT_FALSE(network.isDebugEnabled());
+   ASSERT_FALSE(network.isWarningEnabled());
+   ASSERT_FALSE(networkHttp.isDebugEnabled());
+   ASSERT_TRUE(networkHttp.isWarningEnabled());
+   ASSERT_FALSE(networkHttp.isCriticalEnabled());
+   ASSERT_FALSE(storage.isDebugEnabled());
+   ASSERT_TRUE(storage.isInfoEnabled());
+   ASSERT_FALSE(storage.isCriticalEnabled());
+   
+   // categories created later pick up the rules as well
+   LoggingCategory networkDns("app.network.dns");
+   ASSERT_FALSE(networkDns.isInfoEnabled());
+   
+   LoggingCategory::setFilterRules(String());
+   ASSERT_TRUE(network.isDebugEnabled());
+   ASSERT_TRUE(networkHttp.isCriticalEnabled());
+   ASSERT_TRUE(storage.isCriticalEnabled());
+}
+
+TEST(LoggingCategoryTest, testLaterRulesWin)
+{
+   LoggingCategory category("order.test");
+   LoggingCategory::setFilterRules(String(Latin1String("order.*=false\norder.test.debug=true")));
+   ASSERT_TRUE(category.isDebugEnabled());
+   ASSERT_FALSE(category.isInfoEnabled());
+   LoggingCategory::setFilterRules(String(Latin1String("order.test.debug=true\norder.*=false")));
+   ASSERT_FALSE(category.isDebugEnabled());
+   LoggingCategory::setFilterRules(String());
+}
+
+TEST(LoggingCategoryTest, testRuleMatcher)
+{
+   LoggingSettingsParser parser;
+   parser.setImplicitRulesSection(true);
+   parser.setContent(String(Latin1String("*=false\n"
+                                         "a.b.c=true\n"
+                                         "a.*.warning=true\n"
+                                         "*.c.debug=true\n"
+                                         "*b.c*.info=true\n"
+                                         "x*y=true")));
+   LoggingRuleMatcher matcher;
+   ASSERT_TRUE(matcher.isEmpty());
+   for (const LoggingRule &rule : parser.getRules()) {
+      matcher.addRule(rule);
+   }
+   ASSERT_FALSE(matcher.isEmpty());
+   const int all = 0xf;
+   ASSERT_EQ(matcher.apply("a.b.c", 0), all);
+   ASSERT_EQ(matcher.apply("q.r", all), 0);
+   // suffix rules match the end even when the pattern occurs earlier too
+   ASSERT_EQ(matcher.apply("c.c.c", all), 0x1);
+   ASSERT_EQ(matcher.apply("xb.cx", all), 0x2);
+   ASSERT_EQ(matcher.apply("a.b", all), 0x4);
+   ASSERT_EQ(matcher.apply("a.b.c.c", all), 0x1 | 0x2 | 0x4);
+   // '*' in the middle of a pattern is not supported, the rule is dropped
+   ASSERT_EQ(matcher.apply("x.y", all), 0);
+   matcher.clear();
+   ASSERT_EQ(matcher.apply("q.r", 0x5), 0x5);
+}
+
+TEST(LoggingCategoryTest, testDisabledMacrosSkipArguments)
+{
+   LoggingCategory category("macro.test");
+   category.setEnabled(pdk::MsgType::DebugMsg, false);
+   category.setEnabled(pdk::MsgType::WarningMsg, false);
+   sg_evaluations = 0;
+   cdebug_stream(category, "%d", count_evaluation());
+   cwarning_stream(category) << count_evaluation();
+   ASSERT_EQ(sg_evaluations, 0);
+}
+
+TEST(LoggingCategoryTest, testInstallFilter)
+{
+   LoggingCategory category("filter.test", pdk::MsgType::CriticalMsg);
+   sg_customFilterCalls = 0;
+   LoggingCategory::CategoryFilter old = LoggingCategory::installFilter(custom_category_filter);
+   ASSERT_GT(sg_customFilterCalls, 0);
+   ASSERT_TRUE(category.isDebugEnabled());
+   ASSERT_FALSE(category.isWarningEnabled());
+   LoggingCategory::installFilter(old);
+   ASSERT_FALSE(category.isDebugEnabled());
+   ASSERT_FALSE(category.isWarningEnabled());
+   ASSERT_TRUE(category.isCriticalEnabled());
+}
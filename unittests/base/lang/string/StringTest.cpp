@@ -4355,6 +4355,26 @@ TEST(StringTest, testNumber)
 #endif
 }
 
+TEST(StringTest, testNumberShortest)
+{
+   const int shortest = pdk::utils::Locale::FloatingPointShortest;
+   ASSERT_EQ(String::number(0.1, 'g', shortest), Latin1String("0.1"));
+   ASSERT_EQ(String::number(0.1 + 0.2, 'g', shortest), Latin1String("0.30000000000000004"));
+   ASSERT_EQ(String::number(-1.5, 'f', shortest), Latin1String("-1.5"));
+   ASSERT_EQ(String::number(100.0, 'f', shortest), Latin1String("100"));
+   ASSERT_EQ(String::number(1e21, 'g', shortest), Latin1String("1e+21"));
+   ASSERT_EQ(String::number(1.25e-7, 'e', shortest), Latin1String("1.25e-7"));
+   ASSERT_EQ(String::number(5e-324, 'g', shortest), Latin1String("5e-324"));
+   ASSERT_EQ(ByteArray::number(2.5, 'g', shortest), ByteArray("2.5"));
+   ASSERT_EQ(ByteArray::number(2.5, 'E', shortest), ByteArray("2.5E+0"));
+   const double values[] = {0.1, 1.0 / 3.0, 2.0 / 3.0, 1e23, 123456.789, 1.7976931348623157e308, 2.2250738585072014e-308};
+   for (double value : values) {
+      bool ok;
+      ASSERT_EQ(String::number(value, 'g', shortest).toDouble(&ok), value);
+      ASSERT_TRUE(ok);
+   }
+}
+
 namespace {
 
 void capacity_data(std::list<std::tuple<String, int>> &data)
@@ -6083,10 +6103,10 @@ TEST(StringTest, testAssignLatin1String)
     String s;
     ASSERT_EQ(s.capacity(), 0);
 
-    // assign to null String:
+    // assign to null String, short values are stored inline:
     s = latin1foo;
     ASSERT_EQ(s, String::fromLatin1("foo"));
-    ASSERT_EQ(s.capacity(), 3);
+    ASSERT_EQ(s.capacity(), 10);
 
     // assign to non-null String with enough capacity:
     s = String::fromLatin1("foofoo");
@@ -6096,18 +6116,19 @@ TEST(StringTest, testAssignLatin1String)
     ASSERT_EQ(s.capacity(), capacity);
 
     // assign to shared String (enough capacity, but can't use):
-    s = String::fromLatin1("foofoo");
+    s = String::fromLatin1("foofoofoofoo");
     String s2 = s;
+    ASSERT_TRUE(s.isSharedWith(s2));
     s = latin1foo;
     ASSERT_EQ(s, String::fromLatin1("foo"));
-    ASSERT_EQ(s.capacity(), 3);
+    ASSERT_EQ(s.capacity(), 10);
 
     // assign to String with too little capacity:
-    s = String::fromLatin1("fo");
-    ASSERT_EQ(s.capacity(), 2);
-    s = latin1foo;
-    ASSERT_EQ(s, String::fromLatin1("foo"));
-    ASSERT_EQ(s.capacity(), 3);
+    s = String::fromLatin1("foofoofoofoo");
+    ASSERT_EQ(s.capacity(), 12);
+    s = Latin1String("foofoofoofoofoo");
+    ASSERT_EQ(s, String::fromLatin1("foofoofoofoofoo"));
+    ASSERT_EQ(s.capacity(), 15);
 
 }
 
@@ -6117,25 +6138,25 @@ TEST(StringTest, testAssignChar)
     String s;
     ASSERT_EQ(s.capacity(), 0);
 
-    // assign to null String:
+    // assign to null String, short values are stored inline:
     s = sp;
     ASSERT_EQ(s, String(sp));
-    ASSERT_EQ(s.capacity(), 1);
+    ASSERT_EQ(s.capacity(), 10);
 
     // assign to non-null String with enough capacity:
-    s = Latin1String("foo");
+    s = Latin1String("foofoofoofoo");
     const int capacity = s.capacity();
-    ASSERT_EQ(capacity, 3);
+    ASSERT_EQ(capacity, 12);
     s = sp;
     ASSERT_EQ(s, String(sp));
     ASSERT_EQ(s.capacity(), capacity);
 
     // assign to shared String (enough capacity, but can't use):
-    s = Latin1String("foo");
+    s = Latin1String("foofoofoofoo");
     String s2 = s;
     s = sp;
     ASSERT_EQ(s, String(sp));
-    ASSERT_EQ(s.capacity(), 1);
+    ASSERT_EQ(s.capacity(), 10);
 
     // assign to empty String:
     s = String(Latin1String(""));
@@ -6143,7 +6164,7 @@ TEST(StringTest, testAssignChar)
     ASSERT_EQ(s.capacity(), 0);
     s = sp;
     ASSERT_EQ(s, String(sp));
-    ASSERT_EQ(s.capacity(), 1);
+    ASSERT_EQ(s.capacity(), 10);
 }
 
 namespace {
@@ -6193,3 +6214,113 @@ TEST(StringTest, testIsRightToLeft)
    }
 }
 
+
+TEST(StringTest, testLongStringKernels)
+{
+   // lengths and positions around the 16 and 32 unit block sizes of the wide
+   // kernels, so the vector loops and their tails are all crossed
+   for (int length = 1; length < 150; ++length) {
+      String base;
+      ByteArray latin1;
+      for (int i = 0; i < length; ++i) {
+         base.append(Character(static_cast<char16_t>('a' + i % 23)));
+         latin1.append(static_cast<char>(0xa0 + i % 89));
+      }
+      const String upper = base.toUpper();
+      for (int pos = 0; pos < length; pos += (length > 40 ? 7 : 1)) {
+         String str = base;
+         str[pos] = Character(0x263a);
+         ASSERT_EQ(str.indexOf(Character(0x263a)), pos);
+         ASSERT_EQ(str.count(Character(0x263a)), 1);
+         ASSERT_EQ(str.indexOf(Character(0x263a), pos + 1), -1);
+         ASSERT_TRUE(str.contains(Character(0x263a)));
+         ASSERT_TRUE(str.compare(base) > 0);
+         ASSERT_TRUE(base.compare(str) < 0);
+         ASSERT_EQ(str.compare(base, pdk::CaseSensitivity::Insensitive) > 0, true);
+         ASSERT_EQ(upper.compare(str, pdk::CaseSensitivity::Insensitive) < 0, true);
+         ASSERT_EQ(str.toLatin1().indexOf('?'), pos);
+         if (pos + 3 <= length) {
+            String hay = base;
+            hay.replace(pos, 3, String::fromLatin1("XYZ"));
+            ASSERT_EQ(hay.indexOf(String::fromLatin1("XYZ")), pos);
+            ASSERT_EQ(hay.count(String::fromLatin1("XYZ")), 1);
+            ASSERT_EQ(hay.indexOf(String::fromLatin1("XYZ"), pos + 1), -1);
+            ASSERT_EQ(hay.indexOf(Latin1String("XYZ")), pos);
+            StringMatcher matcher(String::fromLatin1("XYZ"));
+            ASSERT_EQ(matcher.indexIn(hay), pos);
+         }
+         String fromLatin1 = String::fromLatin1(latin1);
+         ASSERT_EQ(fromLatin1.toLatin1(), latin1);
+         ASSERT_EQ(fromLatin1.compare(Latin1String(latin1.getConstRawData(), latin1.size())), 0);
+         fromLatin1[pos] = Character(static_cast<char16_t>(fromLatin1.at(pos).unicode() + 1));
+         ASSERT_TRUE(fromLatin1.compare(Latin1String(latin1.getConstRawData(), latin1.size())) > 0);
+      }
+      ASSERT_EQ(base.compare(upper, pdk::CaseSensitivity::Insensitive), 0);
+      ASSERT_EQ(upper.compare(Latin1String(base.toLatin1()), pdk::CaseSensitivity::Insensitive), 0);
+      ASSERT_EQ(base.count(Character('a')), (length + 22) / 23);
+      // a non ASCII run after the ASCII prefix still folds with the full tables
+      ASSERT_EQ((base + String(Character(0x00c4))).compare(upper + String(Character(0x00e4)),
+                                                         pdk::CaseSensitivity::Insensitive), 0);
+   }
+}
+
+TEST(StringTest, testInlineStorage)
+{
+   auto is_inline = [](const String &str) {
+      const char *begin = reinterpret_cast<const char *>(&str);
+      const char *data = reinterpret_cast<const char *>(str.getConstRawData());
+      return data >= begin && data < begin + sizeof(String);
+   };
+   ASSERT_FALSE(is_inline(String()));
+   String shortStr(Latin1String("0123456789"));
+   ASSERT_TRUE(is_inline(shortStr));
+   ASSERT_TRUE(shortStr.isDetached());
+   ASSERT_EQ(shortStr.capacity(), 10);
+   ASSERT_EQ(shortStr.getConstRawData()[10], Character(0));
+   ASSERT_FALSE(is_inline(String(Latin1String("0123456789a"))));
+   ASSERT_TRUE(is_inline(String(Character('x'))));
+   ASSERT_TRUE(is_inline(String::fromUtf8("caf\xc3\xa9")));
+   ASSERT_TRUE(is_inline(String::number(42)));
+   ASSERT_TRUE(is_inline(String::fromLatin1("0123456789").substring(2, 3)));
+   const Character raw[] = { 'r', 'a', 'w' };
+   ASSERT_FALSE(is_inline(String::fromRawData(raw, 3)));
+   
+   // copies do not share, writing to one leaves the other alone
+   String copy = shortStr;
+   ASSERT_TRUE(is_inline(copy));
+   copy[0] = Character('X');
+   ASSERT_EQ(shortStr, Latin1String("0123456789"));
+   ASSERT_EQ(copy, Latin1String("X123456789"));
+   
+   // growing past the buffer moves the value to the heap
+   String grown(Latin1String("abc"));
+   grown += Character('d');
+   ASSERT_TRUE(is_inline(grown));
+   grown.append(Latin1String("efghijklmnop"));
+   ASSERT_FALSE(is_inline(grown));
+   ASSERT_EQ(grown, Latin1String("abcdefghijklmnop"));
+   String filled(Character('a'));
+   filled += Latin1String("bcdefghij");
+   ASSERT_TRUE(is_inline(filled));
+   ASSERT_EQ(filled.size(), 10);
+   ASSERT_EQ(filled, Latin1String("abcdefghij"));
+
+   // toLatin1() of an inline temporary can not reuse its buffer
+   ASSERT_EQ(String(Latin1String("latin1")).toLatin1(), ByteArray("latin1"));
+   
+   // the data pointer always points to a header of its own
+   String exposed(Latin1String("exposed"));
+   String::DataPtr dataPtr = exposed.getDataPtr();
+   ASSERT_FALSE(is_inline(exposed));
+   ASSERT_EQ(dataPtr->m_size, 7);
+   ASSERT_EQ(exposed, Latin1String("exposed"));
+   
+   // relocating the bytes keeps the value intact
+   alignas(String) char buffer[sizeof(String)];
+   std::memcpy(buffer, static_cast<void *>(&copy), sizeof(String));
+   new (&copy) String;
+   String *relocated = reinterpret_cast<String *>(buffer);
+   ASSERT_EQ(*relocated, Latin1String("X123456789"));
+   ASSERT_TRUE(is_inline(*relocated));
+   relocated->~String();
+}
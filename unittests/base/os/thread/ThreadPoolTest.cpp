@@ -24,6 +24,7 @@
 #include "pdktest/PdkTest.h"
 #include "pdk/global/Random.h"
 #include <mutex>
+#include <set>
 #include <iostream>
 
 using FunctionPointer =  void (*)();
@@ -1260,3 +1261,238 @@ TEST(ThreadPoolTest, testWaitForDoneAfterTake)
    }
    PDKTEST_END_APP_CONTEXT();
 }
+
+TEST(ThreadPoolTest, testWorkStealingPolicy)
+{
+   PDKTEST_BEGIN_APP_CONTEXT();
+   ThreadPool manager;
+   EXPECT_TRUE(manager.getSchedulingPolicy() == ThreadPool::SchedulingPolicy::GlobalQueue);
+   EXPECT_TRUE(manager.setSchedulingPolicy(ThreadPool::SchedulingPolicy::WorkStealing));
+   EXPECT_TRUE(manager.getSchedulingPolicy() == ThreadPool::SchedulingPolicy::WorkStealing);
+   testFunctionCount = 0;
+   manager.start(create_task(no_sleep_test_function_mutex));
+   // the pool is running now, the policy is fixed until waitForDone()
+   EXPECT_TRUE(!manager.setSchedulingPolicy(ThreadPool::SchedulingPolicy::GlobalQueue));
+   EXPECT_TRUE(manager.waitForDone());
+   EXPECT_EQ(testFunctionCount, 1);
+   EXPECT_TRUE(manager.setSchedulingPolicy(ThreadPool::SchedulingPolicy::GlobalQueue));
+   PDKTEST_END_APP_CONTEXT();
+}
+
+TEST(ThreadPoolTest, testWorkStealingRunMultiple)
+{
+   PDKTEST_BEGIN_APP_CONTEXT();
+   {
+      ThreadPool manager;
+      manager.setSchedulingPolicy(ThreadPool::SchedulingPolicy::WorkStealing);
+      testFunctionCount = 0;
+      for (int i = 0; i < 1000; ++i) {
+         manager.start(create_task(no_sleep_test_function_mutex), i % 3 - 1);
+      }
+   }
+   EXPECT_EQ(testFunctionCount, 1000);
+   PDKTEST_END_APP_CONTEXT();
+}
+
+TEST(ThreadPoolTest, testWorkStealingNestedSpawn)
+{
+   PDKTEST_BEGIN_APP_CONTEXT();
+   // every task pushes its children into the local deque of the worker
+   // running it, the other workers have to steal them
+   class SpawnTask : public Runnable
+   {
+   public:
+      SpawnTask(ThreadPool &pool, AtomicInt &counter, int depth)
+         : m_pool(pool),
+           m_counter(counter),
+           m_depth(depth)
+      {}
+      
+      void run() override
+      {
+         m_counter.ref();
+         if (m_depth > 0) {
+            for (int i = 0; i < 4; ++i) {
+               m_pool.start(new SpawnTask(m_pool, m_counter, m_depth - 1), i % 2);
+            }
+         }
+      }
+   private:
+      ThreadPool &m_pool;
+      AtomicInt &m_counter;
+      int m_depth;
+   };
+   
+   AtomicInt counter(0);
+   ThreadPool manager;
+   manager.setSchedulingPolicy(ThreadPool::SchedulingPolicy::WorkStealing);
+   manager.setMaxThreadCount(8);
+   for (int i = 0; i < 8; ++i) {
+      manager.start(new SpawnTask(manager, counter, 5));
+   }
+   EXPECT_TRUE(manager.waitForDone(5 * 60 * 1000));
+   // 8 * (1 + 4 + 16 + 64 + 256 + 1024)
+   EXPECT_EQ(counter.load(), 8 * 1365);
+   PDKTEST_END_APP_CONTEXT();
+}
+
+TEST(ThreadPoolTest, testWorkStealingExpiry)
+{
+   PDKTEST_BEGIN_APP_CONTEXT();
+   // workers expire between the rounds, the pool must restart the expired
+   // ones and still run everything they had queued locally
+   class SpawnTask : public Runnable
+   {
+   public:
+      SpawnTask(ThreadPool &pool, AtomicInt &counter, std::mutex &mutex,
+                std::set<Thread *> &workers, int depth)
+         : m_pool(pool),
+           m_counter(counter),
+           m_mutex(mutex),
+           m_workers(workers),
+           m_depth(depth)
+      {}
+      
+      void run() override
+      {
+         {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_workers.insert(Thread::getCurrentThread());
+         }
+         m_counter.ref();
+         for (int i = 0; m_depth > 0 && i < 3; ++i) {
+            m_pool.start(new SpawnTask(m_pool, m_counter, m_mutex, m_workers, m_depth - 1), i - 1);
+         }
+      }
+   private:
+      ThreadPool &m_pool;
+      AtomicInt &m_counter;
+      std::mutex &m_mutex;
+      std::set<Thread *> &m_workers;
+      int m_depth;
+   };
+   
+   AtomicInt counter(0);
+   std::mutex mutex;
+   std::set<Thread *> workers;
+   ThreadPool manager;
+   manager.setSchedulingPolicy(ThreadPool::SchedulingPolicy::WorkStealing);
+   manager.setMaxThreadCount(4);
+   manager.setExpiryTimeout(10);
+   for (int round = 1; round <= 5; ++round) {
+      for (int i = 0; i < 4; ++i) {
+         manager.start(new SpawnTask(manager, counter, mutex, workers, 4));
+      }
+      EXPECT_TRUE(manager.waitForDone(60 * 1000));
+      // 4 * (1 + 3 + 9 + 27 + 81)
+      EXPECT_EQ(counter.load(), round * 4 * 121);
+      // every worker of this round has to expire
+      std::lock_guard<std::mutex> locker(mutex);
+      for (Thread *worker : workers) {
+         EXPECT_TRUE(worker->wait(10000));
+      }
+      EXPECT_EQ(manager.getActiveThreadCount(), 0);
+   }
+   // later rounds ran on the expired workers instead of new threads
+   EXPECT_LE(workers.size(), 4u);
+   PDKTEST_END_APP_CONTEXT();
+}
+
+TEST(ThreadPoolTest, testWorkStealingTryTakeAndClear)
+{
+   PDKTEST_BEGIN_APP_CONTEXT();
+   Semaphore sem(0);
+   Semaphore started(0);
+   AtomicInt runCounter(0);
+   
+   class BlockingRunnable : public Runnable
+   {
+   public:
+      BlockingRunnable(Semaphore &sem, Semaphore &started, AtomicInt &runCounter)
+         : m_sem(sem),
+           m_started(started),
+           m_runCounter(runCounter)
+      {}
+      
+      void run() override
+      {
+         m_started.release();
+         m_sem.acquire();
+         m_runCounter.ref();
+      }
+   private:
+      Semaphore &m_sem;
+      Semaphore &m_started;
+      AtomicInt &m_runCounter;
+   };
+   
+   class QueueingRunnable : public Runnable
+   {
+   public:
+      QueueingRunnable(ThreadPool &pool, Runnable **children, int count, Semaphore &queued)
+         : m_pool(pool),
+           m_children(children),
+           m_count(count),
+           m_queued(queued)
+      {}
+      
+      void run() override
+      {
+         // these land in the local deque of this worker
+         for (int i = 0; i < m_count; ++i) {
+            m_pool.start(m_children[i]);
+         }
+         m_queued.release();
+      }
+   private:
+      ThreadPool &m_pool;
+      Runnable **m_children;
+      int m_count;
+      Semaphore &m_queued;
+   };
+   
+   enum {
+      MaxThreadCount = 2,
+      Children = 6
+   };
+   
+   ThreadPool threadPool;
+   threadPool.setSchedulingPolicy(ThreadPool::SchedulingPolicy::WorkStealing);
+   threadPool.setMaxThreadCount(MaxThreadCount);
+   const SemaphoreReleaser semReleaser(sem, Children + MaxThreadCount);
+   
+   // occupy one worker so that the local deque of the other one is not drained
+   threadPool.start(new BlockingRunnable(sem, started, runCounter));
+   EXPECT_TRUE(started.tryAcquire(1, 60 * 1000));
+   
+   Runnable *children[Children];
+   for (int i = 0; i < Children; ++i) {
+      children[i] = new BlockingRunnable(sem, started, runCounter);
+      children[i]->setAutoDelete(false);
+   }
+   Semaphore queued(0);
+   threadPool.start(new QueueingRunnable(threadPool, children, Children, queued));
+   EXPECT_TRUE(queued.tryAcquire(1, 60 * 1000));
+   // the queueing worker now runs one child and blocks, the rest stay queued
+   EXPECT_TRUE(started.tryAcquire(1, 60 * 1000));
+   
+   int taken = 0;
+   for (int i = 0; i < Children; ++i) {
+      if (threadPool.tryTake(children[i])) {
+         ++taken;
+      }
+   }
+   EXPECT_EQ(taken, int(Children - 1));
+   // taking twice is a no-op
+   for (int i = 0; i < Children; ++i) {
+      EXPECT_TRUE(!threadPool.tryTake(children[i]));
+   }
+   threadPool.clear();
+   sem.release(MaxThreadCount);
+   EXPECT_TRUE(threadPool.waitForDone());
+   EXPECT_EQ(runCounter.load(), int(MaxThreadCount));
+   for (int i = 0; i < Children; ++i) {
+      delete children[i];
+   }
+   PDKTEST_END_APP_CONTEXT();
+}
@@ -23,3 +23,154 @@
 #include "gtest/gtest.h"
 #include "pdk/base/text/codecs/TextCodec.h"
 
+#include "pdk/base/text/codecs/internal/UtfCodecPrivate.h"
+#include "pdk/base/lang/String.h"
+#include "pdk/base/ds/ByteArray.h"
+#include <vector>
+
+using pdk::text::codecs::TextCodec;
+using pdk::text::codecs::TextDecoder;
+using pdk::text::codecs::internal::Utf8;
+using pdk::lang::String;
+using pdk::lang::Character;
+using pdk::ds::ByteArray;
+
+namespace {
+
+void append_utf8(ByteArray &out, char32_t ucs4)
+{
+   if (ucs4 < 0x80) {
+      out.append(char(ucs4));
+   } else if (ucs4 < 0x800) {
+      out.append(char(0xc0 | (ucs4 >> 6)));
+      out.append(char(0x80 | (ucs4 & 0x3f)));
+   } else if (ucs4 < 0x10000) {
+      out.append(char(0xe0 | (ucs4 >> 12)));
+      out.append(char(0x80 | ((ucs4 >> 6) & 0x3f)));
+      out.append(char(0x80 | (ucs4 & 0x3f)));
+   } else {
+      out.append(char(0xf0 | (ucs4 >> 18)));
+      out.append(char(0x80 | ((ucs4 >> 12) & 0x3f)));
+      out.append(char(0x80 | ((ucs4 >> 6) & 0x3f)));
+      out.append(char(0x80 | (ucs4 & 0x3f)));
+   }
+}
+
+// long enough for several validation blocks, with every script mixed with ASCII
+std::vector<std::vector<char32_t>> multibyte_texts()
+{
+   std::vector<std::vector<char32_t>> texts;
+   std::vector<char32_t> latin;
+   std::vector<char32_t> cyrillic;
+   std::vector<char32_t> cjk;
+   std::vector<char32_t> emoji;
+   std::vector<char32_t> mixed;
+   for (char32_t i = 0; i < 400; ++i) {
+      latin.push_back(i % 7 ? 'a' + i % 26 : 0xe0 + i % 31);
+      cyrillic.push_back(i % 9 ? 0x430 + i % 32 : ' ');
+      cjk.push_back(i % 50 ? 0x4e00 + i * 37 % 0x5000 : 0x3002);
+      emoji.push_back(i % 3 ? 0x1f600 + i % 0x50 : 0x200d);
+      const char32_t samples[] = {'x', 0xdf, 0x3a9, 0x20ac, 0xfeff, 0xffff, 0x10000, 0x10ffff, 0x7ff, 0x800};
+      mixed.push_back(samples[i * 7 % 10]);
+   }
+   texts.push_back(latin);
+   texts.push_back(cyrillic);
+   texts.push_back(cjk);
+   texts.push_back(emoji);
+   texts.push_back(mixed);
+   return texts;
+}
+
+String decode_in_chunks(const ByteArray &utf8, int chunkSize)
+{
+   TextDecoder decoder(TextCodec::codecForMib(106));
+   String result;
+   for (int i = 0; i < utf8.size(); i += chunkSize) {
+      result += decoder.toUnicode(utf8.getConstRawData() + i, std::min(chunkSize, utf8.size() - i));
+   }
+   return result;
+}
+
+} // anonymous namespace
+
+TEST(TextCodecTest, testUtf8LongMultibyteText)
+{
+   for (const std::vector<char32_t> &text : multibyte_texts()) {
+      ByteArray utf8;
+      for (char32_t ucs4 : text) {
+         append_utf8(utf8, ucs4);
+      }
+      const String expected = String::fromUcs4(text.data(), static_cast<int>(text.size()));
+      ASSERT_TRUE(Utf8::isValidUtf8(utf8.getConstRawData(), utf8.size()));
+      ASSERT_EQ(String::fromUtf8(utf8), expected);
+      ASSERT_EQ(expected.toUtf8(), utf8);
+      ASSERT_EQ(decode_in_chunks(utf8, 7), expected);
+      ASSERT_EQ(decode_in_chunks(utf8, 100), expected);
+   }
+}
+
+TEST(TextCodecTest, testUtf8InvalidSequencesInLongText)
+{
+   // every byte of these is reported as one replacement character
+   const char *const invalid[] = {
+      "\xc0\x80",          // overlong
+      "\xe0\x9f\xbf",      // overlong
+      "\xed\xa0\x80",      // surrogate
+      "\xf4\x90\x80\x80",  // above U+10FFFF
+      "\xf8\x88\x80\x80",  // not a lead byte
+      "\x80",              // continuation without a lead
+      "\xe4\xb8"           // truncated, followed by more text
+   };
+   for (const char *sequence : invalid) {
+      const int sequenceLength = static_cast<int>(std::strlen(sequence));
+      for (int position : {0, 1, 31, 62, 63, 64, 65, 127, 200}) {
+         ByteArray utf8;
+         String expected;
+         for (int i = 0; i < 100; ++i) {
+            if (utf8.size() >= position && expected.size() == i) {
+               utf8.append(sequence);
+               expected.append(String(sequenceLength, Character::ReplacementCharacter));
+            }
+            const char32_t ucs4 = 0x4e00 + i;
+            append_utf8(utf8, ucs4);
+            expected.append(String::fromUcs4(&ucs4, 1));
+         }
+         ASSERT_FALSE(Utf8::isValidUtf8(utf8.getConstRawData(), utf8.size()));
+         ASSERT_EQ(String::fromUtf8(utf8), expected);
+         ASSERT_EQ(decode_in_chunks(utf8, 13), expected);
+         
+         TextCodec::ConverterState state;
+         TextCodec::codecForMib(106)->toUnicode(utf8.getConstRawData(), utf8.size(), &state);
+         ASSERT_EQ(state.m_invalidChars, sequenceLength);
+      }
+   }
+   
+   // a truncated sequence at the very end
+   ByteArray utf8;
+   for (int i = 0; i < 100; ++i) {
+      append_utf8(utf8, 0x4e00 + i);
+   }
+   utf8.chop(1);
+   ASSERT_FALSE(Utf8::isValidUtf8(utf8.getConstRawData(), utf8.size()));
+   const String decoded = String::fromUtf8(utf8);
+   ASSERT_EQ(decoded.size(), 101);
+   ASSERT_EQ(decoded.at(99), Character(Character::ReplacementCharacter));
+   ASSERT_EQ(decoded.at(100), Character(Character::ReplacementCharacter));
+}
+
+TEST(TextCodecTest, testUtf8BomInLongText)
+{
+   ByteArray body;
+   String expected;
+   for (int i = 0; i < 100; ++i) {
+      const char32_t ucs4 = i % 10 ? 0x4e00 + i : 0xfeff;
+      append_utf8(body, ucs4);
+      expected.append(String::fromUcs4(&ucs4, 1));
+   }
+   // only the leading BOM is eaten, the ones inside are ZWNBSPs
+   const ByteArray utf8 = ByteArray("\xef\xbb\xbf") + body;
+   ASSERT_EQ(String::fromUtf8(utf8), expected);
+   ASSERT_EQ(decode_in_chunks(utf8, 2), expected);
+   ASSERT_EQ(decode_in_chunks(utf8, 64), expected);
+   ASSERT_EQ(String::fromUtf8(body), expected.substring(1));
+}
@@ -0,0 +1,166 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/base/lang/String.h"
+#include "pdk/base/time/DateTimeFormatter.h"
+
+#include <cstring>
+#include <string>
+
+using pdk::lang::Character;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+using pdk::lang::StringView;
+using pdk::time::Date;
+using pdk::time::DateTime;
+using pdk::time::DateTimeFormatter;
+using pdk::time::Time;
+
+namespace {
+
+// 2018-01-01T00:00:00Z
+constexpr pdk::pint64 sg_msecs2018 = PDK_INT64_C(1514764800000);
+
+std::string format_utf8(const DateTimeFormatter &formatter, const DateTime &dateTime)
+{
+   char buffer[128];
+   const int length = formatter.format(dateTime, buffer, sizeof(buffer));
+   return length < 0 ? std::string("<invalid>") : std::string(buffer, length);
+}
+
+} // anonymous namespace
+
+TEST(DateTimeTest, testFormatterStandardFormats)
+{
+   const DateTime utc(Date(2018, 3, 4), Time(5, 6, 7, 89), pdk::TimeSpec::UTC);
+   const DateTime india(Date(2018, 3, 4), Time(5, 6, 7, 89), pdk::TimeSpec::OffsetFromUTC, 19800);
+   const DateTime newYork(Date(2018, 3, 4), Time(5, 6, 7), pdk::TimeSpec::OffsetFromUTC, -18000);
+
+   const DateTimeFormatter iso(pdk::DateFormat::ISODate);
+   const DateTimeFormatter isoWithMs(pdk::DateFormat::ISODateWithMs);
+   const DateTimeFormatter rfc(pdk::DateFormat::RFC2822Date);
+   const DateTimeFormatter text(pdk::DateFormat::TextDate);
+   ASSERT_TRUE(iso.isValid());
+   ASSERT_EQ(format_utf8(iso, utc), "2018-03-04T05:06:07Z");
+   ASSERT_EQ(format_utf8(isoWithMs, utc), "2018-03-04T05:06:07.089Z");
+   ASSERT_EQ(format_utf8(isoWithMs, india), "2018-03-04T05:06:07.089+05:30");
+   ASSERT_EQ(format_utf8(rfc, newYork), "04 Mar 2018 05:06:07 -0500");
+   ASSERT_EQ(format_utf8(text, utc), "Sun Mar 4 05:06:07 2018 GMT");
+   ASSERT_EQ(format_utf8(text, newYork), "Sun Mar 4 05:06:07 2018 GMT-0500");
+   ASSERT_EQ(iso.toString(utc), utc.toString(pdk::DateFormat::ISODate));
+   ASSERT_EQ(rfc.toString(newYork), newYork.toString(pdk::DateFormat::RFC2822Date));
+
+   ASSERT_EQ(iso.toString(Date(2018, 3, 4)), Latin1String("2018-03-04"));
+   ASSERT_EQ(iso.toString(Time(5, 6, 7)), Latin1String("05:06:07"));
+   ASSERT_EQ(text.toString(Date(2018, 3, 4)), Latin1String("Sun Mar 4 2018"));
+   // ISO 8601 has no room for years past 9999
+   ASSERT_TRUE(iso.toString(Date(10000, 1, 1)).isEmpty());
+}
+
+TEST(DateTimeTest, testFormatterCustomFormat)
+{
+   const DateTime dateTime(Date(2018, 3, 4), Time(17, 6, 7, 200));
+   const DateTimeFormatter formatter(StringViewLiteral("yyyy-MM-dd 'at' h:mm:ss.z AP, dddd d MMMM yy"));
+   ASSERT_EQ(formatter.toString(dateTime), Latin1String("2018-03-04 at 5:06:07.2 PM, Sunday 4 March 18"));
+   ASSERT_EQ(formatter.toString(dateTime),
+             dateTime.toString(StringViewLiteral("yyyy-MM-dd 'at' h:mm:ss.z AP, dddd d MMMM yy")));
+
+   // tokens for a part the value lacks are written as they were given
+   const DateTimeFormatter dateAndTime(StringViewLiteral("dd/MM/yyyy hh:mm"));
+   ASSERT_EQ(dateAndTime.toString(Date(2018, 3, 4)), Latin1String("04/03/2018 hh:mm"));
+   ASSERT_EQ(dateAndTime.toString(Time(9, 30)), Latin1String("dd/MM/yyyy 09:30"));
+   ASSERT_EQ(dateAndTime.toString(Date(-44, 3, 15)), Latin1String("15/03/-0044 hh:mm"));
+}
+
+TEST(DateTimeTest, testFormatterBuffers)
+{
+   const DateTimeFormatter iso(pdk::DateFormat::ISODateWithMs);
+   const DateTime dateTime(Date(2018, 3, 4), Time(5, 6, 7, 89), pdk::TimeSpec::UTC);
+   Character characters[32];
+   const int length = iso.format(dateTime, characters, 32);
+   ASSERT_EQ(String(characters, length), Latin1String("2018-03-04T05:06:07.089Z"));
+   ASSERT_LE(length, iso.getMaxLength());
+
+   char exact[24];
+   ASSERT_EQ(iso.format(dateTime, exact, 24), 24);
+   ASSERT_EQ(std::memcmp(exact, "2018-03-04T05:06:07.089Z", 24), 0);
+   char small[23];
+   ASSERT_EQ(iso.format(dateTime, small, 23), -1);
+   ASSERT_EQ(iso.format(DateTime(), exact, 24), -1);
+   ASSERT_EQ(DateTimeFormatter().format(dateTime, exact, 24), -1);
+
+   char buffer[64];
+   int written = iso.format(sg_msecs2018 + 1, 0, buffer, sizeof(buffer));
+   ASSERT_EQ(std::string(buffer, written), "2018-01-01T00:00:00.001Z");
+   written = iso.format(sg_msecs2018, -3600, buffer, sizeof(buffer));
+   ASSERT_EQ(std::string(buffer, written), "2017-12-31T23:00:00.000-01:00");
+   const DateTimeFormatter text(pdk::DateFormat::TextDate);
+   written = text.format(-1, 0, buffer, sizeof(buffer));
+   ASSERT_EQ(std::string(buffer, written), "Wed Dec 31 23:59:59 1969 GMT");
+}
+
+TEST(DateTimeTest, testFormatterParse)
+{
+   const DateTimeFormatter formatter(StringViewLiteral("dd.MM.yyyy hh:mm:ss.zzz"));
+   const DateTime expected(Date(2018, 3, 4), Time(5, 6, 7, 89));
+   ASSERT_EQ(formatter.parse(StringViewLiteral("04.03.2018 05:06:07.089")), expected);
+   ASSERT_EQ(formatter.parse("04.03.2018 05:06:07.089", 23), expected);
+   ASSERT_EQ(formatter.parse(StringView(formatter.toString(expected))), expected);
+   ASSERT_FALSE(formatter.parse("04.03.2018 05:06:07", 19).isValid());
+   ASSERT_FALSE(formatter.parse("31.02.2018 05:06:07.089", 23).isValid());
+
+   const DateTimeFormatter twelveHour(StringViewLiteral("MMM d yyyy h:mm ap"));
+   ASSERT_EQ(twelveHour.parse("mar 4 2018 12:15 am", 19), DateTime(Date(2018, 3, 4), Time(0, 15)));
+   ASSERT_EQ(twelveHour.parse("Mar 4 2018 5:15 pm", 18), DateTime(Date(2018, 3, 4), Time(17, 15)));
+
+   const DateTimeFormatter rfc(pdk::DateFormat::RFC2822Date);
+   const DateTime parsed = rfc.parse("04 Mar 2018 05:06:07 -0500", 26);
+   ASSERT_TRUE(parsed.isValid());
+   ASSERT_EQ(parsed.getOffsetFromUtc(), -18000);
+   ASSERT_EQ(parsed.toMSecsSinceEpoch(), DateTime(Date(2018, 3, 4), Time(10, 6, 7), pdk::TimeSpec::UTC).toMSecsSinceEpoch());
+}
+
+TEST(DateTimeTest, testParseIsoDateTime)
+{
+   const DateTime utc = DateTimeFormatter::parseIsoDateTime(StringViewLiteral("2018-03-04T05:06:07Z"));
+   ASSERT_EQ(utc, DateTime(Date(2018, 3, 4), Time(5, 6, 7), pdk::TimeSpec::UTC));
+   ASSERT_EQ(utc.getTimeSpec(), pdk::TimeSpec::UTC);
+
+   const DateTime offset = DateTimeFormatter::parseIsoDateTime("2018-03-04 05:06:07,0895+05:30", 30);
+   ASSERT_EQ(offset.getOffsetFromUtc(), 19800);
+   ASSERT_EQ(offset.getTime(), Time(5, 6, 7, 90));
+   ASSERT_EQ(DateTimeFormatter::parseIsoDateTime("2018-03-04T05:06-0130", 21).getOffsetFromUtc(), -5400);
+   ASSERT_EQ(DateTimeFormatter::parseIsoDateTime("2018-03-04T05:06:07.9999", 24).getTime(), Time(5, 6, 7, 999));
+   // digits past the fourth are skipped, however many there are
+   const char *longFraction = "2018-03-04T05:06:07.123456789012345678901234567890Z";
+   const DateTime precise = DateTimeFormatter::parseIsoDateTime(longFraction,
+                                                                static_cast<int>(std::strlen(longFraction)));
+   ASSERT_EQ(precise, DateTime(Date(2018, 3, 4), Time(5, 6, 7, 123), pdk::TimeSpec::UTC));
+   ASSERT_EQ(DateTimeFormatter::parseIsoDateTime("2018-03-04T05:06", 16),
+             DateTime(Date(2018, 3, 4), Time(5, 6)));
+   ASSERT_EQ(DateTimeFormatter::parseIsoDateTime("2018-03-04", 10), DateTime(Date(2018, 3, 4)));
+   // 24:00 closes the day
+   ASSERT_EQ(DateTimeFormatter::parseIsoDateTime("2018-12-31T24:00:00Z", 20),
+             DateTime(Date(2019, 1, 1), Time(0, 0), pdk::TimeSpec::UTC));
+
+   const char *const invalid[] = {
+      "", "2018-3-04", "2018-03-04T", "2018-03-04T5:06", "2018-03-04T24:00:01",
+      "2018-02-30", "2018-03-04T05:06:07+2", "2018-03-04T05:06:07Zulu", "0000-01-01"
+   };
+   for (const char *text : invalid) {
+      ASSERT_FALSE(DateTimeFormatter::parseIsoDateTime(text, static_cast<int>(std::strlen(text))).isValid()) << text;
+   }
+}
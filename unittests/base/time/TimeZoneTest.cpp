@@ -0,0 +1,197 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/base/ds/ByteArray.h"
+#include "pdk/base/lang/String.h"
+#include "pdk/base/time/internal/TimeZonePrivate.h"
+#include "pdk/utils/Funcs.h"
+#include <algorithm>
+#include <list>
+
+#if defined(PDK_OS_UNIX) && !defined(PDK_OS_DARWIN)
+
+using pdk::ds::ByteArray;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+using pdk::time::internal::TimeZonePrivate;
+using pdk::time::internal::TzTimeZonePrivate;
+
+namespace {
+
+// 2018-01-01T00:00:00Z, 2050-01-01T00:00:00Z, 2150-01-01T00:00:00Z and
+// 2300-01-01T00:00:00Z
+constexpr pdk::pint64 sg_msecs2018 = PDK_INT64_C(1514764800000);
+constexpr pdk::pint64 sg_msecs2050 = PDK_INT64_C(2524608000000);
+constexpr pdk::pint64 sg_msecs2150 = PDK_INT64_C(5680281600000);
+constexpr pdk::pint64 sg_msecs2300 = PDK_INT64_C(10413792000000);
+
+} // anonymous namespace
+
+TEST(TimeZoneTest, testTzfileOffsets)
+{
+   TzTimeZonePrivate zone(ByteArrayLiteral("Europe/Berlin"));
+   if (!zone.isValid()) {
+      GTEST_SKIP() << "no zoneinfo database installed";
+   }
+   ASSERT_TRUE(zone.hasDaylightTime());
+   ASSERT_TRUE(zone.hasTransitions());
+   // 2018-01-15 and 2018-07-15
+   TimeZonePrivate::Data winter = zone.data(sg_msecs2018 + PDK_INT64_C(14) * 86400000);
+   ASSERT_EQ(winter.m_offsetFromUtc, 3600);
+   ASSERT_EQ(winter.m_daylightTimeOffset, 0);
+   ASSERT_EQ(winter.m_abbreviation, String(Latin1String("CET")));
+   TimeZonePrivate::Data summer = zone.data(sg_msecs2018 + PDK_INT64_C(195) * 86400000);
+   ASSERT_EQ(summer.m_offsetFromUtc, 7200);
+   ASSERT_EQ(summer.m_standardTimeOffset, 3600);
+   ASSERT_EQ(summer.m_daylightTimeOffset, 3600);
+   ASSERT_EQ(summer.m_abbreviation, String(Latin1String("CEST")));
+   
+   TimeZonePrivate::Data next = zone.nextTransition(sg_msecs2018);
+   // 2018-03-25T01:00:00Z
+   ASSERT_EQ(next.m_atMSecsSinceEpoch, PDK_INT64_C(1521939600000));
+   ASSERT_EQ(next.m_offsetFromUtc, 7200);
+   TimeZonePrivate::Data previous = zone.previousTransition(next.m_atMSecsSinceEpoch + 1);
+   ASSERT_EQ(previous.m_atMSecsSinceEpoch, next.m_atMSecsSinceEpoch);
+   previous = zone.previousTransition(next.m_atMSecsSinceEpoch);
+   ASSERT_LT(previous.m_atMSecsSinceEpoch, next.m_atMSecsSinceEpoch);
+   ASSERT_EQ(previous.m_offsetFromUtc, 3600);
+}
+
+TEST(TimeZoneTest, testTzfilePosixRuleExtrapolation)
+{
+   TzTimeZonePrivate zone(ByteArrayLiteral("Europe/Berlin"));
+   if (!zone.isValid()) {
+      GTEST_SKIP() << "no zoneinfo database installed";
+   }
+   // 2050-03-27T01:00:00Z, inside the transitions precomputed up to 2100
+   TimeZonePrivate::Data next = zone.nextTransition(sg_msecs2050);
+   ASSERT_EQ(next.m_atMSecsSinceEpoch, PDK_INT64_C(2531955600000));
+   ASSERT_EQ(next.m_offsetFromUtc, 7200);
+   ASSERT_EQ(zone.previousTransition(next.m_atMSecsSinceEpoch).m_offsetFromUtc, 3600);
+   // 2150-03-29T01:00:00Z, past the precomputed transitions
+   next = zone.nextTransition(sg_msecs2150);
+   ASSERT_EQ(next.m_atMSecsSinceEpoch, PDK_INT64_C(5687802000000));
+   ASSERT_EQ(next.m_daylightTimeOffset, 3600);
+   ASSERT_EQ(zone.data(next.m_atMSecsSinceEpoch - 1).m_offsetFromUtc, 3600);
+   ASSERT_EQ(zone.data(next.m_atMSecsSinceEpoch).m_offsetFromUtc, 7200);
+   // 2300-03-25T01:00:00Z, worked out from the rule on demand
+   next = zone.nextTransition(sg_msecs2300);
+   ASSERT_EQ(next.m_atMSecsSinceEpoch, PDK_INT64_C(10420966800000));
+   ASSERT_EQ(zone.data(next.m_atMSecsSinceEpoch - 1).m_abbreviation, String(Latin1String("CET")));
+   ASSERT_EQ(zone.data(next.m_atMSecsSinceEpoch).m_abbreviation, String(Latin1String("CEST")));
+   ASSERT_EQ(zone.previousTransition(next.m_atMSecsSinceEpoch + 1).m_atMSecsSinceEpoch,
+             next.m_atMSecsSinceEpoch);
+   // walking the transitions never goes backwards across the cache boundary
+   pdk::pint64 at = sg_msecs2018;
+   for (int i = 0; i < 400; ++i) {
+      TimeZonePrivate::Data tran = zone.nextTransition(at);
+      ASSERT_GT(tran.m_atMSecsSinceEpoch, at);
+      ASSERT_EQ(zone.previousTransition(tran.m_atMSecsSinceEpoch + 1).m_atMSecsSinceEpoch,
+                tran.m_atMSecsSinceEpoch);
+      at = tran.m_atMSecsSinceEpoch;
+   }
+}
+
+TEST(TimeZoneTest, testTzfilePosixRuleZone)
+{
+   TzTimeZonePrivate zone(ByteArrayLiteral("EST5EDT,M3.2.0,M11.1.0"));
+   ASSERT_TRUE(zone.isValid());
+   ASSERT_TRUE(zone.hasDaylightTime());
+   // 2018-03-11T07:00:00Z
+   TimeZonePrivate::Data next = zone.nextTransition(sg_msecs2018);
+   ASSERT_EQ(next.m_atMSecsSinceEpoch, PDK_INT64_C(1520751600000));
+   ASSERT_EQ(next.m_offsetFromUtc, -14400);
+   ASSERT_EQ(next.m_abbreviation, String(Latin1String("EDT")));
+   ASSERT_EQ(zone.data(sg_msecs2018).m_offsetFromUtc, -18000);
+   ASSERT_EQ(zone.data(sg_msecs2018).m_abbreviation, String(Latin1String("EST")));
+   
+   TzTimeZonePrivate fixed(ByteArrayLiteral("<+0530>-5:30"));
+   ASSERT_TRUE(fixed.isValid());
+   ASSERT_FALSE(fixed.hasDaylightTime());
+   ASSERT_EQ(fixed.data(sg_msecs2150).m_offsetFromUtc, 19800);
+   ASSERT_EQ(fixed.nextTransition(sg_msecs2018).m_atMSecsSinceEpoch, TimeZonePrivate::getInvalidMSecs());
+}
+
+TEST(TimeZoneTest, testTzfileInvalidIds)
+{
+   ASSERT_FALSE(TzTimeZonePrivate(ByteArrayLiteral("Nowhere/Special")).isValid());
+   ASSERT_FALSE(TzTimeZonePrivate(ByteArrayLiteral("../../etc/passwd")).isValid());
+   ASSERT_FALSE(TzTimeZonePrivate(ByteArrayLiteral("/etc/localtime")).isValid());
+   ASSERT_FALSE(TzTimeZonePrivate(ByteArray()).isValid());
+}
+
+TEST(TimeZoneTest, testTzfileSharedZones)
+{
+   TzTimeZonePrivate first(ByteArrayLiteral("Europe/Berlin"));
+   if (!first.isValid()) {
+      GTEST_SKIP() << "no zoneinfo database installed";
+   }
+   TzTimeZonePrivate second(ByteArrayLiteral("Europe/Berlin"));
+   std::unique_ptr<TzTimeZonePrivate> copy(first.clone());
+   for (pdk::pint64 msecs = sg_msecs2018; msecs < sg_msecs2150; msecs += PDK_INT64_C(86400000) * 97) {
+      ASSERT_EQ(first.data(msecs).m_offsetFromUtc, second.data(msecs).m_offsetFromUtc);
+      ASSERT_EQ(first.data(msecs).m_abbreviation, copy->data(msecs).m_abbreviation);
+   }
+   ASSERT_EQ(copy->getId(), first.getId());
+}
+
+TEST(TimeZoneTest, testTzfileSystemZoneFromPath)
+{
+   const ByteArray oldTz = pdk::get_env("TZ");
+   pdk::unset_env("TZ");
+   const ByteArray systemId = TzTimeZonePrivate().getId();
+   const ByteArray ianaId = systemId == "Asia/Kolkata" ? ByteArrayLiteral("Asia/Tokyo")
+                                                      : ByteArrayLiteral("Asia/Kolkata");
+   const int offset = ianaId == "Asia/Kolkata" ? 19800 : 32400;
+   if (!TzTimeZonePrivate(ianaId).isValid()) {
+      GTEST_SKIP() << "no zoneinfo database installed";
+   }
+   pdk::put_env("TZ", ":/usr/share/zoneinfo/" + ianaId);
+   TzTimeZonePrivate zone;
+   ByteArray id = zone.getSystemTimeZoneId();
+   const bool valid = zone.isValid();
+   const int offsetFromUtc = zone.data(sg_msecs2018).m_offsetFromUtc;
+   // a path that does not load leaves the zone /etc/localtime holds
+   pdk::put_env("TZ", ByteArrayLiteral(":/nonexistent/Nowhere"));
+   TzTimeZonePrivate fallback;
+   if (oldTz.isEmpty()) {
+      pdk::unset_env("TZ");
+   } else {
+      pdk::put_env("TZ", oldTz);
+   }
+   ASSERT_TRUE(valid);
+   ASSERT_EQ(id, ianaId);
+   ASSERT_EQ(zone.getId(), ianaId);
+   ASSERT_EQ(offsetFromUtc, offset);
+   ASSERT_EQ(fallback.isValid(), TzTimeZonePrivate().isValid());
+   ASSERT_EQ(fallback.getId(), systemId);
+}
+
+TEST(TimeZoneTest, testTzfileAvailableIds)
+{
+   TzTimeZonePrivate zone;
+   const std::list<ByteArray> all = zone.getAvailableTimeZoneIds();
+   if (all.empty()) {
+      GTEST_SKIP() << "no zone.tab installed";
+   }
+   ASSERT_EQ(zone.getAvailableTimeZoneIds(pdk::utils::Locale::Country::AnyCountry), all);
+   const std::list<ByteArray> german = zone.getAvailableTimeZoneIds(pdk::utils::Locale::Country::Germany);
+   ASSERT_FALSE(german.empty());
+   ASSERT_LT(german.size(), all.size());
+   ASSERT_NE(std::find(german.begin(), german.end(), ByteArrayLiteral("Europe/Berlin")), german.end());
+}
+
+#endif // PDK_OS_UNIX && !PDK_OS_DARWIN
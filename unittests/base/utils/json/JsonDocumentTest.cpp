@@ -0,0 +1,381 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/base/ds/ByteArray.h"
+#include "pdk/base/io/fs/File.h"
+#include "pdk/base/io/fs/TemporaryDir.h"
+#include "pdk/base/lang/String.h"
+#include "pdk/base/utils/json/JsonArena.h"
+#include "pdk/base/utils/json/JsonArray.h"
+#include "pdk/base/utils/json/JsonDocument.h"
+#include "pdk/base/utils/json/JsonObject.h"
+#include "pdk/base/utils/json/JsonValue.h"
+#include "pdk/global/Endian.h"
+
+using pdk::ds::ByteArray;
+using pdk::io::IoDevice;
+using pdk::io::fs::File;
+using pdk::io::fs::TemporaryDir;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+using pdk::utils::json::JsonArena;
+using pdk::utils::json::JsonArray;
+using pdk::utils::json::JsonDocument;
+using pdk::utils::json::JsonObject;
+using pdk::utils::json::JsonParseError;
+using pdk::utils::json::JsonValue;
+
+namespace {
+
+JsonDocument make_catalog(int count)
+{
+   JsonArray items;
+   for (int i = 0; i < count; ++i) {
+      JsonObject item;
+      item.insert(Latin1String("id"), i);
+      item.insert(Latin1String("name"), String(Latin1String("item-")) + String::number(i));
+      item.insert(Latin1String("price"), i * 0.5);
+      item.insert(Latin1String("available"), (i % 3) != 0);
+      items.append(item);
+   }
+   JsonObject root;
+   root.insert(Latin1String("version"), 3);
+   root.insert(Latin1String("items"), items);
+   return JsonDocument(root);
+}
+
+void check_catalog(const JsonDocument &doc, int count)
+{
+   ASSERT_TRUE(doc.isObject());
+   const JsonObject root = doc.getObject();
+   ASSERT_EQ(root[Latin1String("version")].toInt(), 3);
+   JsonArray items = root[Latin1String("items")].toArray();
+   ASSERT_EQ(items.getSize(), count);
+   for (int i = 0; i < count; ++i) {
+      const JsonObject item = items.at(i).toObject();
+      ASSERT_EQ(item[Latin1String("id")].toInt(), i);
+      ASSERT_EQ(item[Latin1String("name")].toString(), String(Latin1String("item-")) + String::number(i));
+      ASSERT_EQ(item[Latin1String("price")].toDouble(), i * 0.5);
+      ASSERT_EQ(item[Latin1String("available")].toBool(), (i % 3) != 0);
+   }
+}
+
+} // anonymous namespace
+
+TEST(JsonDocumentTest, testBinaryRoundTrip)
+{
+   JsonDocument doc = make_catalog(100);
+   ByteArray binary = doc.toBinaryData();
+   ASSERT_FALSE(binary.isEmpty());
+   JsonDocument loaded = JsonDocument::fromBinaryData(binary);
+   check_catalog(loaded, 100);
+   ASSERT_EQ(loaded, doc);
+   ASSERT_EQ(loaded.toJson(), doc.toJson());
+}
+
+TEST(JsonDocumentTest, testFromBinaryDataSharesBuffer)
+{
+   ByteArray binary = make_catalog(10).toBinaryData();
+   JsonDocument loaded = JsonDocument::fromBinaryData(binary);
+   ByteArray again = loaded.toBinaryData();
+   ASSERT_EQ(again, binary);
+   ASSERT_EQ(again.getConstRawData(), binary.getConstRawData());
+   
+   // modifying the document detaches from the shared buffer
+   JsonObject root = loaded.getObject();
+   root.insert(Latin1String("version"), 4);
+   loaded.setObject(root);
+   ASSERT_EQ(loaded.getObject()[Latin1String("version")].toInt(), 4);
+   ASSERT_EQ(JsonDocument::fromBinaryData(binary).getObject()[Latin1String("version")].toInt(), 3);
+   ASSERT_NE(loaded.toBinaryData().getConstRawData(), binary.getConstRawData());
+}
+
+TEST(JsonDocumentTest, testFromRawDataOnMappedFile)
+{
+   TemporaryDir dir;
+   ASSERT_TRUE(dir.isValid());
+   const String fileName = dir.getFilePath(Latin1String("catalog.bjson"));
+   {
+      File file(fileName);
+      ASSERT_TRUE(file.open(IoDevice::OpenMode::WriteOnly));
+      ByteArray binary = make_catalog(1000).toBinaryData();
+      ASSERT_EQ(file.write(binary), binary.size());
+   }
+   File file(fileName);
+   ASSERT_TRUE(file.open(IoDevice::OpenMode::ReadOnly));
+   uchar *memory = file.map(0, file.getSize());
+   ASSERT_TRUE(memory);
+   {
+      JsonDocument doc = JsonDocument::fromRawData(reinterpret_cast<const char *>(memory), 
+                                                   static_cast<int>(file.getSize()));
+      check_catalog(doc, 1000);
+      
+      // the mapping is read only, writes must go to a private copy
+      JsonObject root = doc.getObject();
+      root.remove(Latin1String("version"));
+      JsonArray items = root[Latin1String("items")].toArray();
+      items.removeFirst();
+      ASSERT_FALSE(root.contains(Latin1String("version")));
+      ASSERT_EQ(items.getSize(), 999);
+      check_catalog(doc, 1000);
+   }
+   ASSERT_TRUE(file.unmap(memory));
+}
+
+TEST(JsonDocumentTest, testInvalidBinaryData)
+{
+   ASSERT_TRUE(JsonDocument::fromBinaryData(ByteArray()).isNull());
+   ASSERT_TRUE(JsonDocument::fromBinaryData(ByteArray("garbage that is not json")).isNull());
+   ByteArray binary = make_catalog(5).toBinaryData();
+   ASSERT_TRUE(JsonDocument::fromBinaryData(binary.left(binary.size() / 2)).isNull());
+   
+   // swap the first two keys of the root object, breaking the sort order
+   ByteArray corrupted = binary;
+   const int first = corrupted.indexOf("items");
+   const int second = corrupted.indexOf("version");
+   ASSERT_TRUE(first > 0 && second > 0);
+   corrupted.replace(first, 5, "zzzzz");
+   ASSERT_TRUE(JsonDocument::fromBinaryData(corrupted).isNull());
+   ASSERT_FALSE(JsonDocument::fromBinaryData(corrupted, JsonDocument::DataValidation::BypassValidation).isNull());
+}
+
+TEST(JsonDocumentTest, testNestedContainersValidatedLazily)
+{
+   const ByteArray binary = make_catalog(5).toBinaryData();
+   // break the key order of one item, the root stays intact
+   ByteArray corrupted = binary;
+   const int keyPos = corrupted.indexOf("available");
+   ASSERT_TRUE(keyPos > 0);
+   corrupted.replace(keyPos, 9, "zzzzzzzzz");
+   JsonDocument doc = JsonDocument::fromBinaryData(corrupted);
+   ASSERT_TRUE(doc.isObject());
+   const JsonObject root = doc.getObject();
+   ASSERT_EQ(root[Latin1String("version")].toInt(), 3);
+   const JsonArray items = root[Latin1String("items")].toArray();
+   ASSERT_EQ(items.getSize(), 5);
+   int undefinedCount = 0;
+   for (int i = 0; i < items.getSize(); ++i) {
+      if (items.at(i).isUndefined()) {
+         ++undefinedCount;
+      } else {
+         ASSERT_EQ(items.at(i).toObject()[Latin1String("id")].toInt(), i);
+      }
+   }
+   ASSERT_EQ(undefinedCount, 1);
+   ASSERT_TRUE(doc.toJson(JsonDocument::JsonFormat::Compact).contains("null"));
+   // a modified copy keeps checking the containers it copied
+   JsonObject modified = root;
+   modified.insert(Latin1String("version"), 4);
+   const JsonArray modifiedItems = modified[Latin1String("items")].toArray();
+   int modifiedUndefinedCount = 0;
+   for (int i = 0; i < modifiedItems.getSize(); ++i) {
+      modifiedUndefinedCount += modifiedItems.at(i).isUndefined() ? 1 : 0;
+   }
+   ASSERT_EQ(modifiedUndefinedCount, 1);
+   // trusted data is not checked at all
+   JsonDocument bypassed = JsonDocument::fromBinaryData(corrupted, JsonDocument::DataValidation::BypassValidation);
+   ASSERT_TRUE(bypassed.getObject()[Latin1String("items")].toArray().at(0).isObject());
+}
+
+TEST(JsonDocumentTest, testBinarySizeLimit)
+{
+   // an empty root object padded to the given document size
+   const ByteArray empty = JsonDocument(JsonObject()).toBinaryData();
+   auto padded_document = [&empty](int size, uint version) {
+      ByteArray binary(size, '\0');
+      memcpy(binary.getRawData(), empty.getConstRawData(), empty.size());
+      pdk::to_little_endian<uint>(version, binary.getRawData() + 4);
+      pdk::to_little_endian<uint>(size - 8, binary.getRawData() + 8);
+      return binary;
+   };
+   // offsets in the version 1 format have 27 bits
+   const int limit = (1 << 27) - 4;
+   {
+      const ByteArray binary = padded_document(limit, 1);
+      JsonDocument doc = JsonDocument::fromBinaryData(binary);
+      ASSERT_TRUE(doc.isObject());
+      ASSERT_TRUE(doc.getObject().isEmpty());
+      ASSERT_TRUE(JsonDocument::fromRawData(binary.getConstRawData(), binary.size()).isObject());
+   }
+   {
+      const ByteArray binary = padded_document(limit + 4, 1);
+      ASSERT_TRUE(JsonDocument::fromBinaryData(binary).isNull());
+      ASSERT_TRUE(JsonDocument::fromBinaryData(binary, JsonDocument::DataValidation::BypassValidation).isNull());
+      ASSERT_TRUE(JsonDocument::fromRawData(binary.getConstRawData(), binary.size()).isNull());
+   }
+   // version 2 counts them in 4 byte units
+   const ByteArray binary = padded_document(limit + 4, 2);
+   ASSERT_TRUE(JsonDocument::fromBinaryData(binary).isObject());
+   ASSERT_TRUE(JsonDocument::fromRawData(binary.getConstRawData(), binary.size()).isObject());
+   ASSERT_TRUE(JsonDocument::fromBinaryData(padded_document(limit, 3)).isNull());
+}
+
+TEST(JsonDocumentTest, testWideOffsets)
+{
+   // long enough text to be parsed as version 2, the catalog lies behind
+   // the padding so its offsets only fit once they are scaled
+   ByteArray json("{\"padding\": \"");
+   json.append(ByteArray(16 << 20, 'p'));
+   json.append("\", \"catalog\": ");
+   json.append(make_catalog(50).toJson(JsonDocument::JsonFormat::Compact));
+   json.append("}");
+   JsonParseError error;
+   JsonDocument doc = JsonDocument::fromJson(json, &error);
+   ASSERT_EQ(error.m_error, JsonParseError::ParseError::NoError);
+   check_catalog(JsonDocument(doc.getObject()[Latin1String("catalog")].toObject()), 50);
+   ASSERT_EQ(doc.getObject()[Latin1String("padding")].toString().size(), 16 << 20);
+   const ByteArray binary = doc.toBinaryData();
+   ASSERT_EQ(pdk::from_little_endian<uint>(binary.getConstRawData() + 4), 2u);
+   JsonDocument loaded = JsonDocument::fromBinaryData(binary);
+   ASSERT_EQ(loaded, doc);
+   // a modified copy keeps the wide layout of the containers it copied
+   JsonObject root = loaded.getObject();
+   root.insert(Latin1String("extra"), Latin1String("value"));
+   root.remove(Latin1String("padding"));
+   ASSERT_EQ(root[Latin1String("extra")].toString(), Latin1String("value"));
+   check_catalog(JsonDocument(root[Latin1String("catalog")].toObject()), 50);
+   // and a container moved into a new document makes it version 2
+   JsonObject copy;
+   copy.insert(Latin1String("catalog"), root[Latin1String("catalog")]);
+   const ByteArray copied = JsonDocument(copy).toBinaryData();
+   ASSERT_EQ(pdk::from_little_endian<uint>(copied.getConstRawData() + 4), 2u);
+   check_catalog(JsonDocument(JsonDocument::fromBinaryData(copied).getObject()[Latin1String("catalog")].toObject()), 50);
+}
+
+TEST(JsonDocumentTest, testFromJsonArena)
+{
+   const ByteArray json = make_catalog(50).toJson();
+   JsonArena arena(1024);
+   ASSERT_EQ(arena.getBytesUsed(), 0u);
+   {
+      JsonParseError error;
+      JsonDocument doc = JsonDocument::fromJson(json, &arena, &error);
+      ASSERT_EQ(error.m_error, JsonParseError::ParseError::NoError);
+      check_catalog(doc, 50);
+      ASSERT_EQ(doc, JsonDocument::fromJson(json));
+   }
+   const size_t used = arena.getBytesUsed();
+   const size_t reserved = arena.getBytesReserved();
+   ASSERT_GT(used, 0u);
+   ASSERT_GE(reserved, used);
+   
+   // the same document again fits in the blocks that are already there
+   arena.reset();
+   ASSERT_EQ(arena.getBytesUsed(), 0u);
+   JsonDocument doc = JsonDocument::fromJson(json, &arena);
+   check_catalog(doc, 50);
+   ASSERT_EQ(arena.getBytesUsed(), used);
+   ASSERT_EQ(arena.getBytesReserved(), reserved);
+   
+   // a modified document no longer reads from the arena
+   JsonObject root = doc.getObject();
+   root.insert(Latin1String("version"), 4);
+   doc.setObject(root);
+   arena.reset();
+   JsonDocument other = JsonDocument::fromJson(ByteArray("[\"overwrites the arena\", 1, 2, 3]"), &arena);
+   ASSERT_TRUE(other.isArray());
+   ASSERT_EQ(other.getArray().getSize(), 4);
+   ASSERT_EQ(doc.getObject()[Latin1String("version")].toInt(), 4);
+   ASSERT_EQ(doc.getObject()[Latin1String("items")].toArray().getSize(), 50);
+   
+   JsonParseError error;
+   ASSERT_TRUE(JsonDocument::fromJson(ByteArray("{\"a\": [1, 2, {\"b\": }]}"), &arena, &error).isNull());
+   ASSERT_NE(error.m_error, JsonParseError::ParseError::NoError);
+   JsonDocument nested = JsonDocument::fromJson(ByteArray("{\"a\": [1, {\"b\": [true, null]}], \"c\": {}}"), &arena);
+   ASSERT_EQ(nested.getObject()[Latin1String("a")].toArray().at(1).toObject()[Latin1String("b")].toArray().getSize(), 2);
+   ASSERT_TRUE(nested.getObject()[Latin1String("c")].toObject().isEmpty());
+}
+
+TEST(JsonDocumentTest, testLargeDocument)
+{
+   // large enough for the structural index, with runs that cross its blocks
+   JsonDocument doc = make_catalog(500);
+   JsonObject root = doc.getObject();
+   root.insert(Latin1String("text"), String(Latin1String("tab\tquote\"backslash\\")) + String(300, 'x') + String::fromUtf8("\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80") + String(200, 'y'));
+   root.insert(Latin1String("latin1"), String(100, 'z') + String::fromUtf8("\xc3\xa9") + String(100, 'z'));
+   root.insert(Latin1String("long"), String(0x9000, 'l'));
+   doc.setObject(root);
+   for (JsonDocument::JsonFormat format : {JsonDocument::JsonFormat::Compact, JsonDocument::JsonFormat::Indented}) {
+      const ByteArray json = doc.toJson(format);
+      JsonParseError error;
+      JsonDocument parsed = JsonDocument::fromJson(json, &error);
+      ASSERT_EQ(error.m_error, JsonParseError::ParseError::NoError);
+      check_catalog(parsed, 500);
+      ASSERT_EQ(parsed, doc);
+   }
+}
+
+TEST(JsonDocumentTest, testLargeDocumentEscapedQuotes)
+{
+   // runs of backslashes and structural characters inside strings, moved
+   // across the block boundaries of the index one byte at a time
+   const ByteArray text("{[a\\\\\\\"b\\\\\\\\\\\"],:}\\\\");
+   const String expected = String::fromLatin1("{[a\\\"b\\\\\"],:}\\");
+   ByteArray padding;
+   while (padding.size() < 1024) {
+      padding.append("1,");
+   }
+   for (int shift = 0; shift < 64; ++shift) {
+      ByteArray json("[");
+      json.append(padding);
+      json.append(ByteArray(shift, ' '));
+      json.append("\"");
+      json.append(text);
+      json.append("\", {\"k\\\"\": [\"\\\\\", \"]\"]}]");
+      JsonParseError error;
+      JsonDocument doc = JsonDocument::fromJson(json, &error);
+      ASSERT_EQ(error.m_error, JsonParseError::ParseError::NoError) << shift;
+      const JsonArray array = doc.getArray();
+      ASSERT_EQ(array.getSize(), padding.size() / 2 + 2);
+      ASSERT_EQ(array.at(array.getSize() - 2).toString(), expected) << shift;
+      const JsonArray last = array.at(array.getSize() - 1).toObject()[Latin1String("k\"")].toArray();
+      ASSERT_EQ(last.getSize(), 2);
+      ASSERT_EQ(last.at(0).toString(), Latin1String("\\"));
+      ASSERT_EQ(last.at(1).toString(), Latin1String("]"));
+   }
+}
+
+TEST(JsonDocumentTest, testLargeDocumentErrorOffsets)
+{
+   // each tail fails the same way whether or not the document is large
+   // enough to be indexed, only shifted by the padding in front of it
+   const char *tails[] = {
+      "\"unterminated",
+      "tru]",
+      "{\"a\" 1}",
+      "{\"a\": 1,}",
+      "\"\\u12\"]",
+      "[1 2]",
+      "\"bad utf8 \xff\"]",
+      "\"\xc3\xa9 and then",
+      "1] garbage",
+      "{\"a\": [1, 2, {\"b\": }]}",
+      "   \n\t  "
+   };
+   ByteArray padding;
+   while (padding.size() < 2048) {
+      padding.append("1,  \n ");
+   }
+   for (const char *tail : tails) {
+      JsonParseError smallError;
+      JsonParseError largeError;
+      ASSERT_TRUE(JsonDocument::fromJson(ByteArray("[") + tail, &smallError).isNull());
+      ASSERT_TRUE(JsonDocument::fromJson(ByteArray("[") + padding + tail, &largeError).isNull());
+      ASSERT_NE(smallError.m_error, JsonParseError::ParseError::NoError) << tail;
+      ASSERT_EQ(largeError.m_error, smallError.m_error) << tail;
+      ASSERT_EQ(largeError.m_offset, smallError.m_offset + padding.size()) << tail;
+   }
+}
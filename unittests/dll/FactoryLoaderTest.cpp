@@ -0,0 +1,221 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/dll/internal/FactoryLoaderPrivate.h"
+#include "pdk/dll/Plugin.h"
+#include "pdk/kernel/CoreApplication.h"
+#include "pdk/base/io/fs/File.h"
+#include "pdk/base/io/fs/FileInfo.h"
+#include "pdk/base/io/fs/TemporaryDir.h"
+#include "pdk/base/os/thread/ThreadPool.h"
+#include "pdk/base/utils/json/JsonArray.h"
+#include "pdk/base/utils/json/JsonValue.h"
+
+#include <list>
+
+using pdk::ds::ByteArray;
+using pdk::ds::StringList;
+using pdk::io::IoDevice;
+using pdk::io::fs::File;
+using pdk::io::fs::FileInfo;
+using pdk::io::fs::TemporaryDir;
+using pdk::kernel::CoreApplication;
+using pdk::kernel::Object;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+using pdk::dll::StaticPlugin;
+using pdk::dll::internal::FactoryLoader;
+using pdk::dll::internal::PluginLoadTiming;
+using pdk::os::thread::ThreadPool;
+using pdk::utils::json::JsonArray;
+using pdk::utils::json::JsonDocument;
+using pdk::utils::json::JsonObject;
+using pdk::utils::json::JsonValue;
+
+namespace {
+
+const char sg_keyIndexIid[] = "org.libpdk.test.KeyIndex";
+
+// raw metadata as PDK_EXPORT_PLUGIN embeds it, kept alive for the
+// functions StaticPlugin points to
+std::list<ByteArray> sg_rawMetaData;
+
+const char *raw_meta_data(const char *iid, std::initializer_list<JsonValue> keys)
+{
+   JsonObject metaData;
+   metaData.insert(Latin1String("Keys"), JsonArray(keys));
+   JsonObject object;
+   object.insert(Latin1String("IID"), Latin1String(iid));
+   object.insert(Latin1String("version"), PDK_VERSION);
+   object.insert(Latin1String("MetaData"), metaData);
+   sg_rawMetaData.push_back(ByteArray("PDKMETADATA  ") + JsonDocument(object).toBinaryData());
+   return sg_rawMetaData.back().getConstRawData();
+}
+
+Object *plugin_instance()
+{
+   static Object instance;
+   return &instance;
+}
+
+const char *alpha_meta_data()
+{
+   static const char *raw = raw_meta_data(sg_keyIndexIid, {Latin1String("Alpha"),
+                                                           Latin1String("beta")});
+   return raw;
+}
+
+const char *gamma_meta_data()
+{
+   static const char *raw = raw_meta_data(sg_keyIndexIid, {Latin1String("gamma"),
+                                                           Latin1String("alpha")});
+   return raw;
+}
+
+const char *other_meta_data()
+{
+   static const char *raw = raw_meta_data("org.libpdk.test.Other", {Latin1String("delta")});
+   return raw;
+}
+
+// a directory of files that look like plugins by name only
+class PluginDir
+{
+public:
+   explicit PluginDir(int count)
+   {
+      for (int i = 0; i < count; ++i) {
+         const String fileName = m_dir.getFilePath(String(Latin1String("libplugin%1.so")).arg(i));
+         File file(fileName);
+         if (file.open(IoDevice::OpenMode::WriteOnly)) {
+            file.write(ByteArray("not really a plugin"));
+         }
+         m_fileNames.push_back(FileInfo(fileName).getCanonicalFilePath());
+      }
+      // the order Dir lists them in
+      m_fileNames.sort();
+   }
+
+   String getPath() const
+   {
+      return m_dir.getPath();
+   }
+
+   const StringList &getFileNames() const
+   {
+      return m_fileNames;
+   }
+
+private:
+   TemporaryDir m_dir;
+   StringList m_fileNames;
+};
+
+StringList timing_file_names(const std::vector<PluginLoadTiming> &timings)
+{
+   StringList fileNames;
+   for (const PluginLoadTiming &timing : timings) {
+      fileNames.push_back(timing.m_fileName);
+   }
+   return fileNames;
+}
+
+} // anonymous namespace
+
+TEST(FactoryLoaderTest, testKeyIndex)
+{
+   CoreApplication::setLibraryPaths(StringList());
+   FactoryLoader loader(sg_keyIndexIid, String(), pdk::CaseSensitivity::Insensitive);
+   ASSERT_EQ(loader.indexOf(Latin1String("alpha")), -1);
+   ASSERT_TRUE(loader.getKeyMap().empty());
+
+   pdk::dll::register_static_plugin_func(StaticPlugin{plugin_instance, alpha_meta_data});
+   pdk::dll::register_static_plugin_func(StaticPlugin{plugin_instance, other_meta_data});
+   // lookups ignore case, keys of other interfaces are not served
+   ASSERT_EQ(loader.indexOf(Latin1String("alpha")), 0);
+   ASSERT_EQ(loader.indexOf(Latin1String("ALPHA")), 0);
+   ASSERT_EQ(loader.indexOf(Latin1String("Beta")), 0);
+   ASSERT_EQ(loader.indexOf(Latin1String("delta")), -1);
+   ASSERT_EQ(loader.getMetaData().size(), 1u);
+
+   // a plugin registered later is picked up, the first one keeps its keys
+   pdk::dll::register_static_plugin_func(StaticPlugin{plugin_instance, gamma_meta_data});
+   ASSERT_EQ(loader.indexOf(Latin1String("gamma")), 1);
+   ASSERT_EQ(loader.indexOf(Latin1String("alpha")), 0);
+   ASSERT_EQ(loader.getInstance(loader.indexOf(Latin1String("gamma"))), plugin_instance());
+
+   const std::multimap<int, String> keyMap = loader.getKeyMap();
+   ASSERT_EQ(keyMap.size(), 4u);
+   ASSERT_EQ(keyMap.count(0), 2u);
+   ASSERT_EQ(keyMap.count(1), 2u);
+   ASSERT_EQ(keyMap.find(0)->second, Latin1String("Alpha"));
+   ASSERT_EQ(keyMap.find(1)->second, Latin1String("gamma"));
+}
+
+#if PDK_CONFIG(library) && defined(PDK_SHARED)
+
+TEST(FactoryLoaderTest, testScanTimings)
+{
+   PluginDir pluginDir(4);
+   pdk::put_env("PDK_NO_PLUGIN_INDEX", "1");
+   CoreApplication::setLibraryPaths(StringList());
+   FactoryLoader loader("org.libpdk.test.Scan");
+   ASSERT_TRUE(loader.getLoadTimings().empty());
+
+   CoreApplication::setLibraryPaths(StringList{pluginDir.getPath()});
+   loader.update();
+   const std::vector<PluginLoadTiming> timings = loader.getLoadTimings();
+   ASSERT_EQ(timing_file_names(timings), pluginDir.getFileNames());
+   for (const PluginLoadTiming &timing : timings) {
+      ASSERT_GE(timing.m_scanNsecs, 0);
+      ASSERT_EQ(timing.m_loadNsecs, 0);
+      ASSERT_FALSE(timing.m_loaded);
+   }
+   // a directory is only scanned once
+   loader.update();
+   ASSERT_EQ(loader.getLoadTimings().size(), timings.size());
+   ASSERT_TRUE(loader.getKeyMap().empty());
+   pdk::unset_env("PDK_NO_PLUGIN_INDEX");
+}
+
+TEST(FactoryLoaderTest, testScanConcurrently)
+{
+   PluginDir pluginDir(16);
+   pdk::put_env("PDK_NO_PLUGIN_INDEX", "1");
+   CoreApplication::setLibraryPaths(StringList());
+   FactoryLoader serial("org.libpdk.test.Scan");
+   FactoryLoader concurrent("org.libpdk.test.Scan");
+
+   CoreApplication::setLibraryPaths(StringList{pluginDir.getPath()});
+   serial.update();
+   ThreadPool pool;
+   pool.setMaxThreadCount(4);
+   concurrent.updateConcurrently(&pool, false);
+   // results are merged in directory order whatever order the tasks finish in
+   const std::vector<PluginLoadTiming> timings = concurrent.getLoadTimings();
+   ASSERT_EQ(timing_file_names(timings), timing_file_names(serial.getLoadTimings()));
+   ASSERT_EQ(timing_file_names(timings), pluginDir.getFileNames());
+   for (const PluginLoadTiming &timing : timings) {
+      ASSERT_GE(timing.m_scanNsecs, 0);
+      ASSERT_FALSE(timing.m_loaded);
+   }
+   ASSERT_TRUE(pool.waitForDone());
+   ASSERT_TRUE(concurrent.getKeyMap().empty());
+   ASSERT_TRUE(concurrent.getMetaData().empty());
+   pdk::unset_env("PDK_NO_PLUGIN_INDEX");
+}
+
+#endif // PDK_CONFIG(library) && defined(PDK_SHARED)
@@ -0,0 +1,210 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/dll/internal/PluginIndexPrivate.h"
+#include "pdk/base/io/fs/File.h"
+#include "pdk/base/io/fs/FileInfo.h"
+#include "pdk/base/io/fs/TemporaryDir.h"
+#include "pdk/base/utils/json/JsonArray.h"
+#include "pdk/base/utils/json/JsonValue.h"
+#include "pdk/utils/Funcs.h"
+
+using pdk::ds::ByteArray;
+using pdk::io::IoDevice;
+using pdk::io::fs::File;
+using pdk::io::fs::FileInfo;
+using pdk::io::fs::TemporaryDir;
+using pdk::lang::Latin1String;
+using pdk::lang::String;
+using pdk::dll::internal::PluginFileStamp;
+using pdk::dll::internal::PluginIndex;
+using pdk::utils::json::JsonArray;
+using pdk::utils::json::JsonObject;
+
+namespace {
+
+// points PDK_PLUGIN_INDEX_PATH at a directory of its own while alive
+class IndexLocation
+{
+public:
+   IndexLocation()
+      : m_oldPath(pdk::get_env("PDK_PLUGIN_INDEX_PATH"))
+   {
+      pdk::unset_env("PDK_NO_PLUGIN_INDEX");
+      pdk::put_env("PDK_PLUGIN_INDEX_PATH", File::encodeName(m_cacheDir.getPath()));
+   }
+
+   ~IndexLocation()
+   {
+      if (m_oldPath.isEmpty()) {
+         pdk::unset_env("PDK_PLUGIN_INDEX_PATH");
+      } else {
+         pdk::put_env("PDK_PLUGIN_INDEX_PATH", m_oldPath);
+      }
+   }
+
+   String getPath() const
+   {
+      return m_cacheDir.getPath();
+   }
+
+private:
+   TemporaryDir m_cacheDir;
+   ByteArray m_oldPath;
+};
+
+void write_file(const String &fileName, const ByteArray &data)
+{
+   File file(fileName);
+   ASSERT_TRUE(file.open(IoDevice::OpenMode::WriteOnly));
+   ASSERT_EQ(file.write(data), data.size());
+}
+
+JsonObject plugin_meta_data(const String &key)
+{
+   JsonObject keys;
+   keys.insert(Latin1String("Keys"), JsonArray{key});
+   JsonObject object;
+   object.insert(Latin1String("IID"), Latin1String("org.libpdk.test.PluginIndex"));
+   object.insert(Latin1String("MetaData"), keys);
+   return object;
+}
+
+} // anonymous namespace
+
+TEST(PluginIndexTest, testFileStamp)
+{
+   TemporaryDir dir;
+   ASSERT_TRUE(dir.isValid());
+   const String fileName = dir.getFilePath(Latin1String("libplugin.so"));
+   ASSERT_FALSE(PluginFileStamp::fromFile(fileName).isValid());
+   write_file(fileName, ByteArray("0123456789"));
+   const PluginFileStamp stamp = PluginFileStamp::fromFile(fileName);
+   ASSERT_TRUE(stamp.isValid());
+   ASSERT_EQ(stamp.m_size, 10);
+   ASSERT_EQ(stamp, PluginFileStamp::fromFile(fileName));
+   write_file(fileName, ByteArray("0123456789abc"));
+   ASSERT_NE(stamp, PluginFileStamp::fromFile(fileName));
+}
+
+TEST(PluginIndexTest, testIndexFileName)
+{
+   IndexLocation location;
+   const String first = PluginIndex::getIndexFileName(Latin1String("/usr/lib/plugins/a"));
+   const String second = PluginIndex::getIndexFileName(Latin1String("/usr/lib/plugins/b"));
+   ASSERT_TRUE(first.startsWith(location.getPath()));
+   ASSERT_TRUE(first.endsWith(Latin1String(".index")));
+   ASSERT_NE(first, second);
+   ASSERT_EQ(first, PluginIndex::getIndexFileName(Latin1String("/usr/lib/plugins/a")));
+   pdk::put_env("PDK_NO_PLUGIN_INDEX", "1");
+   ASSERT_TRUE(PluginIndex::getIndexFileName(Latin1String("/usr/lib/plugins/a")).isEmpty());
+   PluginIndex disabled(Latin1String("/usr/lib/plugins/a"));
+   ASSERT_FALSE(disabled.isEnabled());
+   ASSERT_FALSE(disabled.save());
+   pdk::unset_env("PDK_NO_PLUGIN_INDEX");
+}
+
+TEST(PluginIndexTest, testRoundTrip)
+{
+   IndexLocation location;
+   TemporaryDir pluginDir;
+   ASSERT_TRUE(pluginDir.isValid());
+   const String pluginFile = pluginDir.getFilePath(Latin1String("libplugin.so"));
+   const String otherFile = pluginDir.getFilePath(Latin1String("README"));
+   write_file(pluginFile, ByteArray("not really a plugin"));
+   write_file(otherFile, ByteArray("text"));
+   const PluginFileStamp pluginStamp = PluginFileStamp::fromFile(pluginFile);
+   const PluginFileStamp otherStamp = PluginFileStamp::fromFile(otherFile);
+   const String error(Latin1String("Failed to extract plugin meta data from 'README'"));
+   {
+      PluginIndex index(pluginDir.getPath());
+      ASSERT_TRUE(index.isEnabled());
+      JsonObject metaData;
+      String errorString;
+      ASSERT_FALSE(index.lookup(pluginFile, pluginStamp, &metaData, &errorString));
+      index.insert(pluginFile, pluginStamp, plugin_meta_data(Latin1String("alpha")));
+      index.insert(otherFile, otherStamp, JsonObject(), error);
+      ASSERT_TRUE(index.save());
+      ASSERT_TRUE(FileInfo(index.getIndexFileName()).exists());
+   }
+
+   PluginIndex index(pluginDir.getPath());
+   JsonObject metaData;
+   String errorString;
+   ASSERT_TRUE(index.lookup(pluginFile, pluginStamp, &metaData, &errorString));
+   ASSERT_EQ(metaData, plugin_meta_data(Latin1String("alpha")));
+   ASSERT_TRUE(errorString.isEmpty());
+   // files that are not plugins keep the reason
+   ASSERT_TRUE(index.lookup(otherFile, otherStamp, &metaData, &errorString));
+   ASSERT_TRUE(metaData.isEmpty());
+   ASSERT_EQ(errorString, error);
+   // a changed file is scanned again
+   PluginFileStamp changed = pluginStamp;
+   ++changed.m_modified;
+   ASSERT_FALSE(index.lookup(pluginFile, changed, &metaData, &errorString));
+   ASSERT_FALSE(index.lookup(pluginFile, PluginFileStamp(), &metaData, &errorString));
+}
+
+TEST(PluginIndexTest, testDropsRemovedFiles)
+{
+   IndexLocation location;
+   TemporaryDir pluginDir;
+   ASSERT_TRUE(pluginDir.isValid());
+   const String keptFile = pluginDir.getFilePath(Latin1String("libkept.so"));
+   const String removedFile = pluginDir.getFilePath(Latin1String("libremoved.so"));
+   PluginFileStamp stamp;
+   stamp.m_size = 1;
+   {
+      PluginIndex index(pluginDir.getPath());
+      index.insert(keptFile, stamp, plugin_meta_data(Latin1String("kept")));
+      index.insert(removedFile, stamp, plugin_meta_data(Latin1String("removed")));
+      ASSERT_TRUE(index.save());
+   }
+   {
+      // only the kept file is looked up on this scan
+      PluginIndex index(pluginDir.getPath());
+      JsonObject metaData;
+      String errorString;
+      ASSERT_TRUE(index.lookup(keptFile, stamp, &metaData, &errorString));
+      ASSERT_TRUE(index.save());
+   }
+   PluginIndex index(pluginDir.getPath());
+   JsonObject metaData;
+   String errorString;
+   ASSERT_TRUE(index.lookup(keptFile, stamp, &metaData, &errorString));
+   ASSERT_FALSE(index.lookup(removedFile, stamp, &metaData, &errorString));
+}
+
+TEST(PluginIndexTest, testIgnoresCorruptIndex)
+{
+   IndexLocation location;
+   TemporaryDir pluginDir;
+   ASSERT_TRUE(pluginDir.isValid());
+   const String fileName = pluginDir.getFilePath(Latin1String("libplugin.so"));
+   PluginFileStamp stamp;
+   stamp.m_size = 1;
+   {
+      PluginIndex index(pluginDir.getPath());
+      index.insert(fileName, stamp, plugin_meta_data(Latin1String("alpha")));
+      ASSERT_TRUE(index.save());
+   }
+   // an index file that is not valid binary JSON is ignored
+   write_file(PluginIndex::getIndexFileName(pluginDir.getPath()), ByteArray("garbage"));
+   PluginIndex index(pluginDir.getPath());
+   JsonObject metaData;
+   String errorString;
+   ASSERT_FALSE(index.lookup(fileName, stamp, &metaData, &errorString));
+}
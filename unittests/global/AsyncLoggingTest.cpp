@@ -0,0 +1,209 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/global/Logging.h"
+#include "pdk/global/internal/AsyncLoggingPrivate.h"
+#include "pdk/base/io/fs/File.h"
+#include "pdk/base/io/fs/TemporaryDir.h"
+#include "pdk/base/lang/String.h"
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using pdk::AsyncLoggingOptions;
+using pdk::AsyncLogRecord;
+using pdk::io::fs::File;
+using pdk::io::fs::TemporaryDir;
+using pdk::lang::Latin1String;
+
+namespace {
+
+struct CollectingSink
+{
+   static void write(const AsyncLogRecord *records, int count, void *userData)
+   {
+      CollectingSink *sink = static_cast<CollectingSink *>(userData);
+      std::lock_guard<std::mutex> locker(sink->m_mutex);
+      ++sink->m_batches;
+      for (int i = 0; i < count; ++i) {
+         sink->m_lines.emplace_back(records[i].m_data, records[i].m_size);
+      }
+   }
+   
+   std::mutex m_mutex;
+   std::vector<std::string> m_lines;
+   int m_batches = 0;
+};
+
+AsyncLoggingOptions sink_options(CollectingSink &sink)
+{
+   AsyncLoggingOptions options;
+   options.m_sink = &CollectingSink::write;
+   options.m_sinkData = &sink;
+   return options;
+}
+
+} // anonymous namespace
+
+TEST(AsyncLoggingTest, testEnableDisable)
+{
+   CollectingSink sink;
+   ASSERT_FALSE(pdk::is_async_logging_enabled());
+   ASSERT_TRUE(pdk::enable_async_logging(sink_options(sink)));
+   ASSERT_TRUE(pdk::is_async_logging_enabled());
+   ASSERT_FALSE(pdk::enable_async_logging(sink_options(sink)));
+   warning_stream("queued message");
+   pdk::disable_async_logging();
+   ASSERT_FALSE(pdk::is_async_logging_enabled());
+   ASSERT_EQ(sink.m_lines.size(), 1u);
+   ASSERT_EQ(sink.m_lines.front(), std::string("queued message\n"));
+}
+
+TEST(AsyncLoggingTest, testBlockingKeepsEveryMessageInOrder)
+{
+   CollectingSink sink;
+   AsyncLoggingOptions options = sink_options(sink);
+   options.m_bufferSize = 4096;
+   options.m_overflowPolicy = AsyncLoggingOptions::OverflowPolicy::BlockProducer;
+   const pdk::puint64 droppedBefore = pdk::get_dropped_log_message_count();
+   ASSERT_TRUE(pdk::enable_async_logging(options));
+   std::vector<std::thread> threads;
+   for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([t]() {
+         for (int i = 0; i < 5000; ++i) {
+            // every now and then a message too large for the ring
+            if (i % 1000 == 0) {
+               warning_stream("%d:%d %s", t, i, std::string(3000, 'x').c_str());
+            } else {
+               warning_stream("%d:%d", t, i);
+            }
+         }
+      });
+   }
+   for (std::thread &thread : threads) {
+      thread.join();
+   }
+   pdk::flush_async_logging();
+   pdk::disable_async_logging();
+   ASSERT_EQ(pdk::get_dropped_log_message_count(), droppedBefore);
+   ASSERT_EQ(sink.m_lines.size(), 20000u);
+   std::map<int, int> expected;
+   for (const std::string &line : sink.m_lines) {
+      int thread = -1;
+      int index = -1;
+      ASSERT_EQ(std::sscanf(line.c_str(), "%d:%d", &thread, &index), 2);
+      ASSERT_EQ(index, expected[thread]);
+      expected[thread] = index + 1;
+      ASSERT_EQ(line.back(), '\n');
+   }
+   ASSERT_LT(sink.m_batches, 20000);
+}
+
+TEST(AsyncLoggingTest, testDropCountsMessages)
+{
+   CollectingSink sink;
+   AsyncLoggingOptions options = sink_options(sink);
+   options.m_bufferSize = 4096;
+   options.m_flushInterval = 1000;
+   const pdk::puint64 droppedBefore = pdk::get_dropped_log_message_count();
+   ASSERT_TRUE(pdk::enable_async_logging(options));
+   for (int i = 0; i < 10000; ++i) {
+      warning_stream("message %d", i);
+   }
+   pdk::flush_async_logging();
+   pdk::disable_async_logging();
+   const pdk::puint64 dropped = pdk::get_dropped_log_message_count() - droppedBefore;
+   ASSERT_EQ(sink.m_lines.size() + dropped, 10000u);
+}
+
+TEST(AsyncLoggingTest, testExitedThreadsReleaseRings)
+{
+   CollectingSink sink;
+   ASSERT_TRUE(pdk::enable_async_logging(sink_options(sink)));
+   const int ringsBefore = pdk::internal::async_log_ring_count();
+   std::vector<std::thread> threads;
+   for (int t = 0; t < 8; ++t) {
+      threads.emplace_back([t]() {
+         warning_stream("thread %d", t);
+      });
+   }
+   for (std::thread &thread : threads) {
+      thread.join();
+   }
+   // drained rings of finished threads go on the next pass of the writer
+   pdk::flush_async_logging();
+   pdk::flush_async_logging();
+   ASSERT_EQ(pdk::internal::async_log_ring_count(), ringsBefore);
+   
+   // threads that outlive the writer free their rings when they exit
+   std::mutex mutex;
+   std::condition_variable released;
+   bool exit = false;
+   threads.clear();
+   for (int t = 0; t < 8; ++t) {
+      threads.emplace_back([t, &mutex, &released, &exit]() {
+         warning_stream("thread %d", t);
+         std::unique_lock<std::mutex> locker(mutex);
+         released.wait(locker, [&exit]() {
+            return exit;
+         });
+      });
+   }
+   pdk::flush_async_logging();
+   ASSERT_EQ(pdk::internal::async_log_ring_count(), ringsBefore + 8);
+   pdk::disable_async_logging();
+   {
+      std::lock_guard<std::mutex> locker(mutex);
+      exit = true;
+   }
+   released.notify_all();
+   for (std::thread &thread : threads) {
+      thread.join();
+   }
+   ASSERT_EQ(pdk::internal::async_log_ring_count(), ringsBefore);
+   ASSERT_EQ(sink.m_lines.size(), 16u);
+}
+
+TEST(AsyncLoggingTest, testRotatingFile)
+{
+   TemporaryDir dir;
+   ASSERT_TRUE(dir.isValid());
+   const std::string fileName = dir.getFilePath(Latin1String("app.log")).toStdString();
+   AsyncLoggingOptions options;
+   options.m_fileName = fileName.c_str();
+   options.m_maxFileSize = 4096;
+   options.m_maxBackupFiles = 2;
+   ASSERT_TRUE(pdk::enable_async_logging(options));
+   for (int i = 0; i < 1000; ++i) {
+      warning_stream("line %04d", i);
+      if (i % 50 == 0) {
+         pdk::flush_async_logging();
+      }
+   }
+   pdk::disable_async_logging();
+   File current(dir.getFilePath(Latin1String("app.log")));
+   ASSERT_TRUE(current.exists());
+   ASSERT_LE(current.getSize(), 4096);
+   ASSERT_TRUE(File::exists(dir.getFilePath(Latin1String("app.log.1"))));
+   ASSERT_TRUE(File::exists(dir.getFilePath(Latin1String("app.log.2"))));
+   ASSERT_FALSE(File::exists(dir.getFilePath(Latin1String("app.log.3"))));
+   ASSERT_TRUE(current.open(pdk::io::IoDevice::OpenMode::ReadOnly));
+   ASSERT_TRUE(current.readAll().endsWith("line 0999\n"));
+}
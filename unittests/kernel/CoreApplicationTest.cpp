@@ -986,6 +986,83 @@ TEST(CoreApplicationTest, testThreadedEventDelivery)
    }
 }
 
+namespace {
+
+constexpr int POSTING_THREAD_COUNT = 4;
+constexpr int EVENTS_PER_POSTING_THREAD = 1000;
+
+class PostingThread : public Thread
+{
+public:
+   Object *m_receiver;
+   int m_base;
+   
+   void run() override
+   {
+      for (int i = 0; i < EVENTS_PER_POSTING_THREAD; ++i) {
+         CoreApplication::postEvent(m_receiver, new Event(Event::Type(pdk::as_integer<Event::Type>(Event::Type::User) + m_base + i)));
+      }
+   }
+};
+
+class OrderRecorder : public Object
+{
+public:
+   int m_count = 0;
+   bool m_inOrder = true;
+   int m_last[POSTING_THREAD_COUNT] = {-1, -1, -1, -1};
+   
+   bool event(Event *event) override
+   {
+      int offset = pdk::as_integer<Event::Type>(event->getType()) - pdk::as_integer<Event::Type>(Event::Type::User);
+      if (offset < 0) {
+         return Object::event(event);
+      }
+      int thread = offset / EVENTS_PER_POSTING_THREAD;
+      int index = offset % EVENTS_PER_POSTING_THREAD;
+      m_inOrder = m_inOrder && index > m_last[thread];
+      m_last[thread] = index;
+      ++m_count;
+      return true;
+   }
+};
+
+} // anonymous namespace
+
+TEST(CoreApplicationTest, testPostEventFromManyThreads)
+{
+   std::string str("CoreAplicationTest");
+   int argc = 1;
+   char *argv[] = {const_cast<char *>(str.c_str())};
+   CoreApplication app(argc, argv);
+   ThreadData *data = ThreadData::current();
+   pdk::puint64 lockedPostCount = data->m_postEventList.getLockedPostCount();
+   OrderRecorder receiver;
+   PostingThread threads[POSTING_THREAD_COUNT];
+   for (int i = 0; i < POSTING_THREAD_COUNT; ++i) {
+      threads[i].m_receiver = &receiver;
+      threads[i].m_base = i * EVENTS_PER_POSTING_THREAD;
+      threads[i].start();
+   }
+   for (PostingThread &thread : threads) {
+      EXPECT_TRUE(thread.wait());
+   }
+   CoreApplication::sendPostedEvents();
+   EXPECT_EQ(receiver.m_count, POSTING_THREAD_COUNT * EVENTS_PER_POSTING_THREAD);
+   EXPECT_TRUE(receiver.m_inOrder);
+   // normal priority events never touch the post event mutex
+   EXPECT_EQ(data->m_postEventList.getLockedPostCount(), lockedPostCount);
+   CoreApplication::postEvent(&receiver, new Event(Event::Type::User), pdk::EventPriority::HighEventPriority);
+   EXPECT_EQ(data->m_postEventList.getLockedPostCount(), lockedPostCount + 1);
+   // pending intake events are dropped together with their receiver
+   {
+      OrderRecorder doomed;
+      CoreApplication::postEvent(&doomed, new Event(Event::Type::User));
+   }
+   CoreApplication::sendPostedEvents();
+   EXPECT_EQ(receiver.m_count, POSTING_THREAD_COUNT * EVENTS_PER_POSTING_THREAD + 1);
+}
+
 int main(int argc, char **argv)
 {
    ::testing::InitGoogleTest(&argc, argv);
@@ -24,6 +24,10 @@
 #include "pdk/kernel/internal/CoreUnixPrivate.h"
 #include "pdk/kernel/EventDispatcherUnix.h"
 #endif
+#if defined(PDK_OS_LINUX)
+#include "pdk/kernel/EventDispatcherEpoll.h"
+#endif
+#include "pdk/kernel/SocketNotifier.h"
 #include "pdk/base/os/thread/Thread.h"
 #include "pdk/kernel/Timer.h"
 #include "pdktest/PdkTest.h"
@@ -41,9 +45,13 @@ using pdk::kernel::Timer;
 using pdk::kernel::internal::ObjectPrivate;
 using pdk::kernel::AbstractEventDispatcher;
 using pdk::kernel::EventDispatcherUNIX;
+#if defined(PDK_OS_LINUX)
+using pdk::kernel::EventDispatcherEpoll;
+#endif
 using pdk::kernel::CoreApplication;
 using pdk::kernel::CallableInvoker;
 using pdk::kernel::EventLoopLocker;
+using pdk::kernel::SocketNotifier;
 
 PDKTEST_DECLARE_APP_STARTUP_ARGS();
 
@@ -571,3 +579,47 @@ TEST(EventLoopTest, testQuitLock)
    eventLoop.exec();
    PDKTEST_END_APP_CONTEXT();
 }
+
+#if defined(PDK_OS_LINUX)
+
+TEST(EventLoopTest, testEpollSocketNotifier)
+{
+   PDKTEST_BEGIN_APP_CONTEXT();
+   // PDK_EVENT_DISPATCHER_POLL selects the poll(2) based dispatcher instead
+   if (EventDispatcherEpoll::isPreferred()) {
+      ASSERT_TRUE(dynamic_cast<EventDispatcherEpoll *>(AbstractEventDispatcher::getInstance()) != nullptr);
+      int fds[2];
+      ASSERT_EQ(pdk::kernel::safe_pipe(fds, O_NONBLOCK), 0);
+      int activated = 0;
+      {
+         SocketNotifier notifier(fds[0], SocketNotifier::Type::Read);
+         notifier.connectActivatedSignal([&activated](int) {
+            ++activated;
+         });
+         char c = 'x';
+         ASSERT_EQ(::write(fds[1], &c, 1), 1);
+         EventLoop eventLoop;
+         while (activated == 0) {
+            eventLoop.processEvents(EventLoop::WaitForMoreEvents);
+         }
+         ASSERT_EQ(activated, 1);
+         ASSERT_EQ(::read(fds[0], &c, 1), 1);
+         // a disabled notifier is removed from the epoll set
+         notifier.setEnabled(false);
+         ASSERT_EQ(::write(fds[1], &c, 1), 1);
+         eventLoop.processEvents();
+         ASSERT_EQ(activated, 1);
+         // and comes back when enabled again
+         notifier.setEnabled(true);
+         while (activated == 1) {
+            eventLoop.processEvents(EventLoop::WaitForMoreEvents);
+         }
+         ASSERT_EQ(activated, 2);
+      }
+      ::close(fds[0]);
+      ::close(fds[1]);
+   }
+   PDKTEST_END_APP_CONTEXT();
+}
+
+#endif
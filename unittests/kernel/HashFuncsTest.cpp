@@ -15,10 +15,32 @@
 
 #include "gtest/gtest.h"
 #include "pdk/kernel/HashFuncs.h"
+#include "pdk/base/ds/ByteArray.h"
+#include "pdk/base/lang/String.h"
 #include <list>
 #include <algorithm>
 #include <utility>
 #include <tuple>
+#include <unordered_set>
+#include <vector>
+
+using pdk::ds::ByteArray;
+using pdk::lang::String;
+using pdk::lang::StringView;
+using pdk::lang::Latin1String;
+
+namespace {
+
+std::vector<uchar> make_bytes(size_t size)
+{
+   std::vector<uchar> bytes(size);
+   for (size_t i = 0; i < size; ++i) {
+      bytes[i] = static_cast<uchar>(i * 131 + (i >> 8));
+   }
+   return bytes;
+}
+
+} // anonymous namespace
 
 TEST(HashFuncsTest, testHash)
 {
@@ -33,3 +55,113 @@ TEST(HashFuncsTest, testHash)
       ASSERT_FALSE(pdk::pdk_hash(pA) == pdk::pdk_hash(pB));
    }
 }
+
+TEST(HashFuncsTest, testHashBytes64)
+{
+   std::vector<uchar> bytes = make_bytes(5000);
+   std::unordered_set<pdk::puint64> seen;
+   // every length through the short and the long path gives its own hash
+   for (size_t length = 0; length <= 2100; ++length) {
+      const pdk::puint64 hash = pdk::hash_bytes64(bytes.data(), length);
+      ASSERT_EQ(hash, pdk::hash_bytes64(bytes.data(), length));
+      ASSERT_NE(hash, pdk::hash_bytes64(bytes.data(), length, 1)) << length;
+      ASSERT_TRUE(seen.insert(hash).second) << length;
+   }
+   // a flipped bit anywhere, including the middle of a long input
+   for (size_t length : {1, 16, 17, 100, 1024, 1025, 5000}) {
+      std::vector<uchar> other = bytes;
+      other[length / 2] ^= 1;
+      ASSERT_NE(pdk::hash_bytes64(bytes.data(), length), pdk::hash_bytes64(other.data(), length)) << length;
+   }
+}
+
+TEST(HashFuncsTest, testIncrementalHash)
+{
+   std::vector<uchar> bytes = make_bytes(5000);
+   for (size_t length : {0, 1, 63, 64, 65, 1023, 1024, 1025, 1030, 2048, 2049, 3000, 5000}) {
+      const pdk::puint64 expected = pdk::hash_bytes64(bytes.data(), length, 42);
+      for (size_t step : {1, 7, 64, 100, 1024, 1500}) {
+         pdk::IncrementalHash hash(42);
+         for (size_t i = 0; i < length; i += step) {
+            hash.addData(bytes.data() + i, std::min(step, length - i));
+         }
+         ASSERT_EQ(hash.result(), expected) << length << " " << step;
+      }
+   }
+   pdk::IncrementalHash hash;
+   hash.addData(bytes.data(), 3000);
+   hash.reset();
+   hash.addData(bytes.data(), 10);
+   ASSERT_EQ(hash.result(), pdk::hash_bytes64(bytes.data(), 10));
+   
+   String text(Latin1String("incremental"));
+   pdk::IncrementalHash stringHash;
+   stringHash.addData(StringView(text));
+   ASSERT_EQ(pdk::pdk_hash(text), static_cast<uint>(stringHash.result() ^ (stringHash.result() >> 32)));
+}
+
+TEST(HashFuncsTest, testHashSpread)
+{
+   // sequential integer keys must fill the buckets of a power of two table
+   // evenly through the low bits
+   std::vector<int> buckets(1024);
+   for (pdk::puint64 i = 0; i < 102400; ++i) {
+      ++buckets[pdk::hash_bytes64(&i, sizeof(i)) & 1023];
+   }
+   ASSERT_LT(*std::max_element(buckets.begin(), buckets.end()), 160);
+   ASSERT_GT(*std::min_element(buckets.begin(), buckets.end()), 50);
+}
+
+TEST(HashFuncsTest, testSipHash)
+{
+   // reference vectors from the SipHash paper
+   const pdk::SipHashKey key = {PDK_UINT64_C(0x0706050403020100), PDK_UINT64_C(0x0f0e0d0c0b0a0908)};
+   std::vector<uchar> message(64);
+   for (size_t i = 0; i < message.size(); ++i) {
+      message[i] = static_cast<uchar>(i);
+   }
+   ASSERT_EQ(pdk::siphash(message.data(), 0, key), PDK_UINT64_C(0x726fdb47dd0e0e31));
+   ASSERT_EQ(pdk::siphash(message.data(), 1, key), PDK_UINT64_C(0x74f839c593dc67fd));
+   ASSERT_EQ(pdk::siphash(message.data(), 7, key), PDK_UINT64_C(0xab0200f58b01d137));
+   ASSERT_EQ(pdk::siphash(message.data(), 8, key), PDK_UINT64_C(0x93f5f5799a932462));
+   ASSERT_EQ(pdk::siphash(message.data(), 15, key), PDK_UINT64_C(0xa129ca6149be45e5));
+   ASSERT_EQ(pdk::siphash(message.data(), 63, key), PDK_UINT64_C(0x958a324ceb064572));
+}
+
+TEST(HashFuncsTest, testLatin1Hash)
+{
+   ASSERT_EQ(pdk::pdk_hash(Latin1String("abc")), pdk::pdk_hash(String::fromLatin1("abc")));
+   ASSERT_EQ(pdk::pdk_hash(Latin1String("")), pdk::pdk_hash(String()));
+   // sizes around the chunks the Latin-1 data is widened in
+   for (int size : {7, 255, 256, 257, 511, 513, 1000, 4099}) {
+      ByteArray latin1(size, 'x');
+      for (int i = 0; i < size; ++i) {
+         latin1[i] = static_cast<char>(0x20 + (i * 7) % 0xd0);
+      }
+      Latin1String view(latin1.getConstRawData(), size);
+      const String text(view);
+      ASSERT_EQ(pdk::pdk_hash(view), pdk::pdk_hash(text)) << size;
+      ASSERT_EQ(pdk::pdk_hash(view, 7), pdk::pdk_hash(text, 7)) << size;
+      ASSERT_EQ(pdk::pdk_secure_hash(view), pdk::pdk_secure_hash(text)) << size;
+      ASSERT_EQ(pdk::pdk_secure_hash(view, 7), pdk::pdk_secure_hash(text, 7)) << size;
+   }
+}
+
+TEST(HashFuncsTest, testSecureHash)
+{
+   ByteArray bytes("untrusted key");
+   String text(Latin1String("untrusted key"));
+   ASSERT_EQ(pdk::pdk_secure_hash(bytes), pdk::pdk_secure_hash(ByteArray("untrusted key")));
+   ASSERT_EQ(pdk::pdk_secure_hash(text), pdk::pdk_secure_hash(Latin1String("untrusted key")));
+   ASSERT_EQ(pdk::pdk_secure_hash(text), pdk::pdk_secure_hash(StringView(text)));
+   ASSERT_NE(pdk::pdk_secure_hash(bytes), pdk::pdk_secure_hash(bytes, 1));
+   
+   std::unordered_set<ByteArray, pdk::SecureHash<ByteArray>> keys;
+   for (int i = 0; i < 1000; ++i) {
+      keys.insert(ByteArray::number(i));
+   }
+   ASSERT_EQ(keys.size(), 1000u);
+   ASSERT_EQ(keys.count(ByteArray("999")), 1u);
+   std::unordered_set<ByteArray> plainKeys(keys.begin(), keys.end());
+   ASSERT_EQ(plainKeys.size(), 1000u);
+}
@@ -23,11 +23,13 @@
 #include "pdk/base/time/Time.h"
 #include "pdk/utils/ScopedPointer.h"
 #include "pdk/kernel/CallableInvoker.h"
+#include "pdk/kernel/AbstractEventDispatcher.h"
 #include "pdktest/PdkTest.h"
 
 #if defined PDK_OS_UNIX
 #include <unistd.h>
 #endif
+#include <map>
 
 using pdk::kernel::Object;
 using pdk::kernel::Timer;
@@ -43,6 +45,7 @@ using pdk::kernel::BasicTimer;
 using pdk::time::Time;
 using pdk::utils::ScopedPointer;
 using pdk::kernel::CallableInvoker;
+using pdk::kernel::AbstractEventDispatcher;
 
 PDKTEST_DECLARE_APP_STARTUP_ARGS();
 
@@ -988,3 +991,50 @@ TEST(TimerTest, testCrossThreadSingleShotToFunctor)
    PDKTEST_END_APP_CONTEXT();
 }
 
+
+class ManyTimersObject : public Object
+{
+public:
+   std::map<int, int> m_timeouts;
+   
+   void timerEvent(TimerEvent *timerEvent)
+   {
+      ++m_timeouts[timerEvent->getTimerId()];
+   }
+};
+
+TEST(TimerTest, testManyTimers)
+{
+   PDKTEST_BEGIN_APP_CONTEXT();
+   ManyTimersObject object;
+   std::list<int> keptIds;
+   std::list<int> killedIds;
+   for (int i = 0; i < 5000; ++i) {
+      // spread over the root wheel and the first upper wheels
+      int timerId = object.startTimer(1 + (i * 7) % 400, pdk::TimerType::PreciseTimer);
+      if (i % 2) {
+         killedIds.push_back(timerId);
+      } else {
+         keptIds.push_back(timerId);
+      }
+   }
+   // long running timers that must be cancellable before they fire
+   for (int i = 0; i < 100; ++i) {
+      killedIds.push_back(object.startTimer(60 * 60 * 1000 + i));
+   }
+   for (int timerId : killedIds) {
+      object.killTimer(timerId);
+   }
+   std::list<AbstractEventDispatcher::TimerInfo> timers = AbstractEventDispatcher::getInstance()->getRegisteredTimers(&object);
+   ASSERT_EQ(timers.size(), keptIds.size());
+   ASSERT_EQ(timers.front().m_timerId, keptIds.front());
+   PDK_TRY_COMPARE(object.m_timeouts.size(), keptIds.size());
+   for (int timerId : killedIds) {
+      ASSERT_EQ(object.m_timeouts.count(timerId), 0u);
+   }
+   for (int timerId : keptIds) {
+      object.killTimer(timerId);
+   }
+   ASSERT_TRUE(AbstractEventDispatcher::getInstance()->getRegisteredTimers(&object).empty());
+   PDKTEST_END_APP_CONTEXT();
+}
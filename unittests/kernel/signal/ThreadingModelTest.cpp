@@ -14,8 +14,11 @@
 // Created by softboy on 2018/01/23.
 
 #include "gtest/gtest.h"
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 #include "pdk/kernel/signal/Signal.h"
 
 
@@ -95,3 +98,68 @@ TEST(ThreadingModelTest, testThreadingModel)
          std::function<void (const Signals::Connection &)>, Signals::DummyMutex> sig0_st_type;
    simple_test<sig0_st_type>();
 }
+
+TEST(ThreadingModelTest, testSnapshotEmission)
+{
+   typedef Signals::Signal<void (), SlotCounter> SignalType;
+   SignalType sig;
+   ASSERT_EQ(sig.getEmissionMode(), Signals::EmissionMode::Locked);
+   sig.setEmissionMode(Signals::EmissionMode::Snapshot);
+   ASSERT_EQ(sig.getEmissionMode(), Signals::EmissionMode::Snapshot);
+   ASSERT_EQ(sig(), 0u);
+   Signals::Connection conn = sig.connect(SignalType::SlotType(&myslot));
+   ASSERT_EQ(sig(), 1u);
+   {
+      Signals::SharedConnectionBlock block(conn);
+      ASSERT_EQ(sig(), 0u);
+   }
+   ASSERT_EQ(sig(), 1u);
+   {
+      std::shared_ptr<int> tracked(new int(0));
+      sig.connect(SignalType::SlotType(&myslot).track(tracked));
+      ASSERT_EQ(sig(), 2u);
+   }
+   ASSERT_EQ(sig(), 1u);
+   ASSERT_EQ(sig.getNumSlots(), 1u);
+   
+   // emit from several threads while another one keeps connecting and
+   // disconnecting, every disconnected slot must stay alive while an
+   // emission may still call it
+   std::atomic<bool> stop(false);
+   std::atomic<bool> failed(false);
+   std::vector<std::thread> emitters;
+   for (int i = 0; i < 4; ++i) {
+      emitters.emplace_back([&sig, &stop, &failed]() {
+         while (!stop.load()) {
+            if (sig() < 1u) {
+               failed.store(true);
+            }
+         }
+      });
+   }
+   std::weak_ptr<int> lastSentinel;
+   for (int i = 0; i < 1000; ++i) {
+      std::shared_ptr<int> sentinel(new int(i));
+      lastSentinel = sentinel;
+      Signals::Connection churn = sig.connect([sentinel, i, &failed]() {
+         if (*sentinel != i) {
+            failed.store(true);
+         }
+      });
+      if (i % 3 == 0) {
+         std::this_thread::yield();
+      }
+      churn.disconnect();
+   }
+   stop.store(true);
+   for (std::thread &emitter : emitters) {
+      emitter.join();
+   }
+   ASSERT_FALSE(failed.load());
+   ASSERT_EQ(sig.getNumSlots(), 1u);
+   sig.setEmissionMode(Signals::EmissionMode::Locked);
+   ASSERT_TRUE(lastSentinel.expired());
+   ASSERT_EQ(sig(), 1u);
+   sig.disconnect(conn);
+   ASSERT_EQ(sig(), 0u);
+}
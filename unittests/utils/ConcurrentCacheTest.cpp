@@ -0,0 +1,256 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/utils/ConcurrentCache.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using pdk::utils::ConcurrentCache;
+
+namespace {
+
+struct Payload
+{
+   explicit Payload(int value)
+      : m_value(value)
+   {
+      ++sm_liveCount;
+   }
+   
+   ~Payload()
+   {
+      --sm_liveCount;
+   }
+   
+   int m_value;
+   static std::atomic<int> sm_liveCount;
+};
+
+std::atomic<int> Payload::sm_liveCount(0);
+
+using CacheType = ConcurrentCache<int, Payload>;
+
+// asks another thread to use the cache while the object is destroyed, which
+// only gets through when the cache is not locked at that point
+struct UnlockedCheck
+{
+   explicit UnlockedCheck(ConcurrentCache<int, UnlockedCheck> *cache)
+      : m_cache(cache)
+   {}
+   
+   ~UnlockedCheck()
+   {
+      std::shared_ptr<std::promise<void>> done = std::make_shared<std::promise<void>>();
+      std::future<void> result = done->get_future();
+      ConcurrentCache<int, UnlockedCheck> *cache = m_cache;
+      sm_checkers.emplace_back([cache, done]() {
+         cache->contains(-1);
+         done->set_value();
+      });
+      if (result.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+         ++sm_lockedCount;
+      }
+   }
+   
+   ConcurrentCache<int, UnlockedCheck> *m_cache;
+   static std::vector<std::thread> sm_checkers;
+   static int sm_lockedCount;
+};
+
+std::vector<std::thread> UnlockedCheck::sm_checkers;
+int UnlockedCheck::sm_lockedCount = 0;
+
+} // anonymous namespace
+
+TEST(ConcurrentCacheTest, testBasicOperations)
+{
+   {
+      CacheType cache(10, CacheType::EvictionPolicy::LeastRecentlyUsed, 1);
+      ASSERT_EQ(cache.getShardCount(), 1);
+      ASSERT_TRUE(cache.isEmpty());
+      ASSERT_TRUE(cache.insert(1, new Payload(1), 4));
+      ASSERT_TRUE(cache.insert(2, new Payload(2), 4));
+      ASSERT_EQ(cache.getCount(), 2);
+      ASSERT_EQ(cache.getTotalCost(), 8);
+      ASSERT_TRUE(cache.contains(1));
+      ASSERT_EQ(cache.getData(1)->m_value, 1);
+      // key 2 is now the least recently used entry
+      ASSERT_TRUE(cache.insert(3, new Payload(3), 4));
+      ASSERT_FALSE(cache.contains(2));
+      ASSERT_TRUE(cache.contains(1));
+      ASSERT_EQ(cache.getTotalCost(), 8);
+      // too expensive, rejected and deleted
+      ASSERT_FALSE(cache.insert(4, new Payload(4), 11));
+      ASSERT_EQ(Payload::sm_liveCount.load(), 2);
+      // replacing an entry updates the cost
+      ASSERT_TRUE(cache.insert(1, new Payload(10), 1));
+      ASSERT_EQ(cache.getTotalCost(), 5);
+      ASSERT_EQ(cache[1]->m_value, 10);
+      std::shared_ptr<Payload> taken = cache.take(3);
+      ASSERT_TRUE(taken);
+      ASSERT_EQ(taken->m_value, 3);
+      ASSERT_FALSE(cache.contains(3));
+      ASSERT_FALSE(cache.remove(3));
+      ASSERT_TRUE(cache.remove(1));
+      ASSERT_TRUE(cache.isEmpty());
+      ASSERT_EQ(cache.getTotalCost(), 0);
+      
+      CacheType::Statistics statistics = cache.getStatistics();
+      ASSERT_EQ(statistics.m_hits, 2u);
+      ASSERT_EQ(statistics.m_misses, 0u);
+      ASSERT_EQ(statistics.m_insertions, 4u);
+      ASSERT_EQ(statistics.m_evictions, 1u);
+      ASSERT_FALSE(cache.getData(42));
+      ASSERT_EQ(cache.getStatistics().m_misses, 1u);
+      cache.resetStatistics();
+      ASSERT_EQ(cache.getStatistics().m_hits, 0u);
+   }
+   ASSERT_EQ(Payload::sm_liveCount.load(), 0);
+}
+
+TEST(ConcurrentCacheTest, testClockEviction)
+{
+   CacheType cache(3, CacheType::EvictionPolicy::Clock, 1);
+   cache.insert(1, new Payload(1));
+   cache.insert(2, new Payload(2));
+   cache.insert(3, new Payload(3));
+   // 1 is the oldest entry but was referenced, it gets a second chance
+   ASSERT_TRUE(cache.getData(1));
+   cache.insert(4, new Payload(4));
+   ASSERT_TRUE(cache.contains(1));
+   ASSERT_FALSE(cache.contains(2));
+   ASSERT_TRUE(cache.contains(3));
+   ASSERT_TRUE(cache.contains(4));
+   // shrinking the budget evicts down to the new limit
+   cache.setMaxCost(1);
+   ASSERT_EQ(cache.getCount(), 1);
+   ASSERT_EQ(cache.getTotalCost(), 1);
+   cache.clear();
+   ASSERT_TRUE(cache.isEmpty());
+   ASSERT_EQ(Payload::sm_liveCount.load(), 0);
+}
+
+TEST(ConcurrentCacheTest, testEvictedObjectsReleasedUnlocked)
+{
+   using CheckCache = ConcurrentCache<int, UnlockedCheck>;
+   for (CheckCache::EvictionPolicy policy : {CheckCache::EvictionPolicy::LeastRecentlyUsed,
+        CheckCache::EvictionPolicy::Clock}) {
+      {
+         CheckCache cache(2, policy, 1);
+         for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(cache.insert(i, new UnlockedCheck(&cache)));
+         }
+         ASSERT_EQ(UnlockedCheck::sm_checkers.size(), 2u);
+         cache.setMaxCost(1);
+         ASSERT_EQ(UnlockedCheck::sm_checkers.size(), 3u);
+         ASSERT_TRUE(cache.insert(3, new UnlockedCheck(&cache)));
+         ASSERT_EQ(UnlockedCheck::sm_checkers.size(), 4u);
+         cache.clear();
+      }
+      for (std::thread &checker : UnlockedCheck::sm_checkers) {
+         checker.join();
+      }
+      ASSERT_EQ(UnlockedCheck::sm_checkers.size(), 5u);
+      ASSERT_EQ(UnlockedCheck::sm_lockedCount, 0);
+      UnlockedCheck::sm_checkers.clear();
+   }
+}
+
+TEST(ConcurrentCacheTest, testShardedBudget)
+{
+   CacheType cache(64, CacheType::EvictionPolicy::LeastRecentlyUsed, 5);
+   ASSERT_EQ(cache.getShardCount(), 8);
+   for (int i = 0; i < 1000; ++i) {
+      cache.insert(i, new Payload(i));
+   }
+   ASSERT_LE(cache.getTotalCost(), 64);
+   ASSERT_EQ(cache.getTotalCost(), cache.getCount());
+   // a budget below the shard count drops to fewer shards
+   CacheType small(2, CacheType::EvictionPolicy::LeastRecentlyUsed, 16);
+   ASSERT_EQ(small.getShardCount(), 2);
+}
+
+TEST(ConcurrentCacheTest, testCostAboveShardShare)
+{
+   {
+      CacheType cache(100, CacheType::EvictionPolicy::LeastRecentlyUsed, 8);
+      ASSERT_EQ(cache.getShardCount(), 8);
+      for (int i = 0; i < 40; ++i) {
+         ASSERT_TRUE(cache.insert(i, new Payload(i)));
+      }
+      // far more than the share of a single shard
+      ASSERT_TRUE(cache.insert(100, new Payload(100), 90));
+      ASSERT_TRUE(cache.contains(100));
+      ASSERT_EQ(cache.getTotalCost(), 100);
+      ASSERT_EQ(cache.getCount(), 11);
+      ASSERT_TRUE(cache.insert(101, new Payload(101), 100));
+      ASSERT_TRUE(cache.contains(101));
+      ASSERT_EQ(cache.getCount(), 1);
+      ASSERT_FALSE(cache.insert(102, new Payload(102), 101));
+      ASSERT_TRUE(cache.contains(101));
+      for (int i = 0; i < 1000; ++i) {
+         cache.insert(i, new Payload(i), 1 + i % 7);
+         ASSERT_LE(cache.getTotalCost(), 100);
+      }
+      ASSERT_FALSE(cache.contains(101));
+      // the budget is shared, so a smaller one still fits large objects
+      cache.setMaxCost(60);
+      ASSERT_LE(cache.getTotalCost(), 60);
+      ASSERT_TRUE(cache.insert(103, new Payload(103), 60));
+      ASSERT_EQ(cache.getTotalCost(), 60);
+   }
+   ASSERT_EQ(Payload::sm_liveCount.load(), 0);
+}
+
+TEST(ConcurrentCacheTest, testConcurrentAccess)
+{
+   for (CacheType::EvictionPolicy policy : {CacheType::EvictionPolicy::LeastRecentlyUsed,
+        CacheType::EvictionPolicy::Clock}) {
+      CacheType cache(256, policy, 4);
+      std::atomic<bool> failed(false);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t) {
+         threads.emplace_back([&cache, &failed, t]() {
+            for (int i = 0; i < 20000; ++i) {
+               int key = (i * 7 + t) % 512;
+               std::shared_ptr<Payload> payload = cache.getData(key);
+               if (payload) {
+                  if (payload->m_value != key) {
+                     failed.store(true);
+                  }
+               } else {
+                  cache.insert(key, new Payload(key));
+               }
+               if (i % 97 == 0) {
+                  cache.remove(key);
+               }
+            }
+         });
+      }
+      for (std::thread &thread : threads) {
+         thread.join();
+      }
+      ASSERT_FALSE(failed.load());
+      ASSERT_LE(cache.getTotalCost(), 256);
+      CacheType::Statistics statistics = cache.getStatistics();
+      ASSERT_EQ(statistics.m_hits + statistics.m_misses, 80000u);
+   }
+   ASSERT_EQ(Payload::sm_liveCount.load(), 0);
+}
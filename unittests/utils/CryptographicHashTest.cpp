@@ -0,0 +1,141 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+#include "gtest/gtest.h"
+#include "pdk/utils/CryptographicHash.h"
+#include "pdk/base/io/fs/File.h"
+#include "pdk/base/io/fs/TemporaryDir.h"
+#include <algorithm>
+#include <vector>
+
+using pdk::ds::ByteArray;
+using pdk::lang::Latin1String;
+using pdk::io::IoDevice;
+using pdk::io::fs::File;
+using pdk::io::fs::TemporaryDir;
+using pdk::utils::CryptographicHash;
+
+namespace {
+
+const CryptographicHash::Algorithm sg_algorithms[] = {
+   CryptographicHash::Md4,
+   CryptographicHash::Md5,
+   CryptographicHash::Sha1,
+   CryptographicHash::Sha224,
+   CryptographicHash::Sha256,
+   CryptographicHash::Sha384,
+   CryptographicHash::Sha512,
+   CryptographicHash::Keccak_224,
+   CryptographicHash::Keccak_256,
+   CryptographicHash::Keccak_384,
+   CryptographicHash::Keccak_512,
+   CryptographicHash::RealSha3_224,
+   CryptographicHash::RealSha3_256,
+   CryptographicHash::RealSha3_384,
+   CryptographicHash::RealSha3_512
+};
+
+ByteArray hex_hash(const ByteArray &data, CryptographicHash::Algorithm method)
+{
+   return CryptographicHash::hash(data, method).toHex();
+}
+
+// bytes that do not repeat with the block size
+ByteArray make_data(int size)
+{
+   ByteArray data(size, pdk::Uninitialized);
+   for (int i = 0; i < size; ++i) {
+      data[i] = static_cast<char>(i * 7 + i / 251);
+   }
+   return data;
+}
+
+} // anonymous namespace
+
+TEST(CryptographicHashTest, testKnownVectors)
+{
+   ByteArray abc("abc");
+   ASSERT_EQ(hex_hash(abc, CryptographicHash::Md5), ByteArray("900150983cd24fb0d6963f7d28e17f72"));
+   ASSERT_EQ(hex_hash(abc, CryptographicHash::Sha1), ByteArray("a9993e364706816aba3e25717850c26c9cd0d89d"));
+   ASSERT_EQ(hex_hash(abc, CryptographicHash::Sha224),
+             ByteArray("23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7"));
+   ASSERT_EQ(hex_hash(abc, CryptographicHash::Sha256),
+             ByteArray("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+   ASSERT_EQ(hex_hash(abc, CryptographicHash::RealSha3_256),
+             ByteArray("3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532"));
+   ASSERT_EQ(hex_hash(abc, CryptographicHash::Keccak_256),
+             ByteArray("4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45"));
+   ASSERT_EQ(hex_hash(ByteArray(), CryptographicHash::Sha256),
+             ByteArray("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+   ByteArray million(1000000, 'a');
+   ASSERT_EQ(hex_hash(million, CryptographicHash::Sha1), ByteArray("34aa973cd4c4daa4f61eeb2bdbad27316534016f"));
+   ASSERT_EQ(hex_hash(million, CryptographicHash::Sha256),
+             ByteArray("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+}
+
+TEST(CryptographicHashTest, testIncrementalAddData)
+{
+   ByteArray data = make_data(1000);
+   for (CryptographicHash::Algorithm method : sg_algorithms) {
+      const ByteArray expected = CryptographicHash::hash(data, method);
+      for (int step : {1, 3, 63, 64, 65, 200}) {
+         CryptographicHash hash(method);
+         for (int i = 0; i < data.size(); i += step) {
+            hash.addData(data.getConstRawData() + i, std::min(step, data.size() - i));
+            // taking the result in between must not disturb the state
+            hash.result();
+         }
+         ASSERT_EQ(hash.result(), expected) << method << " " << step;
+      }
+   }
+}
+
+TEST(CryptographicHashTest, testHashMany)
+{
+   // lengths around the block sizes of every family, so lanes of one batch
+   // finish after different numbers of blocks
+   std::vector<ByteArray> data;
+   for (int size = 0; size < 300; size += 5) {
+      data.push_back(make_data(size));
+   }
+   data.push_back(make_data(10000));
+   for (CryptographicHash::Algorithm method : sg_algorithms) {
+      std::vector<ByteArray> results = CryptographicHash::hashMany(data, method);
+      ASSERT_EQ(results.size(), data.size());
+      for (size_t i = 0; i < data.size(); ++i) {
+         ASSERT_EQ(results[i], CryptographicHash::hash(data[i], method)) << method << " " << i;
+      }
+   }
+   ASSERT_TRUE(CryptographicHash::hashMany(std::vector<ByteArray>(), CryptographicHash::Sha256).empty());
+}
+
+TEST(CryptographicHashTest, testAddFileDevice)
+{
+   TemporaryDir dir;
+   ASSERT_TRUE(dir.isValid());
+   // large enough to be hashed from a mapping
+   ByteArray data = make_data(200000);
+   File file(dir.getFilePath(Latin1String("data")));
+   ASSERT_TRUE(file.open(IoDevice::OpenMode::WriteOnly));
+   ASSERT_EQ(file.write(data), data.size());
+   file.close();
+   ASSERT_TRUE(file.open(IoDevice::OpenMode::ReadOnly));
+   for (int offset : {0, 1000}) {
+      ASSERT_TRUE(file.seek(offset));
+      CryptographicHash hash(CryptographicHash::Sha256);
+      ASSERT_TRUE(hash.addData(&file));
+      ASSERT_TRUE(file.atEnd());
+      ASSERT_EQ(hash.result(), CryptographicHash::hash(data.mid(offset), CryptographicHash::Sha256));
+   }
+}
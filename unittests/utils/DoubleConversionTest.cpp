@@ -0,0 +1,137 @@
+// @copyright 2017-2018 zzu_softboy <zzu_softboy@163.com>
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+// NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Created by softboy on 2026/10/18.
+
+#include "gtest/gtest.h"
+#include "pdk/utils/internal/DoubleConversionPrivate.h"
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+using pdk::utils::internal::double_to_shortest;
+using pdk::utils::internal::decimal_to_double;
+
+namespace {
+
+std::string shortest(double d, int *decpt)
+{
+   char digits[17];
+   int length = double_to_shortest(d, digits, decpt);
+   return std::string(digits, length);
+}
+
+double bits_to_double(pdk::puint64 bits)
+{
+   double d;
+   std::memcpy(&d, &bits, sizeof(d));
+   return d;
+}
+
+pdk::puint64 double_to_bits(double d)
+{
+   pdk::puint64 bits;
+   std::memcpy(&bits, &d, sizeof(d));
+   return bits;
+}
+
+} // anonymous namespace
+
+TEST(DoubleConversionTest, testShortest)
+{
+   int decpt;
+   ASSERT_EQ(shortest(0.1, &decpt), "1");
+   ASSERT_EQ(decpt, 0);
+   ASSERT_EQ(shortest(1.0, &decpt), "1");
+   ASSERT_EQ(decpt, 1);
+   ASSERT_EQ(shortest(123.456, &decpt), "123456");
+   ASSERT_EQ(decpt, 3);
+   ASSERT_EQ(shortest(1e23, &decpt), "1");
+   ASSERT_EQ(decpt, 24);
+   ASSERT_EQ(shortest(0.3, &decpt), "3");
+   ASSERT_EQ(decpt, 0);
+   ASSERT_EQ(shortest(0.1 + 0.2, &decpt), "30000000000000004");
+   ASSERT_EQ(decpt, 0);
+   ASSERT_EQ(shortest(DBL_MAX, &decpt), "17976931348623157");
+   ASSERT_EQ(decpt, 309);
+   ASSERT_EQ(shortest(DBL_MIN, &decpt), "22250738585072014");
+   ASSERT_EQ(decpt, -307);
+   ASSERT_EQ(shortest(std::numeric_limits<double>::denorm_min(), &decpt), "5");
+   ASSERT_EQ(decpt, -323);
+   ASSERT_EQ(shortest(9007199254740993.0, &decpt), "9007199254740992");
+   ASSERT_EQ(decpt, 16);
+}
+
+TEST(DoubleConversionTest, testShortestRoundTrip)
+{
+   std::mt19937_64 rng(20261018);
+   char buf[64];
+   for (int i = 0; i < 100000; ++i) {
+      double d = bits_to_double(rng() & ~(pdk::puint64(1) << 63));
+      if (!std::isfinite(d) || d == 0) {
+         continue;
+      }
+      int decpt;
+      std::string digits = shortest(d, &decpt);
+      ASSERT_LE(digits.size(), 17u);
+      ASSERT_NE(digits.back(), '0');
+      std::snprintf(buf, sizeof(buf), "0.%se%d", digits.c_str(), decpt);
+      ASSERT_EQ(double_to_bits(std::strtod(buf, nullptr)), double_to_bits(d)) << buf;
+      if (digits.size() > 1) {
+         // one digit less must not read back as d
+         std::snprintf(buf, sizeof(buf), "%.*e", static_cast<int>(digits.size()) - 2, d);
+         ASSERT_NE(double_to_bits(std::strtod(buf, nullptr)), double_to_bits(d)) << buf;
+      }
+   }
+}
+
+TEST(DoubleConversionTest, testDecimalToDouble)
+{
+   double d;
+   ASSERT_TRUE(decimal_to_double(1, -1, false, &d));
+   ASSERT_EQ(d, 0.1);
+   ASSERT_TRUE(decimal_to_double(123456, -3, true, &d));
+   ASSERT_EQ(d, -123.456);
+   ASSERT_TRUE(decimal_to_double(17976931348623157ULL, 292, false, &d));
+   ASSERT_EQ(d, DBL_MAX);
+   ASSERT_TRUE(decimal_to_double(5, -324, false, &d));
+   ASSERT_EQ(d, std::numeric_limits<double>::denorm_min());
+   ASSERT_TRUE(decimal_to_double(9007199254740993ULL, 0, false, &d));
+   ASSERT_EQ(d, 9007199254740992.0);
+   ASSERT_TRUE(decimal_to_double(1, 400, false, &d));
+   ASSERT_TRUE(std::isinf(d));
+   ASSERT_TRUE(decimal_to_double(1, -400, false, &d));
+   ASSERT_EQ(d, 0.0);
+   ASSERT_TRUE(decimal_to_double(0, 10, false, &d));
+   ASSERT_EQ(d, 0.0);
+}
+
+TEST(DoubleConversionTest, testDecimalToDoubleMatchesStrtod)
+{
+   std::mt19937_64 rng(20261018);
+   char buf[64];
+   for (int i = 0; i < 100000; ++i) {
+      pdk::puint64 w = rng() >> (rng() % 64);
+      int q = static_cast<int>(rng() % 700) - 350;
+      double d;
+      if (!decimal_to_double(w, q, false, &d)) {
+         continue;
+      }
+      std::snprintf(buf, sizeof(buf), "%llue%d", static_cast<unsigned long long>(w), q);
+      ASSERT_EQ(double_to_bits(d), double_to_bits(std::strtod(buf, nullptr))) << buf;
+   }
+}